@@ -36,8 +36,8 @@
 #include "ns_energy_monitor.h"
 #include "ns_peripherals_power.h"
 #include "ns_audio_mfcc.h"
+#include "ns_audio_kws_stream.h"
 #include "ns_debug_log.h"
-#include "ns_peripherals_button.h"
 #include "ns_timer.h"
 
 ////////////////////////////////////////////////
@@ -72,6 +72,30 @@ static ns_mfcc_cfg_t mfcc_config = {.api = &ns_mfcc_V1_0_0,
                              .frame_len = SAMPLES_IN_FRAME,
                              .frame_len_pow2 = MY_MFCC_FRAME_LEN_POW2};
 
+////////////////////////////////////////////////
+// Continuous KWS: features are quantized per hop into a rolling window,
+// the model runs every KWS_STRIDE hops, and detections are smoothed over
+// the last KWS_SMOOTHING inferences.
+#define KWS_STRIDE 5          // 100ms between inferences
+#define KWS_SMOOTHING 3       // inferences averaged
+#define KWS_THRESHOLD 0.6f    // smoothed posterior needed to report a keyword
+#define KWS_SUPPRESSION 10    // ~1s refractory period after a detection
+#define KWS_ARENA_SIZE                                                                             \
+    NS_KWS_STREAM_ARENA_SIZE(NUM_FRAMES, MY_MFCC_NUM_MFCC_COEFFS, kCategoryCount, KWS_SMOOTHING)
+alignas(4) static uint8_t kwsArena[KWS_ARENA_SIZE];
+static ns_kws_stream_cfg_t kws_config = {.api = &ns_kws_stream_V0_0_1,
+                                         .mfcc = &mfcc_config,
+                                         .arena = kwsArena,
+                                         .arena_size = KWS_ARENA_SIZE,
+                                         .num_frames = NUM_FRAMES,
+                                         .num_coeffs = MY_MFCC_NUM_MFCC_COEFFS,
+                                         .stride = KWS_STRIDE,
+                                         .num_classes = kCategoryCount,
+                                         .smoothing_window = KWS_SMOOTHING,
+                                         .threshold = KWS_THRESHOLD,
+                                         .suppression = KWS_SUPPRESSION,
+                                         .ignore_mask = (1 << 10) | (1 << 11)}; // silence, unknown
+
 ////////////////////////////////////////////////
 // Tensorflow Globals (somewhat boilerplate)
 static tflite::ErrorReporter *error_reporter = nullptr;
@@ -101,9 +125,15 @@ static ns_timer_config_t basic_tickTimer = {
 // Set by app when it wants to start recording, used by callback
 bool volatile static audioRecording = false;
 
-// Set by callback when audio buffer has been copied, cleared by
-// app when the buffer has been consumed.
-bool volatile static audioReady = false;
+// Hops wait here between the callback and the event loop, which falls several hops behind
+// while the model runs. If the ring is full, the callback drops the hop and flags the next one
+// it stores, so the loop restarts the feature window there instead of splicing across the gap.
+#define KWS_HOP_SLOTS 8 // 160ms of audio
+alignas(16) int16_t static hopRing[KWS_HOP_SLOTS][SAMPLES_IN_FRAME];
+bool static hopAfterGap[KWS_HOP_SLOTS];
+uint32_t volatile static hopHead = 0;    // hops stored, advanced by the callback
+uint32_t volatile static hopTail = 0;    // hops consumed, advanced by the event loop
+uint32_t volatile static hopsMissed = 0; // hops dropped because the ring was full
 
 // Audio buffers
 #if NUM_CHANNELS == 1
@@ -126,16 +156,24 @@ am_hal_offset_cal_coeffs_array_t sOffsetCalib;
  *
  * @brief Audio Callback (executes in IRQ context)
  *
- * When the 'audioRecording' flag is set, copy the latest sample to a buffer
- * and set a 'ready' flag. If recording flag isn't set, discard buffer.
- * If 'ready' flag is still set, the last buffer hasn't been consumed yet,
- * print a debug message and overwrite.
+ * When the 'audioRecording' flag is set, copy the latest hop into the hop ring.
+ * If the ring is full, the event loop is too far behind: drop the hop and count it.
  *
  */
 static void audio_frame_callback(ns_audio_config_t *config, uint16_t bytesCollected) {
-   if (audioRecording) {
+    static bool dropped = false;
+
+    if (audioRecording) {
         ns_audio_getPCM_v2(config, audioDataBuffer);
-        audioReady = true;
+        if (hopHead - hopTail == KWS_HOP_SLOTS) {
+            hopsMissed++;
+            dropped = true;
+            return;
+        }
+        memcpy(hopRing[hopHead % KWS_HOP_SLOTS], audioDataBuffer, sizeof(hopRing[0]));
+        hopAfterGap[hopHead % KWS_HOP_SLOTS] = dropped;
+        dropped = false;
+        hopHead++;
     }
 }
 
@@ -170,44 +208,19 @@ static ns_audio_config_t audio_config = {
     #endif
 };
 
-////////////////////////////////////////////////
-// Button config and application state
-// buttonPressed - will be set by neuralSPOT button helper
-static int volatile buttonPressed = 0;
-
-// Button Peripheral Config Struct
-ns_button_config_t button_config = {.api = &ns_button_V1_0_0,
-                                    .button_0_enable = true,
-                                    .button_1_enable = false,
-                                    .joulescope_trigger_enable = false,
-                                    .button_0_flag = &buttonPressed,
-                                    .button_1_flag = NULL,
-                                    .joulescope_trigger_flag = NULL};
-
 ////////////////////////////////////////////////
 //*** KWS Application State
-static int recording_win = NUM_FRAMES;
-typedef enum { WAITING_TO_RECORD, WAIT_FOR_FRAME, INFERING } myState_e;
 static void model_init(void);
 
 /**
- * @brief Main basic_tf_stub - infinite loop listening and inferring
+ * @brief Main KWS - infinite loop listening and inferring
  *
  * @return int
  */
 int main(void) {
-    float tmp = 0;
-    float mfcc_buffer[NUM_FRAMES * MY_MFCC_NUM_MFCC_COEFFS];
-    float output[kCategoryCount];
-    uint8_t output_max = 0;
-    float max_val = 0.0;
+    int32_t detected;
     ns_core_config_t ns_core_cfg = {.api = &ns_core_V1_0_0};
 
-    myState_e state = WAITING_TO_RECORD;
-
-    // Tells callback if it should be recording audio
-    audioRecording = false;
-
     // Pile of inits
     NS_TRY(ns_core_init(&ns_core_cfg), "Core init failed.\n");
     NS_TRY(ns_power_config(&ns_development_default), "Power Init Failed.\n");
@@ -216,91 +229,58 @@ int main(void) {
     NS_TRY(ns_timer_init(&basic_tickTimer), "Timer init failed.\n");
     NS_TRY(ns_audio_init(&audio_config), "Audio initialization Failed.\n");
     NS_TRY(ns_audio_set_gain(AM_HAL_PDM_GAIN_P345DB, AM_HAL_PDM_GAIN_P345DB), "Gain set failed.\n"); // PDM gain
-    NS_TRY(ns_start_audio(&audio_config), "Audio start failed.\n");
     NS_TRY(ns_mfcc_init(&mfcc_config), "MFCC config failed.\n");
-    NS_TRY(ns_peripheral_button_init(&button_config), "Button initialization failed.\n")
 
     model_init();
 
-    ns_lp_printf("This KWS example listens for 1 second, then classifies\n");
-    ns_lp_printf("the captured audio into one of the following phrases:\n");
-    ns_lp_printf("yes, no, up, down, left, right, on, off, or unknown/silence\n\n");
-    ns_lp_printf("Press Button 0 to start listening...\n");
+    // Quantization params come from the model, so the stream is initialized after it
+    kws_config.input_scale = model_input->params.scale;
+    kws_config.input_zero_point = model_input->params.zero_point;
+    kws_config.output_scale = model_output->params.scale;
+    kws_config.output_zero_point = model_output->params.zero_point;
+    NS_TRY(ns_kws_stream_init(&kws_config), "KWS stream init failed.\n");
+
+    ns_lp_printf("This KWS example listens continuously and reports when it hears\n");
+    ns_lp_printf("one of the following phrases:\n");
+    ns_lp_printf("down, go, left, no, off, on, right, stop, up, or yes\n\n");
+
+    audioRecording = true; // Global to tell callback to start recording
+    NS_TRY(ns_start_audio(&audio_config), "Audio start failed.\n");
 
     // Event loop
     while (1) {
-        switch (state) {
-
-        case WAITING_TO_RECORD:
-            if (buttonPressed) {
-                state = WAIT_FOR_FRAME;
-                buttonPressed = false;
-                ns_delay_us(250000); // wait for button click noise to die down
-                audioRecording = true; // Global to tell callback to start recording
-                ns_lp_printf("\nListening for 1 second.\n");
-            }
-            break;
-
-        case WAIT_FOR_FRAME:
-            if (audioReady) { // Set by audio callback when there is a new frame ready
-                int32_t mfcc_buffer_head = (NUM_FRAMES - recording_win) * MY_MFCC_NUM_MFCC_COEFFS;
-                // audioDataBuffer contains one frame of audio data
-                ns_mfcc_compute(&mfcc_config, audioDataBuffer, &mfcc_buffer[mfcc_buffer_head]);
-                recording_win--; // number of frames left to record before it is ready for inference
-                audioReady = false; // pause callback from recording more audio 
-                ns_lp_printf(".");
+        if (hopTail != hopHead) { // The audio callback has stored a new hop
+            uint32_t slot = hopTail % KWS_HOP_SLOTS;
+            if (hopAfterGap[slot]) {
+                // Audio is missing before this hop, start a new window
+                ns_lp_printf("Dropped audio (%d hops so far), restarting\n", hopsMissed);
+                ns_kws_stream_reset(&kws_config);
             }
 
-            if (recording_win == 0) { // We have enough frames to run inference
-                ns_lp_printf("\n");
-                audioRecording = false;
-                recording_win = NUM_FRAMES;
-                state = INFERING; // have full sample
-            } else {
-                ns_set_power_monitor_state(NS_DATA_COLLECTION);
-            }
-
-            break;
-
-        case INFERING:
-            // Prepare the model input
-            for (uint16_t i = 0; i < (NUM_FRAMES * MY_MFCC_NUM_MFCC_COEFFS); i = i + 1) {
-                tmp = mfcc_buffer[i] / model_input->params.scale + model_input->params.zero_point;
-                tmp = MAX(MIN(tmp, 127), -128);
-                model_input->data.int8[i] = (int8_t)tmp;
-            }
+            // One hop of MFCCs, quantized straight into the rolling feature window
+            bool infer = ns_kws_stream_push_audio(&kws_config, hopRing[slot]);
+            hopTail++;
 
-            // Call the model
-            TfLiteStatus invoke_status = interpreter->Invoke();
+            if (infer) {
+                memcpy(
+                    model_input->data.int8, ns_kws_stream_get_window(&kws_config),
+                    NUM_FRAMES * MY_MFCC_NUM_MFCC_COEFFS);
 
-            if (invoke_status != kTfLiteOk) {
-                ns_lp_printf("Invoke failed\n");
-                while (1) {
-                }; // hang
-            }
+                TfLiteStatus invoke_status = interpreter->Invoke();
 
-            // Decode the output
-            max_val = 0.0;
-            for (uint8_t i = 0; i < kCategoryCount; i = i + 1) {
-                output[i] = (model_output->data.int8[i] - model_output->params.zero_point) *
-                            model_output->params.scale;
-                if (output[i] > 0.3) {
-                    ns_lp_printf(
-                        "\n[%s] with %d%% certainty\n", kCategoryLabels[i],
-                        (uint8_t)(output[i] * 100));
+                if (invoke_status != kTfLiteOk) {
+                    ns_lp_printf("Invoke failed\n");
+                    while (1) {
+                    }; // hang
                 }
 
-                if (output[i] > max_val) {
-                    max_val = output[i];
-                    output_max = i;
+                detected = ns_kws_stream_push_scores(&kws_config, model_output->data.int8);
+                if (detected != NS_KWS_STREAM_NO_DETECTION) {
+                    ns_lp_printf(
+                        "[%s] with %d%% certainty\n", kCategoryLabels[detected],
+                        (uint8_t)(ns_kws_stream_get_smoothed(&kws_config, detected) * 100));
                 }
             }
-
-            ns_lp_printf("\n**** Most probably: [%s]\n\n", kCategoryLabels[output_max]);
-            ns_lp_printf("Press Button 0 to start listening...\n");
-            buttonPressed = false; // thoroughly debounce the button
-            state = WAITING_TO_RECORD; // wait for button press to start recording again
-            break;
         }
         // ns_deep_sleep();
     } // while(1)
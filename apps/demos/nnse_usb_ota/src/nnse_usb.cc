@@ -17,6 +17,8 @@
 
 #include "ns_malloc.h"
 #include "ns_model.h"
+#include "ns_ota.h"
+#include "ns_ota_delta.h"
 
 // Add profiling includes
 #include "ns_energy_monitor.h"
@@ -44,6 +46,7 @@ typedef struct {
 #define CHUNK_CMD_ACK        0x02
 #define CHUNK_CMD_CONFIG     0x03
 #define CHUNK_CMD_RUN_STATS  0x04
+#define CHUNK_CMD_OTA        0x05 // Payload is an ns-ota message (resumable, windowed upload)
 
 // Maximum model sizes for TCM and SRAM
 #define TCM_MODEL_SIZE  (200 * 1024) // 256KB
@@ -76,6 +79,19 @@ typedef struct {
 // Global model upload state
 static model_upload_state_t model_state = {0};
 
+// ns-ota upload (CHUNK_CMD_OTA): the A/B slots are the two halves of sram_model_array, so a new
+// model is received while the previous one stays usable. The records are in RAM here, so an
+// interrupted upload resumes after a USB reconnect but not a power cycle; put the regions in
+// MRAM with ns_ota_mram_storage_init() for that. Delta uploads (tools/ns_ota_delta.py) patch
+// the active model into the other half.
+static uint8_t ota_progress[sizeof(ns_ota_progress_t)] __attribute__((aligned(4)));
+static uint8_t ota_boot[2][sizeof(ns_ota_boot_t)] __attribute__((aligned(4)));
+static ns_ota_mem_storage_t ota_mem;
+static ns_ota_storage_t ota_storage;
+static ns_ota_t ota;
+static ns_ota_delta_t ota_delta;
+static uint32_t ota_generation = 0; // Generation of the image model_state points to
+
 // WebUSB Configuration and Datatypes
 #define MY_RX_BUFSIZE 4096
 #define MY_TX_BUFSIZE 4096
@@ -238,6 +254,13 @@ void handle_model_chunk(const uint8_t* data, uint32_t length) {
                 model_state.upload_in_progress = false;
                 return;
             }
+            if (model_buffer == sram_model_array) {
+                // This overwrites the OTA slots, forget the image they held
+                memset(ota_boot, 0, sizeof(ota_boot));
+                ns_ota_abort(&ota);
+                ns_ota_init(&ota);
+                ota_generation = 0;
+            }
             model_state.model_buffer = model_buffer;
             model_state.model_size = estimated_size;
         }
@@ -260,6 +283,49 @@ void handle_model_chunk(const uint8_t* data, uint32_t length) {
     }
 }
 
+static uint32_t ota_send(void *ctx, const uint8_t *msg, uint32_t len) {
+    // ACKs go out as is, the host tells them from the legacy 5-byte ACK by length
+    return webusb_send_data((uint8_t *)msg, len) == len ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+}
+
+void ota_init() {
+    ota_mem.region[NS_OTA_REGION_SLOT_A] = sram_model_array;
+    ota_mem.regionSize[NS_OTA_REGION_SLOT_A] = SRAM_MODEL_SIZE / 2;
+    ota_mem.region[NS_OTA_REGION_SLOT_B] = sram_model_array + SRAM_MODEL_SIZE / 2;
+    ota_mem.regionSize[NS_OTA_REGION_SLOT_B] = SRAM_MODEL_SIZE / 2;
+    ota_mem.region[NS_OTA_REGION_PROGRESS] = ota_progress;
+    ota_mem.regionSize[NS_OTA_REGION_PROGRESS] = sizeof(ota_progress);
+    ota_mem.region[NS_OTA_REGION_BOOT0] = ota_boot[0];
+    ota_mem.regionSize[NS_OTA_REGION_BOOT0] = sizeof(ota_boot[0]);
+    ota_mem.region[NS_OTA_REGION_BOOT1] = ota_boot[1];
+    ota_mem.regionSize[NS_OTA_REGION_BOOT1] = sizeof(ota_boot[1]);
+    ns_ota_mem_storage_init(&ota_storage, &ota_mem);
+
+    ota.api = &ns_ota_V0_0_1;
+    ota.storage = &ota_storage;
+    ota.link.send = ota_send;
+    ota.link.ctx = NULL;
+    ota.ackEvery = 8;
+    ota.persistEvery = 16;
+    ota.delta = &ota_delta;
+    NS_TRY(ns_ota_init(&ota), "OTA init failed.\n");
+}
+
+void handle_ota(const uint8_t* data, uint32_t length) {
+    ns_ota_image_t image;
+
+    ns_ota_receive(&ota, data, length);
+    if (ns_ota_get_active(&ota, &image) && (image.generation != ota_generation)) {
+        // A verified image was just switched in, run it from its slot
+        ota_generation = image.generation;
+        model_state.model_buffer = (uint8_t *)ns_ota_mem_storage_addr(&ota_mem, image.slot);
+        model_state.model_size = image.size;
+        model_state.upload_in_progress = false;
+        model_state.upload_complete = true;
+        ns_lp_printf("OTA model active: %d bytes, generation %d\n", image.size, image.generation);
+    }
+}
+
 void run_model_and_send_stats() {
     ns_lp_printf("=== run_model_and_send_stats called ===\n");
     
@@ -273,12 +339,12 @@ void run_model_and_send_stats() {
     
     ns_lp_printf("Model upload complete, size: %d bytes\n", model_state.model_size);
     
-    // Select model buffer and arena
-    uint8_t* model_data = (selected_model_location == MODEL_LOC_SRAM) ? sram_model_array : tcm_model_array;
+    // Select model buffer (where the last upload put it) and arena
+    uint8_t* model_data = model_state.model_buffer;
     size_t model_len = model_state.model_size;
     uint8_t* arena = (selected_arena_location == ARENA_LOC_SRAM) ? sram_arena : tcm_arena;
     
-    ns_lp_printf("Using model location: %s\n", selected_model_location == MODEL_LOC_SRAM ? "SRAM" : "TCM");
+    ns_lp_printf("Using model location: %s\n", model_data == tcm_model_array ? "TCM" : "SRAM");
     ns_lp_printf("Model data pointer: %p, size: %d\n", model_data, model_len);
 
     // Fill out model state struct
@@ -439,6 +505,11 @@ void msgReceived(const uint8_t *buffer, uint32_t length, void *args) {
             handle_model_config(payload, payload_length);
             ns_lp_printf("Configuration received\n");
             return;
+        } else if (header->command == CHUNK_CMD_OTA) {
+            if (CalcCrc32(0xFFFFFFFF, payload_length, (uint8_t*)payload) == header->crc32) {
+                handle_ota(payload, payload_length);
+            }
+            return;
         } else if (header->command == CHUNK_CMD_RUN_STATS) {
             ns_lp_printf("Processing RUN_STATS command\n");
             run_model_and_send_stats();
@@ -492,6 +563,7 @@ int main(void) {
     model_state.received_chunks = 0;
     model_state.upload_in_progress = false;
     model_state.upload_complete = false;
+    ota_init();
 
     ns_lp_printf("Model upload firmware ready\n");
     
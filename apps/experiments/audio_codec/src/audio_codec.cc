@@ -40,6 +40,7 @@
 #include "ns_peripherals_button.h"
 #include "ns_peripherals_power.h"
 #ifdef AC_RPC_MODE
+    #include "ns_audio_encoder.h"
     #include "ns_rpc_generic_data.h"
 #else
     #include "ns_ble.h"
@@ -86,10 +87,65 @@ am_hal_audadc_sample_t static workingBuffer[SAMPLES_IN_FRAME * NUM_CHANNELS]; //
 am_hal_offset_cal_coeffs_array_t sOffsetCalib;
 #endif
 
+#ifdef AC_RPC_MODE
+// In RPC mode the callback only queues PCM frames; the main loop encodes them and hands the
+// packets to USB as fast as RPC accepts them, so a slow transfer doesn't drop audio
+    #define AC_POOL_FRAMES 4
+    #define AC_QUEUE_PACKETS 4
+alignas(16) int16_t static pcmPool[AC_POOL_FRAMES * SAMPLES_IN_FRAME];
+alignas(4) uint8_t static packetBuf[NS_AUDIO_ENC_QUEUE_MIN(sizeof(encodedDataBuffer)) +
+                                    AC_QUEUE_PACKETS *
+                                        NS_AUDIO_ENC_PACKET_FOOTPRINT(sizeof(encodedDataBuffer))];
+
+static int32_t
+ac_opus_encode(void *ctx, const int16_t *pcm, uint32_t samples, uint8_t *out, uint32_t cap) {
+    if (cap < sizeof(encodedDataBuffer)) {
+        return -1;
+    }
+    return audio_enc_encode_frame((short *)pcm, samples, out);
+}
+
+static const ns_audio_codec_t acOpus = {
+    .encode = ac_opus_encode,
+    .set_bitrate = NULL, // The precompiled encoder has a fixed configuration
+    .set_complexity = NULL,
+    .ctx = NULL};
+
+static ns_audio_enc_t acEncoder = {
+    .api = &ns_audio_enc_V0_0_1,
+    .codec = &acOpus,
+    .frameSamples = SAMPLES_IN_FRAME * NUM_CHANNELS,
+    .numChannels = NUM_CHANNELS,
+    .numFrames = AC_POOL_FRAMES,
+    .pcmPool = pcmPool,
+    .packetBuf = packetBuf,
+    .packetBufSize = sizeof(packetBuf),
+    .maxPacket = sizeof(encodedDataBuffer),
+    .bitrate = 0,
+    .complexity = -1};
+
+// Sink for ns_audio_enc_drain(), ctx is the dataBlock sent to the PC
+static uint32_t ac_rpc_send(void *ctx, const ns_audio_packet_t *packet) {
+    dataBlock *block = (dataBlock *)ctx;
+
+    block->length = packet->len;
+    block->buffer.data = packet->data;
+    block->buffer.dataLength = packet->len;
+    if (ns_rpc_data_sendBlockToPC(block) != ns_rpc_data_success) {
+        return NS_STATUS_FAILURE; // Left queued, retried on the next drain
+    }
+    return NS_STATUS_SUCCESS;
+}
+#endif
+
 void audio_frame_callback(ns_audio_config_t *config, uint16_t bytesCollected) {
     if (g_audioRecording) {
+#ifdef AC_RPC_MODE
+        ns_audio_enc_capture(&acEncoder, config);
+#else
         ns_audio_getPCM_v2(config, audioDataBuffer);
         g_audioReady = true;
+#endif
     }
 }
 
@@ -233,10 +289,9 @@ int main(void) {
     NS_TRY(ns_peripheral_button_init(&button_config), "Button init failed\n");
 
     // -- Audio init
-    int recordingWin = NUM_FRAMES;
+    uint32_t recordingWin = NUM_FRAMES;
 
     // Vars and init the RPC system - note this also inits the USB interface
-    status stat;
     binary_t binaryBlock = {
         .data = (uint8_t *)encodedDataBuffer, // point this to audio buffer
         .dataLength = sizeof(audioDataBuffer)};
@@ -274,48 +329,33 @@ int main(void) {
 
     ns_lp_printf("Starting Opus-over-RPC  demo.\n");
     g_audioRecording = false;
+    ns_audio_enc_sink_t rpcSink = {.send = ac_rpc_send, .ctx = &outBlock};
 
     // In the app loop we service USB and the RPC server while
     // we collect data and send it over the various RPC
     // interfaces. Any incoming RPC calls will result in calls to the
     // RPC handler functions defined above.
-    uint32_t ui32EncoderReturn;
-    uint32_t totalenc = 0;
     while (1) {
         if ((g_intButtonPressed) == 1 && !g_audioRecording) {
+            NS_TRY(ns_audio_enc_init(&acEncoder), "Encoder init failed\n"); // Empty pool and queue
             g_audioRecording = true;
             ns_printf("Listening for 3 seconds.\n");
             // ns_rpc_data_remotePrintOnPC("EVB Says this: Listening for 3 seconds.\n");
 
-            while (recordingWin > 0) {
-                if (g_audioReady) { // got an audio sample
-                    recordingWin--;
-                    g_audioReady = false;
-                    ui32EncoderReturn =
-                        audio_enc_encode_frame(sinWave, SAMPLES_IN_FRAME, encodedDataBuffer);
-                    totalenc += ui32EncoderReturn;
-
-                    outBlock.length = ui32EncoderReturn;
-                    outBlock.buffer.dataLength = ui32EncoderReturn;
-
-                    stat = ns_rpc_data_sendBlockToPC(&outBlock);
-
-                    if (stat == ns_rpc_data_success) {
-                        ns_lp_printf(".", ui32EncoderReturn);
-                        // ns_lp_printf(". %d .", ui32EncoderReturn);
-                        // ns_lp_printf("raw 0x%x%x%x\n", audioDataBuffer[0], audioDataBuffer[1],
-                        // audioDataBuffer[2]); ns_lp_printf("enc 0x%x%x%x\n", encodedDataBuffer[0],
-                        // encodedDataBuffer[1], encodedDataBuffer[2]);
-                    } else
-                        ns_lp_printf("[%d]+", stat);
+            while (acEncoder.stats.sent < recordingWin) {
+                ns_audio_enc_process(&acEncoder);
+                if (ns_audio_enc_drain(&acEncoder, &rpcSink)) {
+                    ns_lp_printf(".");
+                } else if (ns_audio_enc_queued(&acEncoder)) {
+                    ns_lp_printf("+");
                 }
             }
+            g_audioRecording = false;
             ns_lp_printf(
-                "%d bytes, total %d, frames %d\n", ui32EncoderReturn, totalenc, NUM_FRAMES);
+                "%d bytes, frames %d, overruns %d, encode errors %d\n", acEncoder.stats.bytes,
+                acEncoder.stats.sent, acEncoder.stats.overruns, acEncoder.stats.encodeErrors);
 
-            g_audioRecording = false;
             g_intButtonPressed = 0;
-            recordingWin = NUM_FRAMES;
         }
         ns_deep_sleep();
     }
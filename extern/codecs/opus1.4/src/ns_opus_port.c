@@ -13,6 +13,7 @@
 #include "opus.h"
 #include "opus_types.h"
 #include "ns_ambiqsuite_harness.h"
+#include "ns_opus_port.h"
 
 void* alloca(int size)
 {
@@ -27,9 +28,11 @@ OpusEncoder *ns_opus_encoder_default_create()
 {
     // Create a default encoder typical to neuralspot applications
     // 16khz, 1 channel, 20ms frame size, low complexity
-    int sample_rate = 16000;
-    int frame_size = 320;
-    int complexity = 3;
+    return ns_opus_encoder_create(16000, 16000, 3, 0);
+}
+
+OpusEncoder *ns_opus_encoder_create(int sample_rate, int bitrate, int complexity, int vbr)
+{
     int channels = 1;
     int application = OPUS_APPLICATION_VOIP;
 
@@ -40,8 +43,8 @@ OpusEncoder *ns_opus_encoder_default_create()
         return NULL;
     }
     // Set the encoder parameters
-    NS_TRY(opus_encoder_ctl(enc, OPUS_SET_BITRATE(sample_rate)),"OPUS_SET_BITRATE");
-    NS_TRY(opus_encoder_ctl(enc, OPUS_SET_VBR(0)), "OPUS_SET_VBR");
+    NS_TRY(opus_encoder_ctl(enc, OPUS_SET_BITRATE(bitrate)),"OPUS_SET_BITRATE");
+    NS_TRY(opus_encoder_ctl(enc, OPUS_SET_VBR(vbr)), "OPUS_SET_VBR");
     NS_TRY(opus_encoder_ctl(enc, OPUS_SET_VBR_CONSTRAINT(0)), "OPUS_SET_VBR_CONSTRAINT");
     NS_TRY(opus_encoder_ctl(enc, OPUS_SET_COMPLEXITY(complexity)), "OPUS_SET_COMPLEXITY");
     NS_TRY(opus_encoder_ctl(enc, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE)), "OPUS_SET_SIGNAL");
@@ -56,3 +59,29 @@ int ns_opus_encode_frame(OpusEncoder *st, const opus_int16 *pcm, int frame_size,
     return opus_encode(st, pcm, frame_size, data, max_data_bytes);
 }
 
+static int32_t ns_opus_codec_encode(void *ctx, const int16_t *pcm, uint32_t samples, uint8_t *out, uint32_t cap)
+{
+    return opus_encode((OpusEncoder *)ctx, pcm, samples, out, cap);
+}
+
+static uint32_t ns_opus_codec_set_bitrate(void *ctx, uint32_t bitsPerSecond)
+{
+    return (opus_encoder_ctl((OpusEncoder *)ctx, OPUS_SET_BITRATE(bitsPerSecond)) == OPUS_OK)
+               ? NS_STATUS_SUCCESS
+               : NS_STATUS_INVALID_CONFIG;
+}
+
+static uint32_t ns_opus_codec_set_complexity(void *ctx, uint8_t complexity)
+{
+    return (opus_encoder_ctl((OpusEncoder *)ctx, OPUS_SET_COMPLEXITY(complexity)) == OPUS_OK)
+               ? NS_STATUS_SUCCESS
+               : NS_STATUS_INVALID_CONFIG;
+}
+
+void ns_opus_codec_init(ns_audio_codec_t *codec, OpusEncoder *enc)
+{
+    codec->encode = ns_opus_codec_encode;
+    codec->set_bitrate = ns_opus_codec_set_bitrate;
+    codec->set_complexity = ns_opus_codec_set_complexity;
+    codec->ctx = enc;
+}
@@ -13,6 +13,7 @@
     #ifdef __cplusplus
 extern "C" {
     #endif
+#include "ns_audio_encoder.h"
 #include "ns_malloc.h"
 #include "opus.h"
 #include "opus_types.h"
@@ -20,7 +21,26 @@ extern "C" {
 OpusEncoder *ns_opus_encoder_default_create();
 int ns_opus_encode_frame(OpusEncoder *st, const opus_int16 *pcm, int frame_size, unsigned char *data, opus_int32 max_data_bytes);
 
-#endif
+/**
+ * @brief Create an encoder like ns_opus_encoder_default_create(), with explicit knobs
+ *
+ * @param sample_rate - 8000, 12000, 16000, 24000 or 48000
+ * @param bitrate - bits per second
+ * @param complexity - 0 (fastest) to 10
+ * @param vbr - variable bitrate, packets vary in length around the bitrate
+ * @return OpusEncoder* or NULL
+ */
+OpusEncoder *ns_opus_encoder_create(int sample_rate, int bitrate, int complexity, int vbr);
+
+/**
+ * @brief Bind an encoder to the ns_audio encode stage (ns_audio_encoder.h)
+ *
+ * @param codec - filled with the binding, the encoder is its context
+ * @param enc - encoder, e.g. from ns_opus_encoder_create()
+ */
+void ns_opus_codec_init(ns_audio_codec_t *codec, OpusEncoder *enc);
+
     #ifdef __cplusplus
 }
-    #endif
\ No newline at end of file
+    #endif
+#endif
@@ -60,6 +60,13 @@ erpc_mbf_t erpc_mbf_rpmsg_init(erpc_transport_t transport);
  */
 erpc_mbf_t erpc_mbf_rpmsg_tty_init(erpc_transport_t transport);
 
+/*!
+ * @brief Create MessageBuffer factory which is using the UART COBS transport's frame buffers.
+ *
+ * Has to be used with the UART COBS transport.
+ */
+erpc_mbf_t erpc_mbf_uart_cobs_init(erpc_transport_t transport);
+
 //@}
 
 #ifdef __cplusplus
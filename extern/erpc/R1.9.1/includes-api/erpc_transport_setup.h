@@ -376,6 +376,22 @@ erpc_transport_t erpc_transport_usb_cdc_init(usb_handle_t);
  * @return Return NULL or erpc_transport_t instance pointer.
  */
 erpc_transport_t erpc_transport_uart_init(ns_uart_handle_t);
+
+/*!
+ * @brief Create a COBS framed UART transport.
+ *
+ * Messages are COBS encoded with a CRC-16 trailer and a 0x00 delimiter. The UART must have
+ * been initialized with an ns_uart_framer_t, which receives and decodes frames in its RX
+ * interrupt. Use erpc_mbf_uart_cobs_init() to receive without copying.
+ *
+ * @param[in] handle UART handle returned by ns_uart_init().
+ * @param[in] txBuffer Scratch buffer for encoding, NS_UART_COBS_MAX_ENCODED(size + 2) + 1 bytes.
+ * @param[in] txBufferSize Size of txBuffer.
+ *
+ * @return Return NULL or erpc_transport_t instance pointer.
+ */
+erpc_transport_t erpc_transport_uart_cobs_init(ns_uart_handle_t handle, uint8_t *txBuffer,
+                                               uint32_t txBufferSize);
 //! @name I2C transport setup
 //@{
 
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 Ambiq Micro, Inc.
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _EMBEDDED_RPC__UART_COBS_TRANSPORT_H_
+#define _EMBEDDED_RPC__UART_COBS_TRANSPORT_H_
+
+#include "erpc_crc16.hpp"
+#include "erpc_message_buffer.hpp"
+#include "erpc_transport.hpp"
+
+extern "C" {
+#include "ns_uart.h"
+}
+
+/*!
+ * @addtogroup uart_transport
+ * @{
+ * @file
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace erpc {
+/*!
+ * @brief COBS framed UART transport
+ *
+ * Each message is sent as COBS(message, CRC-16 little endian) followed by a 0x00 delimiter.
+ * Frames are received and decoded in place by the ns_uart_framer_t attached to the UART
+ * handle. When the message buffer comes from the same framer (see erpc_mbf_uart_cobs_init)
+ * receive() swaps buffers instead of copying the payload.
+ *
+ * @ingroup uart_transport
+ */
+class UartCobsTransport : public Transport
+{
+public:
+    /*!
+     * @brief Constructor.
+     *
+     * @param[in] uartHandle Initialized UART handle with a framer.
+     * @param[in] txBuffer Scratch buffer for encoding outgoing frames.
+     * @param[in] txBufferSize Size of txBuffer.
+     */
+    UartCobsTransport(ns_uart_handle_t uartHandle, uint8_t *txBuffer, uint32_t txBufferSize);
+
+    /*!
+     * @brief Destructor.
+     */
+    virtual ~UartCobsTransport(void);
+
+    /*!
+     * @brief Initialize the transport.
+     *
+     * @return kErpcStatus_InitFailed if the UART has no framer.
+     */
+    erpc_status_t init(void);
+
+    /*!
+     * @brief Wait for a frame, check its CRC and hand it to the message.
+     *
+     * @param[inout] message Message buffer, swapped for the frame buffer if it is one.
+     *
+     * @retval kErpcStatus_CrcCheckFailed Frame was corrupted and has been dropped.
+     * @retval kErpcStatus_ReceiveFailed Frame was too short or does not fit the message.
+     * @retval kErpcStatus_Success Message holds the received payload.
+     */
+    virtual erpc_status_t receive(MessageBuffer *message) override;
+
+    /*!
+     * @brief Encode and send a message.
+     *
+     * @param[in] message Message buffer to send.
+     *
+     * @retval kErpcStatus_SendFailed Message does not fit the tx buffer or UART failed.
+     * @retval kErpcStatus_Success Message was sent.
+     */
+    virtual erpc_status_t send(MessageBuffer *message) override;
+
+    /*!
+     * @brief True if a complete frame has been received.
+     */
+    virtual bool hasMessage(void) override;
+
+    /*!
+     * @brief Set the CRC-16 implementation.
+     */
+    virtual void setCrc16(Crc16 *crcImpl) override;
+
+    /*!
+     * @brief The framer frames are received into.
+     */
+    ns_uart_framer_t *getFramer(void) { return m_framer; }
+
+    /*!
+     * @brief Largest message that fits in a frame buffer.
+     */
+    uint16_t getMessageSize(void) const;
+
+    /*!
+     * @brief Number of frames dropped because of a CRC mismatch.
+     */
+    uint32_t getCrcErrors(void) const { return m_crcErrors; }
+
+private:
+    ns_uart_handle_t m_uartHandle; /*!< UART handle. */
+    ns_uart_framer_t *m_framer;    /*!< Receives and decodes frames. */
+    uint8_t *m_txBuffer;           /*!< Encoded frame being sent. */
+    uint32_t m_txBufferSize;       /*!< Size of m_txBuffer. */
+    Crc16 *m_crcImpl;              /*!< CRC object. */
+    uint32_t m_crcErrors;          /*!< Frames dropped because of a CRC mismatch. */
+};
+
+} // namespace erpc
+
+/*! @} */
+
+#endif // _EMBEDDED_RPC__UART_COBS_TRANSPORT_H_
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 Ambiq Micro, Inc.
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "erpc_manually_constructed.hpp"
+#include "erpc_mbf_setup.h"
+#include "erpc_transport_setup.h"
+#include "erpc_uart_cobs_transport.hpp"
+
+using namespace erpc;
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+ * @brief MessageBuffer factory handing out the COBS transport's frame buffers.
+ *
+ * Buffers from this factory can be swapped with received frames without copying.
+ */
+class UartCobsMessageBufferFactory : public MessageBufferFactory
+{
+public:
+    explicit UartCobsMessageBufferFactory(UartCobsTransport *transport)
+    : m_transport(transport)
+    {
+    }
+
+    virtual ~UartCobsMessageBufferFactory(void) {}
+
+    virtual MessageBuffer create(void)
+    {
+        uint8_t *buf = ns_uart_framer_alloc(m_transport->getFramer());
+        erpc_assert(NULL != buf);
+        return MessageBuffer(buf, m_transport->getMessageSize());
+    }
+
+    virtual void dispose(MessageBuffer *buf)
+    {
+        erpc_assert(buf != NULL);
+        if ((buf->get() != NULL) && ns_uart_framer_owns(m_transport->getFramer(), buf->get()))
+        {
+            ns_uart_framer_release(m_transport->getFramer(), buf->get());
+        }
+    }
+
+protected:
+    UartCobsTransport *m_transport; /*!< Transport owning the frame buffers. */
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+////////////////////////////////////////////////////////////////////////////////
+
+ERPC_MANUALLY_CONSTRUCTED(UartCobsTransport, s_uart_cobs_transport);
+ERPC_MANUALLY_CONSTRUCTED(UartCobsMessageBufferFactory, s_uart_cobs_msgFactory);
+
+////////////////////////////////////////////////////////////////////////////////
+// Code
+////////////////////////////////////////////////////////////////////////////////
+
+erpc_transport_t erpc_transport_uart_cobs_init(ns_uart_handle_t handle, uint8_t *txBuffer,
+                                               uint32_t txBufferSize)
+{
+    erpc_transport_t transport;
+
+    s_uart_cobs_transport.construct(handle, txBuffer, txBufferSize);
+    if (s_uart_cobs_transport->init() == kErpcStatus_Success)
+    {
+        transport = reinterpret_cast<erpc_transport_t>(s_uart_cobs_transport.get());
+    }
+    else
+    {
+        transport = NULL;
+    }
+
+    return transport;
+}
+
+erpc_mbf_t erpc_mbf_uart_cobs_init(erpc_transport_t transport)
+{
+    s_uart_cobs_msgFactory.construct(reinterpret_cast<UartCobsTransport *>(transport));
+    return reinterpret_cast<erpc_mbf_t>(s_uart_cobs_msgFactory.get());
+}
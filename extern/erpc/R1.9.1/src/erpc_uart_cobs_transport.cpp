@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Ambiq Micro, Inc.
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "erpc_uart_cobs_transport.hpp"
+#include "erpc_config_internal.h"
+
+#include <cstring>
+
+using namespace erpc;
+
+////////////////////////////////////////////////////////////////////////////////
+// Definitions
+////////////////////////////////////////////////////////////////////////////////
+
+#define ERPC_UART_COBS_CRC_SIZE (sizeof(uint16_t))
+
+////////////////////////////////////////////////////////////////////////////////
+// Code
+////////////////////////////////////////////////////////////////////////////////
+
+UartCobsTransport::UartCobsTransport(ns_uart_handle_t uartHandle, uint8_t *txBuffer,
+                                     uint32_t txBufferSize)
+: Transport()
+, m_uartHandle(uartHandle)
+, m_framer(((ns_uart_config_t *)uartHandle)->framer)
+, m_txBuffer(txBuffer)
+, m_txBufferSize(txBufferSize)
+, m_crcImpl(NULL)
+, m_crcErrors(0)
+{
+}
+
+UartCobsTransport::~UartCobsTransport(void) {}
+
+erpc_status_t UartCobsTransport::init(void)
+{
+    if ((m_framer == NULL) || (m_txBuffer == NULL))
+    {
+        return kErpcStatus_InitFailed;
+    }
+    return kErpcStatus_Success;
+}
+
+void UartCobsTransport::setCrc16(Crc16 *crcImpl)
+{
+    erpc_assert(crcImpl);
+    m_crcImpl = crcImpl;
+}
+
+uint16_t UartCobsTransport::getMessageSize(void) const
+{
+    uint32_t size = ns_uart_framer_payload_max(m_framer) - ERPC_UART_COBS_CRC_SIZE;
+    return (size > UINT16_MAX) ? UINT16_MAX : (uint16_t)size;
+}
+
+bool UartCobsTransport::hasMessage(void)
+{
+    return ns_uart_framer_available(m_framer);
+}
+
+erpc_status_t UartCobsTransport::receive(MessageBuffer *message)
+{
+    uint8_t *frame;
+    uint32_t len;
+    uint32_t size;
+    uint16_t crc;
+
+    erpc_assert((m_crcImpl != NULL) && ("Uninitialized Crc16 object." != NULL));
+
+    // Frames are assembled by the UART interrupt
+    while (!ns_uart_framer_get(m_framer, &frame, &len))
+    {
+    }
+
+    if (len <= ERPC_UART_COBS_CRC_SIZE)
+    {
+        ns_uart_framer_release(m_framer, frame);
+        return kErpcStatus_ReceiveFailed;
+    }
+
+    size = len - ERPC_UART_COBS_CRC_SIZE;
+    crc = (uint16_t)(frame[size] | (frame[size + 1] << 8));
+    if (m_crcImpl->computeCRC16(frame, size) != crc)
+    {
+        m_crcErrors++;
+        ns_uart_framer_release(m_framer, frame);
+        return kErpcStatus_CrcCheckFailed;
+    }
+
+    if (ns_uart_framer_owns(m_framer, message->get()))
+    {
+        // Zero copy: the frame becomes the message, the message's buffer goes back to the
+        // framer for reception
+        ns_uart_framer_release(m_framer, message->get());
+        message->set(frame, getMessageSize());
+    }
+    else
+    {
+        if (size > message->getLength())
+        {
+            ns_uart_framer_release(m_framer, frame);
+            return kErpcStatus_ReceiveFailed;
+        }
+        (void)memcpy(message->get(), frame, size);
+        ns_uart_framer_release(m_framer, frame);
+    }
+    message->setUsed((uint16_t)size);
+
+    return kErpcStatus_Success;
+}
+
+erpc_status_t UartCobsTransport::send(MessageBuffer *message)
+{
+    ns_uart_config_t *cfg = (ns_uart_config_t *)m_uartHandle;
+    uint16_t used = message->getUsed();
+    uint16_t crc;
+    uint8_t trailer[ERPC_UART_COBS_CRC_SIZE];
+    uint32_t len;
+    uint32_t status;
+
+    erpc_assert((m_crcImpl != NULL) && ("Uninitialized Crc16 object." != NULL));
+
+    crc = m_crcImpl->computeCRC16(message->get(), used);
+    trailer[0] = (uint8_t)(crc & 0xFFU);
+    trailer[1] = (uint8_t)(crc >> 8);
+
+    len = ns_uart_cobs_encode(message->get(), used, trailer, sizeof(trailer), m_txBuffer,
+                              m_txBufferSize);
+    if (len == 0U)
+    {
+        return kErpcStatus_SendFailed;
+    }
+
+    if (cfg->tx_blocking)
+    {
+        status = ns_uart_blocking_send_data(cfg, (char *)m_txBuffer, len);
+    }
+    else
+    {
+        status = ns_uart_nonblocking_send_data(cfg, (char *)m_txBuffer, len);
+    }
+    return (status != AM_HAL_STATUS_SUCCESS) ? kErpcStatus_SendFailed : kErpcStatus_Success;
+}
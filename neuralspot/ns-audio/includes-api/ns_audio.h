@@ -234,6 +234,15 @@ extern void ns_audio_getPCM(int16_t *pcm, uint32_t *raw, int16_t len);
  */
 extern void ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm);
 
+/**
+ * @brief Extract int16 PCM from AUDADC or PDM sources into one buffer per channel
+ *
+ * @param config - ns audio config
+ * @param ch0 - numSamples of channel 0 (left/MIC0)
+ * @param ch1 - numSamples of channel 1 (right), unused if numChannels is 1
+ */
+extern void ns_audio_getPCM_planar(ns_audio_config_t *config, int16_t *ch0, int16_t *ch1);
+
 /**
  * @brief Set gain of audio source
  *
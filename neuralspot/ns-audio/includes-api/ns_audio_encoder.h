@@ -0,0 +1,226 @@
+/**
+ * @file ns_audio_encoder.h
+ * @author Ambiq
+ * @brief Audio encode stage: PCM frame pool in, timestamped variable-length packets out
+ * @version 0.1
+ * @date 2025-08-06
+ *
+ * Decouples the three parts of an audio streaming application so each can run at its own pace:
+ *
+ * - capture (usually the ns_audio callback, in interrupt context) fills PCM frames from a pool
+ *   with ns_audio_enc_capture() or ns_audio_enc_capture_ring(), or with
+ *   ns_audio_enc_frame_acquire() and ns_audio_enc_frame_submit() for other sources
+ * - ns_audio_enc_process() encodes every captured frame straight into a packet queue
+ * - the transport (BLE, RPC, ...) takes packets from the queue in place with
+ *   ns_audio_enc_peek() and ns_audio_enc_release(), or through a sink with
+ *   ns_audio_enc_drain()
+ *
+ * A packet stays in the queue until the transport releases it, so the next frames are encoded
+ * while earlier packets are still being transmitted, and a slow link backs up into the queue
+ * and then the frame pool instead of stalling capture. Packets carry a sequence number and the
+ * timestamp of their first sample, in samples per channel since init (frames lost to a full
+ * pool still advance it, so receivers can conceal the gap).
+ *
+ * The codec is reached through ns_audio_codec_t. Bitrate and complexity can be changed from
+ * any context; the change is applied by ns_audio_enc_process() before the next frame.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-audio-encoder
+ *  @{
+ */
+
+#ifndef NS_AUDIO_ENCODER_H
+    #define NS_AUDIO_ENCODER_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_AUDIO_ENC_V0_0_1                                                                    \
+        { .major = 0, .minor = 0, .revision = 1 }
+    #define NS_AUDIO_ENC_OLDEST_SUPPORTED_VERSION NS_AUDIO_ENC_V0_0_1
+    #define NS_AUDIO_ENC_CURRENT_VERSION NS_AUDIO_ENC_V0_0_1
+    #define NS_AUDIO_ENC_API_ID 0xCA0013
+
+extern const ns_core_api_t ns_audio_enc_V0_0_1;
+extern const ns_core_api_t ns_audio_enc_oldest_supported_version;
+extern const ns_core_api_t ns_audio_enc_current_version;
+
+    #define NS_AUDIO_ENC_MAX_FRAMES 16 ///< Frame pool size limit (power of two)
+
+    /// Bytes of packet queue used by a packet of len bytes (header and alignment included)
+    #define NS_AUDIO_ENC_PACKET_FOOTPRINT(len) (8u + (((uint32_t)(len) + 3u) & ~3u))
+
+    /// Smallest packet queue for a maxPacket, holds at least one packet wherever the queue is
+    #define NS_AUDIO_ENC_QUEUE_MIN(maxPacket) (2u * NS_AUDIO_ENC_PACKET_FOOTPRINT(maxPacket) + 8u)
+
+/// Encoder binding. encode returns the packet length, or a negative codec error.
+typedef struct {
+    int32_t (*encode)(void *ctx, const int16_t *pcm, uint32_t samples, uint8_t *out, uint32_t cap);
+    uint32_t (*set_bitrate)(void *ctx, uint32_t bitsPerSecond);  ///< Optional
+    uint32_t (*set_complexity)(void *ctx, uint8_t complexity);   ///< Optional
+    void *ctx;
+} ns_audio_codec_t;
+
+/// An encoded packet, pointing into the packet queue
+typedef struct {
+    uint8_t *data;
+    uint16_t len;
+    uint16_t seq;
+    uint32_t timestamp; ///< First sample, in samples per channel since init
+} ns_audio_packet_t;
+
+/// Transport used by ns_audio_enc_drain(), returns NS_STATUS_SUCCESS once it is done with the
+/// packet, anything else to keep it queued and stop draining (e.g. link busy)
+typedef struct {
+    uint32_t (*send)(void *ctx, const ns_audio_packet_t *packet);
+    void *ctx;
+} ns_audio_enc_sink_t;
+
+typedef struct {
+    uint32_t frames;       ///< Frames encoded
+    uint32_t bytes;        ///< Encoded bytes
+    uint32_t maxPacket;    ///< Largest packet
+    uint32_t overruns;     ///< Frames lost because the pool was full
+    uint32_t stalls;       ///< ns_audio_enc_process() calls stopped by a full packet queue
+    uint32_t encodeErrors; ///< Frames the codec failed to encode (dropped)
+    uint32_t sent;         ///< Packets released by the transport
+} ns_audio_enc_stats_t;
+
+typedef struct {
+    const ns_core_api_t *api;
+    const ns_audio_codec_t *codec;
+    uint16_t frameSamples; ///< PCM samples per frame, all channels (interleaved)
+    uint8_t numChannels;
+    uint8_t numFrames;     ///< Frames in pcmPool, power of two up to NS_AUDIO_ENC_MAX_FRAMES
+    int16_t *pcmPool;      ///< numFrames * frameSamples samples
+    uint8_t *packetBuf;    ///< Packet queue, 4 byte aligned
+    uint32_t packetBufSize; ///< At least NS_AUDIO_ENC_QUEUE_MIN(maxPacket)
+    uint16_t maxPacket;    ///< Codec output limit per frame
+    uint32_t bitrate;      ///< Applied at init, 0 for the codec's default
+    int16_t complexity;    ///< Applied at init, negative for the codec's default
+
+    // Internal state
+    volatile uint32_t frameHead; ///< Frames submitted (capture)
+    volatile uint32_t frameTail; ///< Frames consumed (encoder)
+    uint32_t frameTimestamp[NS_AUDIO_ENC_MAX_FRAMES];
+    uint32_t sampleClock; ///< Timestamp of the next captured frame
+    volatile uint32_t packetHead; ///< Write offset in packetBuf (encoder)
+    volatile uint32_t packetTail; ///< Read offset in packetBuf (transport)
+    volatile uint32_t packetsQueued;
+    volatile uint32_t packetsReleased;
+    uint16_t seq;
+    volatile uint32_t requestedBitrate; ///< Set from any context
+    volatile int16_t requestedComplexity;
+    uint32_t appliedBitrate; ///< Last value handed to the codec (encoder context)
+    int16_t appliedComplexity;
+    ns_audio_enc_stats_t stats;
+} ns_audio_enc_t;
+
+struct ns_audio_cfg;
+
+/**
+ * @brief Validate the configuration, empty the pool and queue, apply bitrate and complexity
+ *
+ * @param e Encode stage
+ * @return uint32_t status
+ */
+extern uint32_t ns_audio_enc_init(ns_audio_enc_t *e);
+
+/**
+ * @brief Get the next free frame of the pool (capture side)
+ *
+ * @param e Encode stage
+ * @return int16_t* frameSamples samples to fill, or NULL if the pool is full (the frame is
+ * counted as an overrun and its samples skipped in the timestamps)
+ */
+extern int16_t *ns_audio_enc_frame_acquire(ns_audio_enc_t *e);
+
+/**
+ * @brief Queue the frame returned by the last ns_audio_enc_frame_acquire() for encoding
+ *
+ * @param e Encode stage
+ */
+extern void ns_audio_enc_frame_submit(ns_audio_enc_t *e);
+
+/**
+ * @brief Copy the frame ns_audio just captured into the pool, call from the ns_audio callback
+ *
+ * The frame (numSamples * numChannels samples) must match frameSamples.
+ *
+ * @param e Encode stage
+ * @param cfg ns_audio configuration that invoked the callback
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the pool was full
+ */
+extern uint32_t ns_audio_enc_capture(ns_audio_enc_t *e, struct ns_audio_cfg *cfg);
+
+/**
+ * @brief Move every complete frame from an ns_audio ring buffer (NS_AUDIO_API_RINGBUFFER)
+ *
+ * @param e Encode stage
+ * @param cfg ns_audio configuration, its bufferHandle is drained
+ * @return uint32_t Frames moved into the pool
+ */
+extern uint32_t ns_audio_enc_capture_ring(ns_audio_enc_t *e, struct ns_audio_cfg *cfg);
+
+/**
+ * @brief Encode captured frames into the packet queue
+ *
+ * Stops early when the queue cannot hold another maxPacket byte packet; the remaining frames
+ * stay in the pool until the transport releases packets.
+ *
+ * @param e Encode stage
+ * @return uint32_t Frames encoded
+ */
+extern uint32_t ns_audio_enc_process(ns_audio_enc_t *e);
+
+/**
+ * @brief Oldest queued packet, left in the queue until ns_audio_enc_release()
+ *
+ * @param e Encode stage
+ * @param packet Filled with the packet
+ * @return true if there was a packet
+ */
+extern bool ns_audio_enc_peek(ns_audio_enc_t *e, ns_audio_packet_t *packet);
+
+/**
+ * @brief Drop the packet returned by ns_audio_enc_peek(), making its space available
+ *
+ * @param e Encode stage
+ */
+extern void ns_audio_enc_release(ns_audio_enc_t *e);
+
+/**
+ * @brief Hand queued packets to a sink until the queue is empty or the sink is busy
+ *
+ * @param e Encode stage
+ * @param sink Transport
+ * @return uint32_t Packets sent
+ */
+extern uint32_t ns_audio_enc_drain(ns_audio_enc_t *e, const ns_audio_enc_sink_t *sink);
+
+/**
+ * @brief Number of packets waiting for the transport
+ */
+extern uint32_t ns_audio_enc_queued(const ns_audio_enc_t *e);
+
+/**
+ * @brief Request a new bitrate, applied before the next frame is encoded
+ */
+extern void ns_audio_enc_set_bitrate(ns_audio_enc_t *e, uint32_t bitsPerSecond);
+
+/**
+ * @brief Request a new complexity, applied before the next frame is encoded
+ */
+extern void ns_audio_enc_set_complexity(ns_audio_enc_t *e, uint8_t complexity);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @} */
@@ -0,0 +1,159 @@
+/**
+ * @file ns_audio_kws_stream.h
+ * @author Ambiq
+ * @brief Continuous (always-on) keyword spotting feature pipeline
+ * @version 0.1
+ * @date 2025-07-01
+ *
+ * The KWS stream turns the 'record one second, then infer' flow into an
+ * always-on detector. Every audio hop is converted to MFCCs, quantized
+ * once into a rolling int8 feature ring laid out exactly like the model's
+ * input tensor, and the model is invoked every 'stride' hops. Model outputs
+ * are smoothed by averaging posteriors over the last few inferences.
+ *
+ * The feature ring is mirrored (each frame is written twice, num_frames apart)
+ * so the most recent window is always available as one contiguous block -
+ * no shifting is needed, and handing the window to the model is one memcpy.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-kws-stream
+ *  @{
+ */
+
+#ifndef NS_AUDIO_KWS_STREAM_H
+    #define NS_AUDIO_KWS_STREAM_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_audio_mfcc.h"
+    #include "ns_core.h"
+
+    #define NS_KWS_STREAM_V0_0_1                                                                   \
+        { .major = 0, .minor = 0, .revision = 1 }
+    #define NS_KWS_STREAM_OLDEST_SUPPORTED_VERSION NS_KWS_STREAM_V0_0_1
+    #define NS_KWS_STREAM_CURRENT_VERSION NS_KWS_STREAM_V0_0_1
+    #define NS_KWS_STREAM_API_ID 0xCA000D
+
+extern const ns_core_api_t ns_kws_stream_V0_0_1;
+extern const ns_core_api_t ns_kws_stream_oldest_supported_version;
+extern const ns_core_api_t ns_kws_stream_current_version;
+
+    #define NS_KWS_STREAM_NO_DETECTION -1
+
+/// Arena needed by the KWS stream (mirrored feature ring, posterior history, MFCC scratch)
+    #define NS_KWS_STREAM_ARENA_SIZE(num_frames, num_coeffs, num_classes, smoothing_window)      \
+        (2 * (num_frames) * (num_coeffs) + 2 * (smoothing_window) * (num_classes) +               \
+         4 * (num_classes) + 4 * (num_coeffs) + 4)
+
+/**
+ * @brief Config and state for the KWS stream
+ *
+ */
+typedef struct {
+    const ns_core_api_t *api; ///< API prefix
+    ns_mfcc_cfg_t *mfcc;      ///< Initialized MFCC calculator, one hop per frame (NULL if
+                              ///< features are pushed directly)
+    uint8_t *arena;           ///< See NS_KWS_STREAM_ARENA_SIZE (allocated by caller)
+    uint32_t arena_size;      ///< Size of arena in bytes
+
+    // Feature config
+    uint32_t num_frames;    ///< Frames in one model window (e.g. 49)
+    uint32_t num_coeffs;    ///< Features per frame (e.g. 10)
+    uint32_t stride;        ///< Hops between inferences (1 = infer on every hop)
+    float input_scale;      ///< Model input quantization scale
+    int32_t input_zero_point; ///< Model input quantization zero point
+
+    // Posterior smoothing config
+    uint32_t num_classes;      ///< Number of model output classes
+    float output_scale;        ///< Model output quantization scale
+    int32_t output_zero_point; ///< Model output quantization zero point
+    uint32_t smoothing_window; ///< Number of inferences averaged
+    float threshold;           ///< Smoothed posterior needed for a detection (0.0-1.0)
+    uint32_t suppression;      ///< Inferences ignored after a detection
+    uint32_t ignore_mask;      ///< Bitmask of classes that never trigger (e.g. silence)
+
+    // Internals (set by ns_kws_stream_init)
+    int8_t *ring;             ///< Mirrored feature ring, 2 * num_frames * num_coeffs
+    int16_t *scores;          ///< Posterior history (q - zero_point), smoothing_window * num_classes
+    int32_t *score_sums;      ///< Running per-class posterior sums
+    float *mfcc_scratch;      ///< One frame of float MFCCs
+    float input_inv_scale;    ///< 1 / input_scale
+    int32_t threshold_sum;    ///< threshold expressed as a quantized window sum
+    uint32_t head;            ///< Next frame slot in the ring
+    uint32_t frames_seen;     ///< Frames pushed since reset (saturates at num_frames)
+    uint32_t hops_since_infer; ///< Hops since the last inference was requested
+    uint32_t score_head;      ///< Next slot in the posterior history
+    uint32_t scores_seen;     ///< Inferences pushed since reset (saturates at window)
+    uint32_t suppress_count;  ///< Remaining inferences to suppress
+} ns_kws_stream_cfg_t;
+
+/**
+ * @brief Initialize the KWS stream, mapping its arena and precomputing quantization constants
+ *
+ * @param c configuration struct (see ns_kws_stream_cfg_t)
+ * @return uint32_t status
+ */
+extern uint32_t ns_kws_stream_init(ns_kws_stream_cfg_t *c);
+
+/**
+ * @brief Clear feature and posterior history (e.g. after a pause in audio capture)
+ *
+ * @param c configuration struct
+ */
+extern void ns_kws_stream_reset(ns_kws_stream_cfg_t *c);
+
+/**
+ * @brief Compute MFCCs for one hop of audio and append them to the feature ring
+ *
+ * @param c configuration struct
+ * @param audio_data one frame of PCM audio (mfcc->frame_len samples)
+ * @return true if the window is full and an inference is due
+ */
+extern bool ns_kws_stream_push_audio(ns_kws_stream_cfg_t *c, const int16_t *audio_data);
+
+/**
+ * @brief Quantize one frame of float features and append them to the feature ring
+ *
+ * @param c configuration struct
+ * @param features num_coeffs float features
+ * @return true if the window is full and an inference is due
+ */
+extern bool ns_kws_stream_push_features(ns_kws_stream_cfg_t *c, const float *features);
+
+/**
+ * @brief Returns the most recent window of quantized features, oldest frame first
+ *
+ * The returned block is num_frames * num_coeffs contiguous int8 values, in
+ * the same layout as the model's input tensor.
+ *
+ * @param c configuration struct
+ * @return const int8_t* window
+ */
+extern const int8_t *ns_kws_stream_get_window(ns_kws_stream_cfg_t *c);
+
+/**
+ * @brief Feed quantized model output into the posterior smoother
+ *
+ * @param c configuration struct
+ * @param scores num_classes quantized model outputs
+ * @return int32_t detected class index, or NS_KWS_STREAM_NO_DETECTION
+ */
+extern int32_t ns_kws_stream_push_scores(ns_kws_stream_cfg_t *c, const int8_t *scores);
+
+/**
+ * @brief Returns the smoothed posterior of a class (0.0-1.0), for reporting
+ *
+ * @param c configuration struct
+ * @param class_index class
+ * @return float smoothed posterior
+ */
+extern float ns_kws_stream_get_smoothed(ns_kws_stream_cfg_t *c, uint32_t class_index);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @} */ // End Doxygen Group
@@ -48,13 +48,16 @@ extern "C" {
         { .major = 0, .minor = 0, .revision = 1 }
     #define NS_MFCC_V1_0_0                                                                         \
         { .major = 1, .minor = 0, .revision = 0 }
+    #define NS_MFCC_V1_1_0                                                                         \
+        { .major = 1, .minor = 1, .revision = 0 }
 
     #define NS_MFCC_OLDEST_SUPPORTED_VERSION NS_MFCC_V0_0_1
-    #define NS_MFCC_CURRENT_VERSION NS_MFCC_V1_0_0
+    #define NS_MFCC_CURRENT_VERSION NS_MFCC_V1_1_0
     #define NS_MFCC_API_ID 0xCA0005
 
 extern const ns_core_api_t ns_mfcc_V0_0_1;
 extern const ns_core_api_t ns_mfcc_V1_0_0;
+extern const ns_core_api_t ns_mfcc_V1_1_0;
 extern const ns_core_api_t ns_mfcc_oldest_supported_version;
 extern const ns_core_api_t ns_mfcc_current_version;
 
@@ -91,6 +94,31 @@ typedef struct {
 // MY_MFCC_NUM_FBANK_BINS*(NS_MFCC_SIZEBINS+MY_MFCC_NUM_MFCC_COEFFS)) where '32' is size of float
 // and int32_t
 
+    #define NS_MFCC_MAX_CHANNELS 4
+
+/// Arena needed by the multi-channel MFCC (per-channel power spectra and filterbank energies)
+    #define NS_MFCC_MULTI_ARENA_SIZE(num_channels, frame_len_pow2, num_fbank_bins)                 \
+        (4 * (num_channels) * ((frame_len_pow2) + (num_fbank_bins)) + 4)
+
+/**
+ * @brief Config and state for computing MFCCs of several channels (e.g. a mic array)
+ *
+ * Channels share the FFT plan, window, filterbanks and DCT matrix of one
+ * initialized MFCC calculator. Filterbank and DCT coefficients are loaded once
+ * per frame and applied to every channel, so per-channel cost is mostly the FFT.
+ */
+typedef struct {
+    const ns_core_api_t *api; ///< API prefix (NS_MFCC_V1_1_0 or later)
+    ns_mfcc_cfg_t *mfcc;      ///< Initialized MFCC calculator, shared by all channels
+    uint32_t num_channels;    ///< Channels per frame, up to NS_MFCC_MAX_CHANNELS
+    uint8_t *arena;           ///< See NS_MFCC_MULTI_ARENA_SIZE (allocated by caller)
+    uint32_t arena_size;      ///< Size of arena in bytes
+
+    // Internals (set by ns_mfcc_multi_init)
+    float *spectra[NS_MFCC_MAX_CHANNELS]; ///< Per-channel power spectra
+    float *energies;                      ///< Filterbank energies, num_channels * num_fbank_bins
+} ns_mfcc_multi_cfg_t;
+
     #define M_2PI 6.283185307179586476925286766559005
     #ifndef M_PI
         #define M_PI 3.14159265358979323846264338328
@@ -123,6 +151,27 @@ extern uint32_t ns_mfcc_init(ns_mfcc_cfg_t *c);
  */
 extern uint32_t ns_mfcc_compute(ns_mfcc_cfg_t *c, const int16_t *audio_data, float *mfcc_out);
 
+/**
+ * @brief Initializes a multi-channel MFCC calculator on top of an initialized ns_mfcc_cfg_t
+ *
+ * @param c configuration struct (see ns_mfcc_multi_cfg_t)
+ * @return uint32_t status
+ */
+extern uint32_t ns_mfcc_multi_init(ns_mfcc_multi_cfg_t *c);
+
+/**
+ * @brief Computes MFCCs for one frame of every channel
+ *
+ * Results are identical to calling ns_mfcc_compute() once per channel.
+ *
+ * @param c - configuration struct from ns_mfcc_multi_init
+ * @param audio_data - per-channel pointers to planar audio data (frame_len samples each)
+ * @param mfcc_out - per-channel pointers to output buffers (num_coeffs each)
+ * @return uint32_t status
+ */
+extern uint32_t ns_mfcc_multi_compute(
+    ns_mfcc_multi_cfg_t *c, const int16_t *const *audio_data, float *const *mfcc_out);
+
     #ifdef __cplusplus
 }
     #endif
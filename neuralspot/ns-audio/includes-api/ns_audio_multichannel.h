@@ -0,0 +1,96 @@
+/**
+ * @file ns_audio_multichannel.h
+ * @author Ambiq
+ * @brief Planar multi-channel audio helpers: deinterleave and mixdown/beamforming
+ * @version 0.1
+ * @date 2025-07-10
+ *
+ * Dual-mic captures arrive interleaved (PDM: L,R,L,R...) or tagged per sample
+ * (AUDADC). Feature extractors want one contiguous buffer per channel, so
+ * captures are split once into planar buffers with ns_audio_deinterleave()
+ * (or ns_audio_getPCM_planar(), see ns_audio.h). Planar channels can then be
+ * handed to ns_mfcc_multi_compute(), or combined into a single channel with
+ * the delay-and-sum mixdown stage below.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-audio-multichannel
+ *  @{
+ */
+
+#ifndef NS_AUDIO_MULTICHANNEL_H
+    #define NS_AUDIO_MULTICHANNEL_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+
+    #define NS_AUDIO_MIX_V0_0_1                                                                    \
+        { .major = 0, .minor = 0, .revision = 1 }
+    #define NS_AUDIO_MIX_OLDEST_SUPPORTED_VERSION NS_AUDIO_MIX_V0_0_1
+    #define NS_AUDIO_MIX_CURRENT_VERSION NS_AUDIO_MIX_V0_0_1
+    #define NS_AUDIO_MIX_API_ID 0xCA000E
+
+extern const ns_core_api_t ns_audio_mix_V0_0_1;
+extern const ns_core_api_t ns_audio_mix_oldest_supported_version;
+extern const ns_core_api_t ns_audio_mix_current_version;
+
+    #define NS_AUDIO_MIX_MAX_DELAY 32 ///< Max steering delay, in samples
+
+/**
+ * @brief Config and state for the two-channel delay-and-sum mixdown
+ *
+ * out[n] = (weight0 * ch0[n] + weight1 * ch1[n - delay]) >> 15, saturated.
+ * With weights of 0.5 and delay 0 this is a plain mono mixdown; a non-zero
+ * delay steers the beam towards sources reaching ch1 'delay' samples early.
+ * The delayed ch1 samples are carried across frames.
+ */
+typedef struct {
+    const ns_core_api_t *api; ///< API prefix
+    int16_t weight0;          ///< Q15 gain of channel 0
+    int16_t weight1;          ///< Q15 gain of channel 1
+    uint16_t delay;           ///< Delay applied to channel 1, in samples (<= NS_AUDIO_MIX_MAX_DELAY)
+
+    // Internals
+    int16_t history[NS_AUDIO_MIX_MAX_DELAY]; ///< Last 'delay' samples of channel 1
+} ns_audio_mix_cfg_t;
+
+/**
+ * @brief Split interleaved two-channel PCM (ch0, ch1, ch0, ...) into planar buffers
+ *
+ * @param interleaved - 2 * num_samples interleaved samples
+ * @param ch0 - num_samples of channel 0
+ * @param ch1 - num_samples of channel 1
+ * @param num_samples - samples per channel
+ */
+extern void ns_audio_deinterleave(
+    const int16_t *interleaved, int16_t *ch0, int16_t *ch1, uint32_t num_samples);
+
+/**
+ * @brief Initialize the mixdown stage and clear its delay line
+ *
+ * @param c configuration struct (see ns_audio_mix_cfg_t)
+ * @return uint32_t status
+ */
+extern uint32_t ns_audio_mix_init(ns_audio_mix_cfg_t *c);
+
+/**
+ * @brief Mix two planar channels into one
+ *
+ * @param c configuration struct
+ * @param ch0 - num_samples of channel 0
+ * @param ch1 - num_samples of channel 1
+ * @param out - num_samples of mixed audio (may alias ch0)
+ * @param num_samples - samples per channel
+ */
+extern void ns_audio_mix(
+    ns_audio_mix_cfg_t *c, const int16_t *ch0, const int16_t *ch1, int16_t *out,
+    uint32_t num_samples);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @} */ // End Doxygen Group
@@ -17,6 +17,7 @@
 //*****************************************************************************
 
 #include "ns_audio.h"
+#include "ns_audio_multichannel.h"
 #include "am_bsp.h"
 #include "am_mcu_apollo.h"
 #include "am_util.h"
@@ -27,6 +28,7 @@
 
 #include "ns_ipc_ring_buffer.h"
 #include "ns_pdm.h"
+#include <string.h>
 
 const ns_core_api_t ns_audio_V0_0_1 = {.apiId = NS_AUDIO_API_ID, .version = NS_AUDIO_V0_0_1};
 const ns_core_api_t ns_audio_V1_0_0 = {.apiId = NS_AUDIO_API_ID, .version = NS_AUDIO_V1_0_0};
@@ -257,10 +259,12 @@ void ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm) {
             config->audioSystemHandle, config->sampleBuffer, &ui32PcmSampleCnt, true,
             config->workingBuffer, false, NULL, config->sOffsetCalib);
     #endif
-        for (int i = 0; i < ui32PcmSampleCnt; i++) {
-            if (config->numChannels == 1) {
+        if (config->numChannels == 1) {
+            for (int i = 0; i < ui32PcmSampleCnt; i++) {
                 pcm16[i] = config->workingBuffer[i].int16Sample;
-            } else {
+            }
+        } else {
+            for (int i = 0; i < ui32PcmSampleCnt; i++) {
                 if (config->workingBuffer[i].ui16AudChannel == 0) {
                     // Low gain samples (MIC0) data to left channel.
                     pcm32[LeftChCount++] = (config->workingBuffer[i].int16Sample & 0x0000FFFF);
@@ -276,6 +280,44 @@ void ns_audio_getPCM_v2(ns_audio_config_t *config, void *pcm) {
 #endif
 }
 
+void ns_audio_getPCM_planar(ns_audio_config_t *config, int16_t *ch0, int16_t *ch1) {
+    if (config->eAudioSource == NS_AUDIO_SOURCE_PDM) {
+        // PDM ISR has already re-arranged samples into audioBuffer (interleaved if stereo)
+        if (config->numChannels == 1) {
+            memcpy(ch0, config->audioBuffer, config->numSamples * sizeof(int16_t));
+        } else {
+            ns_audio_deinterleave(
+                (const int16_t *)config->audioBuffer, ch0, ch1, config->numSamples);
+        }
+        return;
+    }
+#ifdef NS_AUDADC_PRESENT
+    uint32_t ui32PcmSampleCnt = config->numSamples * config->numChannels;
+    #ifdef NS_AMBIQSUITE_VERSION_R4_1_0
+    am_hal_audadc_samples_read(
+        config->audioSystemHandle, config->sampleBuffer, &ui32PcmSampleCnt, true,
+        config->workingBuffer, false, NULL);
+    #else
+    am_hal_audadc_samples_read(
+        config->audioSystemHandle, config->sampleBuffer, &ui32PcmSampleCnt, true,
+        config->workingBuffer, false, NULL, config->sOffsetCalib);
+    #endif
+    if (config->numChannels == 1) {
+        for (uint32_t i = 0; i < ui32PcmSampleCnt; i++) {
+            ch0[i] = config->workingBuffer[i].int16Sample;
+        }
+    } else {
+        // Channel tag selects the destination directly instead of branching per sample
+        int16_t *dst[2] = {ch0, ch1};
+        uint32_t count[2] = {0, 0};
+        for (uint32_t i = 0; i < ui32PcmSampleCnt; i++) {
+            uint32_t ch = config->workingBuffer[i].ui16AudChannel & 1;
+            dst[ch][count[ch]++] = config->workingBuffer[i].int16Sample;
+        }
+    }
+#endif
+}
+
 uint32_t ns_audio_set_gain(int left_gain, int right_gain) {
     if (g_ns_audio_config == NULL) {
         return NS_STATUS_FAILURE;
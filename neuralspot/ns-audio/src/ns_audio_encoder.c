@@ -0,0 +1,237 @@
+/**
+ * @file ns_audio_encoder.c
+ * @author Ambiq
+ * @brief Audio encode stage: PCM frame pool in, timestamped variable-length packets out
+ * @version 0.1
+ * @date 2025-08-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_audio_encoder.h"
+#include "ns_core.h"
+#include <string.h>
+
+const ns_core_api_t ns_audio_enc_V0_0_1 = {
+    .apiId = NS_AUDIO_ENC_API_ID, .version = NS_AUDIO_ENC_V0_0_1};
+
+const ns_core_api_t ns_audio_enc_oldest_supported_version = {
+    .apiId = NS_AUDIO_ENC_API_ID, .version = NS_AUDIO_ENC_V0_0_1};
+
+const ns_core_api_t ns_audio_enc_current_version = {
+    .apiId = NS_AUDIO_ENC_API_ID, .version = NS_AUDIO_ENC_V0_0_1};
+
+// Capture, encoder and transport each own one side of a queue and run on one core, so a
+// compiler barrier is enough to publish entries before the index that covers them
+#define NS_AUDIO_ENC_BARRIER() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+#define NS_AUDIO_ENC_HEADER 8
+#define NS_AUDIO_ENC_WRAP 0xFFFF // Packet length marking the end of the used part of packetBuf
+
+// Packet header, followed by the packet, padded to 4 bytes
+typedef struct {
+    uint16_t len;
+    uint16_t seq;
+    uint32_t timestamp;
+} ns_audio_enc_header_t;
+
+uint32_t ns_audio_enc_init(ns_audio_enc_t *e) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (e == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(
+            e->api, &ns_audio_enc_oldest_supported_version, &ns_audio_enc_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((e->codec == NULL) || (e->codec->encode == NULL) || (e->pcmPool == NULL) ||
+        (e->packetBuf == NULL) || ((uintptr_t)e->packetBuf & 3) || (e->frameSamples == 0) ||
+        (e->numChannels == 0) || (e->frameSamples % e->numChannels) || (e->numFrames == 0) ||
+        (e->numFrames > NS_AUDIO_ENC_MAX_FRAMES) || (e->numFrames & (e->numFrames - 1)) ||
+        (e->maxPacket == 0) || (e->maxPacket >= NS_AUDIO_ENC_WRAP)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (e->packetBufSize < NS_AUDIO_ENC_QUEUE_MIN(e->maxPacket)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    e->frameHead = 0;
+    e->frameTail = 0;
+    e->sampleClock = 0;
+    e->packetHead = 0;
+    e->packetTail = 0;
+    e->packetsQueued = 0;
+    e->packetsReleased = 0;
+    e->seq = 0;
+    memset(&e->stats, 0, sizeof(e->stats));
+
+    e->appliedBitrate = e->requestedBitrate = e->bitrate;
+    e->appliedComplexity = e->requestedComplexity = e->complexity;
+    if ((e->bitrate != 0) && (e->codec->set_bitrate != NULL)) {
+        uint32_t status = e->codec->set_bitrate(e->codec->ctx, e->bitrate);
+        if (status != NS_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    if ((e->complexity >= 0) && (e->codec->set_complexity != NULL)) {
+        uint32_t status = e->codec->set_complexity(e->codec->ctx, (uint8_t)e->complexity);
+        if (status != NS_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+int16_t *ns_audio_enc_frame_acquire(ns_audio_enc_t *e) {
+    if (e->frameHead - e->frameTail >= e->numFrames) {
+        e->stats.overruns++;
+        e->sampleClock += e->frameSamples / e->numChannels;
+        return NULL;
+    }
+    return e->pcmPool + (e->frameHead & (e->numFrames - 1)) * e->frameSamples;
+}
+
+void ns_audio_enc_frame_submit(ns_audio_enc_t *e) {
+    e->frameTimestamp[e->frameHead & (e->numFrames - 1)] = e->sampleClock;
+    e->sampleClock += e->frameSamples / e->numChannels;
+    NS_AUDIO_ENC_BARRIER();
+    e->frameHead++;
+}
+
+// Offset where the next packet (up to maxPacket bytes) can be written, or -1 if the transport
+// has to release packets first. The head never catches up with the tail from behind, so
+// head == tail always means empty. With NS_AUDIO_ENC_QUEUE_MIN bytes, an empty queue always
+// has room either before the end or before the tail.
+static int32_t ns_audio_enc_reserve(const ns_audio_enc_t *e) {
+    uint32_t need = NS_AUDIO_ENC_PACKET_FOOTPRINT(e->maxPacket);
+    uint32_t head = e->packetHead;
+    uint32_t tail = e->packetTail;
+
+    if (head >= tail) {
+        // Keep room at the end for the wrap marker
+        if (head + need + NS_AUDIO_ENC_HEADER <= e->packetBufSize) {
+            return (int32_t)head;
+        }
+        return (need < tail) ? 0 : -1;
+    }
+    return (head + need < tail) ? (int32_t)head : -1;
+}
+
+static void ns_audio_enc_apply_knobs(ns_audio_enc_t *e) {
+    const ns_audio_codec_t *codec = e->codec;
+    uint32_t bitrate = e->requestedBitrate;
+    int16_t complexity = e->requestedComplexity;
+
+    if (bitrate != e->appliedBitrate) {
+        e->appliedBitrate = bitrate;
+        if (codec->set_bitrate != NULL) {
+            codec->set_bitrate(codec->ctx, bitrate);
+        }
+    }
+    if (complexity != e->appliedComplexity) {
+        e->appliedComplexity = complexity;
+        if (codec->set_complexity != NULL) {
+            codec->set_complexity(codec->ctx, (uint8_t)complexity);
+        }
+    }
+}
+
+uint32_t ns_audio_enc_process(ns_audio_enc_t *e) {
+    uint32_t encoded = 0;
+
+    ns_audio_enc_apply_knobs(e);
+
+    while (e->frameTail != e->frameHead) {
+        int32_t offset = ns_audio_enc_reserve(e);
+        if (offset < 0) {
+            e->stats.stalls++;
+            break;
+        }
+
+        uint32_t slot = e->frameTail & (e->numFrames - 1);
+        ns_audio_enc_header_t *h = (ns_audio_enc_header_t *)(e->packetBuf + offset);
+        int32_t len = e->codec->encode(
+            e->codec->ctx, e->pcmPool + slot * e->frameSamples, e->frameSamples,
+            (uint8_t *)h + NS_AUDIO_ENC_HEADER, e->maxPacket);
+
+        if ((len < 0) || (len > e->maxPacket)) {
+            e->stats.encodeErrors++;
+        } else {
+            h->len = (uint16_t)len;
+            h->seq = e->seq++;
+            h->timestamp = e->frameTimestamp[slot];
+            if ((uint32_t)offset != e->packetHead) {
+                // Wrapped: tell the transport to continue at the start
+                ((ns_audio_enc_header_t *)(e->packetBuf + e->packetHead))->len = NS_AUDIO_ENC_WRAP;
+            }
+            NS_AUDIO_ENC_BARRIER();
+            e->packetHead = offset + NS_AUDIO_ENC_PACKET_FOOTPRINT(len);
+            e->packetsQueued++;
+
+            e->stats.frames++;
+            e->stats.bytes += len;
+            e->stats.maxPacket = MAX(e->stats.maxPacket, (uint32_t)len);
+            encoded++;
+        }
+        NS_AUDIO_ENC_BARRIER();
+        e->frameTail++;
+    }
+    return encoded;
+}
+
+bool ns_audio_enc_peek(ns_audio_enc_t *e, ns_audio_packet_t *packet) {
+    uint32_t tail = e->packetTail;
+
+    if (tail == e->packetHead) {
+        return false;
+    }
+    const ns_audio_enc_header_t *h = (const ns_audio_enc_header_t *)(e->packetBuf + tail);
+    if (h->len == NS_AUDIO_ENC_WRAP) {
+        e->packetTail = tail = 0;
+        h = (const ns_audio_enc_header_t *)e->packetBuf;
+    }
+    packet->data = e->packetBuf + tail + NS_AUDIO_ENC_HEADER;
+    packet->len = h->len;
+    packet->seq = h->seq;
+    packet->timestamp = h->timestamp;
+    return true;
+}
+
+void ns_audio_enc_release(ns_audio_enc_t *e) {
+    const ns_audio_enc_header_t *h = (const ns_audio_enc_header_t *)(e->packetBuf + e->packetTail);
+
+    NS_AUDIO_ENC_BARRIER();
+    e->packetTail += NS_AUDIO_ENC_PACKET_FOOTPRINT(h->len);
+    e->packetsReleased++;
+    e->stats.sent++;
+}
+
+uint32_t ns_audio_enc_drain(ns_audio_enc_t *e, const ns_audio_enc_sink_t *sink) {
+    ns_audio_packet_t packet;
+    uint32_t sent = 0;
+
+    while (ns_audio_enc_peek(e, &packet)) {
+        if (sink->send(sink->ctx, &packet) != NS_STATUS_SUCCESS) {
+            break;
+        }
+        ns_audio_enc_release(e);
+        sent++;
+    }
+    return sent;
+}
+
+uint32_t ns_audio_enc_queued(const ns_audio_enc_t *e) {
+    return e->packetsQueued - e->packetsReleased;
+}
+
+void ns_audio_enc_set_bitrate(ns_audio_enc_t *e, uint32_t bitsPerSecond) {
+    e->requestedBitrate = bitsPerSecond;
+}
+
+void ns_audio_enc_set_complexity(ns_audio_enc_t *e, uint8_t complexity) {
+    e->requestedComplexity = complexity;
+}
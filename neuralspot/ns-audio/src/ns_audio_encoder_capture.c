@@ -0,0 +1,48 @@
+/**
+ * @file ns_audio_encoder_capture.c
+ * @author Ambiq
+ * @brief Feeds the audio encode stage from ns_audio
+ * @version 0.1
+ * @date 2025-08-06
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_audio.h"
+#include "ns_audio_encoder.h"
+#include "ns_ipc_ring_buffer.h"
+#include <string.h>
+
+uint32_t ns_audio_enc_capture(ns_audio_enc_t *e, ns_audio_config_t *cfg) {
+    int16_t *frame = ns_audio_enc_frame_acquire(e);
+
+    if (frame == NULL) {
+        return NS_STATUS_FAILURE;
+    }
+    if (cfg->eAudioSource == NS_AUDIO_SOURCE_AUDADC) {
+        // Converted straight from the AUDADC samples into the pool
+        ns_audio_getPCM_v2(cfg, frame);
+    } else {
+        // The PDM ISR has already moved the samples into audioBuffer
+        memcpy(frame, cfg->audioBuffer, e->frameSamples * sizeof(int16_t));
+    }
+    ns_audio_enc_frame_submit(e);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_audio_enc_capture_ring(ns_audio_enc_t *e, ns_audio_config_t *cfg) {
+    uint32_t frameBytes = e->frameSamples * sizeof(int16_t);
+    uint32_t moved = 0;
+
+    // With the pool full, frames wait in the ring (which overwrites them if the encoder does
+    // not catch up) rather than being counted as overruns
+    while ((e->frameHead - e->frameTail < e->numFrames) &&
+           (ns_ipc_get_ring_buffer_status(cfg->bufferHandle) >= frameBytes)) {
+        int16_t *frame = ns_audio_enc_frame_acquire(e);
+        ns_ipc_ring_buffer_pop(cfg->bufferHandle, frame, frameBytes);
+        ns_audio_enc_frame_submit(e);
+        moved++;
+    }
+    return moved;
+}
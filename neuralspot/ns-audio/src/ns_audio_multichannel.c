@@ -0,0 +1,109 @@
+/**
+ * @file ns_audio_multichannel.c
+ * @author Ambiq
+ * @brief Planar multi-channel audio helpers
+ * @version 0.1
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_audio_multichannel.h"
+#include "ns_core.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+#endif
+
+const ns_core_api_t ns_audio_mix_V0_0_1 = {
+    .apiId = NS_AUDIO_MIX_API_ID, .version = NS_AUDIO_MIX_V0_0_1};
+
+const ns_core_api_t ns_audio_mix_oldest_supported_version = {
+    .apiId = NS_AUDIO_MIX_API_ID, .version = NS_AUDIO_MIX_V0_0_1};
+
+const ns_core_api_t ns_audio_mix_current_version = {
+    .apiId = NS_AUDIO_MIX_API_ID, .version = NS_AUDIO_MIX_V0_0_1};
+
+void ns_audio_deinterleave(
+    const int16_t *interleaved, int16_t *ch0, int16_t *ch1, uint32_t num_samples) {
+    uint32_t i = 0;
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    // VLD2 splits 8 sample pairs per iteration
+    int16x8x2_t v;
+    for (; i + 8 <= num_samples; i += 8) {
+        v = vld2q_s16(interleaved + 2 * i);
+        vst1q_s16(ch0 + i, v.val[0]);
+        vst1q_s16(ch1 + i, v.val[1]);
+    }
+#else
+    // Two sample pairs per iteration, no per-sample channel test
+    for (; i + 2 <= num_samples; i += 2) {
+        int16_t a0 = interleaved[2 * i];
+        int16_t b0 = interleaved[2 * i + 1];
+        int16_t a1 = interleaved[2 * i + 2];
+        int16_t b1 = interleaved[2 * i + 3];
+        ch0[i] = a0;
+        ch0[i + 1] = a1;
+        ch1[i] = b0;
+        ch1[i + 1] = b1;
+    }
+#endif
+    for (; i < num_samples; i++) {
+        ch0[i] = interleaved[2 * i];
+        ch1[i] = interleaved[2 * i + 1];
+    }
+}
+
+uint32_t ns_audio_mix_init(ns_audio_mix_cfg_t *c) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (c == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(
+            c->api, &ns_audio_mix_oldest_supported_version, &ns_audio_mix_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if (c->delay > NS_AUDIO_MIX_MAX_DELAY) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    memset(c->history, 0, sizeof(c->history));
+    return NS_STATUS_SUCCESS;
+}
+
+static inline int16_t ns_audio_mix_sample(int32_t w0, int32_t w1, int16_t a, int16_t b) {
+    int32_t acc = (w0 * a + w1 * b) >> 15;
+    return (int16_t)MAX(MIN(acc, 32767), -32768);
+}
+
+void ns_audio_mix(
+    ns_audio_mix_cfg_t *c, const int16_t *ch0, const int16_t *ch1, int16_t *out,
+    uint32_t num_samples) {
+    uint32_t d = c->delay;
+    uint32_t head = MIN(d, num_samples);
+    int16_t tail[NS_AUDIO_MIX_MAX_DELAY];
+    uint32_t i;
+
+    // The newest 'd' samples of (history, ch1) become the next history; save them
+    // before 'out' (which may alias ch0, but never ch1) is written
+    if (num_samples >= d) {
+        memcpy(tail, &ch1[num_samples - d], d * sizeof(int16_t));
+    } else {
+        memcpy(tail, &c->history[num_samples], (d - num_samples) * sizeof(int16_t));
+        memcpy(&tail[d - num_samples], ch1, num_samples * sizeof(int16_t));
+    }
+
+    // First 'd' outputs pair with delayed samples from the previous frame
+    for (i = 0; i < head; i++) {
+        out[i] = ns_audio_mix_sample(c->weight0, c->weight1, ch0[i], c->history[i]);
+    }
+    for (; i < num_samples; i++) {
+        out[i] = ns_audio_mix_sample(c->weight0, c->weight1, ch0[i], ch1[i - d]);
+    }
+
+    memcpy(c->history, tail, d * sizeof(int16_t));
+}
@@ -0,0 +1,169 @@
+/**
+ * @file ns_kws_stream.c
+ * @author Ambiq
+ * @brief Continuous keyword spotting feature pipeline
+ * @version 0.1
+ * @date 2025-07-01
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_audio_kws_stream.h"
+#include "ns_core.h"
+#include <string.h>
+
+const ns_core_api_t ns_kws_stream_V0_0_1 = {
+    .apiId = NS_KWS_STREAM_API_ID, .version = NS_KWS_STREAM_V0_0_1};
+
+const ns_core_api_t ns_kws_stream_oldest_supported_version = {
+    .apiId = NS_KWS_STREAM_API_ID, .version = NS_KWS_STREAM_V0_0_1};
+
+const ns_core_api_t ns_kws_stream_current_version = {
+    .apiId = NS_KWS_STREAM_API_ID, .version = NS_KWS_STREAM_V0_0_1};
+
+// 32b-aligned members first, then the posterior history, then the byte-sized feature ring
+static void ns_kws_stream_map_arena(ns_kws_stream_cfg_t *c) {
+    uintptr_t p = ((uintptr_t)c->arena + 3) & ~(uintptr_t)3;
+    c->score_sums = (int32_t *)p;
+    p += c->num_classes * sizeof(int32_t);
+    c->mfcc_scratch = (float *)p;
+    p += c->num_coeffs * sizeof(float);
+    c->scores = (int16_t *)p;
+    p += c->smoothing_window * c->num_classes * sizeof(int16_t);
+    c->ring = (int8_t *)p;
+}
+
+void ns_kws_stream_reset(ns_kws_stream_cfg_t *c) {
+    memset(c->ring, (int8_t)c->input_zero_point, 2 * c->num_frames * c->num_coeffs);
+    memset(c->scores, 0, c->smoothing_window * c->num_classes * sizeof(int16_t));
+    memset(c->score_sums, 0, c->num_classes * sizeof(int32_t));
+    c->head = 0;
+    c->frames_seen = 0;
+    c->hops_since_infer = 0;
+    c->score_head = 0;
+    c->scores_seen = 0;
+    c->suppress_count = 0;
+}
+
+uint32_t ns_kws_stream_init(ns_kws_stream_cfg_t *c) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (c == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(
+            c->api, &ns_kws_stream_oldest_supported_version, &ns_kws_stream_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((c->arena == NULL) || (c->num_frames == 0) || (c->num_coeffs == 0) ||
+        (c->stride == 0) || (c->num_classes == 0) || (c->num_classes > 32) ||
+        (c->smoothing_window == 0) || (c->input_scale <= 0.0f) || (c->output_scale <= 0.0f) ||
+        (c->arena_size < NS_KWS_STREAM_ARENA_SIZE(
+                             c->num_frames, c->num_coeffs, c->num_classes, c->smoothing_window))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    if ((c->mfcc != NULL) && (c->mfcc->num_coeffs != c->num_coeffs)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    ns_kws_stream_map_arena(c);
+
+    // Quantization happens once per hop with a multiply instead of a divide
+    c->input_inv_scale = 1.0f / c->input_scale;
+
+    // Compare window sums of (q - zero_point) against a pre-quantized threshold,
+    // so smoothing stays in the integer domain
+    c->threshold_sum = (int32_t)(c->threshold / c->output_scale * c->smoothing_window + 0.5f);
+
+    ns_kws_stream_reset(c);
+    return NS_STATUS_SUCCESS;
+}
+
+bool ns_kws_stream_push_features(ns_kws_stream_cfg_t *c, const float *features) {
+    uint32_t n = c->num_coeffs;
+    int8_t *lo = &c->ring[c->head * n];
+    int8_t *hi = &c->ring[(c->head + c->num_frames) * n];
+    float zp = (float)c->input_zero_point;
+    float inv = c->input_inv_scale;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float tmp = features[i] * inv + zp;
+        tmp = MAX(MIN(tmp, 127), -128);
+        lo[i] = (int8_t)tmp;
+        hi[i] = lo[i];
+    }
+
+    if (++c->head == c->num_frames) {
+        c->head = 0;
+    }
+    if (c->frames_seen < c->num_frames) {
+        c->frames_seen++;
+    }
+
+    if (++c->hops_since_infer >= c->stride && c->frames_seen == c->num_frames) {
+        c->hops_since_infer = 0;
+        return true;
+    }
+    return false;
+}
+
+bool ns_kws_stream_push_audio(ns_kws_stream_cfg_t *c, const int16_t *audio_data) {
+    ns_mfcc_compute(c->mfcc, audio_data, c->mfcc_scratch);
+    return ns_kws_stream_push_features(c, c->mfcc_scratch);
+}
+
+const int8_t *ns_kws_stream_get_window(ns_kws_stream_cfg_t *c) {
+    // 'head' is the oldest frame; the mirror makes the next num_frames contiguous
+    return &c->ring[c->head * c->num_coeffs];
+}
+
+int32_t ns_kws_stream_push_scores(ns_kws_stream_cfg_t *c, const int8_t *scores) {
+    int16_t *slot = &c->scores[c->score_head * c->num_classes];
+    int32_t best = NS_KWS_STREAM_NO_DETECTION;
+    int32_t best_sum = 0;
+
+    // Running sum: drop the oldest posterior, add the newest
+    for (uint32_t i = 0; i < c->num_classes; i++) {
+        int32_t q = (int32_t)scores[i] - c->output_zero_point;
+        c->score_sums[i] += q - slot[i];
+        slot[i] = (int16_t)q;
+    }
+
+    if (++c->score_head == c->smoothing_window) {
+        c->score_head = 0;
+    }
+    if (c->scores_seen < c->smoothing_window) {
+        c->scores_seen++;
+    }
+
+    if (c->suppress_count) {
+        c->suppress_count--;
+        return NS_KWS_STREAM_NO_DETECTION;
+    }
+
+    // Sums are only meaningful once the smoothing window has filled
+    if (c->scores_seen < c->smoothing_window) {
+        return NS_KWS_STREAM_NO_DETECTION;
+    }
+
+    for (uint32_t i = 0; i < c->num_classes; i++) {
+        if ((c->ignore_mask & (1u << i)) == 0 && c->score_sums[i] >= c->threshold_sum &&
+            c->score_sums[i] > best_sum) {
+            best = (int32_t)i;
+            best_sum = c->score_sums[i];
+        }
+    }
+
+    if (best != NS_KWS_STREAM_NO_DETECTION) {
+        c->suppress_count = c->suppression;
+    }
+    return best;
+}
+
+float ns_kws_stream_get_smoothed(ns_kws_stream_cfg_t *c, uint32_t class_index) {
+    uint32_t n = c->scores_seen ? c->scores_seen : 1;
+    return (float)c->score_sums[class_index] * c->output_scale / (float)n;
+}
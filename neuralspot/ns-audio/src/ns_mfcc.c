@@ -42,15 +42,18 @@
 #include "ns_audio_features_common.h"
 #include "ns_audio_mfcc.h"
 #include "ns_core.h"
+#include "ns_fast_log.h"
 
 const ns_core_api_t ns_mfcc_V0_0_1 = {.apiId = NS_MFCC_API_ID, .version = NS_MFCC_V0_0_1};
 
 const ns_core_api_t ns_mfcc_V1_0_0 = {.apiId = NS_MFCC_API_ID, .version = NS_MFCC_V1_0_0};
 
+const ns_core_api_t ns_mfcc_V1_1_0 = {.apiId = NS_MFCC_API_ID, .version = NS_MFCC_V1_1_0};
+
 const ns_core_api_t ns_mfcc_oldest_supported_version = {
     .apiId = NS_MFCC_API_ID, .version = NS_MFCC_V0_0_1};
 
-const ns_core_api_t ns_mfcc_current_version = {.apiId = NS_MFCC_API_ID, .version = NS_MFCC_V1_0_0};
+const ns_core_api_t ns_mfcc_current_version = {.apiId = NS_MFCC_API_ID, .version = NS_MFCC_V1_1_0};
 
 // float g_mfccFrame[MFCC_FRAME_LEN_POW2];
 // float g_mfccBuffer[MFCC_FRAME_LEN_POW2];
@@ -125,9 +128,9 @@ uint32_t ns_mfcc_init(ns_mfcc_cfg_t *c) {
     return NS_STATUS_SUCCESS;
 }
 
-uint32_t ns_mfcc_compute(ns_mfcc_cfg_t *cfg, const int16_t *audio_data, float *mfcc_out) {
-
-    int32_t i, j, bin;
+// Window and FFT one frame of audio, leaving the power spectrum in 'spectrum'
+static void ns_mfcc_power_spectrum(ns_mfcc_cfg_t *cfg, const int16_t *audio_data, float *spectrum) {
+    int32_t i;
 
     // TensorFlow way of normalizing int16_t data to (-1,1)
     for (i = 0; i < cfg->frame_len; i++) {
@@ -139,61 +142,122 @@ uint32_t ns_mfcc_compute(ns_mfcc_cfg_t *cfg, const int16_t *audio_data, float *m
         sizeof(float) * (cfg->frame_len_pow2 - cfg->frame_len));
 
     // Compute FFT
-    arm_rfft_fast_f32(&g_mfccRfft, cfg->mfccFrame, cfg->mfccBuffer, 0);
+    arm_rfft_fast_f32(&g_mfccRfft, cfg->mfccFrame, spectrum, 0);
 
     // Convert to power spectrum
     // frame is stored as [real0, realN/2-1, real1, im1, real2, im2, ...]
     int32_t half_dim = cfg->frame_len_pow2 / 2;
-    float first_energy = cfg->mfccBuffer[0] * cfg->mfccBuffer[0],
-          last_energy = cfg->mfccBuffer[1] * cfg->mfccBuffer[1]; // handle this special case
+    float first_energy = spectrum[0] * spectrum[0],
+          last_energy = spectrum[1] * spectrum[1]; // handle this special case
     for (i = 1; i < half_dim; i++) {
-        float real = cfg->mfccBuffer[i * 2];
-        float im = cfg->mfccBuffer[i * 2 + 1];
-        cfg->mfccBuffer[i] = real * real + im * im;
+        float real = spectrum[i * 2];
+        float im = spectrum[i * 2 + 1];
+        spectrum[i] = real * real + im * im;
     }
-    cfg->mfccBuffer[0] = first_energy;
-    cfg->mfccBuffer[half_dim] = last_energy;
+    spectrum[0] = first_energy;
+    spectrum[half_dim] = last_energy;
+}
 
-    float sqrt_data;
+// Mel filterbank, log and DCT for one or more power spectra. Filterbank weights and
+// DCT coefficients are loaded once and applied to every channel.
+static void ns_mfcc_cepstrum(
+    ns_mfcc_cfg_t *cfg, uint32_t num_channels, float *const *spectra, float *energies,
+    float *const *mfcc_out) {
+    int32_t i, j, bin;
+    uint32_t ch;
+    int32_t num_bins = cfg->num_fbank_bins;
+    float acc[NS_MFCC_MAX_CHANNELS];
+    float sqrt_data, coeff;
 
     // Apply mel filterbanks
-    for (bin = 0; bin < cfg->num_fbank_bins; bin++) {
+    for (bin = 0; bin < num_bins; bin++) {
         j = 0;
-        float mel_energy = 0;
         int32_t first_index = cfg->fbc.mfccFbankFirst[bin];
         int32_t last_index = cfg->fbc.mfccFbankLast[bin];
+        for (ch = 0; ch < num_channels; ch++) {
+            acc[ch] = 0;
+        }
         for (i = first_index; i <= last_index; i++) {
-            arm_sqrt_f32(cfg->mfccBuffer[i], &sqrt_data);
-            mel_energy += (sqrt_data) * (*(cfg->fbc.melFBank))[bin][j++];
+            coeff = (*(cfg->fbc.melFBank))[bin][j++];
+            for (ch = 0; ch < num_channels; ch++) {
+                arm_sqrt_f32(spectra[ch][i], &sqrt_data);
+                acc[ch] += (sqrt_data)*coeff;
+            }
+        }
+        for (ch = 0; ch < num_channels; ch++) {
+            // avoid log of zero
+            energies[ch * num_bins + bin] = (acc[ch] == 0.0) ? FLT_MIN : acc[ch];
         }
-        cfg->mfccEnergies[bin] = mel_energy;
-
-        // avoid log of zero
-        if (mel_energy == 0.0)
-            cfg->mfccEnergies[bin] = FLT_MIN;
     }
 
-    // Take log
-    for (bin = 0; bin < cfg->num_fbank_bins; bin++)
-        cfg->mfccEnergies[bin] = logf(cfg->mfccEnergies[bin]);
+    // Take log (all channels in one pass)
+    ns_logf_vec(energies, energies, num_channels * num_bins);
 
     // Take DCT. Uses matrix mul.
     for (i = 0; i < cfg->num_coeffs; i++) {
-        float sum = 0.0;
-        for (j = 0; j < cfg->num_fbank_bins; j++) {
-            sum += cfg->mfccDCTMatrix[i * cfg->num_fbank_bins + j] * cfg->mfccEnergies[j];
+        for (ch = 0; ch < num_channels; ch++) {
+            acc[ch] = 0.0;
+        }
+        for (j = 0; j < num_bins; j++) {
+            coeff = cfg->mfccDCTMatrix[i * num_bins + j];
+            for (ch = 0; ch < num_channels; ch++) {
+                acc[ch] += coeff * energies[ch * num_bins + j];
+            }
+        }
+
+        for (ch = 0; ch < num_channels; ch++) {
+            float sum = acc[ch] * (0x1 << cfg->num_dec_bits);
+            sum = round(sum);
+
+            // This is usually done after dequantization anyway, so preserve accuracy
+            // if(sum >= 127)
+            //     mfcc_out[i] = 127;
+            // else if(sum <= -128)
+            //     mfcc_out[i] = -128;
+            // else
+            mfcc_out[ch][i] = sum;
         }
+    }
+}
 
-        sum *= (0x1 << cfg->num_dec_bits);
-        sum = round(sum);
+uint32_t ns_mfcc_compute(ns_mfcc_cfg_t *cfg, const int16_t *audio_data, float *mfcc_out) {
+    ns_mfcc_power_spectrum(cfg, audio_data, cfg->mfccBuffer);
+    ns_mfcc_cepstrum(cfg, 1, &cfg->mfccBuffer, cfg->mfccEnergies, &mfcc_out);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_mfcc_multi_init(ns_mfcc_multi_cfg_t *c) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (c == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(c->api, &ns_mfcc_V1_1_0, &ns_mfcc_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((c->mfcc == NULL) || (c->arena == NULL) || (c->num_channels == 0) ||
+        (c->num_channels > NS_MFCC_MAX_CHANNELS) ||
+        (c->arena_size < NS_MFCC_MULTI_ARENA_SIZE(
+                             c->num_channels, c->mfcc->frame_len_pow2, c->mfcc->num_fbank_bins))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    uintptr_t p = ((uintptr_t)c->arena + 3) & ~(uintptr_t)3;
+    for (uint32_t ch = 0; ch < c->num_channels; ch++) {
+        c->spectra[ch] = (float *)p;
+        p += c->mfcc->frame_len_pow2 * sizeof(float);
+    }
+    c->energies = (float *)p;
+    return NS_STATUS_SUCCESS;
+}
 
-        // This is usually done after dequantization anyway, so preserve accuracy
-        // if(sum >= 127)
-        //     mfcc_out[i] = 127;
-        // else if(sum <= -128)
-        //     mfcc_out[i] = -128;
-        // else
-        mfcc_out[i] = sum;
+uint32_t ns_mfcc_multi_compute(
+    ns_mfcc_multi_cfg_t *c, const int16_t *const *audio_data, float *const *mfcc_out) {
+    // The FFT plan, window and frame scratch are shared; only the spectra are per-channel
+    for (uint32_t ch = 0; ch < c->num_channels; ch++) {
+        ns_mfcc_power_spectrum(c->mfcc, audio_data[ch], c->spectra[ch]);
     }
+    ns_mfcc_cepstrum(c->mfcc, c->num_channels, c->spectra, c->energies, mfcc_out);
     return NS_STATUS_SUCCESS;
 }
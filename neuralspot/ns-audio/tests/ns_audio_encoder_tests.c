@@ -0,0 +1,511 @@
+#include "unity/unity.h"
+
+#include "ns_audio_encoder_tests.h"
+#include "ns_timer.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Build with NS_AUDIO_ENC_TEST_OPUS (and the opus1.4 module) to run the round trip through Opus
+#ifdef NS_AUDIO_ENC_TEST_OPUS
+    #include "ns_opus_port.h"
+    #define MIN_CORRELATION 0.8f // Perceptual codec, the waveform is only roughly preserved
+#else
+    #define MIN_CORRELATION 0.9f
+#endif
+
+#define SAMPLE_RATE 16000
+#define FRAME_SAMPLES 320 // 20ms
+#define NUM_FRAMES 4
+#define MAX_PACKET 400
+#define WAV_SECONDS 2
+#define WAV_SAMPLES (SAMPLE_RATE * WAV_SECONDS)
+#define TEST_PI 3.14159265358979f
+
+static int16_t pcmPool[NUM_FRAMES * FRAME_SAMPLES];
+static uint8_t packetBuf[NS_AUDIO_ENC_QUEUE_MIN(MAX_PACKET) * 2] __attribute__((aligned(4)));
+static ns_audio_enc_t enc;
+
+static ns_timer_config_t rtf_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+// Reference codec: block floating point, a shift byte followed by one byte per sample, or just
+// the shift byte (0xFF) for silent frames, so packet lengths vary
+typedef struct {
+    uint32_t bitrate;
+    uint8_t complexity;
+    uint32_t bitrateCalls;
+    uint32_t complexityCalls;
+    uint32_t frames;
+    int32_t failOnFrame; ///< Return an error for this frame, -1 never
+} test_codec_t;
+
+static test_codec_t testCodec;
+
+static int32_t test_encode(void *ctx, const int16_t *pcm, uint32_t samples, uint8_t *out,
+                           uint32_t cap) {
+    test_codec_t *c = (test_codec_t *)ctx;
+    int32_t peak = 0;
+    uint8_t shift = 0;
+
+    if ((int32_t)c->frames++ == c->failOnFrame) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < samples; i++) {
+        peak = MAX(peak, abs(pcm[i]));
+    }
+    if (peak == 0) {
+        out[0] = 0xFF;
+        return 1;
+    }
+    if (samples + 1 > cap) {
+        return -2;
+    }
+    while ((peak >> shift) > 127) {
+        shift++;
+    }
+    out[0] = shift;
+    for (uint32_t i = 0; i < samples; i++) {
+        out[1 + i] = (uint8_t)(int8_t)(pcm[i] >> shift);
+    }
+    return samples + 1;
+}
+
+static void test_decode(const uint8_t *in, uint32_t len, int16_t *pcm, uint32_t samples) {
+    if ((len == 1) && (in[0] == 0xFF)) {
+        memset(pcm, 0, samples * sizeof(int16_t));
+        return;
+    }
+    for (uint32_t i = 0; i < samples; i++) {
+        pcm[i] = (int16_t)((int8_t)in[1 + i] * (1 << in[0]));
+    }
+}
+
+static uint32_t test_set_bitrate(void *ctx, uint32_t bitsPerSecond) {
+    ((test_codec_t *)ctx)->bitrate = bitsPerSecond;
+    ((test_codec_t *)ctx)->bitrateCalls++;
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t test_set_complexity(void *ctx, uint8_t complexity) {
+    ((test_codec_t *)ctx)->complexity = complexity;
+    ((test_codec_t *)ctx)->complexityCalls++;
+    return NS_STATUS_SUCCESS;
+}
+
+static ns_audio_codec_t codec = {
+    .encode = test_encode,
+    .set_bitrate = test_set_bitrate,
+    .set_complexity = test_set_complexity,
+    .ctx = &testCodec,
+};
+
+// Sink that records what it was handed, or refuses while busy
+typedef struct {
+    bool busy;
+    uint32_t packets;
+    uint16_t seq[64];
+    uint16_t len[64];
+    uint32_t timestamp[64];
+} test_sink_t;
+
+static test_sink_t sinkState;
+
+static uint32_t test_send(void *ctx, const ns_audio_packet_t *packet) {
+    test_sink_t *s = (test_sink_t *)ctx;
+    if (s->busy) {
+        return NS_STATUS_FAILURE;
+    }
+    if (s->packets < 64) {
+        s->seq[s->packets] = packet->seq;
+        s->len[s->packets] = packet->len;
+        s->timestamp[s->packets] = packet->timestamp;
+    }
+    s->packets++;
+    return NS_STATUS_SUCCESS;
+}
+
+static const ns_audio_enc_sink_t sink = {.send = test_send, .ctx = &sinkState};
+
+static void enc_config(void) {
+    memset(&enc, 0, sizeof(enc));
+    memset(&testCodec, 0, sizeof(testCodec));
+    memset(&sinkState, 0, sizeof(sinkState));
+    testCodec.failOnFrame = -1;
+    enc.api = &ns_audio_enc_V0_0_1;
+    enc.codec = &codec;
+    enc.frameSamples = FRAME_SAMPLES;
+    enc.numChannels = 1;
+    enc.numFrames = NUM_FRAMES;
+    enc.pcmPool = pcmPool;
+    enc.packetBuf = packetBuf;
+    enc.packetBufSize = sizeof(packetBuf);
+    enc.maxPacket = MAX_PACKET;
+    enc.bitrate = 0;
+    enc.complexity = -1;
+}
+
+// Capture one frame: a tone whose amplitude depends on the frame number, or silence
+static bool capture(uint32_t n, bool silent) {
+    int16_t *frame = ns_audio_enc_frame_acquire(&enc);
+    if (frame == NULL) {
+        return false;
+    }
+    for (uint32_t i = 0; i < FRAME_SAMPLES; i++) {
+        frame[i] = silent ? 0 : (int16_t)((1000 + 100 * n) * sinf(2 * TEST_PI * i / 40.0f));
+    }
+    ns_audio_enc_frame_submit(&enc);
+    return true;
+}
+
+void ns_audio_encoder_tests_pre_test_hook() { ns_timer_init(&rtf_timer); }
+
+void ns_audio_encoder_tests_post_test_hook() {}
+
+void ns_audio_enc_init_test() {
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_audio_enc_init(NULL));
+
+    enc_config();
+    enc.api = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_audio_enc_init(&enc));
+
+    enc_config();
+    enc.numFrames = 3; // not a power of two
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_audio_enc_init(&enc));
+
+    enc_config();
+    enc.packetBufSize = NS_AUDIO_ENC_QUEUE_MIN(MAX_PACKET) - 4;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_audio_enc_init(&enc));
+
+    enc_config();
+    enc.packetBuf = packetBuf + 2; // unaligned
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_audio_enc_init(&enc));
+
+    enc_config();
+    enc.codec = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_audio_enc_init(&enc));
+
+    // Knobs are handed to the codec at init
+    enc_config();
+    enc.bitrate = 24000;
+    enc.complexity = 5;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+    TEST_ASSERT_EQUAL(24000, testCodec.bitrate);
+    TEST_ASSERT_EQUAL(5, testCodec.complexity);
+}
+
+void ns_audio_enc_packets_test() {
+    ns_audio_packet_t packet;
+
+    enc_config();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+    TEST_ASSERT_FALSE(ns_audio_enc_peek(&enc, &packet));
+
+    TEST_ASSERT_TRUE(capture(0, false));
+    TEST_ASSERT_TRUE(capture(1, true));
+    TEST_ASSERT_TRUE(capture(2, false));
+    TEST_ASSERT_EQUAL(3, ns_audio_enc_process(&enc));
+    TEST_ASSERT_EQUAL(3, ns_audio_enc_queued(&enc));
+
+    // Variable length, sequence numbers and sample timestamps
+    const uint16_t lens[3] = {FRAME_SAMPLES + 1, 1, FRAME_SAMPLES + 1};
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(ns_audio_enc_peek(&enc, &packet));
+        TEST_ASSERT_EQUAL(lens[i], packet.len);
+        TEST_ASSERT_EQUAL(i, packet.seq);
+        TEST_ASSERT_EQUAL(i * FRAME_SAMPLES, packet.timestamp);
+        ns_audio_enc_release(&enc);
+    }
+    TEST_ASSERT_FALSE(ns_audio_enc_peek(&enc, &packet));
+    TEST_ASSERT_EQUAL(0, ns_audio_enc_queued(&enc));
+    TEST_ASSERT_EQUAL(3, enc.stats.frames);
+    TEST_ASSERT_EQUAL(2 * (FRAME_SAMPLES + 1) + 1, enc.stats.bytes);
+    TEST_ASSERT_EQUAL(FRAME_SAMPLES + 1, enc.stats.maxPacket);
+
+    // Stereo timestamps count samples per channel
+    enc_config();
+    enc.numChannels = 2;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+    capture(0, false);
+    capture(1, false);
+    ns_audio_enc_process(&enc);
+    ns_audio_enc_drain(&enc, &sink);
+    TEST_ASSERT_EQUAL(FRAME_SAMPLES / 2, sinkState.timestamp[1]);
+}
+
+void ns_audio_enc_wrap_test() {
+    int16_t expected[FRAME_SAMPLES];
+    int16_t decoded[FRAME_SAMPLES];
+    ns_audio_packet_t packet;
+    uint32_t next = 0;
+    uint32_t n = 0;
+
+    enc_config();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+
+    // Keep one packet in flight while the next ones are encoded, so the queue wraps with
+    // packets on both sides of the end
+    while (n < 40) {
+        while ((n < 40) && (enc.frameHead - enc.frameTail < NUM_FRAMES)) {
+            capture(n, (n % 3) == 1);
+            n++;
+        }
+        ns_audio_enc_process(&enc);
+        while ((ns_audio_enc_queued(&enc) > 1) && ns_audio_enc_peek(&enc, &packet)) {
+            TEST_ASSERT_EQUAL(next, packet.seq);
+            TEST_ASSERT_EQUAL(next * FRAME_SAMPLES, packet.timestamp);
+            test_decode(packet.data, packet.len, decoded, FRAME_SAMPLES);
+            for (uint32_t i = 0; i < FRAME_SAMPLES; i++) {
+                expected[i] = ((next % 3) == 1)
+                                  ? 0
+                                  : (int16_t)((1000 + 100 * next) * sinf(2 * TEST_PI * i / 40.0f));
+                TEST_ASSERT_INT16_WITHIN(
+                    (packet.len == 1) ? 0 : 1 << packet.data[0], expected[i], decoded[i]);
+            }
+            ns_audio_enc_release(&enc);
+            next++;
+        }
+    }
+    ns_audio_enc_process(&enc);
+    next += ns_audio_enc_drain(&enc, &sink);
+    TEST_ASSERT_EQUAL(40, next);
+    TEST_ASSERT_EQUAL(40, enc.stats.frames);
+    TEST_ASSERT_EQUAL(0, enc.stats.overruns);
+}
+
+void ns_audio_enc_backpressure_test() {
+    uint32_t captured = 0;
+
+    enc_config();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+
+    // The link is down: the queue fills, then the pool, then frames are lost
+    sinkState.busy = true;
+    for (uint32_t n = 0; n < 20; n++) {
+        captured += capture(n, false);
+        ns_audio_enc_process(&enc);
+        TEST_ASSERT_EQUAL(0, ns_audio_enc_drain(&enc, &sink));
+    }
+    uint32_t queued = ns_audio_enc_queued(&enc);
+    TEST_ASSERT_TRUE(queued >= 2);
+    TEST_ASSERT_TRUE(enc.stats.stalls > 0);
+    TEST_ASSERT_EQUAL(queued + NUM_FRAMES, captured);
+    TEST_ASSERT_EQUAL(20 - captured, enc.stats.overruns);
+
+    // The link recovers: everything captured goes out in order, and the lost frames show up
+    // as a jump in the timestamps
+    sinkState.busy = false;
+    for (uint32_t n = 0; n < NUM_FRAMES + 1; n++) {
+        ns_audio_enc_process(&enc);
+        ns_audio_enc_drain(&enc, &sink);
+    }
+    TEST_ASSERT_EQUAL(captured, sinkState.packets);
+    TEST_ASSERT_TRUE(capture(20, false));
+    ns_audio_enc_process(&enc);
+    ns_audio_enc_drain(&enc, &sink);
+    for (uint32_t i = 0; i < captured; i++) {
+        TEST_ASSERT_EQUAL(i, sinkState.seq[i]);
+        TEST_ASSERT_EQUAL(i * FRAME_SAMPLES, sinkState.timestamp[i]);
+    }
+    TEST_ASSERT_EQUAL(20 * FRAME_SAMPLES, sinkState.timestamp[captured]);
+}
+
+void ns_audio_enc_knobs_test() {
+    enc_config();
+    enc.bitrate = 16000;
+    enc.complexity = 3;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+    TEST_ASSERT_EQUAL(1, testCodec.bitrateCalls);
+    TEST_ASSERT_EQUAL(1, testCodec.complexityCalls);
+
+    // Requests are applied before the next frame, once, and only when they change something
+    ns_audio_enc_set_bitrate(&enc, 32000);
+    ns_audio_enc_set_bitrate(&enc, 24000);
+    ns_audio_enc_set_complexity(&enc, 3);
+    TEST_ASSERT_EQUAL(16000, testCodec.bitrate);
+    capture(0, false);
+    ns_audio_enc_process(&enc);
+    TEST_ASSERT_EQUAL(24000, testCodec.bitrate);
+    TEST_ASSERT_EQUAL(2, testCodec.bitrateCalls);
+    TEST_ASSERT_EQUAL(1, testCodec.complexityCalls);
+
+    ns_audio_enc_set_complexity(&enc, 8);
+    ns_audio_enc_process(&enc);
+    ns_audio_enc_process(&enc);
+    TEST_ASSERT_EQUAL(8, testCodec.complexity);
+    TEST_ASSERT_EQUAL(2, testCodec.complexityCalls);
+}
+
+void ns_audio_enc_error_test() {
+    enc_config();
+    testCodec.failOnFrame = 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+
+    capture(0, false);
+    capture(1, false);
+    capture(2, false);
+    TEST_ASSERT_EQUAL(2, ns_audio_enc_process(&enc));
+    TEST_ASSERT_EQUAL(1, enc.stats.encodeErrors);
+    TEST_ASSERT_EQUAL(2, ns_audio_enc_drain(&enc, &sink));
+
+    // The failed frame leaves a gap in the timestamps but not in the sequence numbers
+    TEST_ASSERT_EQUAL(1, sinkState.seq[1]);
+    TEST_ASSERT_EQUAL(2 * FRAME_SAMPLES, sinkState.timestamp[1]);
+}
+
+// -- WAV round trip --------------------------------------------------------------------------
+
+static uint8_t wav[44 + WAV_SAMPLES * 2];
+static int16_t decodedPcm[WAV_SAMPLES + FRAME_SAMPLES];
+
+static void put_le(uint8_t *p, uint32_t v, uint32_t bytes) {
+    for (uint32_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t get_le(const uint8_t *p, uint32_t bytes) {
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < bytes; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+// 16 bit mono WAV with a voiced-speech-like signal: a 140Hz pulse train's harmonics under a
+// slow syllable envelope
+static void wav_build(void) {
+    memcpy(wav, "RIFF", 4);
+    put_le(wav + 4, 36 + WAV_SAMPLES * 2, 4);
+    memcpy(wav + 8, "WAVEfmt ", 8);
+    put_le(wav + 16, 16, 4);
+    put_le(wav + 20, 1, 2); // PCM
+    put_le(wav + 22, 1, 2);
+    put_le(wav + 24, SAMPLE_RATE, 4);
+    put_le(wav + 28, SAMPLE_RATE * 2, 4);
+    put_le(wav + 32, 2, 2);
+    put_le(wav + 34, 16, 2);
+    memcpy(wav + 36, "data", 4);
+    put_le(wav + 40, WAV_SAMPLES * 2, 4);
+    for (uint32_t n = 0; n < WAV_SAMPLES; n++) {
+        float t = (float)n / SAMPLE_RATE;
+        float env = 0.5f + 0.5f * sinf(2 * TEST_PI * 3.0f * t);
+        float x = 0.0f;
+        for (uint32_t h = 1; h <= 8; h++) {
+            x += sinf(2 * TEST_PI * 140.0f * h * t) / h;
+        }
+        put_le(wav + 44 + 2 * n, (uint16_t)(int16_t)(6000.0f * env * x), 2);
+    }
+}
+
+// Returns the PCM samples of a 16 bit mono WAV at SAMPLE_RATE, or NULL
+static const uint8_t *wav_parse(const uint8_t *w, uint32_t size, uint32_t *samples) {
+    if ((size < 44) || memcmp(w, "RIFF", 4) || memcmp(w + 8, "WAVEfmt ", 8) ||
+        (get_le(w + 20, 2) != 1) || (get_le(w + 22, 2) != 1) ||
+        (get_le(w + 24, 4) != SAMPLE_RATE) || (get_le(w + 34, 2) != 16) ||
+        memcmp(w + 36, "data", 4)) {
+        return NULL;
+    }
+    *samples = MIN(get_le(w + 40, 4), size - 44) / 2;
+    return w + 44;
+}
+
+#ifdef NS_AUDIO_ENC_TEST_OPUS
+static OpusDecoder *opusDecoder;
+#endif
+
+// Decoder side of the link: decodes each packet at its timestamp
+static uint32_t decode_send(void *ctx, const ns_audio_packet_t *packet) {
+    int16_t *dst = decodedPcm + packet->timestamp;
+#ifdef NS_AUDIO_ENC_TEST_OPUS
+    int n = opus_decode(opusDecoder, packet->data, packet->len, dst, FRAME_SAMPLES, 0);
+    return (n == FRAME_SAMPLES) ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+#else
+    test_decode(packet->data, packet->len, dst, FRAME_SAMPLES);
+    return NS_STATUS_SUCCESS;
+#endif
+}
+
+// Normalized cross-correlation of the decoded signal, at the lag (codec delay) that maximizes it
+static float best_correlation(const int16_t *ref, const int16_t *out, uint32_t len, uint32_t *lag) {
+    float best = -1.0f;
+    for (uint32_t d = 0; d < FRAME_SAMPLES; d++) {
+        double xy = 0, xx = 0, yy = 0;
+        for (uint32_t i = 0; i + d < len; i++) {
+            xy += (double)ref[i] * out[i + d];
+            xx += (double)ref[i] * ref[i];
+            yy += (double)out[i + d] * out[i + d];
+        }
+        float c = (xx > 0 && yy > 0) ? (float)(xy / sqrt(xx * yy)) : 0.0f;
+        if (c > best) {
+            best = c;
+            *lag = d;
+        }
+    }
+    return best;
+}
+
+void ns_audio_enc_wav_roundtrip_test() {
+    const ns_audio_enc_sink_t decoder = {.send = decode_send, .ctx = NULL};
+    uint32_t samples = 0;
+    uint32_t lag = 0;
+
+    enc_config();
+
+    wav_build();
+    const int16_t *pcm = (const int16_t *)wav_parse(wav, sizeof(wav), &samples);
+    TEST_ASSERT_NOT_NULL(pcm);
+    TEST_ASSERT_EQUAL(WAV_SAMPLES, samples);
+
+#ifdef NS_AUDIO_ENC_TEST_OPUS
+    int err;
+    ns_audio_codec_t opus;
+    OpusEncoder *opusEncoder = ns_opus_encoder_create(SAMPLE_RATE, 24000, 3, 1);
+    TEST_ASSERT_NOT_NULL(opusEncoder);
+    ns_opus_codec_init(&opus, opusEncoder);
+    opusDecoder = opus_decoder_create(SAMPLE_RATE, 1, &err);
+    TEST_ASSERT_EQUAL(OPUS_OK, err);
+    enc.codec = &opus;
+    enc.bitrate = 24000;
+    enc.complexity = 3;
+#endif
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_enc_init(&enc));
+    memset(decodedPcm, 0, sizeof(decodedPcm));
+
+    // Capture a frame, encode, send, as the capture interrupt and the encode and transport
+    // tasks would
+    uint32_t start = ns_us_ticker_read(&rtf_timer);
+    for (uint32_t n = 0; n + FRAME_SAMPLES <= samples; n += FRAME_SAMPLES) {
+        int16_t *frame = ns_audio_enc_frame_acquire(&enc);
+        TEST_ASSERT_NOT_NULL(frame);
+        memcpy(frame, pcm + n, FRAME_SAMPLES * sizeof(int16_t));
+        ns_audio_enc_frame_submit(&enc);
+        ns_audio_enc_process(&enc);
+        ns_audio_enc_drain(&enc, &decoder);
+    }
+    uint32_t elapsedUs = ns_us_ticker_read(&rtf_timer) - start;
+
+    TEST_ASSERT_EQUAL(samples / FRAME_SAMPLES, enc.stats.sent);
+    TEST_ASSERT_EQUAL(0, enc.stats.overruns);
+    TEST_ASSERT_EQUAL(0, enc.stats.encodeErrors);
+
+    float corr = best_correlation(pcm, decodedPcm, samples, &lag);
+    float rtf = elapsedUs / (1e6f * samples / SAMPLE_RATE);
+    float kbps = enc.stats.bytes * 8.0f / (1000.0f * samples / SAMPLE_RATE);
+    ns_lp_printf(
+        "WAV round trip: %d frames, %d kbps, max packet %d, correlation %d/1000 at lag %d, "
+        "real-time factor %d/1000\n",
+        enc.stats.frames, (int)kbps, enc.stats.maxPacket, (int)(corr * 1000), lag,
+        (int)(rtf * 1000));
+    TEST_ASSERT_TRUE(corr > MIN_CORRELATION);
+    TEST_ASSERT_TRUE(rtf < 1.0f);
+
+#ifdef NS_AUDIO_ENC_TEST_OPUS
+    opus_encoder_destroy(opusEncoder);
+    opus_decoder_destroy(opusDecoder);
+#endif
+}
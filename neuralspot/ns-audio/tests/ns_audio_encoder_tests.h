@@ -0,0 +1,12 @@
+#include "ns_audio_encoder.h"
+#include "ns_core.h"
+
+void ns_audio_encoder_tests_pre_test_hook();
+void ns_audio_encoder_tests_post_test_hook();
+void ns_audio_enc_init_test();
+void ns_audio_enc_packets_test();
+void ns_audio_enc_wrap_test();
+void ns_audio_enc_backpressure_test();
+void ns_audio_enc_knobs_test();
+void ns_audio_enc_error_test();
+void ns_audio_enc_wav_roundtrip_test();
@@ -0,0 +1,268 @@
+#include "unity/unity.h"
+
+#include "ns_audio_multichannel_tests.h"
+#include "ns_timer.h"
+#include <math.h>
+#include <stdint.h>
+
+#define FRAME_LEN 320
+#define FRAME_LEN_POW2 512
+#define NUM_FBANK_BINS 40
+#define NUM_COEFFS 10
+#define NUM_CHANNELS 2
+#define BENCH_REPS 20
+
+#define MFCC_ARENA_SIZE                                                                            \
+    32 * (FRAME_LEN_POW2 * 2 + NUM_FBANK_BINS * (NS_MFCC_SIZEBINS + NUM_COEFFS))
+
+static uint8_t mfccArena[MFCC_ARENA_SIZE] __attribute__((aligned(4)));
+static uint8_t multiArena[NS_MFCC_MULTI_ARENA_SIZE(NUM_CHANNELS, FRAME_LEN_POW2, NUM_FBANK_BINS)]
+    __attribute__((aligned(4)));
+static ns_mfcc_cfg_t mfcc;
+static ns_mfcc_multi_cfg_t multi;
+static ns_audio_mix_cfg_t mix;
+
+static int16_t interleaved[2 * FRAME_LEN];
+static int16_t left[FRAME_LEN];
+static int16_t right[FRAME_LEN];
+static int16_t mixed[FRAME_LEN];
+
+static ns_timer_config_t bench_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+static void initialize_mfcc_config() {
+    mfcc.api = &ns_mfcc_V1_1_0;
+    mfcc.arena = mfccArena;
+    mfcc.sample_frequency = 16000;
+    mfcc.num_fbank_bins = NUM_FBANK_BINS;
+    mfcc.low_freq = 20;
+    mfcc.high_freq = 4000;
+    mfcc.num_frames = 49;
+    mfcc.num_coeffs = NUM_COEFFS;
+    mfcc.num_dec_bits = 0;
+    mfcc.frame_shift_ms = 20;
+    mfcc.frame_len_ms = 30;
+    mfcc.frame_len = FRAME_LEN;
+    mfcc.frame_len_pow2 = FRAME_LEN_POW2;
+
+    multi.api = &ns_mfcc_V1_1_0;
+    multi.mfcc = &mfcc;
+    multi.num_channels = NUM_CHANNELS;
+    multi.arena = multiArena;
+    multi.arena_size = sizeof(multiArena);
+}
+
+static void initialize_mix_config() {
+    mix.api = &ns_audio_mix_V0_0_1;
+    mix.weight0 = 16384;
+    mix.weight1 = 16384;
+    mix.delay = 0;
+}
+
+// Two different tones so channel mix-ups are visible
+static void fill_stereo() {
+    for (int i = 0; i < FRAME_LEN; i++) {
+        interleaved[2 * i] = (int16_t)(8000 * sinf(2 * M_PI * 440 * i / 16000.0f));
+        interleaved[2 * i + 1] = (int16_t)(6000 * sinf(2 * M_PI * 1250 * i / 16000.0f) + i);
+    }
+}
+
+void ns_audio_multichannel_tests_pre_test_hook() {
+    initialize_mfcc_config();
+    initialize_mix_config();
+    fill_stereo();
+}
+
+void ns_audio_multichannel_tests_post_test_hook() {
+    // post hook if needed
+}
+
+void ns_audio_deinterleave_test() {
+    // Odd lengths exercise the scalar tail after the vector/unrolled loop
+    for (uint32_t len = 0; len <= 19; len++) {
+        memset(left, 0x55, sizeof(left));
+        memset(right, 0x55, sizeof(right));
+        ns_audio_deinterleave(interleaved, left, right, len);
+        for (uint32_t i = 0; i < len; i++) {
+            TEST_ASSERT_EQUAL_INT16(interleaved[2 * i], left[i]);
+            TEST_ASSERT_EQUAL_INT16(interleaved[2 * i + 1], right[i]);
+        }
+        TEST_ASSERT_EQUAL_INT16(0x5555, left[len]);
+        TEST_ASSERT_EQUAL_INT16(0x5555, right[len]);
+    }
+    ns_audio_deinterleave(interleaved, left, right, FRAME_LEN);
+    TEST_ASSERT_EQUAL_INT16(interleaved[2 * (FRAME_LEN - 1) + 1], right[FRAME_LEN - 1]);
+}
+
+void ns_audio_mix_invalid_config_test() {
+    initialize_mix_config();
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_audio_mix_init(NULL));
+    mix.api = &ns_mfcc_V1_1_0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_audio_mix_init(&mix));
+    mix.api = &ns_audio_mix_V0_0_1;
+    mix.delay = NS_AUDIO_MIX_MAX_DELAY + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_audio_mix_init(&mix));
+    mix.delay = NS_AUDIO_MIX_MAX_DELAY;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_mix_init(&mix));
+}
+
+void ns_audio_mix_average_test() {
+    initialize_mix_config();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_mix_init(&mix));
+    ns_audio_deinterleave(interleaved, left, right, FRAME_LEN);
+    ns_audio_mix(&mix, left, right, mixed, FRAME_LEN);
+    for (int i = 0; i < FRAME_LEN; i++) {
+        TEST_ASSERT_EQUAL_INT16((left[i] + right[i]) >> 1, mixed[i]);
+    }
+}
+
+// Frames of uneven size (some shorter than the delay) must match one long delayed stream
+void ns_audio_mix_delay_test() {
+    static const uint32_t frame_sizes[] = {7, 3, 40, 1, 100, 12, 157};
+    int16_t delayed;
+    uint32_t pos = 0;
+
+    initialize_mix_config();
+    mix.delay = 9;
+    mix.weight0 = 0;
+    mix.weight1 = 32767;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_mix_init(&mix));
+    ns_audio_deinterleave(interleaved, left, right, FRAME_LEN);
+
+    for (uint32_t f = 0; f < sizeof(frame_sizes) / sizeof(frame_sizes[0]); f++) {
+        ns_audio_mix(&mix, &left[pos], &right[pos], &mixed[pos], frame_sizes[f]);
+        pos += frame_sizes[f];
+    }
+    TEST_ASSERT_EQUAL(FRAME_LEN, pos);
+
+    for (uint32_t i = 0; i < FRAME_LEN; i++) {
+        delayed = (i < mix.delay) ? 0 : right[i - mix.delay];
+        TEST_ASSERT_EQUAL_INT16((delayed * 32767) >> 15, mixed[i]);
+    }
+}
+
+void ns_audio_mix_saturation_test() {
+    initialize_mix_config();
+    int16_t a[4] = {32767, -32768, 30000, -30000};
+    int16_t b[4] = {32767, -32768, 30000, -30000};
+    mix.weight0 = 32767;
+    mix.weight1 = 32767;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_mix_init(&mix));
+    ns_audio_mix(&mix, a, b, mixed, 4);
+    TEST_ASSERT_EQUAL_INT16(32767, mixed[0]);
+    TEST_ASSERT_EQUAL_INT16(-32768, mixed[1]);
+    TEST_ASSERT_EQUAL_INT16(32767, mixed[2]);
+    TEST_ASSERT_EQUAL_INT16(-32768, mixed[3]);
+}
+
+void ns_audio_mix_in_place_test() {
+    initialize_mix_config();
+    mix.delay = 5;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_mix_init(&mix));
+    ns_audio_deinterleave(interleaved, left, right, FRAME_LEN);
+    ns_audio_mix(&mix, left, right, mixed, FRAME_LEN);
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_audio_mix_init(&mix));
+    ns_audio_mix(&mix, left, right, left, FRAME_LEN);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(mixed, left, FRAME_LEN);
+}
+
+void ns_mfcc_multi_invalid_config_test() {
+    initialize_mfcc_config();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_init(&mfcc));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_mfcc_multi_init(NULL));
+
+    // Multi-channel needs the V1.1.0 API
+    multi.api = &ns_mfcc_V1_0_0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_mfcc_multi_init(&multi));
+    multi.api = &ns_mfcc_V1_1_0;
+
+    multi.num_channels = NS_MFCC_MAX_CHANNELS + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_mfcc_multi_init(&multi));
+    multi.num_channels = NUM_CHANNELS;
+
+    multi.arena_size = sizeof(multiArena) - 8;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_mfcc_multi_init(&multi));
+    multi.arena_size = sizeof(multiArena);
+
+    multi.mfcc = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_mfcc_multi_init(&multi));
+    multi.mfcc = &mfcc;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_multi_init(&multi));
+}
+
+void ns_mfcc_multi_matches_mono_test() {
+    float mono_out[NUM_CHANNELS][NUM_COEFFS];
+    float multi_out[NUM_CHANNELS][NUM_COEFFS];
+    float *outs[NUM_CHANNELS] = {multi_out[0], multi_out[1]};
+    const int16_t *ins[NUM_CHANNELS] = {left, right};
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_init(&mfcc));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_multi_init(&multi));
+    ns_audio_deinterleave(interleaved, left, right, FRAME_LEN);
+
+    ns_mfcc_compute(&mfcc, left, mono_out[0]);
+    ns_mfcc_compute(&mfcc, right, mono_out[1]);
+    ns_mfcc_multi_compute(&multi, ins, outs);
+
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(mono_out[0], multi_out[0], NUM_COEFFS);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(mono_out[1], multi_out[1], NUM_COEFFS);
+
+    // Different signals must give different features
+    TEST_ASSERT_FALSE(mono_out[0][1] == mono_out[1][1]);
+}
+
+// Not a pass/fail check: reports the cost of the planar path against the per-channel path
+void ns_audio_multichannel_benchmark_test() {
+    float out[NUM_CHANNELS][NUM_COEFFS];
+    float *outs[NUM_CHANNELS] = {out[0], out[1]};
+    const int16_t *ins[NUM_CHANNELS] = {left, right};
+    uint32_t t0, t_mono, t_multi, t_split, t_deint;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_init(&bench_timer));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_init(&mfcc));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_multi_init(&multi));
+
+    // Per-sample channel test, as ns_audio_getPCM_v2 does for stereo
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < BENCH_REPS * 10; r++) {
+        uint32_t l = 0, rc = 0;
+        for (int i = 0; i < 2 * FRAME_LEN; i++) {
+            if ((i & 1) == 0) {
+                left[l++] = interleaved[i];
+            } else {
+                right[rc++] = interleaved[i];
+            }
+        }
+    }
+    t_split = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < BENCH_REPS * 10; r++) {
+        ns_audio_deinterleave(interleaved, left, right, FRAME_LEN);
+    }
+    t_deint = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < BENCH_REPS; r++) {
+        ns_mfcc_compute(&mfcc, left, out[0]);
+        ns_mfcc_compute(&mfcc, right, out[1]);
+    }
+    t_mono = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < BENCH_REPS; r++) {
+        ns_mfcc_multi_compute(&multi, ins, outs);
+    }
+    t_multi = ns_us_ticker_read(&bench_timer) - t0;
+
+    ns_lp_printf(
+        "deinterleave x%d: per-sample %d us, ns_audio_deinterleave %d us\n", BENCH_REPS * 10,
+        t_split, t_deint);
+    ns_lp_printf(
+        "stereo MFCC x%d: 2x ns_mfcc_compute %d us, ns_mfcc_multi_compute %d us\n", BENCH_REPS,
+        t_mono, t_multi);
+}
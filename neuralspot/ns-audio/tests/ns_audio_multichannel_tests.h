@@ -0,0 +1,13 @@
+#include "ns_audio_mfcc.h"
+#include "ns_audio_multichannel.h"
+void ns_audio_multichannel_tests_pre_test_hook();
+void ns_audio_multichannel_tests_post_test_hook();
+void ns_audio_deinterleave_test();
+void ns_audio_mix_invalid_config_test();
+void ns_audio_mix_average_test();
+void ns_audio_mix_delay_test();
+void ns_audio_mix_saturation_test();
+void ns_audio_mix_in_place_test();
+void ns_mfcc_multi_invalid_config_test();
+void ns_mfcc_multi_matches_mono_test();
+void ns_audio_multichannel_benchmark_test();
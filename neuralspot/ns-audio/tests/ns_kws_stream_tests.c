@@ -0,0 +1,304 @@
+#include "unity/unity.h"
+
+#include "ns_audio_kws_stream.h"
+#include "ns_audio_mfcc.h"
+#include <math.h>
+#include <stdint.h>
+
+#define NUM_FRAMES 49
+#define NUM_COEFFS 10
+#define NUM_CLASSES 12
+#define SMOOTHING 3
+#define STRIDE 4
+
+static uint8_t kwsArena[NS_KWS_STREAM_ARENA_SIZE(NUM_FRAMES, NUM_COEFFS, NUM_CLASSES, SMOOTHING)]
+    __attribute__((aligned(4)));
+static ns_kws_stream_cfg_t kws;
+
+static void initialize_kws_config() {
+    kws.api = &ns_kws_stream_V0_0_1;
+    kws.mfcc = NULL;
+    kws.arena = kwsArena;
+    kws.arena_size = sizeof(kwsArena);
+    kws.num_frames = NUM_FRAMES;
+    kws.num_coeffs = NUM_COEFFS;
+    kws.stride = STRIDE;
+    kws.input_scale = 1.0f;
+    kws.input_zero_point = 0;
+    kws.num_classes = NUM_CLASSES;
+    kws.output_scale = 1.0f / 256.0f;
+    kws.output_zero_point = -128;
+    kws.smoothing_window = SMOOTHING;
+    kws.threshold = 0.5f;
+    kws.suppression = 2;
+    kws.ignore_mask = (1 << 10) | (1 << 11); // silence, unknown
+}
+
+// Each frame's features encode its frame number, so window order can be checked
+static bool push_frame(uint32_t frame) {
+    float f[NUM_COEFFS];
+    for (int i = 0; i < NUM_COEFFS; i++) {
+        f[i] = (float)((frame % 100) + i);
+    }
+    return ns_kws_stream_push_features(&kws, f);
+}
+
+// Quantized softmax-like output with most of the mass on one class
+static void make_scores(int8_t *scores, int hot, uint8_t prob) {
+    for (int i = 0; i < NUM_CLASSES; i++) {
+        scores[i] = -128;
+    }
+    scores[hot] = (int8_t)(prob - 128);
+}
+
+void ns_kws_stream_tests_pre_test_hook() {
+    initialize_kws_config();
+}
+
+void ns_kws_stream_tests_post_test_hook() {}
+
+void ns_kws_stream_init_test() {
+    initialize_kws_config();
+    int status = ns_kws_stream_init(&kws);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, status);
+}
+
+void ns_kws_stream_invalid_config_test() {
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_kws_stream_init(NULL));
+
+    initialize_kws_config();
+    const ns_core_api_t invalid_api = {.apiId = 0xFFFFF, .version = NS_KWS_STREAM_V0_0_1};
+    kws.api = &invalid_api;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_kws_stream_init(&kws));
+
+    initialize_kws_config();
+    kws.arena_size = sizeof(kwsArena) - 8;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_kws_stream_init(&kws));
+
+    initialize_kws_config();
+    kws.stride = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_kws_stream_init(&kws));
+}
+
+// The window must always be the last NUM_FRAMES frames, oldest first, contiguous
+void ns_kws_stream_window_layout_test() {
+    initialize_kws_config();
+    kws.stride = 1;
+    ns_kws_stream_init(&kws);
+
+    for (uint32_t frame = 0; frame < 3 * NUM_FRAMES + 7; frame++) {
+        push_frame(frame);
+        if (frame + 1 < NUM_FRAMES) {
+            continue;
+        }
+        const int8_t *w = ns_kws_stream_get_window(&kws);
+        uint32_t oldest = frame + 1 - NUM_FRAMES;
+        for (uint32_t f = 0; f < NUM_FRAMES; f++) {
+            for (int i = 0; i < NUM_COEFFS; i++) {
+                TEST_ASSERT_EQUAL_INT8((int8_t)(((oldest + f) % 100) + i), w[f * NUM_COEFFS + i]);
+            }
+        }
+    }
+}
+
+void ns_kws_stream_stride_test() {
+    initialize_kws_config();
+    ns_kws_stream_init(&kws);
+
+    uint32_t inferences = 0;
+    uint32_t first = 0;
+    for (uint32_t frame = 0; frame < NUM_FRAMES + 4 * STRIDE; frame++) {
+        if (push_frame(frame)) {
+            if (inferences == 0) {
+                first = frame;
+            }
+            inferences++;
+        }
+    }
+    // Nothing until the window is full, then one inference every STRIDE hops
+    TEST_ASSERT_EQUAL(NUM_FRAMES - 1, first);
+    TEST_ASSERT_EQUAL(5, inferences);
+}
+
+void ns_kws_stream_quantize_test() {
+    initialize_kws_config();
+    kws.stride = 1;
+    kws.num_frames = 1;
+    kws.input_scale = 0.5f;
+    kws.input_zero_point = -3;
+    ns_kws_stream_init(&kws);
+
+    float f[NUM_COEFFS] = {0.0f, 1.0f, -1.0f, 10.0f, -10.0f, 100.0f, -100.0f, 63.0f, -62.0f, 0.2f};
+    ns_kws_stream_push_features(&kws, f);
+    const int8_t *w = ns_kws_stream_get_window(&kws);
+
+    // Same math (and saturation) as the original per-element loop in kws.cc
+    for (int i = 0; i < NUM_COEFFS; i++) {
+        float tmp = f[i] / kws.input_scale + kws.input_zero_point;
+        tmp = MAX(MIN(tmp, 127), -128);
+        TEST_ASSERT_EQUAL_INT8((int8_t)tmp, w[i]);
+    }
+}
+
+void ns_kws_stream_smoothing_test() {
+    int8_t scores[NUM_CLASSES];
+    initialize_kws_config();
+    ns_kws_stream_init(&kws);
+
+    // A single confident inference is not enough to trigger
+    make_scores(scores, 9, 250);
+    TEST_ASSERT_EQUAL(NS_KWS_STREAM_NO_DETECTION, ns_kws_stream_push_scores(&kws, scores));
+    make_scores(scores, 10, 250);
+    TEST_ASSERT_EQUAL(NS_KWS_STREAM_NO_DETECTION, ns_kws_stream_push_scores(&kws, scores));
+    make_scores(scores, 10, 250);
+    TEST_ASSERT_EQUAL(NS_KWS_STREAM_NO_DETECTION, ns_kws_stream_push_scores(&kws, scores));
+
+    // Sustained keyword triggers once, then is suppressed
+    int detections = 0;
+    for (int i = 0; i < 3; i++) {
+        make_scores(scores, 9, 200);
+        if (ns_kws_stream_push_scores(&kws, scores) == 9) {
+            detections++;
+        }
+    }
+    TEST_ASSERT_EQUAL(1, detections);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 200.0f / 256.0f, ns_kws_stream_get_smoothed(&kws, 9));
+
+    // Ignored classes never trigger
+    ns_kws_stream_reset(&kws);
+    for (int i = 0; i < 2 * SMOOTHING; i++) {
+        make_scores(scores, 10, 255);
+        TEST_ASSERT_EQUAL(NS_KWS_STREAM_NO_DETECTION, ns_kws_stream_push_scores(&kws, scores));
+    }
+}
+
+// Replays a synthetic clip (silence, keyword, silence) through features and a stub
+// classifier whose output follows the energy in the window
+void ns_kws_stream_replay_test() {
+    int8_t scores[NUM_CLASSES];
+    int32_t detected = NS_KWS_STREAM_NO_DETECTION;
+    uint32_t detections = 0;
+    initialize_kws_config();
+    kws.stride = 2;
+    kws.suppression = 25; // one detection per utterance
+    ns_kws_stream_init(&kws);
+
+    for (uint32_t frame = 0; frame < 200; frame++) {
+        float f[NUM_COEFFS];
+        bool keyword = (frame >= 80) && (frame < 110);
+        for (int i = 0; i < NUM_COEFFS; i++) {
+            f[i] = keyword ? 40.0f : -40.0f;
+        }
+        if (!ns_kws_stream_push_features(&kws, f)) {
+            continue;
+        }
+
+        const int8_t *w = ns_kws_stream_get_window(&kws);
+        int32_t loud = 0;
+        for (int i = 0; i < NUM_FRAMES * NUM_COEFFS; i++) {
+            loud += (w[i] > 0);
+        }
+        bool hot = loud > (NUM_FRAMES * NUM_COEFFS) / 2 - 50;
+        make_scores(scores, hot ? 5 : 10, 240);
+        int32_t d = ns_kws_stream_push_scores(&kws, scores);
+        if (d != NS_KWS_STREAM_NO_DETECTION) {
+            detected = d;
+            detections++;
+        }
+    }
+    TEST_ASSERT_EQUAL(5, detected);
+    TEST_ASSERT_EQUAL(1, detections);
+}
+
+// The KWS app's front end (kws.cc): 20ms hops of 16kHz audio, 40 filterbank bins, and its
+// model's input quantization
+#define HOP_SAMPLES 320
+#define FRAME_LEN_POW2 512
+#define NUM_FBANK_BINS 40
+#define REPLAY_HOPS 120
+#define MFCC_ARENA_SIZE                                                                            \
+    32 * (FRAME_LEN_POW2 * 2 + NUM_FBANK_BINS * (NS_MFCC_SIZEBINS + NUM_COEFFS))
+
+static uint8_t mfccArena[MFCC_ARENA_SIZE] __attribute__((aligned(4)));
+static float mfccHistory[REPLAY_HOPS][NUM_COEFFS];
+
+static void initialize_mfcc_config(ns_mfcc_cfg_t *m) {
+    m->api = &ns_mfcc_V1_0_0;
+    m->arena = mfccArena;
+    m->sample_frequency = 16000;
+    m->num_fbank_bins = NUM_FBANK_BINS;
+    m->low_freq = 20;
+    m->high_freq = 4000;
+    m->num_frames = NUM_FRAMES;
+    m->num_coeffs = NUM_COEFFS;
+    m->num_dec_bits = 0;
+    m->frame_shift_ms = 20;
+    m->frame_len_ms = 30;
+    m->frame_len = HOP_SAMPLES;
+    m->frame_len_pow2 = FRAME_LEN_POW2;
+}
+
+// Background noise, then a voiced "word" (harmonics of a gliding pitch under an envelope)
+// loud enough to clip, then noise again
+static void make_hop(uint32_t hop, int16_t *pcm) {
+    static uint32_t lcg = 12345;
+    for (uint32_t i = 0; i < HOP_SAMPLES; i++) {
+        float t = (float)(hop * HOP_SAMPLES + i) / 16000.0f;
+        lcg = lcg * 1664525u + 1013904223u;
+        float x = (float)((int32_t)(lcg >> 16) - 32768) / 128.0f;
+        if ((hop >= 40) && (hop < 90)) {
+            float env = sinf((float)M_PI * (t - 0.8f) / 1.0f) * 40000.0f;
+            float f0 = 140.0f + 60.0f * (t - 0.8f);
+            for (int h = 1; h <= 8; h++) {
+                x += env / h * sinf(2.0f * (float)M_PI * h * f0 * t);
+            }
+        }
+        pcm[i] = (int16_t)MAX(MIN(x, 32767.0f), -32768.0f);
+    }
+}
+
+// Replays PCM through ns_kws_stream_push_audio() with the app's MFCC config, and checks each
+// window against the float MFCCs of the same hops quantized the way kws.cc did before the
+// stream: x / scale + zero_point, saturated, over the whole window
+void ns_kws_stream_mfcc_replay_test() {
+    ns_mfcc_cfg_t mfcc;
+    int16_t pcm[HOP_SAMPLES];
+    uint32_t windows = 0, mismatches = 0;
+    int8_t lo = 127, hi = -128;
+
+    initialize_mfcc_config(&mfcc);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_mfcc_init(&mfcc));
+    initialize_kws_config();
+    kws.mfcc = &mfcc;
+    kws.stride = 1;
+    kws.input_scale = 0.5847029f; // apps/ai/kws model input
+    kws.input_zero_point = 83;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_kws_stream_init(&kws));
+
+    for (uint32_t hop = 0; hop < REPLAY_HOPS; hop++) {
+        make_hop(hop, pcm);
+        bool infer = ns_kws_stream_push_audio(&kws, pcm);
+
+        // ns_mfcc_compute() keeps no state between hops, so this is the float path's result
+        ns_mfcc_compute(&mfcc, pcm, mfccHistory[hop]);
+        TEST_ASSERT_EQUAL(hop + 1 >= NUM_FRAMES, infer);
+        if (!infer) {
+            continue;
+        }
+
+        const int8_t *w = ns_kws_stream_get_window(&kws);
+        const float *f = mfccHistory[hop + 1 - NUM_FRAMES];
+        for (uint32_t i = 0; i < NUM_FRAMES * NUM_COEFFS; i++) {
+            float tmp = f[i] / kws.input_scale + kws.input_zero_point;
+            tmp = MAX(MIN(tmp, 127), -128);
+            mismatches += (int8_t)tmp != w[i];
+            lo = MIN(lo, w[i]);
+            hi = MAX(hi, w[i]);
+        }
+        windows++;
+    }
+    TEST_ASSERT_EQUAL(REPLAY_HOPS - NUM_FRAMES + 1, windows);
+    TEST_ASSERT_EQUAL(0, mismatches);
+    // Silence and the word span most of the model's input range (MFCCs of about -20 to 20)
+    TEST_ASSERT_TRUE(hi - lo > 60);
+}
@@ -0,0 +1,11 @@
+#include "ns_audio_kws_stream.h"
+void ns_kws_stream_tests_pre_test_hook();
+void ns_kws_stream_tests_post_test_hook();
+void ns_kws_stream_init_test();
+void ns_kws_stream_invalid_config_test();
+void ns_kws_stream_window_layout_test();
+void ns_kws_stream_stride_test();
+void ns_kws_stream_quantize_test();
+void ns_kws_stream_smoothing_test();
+void ns_kws_stream_replay_test();
+void ns_kws_stream_mfcc_replay_test();
@@ -57,6 +57,7 @@ extern "C" {
         #include "hci_drv_cooper.h"
     #endif
     #include "hci_handler.h"
+    #include "ns_ble_stream.h"
 
     // *** Versions
     #define NS_BLE_V0_0_1                                                                          \
@@ -104,11 +105,10 @@ extern const ns_core_api_t ns_ble_current_version;
     #define NS_BLE_ATT_UUID_BUILD(part)                                                            \
         NS_BLE_ATT_UUID_POSTAMBLE, UINT16_TO_BYTES(part), NS_BLE_ATT_UUID_PREAMBLE
 
-    #ifndef NS_BLE_CONN_MAX
-        #define NS_BLE_CONN_MAX 1
-    #endif
+    // NS_BLE_CONN_MAX (default 1) is defined in ns_ble_stream.h
 
     #define NS_BLE_MAX_SERVICES 1
+    #define NS_BLE_CCC_TIMER_EVENT_BASE 0xC0 ///< WSF event of the first notify timer
 
 // *** Typedefs Prototypes (for callbacks)
 typedef struct ns_ble_control ns_ble_control_t;
@@ -265,6 +265,8 @@ typedef struct ns_ble_service {
     attsCccSet_t *cccSet;
     uint16_t nextCccIndex;
     uint16_t nextCccIndicationHandle;
+    ns_ble_characteristic_t **handleMap; // characteristic by (handle - baseHandle)
+    ns_ble_characteristic_t **cccMap;    // characteristic by CCC index
 
     attsGroup_t group;      // attribute group for Cordio
     attsAttr_t *attributes; // array of attributes for Cordio
@@ -332,6 +334,9 @@ typedef struct ns_ble_characteristic {
     uint32_t indicationPeriod;        /*! \brief periodic measurement period in ms */
     uint8_t indicationIsAsynchronous; /*! \brief TRUE if indication is asynchronous */
 
+    // Streaming (NULL unless created by ns_ble_create_stream_characteristic)
+    ns_ble_stream_t *stream;
+
     // Internals
     uint16_t handleId;
 
@@ -391,6 +396,22 @@ extern int ns_ble_create_characteristic(
     ns_ble_characteristic_notify_handler_t notifyHandlerCb, uint16_t periodMs, uint8_t async,
     uint16_t *attributeCount);
 
+/**
+ * @brief Define a streaming notify characteristic. Data pushed with ns_ble_stream_push() is sent
+ * to every subscribed connection as back-to-back MTU-sized notifications.
+ *
+ * @param c - config struct, populated by this function
+ * @param uuidString - a 16-byte UUID string
+ * @param stream - stream config (buffer, size, credits, port), initialized when the
+ * characteristic is added to the service
+ * @param attributeCount - a pointer to the service's attribute count. This is incremented by the
+ * function.
+ * @return int
+ */
+extern int ns_ble_create_stream_characteristic(
+    ns_ble_characteristic_t *c, char const *uuidString, ns_ble_stream_t *stream,
+    uint16_t *attributeCount);
+
 /**
  * @brief Add a characteristic to a service. This function should be called after all
  * characteristics have been defined using ns_ble_create_characteristic.
@@ -0,0 +1,160 @@
+/**
+ * @file ns_ble_stream.h
+ * @author Ambiq
+ * @brief Lock-free notification streaming queue for ns-ble
+ * @version 0.1
+ * @date 2025-07-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A stream turns a notify characteristic into a byte pipe. The application pushes data from
+ * any single task or ISR; the BLE task drains it as MTU-sized notifications, keeping up to
+ * `credits` notifications in flight per connection. Bytes stay in the ring until their
+ * ATTS_HANDLE_VALUE_CNF reports success; a notification ATT dropped (ATT_ERR_OVERFLOW) is
+ * sent again, so no data is lost when the link backs up.
+ *
+ * \addtogroup ns-ble
+ * @{
+ *
+ */
+
+#ifndef NS_BLE_STREAM
+    #define NS_BLE_STREAM
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #ifndef NS_BLE_CONN_MAX
+        #define NS_BLE_CONN_MAX 1
+    #endif
+
+    #ifndef NS_BLE_STREAM_DEFAULT_CREDITS
+        #define NS_BLE_STREAM_DEFAULT_CREDITS 4
+    #endif
+
+    #ifndef NS_BLE_STREAM_MAX_CREDITS
+        #define NS_BLE_STREAM_MAX_CREDITS 8 ///< Bound on credits, sizes the in-flight tracking
+    #endif
+
+    #define NS_BLE_STREAM_NTF_HDR_LEN 3 ///< ATT notification opcode + handle
+    #define NS_BLE_STREAM_EVT 0x01      ///< WSF event bit used to wake the ns-ble handler
+
+/**
+ * @brief Transport hooks used by the stream. ns-ble supplies ns_ble_stream_att_port, which maps
+ * these to Cordio ATT; tests can supply a simulated link.
+ */
+typedef struct {
+    uint16_t (*mtu)(void *ctx, uint8_t connId);       ///< Current ATT MTU of the connection
+    uint8_t *(*alloc)(void *ctx, uint16_t len);       ///< Allocate a notification payload
+    void (*notify)(                                   ///< Send (and take ownership of) a payload
+        void *ctx, uint8_t connId, uint16_t handle, uint16_t len, uint8_t *pValue);
+    void (*kick)(void *ctx);                          ///< Schedule ns_ble_stream_service_all()
+    void *ctx;
+    uint8_t maxCredits; ///< Notifications the transport accepts at once (0 = no limit)
+} ns_ble_stream_port_t;
+
+typedef struct {
+    uint32_t pushed;        ///< Bytes accepted by ns_ble_stream_push
+    uint32_t overflows;     ///< Pushes rejected because a subscriber was too far behind
+    uint32_t notifications; ///< Notifications handed to ATT
+    uint32_t bytesSent;     ///< Payload bytes handed to ATT
+    uint32_t creditStalls;  ///< Times data was waiting but every credit was in flight
+    uint32_t allocFailures; ///< Times a notification buffer couldn't be allocated
+    uint32_t dropped;       ///< Notifications ATT confirmed with an error (their bytes are resent)
+    uint32_t rewinds;       ///< Times a connection went back to its oldest unconfirmed byte
+} ns_ble_stream_stats_t;
+
+typedef struct ns_ble_stream {
+    // Config
+    uint8_t *buffer;                   ///< Ring storage, allocated by caller
+    uint32_t size;                     ///< Size of buffer in bytes, must be a power of 2
+    uint8_t credits; ///< Notifications in flight per connection (0 = default), capped at the
+                     ///< port's maxCredits and NS_BLE_STREAM_MAX_CREDITS
+    const ns_ble_stream_port_t *port;  ///< Transport, usually &ns_ble_stream_att_port
+
+    // Internals - the following is initialized internally
+    volatile uint32_t head;                    ///< Written by the producer only
+    volatile uint32_t tail[NS_BLE_CONN_MAX];   ///< Oldest unconfirmed byte, BLE task only
+    uint32_t sent[NS_BLE_CONN_MAX];            ///< Next byte to notify, BLE task only
+    volatile uint32_t subscribed;              ///< Bit (connId - 1) set while notifying
+    uint32_t rewinding;                        ///< Bit (connId - 1) set after a failed CNF
+    uint8_t inFlight[NS_BLE_CONN_MAX];         ///< Notifications awaiting confirmation
+    uint8_t firstInFlight[NS_BLE_CONN_MAX];    ///< Oldest entry of inFlightLen
+    uint16_t inFlightLen[NS_BLE_CONN_MAX][NS_BLE_STREAM_MAX_CREDITS]; ///< In send order
+    uint16_t valueHandle;                      ///< Handle of the streamed characteristic value
+    ns_ble_stream_stats_t stats;
+    struct ns_ble_stream *next;
+} ns_ble_stream_t;
+
+extern const ns_ble_stream_port_t ns_ble_stream_att_port;
+
+/**
+ * @brief Initialize a stream and register it for servicing. Called by
+ * ns_ble_add_characteristic for stream characteristics; tests may call it directly.
+ *
+ * @param s - stream with buffer, size, credits and port filled in
+ * @param valueHandle - value handle the notifications are sent on
+ * @return uint32_t status
+ */
+extern uint32_t ns_ble_stream_init(ns_ble_stream_t *s, uint16_t valueHandle);
+
+/**
+ * @brief Queue data for every subscribed connection. Lock-free, may be called from one
+ * producer (task or ISR). The data is queued completely or not at all.
+ *
+ * @param s - stream
+ * @param data - bytes to send
+ * @param len - number of bytes
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the slowest subscriber doesn't
+ * have room for len bytes
+ */
+extern uint32_t ns_ble_stream_push(ns_ble_stream_t *s, const void *data, uint32_t len);
+
+/**
+ * @brief Free space available to the producer, in bytes
+ */
+extern uint32_t ns_ble_stream_space(ns_ble_stream_t *s);
+
+/**
+ * @brief Send as many notifications as credits and queued data allow. BLE task context.
+ */
+extern void ns_ble_stream_service(ns_ble_stream_t *s);
+
+/**
+ * @brief Service every registered stream. BLE task context, invoked on NS_BLE_STREAM_EVT.
+ */
+extern void ns_ble_stream_service_all(void);
+
+/**
+ * @brief CCC state change for a stream. Subscribing starts at the current end of the stream.
+ */
+extern void ns_ble_stream_ccc(ns_ble_stream_t *s, uint8_t connId, bool enabled);
+
+/**
+ * @brief Notification confirmation (ATTS_HANDLE_VALUE_CNF) for a stream - returns a credit
+ *
+ * On success the notification's bytes are released to the producer. On an error (e.g.
+ * ATT_ERR_OVERFLOW) they are kept, and the connection resends from its oldest unconfirmed byte
+ * once the remaining notifications in flight are confirmed.
+ *
+ * @param s - stream
+ * @param connId - connection the notification was sent on
+ * @param status - CNF status (ATT_SUCCESS is 0)
+ */
+extern void ns_ble_stream_cnf(ns_ble_stream_t *s, uint8_t connId, uint8_t status);
+
+/**
+ * @brief Connection closed - unsubscribes the connection from every stream
+ */
+extern void ns_ble_stream_conn_close(uint8_t connId);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_BLE_STREAM
+       /** @}*/
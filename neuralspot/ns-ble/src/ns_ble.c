@@ -431,6 +431,8 @@ void ns_ble_generic_handler(wsfEventMask_t event, wsfMsgHdr_t *pMsg) {
         ns_ble_generic_procMsg((ns_ble_msg_t *)pMsg);
 
         // amdtpProcMsg((amdtpMsg_t *) pMsg);
+    } else if (event & NS_BLE_STREAM_EVT) {
+        ns_ble_stream_service_all();
     }
 }
 
@@ -596,72 +598,137 @@ void ns_ble_new_handler_init(wsfHandlerId_t handlerId) {
     // ns_lp_printf("ns_ble_new_handler_init\n");
 }
 
-static void ns_ble_generic_new_handle_cnf(attEvt_t *pMsg){};
+// *** Handle lookup
+// Handles are allocated contiguously from each service's baseHandle, so handle and CCC index
+// lookups are direct table reads instead of scans over every characteristic.
+
+static ns_ble_characteristic_t *ns_ble_find_by_handle(uint16_t handle, ns_ble_service_t **service) {
+    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
+        ns_ble_service_t *s = g_ns_ble_control.services[i];
+        if (handle >= s->baseHandle && handle < s->nextHandleId) {
+            *service = s;
+            return s->handleMap[handle - s->baseHandle];
+        }
+    }
+    return NULL;
+}
+
+static ns_ble_characteristic_t *ns_ble_find_by_ccc(uint16_t cccIndex, ns_ble_service_t **service) {
+    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
+        ns_ble_service_t *s = g_ns_ble_control.services[i];
+        if (cccIndex > 0 && cccIndex < s->nextCccIndex) {
+            *service = s;
+            return s->cccMap[cccIndex];
+        }
+    }
+    return NULL;
+}
+
+static bool ns_ble_ccc_enabled_any(ns_ble_characteristic_t *c) {
+    for (dmConnId_t connId = 1; connId <= NS_BLE_CONN_MAX; connId++) {
+        if (AttsCccEnabled(connId, c->cccIndex)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// *** Stream transport (Cordio ATT)
+
+static uint16_t ns_ble_stream_att_mtu(void *ctx, uint8_t connId) { return AttGetMtu(connId); }
+
+static uint8_t *ns_ble_stream_att_alloc(void *ctx, uint16_t len) {
+    return AttMsgAlloc(len, ATT_PDU_VALUE_NTF);
+}
+
+static void ns_ble_stream_att_notify(
+    void *ctx, uint8_t connId, uint16_t handle, uint16_t len, uint8_t *pValue) {
+    AttsHandleValueNtfZeroCpy(connId, handle, len, pValue);
+}
+
+static void ns_ble_stream_att_kick(void *ctx) {
+    WsfSetEvent(g_ns_ble_control.handlerId, NS_BLE_STREAM_EVT);
+}
+
+const ns_ble_stream_port_t ns_ble_stream_att_port = {
+    .mtu = ns_ble_stream_att_mtu,
+    .alloc = ns_ble_stream_att_alloc,
+    .notify = ns_ble_stream_att_notify,
+    .kick = ns_ble_stream_att_kick,
+    .ctx = NULL,
+    .maxCredits = ATT_NUM_SIMUL_NTF,
+};
+
+static void ns_ble_generic_new_handle_cnf(attEvt_t *pMsg) {
+    ns_ble_service_t *service;
+    ns_ble_characteristic_t *c = ns_ble_find_by_handle(pMsg->handle, &service);
+    if (c != NULL && c->stream != NULL) {
+        ns_ble_stream_cnf(c->stream, (dmConnId_t)pMsg->hdr.param, pMsg->hdr.status);
+    }
+}
 
 void ns_ble_send_value(ns_ble_characteristic_t *c, attEvt_t *pMsg) {
-    dmConnId_t connId = 1;
     // ns_lp_printf("ns_ble_send_value");
-    if (AttsCccEnabled(connId, c->indicationTimer.msg.status)) {
-        int ret = AttsSetAttr(c->valueHandle, c->valueLen, c->applicationValue);
-        if (ret != ATT_SUCCESS) {
-            ns_lp_printf("... failed to send\n");
+    int ret = AttsSetAttr(c->valueHandle, c->valueLen, c->applicationValue);
+    if (ret != ATT_SUCCESS) {
+        ns_lp_printf("... failed to send\n");
+    }
+    for (dmConnId_t connId = 1; connId <= NS_BLE_CONN_MAX; connId++) {
+        if (AttsCccEnabled(connId, c->cccIndex)) {
+            ns_interrupt_master_disable(); // critical region
+            AttsHandleValueNtf(connId, c->valueHandle, c->valueLen, c->applicationValue);
+            ns_interrupt_master_enable();
         }
-        ns_interrupt_master_disable(); // critical region
-        AttsHandleValueNtf(connId, c->valueHandle, c->valueLen, c->applicationValue);
-        ns_interrupt_master_enable();
-    } else {
-        // ns_lp_printf("... not sent\n");
     }
 }
 
 static bool ns_ble_handle_indication_timer_expired(ns_ble_msg_t *pMsg) {
     uint8_t event = pMsg->hdr.event;
     ns_ble_service_t *service;
+    ns_ble_characteristic_t *c;
     // ns_lp_printf("ns_ble_handle_indication_timer_expired\n");
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            if (service->characteristics[j]->cccIndicationHandle == event) {
-                ns_ble_characteristic_t *c = service->characteristics[j];
-                // Found a match, handle timer expiry
-                // Call the callback to update the value of attribute
-                c->notifyHandlerCb(service, c);
-
-                // Send the value if not asynchronous
-                if (c->indicationIsAsynchronous == false) {
-                    ns_ble_send_value(c, (attEvt_t *)pMsg);
-                }
-
-                // Restart timer
-                WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
-                return true;
-            }
-        }
+    // Timer events are allocated in step with CCC indexes (see ns_ble_add_characteristic)
+    if (event < NS_BLE_CCC_TIMER_EVENT_BASE) {
+        return false;
     }
-    return false;
+    c = ns_ble_find_by_ccc(event - NS_BLE_CCC_TIMER_EVENT_BASE + 1, &service);
+    if (c == NULL || c->cccIndicationHandle != event) {
+        return false;
+    }
+
+    // Call the callback to update the value of attribute
+    c->notifyHandlerCb(service, c);
+
+    // Send the value if not asynchronous
+    if (c->indicationIsAsynchronous == false) {
+        ns_ble_send_value(c, (attEvt_t *)pMsg);
+    }
+
+    // Restart timer
+    WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
+    return true;
 }
 
 static void ns_ble_process_ccc_state(attsCccEvt_t *pMsg) {
-    uint8_t idx = pMsg->idx;
     ns_ble_service_t *service;
+    ns_ble_characteristic_t *c = ns_ble_find_by_ccc(pMsg->idx, &service);
     // ns_lp_printf("ns_ble_process_ccc_state\n");
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            ns_ble_characteristic_t *c = service->characteristics[j];
-            // ns_lp_printf("webbleProcessCccState: %d %d %d\n", j, idx, c->cccIndex);
-            if (service->characteristics[j]->cccIndex == idx) {
-                if (pMsg->value == ATT_CLIENT_CFG_NOTIFY) {
-                    // Start the timer
-                    ns_lp_printf("webbleStartTimer\n");
-                    WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
-                } else {
-                    // Stop the timer
-                    ns_lp_printf("webbleStopTimer\n");
-                    WsfTimerStop(&c->indicationTimer);
-                }
-            }
-        }
+    if (c == NULL) {
+        return;
+    }
+
+    if (c->stream != NULL) {
+        ns_ble_stream_ccc(
+            c->stream, (dmConnId_t)pMsg->hdr.param, pMsg->value == ATT_CLIENT_CFG_NOTIFY);
+        ns_ble_stream_service(c->stream);
+    } else if (pMsg->value == ATT_CLIENT_CFG_NOTIFY) {
+        // Start the timer
+        ns_lp_printf("webbleStartTimer\n");
+        WsfTimerStartMs(&c->indicationTimer, c->indicationPeriod);
+    } else if (!ns_ble_ccc_enabled_any(c)) {
+        // Stop the timer once no connection is subscribed
+        ns_lp_printf("webbleStopTimer\n");
+        WsfTimerStop(&c->indicationTimer);
     }
 }
 
@@ -672,11 +739,11 @@ bool ns_ble_new_proc_msg(ns_ble_msg_t *pMsg) {
     switch (pMsg->hdr.event) {
     case DM_CONN_OPEN_IND:
         ns_ble_generic_conn_open((dmEvt_t *)pMsg);
-        DmConnSetDataLen(1, 251, 0x848);
+        DmConnSetDataLen((dmConnId_t)pMsg->hdr.param, 251, 0x848);
         break;
 
     case DM_CONN_CLOSE_IND:
-        // amdtps_conn_close((dmEvt_t *) pMsg);
+        ns_ble_stream_conn_close((dmConnId_t)pMsg->hdr.param);
         break;
 
     case ATTS_CCC_STATE_IND:
@@ -736,16 +803,10 @@ uint8_t ns_ble_generic_write_cback(
     dmConnId_t connId, uint16_t handle, uint8_t operation, uint16_t offset, uint16_t len,
     uint8_t *pValue, attsAttr_t *pAttr) {
     // ns_lp_printf("ns_ble_generic_write_cback, handle %d\n", handle);
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        ns_ble_service_t *service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            if (service->characteristics[j]->valueHandle == handle) {
-                if (service->characteristics[j]->writeHandlerCb) {
-                    return service->characteristics[j]->writeHandlerCb(
-                        service, service->characteristics[j], pValue);
-                }
-            }
-        }
+    ns_ble_service_t *service;
+    ns_ble_characteristic_t *c = ns_ble_find_by_handle(handle, &service);
+    if (c != NULL && c->valueHandle == handle && c->writeHandlerCb) {
+        return c->writeHandlerCb(service, c, pValue);
     }
 
     return ATT_ERR_HANDLE;
@@ -754,16 +815,10 @@ uint8_t ns_ble_generic_write_cback(
 uint8_t ns_ble_generic_read_cback(
     dmConnId_t connId, uint16_t handle, uint8_t operation, uint16_t offset, attsAttr_t *pAttr) {
     // ns_lp_printf("ns_ble_generic_read_cback, handle %d\n", handle);
-    for (int i = 0; i < g_ns_ble_control.numServices; i++) {
-        ns_ble_service_t *service = g_ns_ble_control.services[i];
-        for (int j = 0; j < service->numCharacteristics; j++) {
-            if (service->characteristics[j]->valueHandle == handle) {
-                if (service->characteristics[j]->readHandlerCb) {
-                    return service->characteristics[j]->readHandlerCb(
-                        service, service->characteristics[j], pAttr->pValue);
-                }
-            }
-        }
+    ns_ble_service_t *service;
+    ns_ble_characteristic_t *c = ns_ble_find_by_handle(handle, &service);
+    if (c != NULL && c->valueHandle == handle && c->readHandlerCb) {
+        return c->readHandlerCb(service, c, pAttr->pValue);
     }
     ns_lp_printf("ns_ble_generic_read_cback, handle %d, not found\n", handle);
     return ATT_ERR_HANDLE;
@@ -848,7 +903,16 @@ int ns_ble_create_service(ns_ble_service_t *service) {
     service->cccSet[0].valueRange = ATT_CLIENT_CFG_INDICATE;
     service->cccSet[0].secLevel = DM_SEC_LEVEL_NONE;
     service->nextCccIndex = 1;
-    service->nextCccIndicationHandle = 0xC0; // TODO pick a better way to start this
+    service->nextCccIndicationHandle = NS_BLE_CCC_TIMER_EVENT_BASE;
+
+    // *** Handle and CCC index lookup tables, filled in as characteristics are added
+    service->handleMap = ns_malloc(sizeof(ns_ble_characteristic_t *) * service->numAttributes);
+    service->cccMap = ns_malloc(sizeof(ns_ble_characteristic_t *) * (numCccAttributes + 1));
+    if (service->handleMap == NULL || service->cccMap == NULL) {
+        return NS_STATUS_FAILURE;
+    }
+    memset(service->handleMap, 0, sizeof(ns_ble_characteristic_t *) * service->numAttributes);
+    memset(service->cccMap, 0, sizeof(ns_ble_characteristic_t *) * (numCccAttributes + 1));
 
     // *** TODO name and version attributes
 
@@ -896,6 +960,7 @@ int ns_ble_create_characteristic(
     c->readHandlerCb = readHandlerCb;
     c->writeHandlerCb = writeHandlerCb;
     c->notifyHandlerCb = notifyHandlerCb;
+    c->stream = NULL;
 
     // *** Remember mem location of attribute's value
     // (different from WSF 'value', which is a placeholder)
@@ -974,6 +1039,20 @@ int ns_ble_create_characteristic(
     return NS_STATUS_SUCCESS;
 }
 
+int ns_ble_create_stream_characteristic(
+    ns_ble_characteristic_t *c, const char *uuidString, ns_ble_stream_t *stream,
+    uint16_t *attributeCount) {
+    // Notifications are built straight from the stream, the value attribute is just a placeholder
+    NS_TRY(
+        ns_ble_create_characteristic(
+            c, uuidString, NULL, ATT_DEFAULT_PAYLOAD_LEN, NS_BLE_NOTIFY, NULL, NULL, NULL, 0, true,
+            attributeCount),
+        "Failed to create stream characteristic\n");
+    c->valueLen = 0;
+    c->stream = stream;
+    return NS_STATUS_SUCCESS;
+}
+
 int ns_ble_add_characteristic(ns_ble_service_t *s, ns_ble_characteristic_t *c) {
     // *** Add Characteristic to Service Attributes List
     // Declaration Attribute
@@ -1008,7 +1087,15 @@ int ns_ble_add_characteristic(ns_ble_service_t *s, ns_ble_characteristic_t *c) {
         c->indicationTimer.handlerId = g_ns_ble_control.handlerId;
         c->indicationTimer.msg.event = c->cccIndicationHandle;
         c->indicationTimer.msg.status = s->nextCccIndex;
+        s->cccMap[s->nextCccIndex] = c;
         s->nextCccIndex += 1;
+        s->handleMap[c->cccHandle - s->baseHandle] = c;
+    }
+    s->handleMap[c->declarationHandle - s->baseHandle] = c;
+    s->handleMap[c->valueHandle - s->baseHandle] = c;
+
+    if (c->stream != NULL) {
+        NS_TRY(ns_ble_stream_init(c->stream, c->valueHandle), "Failed to init stream\n");
     }
 
     // Add Characteristic to Service Characteristic List
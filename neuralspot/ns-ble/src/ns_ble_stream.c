@@ -0,0 +1,239 @@
+/**
+ * @file ns_ble_stream.c
+ * @author Ambiq
+ * @brief Lock-free notification streaming queue for ns-ble
+ * @version 0.1
+ * @date 2025-07-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The ring has one producer-owned head and one tail per connection, so it needs no locks as
+ * long as there is a single producer and all of the consumer side runs in the BLE task. The
+ * producer is limited by the slowest subscribed connection.
+ *
+ * A connection's tail only moves when ATT confirms a notification; sent runs ahead of it by the
+ * bytes in flight. Cordio confirms notifications in the order they were queued, except that
+ * once one is held back by L2CAP flow control, every later one on the same handle fails with
+ * ATT_ERR_OVERFLOW until it completes. Successes are therefore always the oldest notifications
+ * in flight, and after a failure the connection resends from tail.
+ */
+
+#include "ns_ble_stream.h"
+#include <string.h>
+
+static ns_ble_stream_t *ns_ble_stream_list = NULL;
+
+// Orders ring data against head/tail updates (DMB on Cortex-M)
+#define NS_BLE_STREAM_BARRIER() __sync_synchronize()
+
+static uint32_t ns_ble_stream_backlog(ns_ble_stream_t *s, uint32_t head) {
+    uint32_t backlog = 0;
+    uint32_t subscribed = s->subscribed;
+    for (int i = 0; i < NS_BLE_CONN_MAX; i++) {
+        if (subscribed & (1u << i)) {
+            backlog = MAX(backlog, head - s->tail[i]);
+        }
+    }
+    return MIN(backlog, s->size);
+}
+
+uint32_t ns_ble_stream_init(ns_ble_stream_t *s, uint16_t valueHandle) {
+    if (s == NULL || s->buffer == NULL || s->port == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (s->size == 0 || (s->size & (s->size - 1)) != 0) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (s->credits == 0) {
+        s->credits = NS_BLE_STREAM_DEFAULT_CREDITS;
+    }
+    // More than ATT accepts at once would only come back as ATT_ERR_OVERFLOW
+    if (s->port->maxCredits != 0) {
+        s->credits = MIN(s->credits, s->port->maxCredits);
+    }
+    s->credits = MIN(s->credits, NS_BLE_STREAM_MAX_CREDITS);
+    s->valueHandle = valueHandle;
+    s->head = 0;
+    s->subscribed = 0;
+    s->rewinding = 0;
+    for (int i = 0; i < NS_BLE_CONN_MAX; i++) {
+        s->tail[i] = 0;
+        s->sent[i] = 0;
+        s->inFlight[i] = 0;
+        s->firstInFlight[i] = 0;
+    }
+    memset(&s->stats, 0, sizeof(s->stats));
+
+    // Register once
+    for (ns_ble_stream_t *it = ns_ble_stream_list; it != NULL; it = it->next) {
+        if (it == s) {
+            return NS_STATUS_SUCCESS;
+        }
+    }
+    s->next = ns_ble_stream_list;
+    ns_ble_stream_list = s;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ble_stream_space(ns_ble_stream_t *s) {
+    return s->size - ns_ble_stream_backlog(s, s->head);
+}
+
+uint32_t ns_ble_stream_push(ns_ble_stream_t *s, const void *data, uint32_t len) {
+    uint32_t head = s->head;
+    uint32_t mask = s->size - 1;
+
+    if (len > s->size - ns_ble_stream_backlog(s, head)) {
+        s->stats.overflows++;
+        return NS_STATUS_FAILURE;
+    }
+
+    uint32_t offset = head & mask;
+    uint32_t first = MIN(len, s->size - offset);
+    memcpy(&s->buffer[offset], data, first);
+    memcpy(s->buffer, (const uint8_t *)data + first, len - first);
+
+    NS_BLE_STREAM_BARRIER();
+    s->head = head + len;
+    s->stats.pushed += len;
+
+    if (s->subscribed) {
+        s->port->kick(s->port->ctx);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static void ns_ble_stream_service_conn(ns_ble_stream_t *s, int i) {
+    uint8_t connId = i + 1;
+    uint32_t mask = s->size - 1;
+    uint16_t mtu = s->port->mtu(s->port->ctx, connId);
+    uint16_t payloadMax = mtu - NS_BLE_STREAM_NTF_HDR_LEN;
+
+    // Wait for the notifications still in flight before resending
+    if (s->rewinding & (1u << i)) {
+        return;
+    }
+    while (1) {
+        uint32_t head = s->head;
+        NS_BLE_STREAM_BARRIER();
+        uint32_t sent = s->sent[i];
+        uint32_t avail = head - sent;
+
+        if (avail == 0) {
+            return;
+        }
+        if (head - s->tail[i] > s->size) {
+            // Only possible right after subscribing while a push was in progress (nothing is
+            // in flight yet); skip ahead
+            s->tail[i] = sent = head - s->size;
+            avail = s->size;
+        }
+        if (s->inFlight[i] >= s->credits) {
+            s->stats.creditStalls++;
+            return;
+        }
+        // Hold back a partial notification while others are in flight - more data will
+        // likely arrive before the next confirmation, and full notifications use the
+        // connection event better.
+        if (avail < payloadMax && s->inFlight[i] != 0) {
+            return;
+        }
+
+        uint16_t len = MIN(avail, payloadMax);
+        uint8_t *pValue = s->port->alloc(s->port->ctx, len);
+        if (pValue == NULL) {
+            // Retried on the next confirmation or push
+            s->stats.allocFailures++;
+            return;
+        }
+
+        uint32_t offset = sent & mask;
+        uint32_t first = MIN(len, s->size - offset);
+        memcpy(pValue, &s->buffer[offset], first);
+        memcpy(pValue + first, s->buffer, len - first);
+
+        // The bytes stay in the ring (tail is unchanged) until ATT confirms them
+        s->sent[i] = sent + len;
+        s->inFlightLen[i][(s->firstInFlight[i] + s->inFlight[i]) % NS_BLE_STREAM_MAX_CREDITS] =
+            len;
+        s->inFlight[i]++;
+        s->stats.notifications++;
+        s->stats.bytesSent += len;
+        s->port->notify(s->port->ctx, connId, s->valueHandle, len, pValue);
+    }
+}
+
+void ns_ble_stream_service(ns_ble_stream_t *s) {
+    for (int i = 0; i < NS_BLE_CONN_MAX; i++) {
+        if (s->subscribed & (1u << i)) {
+            ns_ble_stream_service_conn(s, i);
+        }
+    }
+}
+
+void ns_ble_stream_service_all(void) {
+    for (ns_ble_stream_t *s = ns_ble_stream_list; s != NULL; s = s->next) {
+        ns_ble_stream_service(s);
+    }
+}
+
+void ns_ble_stream_ccc(ns_ble_stream_t *s, uint8_t connId, bool enabled) {
+    if (connId == 0 || connId > NS_BLE_CONN_MAX) {
+        return;
+    }
+    int i = connId - 1;
+    if (enabled) {
+        if (s->subscribed & (1u << i)) {
+            return;
+        }
+        s->tail[i] = s->sent[i] = s->head;
+        s->inFlight[i] = 0;
+        s->firstInFlight[i] = 0;
+        s->rewinding &= ~(1u << i);
+        NS_BLE_STREAM_BARRIER();
+        s->subscribed |= (1u << i);
+    } else {
+        s->subscribed &= ~(1u << i);
+    }
+}
+
+void ns_ble_stream_cnf(ns_ble_stream_t *s, uint8_t connId, uint8_t status) {
+    if (connId == 0 || connId > NS_BLE_CONN_MAX) {
+        return;
+    }
+    int i = connId - 1;
+    if (s->inFlight[i] == 0) {
+        return; // Sent before the connection resubscribed
+    }
+    s->inFlight[i]--;
+    if (status == 0) {
+        // The oldest notification in flight was delivered, free its bytes
+        uint16_t len = s->inFlightLen[i][s->firstInFlight[i]];
+        s->firstInFlight[i] = (s->firstInFlight[i] + 1) % NS_BLE_STREAM_MAX_CREDITS;
+        NS_BLE_STREAM_BARRIER();
+        s->tail[i] += len;
+    } else {
+        // Dropped by ATT, one of the newest in flight
+        s->stats.dropped++;
+        s->rewinding |= (1u << i);
+    }
+    if ((s->rewinding & (1u << i)) && (s->inFlight[i] == 0)) {
+        s->sent[i] = s->tail[i];
+        s->firstInFlight[i] = 0;
+        s->rewinding &= ~(1u << i);
+        s->stats.rewinds++;
+    }
+    if (s->subscribed & (1u << i)) {
+        ns_ble_stream_service_conn(s, i);
+    }
+}
+
+void ns_ble_stream_conn_close(uint8_t connId) {
+    for (ns_ble_stream_t *s = ns_ble_stream_list; s != NULL; s = s->next) {
+        ns_ble_stream_ccc(s, connId, false);
+        if (connId != 0 && connId <= NS_BLE_CONN_MAX) {
+            s->inFlight[connId - 1] = 0;
+            s->rewinding &= ~(1u << (connId - 1));
+        }
+    }
+}
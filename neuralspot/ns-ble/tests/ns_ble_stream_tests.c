@@ -0,0 +1,478 @@
+#include "ns_ble_stream_tests.h"
+#include "ns_core.h"
+#include "unity/unity.h"
+#include <string.h>
+
+// The stream runs against a simulated ATT link: notifications are captured instead of sent,
+// and confirmations are delivered by the test the way ATTS_HANDLE_VALUE_CNF would be. The
+// bs_att port below also models Cordio's notification limits under L2CAP flow control.
+
+#define BS_HANDLE 0x0812
+#define BS_RING 1024
+#define BS_MAX_NTF 64
+#define BS_MAX_PAYLOAD 512
+#define BS_ATT_SUCCESS 0x00
+#define BS_ATT_ERR_OVERFLOW 0x72
+
+typedef struct {
+    uint8_t connId;
+    uint16_t len;
+    uint8_t data[BS_MAX_PAYLOAD];
+} bs_ntf_t;
+
+static uint16_t bsMtu[NS_BLE_CONN_MAX];
+static bs_ntf_t bsNtf[BS_MAX_NTF];
+static uint32_t bsNtfCount;
+static uint32_t bsKicks;
+static bool bsAllocFail;
+static uint8_t bsScratch[BS_MAX_PAYLOAD];
+
+// Next byte expected on each connection, and next byte to push
+static uint8_t bsExpect[NS_BLE_CONN_MAX];
+static uint8_t bsPattern;
+
+static uint16_t bs_mtu(void *ctx, uint8_t connId) { return bsMtu[connId - 1]; }
+
+static uint8_t *bs_alloc(void *ctx, uint16_t len) { return bsAllocFail ? NULL : bsScratch; }
+
+static void bs_notify(void *ctx, uint8_t connId, uint16_t handle, uint16_t len, uint8_t *pValue) {
+    TEST_ASSERT_EQUAL(BS_HANDLE, handle);
+    TEST_ASSERT_TRUE(bsNtfCount < BS_MAX_NTF);
+    bsNtf[bsNtfCount].connId = connId;
+    bsNtf[bsNtfCount].len = len;
+    memcpy(bsNtf[bsNtfCount].data, pValue, len);
+    bsNtfCount++;
+}
+
+static void bs_kick(void *ctx) { bsKicks++; }
+
+static const ns_ble_stream_port_t bs_port = {
+    .mtu = bs_mtu,
+    .alloc = bs_alloc,
+    .notify = bs_notify,
+    .kick = bs_kick,
+};
+
+static uint8_t bsBuffer[BS_RING];
+static ns_ble_stream_t stream;
+
+// Cordio ATTS (atts_ind.c): with L2CAP flow enabled a notification is sent and confirmed at
+// once. With flow disabled its confirmation is held until flow resumes, and a notification on
+// a handle that already has one held, or beyond ATT_NUM_SIMUL_NTF held ones, is dropped and
+// confirmed with ATT_ERR_OVERFLOW.
+typedef struct {
+    uint8_t connId;
+    uint8_t status;
+} bs_cnf_t;
+
+static bool bsAttFlowOff;
+static uint32_t bsAttFlowBudget; // Notifications until L2CAP flow stops again, 0 = unlimited
+static uint8_t bsAttHeld[NS_BLE_CONN_MAX];
+static bs_cnf_t bsAttCnf[BS_MAX_NTF];
+static uint32_t bsAttCnfCount;
+
+static void bs_att_queue_cnf(uint8_t connId, uint8_t status) {
+    TEST_ASSERT_TRUE(bsAttCnfCount < BS_MAX_NTF);
+    bsAttCnf[bsAttCnfCount].connId = connId;
+    bsAttCnf[bsAttCnfCount].status = status;
+    bsAttCnfCount++;
+}
+
+static void bs_att_notify(
+    void *ctx, uint8_t connId, uint16_t handle, uint16_t len, uint8_t *pValue) {
+    uint32_t held = 0;
+    for (int i = 0; i < NS_BLE_CONN_MAX; i++) {
+        held += bsAttHeld[i];
+    }
+    if (bsAttFlowOff && (bsAttHeld[connId - 1] != 0 || held >= *(uint8_t *)ctx)) {
+        bs_att_queue_cnf(connId, BS_ATT_ERR_OVERFLOW);
+        return;
+    }
+    bs_notify(ctx, connId, handle, len, pValue);
+    if (bsAttFlowOff) {
+        bsAttHeld[connId - 1]++;
+    } else {
+        bs_att_queue_cnf(connId, BS_ATT_SUCCESS);
+        if (bsAttFlowBudget != 0 && --bsAttFlowBudget == 0) {
+            bsAttFlowOff = true;
+        }
+    }
+}
+
+// Hand queued confirmations to the stream, including those its resends generate
+static void bs_att_deliver(void) {
+    for (uint32_t n = 0; n < bsAttCnfCount; n++) {
+        ns_ble_stream_cnf(&stream, bsAttCnf[n].connId, bsAttCnf[n].status);
+    }
+    bsAttCnfCount = 0;
+}
+
+static void bs_att_flow_on(uint32_t budget) {
+    bsAttFlowOff = false;
+    bsAttFlowBudget = budget;
+    for (int i = 0; i < NS_BLE_CONN_MAX; i++) {
+        if (bsAttHeld[i] != 0) {
+            bs_att_queue_cnf(i + 1, BS_ATT_SUCCESS);
+            bsAttHeld[i] = 0;
+        }
+    }
+    bs_att_deliver();
+}
+
+static uint8_t bsAttSimulNtf;
+static const ns_ble_stream_port_t bs_att_port = {
+    .mtu = bs_mtu,
+    .alloc = bs_alloc,
+    .notify = bs_att_notify,
+    .kick = bs_kick,
+    .ctx = &bsAttSimulNtf,
+    .maxCredits = 0, // set per test through bs_att_reset()
+};
+static ns_ble_stream_port_t bsAttPort;
+
+static void bs_reset_port(uint8_t credits, const ns_ble_stream_port_t *port) {
+    memset(&stream, 0, sizeof(stream));
+    stream.buffer = bsBuffer;
+    stream.size = BS_RING;
+    stream.credits = credits;
+    stream.port = port;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_ble_stream_init(&stream, BS_HANDLE));
+    for (int i = 0; i < NS_BLE_CONN_MAX; i++) {
+        bsMtu[i] = 247;
+        bsExpect[i] = 0;
+    }
+    bsNtfCount = 0;
+    bsKicks = 0;
+    bsAllocFail = false;
+    bsPattern = 0;
+    bsAttFlowOff = false;
+    bsAttFlowBudget = 0;
+    bsAttCnfCount = 0;
+    memset(bsAttHeld, 0, sizeof(bsAttHeld));
+}
+
+static void bs_reset(uint8_t credits) { bs_reset_port(credits, &bs_port); }
+
+// Cordio-like link with ATT_NUM_SIMUL_NTF = simulNtf, which the port reports as maxCredits
+static void bs_att_reset(uint8_t credits, uint8_t simulNtf) {
+    bsAttSimulNtf = simulNtf;
+    bsAttPort = bs_att_port;
+    bsAttPort.maxCredits = simulNtf;
+    bs_reset_port(credits, &bsAttPort);
+}
+
+static uint32_t bs_push(uint32_t len) {
+    uint8_t data[BS_RING];
+    for (uint32_t i = 0; i < len; i++) {
+        data[i] = bsPattern + i;
+    }
+    uint32_t status = ns_ble_stream_push(&stream, data, len);
+    if (status == NS_STATUS_SUCCESS) {
+        bsPattern += len;
+    }
+    return status;
+}
+
+// Check captured notifications carry the pushed byte sequence, then clear the capture
+static uint32_t bs_drain_check(void) {
+    uint32_t bytes = 0;
+    for (uint32_t n = 0; n < bsNtfCount; n++) {
+        uint8_t *expect = &bsExpect[bsNtf[n].connId - 1];
+        for (uint16_t i = 0; i < bsNtf[n].len; i++) {
+            TEST_ASSERT_EQUAL_UINT8(*expect, bsNtf[n].data[i]);
+            (*expect)++;
+        }
+        bytes += bsNtf[n].len;
+    }
+    bsNtfCount = 0;
+    return bytes;
+}
+
+// Confirm every notification in flight on a connection
+static void bs_confirm_all(uint8_t connId) {
+    while (stream.inFlight[connId - 1] > 0) {
+        ns_ble_stream_cnf(&stream, connId, BS_ATT_SUCCESS);
+    }
+}
+
+void ns_ble_stream_tests_pre_test_hook() {}
+
+void ns_ble_stream_tests_post_test_hook() {}
+
+void ns_ble_stream_test_init_validation() {
+    ns_ble_stream_t s = {.buffer = bsBuffer, .size = 1000, .port = &bs_port};
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_ble_stream_init(NULL, BS_HANDLE));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_ble_stream_init(&s, BS_HANDLE));
+    s.size = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_ble_stream_init(&s, BS_HANDLE));
+    s.size = BS_RING;
+    s.port = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_ble_stream_init(&s, BS_HANDLE));
+
+    bs_reset(0);
+    TEST_ASSERT_EQUAL(NS_BLE_STREAM_DEFAULT_CREDITS, stream.credits);
+    TEST_ASSERT_EQUAL(BS_RING, ns_ble_stream_space(&stream));
+}
+
+void ns_ble_stream_test_fills_credits_with_full_notifications() {
+    bs_reset(4);
+    ns_ble_stream_ccc(&stream, 1, true);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(1000));
+    TEST_ASSERT_EQUAL(1, bsKicks);
+    ns_ble_stream_service_all();
+
+    // Four credits, four MTU-sized notifications in one go
+    TEST_ASSERT_EQUAL(4, bsNtfCount);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(247 - NS_BLE_STREAM_NTF_HDR_LEN, bsNtf[i].len);
+    }
+    TEST_ASSERT_EQUAL(4 * 244, bs_drain_check());
+
+    // Remaining 24 bytes go out as soon as the link is idle
+    bs_confirm_all(1);
+    TEST_ASSERT_EQUAL(1, bsNtfCount);
+    TEST_ASSERT_EQUAL(24, bs_drain_check());
+    TEST_ASSERT_EQUAL(5, stream.stats.notifications);
+    TEST_ASSERT_EQUAL(1000, stream.stats.bytesSent);
+}
+
+void ns_ble_stream_test_partial_held_while_in_flight() {
+    bs_reset(4);
+    ns_ble_stream_ccc(&stream, 1, true);
+    bs_push(10);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(1, bsNtfCount); // idle link: send right away
+    TEST_ASSERT_EQUAL(10, bs_drain_check());
+
+    // More small pushes accumulate while the first is unconfirmed...
+    bs_push(10);
+    bs_push(30);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(0, bsNtfCount);
+
+    // ...and are packed into one notification on confirmation
+    ns_ble_stream_cnf(&stream, 1, BS_ATT_SUCCESS);
+    TEST_ASSERT_EQUAL(1, bsNtfCount);
+    TEST_ASSERT_EQUAL(40, bs_drain_check());
+}
+
+void ns_ble_stream_test_credit_flow_control() {
+    bs_reset(2);
+    ns_ble_stream_ccc(&stream, 1, true);
+    bsMtu[0] = 23;
+    bs_push(200);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(2, bsNtfCount);
+    TEST_ASSERT_EQUAL(2, stream.inFlight[0]);
+    TEST_ASSERT_EQUAL(1, stream.stats.creditStalls);
+
+    // Each confirmation releases exactly one more notification
+    uint32_t sent = bs_drain_check();
+    while (sent < 200) {
+        ns_ble_stream_cnf(&stream, 1, BS_ATT_SUCCESS);
+        TEST_ASSERT_TRUE(bsNtfCount <= 1);
+        TEST_ASSERT_TRUE(stream.inFlight[0] <= 2);
+        sent += bs_drain_check();
+    }
+    TEST_ASSERT_EQUAL(200, sent);
+}
+
+void ns_ble_stream_test_wrap_integrity() {
+    bs_reset(3);
+    ns_ble_stream_ccc(&stream, 1, true);
+    bsMtu[0] = 100;
+    uint32_t pushed = 0, sent = 0;
+
+    // Odd-sized pushes wrap the ring many times
+    for (int i = 0; i < 200; i++) {
+        uint32_t len = 1 + (i * 37) % 300;
+        if (bs_push(len) == NS_STATUS_SUCCESS) {
+            pushed += len;
+        }
+        ns_ble_stream_service_all();
+        sent += bs_drain_check();
+        if (i % 3 == 0) {
+            ns_ble_stream_cnf(&stream, 1, BS_ATT_SUCCESS);
+            sent += bs_drain_check();
+        }
+    }
+    while (sent < pushed) {
+        bs_confirm_all(1);
+        sent += bs_drain_check();
+    }
+    TEST_ASSERT_EQUAL(pushed, sent);
+    TEST_ASSERT_TRUE(pushed > 4 * BS_RING);
+}
+
+void ns_ble_stream_test_overflow_all_or_nothing() {
+    bs_reset(1);
+    ns_ble_stream_ccc(&stream, 1, true);
+    bsMtu[0] = 23;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(1000));
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(20, bs_drain_check());
+
+    // Sent bytes hold their space until they are confirmed
+    TEST_ASSERT_EQUAL(BS_RING - 1000, ns_ble_stream_space(&stream));
+    ns_ble_stream_cnf(&stream, 1, BS_ATT_SUCCESS);
+    TEST_ASSERT_EQUAL(20, bs_drain_check());
+    TEST_ASSERT_EQUAL(BS_RING - 980, ns_ble_stream_space(&stream));
+
+    // Doesn't fit: nothing is queued
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, bs_push(100));
+    TEST_ASSERT_EQUAL(1, stream.stats.overflows);
+    TEST_ASSERT_EQUAL(1000, stream.stats.pushed);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(BS_RING - 980));
+    TEST_ASSERT_EQUAL(0, ns_ble_stream_space(&stream));
+}
+
+void ns_ble_stream_test_no_subscribers() {
+    bs_reset(4);
+    // Without subscribers the producer never blocks and the BLE task is never woken
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(BS_RING));
+    }
+    TEST_ASSERT_EQUAL(0, bsKicks);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(0, bsNtfCount);
+
+    // A new subscriber starts at the current end of the stream
+    ns_ble_stream_ccc(&stream, 1, true);
+    bsExpect[0] = bsPattern;
+    bs_push(50);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(50, bs_drain_check());
+}
+
+void ns_ble_stream_test_alloc_failure_retry() {
+    bs_reset(4);
+    ns_ble_stream_ccc(&stream, 1, true);
+    bsAllocFail = true;
+    bs_push(100);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(0, bsNtfCount);
+    TEST_ASSERT_EQUAL(1, stream.stats.allocFailures);
+    TEST_ASSERT_EQUAL(BS_RING - 100, ns_ble_stream_space(&stream));
+
+    bsAllocFail = false;
+    bs_push(1);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL(101, bs_drain_check());
+}
+
+void ns_ble_stream_test_multi_connection() {
+#if NS_BLE_CONN_MAX > 1
+    bs_reset(2);
+    ns_ble_stream_ccc(&stream, 1, true);
+    ns_ble_stream_ccc(&stream, 2, true);
+    bsMtu[0] = 247;
+    bsMtu[1] = 23;
+    bs_push(600);
+    ns_ble_stream_service_all();
+
+    // Each connection is paced by its own MTU and credits
+    uint32_t bytes[2] = {0, 0};
+    for (uint32_t n = 0; n < bsNtfCount; n++) {
+        bytes[bsNtf[n].connId - 1] += bsNtf[n].len;
+    }
+    TEST_ASSERT_EQUAL(2 * 244, bytes[0]);
+    TEST_ASSERT_EQUAL(2 * 20, bytes[1]);
+    bs_drain_check();
+
+    // The slower connection bounds the producer, nothing is confirmed yet
+    TEST_ASSERT_EQUAL(BS_RING - 600, ns_ble_stream_space(&stream));
+    ns_ble_stream_cnf(&stream, 1, BS_ATT_SUCCESS);
+    TEST_ASSERT_EQUAL(BS_RING - 600, ns_ble_stream_space(&stream));
+    ns_ble_stream_cnf(&stream, 2, BS_ATT_SUCCESS);
+    TEST_ASSERT_EQUAL(BS_RING - 580, ns_ble_stream_space(&stream));
+    bs_drain_check();
+
+    while (stream.inFlight[0] || stream.inFlight[1]) {
+        bs_confirm_all(1);
+        bs_confirm_all(2);
+        bs_drain_check();
+    }
+    TEST_ASSERT_EQUAL((uint8_t)600, bsExpect[0]);
+    TEST_ASSERT_EQUAL((uint8_t)600, bsExpect[1]);
+    TEST_ASSERT_EQUAL(BS_RING, ns_ble_stream_space(&stream));
+#else
+    TEST_IGNORE_MESSAGE("Build with NS_BLE_CONN_MAX > 1");
+#endif
+}
+
+void ns_ble_stream_test_conn_close() {
+    bs_reset(1);
+    ns_ble_stream_ccc(&stream, 1, true);
+    bsMtu[0] = 23;
+    bs_push(BS_RING);
+    ns_ble_stream_service_all();
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, bs_push(100));
+
+    // A disconnected peer no longer holds back the producer
+    ns_ble_stream_conn_close(1);
+    TEST_ASSERT_EQUAL(0, stream.subscribed);
+    TEST_ASSERT_EQUAL(0, stream.inFlight[0]);
+    TEST_ASSERT_EQUAL(BS_RING, ns_ble_stream_space(&stream));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(100));
+}
+
+void ns_ble_stream_test_credits_capped() {
+    bs_att_reset(4, 1);
+    TEST_ASSERT_EQUAL(1, stream.credits);
+    bs_att_reset(0, 2);
+    TEST_ASSERT_EQUAL(2, stream.credits);
+    bs_reset(100);
+    TEST_ASSERT_EQUAL(NS_BLE_STREAM_MAX_CREDITS, stream.credits);
+}
+
+// Flow control toggles while a burst drains: with one notification in flight (Cordio's
+// default ATT_NUM_SIMUL_NTF) nothing is ever dropped
+void ns_ble_stream_test_att_flow_control_no_drops() {
+    uint32_t received = 0;
+
+    bs_att_reset(0, 1);
+    bsMtu[0] = 23;
+    ns_ble_stream_ccc(&stream, 1, true);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(1000));
+    for (int round = 0; received < 1000 && round < 1000; round++) {
+        bsAttFlowOff = (round % 3) != 0;
+        ns_ble_stream_service_all();
+        bs_att_deliver();
+        if (round % 3 == 2) {
+            bs_att_flow_on(0);
+        }
+        received += bs_drain_check();
+    }
+    TEST_ASSERT_EQUAL(1000, received);
+    TEST_ASSERT_EQUAL(0, stream.stats.dropped);
+    TEST_ASSERT_EQUAL(BS_RING, ns_ble_stream_space(&stream));
+}
+
+// With two notifications in flight a held one makes ATT drop the next on the same handle; its
+// bytes are resent, so the peer still gets every byte exactly once and in order
+void ns_ble_stream_test_att_overflow_resent() {
+    uint32_t received = 0;
+
+    bs_att_reset(4, 2);
+    TEST_ASSERT_EQUAL(2, stream.credits);
+    bsMtu[0] = 23;
+    ns_ble_stream_ccc(&stream, 1, true);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, bs_push(1000));
+    bsAttFlowOff = true;
+    for (int round = 0; received < 1000 && round < 1000; round++) {
+        ns_ble_stream_service_all();
+        bs_att_deliver();
+        // The link drains a few notifications and backs up again
+        bs_att_flow_on(1 + round % 4);
+        received += bs_drain_check();
+        // Bytes the peer hasn't got are never released to the producer
+        TEST_ASSERT_TRUE(BS_RING - ns_ble_stream_space(&stream) >= 1000 - received);
+    }
+    bs_att_flow_on(0);
+    received += bs_drain_check();
+    TEST_ASSERT_EQUAL(1000, received);
+    TEST_ASSERT_TRUE(stream.stats.dropped > 10);
+    TEST_ASSERT_TRUE(stream.stats.rewinds > 10);
+    TEST_ASSERT_EQUAL(0, stream.inFlight[0]);
+    TEST_ASSERT_EQUAL(BS_RING, ns_ble_stream_space(&stream));
+}
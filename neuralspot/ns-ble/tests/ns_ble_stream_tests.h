@@ -0,0 +1,16 @@
+#include "ns_ble_stream.h"
+void ns_ble_stream_tests_pre_test_hook();
+void ns_ble_stream_tests_post_test_hook();
+void ns_ble_stream_test_init_validation();
+void ns_ble_stream_test_fills_credits_with_full_notifications();
+void ns_ble_stream_test_partial_held_while_in_flight();
+void ns_ble_stream_test_credit_flow_control();
+void ns_ble_stream_test_wrap_integrity();
+void ns_ble_stream_test_overflow_all_or_nothing();
+void ns_ble_stream_test_no_subscribers();
+void ns_ble_stream_test_alloc_failure_retry();
+void ns_ble_stream_test_multi_connection();
+void ns_ble_stream_test_conn_close();
+void ns_ble_stream_test_credits_capped();
+void ns_ble_stream_test_att_flow_control_no_drops();
+void ns_ble_stream_test_att_overflow_resent();
@@ -57,6 +57,44 @@ typedef enum {
     NS_CAM_IMAGE_PIX_FMT_JPEG = 0x01,
 } ns_image_pix_fmt_e;
 
+/// Resolution the JPEG is decoded at before cropping and resizing into a tensor
+typedef enum {
+    NS_CAM_JPEG_SCALE_1_1 = 0, ///< Full resolution
+    NS_CAM_JPEG_SCALE_1_2 = 1, ///< 4x4 IDCT per 8x8 block
+    NS_CAM_JPEG_SCALE_1_4 = 2, ///< 2x2 IDCT per 8x8 block
+    NS_CAM_JPEG_SCALE_1_8 = 3, ///< DC coefficient only
+    NS_CAM_JPEG_SCALE_AUTO = 4 ///< Smallest scale that still covers the tensor resolution
+} ns_jpeg_scale_e;
+
+typedef enum {
+    NS_CAM_TENSOR_INT8 = 0,
+    NS_CAM_TENSOR_UINT8 = 1,
+} ns_camera_tensor_type_e;
+
+/// Describes the model input tensor a JPEG is decoded into
+typedef struct {
+    uint16_t width;               ///< Tensor width in pixels
+    uint16_t height;              ///< Tensor height in pixels
+    uint8_t channels;             ///< 3 for RGB, 1 for grayscale (luma)
+    ns_camera_tensor_type_e type; ///< Tensor element type
+    float scale;                  ///< Tensor quantization scale
+    int32_t zeroPoint;            ///< Tensor quantization zero point
+    float mean[3];                ///< Per-channel normalization: (pixel/255 - mean) / std
+    float std[3];                 ///< Per-channel normalization, must be > 0
+
+    // Region of the JPEG to use, in full resolution pixels. A cropWidth or
+    // cropHeight of 0 selects the whole image.
+    uint16_t cropX;
+    uint16_t cropY;
+    uint16_t cropWidth;
+    uint16_t cropHeight;
+    ns_jpeg_scale_e jpegScale;
+
+    // Internal state
+    uint8_t lut[3][256];          ///< Pixel value to quantized tensor value
+    ns_jpeg_scale_e decodedScale; ///< Scale used by the last decode
+} ns_camera_tensor_cfg_t;
+
 // Callback def
 struct ns_camera_cfg;
 typedef void (*ns_camera_dma_cb)(struct ns_camera_cfg *cfg);
@@ -178,6 +216,33 @@ int camera_decode_image(
     uint8_t *camBuf, uint32_t camLen, uint8_t *imgBuf, uint32_t imgWidth, uint32_t imgHeight,
     uint32_t scaleFactor);
 
+/**
+ * @brief Prepare a tensor config for ns_camera_decode_to_tensor
+ * Validates the config and precomputes the normalize + quantize lookup table.
+ *
+ * @param tcfg Tensor config
+ * @return uint32_t NS_STATUS_SUCCESS or NS_STATUS_INVALID_CONFIG
+ */
+uint32_t ns_camera_tensor_init(ns_camera_tensor_cfg_t *tcfg);
+
+/**
+ * @brief Decode a JPEG directly into a model input tensor
+ * The JPEG is decoded with a reduced size IDCT (per tcfg->jpegScale), MCUs that
+ * fall outside the crop region are entropy decoded but not transformed, and each
+ * decoded MCU is color converted, resized (nearest neighbor) and quantized straight
+ * into the HWC tensor - no intermediate RGB565 image is needed.
+ *
+ * @param tcfg Tensor config, initialized by ns_camera_tensor_init
+ * @param camBuf Buffer containing JPG image
+ * @param camLen Length of JPG image in bytes
+ * @param tensor Destination tensor, width * height * channels bytes
+ * @return uint32_t NS_STATUS_SUCCESS, NS_STATUS_INVALID_HANDLE if tcfg is NULL,
+ * NS_STATUS_INVALID_CONFIG if a buffer is missing or the crop doesn't fit the image, or
+ * NS_STATUS_FAILURE if the JPEG can't be decoded
+ */
+uint32_t ns_camera_decode_to_tensor(
+    ns_camera_tensor_cfg_t *tcfg, const uint8_t *camBuf, uint32_t camLen, void *tensor);
+
 /**
  * @brief Adjust camera settings
  *
@@ -17,9 +17,8 @@ unsigned char pjpeg_callback(
     jpeg_decoder_context_t *ctx = (jpeg_decoder_context_t *)pCallback_data;
 
     n = jpg_min(ctx->g_nInFileSize - ctx->g_nInFileOfs, buf_size);
-    for (int i = 0; i < n; i++) {
-        pBuf[i] = *ctx->jpg_data++;
-    }
+    memcpy(pBuf, ctx->jpg_data, n);
+    ctx->jpg_data += n;
 
     *pBytes_actually_read = (uint8_t)(n);
     ctx->g_nInFileOfs += n;
@@ -232,6 +231,49 @@ int jpeg_decoder_init(jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_
     return jpeg_decoder_decode_mcu(ctx);
 }
 
+int jpeg_decoder_init_scaled(
+    jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size, uint8_t scale) {
+    ctx->mcu_x = 0;
+    ctx->mcu_y = 0;
+    ctx->status = 0;
+    ctx->is_available = 0;
+    ctx->g_nInFileOfs = 0;
+    ctx->jpg_data = (uint8_t *)array;
+    ctx->g_nInFileSize = array_size;
+
+    ctx->status = pjpeg_decode_init_scaled(&ctx->imgInfo, pjpeg_callback, ctx, scale);
+
+    if (ctx->status) {
+        return 0;
+    }
+
+    ctx->is_available = 1;
+    return 1;
+}
+
+int jpeg_decoder_next_mcu(jpeg_decoder_context_t *ctx, int transform) {
+    if (ctx->is_available == 0 || ctx->mcu_y >= ctx->imgInfo.m_MCUSPerCol) {
+        jpeg_decoder_abort(ctx);
+        return 0;
+    }
+
+    ctx->status = transform ? pjpeg_decode_mcu() : pjpeg_skip_mcu();
+    if (ctx->status) {
+        ctx->is_available = 0;
+        return (ctx->status == PJPG_NO_MORE_BLOCKS) ? 0 : -1;
+    }
+
+    ctx->MCUx = ctx->mcu_x;
+    ctx->MCUy = ctx->mcu_y;
+
+    ctx->mcu_x++;
+    if (ctx->mcu_x == ctx->imgInfo.m_MCUSPerRow) {
+        ctx->mcu_x = 0;
+        ctx->mcu_y++;
+    }
+    return 1;
+}
+
 void jpeg_decoder_abort(jpeg_decoder_context_t *ctx) {
     ctx->mcu_x = 0;
     ctx->mcu_y = 0;
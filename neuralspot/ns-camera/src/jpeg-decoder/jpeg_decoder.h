@@ -42,6 +42,16 @@ unsigned char pjpeg_callback(
     void *pCallback_data);
 int jpeg_decoder_init(jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size);
 int jpeg_decoder_read(jpeg_decoder_context_t *ctx);
+
+// Start a decode at a reduced scale (PJPG_SCALE_*). Unlike jpeg_decoder_init(),
+// no MCU is decoded ahead; the caller steps through them with
+// jpeg_decoder_next_mcu() and reads pixels straight from ctx->imgInfo's MCU buffers.
+int jpeg_decoder_init_scaled(
+    jpeg_decoder_context_t *ctx, const uint8_t *array, uint32_t array_size, uint8_t scale);
+
+// Decode (transform != 0) or skip the next MCU, setting MCUx/MCUy to its position.
+// Returns 1 if an MCU was consumed, 0 at the end of the image, -1 on a decode error.
+int jpeg_decoder_next_mcu(jpeg_decoder_context_t *ctx, int transform);
 void jpeg_decoder_abort(jpeg_decoder_context_t *ctx);
 
 #ifdef __cplusplus
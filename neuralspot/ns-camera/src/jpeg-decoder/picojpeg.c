@@ -234,6 +234,7 @@ static pjpeg_need_bytes_callback_t g_pNeedBytesCallback;
 static void *g_pCallback_data;
 static uint8 gCallbackStatus;
 static uint8 gReduce;
+static uint8 gScaleShift; // 1 or 2 for 1/2 or 1/4 scaled IDCT, 0 otherwise
 //------------------------------------------------------------------------------
 static void fillInBuf(void) {
     unsigned char status;
@@ -607,7 +608,9 @@ static uint8 readDQTMarker(void) {
                 gQuant0[i] = (int16)temp;
         }
 
-        createWinogradQuant(n ? gQuant1 : gQuant0);
+        // The scaled IDCTs work on plain dequantized coefficients
+        if (!gScaleShift)
+            createWinogradQuant(n ? gQuant1 : gQuant0);
 
         totalRead = 64 + 1;
 
@@ -1973,7 +1976,157 @@ static void transformBlockReduce(uint8 mcuBlock) {
     }
 }
 //------------------------------------------------------------------------------
-static uint8 decodeNextMCU(void) {
+// Scaled IDCTs: an NxN (N = 4 or 2) inverse DCT of the top-left NxN coefficients
+// yields the block downsampled by 8/N, without computing the full 8x8 IDCT.
+// Output is NxN pixels at the top-left of a block (row pitch 8), so scaled
+// MCUs keep the block offsets described in picojpeg.h.
+
+#define PJPG_SCALED_FIX_BITS 12
+#define PJPG_SCALED_PASS1_BITS 3
+#define PJPG_C4 2896 // cos(pi/4) in Q12
+#define PJPG_C1 3784 // cos(pi/8) in Q12
+#define PJPG_C3 1567 // cos(3*pi/8) in Q12
+
+static uint8 gScaledBlock[4 * 4];
+
+static void idct4x4(void) {
+    long tmp[4 * 4];
+    long e0, e1, o0, o1;
+    uint8 i;
+
+    // Columns: Q12 products, keeping PJPG_SCALED_PASS1_BITS fractional bits
+    for (i = 0; i < 4; i++) {
+        const int16 *pSrc = gCoeffBuf + i;
+        e0 = ((long)pSrc[0] + pSrc[16]) * PJPG_C4;
+        e1 = ((long)pSrc[0] - pSrc[16]) * PJPG_C4;
+        o0 = (long)pSrc[8] * PJPG_C1 + (long)pSrc[24] * PJPG_C3;
+        o1 = (long)pSrc[8] * PJPG_C3 - (long)pSrc[24] * PJPG_C1;
+
+#define PJPG_PASS1(x)                                                                              \
+    (((x) + (1 << (PJPG_SCALED_FIX_BITS - PJPG_SCALED_PASS1_BITS - 1))) >>                         \
+     (PJPG_SCALED_FIX_BITS - PJPG_SCALED_PASS1_BITS))
+        tmp[0 * 4 + i] = PJPG_PASS1(e0 + o0);
+        tmp[1 * 4 + i] = PJPG_PASS1(e1 + o1);
+        tmp[2 * 4 + i] = PJPG_PASS1(e1 - o1);
+        tmp[3 * 4 + i] = PJPG_PASS1(e0 - o0);
+#undef PJPG_PASS1
+    }
+
+    // Rows, then remove both Q12 scales, the pass 1 bits and the 1/2 per dimension
+    for (i = 0; i < 4; i++) {
+        const long *pSrc = tmp + i * 4;
+        uint8 *pDst = gScaledBlock + i * 4;
+        e0 = (pSrc[0] + pSrc[2]) * PJPG_C4;
+        e1 = (pSrc[0] - pSrc[2]) * PJPG_C4;
+        o0 = pSrc[1] * PJPG_C1 + pSrc[3] * PJPG_C3;
+        o1 = pSrc[1] * PJPG_C3 - pSrc[3] * PJPG_C1;
+
+#define PJPG_PASS2_BITS (PJPG_SCALED_FIX_BITS + PJPG_SCALED_PASS1_BITS + 2)
+#define PJPG_PASS2(x) clamp((int16)(((x) + (1 << (PJPG_PASS2_BITS - 1))) >> PJPG_PASS2_BITS) + 128)
+        pDst[0] = PJPG_PASS2(e0 + o0);
+        pDst[1] = PJPG_PASS2(e1 + o1);
+        pDst[2] = PJPG_PASS2(e1 - o1);
+        pDst[3] = PJPG_PASS2(e0 - o0);
+#undef PJPG_PASS2
+#undef PJPG_PASS2_BITS
+    }
+}
+
+static void idct2x2(void) {
+    // cos(pi/4)^2 and the 1/2 per dimension fold into a single 1/8
+    long a = gCoeffBuf[0], b = gCoeffBuf[1], c = gCoeffBuf[8], d = gCoeffBuf[9];
+
+    gScaledBlock[0] = clamp((int16)((a + b + c + d + 4) >> 3) + 128);
+    gScaledBlock[1] = clamp((int16)((a - b + c - d + 4) >> 3) + 128);
+    gScaledBlock[2] = clamp((int16)((a + b - c - d + 4) >> 3) + 128);
+    gScaledBlock[3] = clamp((int16)((a - b - c + d + 4) >> 3) + 128);
+}
+
+static void copyYScaled(uint8 dstOfs) {
+    uint8 n = 8 >> gScaleShift;
+    uint8 x, y;
+    const uint8 *pSrc = gScaledBlock;
+
+    for (y = 0; y < n; y++) {
+        for (x = 0; x < n; x++) {
+            uint8 c = *pSrc++;
+            gMCUBufR[dstOfs + x] = c;
+            gMCUBufG[dstOfs + x] = c;
+            gMCUBufB[dstOfs + x] = c;
+        }
+        dstOfs += 8;
+    }
+}
+
+// Accumulate a chroma block into an MCU of hs*vs luma blocks (nearest upsampling)
+static void convertChromaScaled(uint8 isCr, uint8 hs, uint8 vs) {
+    uint8 n = 8 >> gScaleShift;
+    uint8 px, py;
+
+    for (py = 0; py < n * vs; py++) {
+        for (px = 0; px < n * hs; px++) {
+            uint8 c = gScaledBlock[(py / vs) * n + (px / hs)];
+            uint8 ofs = ((py >= n) ? 128 : 0) + ((px >= n) ? 64 : 0) + (py & (n - 1)) * 8 +
+                        (px & (n - 1));
+
+            if (isCr) {
+                int16 crR = (c + ((c * 103U) >> 8U)) - 179;
+                int16 crG = ((c * 183U) >> 8U) - 91;
+                gMCUBufR[ofs] = addAndClamp(gMCUBufR[ofs], crR);
+                gMCUBufG[ofs] = subAndClamp(gMCUBufG[ofs], crG);
+            } else {
+                int16 cbG = ((c * 88U) >> 8U) - 44U;
+                int16 cbB = (c + ((c * 198U) >> 8U)) - 227U;
+                gMCUBufG[ofs] = subAndClamp(gMCUBufG[ofs], cbG);
+                gMCUBufB[ofs] = addAndClamp(gMCUBufB[ofs], cbB);
+            }
+        }
+    }
+}
+
+static void transformBlockScaled(uint8 mcuBlock) {
+    if (gScaleShift == 1)
+        idct4x4();
+    else
+        idct2x2();
+
+    switch (gScanType) {
+    case PJPG_GRAYSCALE: {
+        copyYScaled(0);
+        break;
+    }
+    case PJPG_YH1V1: {
+        if (mcuBlock == 0)
+            copyYScaled(0);
+        else
+            convertChromaScaled(mcuBlock == 2, 1, 1);
+        break;
+    }
+    case PJPG_YH1V2: {
+        if (mcuBlock < 2)
+            copyYScaled(mcuBlock * 128);
+        else
+            convertChromaScaled(mcuBlock == 3, 1, 2);
+        break;
+    }
+    case PJPG_YH2V1: {
+        if (mcuBlock < 2)
+            copyYScaled(mcuBlock * 64);
+        else
+            convertChromaScaled(mcuBlock == 3, 2, 1);
+        break;
+    }
+    case PJPG_YH2V2: {
+        if (mcuBlock < 4)
+            copyYScaled(mcuBlock * 64);
+        else
+            convertChromaScaled(mcuBlock == 5, 2, 2);
+        break;
+    }
+    }
+}
+//------------------------------------------------------------------------------
+static uint8 decodeNextMCU(uint8 transform) {
     uint8 status;
     uint8 mcuBlock;
 
@@ -2010,26 +2163,48 @@ static uint8 decodeNextMCU(void) {
 
         compACTab = gCompACTab[componentID];
 
-        if (gReduce) {
-            // Decode, but throw out the AC coefficients in reduce mode.
+        if (gReduce || gScaleShift || !transform) {
+            // Decode, but throw out the AC coefficients in reduce mode. The
+            // scaled IDCTs keep only the top-left NxN, and skipped MCUs keep
+            // nothing beyond the DC predictor.
+            uint8 n = 8 >> gScaleShift;
+
+            if (gScaleShift) {
+                for (k = 0; k < n; k++) {
+                    gCoeffBuf[k * 8 + 0] = 0;
+                    gCoeffBuf[k * 8 + 1] = 0;
+                    gCoeffBuf[k * 8 + 2] = 0;
+                    gCoeffBuf[k * 8 + 3] = 0;
+                }
+                gCoeffBuf[0] = dc * pQ[0];
+            }
+
             for (k = 1; k < 64; k++) {
                 s = huffDecode(
                     compACTab ? &gHuffTab3 : &gHuffTab2, compACTab ? gHuffVal3 : gHuffVal2);
 
+                uint16 extraBits = 0;
+
                 numExtraBits = s & 0xF;
                 if (numExtraBits)
-                    getBits2(numExtraBits);
+                    extraBits = getBits2(numExtraBits);
 
                 r = s >> 4;
                 s &= 15;
 
                 if (s) {
+                    uint8 z;
+
                     if (r) {
                         if ((k + r) > 63)
                             return PJPG_DECODE_ERROR;
 
                         k = (uint8)(k + r);
                     }
+
+                    z = ZAG[k];
+                    if (gScaleShift && ((z & 7) < n) && ((z >> 3) < n))
+                        gCoeffBuf[z] = huffExtend(extraBits, s) * pQ[k];
                 } else {
                     if (r == 15) {
                         if ((k + 16) > 64)
@@ -2041,7 +2216,13 @@ static uint8 decodeNextMCU(void) {
                 }
             }
 
-            transformBlockReduce(mcuBlock);
+            if (!transform)
+                continue;
+
+            if (gReduce)
+                transformBlockReduce(mcuBlock);
+            else
+                transformBlockScaled(mcuBlock);
         } else {
             // Decode and dequantize AC coefficients
             for (k = 1; k < 64; k++) {
@@ -2107,7 +2288,30 @@ unsigned char pjpeg_decode_mcu(void) {
     if ((!gNumMCUSRemainingX) && (!gNumMCUSRemainingY))
         return PJPG_NO_MORE_BLOCKS;
 
-    status = decodeNextMCU();
+    status = decodeNextMCU(1);
+    if ((status) || (gCallbackStatus))
+        return gCallbackStatus ? gCallbackStatus : status;
+
+    gNumMCUSRemainingX--;
+    if (!gNumMCUSRemainingX) {
+        gNumMCUSRemainingY--;
+        if (gNumMCUSRemainingY > 0)
+            gNumMCUSRemainingX = gMaxMCUSPerRow;
+    }
+
+    return 0;
+}
+//------------------------------------------------------------------------------
+unsigned char pjpeg_skip_mcu(void) {
+    uint8 status;
+
+    if (gCallbackStatus)
+        return gCallbackStatus;
+
+    if ((!gNumMCUSRemainingX) && (!gNumMCUSRemainingY))
+        return PJPG_NO_MORE_BLOCKS;
+
+    status = decodeNextMCU(0);
     if ((status) || (gCallbackStatus))
         return gCallbackStatus ? gCallbackStatus : status;
 
@@ -2124,6 +2328,13 @@ unsigned char pjpeg_decode_mcu(void) {
 unsigned char pjpeg_decode_init(
     pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
     void *pCallback_data, unsigned char reduce) {
+    return pjpeg_decode_init_scaled(
+        pInfo, pNeed_bytes_callback, pCallback_data, reduce ? PJPG_SCALE_1_8 : PJPG_SCALE_1_1);
+}
+//------------------------------------------------------------------------------
+unsigned char pjpeg_decode_init_scaled(
+    pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
+    void *pCallback_data, unsigned char scale) {
     uint8 status;
 
     pInfo->m_width = 0;
@@ -2141,7 +2352,8 @@ unsigned char pjpeg_decode_init(
     g_pNeedBytesCallback = pNeed_bytes_callback;
     g_pCallback_data = pCallback_data;
     gCallbackStatus = 0;
-    gReduce = reduce;
+    gReduce = (scale >= PJPG_SCALE_1_8);
+    gScaleShift = gReduce ? 0 : scale;
 
     status = init();
     if ((status) || (gCallbackStatus))
@@ -2176,4 +2388,4 @@ unsigned char pjpeg_decode_init(
 
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -112,6 +112,14 @@ typedef unsigned char (*pjpeg_need_bytes_callback_t)(
     unsigned char *pBuf, unsigned char buf_size, unsigned char *pBytes_actually_read,
     void *pCallback_data);
 
+// Output scales for pjpeg_decode_init_scaled()
+enum {
+    PJPG_SCALE_1_1 = 0, // Full 8x8 IDCT
+    PJPG_SCALE_1_2,     // 4x4 IDCT of the low frequency coefficients
+    PJPG_SCALE_1_4,     // 2x2 IDCT of the low frequency coefficients
+    PJPG_SCALE_1_8,     // DC only, same as reduce = 1
+};
+
 // Initializes the decompressor. Returns 0 on success, or one of the above error
 // codes on failure. pNeed_bytes_callback will be called to fill the
 // decompressor's internal input buffer. If reduce is 1, only the first pixel of
@@ -122,12 +130,28 @@ unsigned char pjpeg_decode_init(
     pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
     void *pCallback_data, unsigned char reduce);
 
+// Same as pjpeg_decode_init(), but each 8x8 block is decoded to an NxN block
+// of pixels, N = 8 >> scale, by a reduced size IDCT. The NxN pixels of each
+// block are stored at the top-left of the block's usual location in
+// m_pMCUBufR/G/B (row pitch of 8 bytes), and chroma is upsampled within the
+// MCU by pixel replication. m_MCUWidth/m_MCUHeight stay in full resolution
+// pixels.
+unsigned char pjpeg_decode_init_scaled(
+    pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback,
+    void *pCallback_data, unsigned char scale);
+
 // Decompresses the file's next MCU. Returns 0 on success, PJPG_NO_MORE_BLOCKS
 // if no more blocks are available, or an error code. Must be called a total of
 // m_MCUSPerRow*m_MCUSPerCol times to completely decompress the image. Not
 // thread safe.
 unsigned char pjpeg_decode_mcu(void);
 
+// Entropy decodes the file's next MCU without dequantizing, transforming or
+// color converting it, leaving the MCU buffers untouched. Use it to step over
+// MCUs that aren't needed (a JPEG scan can't be randomly accessed). Returns
+// the same codes as pjpeg_decode_mcu().
+unsigned char pjpeg_skip_mcu(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,227 @@
+/**
+ * @file ns_camera_jpeg.c
+ * @author Ambiq
+ * @brief Decode camera JPEGs straight into model input tensors
+ * @version 0.1
+ * @date 2025-07-16
+ *
+ * picojpeg decodes one MCU at a time into small R/G/B block buffers. Rather than
+ * assembling a full RGB565 image and converting it to a tensor in a second pass,
+ * each MCU is sampled into the tensor as soon as it is decoded:
+ *  - the IDCT runs at 1/2, 1/4 or 1/8 scale, so most of the downscale is free
+ *  - MCUs that no tensor pixel samples from are entropy decoded only
+ *  - decoding stops after the last MCU row the crop needs
+ *  - color conversion, nearest neighbor resize, normalization and quantization
+ *    happen in one step through a per-channel lookup table
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_camera.h"
+#include "jpeg-decoder/jpeg_decoder.h"
+#include "jpeg-decoder/picojpeg.h"
+#include <math.h>
+
+static jpeg_decoder_context_t ns_camera_tensor_jpeg_ctx;
+
+// Source pixel (relative to the crop) sampled by tensor pixel i, pixel centers aligned
+#define NS_CAM_SAMPLE(i, step) ((((uint32_t)(i) * (step)) + ((step) >> 1)) >> 16)
+
+typedef struct {
+    const pjpeg_image_info_t *info;
+    uint8_t *out;
+    uint32_t n;     // decoded pixels per block edge
+    uint32_t roiX;  // crop origin, decoded pixels
+    uint32_t roiY;
+    uint32_t stepX; // crop pixels per tensor pixel, Q16
+    uint32_t stepY;
+} ns_camera_tensor_map_t;
+
+uint32_t ns_camera_tensor_init(ns_camera_tensor_cfg_t *tcfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (tcfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if ((tcfg->width == 0) || (tcfg->height == 0) ||
+        ((tcfg->channels != 1) && (tcfg->channels != 3)) || (tcfg->scale <= 0.0f) ||
+        (tcfg->type > NS_CAM_TENSOR_UINT8) || (tcfg->jpegScale > NS_CAM_JPEG_SCALE_AUTO)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    for (uint32_t c = 0; c < tcfg->channels; c++) {
+        if (tcfg->std[c] <= 0.0f) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    }
+#endif
+
+    int32_t qmin = (tcfg->type == NS_CAM_TENSOR_INT8) ? -128 : 0;
+    int32_t qmax = (tcfg->type == NS_CAM_TENSOR_INT8) ? 127 : 255;
+
+    for (uint32_t c = 0; c < tcfg->channels; c++) {
+        float inv = 1.0f / (tcfg->std[c] * tcfg->scale);
+        for (uint32_t p = 0; p < 256; p++) {
+            float v = ((float)p / 255.0f - tcfg->mean[c]) * inv;
+            int32_t q = (int32_t)lroundf(v) + tcfg->zeroPoint;
+            tcfg->lut[c][p] = (uint8_t)MAX(MIN(q, qmax), qmin);
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+// Largest IDCT reduction that leaves at least one decoded pixel per tensor pixel
+static ns_jpeg_scale_e
+ns_camera_pick_scale(ns_camera_tensor_cfg_t *tcfg, uint32_t w, uint32_t h) {
+    uint32_t s = NS_CAM_JPEG_SCALE_1_8;
+    while ((s > NS_CAM_JPEG_SCALE_1_1) &&
+           (((w >> s) < tcfg->width) || ((h >> s) < tcfg->height))) {
+        s--;
+    }
+    return (ns_jpeg_scale_e)s;
+}
+
+// Sample tensor pixels [oxLo,oxHi) x [oyLo,oyHi) from the MCU at (mcuX0, mcuY0)
+static void ns_camera_mcu_to_tensor(
+    ns_camera_tensor_cfg_t *tcfg, const ns_camera_tensor_map_t *m, uint32_t mcuX0, uint32_t mcuY0,
+    uint32_t oxLo, uint32_t oxHi, uint32_t oyLo, uint32_t oyHi) {
+    const uint8_t *pR = m->info->m_pMCUBufR;
+    const uint8_t *pG = m->info->m_pMCUBufG;
+    const uint8_t *pB = m->info->m_pMCUBufB;
+    uint32_t n = m->n;
+    bool gray = (m->info->m_scanType == PJPG_GRAYSCALE);
+
+    for (uint32_t oy = oyLo; oy < oyHi; oy++) {
+        uint32_t ly = m->roiY + NS_CAM_SAMPLE(oy, m->stepY) - mcuY0;
+        uint32_t rowOfs = ((ly >= n) ? 128 : 0) + (ly & (n - 1)) * 8;
+        uint8_t *pOut = m->out + (oy * tcfg->width + oxLo) * tcfg->channels;
+
+        for (uint32_t ox = oxLo; ox < oxHi; ox++) {
+            uint32_t lx = m->roiX + NS_CAM_SAMPLE(ox, m->stepX) - mcuX0;
+            uint32_t ofs = rowOfs + ((lx >= n) ? 64 : 0) + (lx & (n - 1));
+            uint8_t r = pR[ofs];
+
+            if (tcfg->channels == 1) {
+                if (!gray) {
+                    r = (uint8_t)((77 * r + 150 * pG[ofs] + 29 * pB[ofs] + 128) >> 8);
+                }
+                *pOut++ = tcfg->lut[0][r];
+            } else if (gray) {
+                *pOut++ = tcfg->lut[0][r];
+                *pOut++ = tcfg->lut[1][r];
+                *pOut++ = tcfg->lut[2][r];
+            } else {
+                *pOut++ = tcfg->lut[0][r];
+                *pOut++ = tcfg->lut[1][pG[ofs]];
+                *pOut++ = tcfg->lut[2][pB[ofs]];
+            }
+        }
+    }
+}
+
+uint32_t ns_camera_decode_to_tensor(
+    ns_camera_tensor_cfg_t *tcfg, const uint8_t *camBuf, uint32_t camLen, void *tensor) {
+    jpeg_decoder_context_t *ctx = &ns_camera_tensor_jpeg_ctx;
+    const pjpeg_image_info_t *info = &ctx->imgInfo;
+    ns_camera_tensor_map_t m;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if (tcfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((camBuf == NULL) || (camLen == 0) || (tensor == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    bool wholeImage = (tcfg->cropWidth == 0) || (tcfg->cropHeight == 0);
+    ns_jpeg_scale_e scale = tcfg->jpegScale;
+
+    if (scale == NS_CAM_JPEG_SCALE_AUTO) {
+        if (wholeImage) {
+            // The scale has to be fixed before decoding starts, so parse the headers once
+            // to learn the image size
+            if (!jpeg_decoder_init_scaled(ctx, camBuf, camLen, PJPG_SCALE_1_8)) {
+                return NS_STATUS_FAILURE;
+            }
+            scale = ns_camera_pick_scale(tcfg, info->m_width, info->m_height);
+        } else {
+            scale = ns_camera_pick_scale(tcfg, tcfg->cropWidth, tcfg->cropHeight);
+        }
+    }
+
+    if (!jpeg_decoder_init_scaled(ctx, camBuf, camLen, (uint8_t)scale)) {
+        return NS_STATUS_FAILURE;
+    }
+    tcfg->decodedScale = scale;
+
+    uint32_t cropX = 0, cropY = 0;
+    uint32_t cropW = info->m_width, cropH = info->m_height;
+    if (!wholeImage) {
+        cropX = tcfg->cropX;
+        cropY = tcfg->cropY;
+        cropW = tcfg->cropWidth;
+        cropH = tcfg->cropHeight;
+        if ((cropX + cropW > (uint32_t)info->m_width) ||
+            (cropY + cropH > (uint32_t)info->m_height)) {
+            jpeg_decoder_abort(ctx);
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    }
+
+    // Everything below is in decoded (scaled) pixels
+    uint32_t roiW = MAX(cropW >> scale, 1);
+    uint32_t roiH = MAX(cropH >> scale, 1);
+    uint32_t mcuW = info->m_MCUWidth >> scale;
+    uint32_t mcuH = info->m_MCUHeight >> scale;
+
+    m.info = info;
+    m.out = (uint8_t *)tensor;
+    m.n = 8 >> scale;
+    m.roiX = cropX >> scale;
+    m.roiY = cropY >> scale;
+    m.stepX = (roiW << 16) / tcfg->width;
+    m.stepY = (roiH << 16) / tcfg->height;
+
+    // Tensor rows/columns covered by the current MCU row/column. Both advance
+    // monotonically, so each MCU's range is found by walking forward.
+    uint32_t oyLo = 0, oyHi = 0, oxLo, oxHi = 0;
+
+    for (;;) {
+        uint32_t mx = ctx->mcu_x;
+        uint32_t my = ctx->mcu_y;
+
+        if (mx == 0) {
+            if (oyHi == tcfg->height) {
+                // Rest of the image is below the crop
+                jpeg_decoder_abort(ctx);
+                return NS_STATUS_SUCCESS;
+            }
+            oyLo = oyHi;
+            while (oyHi < tcfg->height &&
+                   m.roiY + NS_CAM_SAMPLE(oyHi, m.stepY) < (my + 1) * mcuH) {
+                oyHi++;
+            }
+            oxHi = 0;
+        }
+
+        oxLo = oxHi;
+        while (oxHi < tcfg->width && m.roiX + NS_CAM_SAMPLE(oxHi, m.stepX) < (mx + 1) * mcuW) {
+            oxHi++;
+        }
+
+        bool needed = (oyLo < oyHi) && (oxLo < oxHi);
+        int ret = jpeg_decoder_next_mcu(ctx, needed);
+        if (ret < 0) {
+            return NS_STATUS_FAILURE;
+        } else if (ret == 0) {
+            // Ran out of MCUs before filling the tensor
+            return (oyHi == tcfg->height) ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+        }
+
+        if (needed) {
+            ns_camera_mcu_to_tensor(tcfg, &m, mx * mcuW, my * mcuH, oxLo, oxHi, oyLo, oyHi);
+        }
+    }
+}
@@ -0,0 +1,524 @@
+#include "ns_camera_jpeg_tests.h"
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "unity/unity.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Sample JPEGs for the ns_camera_jpeg tests, produced by a baseline encoder from
+// the closed-form images described above each array.
+
+// Smooth RGB gradient, 4:2:0, 60x44 (partial MCUs): R = 40 + 3x, G = 30 + 4y, B = 200 - 2x - y
+#define GRADIENT_420_WIDTH 60
+#define GRADIENT_420_HEIGHT 44
+static const uint8_t gradient_420_jpg[1007] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x84, 0x00, 0x03, 0x02, 0x02, 0x03, 0x05, 0x08, 0x0a, 0x0c, 0x02,
+    0x02, 0x03, 0x04, 0x05, 0x0c, 0x0c, 0x0b, 0x03, 0x03, 0x03, 0x05, 0x08, 0x0b, 0x0e, 0x0b, 0x03,
+    0x03, 0x04, 0x06, 0x0a, 0x11, 0x10, 0x0c, 0x04, 0x04, 0x07, 0x0b, 0x0e, 0x16, 0x15, 0x0f, 0x05,
+    0x07, 0x0b, 0x0d, 0x10, 0x15, 0x17, 0x12, 0x0a, 0x0d, 0x10, 0x11, 0x15, 0x18, 0x18, 0x14, 0x0e,
+    0x12, 0x13, 0x14, 0x16, 0x14, 0x15, 0x14, 0x01, 0x03, 0x04, 0x05, 0x09, 0x14, 0x14, 0x14, 0x14,
+    0x04, 0x04, 0x05, 0x0d, 0x14, 0x14, 0x14, 0x14, 0x05, 0x05, 0x0b, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x09, 0x0d, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0xff, 0xc0, 0x00, 0x11, 0x08, 0x00, 0x2c, 0x00,
+    0x3c, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff, 0xc4, 0x00, 0x1f, 0x00,
+    0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5,
+    0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01,
+    0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61,
+    0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1,
+    0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27,
+    0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+    0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4,
+    0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+    0xf8, 0xf9, 0xfa, 0xff, 0xc4, 0x00, 0x1f, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x11, 0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03,
+    0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05,
+    0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42,
+    0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24,
+    0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57,
+    0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3,
+    0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca,
+    0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8,
+    0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03,
+    0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0xf9, 0x42, 0x1d, 0x2f, 0xfd, 0x9a, 0xbf,
+    0x0e, 0x97, 0xfe, 0xcd, 0x74, 0x30, 0xe9, 0x7f, 0xec, 0xd5, 0xe8, 0x74, 0xbf, 0xf6, 0x6b, 0xfa,
+    0x73, 0x1d, 0x8d, 0xfe, 0xf1, 0xe4, 0xe0, 0x31, 0x9f, 0xde, 0x39, 0xe8, 0x74, 0xbf, 0xf6, 0x6a,
+    0xf4, 0x3a, 0x5f, 0xfb, 0x35, 0xd1, 0x43, 0xa5, 0xff, 0x00, 0xb3, 0x57, 0xa1, 0xd2, 0xff, 0x00,
+    0xd9, 0xaf, 0xcf, 0xb1, 0xd8, 0xdf, 0xef, 0x1f, 0xa3, 0xe0, 0x31, 0x9f, 0xde, 0x39, 0xe8, 0x74,
+    0xbf, 0xf6, 0x6a, 0xf4, 0x3a, 0x5f, 0xfb, 0x35, 0xd0, 0xc3, 0xa5, 0xff, 0x00, 0xb3, 0x57, 0xa1,
+    0xd2, 0xff, 0x00, 0xd9, 0xaf, 0xcf, 0xf1, 0xd8, 0xdf, 0xef, 0x1f, 0xa3, 0xe0, 0x31, 0x9f, 0xde,
+    0x39, 0xe8, 0x74, 0xbf, 0xf6, 0x6a, 0xe2, 0xe9, 0x7f, 0xec, 0xd7, 0x49, 0x0e, 0x97, 0xfe, 0xcd,
+    0x5c, 0x5d, 0x2f, 0xfd, 0x9a, 0xf8, 0x1c, 0x5e, 0x37, 0xfb, 0xc7, 0xe8, 0x98, 0x3c, 0x67, 0xf7,
+    0x8e, 0x36, 0x1d, 0x2f, 0xfd, 0x9a, 0xbd, 0x0e, 0x97, 0xfe, 0xcd, 0x74, 0x30, 0xe9, 0x7f, 0xec,
+    0xd5, 0xf8, 0x74, 0xbf, 0xf6, 0x6b, 0xf7, 0x1c, 0x76, 0x37, 0xfb, 0xc7, 0xf9, 0xd3, 0x80, 0xc6,
+    0x7f, 0x78, 0xe7, 0x61, 0xd2, 0xff, 0x00, 0xd9, 0xab, 0xf0, 0xe9, 0x7f, 0xec, 0xd7, 0x43, 0x0e,
+    0x97, 0xfe, 0xcd, 0x5e, 0x87, 0x4b, 0xff, 0x00, 0x66, 0xbf, 0x3e, 0xc7, 0x63, 0x7f, 0xbc, 0x7e,
+    0x8f, 0x80, 0xc6, 0x7f, 0x78, 0xe7, 0xa1, 0xd2, 0xff, 0x00, 0xd9, 0xab, 0xd0, 0xe9, 0x7f, 0xec,
+    0xd7, 0x43, 0x0e, 0x97, 0xfe, 0xcd, 0x5f, 0x87, 0x4b, 0xff, 0x00, 0x66, 0xbf, 0x3f, 0xc7, 0x63,
+    0x7f, 0xbc, 0x7e, 0x8f, 0x80, 0xc6, 0x7f, 0x78, 0xe7, 0x61, 0xd2, 0xff, 0x00, 0xd9, 0xab, 0x8b,
+    0xa5, 0xff, 0x00, 0xb3, 0x5d, 0x24, 0x3a, 0x5f, 0xfb, 0x35, 0x71, 0x74, 0xbf, 0xf6, 0x6b, 0xe0,
+    0x71, 0x78, 0xdf, 0xef, 0x1f, 0xa2, 0x60, 0xf1, 0x9f, 0xde, 0x38, 0xd8, 0x74, 0xbf, 0xf6, 0x6a,
+    0xf4, 0x3a, 0x5f, 0xfb, 0x35, 0xb5, 0x0d, 0xba, 0x7f, 0x76, 0xaf, 0xc3, 0x6e, 0x9f, 0xdd, 0xaf,
+    0xdd, 0x31, 0xd8, 0xb7, 0xe6, 0x7f, 0x9d, 0x98, 0x0c, 0x53, 0xf3, 0x31, 0x61, 0xd2, 0xff, 0x00,
+    0xd9, 0xab, 0xd0, 0xe9, 0x7f, 0xec, 0xd6, 0xd4, 0x36, 0xe9, 0xfd, 0xda, 0xbd, 0x0d, 0xba, 0x7f,
+    0x76, 0xbf, 0x3f, 0xc7, 0x62, 0xdf, 0x99, 0xfa, 0x36, 0x03, 0x14, 0xfc, 0xcc, 0x58, 0x74, 0xbf,
+    0xf6, 0x6a, 0xf4, 0x3a, 0x5f, 0xfb, 0x35, 0xb5, 0x0d, 0xba, 0x7f, 0x76, 0xaf, 0xc3, 0x6e, 0x9f,
+    0xdd, 0xaf, 0xcf, 0xb1, 0xd8, 0xb7, 0xe6, 0x7e, 0x8f, 0x80, 0xc5, 0x3f, 0x33, 0x16, 0x1d, 0x2f,
+    0xfd, 0x9a, 0xb8, 0xba, 0x5f, 0xfb, 0x35, 0xb9, 0x0d, 0xba, 0x7f, 0x76, 0xae, 0x2d, 0xba, 0x7f,
+    0x76, 0xbe, 0x0b, 0x17, 0x8b, 0x7e, 0x67, 0xe8, 0xb8, 0x3c, 0x53, 0xf3, 0x3f, 0xff, 0xd9,
+};
+
+// Grayscale gradient, 32x32: Y = 16 + 3x + 4y
+#define GRADIENT_GRAY_WIDTH 32
+#define GRADIENT_GRAY_HEIGHT 32
+static const uint8_t gradient_gray_jpg[431] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x03, 0x02, 0x02, 0x03, 0x05, 0x08, 0x0a, 0x0c, 0x02,
+    0x02, 0x03, 0x04, 0x05, 0x0c, 0x0c, 0x0b, 0x03, 0x03, 0x03, 0x05, 0x08, 0x0b, 0x0e, 0x0b, 0x03,
+    0x03, 0x04, 0x06, 0x0a, 0x11, 0x10, 0x0c, 0x04, 0x04, 0x07, 0x0b, 0x0e, 0x16, 0x15, 0x0f, 0x05,
+    0x07, 0x0b, 0x0d, 0x10, 0x15, 0x17, 0x12, 0x0a, 0x0d, 0x10, 0x11, 0x15, 0x18, 0x18, 0x14, 0x0e,
+    0x12, 0x13, 0x14, 0x16, 0x14, 0x15, 0x14, 0xff, 0xc0, 0x00, 0x0b, 0x08, 0x00, 0x20, 0x00, 0x20,
+    0x01, 0x01, 0x11, 0x00, 0xff, 0xc4, 0x00, 0x1f, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02,
+    0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11,
+    0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91,
+    0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09,
+    0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57,
+    0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96,
+    0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4,
+    0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2,
+    0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8,
+    0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xda, 0x00, 0x08,
+    0x01, 0x01, 0x00, 0x00, 0x3f, 0x00, 0xf8, 0x5b, 0x44, 0xf0, 0xdf, 0x4f, 0xdd, 0xd7, 0xa0, 0x68,
+    0x9e, 0x1b, 0xe9, 0xfb, 0xba, 0xf4, 0x0d, 0x13, 0xc3, 0x7d, 0x3f, 0x77, 0x5e, 0x81, 0xa2, 0x78,
+    0x6f, 0xa7, 0xee, 0xeb, 0xc5, 0x34, 0x4f, 0x0d, 0xf4, 0xfd, 0xdd, 0x7a, 0x06, 0x89, 0xe1, 0xbe,
+    0x9f, 0xbb, 0xaf, 0x40, 0xd1, 0x3c, 0x37, 0xd3, 0xf7, 0x75, 0xe8, 0x1a, 0x27, 0x86, 0xfa, 0x7e,
+    0xee, 0xbc, 0x53, 0x44, 0xf0, 0xdf, 0x4f, 0xdd, 0xd7, 0xa0, 0x68, 0x9e, 0x1b, 0xe9, 0xfb, 0xba,
+    0xf4, 0x0d, 0x13, 0xc3, 0x7d, 0x3f, 0x77, 0x5e, 0x81, 0xa2, 0x78, 0x6f, 0xa7, 0xee, 0xeb, 0xc5,
+    0x74, 0x4f, 0x0d, 0xf4, 0xfd, 0xdd, 0x7a, 0x06, 0x89, 0xe1, 0xbe, 0x9f, 0xbb, 0xaf, 0x40, 0xd1,
+    0x3c, 0x37, 0xd3, 0xf7, 0x75, 0xe8, 0x1a, 0x27, 0x86, 0xfa, 0x7e, 0xee, 0xbf, 0xff, 0xd9,
+};
+
+// 16x16 tiles of flat color, 4:4:4, 48x32
+#define TILES_444_WIDTH 48
+#define TILES_444_HEIGHT 32
+static const uint8_t tiles_444_jpg[712] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x84, 0x00, 0x02, 0x01, 0x01, 0x02, 0x02, 0x04, 0x05, 0x06, 0x01,
+    0x01, 0x01, 0x02, 0x03, 0x06, 0x06, 0x06, 0x01, 0x01, 0x02, 0x02, 0x04, 0x06, 0x07, 0x06, 0x01,
+    0x02, 0x02, 0x03, 0x05, 0x09, 0x08, 0x06, 0x02, 0x02, 0x04, 0x06, 0x07, 0x0b, 0x0a, 0x08, 0x02,
+    0x04, 0x06, 0x06, 0x08, 0x0a, 0x0b, 0x09, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0c, 0x0a, 0x07,
+    0x09, 0x0a, 0x0a, 0x0b, 0x0a, 0x0a, 0x0a, 0x01, 0x02, 0x02, 0x02, 0x05, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x02, 0x02, 0x03, 0x07, 0x0a, 0x0a, 0x0a, 0x0a, 0x02, 0x03, 0x06, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x05, 0x07, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0xff, 0xc0, 0x00, 0x11, 0x08, 0x00, 0x20, 0x00,
+    0x30, 0x03, 0x01, 0x11, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff, 0xc4, 0x00, 0x1f, 0x00,
+    0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5,
+    0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01,
+    0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61,
+    0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1,
+    0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27,
+    0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+    0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4,
+    0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+    0xf8, 0xf9, 0xfa, 0xff, 0xc4, 0x00, 0x1f, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x11, 0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03,
+    0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05,
+    0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42,
+    0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24,
+    0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57,
+    0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3,
+    0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca,
+    0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8,
+    0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03,
+    0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0xf9, 0x6a, 0xbf, 0x9f, 0xcf, 0xf5, 0xf0,
+    0x28, 0x03, 0xeb, 0x1a, 0xfc, 0xc8, 0xff, 0x00, 0x96, 0x30, 0xa0, 0x0f, 0xcf, 0x8a, 0xff, 0x00,
+    0xa1, 0x43, 0xfb, 0x60, 0x28, 0x03, 0xd5, 0xab, 0xfc, 0x38, 0x3f, 0xdc, 0x40, 0xa0, 0x0f, 0xac,
+    0x6b, 0xf3, 0x23, 0xfe, 0x58, 0xc2, 0x80, 0x3f, 0x3e, 0x2b, 0xfe, 0x85, 0x0f, 0xed, 0x80, 0xa0,
+    0x0f, 0xe8, 0x96, 0xbf, 0xe5, 0x24, 0xfe, 0x97, 0x0a, 0x00, 0xfc, 0xac, 0xaf, 0xfa, 0x29, 0x3f,
+    0xa6, 0xc2, 0x80, 0x3a, 0x9a, 0xfe, 0x45, 0x3f, 0x85, 0x42, 0x80, 0x3f, 0x4a, 0xab, 0xfc, 0x90,
+    0x3f, 0x4f, 0x0a, 0x00, 0xfc, 0xac, 0xaf, 0xfa, 0x29, 0x3f, 0xa6, 0xc2, 0x80, 0x3a, 0x9a, 0xfe,
+    0x45, 0x3f, 0x85, 0x42, 0x80, 0x3f, 0xff, 0xd9,
+};
+
+#define NS_CAMERA_JPEG_BENCH_REPS 20
+
+static uint8_t tensor[GRADIENT_420_WIDTH * GRADIENT_420_HEIGHT * 3];
+static uint8_t reference[GRADIENT_420_WIDTH * GRADIENT_420_HEIGHT * 3];
+static ns_camera_tensor_cfg_t tcfg;
+
+static const uint8_t tile_palette[6][3] = {{220, 30, 30},  {30, 200, 40},  {40, 50, 210},
+                                           {230, 220, 40}, {200, 60, 200}, {128, 128, 128}};
+
+static ns_timer_config_t bench_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+// Closed-form pixels of the encoded test images (see the comments above the arrays)
+static int gradient_420_pixel(int x, int y, int c) {
+    return (c == 0) ? 40 + 3 * x : (c == 1) ? 30 + 4 * y : 200 - 2 * x - y;
+}
+
+static int gradient_gray_pixel(int x, int y, int c) { return 16 + 3 * x + 4 * y; }
+
+static int tiles_444_pixel(int x, int y, int c) { return tile_palette[(y / 16) * 3 + x / 16][c]; }
+
+// uint8 tensor holding the decoded pixel values
+static void initialize_tensor_config(uint16_t width, uint16_t height, ns_jpeg_scale_e scale) {
+    memset(&tcfg, 0, sizeof(tcfg));
+    tcfg.width = width;
+    tcfg.height = height;
+    tcfg.channels = 3;
+    tcfg.type = NS_CAM_TENSOR_UINT8;
+    tcfg.scale = 1.0f / 255.0f;
+    tcfg.zeroPoint = 0;
+    for (int c = 0; c < 3; c++) {
+        tcfg.mean[c] = 0.0f;
+        tcfg.std[c] = 1.0f;
+    }
+    tcfg.jpegScale = scale;
+}
+
+// Largest difference between the tensor and the k x k box average of the source
+static int max_box_error(int (*pixel)(int, int, int), int k, int x0, int y0) {
+    int worst = 0;
+    for (int y = 0; y < tcfg.height; y++) {
+        for (int x = 0; x < tcfg.width; x++) {
+            for (int c = 0; c < tcfg.channels; c++) {
+                int sum = 0;
+                for (int j = 0; j < k; j++) {
+                    for (int i = 0; i < k; i++) {
+                        sum += pixel(x0 + x * k + i, y0 + y * k + j, c);
+                    }
+                }
+                int expected = (sum + k * k / 2) / (k * k);
+                int err = abs(expected - tensor[(y * tcfg.width + x) * tcfg.channels + c]);
+                worst = MAX(worst, err);
+            }
+        }
+    }
+    return worst;
+}
+
+void ns_camera_jpeg_tests_pre_test_hook() {
+    initialize_tensor_config(GRADIENT_420_WIDTH, GRADIENT_420_HEIGHT, NS_CAM_JPEG_SCALE_1_1);
+}
+
+void ns_camera_jpeg_tests_post_test_hook() {}
+
+void ns_camera_jpeg_invalid_config_test() {
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_camera_tensor_init(NULL));
+
+    initialize_tensor_config(0, 10, NS_CAM_JPEG_SCALE_1_1);
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_camera_tensor_init(&tcfg));
+
+    initialize_tensor_config(10, 10, NS_CAM_JPEG_SCALE_1_1);
+    tcfg.channels = 2;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_camera_tensor_init(&tcfg));
+
+    initialize_tensor_config(10, 10, NS_CAM_JPEG_SCALE_1_1);
+    tcfg.std[2] = 0.0f;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_camera_tensor_init(&tcfg));
+
+    initialize_tensor_config(10, 10, NS_CAM_JPEG_SCALE_1_1);
+    tcfg.scale = 0.0f;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_camera_tensor_init(&tcfg));
+
+    // Crop must fit in the image
+    initialize_tensor_config(8, 8, NS_CAM_JPEG_SCALE_1_1);
+    tcfg.cropX = 40;
+    tcfg.cropWidth = 16;
+    tcfg.cropHeight = 16;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_camera_tensor_init(&tcfg));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), tensor));
+
+    initialize_tensor_config(8, 8, NS_CAM_JPEG_SCALE_1_1);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_camera_tensor_init(&tcfg));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_HANDLE,
+        ns_camera_decode_to_tensor(NULL, tiles_444_jpg, sizeof(tiles_444_jpg), tensor));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_camera_decode_to_tensor(&tcfg, NULL, sizeof(tiles_444_jpg), tensor));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG, ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, 0, tensor));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), NULL));
+}
+
+void ns_camera_jpeg_full_scale_test() {
+    initialize_tensor_config(GRADIENT_420_WIDTH, GRADIENT_420_HEIGHT, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor));
+    TEST_ASSERT_INT_WITHIN(12, 0, max_box_error(gradient_420_pixel, 1, 0, 0));
+
+    initialize_tensor_config(TILES_444_WIDTH, TILES_444_HEIGHT, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), tensor));
+    TEST_ASSERT_INT_WITHIN(3, 0, max_box_error(tiles_444_pixel, 1, 0, 0));
+}
+
+// A 1/2^s IDCT should match averaging 2^s x 2^s blocks of the full image
+void ns_camera_jpeg_scaled_idct_test() {
+    for (int s = NS_CAM_JPEG_SCALE_1_2; s <= NS_CAM_JPEG_SCALE_1_8; s++) {
+        initialize_tensor_config(TILES_444_WIDTH >> s, TILES_444_HEIGHT >> s, s);
+        ns_camera_tensor_init(&tcfg);
+        TEST_ASSERT_EQUAL(
+            NS_STATUS_SUCCESS,
+            ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), tensor));
+        TEST_ASSERT_INT_WITHIN(3, 0, max_box_error(tiles_444_pixel, 1 << s, 0, 0));
+    }
+
+    // Against the full resolution decode of the same (4:2:0, partial MCU) image, so
+    // only the reduced IDCT is being measured. Chroma is reduced along with luma, so
+    // it ends up one step coarser than in the averaged full decode, which shows on
+    // this image's steep color ramps.
+    const int tolerance[] = {0, 12, 20};
+    initialize_tensor_config(GRADIENT_420_WIDTH, GRADIENT_420_HEIGHT, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), reference);
+
+    for (int s = NS_CAM_JPEG_SCALE_1_2; s <= NS_CAM_JPEG_SCALE_1_4; s++) {
+        int k = 1 << s;
+        int worst = 0;
+        initialize_tensor_config(GRADIENT_420_WIDTH >> s, GRADIENT_420_HEIGHT >> s, s);
+        ns_camera_tensor_init(&tcfg);
+        TEST_ASSERT_EQUAL(
+            NS_STATUS_SUCCESS,
+            ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor));
+        TEST_ASSERT_EQUAL(s, tcfg.decodedScale);
+
+        for (int y = 0; y < tcfg.height; y++) {
+            for (int x = 0; x < tcfg.width; x++) {
+                for (int c = 0; c < 3; c++) {
+                    int sum = 0;
+                    for (int j = 0; j < k; j++) {
+                        const uint8_t *row = &reference[(y * k + j) * GRADIENT_420_WIDTH * 3];
+                        for (int i = 0; i < k; i++) {
+                            sum += row[(x * k + i) * 3 + c];
+                        }
+                    }
+                    int expected = (sum + k * k / 2) / (k * k);
+                    int err = abs(expected - tensor[(y * tcfg.width + x) * 3 + c]);
+                    worst = MAX(worst, err);
+                }
+            }
+        }
+        TEST_ASSERT_INT_WITHIN(tolerance[s], 0, worst);
+    }
+}
+
+void ns_camera_jpeg_grayscale_test() {
+    for (int s = NS_CAM_JPEG_SCALE_1_1; s <= NS_CAM_JPEG_SCALE_1_8; s++) {
+        initialize_tensor_config(GRADIENT_GRAY_WIDTH >> s, GRADIENT_GRAY_HEIGHT >> s, s);
+        ns_camera_tensor_init(&tcfg);
+        TEST_ASSERT_EQUAL(
+            NS_STATUS_SUCCESS,
+            ns_camera_decode_to_tensor(
+                &tcfg, gradient_gray_jpg, sizeof(gradient_gray_jpg), tensor));
+        TEST_ASSERT_INT_WITHIN(3, 0, max_box_error(gradient_gray_pixel, 1 << s, 0, 0));
+    }
+}
+
+void ns_camera_jpeg_auto_scale_test() {
+    // 60x44 -> 15x11 is exactly 1/4
+    initialize_tensor_config(15, 11, NS_CAM_JPEG_SCALE_AUTO);
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor));
+    TEST_ASSERT_EQUAL(NS_CAM_JPEG_SCALE_1_4, tcfg.decodedScale);
+
+    // One more column than 1/4 provides
+    initialize_tensor_config(16, 11, NS_CAM_JPEG_SCALE_AUTO);
+    ns_camera_tensor_init(&tcfg);
+    ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor);
+    TEST_ASSERT_EQUAL(NS_CAM_JPEG_SCALE_1_2, tcfg.decodedScale);
+
+    // The crop, not the image, decides
+    initialize_tensor_config(8, 8, NS_CAM_JPEG_SCALE_AUTO);
+    tcfg.cropWidth = 32;
+    tcfg.cropHeight = 32;
+    ns_camera_tensor_init(&tcfg);
+    ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor);
+    TEST_ASSERT_EQUAL(NS_CAM_JPEG_SCALE_1_4, tcfg.decodedScale);
+    TEST_ASSERT_INT_WITHIN(20, 0, max_box_error(gradient_420_pixel, 4, 0, 0));
+}
+
+void ns_camera_jpeg_crop_test() {
+    // One tile at full and half scale
+    for (int s = NS_CAM_JPEG_SCALE_1_1; s <= NS_CAM_JPEG_SCALE_1_2; s++) {
+        initialize_tensor_config(16 >> s, 16 >> s, s);
+        tcfg.cropX = 16;
+        tcfg.cropY = 16;
+        tcfg.cropWidth = 16;
+        tcfg.cropHeight = 16;
+        ns_camera_tensor_init(&tcfg);
+        TEST_ASSERT_EQUAL(
+            NS_STATUS_SUCCESS,
+            ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), tensor));
+        TEST_ASSERT_INT_WITHIN(3, 0, max_box_error(tiles_444_pixel, 1 << s, 16, 16));
+    }
+
+    // Straddling tiles, not MCU aligned
+    initialize_tensor_config(28, 20, NS_CAM_JPEG_SCALE_1_1);
+    tcfg.cropX = 5;
+    tcfg.cropY = 3;
+    tcfg.cropWidth = 28;
+    tcfg.cropHeight = 20;
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor));
+    TEST_ASSERT_INT_WITHIN(12, 0, max_box_error(gradient_420_pixel, 1, 5, 3));
+}
+
+// Non-integer resize samples the source pixel under each tensor pixel's center
+void ns_camera_jpeg_resize_test() {
+    int worst = 0;
+    initialize_tensor_config(25, 13, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor));
+
+    for (int y = 0; y < tcfg.height; y++) {
+        int sy = (y * 2 + 1) * GRADIENT_420_HEIGHT / (2 * tcfg.height);
+        for (int x = 0; x < tcfg.width; x++) {
+            int sx = (x * 2 + 1) * GRADIENT_420_WIDTH / (2 * tcfg.width);
+            for (int c = 0; c < 3; c++) {
+                int err = abs(gradient_420_pixel(sx, sy, c) - tensor[(y * tcfg.width + x) * 3 + c]);
+                worst = MAX(worst, err);
+            }
+        }
+    }
+    TEST_ASSERT_INT_WITHIN(12, 0, worst);
+}
+
+void ns_camera_jpeg_quantize_test() {
+    int8_t *t8 = (int8_t *)tensor;
+
+    initialize_tensor_config(TILES_444_WIDTH, TILES_444_HEIGHT, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), reference);
+
+    // int8 with zero point -128 is the uint8 tensor shifted
+    tcfg.type = NS_CAM_TENSOR_INT8;
+    tcfg.zeroPoint = -128;
+    ns_camera_tensor_init(&tcfg);
+    ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), tensor);
+    for (int i = 0; i < TILES_444_WIDTH * TILES_444_HEIGHT * 3; i++) {
+        TEST_ASSERT_EQUAL_INT8(reference[i] - 128, t8[i]);
+    }
+
+    // Mean/std normalization, then saturation
+    tcfg.mean[0] = 0.5f;
+    tcfg.std[0] = 0.25f;
+    tcfg.scale = 1.0f / 32.0f;
+    tcfg.zeroPoint = 0;
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL_INT8(-64, (int8_t)tcfg.lut[0][0]);
+    TEST_ASSERT_EQUAL_INT8(0, (int8_t)tcfg.lut[0][128]);
+    TEST_ASSERT_EQUAL_INT8(64, (int8_t)tcfg.lut[0][255]);
+    tcfg.scale = 1.0f / 128.0f;
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL_INT8(-128, (int8_t)tcfg.lut[0][0]);
+    TEST_ASSERT_EQUAL_INT8(127, (int8_t)tcfg.lut[0][255]);
+}
+
+void ns_camera_jpeg_luma_test() {
+    initialize_tensor_config(TILES_444_WIDTH / 2, TILES_444_HEIGHT / 2, NS_CAM_JPEG_SCALE_1_2);
+    tcfg.channels = 1;
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_camera_decode_to_tensor(&tcfg, tiles_444_jpg, sizeof(tiles_444_jpg), tensor));
+
+    for (int y = 0; y < tcfg.height; y++) {
+        for (int x = 0; x < tcfg.width; x++) {
+            const uint8_t *p = tile_palette[(y / 8) * 3 + x / 8];
+            int luma = (77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8;
+            TEST_ASSERT_INT_WITHIN(4, luma, tensor[y * tcfg.width + x]);
+        }
+    }
+}
+
+void ns_camera_jpeg_bad_jpeg_test() {
+    static const uint8_t not_a_jpeg[64] = {0x89, 'P', 'N', 'G'};
+
+    initialize_tensor_config(8, 8, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    TEST_ASSERT_EQUAL(
+        (uint32_t)NS_STATUS_FAILURE,
+        ns_camera_decode_to_tensor(&tcfg, not_a_jpeg, sizeof(not_a_jpeg), tensor));
+
+    tcfg.jpegScale = NS_CAM_JPEG_SCALE_AUTO;
+    TEST_ASSERT_EQUAL(
+        (uint32_t)NS_STATUS_FAILURE,
+        ns_camera_decode_to_tensor(&tcfg, not_a_jpeg, sizeof(not_a_jpeg), tensor));
+}
+
+void ns_camera_jpeg_benchmark_test() {
+    uint32_t t0, t_full, t_auto, t_crop;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_init(&bench_timer));
+
+    initialize_tensor_config(15, 11, NS_CAM_JPEG_SCALE_1_1);
+    ns_camera_tensor_init(&tcfg);
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_CAMERA_JPEG_BENCH_REPS; r++) {
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor);
+    }
+    t_full = ns_us_ticker_read(&bench_timer) - t0;
+
+    tcfg.jpegScale = NS_CAM_JPEG_SCALE_AUTO;
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_CAMERA_JPEG_BENCH_REPS; r++) {
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor);
+    }
+    t_auto = ns_us_ticker_read(&bench_timer) - t0;
+
+    // Top-left quarter: MCUs right of the crop are skipped, rows below aren't decoded
+    tcfg.jpegScale = NS_CAM_JPEG_SCALE_1_1;
+    tcfg.cropWidth = 30;
+    tcfg.cropHeight = 22;
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_CAMERA_JPEG_BENCH_REPS; r++) {
+        ns_camera_decode_to_tensor(&tcfg, gradient_420_jpg, sizeof(gradient_420_jpg), tensor);
+    }
+    t_crop = ns_us_ticker_read(&bench_timer) - t0;
+
+    ns_lp_printf(
+        "60x44 JPEG to 15x11 tensor: full IDCT %d us, 1/4 IDCT %d us, 1/4 crop %d us (%d reps)\n",
+        t_full, t_auto, t_crop, NS_CAMERA_JPEG_BENCH_REPS);
+    TEST_ASSERT_TRUE(t_auto < t_full);
+}
@@ -0,0 +1,14 @@
+#include "ns_camera.h"
+void ns_camera_jpeg_tests_pre_test_hook();
+void ns_camera_jpeg_tests_post_test_hook();
+void ns_camera_jpeg_invalid_config_test();
+void ns_camera_jpeg_full_scale_test();
+void ns_camera_jpeg_scaled_idct_test();
+void ns_camera_jpeg_grayscale_test();
+void ns_camera_jpeg_auto_scale_test();
+void ns_camera_jpeg_crop_test();
+void ns_camera_jpeg_resize_test();
+void ns_camera_jpeg_quantize_test();
+void ns_camera_jpeg_luma_test();
+void ns_camera_jpeg_bad_jpeg_test();
+void ns_camera_jpeg_benchmark_test();
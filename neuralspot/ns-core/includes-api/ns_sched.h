@@ -0,0 +1,266 @@
+/**
+ * @file ns_sched.h
+ * @author Ambiq
+ * @brief Event-driven, run-to-completion cooperative scheduler
+ * @version 0.1
+ * @date 2025-08-18
+ *
+ * Replaces the while(1) loop polling volatile flags. Interrupt handlers (or tasks) post events
+ * to tasks; the main loop calls ns_sched_run(), which dispatches them one at a time, highest
+ * priority first and in posting order within a priority, and sleeps when there is nothing
+ * to do. Handlers are never preempted by other handlers, so task state needs no locking.
+ *
+ * Each priority has a bounded multi-producer, single-consumer ring. Posting claims a slot
+ * with a compare-and-swap and publishes it with a per-slot sequence number, so it never
+ * masks interrupts and is safe from any interrupt priority, including one that preempts
+ * another post. A full ring drops the event and counts it.
+ *
+ * Deferred work items (ns_sched_work_t) are tasks that carry a function: an ISR calls
+ * ns_sched_defer() to move processing to the main loop. Deferring a work item that is
+ * already pending is coalesced rather than queued twice.
+ *
+ * The scheduler times every handler through the port, accumulating per-task CPU time,
+ * longest run and post-to-dispatch latency, plus idle time for the whole scheduler.
+ *
+ * The scheduler reaches the platform through ns_sched_port_t. ns_sched_hw_port
+ * (ns_peripherals_sched.h, in ns-peripherals) sleeps with ns_deep_sleep() and times with the
+ * NS_TIMER_COUNTER timer; ns_sched_host.h runs the same scheduler on pthreads with virtual
+ * interrupts for tests and measurements.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-sched
+ * @{
+ * @ingroup ns-core
+ *
+ */
+
+#ifndef NS_SCHED_H
+    #define NS_SCHED_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_SCHED_V0_0_1                                                                        \
+        { .major = 0, .minor = 0, .revision = 1 }
+
+    #define NS_SCHED_OLDEST_SUPPORTED_VERSION NS_SCHED_V0_0_1
+    #define NS_SCHED_CURRENT_VERSION NS_SCHED_V0_0_1
+    #define NS_SCHED_API_ID 0xCA0016
+
+    /// Priority levels, 0 is the highest
+    #ifndef NS_SCHED_PRIORITIES
+        #define NS_SCHED_PRIORITIES 4
+    #endif
+
+    /// Pending events per priority level, a power of 2
+    #ifndef NS_SCHED_QUEUE_DEPTH
+        #define NS_SCHED_QUEUE_DEPTH 16
+    #endif
+
+    #if (NS_SCHED_QUEUE_DEPTH & (NS_SCHED_QUEUE_DEPTH - 1)) != 0
+        #error "NS_SCHED_QUEUE_DEPTH must be a power of 2"
+    #endif
+
+extern const ns_core_api_t ns_sched_V0_0_1;
+extern const ns_core_api_t ns_sched_oldest_supported_version;
+extern const ns_core_api_t ns_sched_current_version;
+
+struct ns_sched;
+struct ns_sched_task;
+
+/**
+ * @brief Task handler, runs to completion in the context of ns_sched_run()
+ *
+ * @param task the task the event was posted to
+ * @param event value given to ns_sched_post()
+ * @param data pointer given to ns_sched_post()
+ */
+typedef void (*ns_sched_handler_t)(struct ns_sched_task *task, uint32_t event, void *data);
+
+/**
+ * @brief Platform access used by the scheduler
+ *
+ * idle() is called with lock() held once the queues are found empty. It must return after
+ * an event is posted and must not lose a post that happens between lock() and idle(); on
+ * Cortex-M this holds for WFI with interrupts masked, on a host it is a condition wait.
+ */
+typedef struct ns_sched_port {
+    uint32_t (*init)(void *ctx);               ///< Optional, called by ns_sched_init()
+    uint32_t (*now_us)(void *ctx);             ///< Free running, wrapping microsecond clock
+    void (*idle)(void *ctx);                   ///< Sleep until woken, see above
+    void (*wake)(void *ctx);                   ///< Optional, called after every post
+    uint32_t (*lock)(void *ctx);               ///< Mask the wakeup sources
+    void (*unlock)(void *ctx, uint32_t state); ///< Undo lock()
+    void *ctx;                                 ///< Passed to every port function
+} ns_sched_port_t;
+
+/// Per-task statistics, all times in microseconds
+typedef struct {
+    uint32_t runs;         ///< Events dispatched to the task
+    uint32_t dropped;      ///< Posts lost to a full queue
+    uint32_t coalesced;    ///< Work deferrals merged with one already pending
+    uint32_t runMaxUs;     ///< Longest single handler run
+    uint64_t cpuUs;        ///< Total handler time
+    uint32_t latencyMaxUs; ///< Worst post-to-dispatch delay
+    uint64_t latencySumUs; ///< For the average, latencySumUs / runs
+} ns_sched_task_stats_t;
+
+/// A task. Owned by the caller, must stay valid once added.
+typedef struct ns_sched_task {
+    ns_sched_handler_t handler; ///< Called for every event posted to the task
+    void *arg;                  ///< For the handler's use
+    const char *name;           ///< Optional, for ns_sched_print_stats()
+    uint8_t priority;           ///< 0 (highest) to NS_SCHED_PRIORITIES - 1
+    ns_sched_task_stats_t stats;
+
+    // Internal state
+    struct ns_sched *sched;
+    struct ns_sched_task *next;
+} ns_sched_task_t;
+
+/// A deferred work item, see ns_sched_work_init() and ns_sched_defer()
+typedef struct {
+    ns_sched_task_t task;
+    void (*fn)(void *arg);
+    void *arg;
+    volatile uint32_t pending;
+} ns_sched_work_t;
+
+typedef struct {
+    ns_sched_task_t *task;
+    void *data;
+    uint32_t event;
+    uint32_t postUs;
+    uint32_t seq; ///< Publication sequence number
+} ns_sched_entry_t;
+
+typedef struct {
+    ns_sched_entry_t slots[NS_SCHED_QUEUE_DEPTH];
+    uint32_t head; ///< Next slot to dispatch, consumer only
+    uint32_t tail; ///< Next slot to claim, shared by producers
+} ns_sched_ring_t;
+
+/// Scheduler-wide statistics, all times in microseconds
+typedef struct {
+    uint32_t posted;     ///< Events queued
+    uint32_t dispatched; ///< Handlers run
+    uint32_t dropped;    ///< Posts lost to a full queue
+    uint32_t idles;      ///< Calls to port->idle()
+    uint64_t busyUs;     ///< Time spent in handlers
+    uint64_t idleUs;     ///< Time spent in port->idle()
+    uint32_t maxQueued;  ///< Deepest any priority's queue got
+} ns_sched_stats_t;
+
+/// Scheduler configuration and state
+typedef struct ns_sched {
+    const ns_core_api_t *api;     ///< API prefix
+    const ns_sched_port_t *port;  ///< Platform access
+    ns_sched_stats_t stats;
+
+    // Internal state
+    ns_sched_ring_t rings[NS_SCHED_PRIORITIES];
+    ns_sched_task_t *tasks; ///< Added tasks, for statistics
+    volatile bool stop;
+} ns_sched_t;
+
+/**
+ * @brief Initialize a scheduler
+ *
+ * @param s api and port must be set
+ * @return uint32_t status
+ */
+extern uint32_t ns_sched_init(ns_sched_t *s);
+
+/**
+ * @brief Add a task to the scheduler. Events can be posted to it afterwards.
+ *
+ * @param s
+ * @param task handler and priority must be set
+ * @return uint32_t status
+ */
+extern uint32_t ns_sched_add(ns_sched_t *s, ns_sched_task_t *task);
+
+/**
+ * @brief Queue an event for a task. Safe from interrupts and from handlers.
+ *
+ * @param task an added task
+ * @param event passed to the handler
+ * @param data passed to the handler
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the queue was full
+ */
+extern uint32_t ns_sched_post(ns_sched_task_t *task, uint32_t event, void *data);
+
+/**
+ * @brief Initialize a deferred work item and add it to the scheduler
+ *
+ * @param s
+ * @param work
+ * @param fn called from ns_sched_run() after each ns_sched_defer()
+ * @param arg passed to fn
+ * @param priority 0 (highest) to NS_SCHED_PRIORITIES - 1
+ * @param name optional, for ns_sched_print_stats()
+ * @return uint32_t status
+ */
+extern uint32_t ns_sched_work_init(
+    ns_sched_t *s, ns_sched_work_t *work, void (*fn)(void *arg), void *arg, uint8_t priority,
+    const char *name);
+
+/**
+ * @brief Have a work item's function run from the main loop. Safe from interrupts.
+ *
+ * If the work item is already pending the request is merged with it; the function runs
+ * once. A work item may defer itself again while running.
+ *
+ * @param work
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the queue was full
+ */
+extern uint32_t ns_sched_defer(ns_sched_work_t *work);
+
+/**
+ * @brief Dispatch the highest priority pending event, if any
+ *
+ * @param s
+ * @return true if a handler ran
+ */
+extern bool ns_sched_run_once(ns_sched_t *s);
+
+/**
+ * @brief Dispatch events until ns_sched_stop(), sleeping whenever none are pending
+ *
+ * @param s
+ */
+extern void ns_sched_run(ns_sched_t *s);
+
+/**
+ * @brief Make ns_sched_run() return after the current handler. Safe from interrupts.
+ *
+ * @param s
+ */
+extern void ns_sched_stop(ns_sched_t *s);
+
+/**
+ * @brief Events waiting at a priority level
+ */
+extern uint32_t ns_sched_pending(ns_sched_t *s, uint8_t priority);
+
+/**
+ * @brief Clear the scheduler and all task statistics
+ */
+extern void ns_sched_stats_reset(ns_sched_t *s);
+
+/**
+ * @brief Print per-task CPU time, runs and latency with ns_lp_printf
+ */
+extern void ns_sched_print_stats(ns_sched_t *s);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_SCHED_H
+/** @}*/
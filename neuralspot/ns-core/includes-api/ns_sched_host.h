@@ -0,0 +1,87 @@
+/**
+ * @file ns_sched_host.h
+ * @author Ambiq
+ * @brief Scheduler port for POSIX hosts, with pthread virtual interrupts
+ * @version 0.1
+ * @date 2025-08-18
+ *
+ * Runs ns_sched on a PC so event handling can be tested and measured off target. The
+ * scheduler's idle() is a condition wait and every post signals it. Virtual interrupts are
+ * threads that call an "ISR" function periodically; like real interrupts they post to the
+ * scheduler concurrently with the handlers running in the main thread. Unlike real ones they
+ * can run in parallel with each other, which exercises the lock-free posting path harder.
+ *
+ * Only compiled for non-Arm builds.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-sched
+ * @{
+ *
+ */
+
+#ifndef NS_SCHED_HOST_H
+    #define NS_SCHED_HOST_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_sched.h"
+    #include <pthread.h>
+
+/// Host port state, see ns_sched_host_init()
+typedef struct {
+    ns_sched_port_t port;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool woken;
+} ns_sched_host_t;
+
+/// A virtual interrupt, fired from its own thread
+typedef struct {
+    void (*isr)(void *arg); ///< Called once per firing
+    void *arg;              ///< Passed to isr
+    uint32_t periodUs;      ///< Time between firings, 0 to fire back to back
+    uint32_t count;         ///< Firings before the thread exits
+
+    // Internal state and results
+    pthread_t thread;
+    uint32_t fired;
+    uint32_t lateMaxUs; ///< Worst host timer lateness, to tell host noise from scheduler latency
+} ns_sched_host_irq_t;
+
+/**
+ * @brief Set up the host port and point the scheduler at it
+ *
+ * Call before ns_sched_init().
+ *
+ * @param host
+ * @param s
+ * @return uint32_t status
+ */
+extern uint32_t ns_sched_host_init(ns_sched_host_t *host, ns_sched_t *s);
+
+/**
+ * @brief Start firing a virtual interrupt
+ *
+ * @param irq isr, periodUs and count must be set
+ * @return uint32_t status
+ */
+extern uint32_t ns_sched_host_irq_start(ns_sched_host_irq_t *irq);
+
+/**
+ * @brief Wait for a virtual interrupt to fire its last time
+ */
+extern void ns_sched_host_irq_join(ns_sched_host_irq_t *irq);
+
+/**
+ * @brief Host monotonic clock in microseconds, wrapping at 32 bits
+ */
+extern uint32_t ns_sched_host_now_us(void);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_SCHED_HOST_H
+/** @}*/
@@ -0,0 +1,295 @@
+/**
+ * @file ns_sched.c
+ * @author Ambiq
+ * @brief Event-driven, run-to-completion cooperative scheduler
+ * @version 0.1
+ * @date 2025-08-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_sched.h"
+#include <string.h>
+
+const ns_core_api_t ns_sched_V0_0_1 = {.apiId = NS_SCHED_API_ID, .version = NS_SCHED_V0_0_1};
+
+const ns_core_api_t ns_sched_oldest_supported_version = {
+    .apiId = NS_SCHED_API_ID, .version = NS_SCHED_V0_0_1};
+
+const ns_core_api_t ns_sched_current_version = {
+    .apiId = NS_SCHED_API_ID, .version = NS_SCHED_V0_0_1};
+
+#define NS_SCHED_MASK (NS_SCHED_QUEUE_DEPTH - 1)
+
+static void ns_sched_ring_init(ns_sched_ring_t *r) {
+    for (uint32_t i = 0; i < NS_SCHED_QUEUE_DEPTH; i++) {
+        r->slots[i].seq = i;
+    }
+    r->head = 0;
+    r->tail = 0;
+}
+
+// A slot is free for the producer claiming position pos when its seq is pos, and holds a
+// published entry for the consumer at pos when its seq is pos + 1.
+static bool ns_sched_ring_push(
+    ns_sched_ring_t *r, ns_sched_task_t *task, uint32_t event, void *data, uint32_t now) {
+    uint32_t pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    ns_sched_entry_t *e;
+
+    for (;;) {
+        e = &r->slots[pos & NS_SCHED_MASK];
+        int32_t dif = (int32_t)(__atomic_load_n(&e->seq, __ATOMIC_ACQUIRE) - pos);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(
+                    &r->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false; // Full
+        } else {
+            pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        }
+    }
+    e->task = task;
+    e->event = event;
+    e->data = data;
+    e->postUs = now;
+    __atomic_store_n(&e->seq, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool ns_sched_ring_pop(ns_sched_ring_t *r, ns_sched_entry_t *out) {
+    uint32_t pos = r->head;
+    ns_sched_entry_t *e = &r->slots[pos & NS_SCHED_MASK];
+
+    if (__atomic_load_n(&e->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+        return false; // Empty, or the next post is still being written
+    }
+    out->task = e->task;
+    out->event = e->event;
+    out->data = e->data;
+    out->postUs = e->postUs;
+    __atomic_store_n(&e->seq, pos + NS_SCHED_QUEUE_DEPTH, __ATOMIC_RELEASE);
+    r->head = pos + 1;
+    return true;
+}
+
+uint32_t ns_sched_init(ns_sched_t *s) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (s == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (ns_core_check_api(s->api, &ns_sched_oldest_supported_version,
+                          &ns_sched_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+    if ((s->port == NULL) || (s->port->now_us == NULL) || (s->port->idle == NULL) ||
+        (s->port->lock == NULL) || (s->port->unlock == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    if (s->port->init && (s->port->init(s->port->ctx) != NS_STATUS_SUCCESS)) {
+        return NS_STATUS_INIT_FAILED;
+    }
+    for (uint32_t p = 0; p < NS_SCHED_PRIORITIES; p++) {
+        ns_sched_ring_init(&s->rings[p]);
+    }
+    memset(&s->stats, 0, sizeof(s->stats));
+    s->tasks = NULL;
+    s->stop = false;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_sched_add(ns_sched_t *s, ns_sched_task_t *task) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((s == NULL) || (task == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((task->handler == NULL) || (task->priority >= NS_SCHED_PRIORITIES)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    if (task->sched == s) {
+        return NS_STATUS_SUCCESS;
+    }
+    memset(&task->stats, 0, sizeof(task->stats));
+    task->sched = s;
+    task->next = s->tasks;
+    s->tasks = task;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_sched_post(ns_sched_task_t *task, uint32_t event, void *data) {
+    ns_sched_t *s;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((task == NULL) || (task->sched == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    s = task->sched;
+    if (!ns_sched_ring_push(
+            &s->rings[task->priority], task, event, data, s->port->now_us(s->port->ctx))) {
+        __atomic_fetch_add(&task->stats.dropped, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&s->stats.dropped, 1, __ATOMIC_RELAXED);
+        return NS_STATUS_FAILURE;
+    }
+    __atomic_fetch_add(&s->stats.posted, 1, __ATOMIC_RELAXED);
+    if (s->port->wake) {
+        s->port->wake(s->port->ctx);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static void ns_sched_work_run(ns_sched_task_t *task, uint32_t event, void *data) {
+    ns_sched_work_t *work = (ns_sched_work_t *)task;
+
+    // Cleared first so the function can defer itself, and so a deferral made while it runs
+    // is not lost
+    __atomic_store_n(&work->pending, 0, __ATOMIC_RELEASE);
+    work->fn(work->arg);
+}
+
+uint32_t ns_sched_work_init(
+    ns_sched_t *s, ns_sched_work_t *work, void (*fn)(void *arg), void *arg, uint8_t priority,
+    const char *name) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((work == NULL) || (fn == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    memset(work, 0, sizeof(*work));
+    work->task.handler = ns_sched_work_run;
+    work->task.name = name;
+    work->task.priority = priority;
+    work->fn = fn;
+    work->arg = arg;
+    return ns_sched_add(s, &work->task);
+}
+
+uint32_t ns_sched_defer(ns_sched_work_t *work) {
+    uint32_t status;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if (work == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    if (__atomic_exchange_n(&work->pending, 1, __ATOMIC_ACQ_REL)) {
+        __atomic_fetch_add(&work->task.stats.coalesced, 1, __ATOMIC_RELAXED);
+        return NS_STATUS_SUCCESS;
+    }
+    status = ns_sched_post(&work->task, 0, NULL);
+    if (status != NS_STATUS_SUCCESS) {
+        __atomic_store_n(&work->pending, 0, __ATOMIC_RELEASE);
+    }
+    return status;
+}
+
+bool ns_sched_run_once(ns_sched_t *s) {
+    const ns_sched_port_t *port = s->port;
+    ns_sched_entry_t e;
+    ns_sched_task_t *task;
+    uint32_t start, end, queued;
+
+    for (uint32_t p = 0; p < NS_SCHED_PRIORITIES; p++) {
+        ns_sched_ring_t *r = &s->rings[p];
+        queued = __atomic_load_n(&r->tail, __ATOMIC_RELAXED) - r->head;
+        if (!ns_sched_ring_pop(r, &e)) {
+            continue;
+        }
+        if (queued > s->stats.maxQueued) {
+            s->stats.maxQueued = queued;
+        }
+
+        task = e.task;
+        start = port->now_us(port->ctx);
+        task->handler(task, e.event, e.data);
+        end = port->now_us(port->ctx);
+
+        task->stats.runs++;
+        task->stats.cpuUs += end - start;
+        if (end - start > task->stats.runMaxUs) {
+            task->stats.runMaxUs = end - start;
+        }
+        task->stats.latencySumUs += start - e.postUs;
+        if (start - e.postUs > task->stats.latencyMaxUs) {
+            task->stats.latencyMaxUs = start - e.postUs;
+        }
+        s->stats.dispatched++;
+        s->stats.busyUs += end - start;
+        return true;
+    }
+    return false;
+}
+
+static bool ns_sched_any_pending(ns_sched_t *s) {
+    for (uint32_t p = 0; p < NS_SCHED_PRIORITIES; p++) {
+        ns_sched_ring_t *r = &s->rings[p];
+        if (__atomic_load_n(&r->slots[r->head & NS_SCHED_MASK].seq, __ATOMIC_ACQUIRE) ==
+            r->head + 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ns_sched_run(ns_sched_t *s) {
+    const ns_sched_port_t *port = s->port;
+    uint32_t state, start;
+
+    s->stop = false;
+    while (!s->stop) {
+        if (ns_sched_run_once(s)) {
+            continue;
+        }
+        // Check again with wakeups masked so a post can't slip in before idle()
+        state = port->lock(port->ctx);
+        if (!ns_sched_any_pending(s) && !s->stop) {
+            start = port->now_us(port->ctx);
+            port->idle(port->ctx);
+            s->stats.idleUs += port->now_us(port->ctx) - start;
+            s->stats.idles++;
+        }
+        port->unlock(port->ctx, state);
+    }
+}
+
+void ns_sched_stop(ns_sched_t *s) {
+    s->stop = true;
+    if (s->port->wake) {
+        s->port->wake(s->port->ctx);
+    }
+}
+
+uint32_t ns_sched_pending(ns_sched_t *s, uint8_t priority) {
+    if (priority >= NS_SCHED_PRIORITIES) {
+        return 0;
+    }
+    return __atomic_load_n(&s->rings[priority].tail, __ATOMIC_RELAXED) -
+           s->rings[priority].head;
+}
+
+void ns_sched_stats_reset(ns_sched_t *s) {
+    memset(&s->stats, 0, sizeof(s->stats));
+    for (ns_sched_task_t *t = s->tasks; t != NULL; t = t->next) {
+        memset(&t->stats, 0, sizeof(t->stats));
+    }
+}
+
+void ns_sched_print_stats(ns_sched_t *s) {
+    uint64_t total = s->stats.busyUs + s->stats.idleUs;
+
+    ns_lp_printf("Task             Runs  CPU us      CPU%%  Max us  Avg lat  Max lat  Drop\n");
+    for (ns_sched_task_t *t = s->tasks; t != NULL; t = t->next) {
+        ns_lp_printf("%-16s %-5u %-11u %-5u %-7u %-8u %-8u %u\n", t->name ? t->name : "-",
+                     t->stats.runs, (uint32_t)t->stats.cpuUs,
+                     total ? (uint32_t)(t->stats.cpuUs * 100 / total) : 0, t->stats.runMaxUs,
+                     t->stats.runs ? (uint32_t)(t->stats.latencySumUs / t->stats.runs) : 0,
+                     t->stats.latencyMaxUs, t->stats.dropped);
+    }
+    ns_lp_printf("Busy %u us, idle %u us (%u sleeps), %u posted, %u dropped, max queued %u\n",
+                 (uint32_t)s->stats.busyUs, (uint32_t)s->stats.idleUs, s->stats.idles,
+                 s->stats.posted, s->stats.dropped, s->stats.maxQueued);
+}
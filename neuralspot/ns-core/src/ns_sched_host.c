@@ -0,0 +1,112 @@
+/**
+ * @file ns_sched_host.c
+ * @author Ambiq
+ * @brief Scheduler port for POSIX hosts, with pthread virtual interrupts
+ * @version 0.1
+ * @date 2025-08-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef __ARM_ARCH
+
+    #define _POSIX_C_SOURCE 200809L
+    #include "ns_sched_host.h"
+    #include <time.h>
+
+uint32_t ns_sched_host_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000);
+}
+
+static uint32_t ns_sched_host_port_now_us(void *ctx) { return ns_sched_host_now_us(); }
+
+// Called with the mutex held (lock()), returns with it held
+static void ns_sched_host_idle(void *ctx) {
+    ns_sched_host_t *host = (ns_sched_host_t *)ctx;
+    while (!host->woken) {
+        pthread_cond_wait(&host->cond, &host->mutex);
+    }
+    host->woken = false;
+}
+
+static void ns_sched_host_wake(void *ctx) {
+    ns_sched_host_t *host = (ns_sched_host_t *)ctx;
+    pthread_mutex_lock(&host->mutex);
+    host->woken = true;
+    pthread_cond_signal(&host->cond);
+    pthread_mutex_unlock(&host->mutex);
+}
+
+static uint32_t ns_sched_host_lock(void *ctx) {
+    pthread_mutex_lock(&((ns_sched_host_t *)ctx)->mutex);
+    return 0;
+}
+
+static void ns_sched_host_unlock(void *ctx, uint32_t state) {
+    pthread_mutex_unlock(&((ns_sched_host_t *)ctx)->mutex);
+}
+
+uint32_t ns_sched_host_init(ns_sched_host_t *host, ns_sched_t *s) {
+    if ((host == NULL) || (s == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (pthread_mutex_init(&host->mutex, NULL) || pthread_cond_init(&host->cond, NULL)) {
+        return NS_STATUS_INIT_FAILED;
+    }
+    host->woken = false;
+    host->port.init = NULL;
+    host->port.now_us = ns_sched_host_port_now_us;
+    host->port.idle = ns_sched_host_idle;
+    host->port.wake = ns_sched_host_wake;
+    host->port.lock = ns_sched_host_lock;
+    host->port.unlock = ns_sched_host_unlock;
+    host->port.ctx = host;
+    s->port = &host->port;
+    return NS_STATUS_SUCCESS;
+}
+
+static void *ns_sched_host_irq_thread(void *arg) {
+    ns_sched_host_irq_t *irq = (ns_sched_host_irq_t *)arg;
+    struct timespec next;
+    uint32_t due;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    due = ns_sched_host_now_us();
+    for (uint32_t i = 0; i < irq->count; i++) {
+        if (irq->periodUs) {
+            next.tv_nsec += (long)irq->periodUs * 1000;
+            while (next.tv_nsec >= 1000000000L) {
+                next.tv_nsec -= 1000000000L;
+                next.tv_sec++;
+            }
+            due += irq->periodUs;
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+            uint32_t late = ns_sched_host_now_us() - due;
+            if ((int32_t)late > 0 && late > irq->lateMaxUs) {
+                irq->lateMaxUs = late;
+            }
+        }
+        irq->isr(irq->arg);
+        irq->fired++;
+    }
+    return NULL;
+}
+
+uint32_t ns_sched_host_irq_start(ns_sched_host_irq_t *irq) {
+    if ((irq == NULL) || (irq->isr == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    irq->fired = 0;
+    irq->lateMaxUs = 0;
+    if (pthread_create(&irq->thread, NULL, ns_sched_host_irq_thread, irq)) {
+        return NS_STATUS_FAILURE;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_sched_host_irq_join(ns_sched_host_irq_t *irq) { pthread_join(irq->thread, NULL); }
+
+#endif // __ARM_ARCH
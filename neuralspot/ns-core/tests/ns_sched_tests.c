@@ -0,0 +1,406 @@
+#include "ns_sched_tests.h"
+#include "ns_core.h"
+#include "unity/unity.h"
+#include <string.h>
+#ifndef __ARM_ARCH
+    #include "ns_sched_host.h"
+    #include <sched.h>
+#endif
+
+// Most tests run the scheduler on a virtual clock: handlers advance it to model their run
+// time and idle() delivers the next simulated interrupt. The host tests use real threads.
+
+#define ST_LOG 64
+
+static uint32_t vclock;
+static uint32_t vidles;
+static void (*vinterrupt)(void); // What idle() "wakes up" to, NULL to stop
+static ns_sched_t sched;
+
+static uint32_t st_now_us(void *ctx) { return vclock; }
+
+static void st_idle(void *ctx) {
+    vidles++;
+    vclock += 1000;
+    if (vinterrupt) {
+        vinterrupt();
+    } else {
+        ns_sched_stop(&sched);
+    }
+}
+
+static uint32_t st_lock(void *ctx) { return 0; }
+
+static void st_unlock(void *ctx, uint32_t state) {}
+
+static const ns_sched_port_t st_port = {
+    .now_us = st_now_us,
+    .idle = st_idle,
+    .lock = st_lock,
+    .unlock = st_unlock,
+};
+
+// Handlers append (task id, event) to a log and advance the clock by arg microseconds
+static uint32_t logTask[ST_LOG], logEvent[ST_LOG], logCount;
+
+static void st_log_handler(ns_sched_task_t *task, uint32_t event, void *data) {
+    if (logCount < ST_LOG) {
+        logTask[logCount] = task->priority;
+        logEvent[logCount] = event;
+        logCount++;
+    }
+    vclock += (uint32_t)(uintptr_t)task->arg;
+}
+
+static ns_sched_task_t tasks[NS_SCHED_PRIORITIES];
+
+static void st_setup() {
+    memset(&sched, 0, sizeof(sched));
+    memset(tasks, 0, sizeof(tasks));
+    sched.api = &ns_sched_V0_0_1;
+    sched.port = &st_port;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_init(&sched));
+    for (uint8_t p = 0; p < NS_SCHED_PRIORITIES; p++) {
+        tasks[p].handler = st_log_handler;
+        tasks[p].priority = p;
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_add(&sched, &tasks[p]));
+    }
+    vclock = 0;
+    vidles = 0;
+    vinterrupt = NULL;
+    logCount = 0;
+}
+
+void ns_sched_tests_pre_test_hook() {}
+
+void ns_sched_tests_post_test_hook() {}
+
+void ns_sched_test_init_validation() {
+    ns_sched_port_t noIdle = st_port;
+    ns_sched_task_t task = {0};
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_sched_init(NULL));
+    memset(&sched, 0, sizeof(sched));
+    sched.port = &st_port;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_sched_init(&sched));
+    sched.api = &ns_sched_V0_0_1;
+    sched.port = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_sched_init(&sched));
+    noIdle.idle = NULL;
+    sched.port = &noIdle;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_sched_init(&sched));
+    sched.port = &st_port;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_init(&sched));
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_sched_add(&sched, &task));
+    task.handler = st_log_handler;
+    task.priority = NS_SCHED_PRIORITIES;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_sched_add(&sched, &task));
+    task.priority = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_sched_post(&task, 0, NULL));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_add(&sched, &task));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_add(&sched, &task));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_post(&task, 0, NULL));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_sched_post(NULL, 0, NULL));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_sched_defer(NULL));
+}
+
+// Highest priority first, posting order within a priority
+void ns_sched_test_priority_order() {
+    static const uint32_t expTask[] = {0, 1, 1, 2, 3, 3};
+    static const uint32_t expEvent[] = {6, 2, 5, 4, 1, 3};
+
+    st_setup();
+    ns_sched_post(&tasks[3], 1, NULL);
+    ns_sched_post(&tasks[1], 2, NULL);
+    ns_sched_post(&tasks[3], 3, NULL);
+    ns_sched_post(&tasks[2], 4, NULL);
+    ns_sched_post(&tasks[1], 5, NULL);
+    ns_sched_post(&tasks[0], 6, NULL);
+    TEST_ASSERT_EQUAL(2, ns_sched_pending(&sched, 1));
+    TEST_ASSERT_EQUAL(0, ns_sched_pending(&sched, NS_SCHED_PRIORITIES));
+
+    TEST_ASSERT_TRUE(ns_sched_run_once(&sched));
+    TEST_ASSERT_TRUE(ns_sched_run_once(&sched));
+    ns_sched_run(&sched);
+    TEST_ASSERT_EQUAL(6, logCount);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expTask, logTask, 6);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expEvent, logEvent, 6);
+    TEST_ASSERT_FALSE(ns_sched_run_once(&sched));
+    TEST_ASSERT_EQUAL(6, sched.stats.posted);
+    TEST_ASSERT_EQUAL(6, sched.stats.dispatched);
+    TEST_ASSERT_EQUAL(2, sched.stats.maxQueued);
+    TEST_ASSERT_EQUAL(1, vidles);
+}
+
+void ns_sched_test_queue_full() {
+    st_setup();
+    for (uint32_t i = 0; i < NS_SCHED_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_post(&tasks[2], i, NULL));
+    }
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_sched_post(&tasks[2], 99, NULL));
+    TEST_ASSERT_EQUAL(1, tasks[2].stats.dropped);
+    TEST_ASSERT_EQUAL(1, sched.stats.dropped);
+
+    // Other priorities are unaffected, and the ring reuses its slots
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_post(&tasks[3], 100, NULL));
+    for (uint32_t round = 0; round < 3; round++) {
+        while (ns_sched_run_once(&sched)) {
+        }
+        for (uint32_t i = 0; i < NS_SCHED_QUEUE_DEPTH - 1; i++) {
+            TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_post(&tasks[2], i, NULL));
+        }
+    }
+    TEST_ASSERT_EQUAL(NS_SCHED_QUEUE_DEPTH - 1, ns_sched_pending(&sched, 2));
+    TEST_ASSERT_EQUAL(NS_SCHED_QUEUE_DEPTH, sched.stats.maxQueued);
+}
+
+static ns_sched_work_t work;
+static uint32_t workRuns, workRedefer;
+
+static void st_work_fn(void *arg) {
+    workRuns++;
+    TEST_ASSERT_EQUAL_PTR(&workRuns, arg);
+    if (workRedefer) {
+        workRedefer--;
+        ns_sched_defer(&work);
+    }
+}
+
+void ns_sched_test_deferred_work() {
+    st_setup();
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_HANDLE, ns_sched_work_init(&sched, &work, NULL, NULL, 0, "work"));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_sched_work_init(&sched, &work, st_work_fn, NULL, NS_SCHED_PRIORITIES, "work"));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS, ns_sched_work_init(&sched, &work, st_work_fn, &workRuns, 1, "work"));
+    workRuns = 0;
+    workRedefer = 0;
+
+    // Three deferrals before the main loop gets to it run the work once
+    ns_sched_defer(&work);
+    ns_sched_defer(&work);
+    ns_sched_defer(&work);
+    TEST_ASSERT_EQUAL(1, ns_sched_pending(&sched, 1));
+    ns_sched_run(&sched);
+    TEST_ASSERT_EQUAL(1, workRuns);
+    TEST_ASSERT_EQUAL(2, work.task.stats.coalesced);
+
+    // Re-deferring from inside the work function queues it again
+    workRedefer = 2;
+    ns_sched_defer(&work);
+    ns_sched_run(&sched);
+    TEST_ASSERT_EQUAL(4, workRuns);
+    TEST_ASSERT_EQUAL(4, work.task.stats.runs);
+
+    // A failed deferral (full queue) can be retried
+    for (uint32_t i = 0; i < NS_SCHED_QUEUE_DEPTH; i++) {
+        ns_sched_post(&tasks[1], i, NULL);
+    }
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_sched_defer(&work));
+    TEST_ASSERT_EQUAL(0, work.pending);
+    ns_sched_run_once(&sched);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_defer(&work));
+}
+
+// A periodic "sensor interrupt" every 1000 us, while idle
+static uint32_t sensorIrqs;
+
+static void st_sensor_irq(void) {
+    if (sensorIrqs++ < 10) {
+        vclock += 7; // Interrupt entry
+        ns_sched_post(&tasks[2], sensorIrqs, NULL);
+        if ((sensorIrqs & 1) == 0) {
+            ns_sched_post(&tasks[3], sensorIrqs, NULL);
+        }
+    } else {
+        ns_sched_stop(&sched);
+    }
+}
+
+void ns_sched_test_cpu_accounting() {
+    st_setup();
+    tasks[2].arg = (void *)(uintptr_t)120;
+    tasks[3].arg = (void *)(uintptr_t)300;
+    vinterrupt = st_sensor_irq;
+    sensorIrqs = 0;
+    ns_sched_run(&sched);
+
+    TEST_ASSERT_EQUAL(10, tasks[2].stats.runs);
+    TEST_ASSERT_EQUAL(5, tasks[3].stats.runs);
+    TEST_ASSERT_EQUAL(1200, tasks[2].stats.cpuUs);
+    TEST_ASSERT_EQUAL(1500, tasks[3].stats.cpuUs);
+    TEST_ASSERT_EQUAL(120, tasks[2].stats.runMaxUs);
+    TEST_ASSERT_EQUAL(300, tasks[3].stats.runMaxUs);
+    // Priority 3 waits behind priority 2's handler each time
+    TEST_ASSERT_EQUAL(0, tasks[2].stats.latencyMaxUs);
+    TEST_ASSERT_EQUAL(120, tasks[3].stats.latencyMaxUs);
+    TEST_ASSERT_EQUAL(5 * 120, tasks[3].stats.latencySumUs);
+    TEST_ASSERT_EQUAL(2700, sched.stats.busyUs);
+    TEST_ASSERT_EQUAL(11, sched.stats.idles);
+    TEST_ASSERT_EQUAL(11 * 1000 + 10 * 7, sched.stats.idleUs);
+    ns_sched_print_stats(&sched);
+
+    ns_sched_stats_reset(&sched);
+    TEST_ASSERT_EQUAL(0, tasks[3].stats.cpuUs);
+    TEST_ASSERT_EQUAL(0, sched.stats.busyUs);
+}
+
+static void st_stop_handler(ns_sched_task_t *task, uint32_t event, void *data) {
+    ns_sched_stop(&sched);
+    ns_sched_post(&tasks[0], event + 1, NULL);
+}
+
+void ns_sched_test_idle_and_stop() {
+    st_setup();
+
+    // Idle is not entered while there is work, and stop takes effect after the handler
+    tasks[1].handler = st_stop_handler;
+    ns_sched_post(&tasks[1], 10, NULL);
+    ns_sched_run(&sched);
+    TEST_ASSERT_EQUAL(0, vidles);
+    TEST_ASSERT_EQUAL(1, ns_sched_pending(&sched, 0));
+
+    // Running again picks up where it stopped
+    ns_sched_run(&sched);
+    TEST_ASSERT_EQUAL(1, logCount);
+    TEST_ASSERT_EQUAL(11, logEvent[0]);
+    TEST_ASSERT_EQUAL(1, vidles);
+}
+
+#ifndef __ARM_ARCH
+
+// Several virtual interrupts post concurrently; every event must arrive exactly once
+    #define ST_IRQS 3
+    #define ST_PER_IRQ 20000
+
+static ns_sched_host_t host;
+static ns_sched_task_t hostTasks[ST_IRQS];
+static uint32_t hostSeen[ST_IRQS];
+static uint32_t hostOutOfOrder, hostDone, hostRetries;
+
+static void st_host_handler(ns_sched_task_t *task, uint32_t event, void *data) {
+    uint32_t i = (uint32_t)(uintptr_t)task->arg;
+    if (event != hostSeen[i]) {
+        hostOutOfOrder++;
+    }
+    hostSeen[i] = event + 1;
+    if (++hostDone == ST_IRQS * ST_PER_IRQ) {
+        ns_sched_stop(&sched);
+    }
+}
+
+typedef struct {
+    ns_sched_task_t *task;
+    uint32_t next;
+} st_host_src_t;
+
+static void st_host_isr(void *arg) {
+    st_host_src_t *src = (st_host_src_t *)arg;
+    // A real ISR would drop (or buffer) the event; here every event has to get through
+    while (ns_sched_post(src->task, src->next, NULL) != NS_STATUS_SUCCESS) {
+        __atomic_fetch_add(&hostRetries, 1, __ATOMIC_RELAXED);
+        sched_yield();
+    }
+    src->next++;
+}
+
+static void st_host_setup() {
+    memset(&sched, 0, sizeof(sched));
+    memset(hostTasks, 0, sizeof(hostTasks));
+    memset(hostSeen, 0, sizeof(hostSeen));
+    sched.api = &ns_sched_V0_0_1;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_host_init(&host, &sched));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_init(&sched));
+    for (uint32_t i = 0; i < ST_IRQS; i++) {
+        hostTasks[i].handler = st_host_handler;
+        hostTasks[i].arg = (void *)(uintptr_t)i;
+        hostTasks[i].priority = (uint8_t)i;
+        hostTasks[i].name = i == 0 ? "irq0" : i == 1 ? "irq1" : "irq2";
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_add(&sched, &hostTasks[i]));
+    }
+    hostOutOfOrder = 0;
+    hostDone = 0;
+    hostRetries = 0;
+}
+
+void ns_sched_test_host_virtual_interrupts() {
+    ns_sched_host_irq_t irqs[ST_IRQS];
+    st_host_src_t srcs[ST_IRQS];
+
+    st_host_setup();
+    for (uint32_t i = 0; i < ST_IRQS; i++) {
+        srcs[i].task = &hostTasks[i];
+        srcs[i].next = 0;
+        memset(&irqs[i], 0, sizeof(irqs[i]));
+        irqs[i].isr = st_host_isr;
+        irqs[i].arg = &srcs[i];
+        irqs[i].periodUs = 0;
+        irqs[i].count = ST_PER_IRQ;
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_host_irq_start(&irqs[i]));
+    }
+    ns_sched_run(&sched);
+    for (uint32_t i = 0; i < ST_IRQS; i++) {
+        ns_sched_host_irq_join(&irqs[i]);
+        TEST_ASSERT_EQUAL(ST_PER_IRQ, hostSeen[i]);
+        TEST_ASSERT_EQUAL(ST_PER_IRQ, hostTasks[i].stats.runs);
+    }
+    TEST_ASSERT_EQUAL(0, hostOutOfOrder);
+    TEST_ASSERT_EQUAL(ST_IRQS * ST_PER_IRQ, sched.stats.posted);
+    TEST_ASSERT_EQUAL(ST_IRQS * ST_PER_IRQ, sched.stats.dispatched);
+    TEST_ASSERT_EQUAL(hostRetries, sched.stats.dropped);
+}
+
+// Latency of periodic interrupts through an idle scheduler, and back to back throughput
+void ns_sched_test_host_benchmark() {
+    ns_sched_host_irq_t irq;
+    st_host_src_t src;
+    uint32_t start, elapsed;
+
+    st_host_setup();
+    src.task = &hostTasks[0];
+    src.next = 0;
+    memset(&irq, 0, sizeof(irq));
+    irq.isr = st_host_isr;
+    irq.arg = &src;
+    irq.periodUs = 1000;
+    irq.count = 200;
+    hostDone = ST_IRQS * ST_PER_IRQ - irq.count;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_sched_host_irq_start(&irq));
+    ns_sched_run(&sched);
+    ns_sched_host_irq_join(&irq);
+    TEST_ASSERT_EQUAL(200, hostTasks[0].stats.runs);
+    TEST_ASSERT_TRUE(sched.stats.idles >= 100); // Slept between interrupts rather than spinning
+    ns_lp_printf("Periodic 1 kHz virtual interrupt, 200 events:\n");
+    ns_lp_printf("  post to dispatch: avg %u us, max %u us (host timer late by up to %u us)\n",
+                 (uint32_t)(hostTasks[0].stats.latencySumUs / hostTasks[0].stats.runs),
+                 hostTasks[0].stats.latencyMaxUs, irq.lateMaxUs);
+    ns_lp_printf("  %u sleeps, busy %u us, idle %u us\n", sched.stats.idles,
+                 (uint32_t)sched.stats.busyUs, (uint32_t)sched.stats.idleUs);
+
+    st_host_setup();
+    for (uint32_t i = 0; i < ST_IRQS * ST_PER_IRQ; i++) {
+        ns_sched_post(&hostTasks[i % ST_IRQS], i / ST_IRQS, NULL);
+        ns_sched_run_once(&sched);
+    }
+    start = ns_sched_host_now_us();
+    st_host_setup();
+    for (uint32_t i = 0; i < ST_IRQS * ST_PER_IRQ; i++) {
+        ns_sched_post(&hostTasks[i % ST_IRQS], i / ST_IRQS, NULL);
+        ns_sched_run_once(&sched);
+    }
+    elapsed = ns_sched_host_now_us() - start;
+    TEST_ASSERT_EQUAL(0, hostOutOfOrder);
+    ns_lp_printf("Post + dispatch, single thread: %u ns per event\n",
+                 (uint32_t)((uint64_t)elapsed * 1000 / (ST_IRQS * ST_PER_IRQ)));
+}
+
+#else
+
+void ns_sched_test_host_virtual_interrupts() { TEST_IGNORE_MESSAGE("host only"); }
+
+void ns_sched_test_host_benchmark() { TEST_IGNORE_MESSAGE("host only"); }
+
+#endif // __ARM_ARCH
@@ -0,0 +1,11 @@
+#include "ns_sched.h"
+void ns_sched_tests_pre_test_hook();
+void ns_sched_tests_post_test_hook();
+void ns_sched_test_init_validation();
+void ns_sched_test_priority_order();
+void ns_sched_test_queue_full();
+void ns_sched_test_deferred_work();
+void ns_sched_test_cpu_accounting();
+void ns_sched_test_idle_and_stop();
+void ns_sched_test_host_virtual_interrupts();
+void ns_sched_test_host_benchmark();
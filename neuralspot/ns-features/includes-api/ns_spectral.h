@@ -0,0 +1,209 @@
+/**
+ * @file ns_spectral.h
+ * @author Ambiq
+ * @brief Multi-channel windowed spectral analysis
+ * @version 0.1
+ * @date 2025-08-04
+ *
+ * Keeps the most recent windowLen samples of every channel and, every hopLen samples, runs a
+ * windowed real FFT over them to extract:
+ *
+ * - the dominant frequency of the spectrum summed over all channels
+ * - optionally the dominant frequency of every channel
+ * - optionally the power of every channel in a set of frequency bands
+ *
+ * Samples are kept in channel-major rings (one contiguous block of floats per channel, one
+ * write position shared by all channels), so windowing a channel is two linear passes. The
+ * window and the FFT twiddle tables are computed once by ns_spectral_init() and shared by every
+ * channel. When only the summed spectrum is needed, the windowed channels are summed before
+ * the FFT (the FFT is linear), so an analysis costs one FFT regardless of the channel count.
+ *
+ * Samples arrive in batches: ns_spectral_process() accepts any number of sample-major frames
+ * (one float per channel per sample, the layout of a sensor FIFO) and runs every analysis that
+ * falls due in between. ns_spectral_sched_t simulates a FIFO with a watermark of K samples to
+ * model duty-cycled sensors, and ns_spectral_benchmark() reports the cost of a configuration
+ * in cycles per channel-second for a set of K.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-spectral
+ *  @{
+ */
+
+#ifndef NS_SPECTRAL_H
+#define NS_SPECTRAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "arm_math.h"
+#include "ns_core.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NS_SPECTRAL_V0_0_1                                                                         \
+    { .major = 0, .minor = 0, .revision = 1 }
+
+#define NS_SPECTRAL_OLDEST_SUPPORTED_VERSION NS_SPECTRAL_V0_0_1
+#define NS_SPECTRAL_CURRENT_VERSION NS_SPECTRAL_V0_0_1
+#define NS_SPECTRAL_API_ID 0xCA0012
+
+/// Size, in floats, of ns_spectral_t.work
+#define NS_SPECTRAL_WORK_SIZE(fftLen) (3 * (fftLen))
+
+extern const ns_core_api_t ns_spectral_V0_0_1;
+extern const ns_core_api_t ns_spectral_oldest_supported_version;
+extern const ns_core_api_t ns_spectral_current_version;
+
+/// Frequency band, bins with lowHz <= f < highHz
+typedef struct {
+    float lowHz;
+    float highHz;
+} ns_spectral_band_t;
+
+struct ns_spectral;
+
+/// Called after every analysis, results are in the ns_spectral_t
+typedef void (*ns_spectral_cb)(struct ns_spectral *s, void *ctx);
+
+typedef struct ns_spectral {
+    const ns_core_api_t *api;
+    uint16_t numChannels;
+    uint16_t windowLen;  ///< Samples per channel in each analysis
+    uint16_t fftLen;     ///< Power of two from 32 to 4096, >= windowLen (zero padded)
+    uint16_t hopLen;     ///< Samples between analyses
+    float sampleRate;    ///< Hz
+    float minHz;         ///< Dominant frequency search range, 0 for the first non-DC bin
+    float maxHz;         ///< 0 for Nyquist
+    float *rings;        ///< numChannels * windowLen floats
+    float *window;       ///< windowLen floats, filled with a Hann window by ns_spectral_init
+    float *work;         ///< NS_SPECTRAL_WORK_SIZE(fftLen) floats
+    const ns_spectral_band_t *bands;
+    uint8_t numBands;
+    float *bandPower;    ///< numChannels * numBands floats (channel-major), NULL if no bands
+    float *channelHz;    ///< numChannels floats, per channel dominant frequency, or NULL
+    ns_spectral_cb callback; ///< Optional
+    void *callbackCtx;
+
+    // Results of the last analysis
+    float dominantHz; ///< Of the spectrum summed over channels
+    float dominantPower; ///< Of the peak bin only, bandPower integrates over bins
+    uint32_t analyses;
+
+    // Internal state
+    uint16_t pos;      ///< Next write position in the rings, also the oldest sample
+    uint16_t sinceHop; ///< Samples since the last analysis
+    uint32_t samples;  ///< Samples received, saturates at windowLen
+    uint16_t binMin;   ///< Dominant frequency search range, from minHz and maxHz
+    uint16_t binMax;
+    float powerScale;  ///< Normalizes |X|^2 to the mean square of a sinusoid
+    arm_rfft_fast_instance_f32 fft;
+} ns_spectral_t;
+
+/// Simulated sensor FIFO that wakes the processor every batch samples
+typedef struct {
+    ns_spectral_t *spectral;
+    float *fifo;    ///< batch * numChannels floats
+    uint16_t batch; ///< Watermark (K), in samples
+
+    // Internal state
+    uint16_t count;
+    uint32_t wakeups;
+} ns_spectral_sched_t;
+
+/// Cost of one batch size, see ns_spectral_benchmark
+typedef struct {
+    uint16_t batch;
+    uint32_t wakeups;
+    uint32_t analyses;
+    float cyclesPerChannelSecond; ///< In units of the benchmark's counter
+} ns_spectral_bench_result_t;
+
+/// Free-running counter used by ns_spectral_benchmark (e.g. DWT->CYCCNT, or clock() on a host)
+typedef uint32_t (*ns_spectral_counter_cb)(void);
+
+/**
+ * @brief Validate the configuration, compute the window and FFT tables and clear the rings
+ *
+ * @param s Spectral analyzer, with config fields and buffers set
+ * @return uint32_t status
+ */
+extern uint32_t ns_spectral_init(ns_spectral_t *s);
+
+/**
+ * @brief Clear the rings and results, keeping the tables
+ *
+ * @param s Initialized spectral analyzer
+ */
+extern void ns_spectral_reset(ns_spectral_t *s);
+
+/**
+ * @brief Add samples, running every analysis that falls due
+ *
+ * An analysis falls due every hopLen samples, starting with the first one after the rings hold
+ * windowLen samples.
+ *
+ * @param s Initialized spectral analyzer
+ * @param frames numFrames * numChannels floats, sample-major (frames[i * numChannels + ch])
+ * @param numFrames Number of samples per channel
+ * @return uint32_t Number of analyses that ran
+ */
+extern uint32_t ns_spectral_process(ns_spectral_t *s, const float *frames, uint32_t numFrames);
+
+/**
+ * @brief Run an analysis over the current rings, regardless of the hop
+ *
+ * @param s Initialized spectral analyzer
+ */
+extern void ns_spectral_analyze(ns_spectral_t *s);
+
+/**
+ * @brief Frequency of an FFT bin
+ */
+extern float ns_spectral_bin_hz(const ns_spectral_t *s, uint32_t bin);
+
+/**
+ * @brief Reset a simulated FIFO
+ *
+ * @param q FIFO, with spectral, fifo and batch set
+ * @return uint32_t status
+ */
+extern uint32_t ns_spectral_sched_init(ns_spectral_sched_t *q);
+
+/**
+ * @brief Add one sample (numChannels floats) to the FIFO
+ *
+ * When the FIFO reaches its watermark the processor wakes up and the whole batch is handed to
+ * ns_spectral_process().
+ *
+ * @param q FIFO
+ * @param frame numChannels floats
+ * @return true if the sample caused a wakeup
+ */
+extern bool ns_spectral_sched_push(ns_spectral_sched_t *q, const float *frame);
+
+/**
+ * @brief Measure processing cost for a set of FIFO watermarks
+ *
+ * For every batch size, resets the analyzer and feeds it seconds worth of a synthetic
+ * multi-channel signal through a simulated FIFO, counting only the processing done at wakeups.
+ *
+ * @param s Initialized spectral analyzer
+ * @param fifo max(batches) * numChannels floats
+ * @param batches Batch sizes (K) to measure
+ * @param numBatches
+ * @param seconds Simulated signal length
+ * @param counter Free-running counter
+ * @param results numBatches results
+ * @return uint32_t status
+ */
+extern uint32_t ns_spectral_benchmark(
+    ns_spectral_t *s, float *fifo, const uint16_t *batches, uint32_t numBatches, uint32_t seconds,
+    ns_spectral_counter_cb counter, ns_spectral_bench_result_t *results);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+/** @} */
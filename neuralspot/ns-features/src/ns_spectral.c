@@ -0,0 +1,242 @@
+/**
+ * @file ns_spectral.c
+ * @author Ambiq
+ * @brief Multi-channel windowed spectral analysis
+ * @version 0.1
+ * @date 2025-08-04
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_spectral.h"
+#include <math.h>
+#include <string.h>
+
+const ns_core_api_t ns_spectral_V0_0_1 = {
+    .apiId = NS_SPECTRAL_API_ID, .version = NS_SPECTRAL_V0_0_1};
+const ns_core_api_t ns_spectral_oldest_supported_version = {
+    .apiId = NS_SPECTRAL_API_ID, .version = NS_SPECTRAL_V0_0_1};
+const ns_core_api_t ns_spectral_current_version = {
+    .apiId = NS_SPECTRAL_API_ID, .version = NS_SPECTRAL_V0_0_1};
+
+#ifndef PI
+    #define PI 3.14159265358979f
+#endif
+
+static uint16_t ns_spectral_hz_to_bin(const ns_spectral_t *s, float hz) {
+    return (uint16_t)ceilf(hz * s->fftLen / s->sampleRate);
+}
+
+uint32_t ns_spectral_init(ns_spectral_t *s) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (s == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(
+            s->api, &ns_spectral_oldest_supported_version, &ns_spectral_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((s->rings == NULL) || (s->window == NULL) || (s->work == NULL) ||
+        (s->numChannels == 0) || (s->windowLen == 0) || (s->hopLen == 0) ||
+        (s->fftLen < 32) || (s->fftLen > 4096) || (s->fftLen & (s->fftLen - 1)) ||
+        (s->windowLen > s->fftLen) || !(s->sampleRate > 0.0f) ||
+        ((s->numBands != 0) && ((s->bands == NULL) || (s->bandPower == NULL)))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    // Search range, bin 0 (DC) is only searched when asked for explicitly
+    s->binMin = (s->minHz > 0.0f) ? ns_spectral_hz_to_bin(s, s->minHz) : 1;
+    s->binMax = s->fftLen / 2;
+    if (s->maxHz > 0.0f) {
+        s->binMax = MIN(s->binMax, (uint16_t)floorf(s->maxHz * s->fftLen / s->sampleRate));
+    }
+    if (s->binMin > s->binMax) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    if (arm_rfft_fast_init_f32(&s->fft, s->fftLen) != ARM_MATH_SUCCESS) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    // Periodic Hann window, w(n) = 0.5 * (1 - cos(2 * pi * n / N))
+    float energy = 0.0f;
+    for (uint32_t i = 0; i < s->windowLen; i++) {
+        s->window[i] = 0.5f * (1.0f - cosf((2.0f * PI * i) / s->windowLen));
+        energy += s->window[i] * s->window[i];
+    }
+    // One-sided spectrum: a sinusoid of amplitude A reports A^2 / 2. Parseval over the
+    // zero-padded frame gives sum(|X|^2) = fftLen * sum((x * w)^2), split over two halves.
+    s->powerScale = (energy > 0.0f) ? 2.0f / (s->fftLen * energy) : 0.0f;
+
+    ns_spectral_reset(s);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_spectral_reset(ns_spectral_t *s) {
+    memset(s->rings, 0, (uint32_t)s->numChannels * s->windowLen * sizeof(float));
+    s->pos = 0;
+    s->sinceHop = 0;
+    s->samples = 0;
+    s->dominantHz = 0.0f;
+    s->dominantPower = 0.0f;
+    s->analyses = 0;
+}
+
+float ns_spectral_bin_hz(const ns_spectral_t *s, uint32_t bin) {
+    return (float)bin * s->sampleRate / s->fftLen;
+}
+
+// Copy one channel, oldest sample first, applying the window
+static void ns_spectral_window(const ns_spectral_t *s, const float *ring, float *dst) {
+    uint32_t first = s->windowLen - s->pos;
+
+    arm_mult_f32((float32_t *)ring + s->pos, s->window, dst, first);
+    arm_mult_f32((float32_t *)ring, s->window + first, dst + first, s->pos);
+}
+
+// Power of bins 0 to fftLen / 2 from a packed CMSIS real FFT (DC and Nyquist in spec[0] and
+// spec[1]). The edge bins have no mirror image, so they are halved to match the power scale.
+static void ns_spectral_power(const ns_spectral_t *s, const float *spec, float *power) {
+    uint32_t half = s->fftLen / 2;
+
+    arm_cmplx_mag_squared_f32((float32_t *)spec, power, half);
+    power[0] = 0.5f * spec[0] * spec[0];
+    power[half] = 0.5f * spec[1] * spec[1];
+}
+
+static uint32_t ns_spectral_peak(const ns_spectral_t *s, const float *power) {
+    float32_t peak;
+    uint32_t index;
+
+    arm_max_f32((float32_t *)power + s->binMin, s->binMax - s->binMin + 1, &peak, &index);
+    return s->binMin + index;
+}
+
+static void ns_spectral_bands(const ns_spectral_t *s, const float *power, float *out) {
+    uint32_t limit = s->fftLen / 2 + 1;
+
+    for (uint32_t b = 0; b < s->numBands; b++) {
+        uint32_t lo = MIN(ns_spectral_hz_to_bin(s, s->bands[b].lowHz), limit);
+        uint32_t hi = MIN(ns_spectral_hz_to_bin(s, s->bands[b].highHz), limit);
+        float sum = 0.0f;
+        for (uint32_t k = lo; k < hi; k++) {
+            sum += power[k];
+        }
+        out[b] = sum * s->powerScale;
+    }
+}
+
+void ns_spectral_analyze(ns_spectral_t *s) {
+    float *frame = s->work;                    // fftLen, windowed samples then power
+    float *spec = s->work + s->fftLen;         // fftLen, packed spectrum
+    float *sum = s->work + 2 * s->fftLen;      // fftLen, summed spectrum or windowed channel
+    uint32_t pad = s->fftLen - s->windowLen;
+    const float *ring = s->rings;
+
+    if ((s->numBands == 0) && (s->channelHz == NULL)) {
+        // Only the summed spectrum is needed: sum the windowed channels and run one FFT
+        ns_spectral_window(s, ring, frame);
+        for (uint32_t ch = 1; ch < s->numChannels; ch++) {
+            ring += s->windowLen;
+            ns_spectral_window(s, ring, sum);
+            arm_add_f32(frame, sum, frame, s->windowLen);
+        }
+        arm_fill_f32(0.0f, frame + s->windowLen, pad);
+        arm_rfft_fast_f32(&s->fft, frame, spec, 0);
+    } else {
+        arm_fill_f32(0.0f, sum, s->fftLen);
+        for (uint32_t ch = 0; ch < s->numChannels; ch++, ring += s->windowLen) {
+            ns_spectral_window(s, ring, frame);
+            arm_fill_f32(0.0f, frame + s->windowLen, pad);
+            arm_rfft_fast_f32(&s->fft, frame, spec, 0);
+            arm_add_f32(sum, spec, sum, s->fftLen);
+
+            // The FFT is done with frame, reuse it for the channel's power spectrum
+            ns_spectral_power(s, spec, frame);
+            if (s->numBands != 0) {
+                ns_spectral_bands(s, frame, s->bandPower + ch * s->numBands);
+            }
+            if (s->channelHz != NULL) {
+                s->channelHz[ch] = ns_spectral_bin_hz(s, ns_spectral_peak(s, frame));
+            }
+        }
+        spec = sum;
+    }
+
+    ns_spectral_power(s, spec, frame);
+    uint32_t peak = ns_spectral_peak(s, frame);
+    s->dominantHz = ns_spectral_bin_hz(s, peak);
+    s->dominantPower = frame[peak] * s->powerScale;
+    s->analyses++;
+
+    if (s->callback != NULL) {
+        s->callback(s, s->callbackCtx);
+    }
+}
+
+uint32_t ns_spectral_process(ns_spectral_t *s, const float *frames, uint32_t numFrames) {
+    uint32_t ran = 0;
+
+    while (numFrames != 0) {
+        // Stop at the end of the rings and at the next analysis
+        uint32_t n = MIN(numFrames, (uint32_t)(s->windowLen - s->pos));
+        n = MIN(n, (uint32_t)(s->hopLen - s->sinceHop));
+
+        // Sample-major FIFO layout to channel-major rings
+        for (uint32_t ch = 0; ch < s->numChannels; ch++) {
+            float *dst = s->rings + ch * s->windowLen + s->pos;
+            const float *src = frames + ch;
+            for (uint32_t i = 0; i < n; i++) {
+                dst[i] = src[i * s->numChannels];
+            }
+        }
+        frames += n * s->numChannels;
+        numFrames -= n;
+
+        s->pos += n;
+        if (s->pos == s->windowLen) {
+            s->pos = 0;
+        }
+        s->samples = MIN(s->samples + n, (uint32_t)s->windowLen);
+        s->sinceHop += n;
+        if (s->sinceHop == s->hopLen) {
+            s->sinceHop = 0;
+            if (s->samples == s->windowLen) {
+                ns_spectral_analyze(s);
+                ran++;
+            }
+        }
+    }
+    return ran;
+}
+
+uint32_t ns_spectral_sched_init(ns_spectral_sched_t *q) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (q == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((q->spectral == NULL) || (q->fifo == NULL) || (q->batch == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    q->count = 0;
+    q->wakeups = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+bool ns_spectral_sched_push(ns_spectral_sched_t *q, const float *frame) {
+    uint32_t numChannels = q->spectral->numChannels;
+
+    memcpy(q->fifo + q->count * numChannels, frame, numChannels * sizeof(float));
+    if (++q->count < q->batch) {
+        return false;
+    }
+    q->count = 0;
+    q->wakeups++;
+    ns_spectral_process(q->spectral, q->fifo, q->batch);
+    return true;
+}
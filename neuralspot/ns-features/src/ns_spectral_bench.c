@@ -0,0 +1,75 @@
+/**
+ * @file ns_spectral_bench.c
+ * @author Ambiq
+ * @brief Processing cost of ns_spectral for a set of FIFO watermarks
+ * @version 0.1
+ * @date 2025-08-04
+ *
+ * Builds on the host (clock() as the counter) as well as on target (DWT->CYCCNT).
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_spectral.h"
+#include <math.h>
+
+#ifndef PI
+    #define PI 3.14159265358979f
+#endif
+
+// Synthetic sample: one tone per channel, spread over the lower half of the band
+static float ns_spectral_bench_sample(const ns_spectral_t *s, uint32_t ch, uint32_t n) {
+    float hz = s->sampleRate * (0.05f + 0.2f * (float)(ch % 4) / 4.0f);
+    return sinf(2.0f * PI * hz * n / s->sampleRate + 0.3f * ch);
+}
+
+uint32_t ns_spectral_benchmark(
+    ns_spectral_t *s, float *fifo, const uint16_t *batches, uint32_t numBatches, uint32_t seconds,
+    ns_spectral_counter_cb counter, ns_spectral_bench_result_t *results) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (s == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((fifo == NULL) || (batches == NULL) || (counter == NULL) || (results == NULL) ||
+        (seconds == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    for (uint32_t b = 0; b < numBatches; b++) {
+        if (batches[b] == 0) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    }
+#endif
+
+    uint32_t total = (uint32_t)(s->sampleRate * seconds);
+
+    for (uint32_t b = 0; b < numBatches; b++) {
+        ns_spectral_bench_result_t *r = &results[b];
+        uint64_t elapsed = 0;
+
+        ns_spectral_reset(s);
+        r->batch = batches[b];
+        r->wakeups = 0;
+
+        for (uint32_t n = 0; n < total; n += r->batch) {
+            uint32_t count = MIN((uint32_t)r->batch, total - n);
+
+            // The sensor fills its FIFO while the processor sleeps, not counted
+            for (uint32_t i = 0; i < count; i++) {
+                for (uint32_t ch = 0; ch < s->numChannels; ch++) {
+                    fifo[i * s->numChannels + ch] = ns_spectral_bench_sample(s, ch, n + i);
+                }
+            }
+
+            uint32_t start = counter();
+            ns_spectral_process(s, fifo, count);
+            elapsed += (uint32_t)(counter() - start);
+            r->wakeups++;
+        }
+        r->analyses = s->analyses;
+        r->cyclesPerChannelSecond = (float)elapsed / ((float)s->numChannels * seconds);
+    }
+    ns_spectral_reset(s);
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,271 @@
+#include "ns_spectral_tests.h"
+#include "unity/unity.h"
+#include <math.h>
+#include <time.h>
+
+#define TEST_CHANNELS 4
+#define TEST_WINDOW 250
+#define TEST_FFT 256
+#define TEST_HOP 25
+#define TEST_RATE 25.0f
+#define TEST_MAX_BATCH 25
+#define TEST_PI 3.14159265358979f
+
+static float rings[TEST_CHANNELS * TEST_WINDOW];
+static float window[TEST_WINDOW];
+static float work[NS_SPECTRAL_WORK_SIZE(TEST_FFT)];
+static float bandPower[TEST_CHANNELS * 2];
+static float channelHz[TEST_CHANNELS];
+static float frames[TEST_WINDOW * 4 * TEST_CHANNELS];
+static float fifo[TEST_MAX_BATCH * TEST_CHANNELS];
+
+static const ns_spectral_band_t bands[2] = {{.lowHz = 0.5f, .highHz = 3.0f},
+                                            {.lowHz = 3.0f, .highHz = 8.0f}};
+
+static ns_spectral_t spectral;
+
+// Dominant bin power of every analysis, reported through the callback
+static float history[64];
+static uint32_t historyLen;
+
+static void record(ns_spectral_t *s, void *ctx) {
+    if (historyLen < 64) {
+        history[historyLen++] = s->dominantPower;
+    }
+}
+
+static void spectral_config(uint16_t numChannels) {
+    memset(&spectral, 0, sizeof(spectral));
+    spectral.api = &ns_spectral_V0_0_1;
+    spectral.numChannels = numChannels;
+    spectral.windowLen = TEST_WINDOW;
+    spectral.fftLen = TEST_FFT;
+    spectral.hopLen = TEST_HOP;
+    spectral.sampleRate = TEST_RATE;
+    spectral.rings = rings;
+    spectral.window = window;
+    spectral.work = work;
+    spectral.callback = record;
+    historyLen = 0;
+}
+
+// Tone at an exact bin on channel 0, weaker tones at other bins on the remaining channels
+static void make_frames(uint32_t numFrames, uint16_t numChannels, float hz) {
+    for (uint32_t n = 0; n < numFrames; n++) {
+        for (uint32_t ch = 0; ch < numChannels; ch++) {
+            float f = (ch == 0) ? hz : 1.0f + 0.5f * ch;
+            float a = (ch == 0) ? 1.0f : 0.2f;
+            frames[n * numChannels + ch] = a * sinf(2.0f * TEST_PI * f * n / TEST_RATE + ch);
+        }
+    }
+}
+
+static float bin_hz(uint32_t bin) { return bin * TEST_RATE / TEST_FFT; }
+
+static uint32_t bench_counter(void) { return (uint32_t)clock(); }
+
+void ns_spectral_tests_pre_test_hook() { spectral_config(TEST_CHANNELS); }
+
+void ns_spectral_tests_post_test_hook() {}
+
+void ns_spectral_init_validation_test() {
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_spectral_init(NULL));
+
+    spectral_config(1);
+    spectral.api = &ns_spectral_oldest_supported_version;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+
+    spectral_config(1);
+    spectral.api = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_spectral_init(&spectral));
+
+    spectral_config(1);
+    spectral.fftLen = 300; // not a power of two
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_spectral_init(&spectral));
+
+    spectral_config(1);
+    spectral.fftLen = 128; // shorter than the window
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_spectral_init(&spectral));
+
+    spectral_config(1);
+    spectral.hopLen = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_spectral_init(&spectral));
+
+    spectral_config(1);
+    spectral.numBands = 2; // no bands or output
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_spectral_init(&spectral));
+
+    spectral_config(1);
+    spectral.minHz = 8.0f;
+    spectral.maxHz = 4.0f;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_spectral_init(&spectral));
+}
+
+void ns_spectral_channel_major_rings_test() {
+    spectral_config(3);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+
+    for (uint32_t n = 0; n < 10; n++) {
+        for (uint32_t ch = 0; ch < 3; ch++) {
+            frames[n * 3 + ch] = (float)(ch * 1000 + n);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, ns_spectral_process(&spectral, frames, 10));
+    for (uint32_t ch = 0; ch < 3; ch++) {
+        for (uint32_t n = 0; n < 10; n++) {
+            TEST_ASSERT_EQUAL_FLOAT((float)(ch * 1000 + n), rings[ch * TEST_WINDOW + n]);
+        }
+    }
+    TEST_ASSERT_EQUAL(10, spectral.pos);
+}
+
+void ns_spectral_dominant_frequency_test() {
+    spectral_config(1);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+
+    make_frames(TEST_WINDOW, 1, bin_hz(40));
+    TEST_ASSERT_EQUAL(1, ns_spectral_process(&spectral, frames, TEST_WINDOW));
+    TEST_ASSERT_EQUAL_FLOAT(bin_hz(40), spectral.dominantHz);
+    // The Hann window spreads the tone's 0.5 over the peak bin and its neighbours
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.5f * 2.0f / 3.0f, spectral.dominantPower);
+
+    // Restricting the search range hides the tone
+    spectral_config(1);
+    spectral.maxHz = 3.0f;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+    ns_spectral_process(&spectral, frames, TEST_WINDOW);
+    TEST_ASSERT_TRUE(spectral.dominantHz <= 3.0f);
+}
+
+void ns_spectral_summed_matches_per_channel_test() {
+    float summedHz, summedPower;
+
+    make_frames(TEST_WINDOW, TEST_CHANNELS, bin_hz(52));
+
+    // Summed spectrum only, one FFT per analysis
+    spectral_config(TEST_CHANNELS);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+    TEST_ASSERT_EQUAL(1, ns_spectral_process(&spectral, frames, TEST_WINDOW));
+    summedHz = spectral.dominantHz;
+    summedPower = spectral.dominantPower;
+    TEST_ASSERT_EQUAL_FLOAT(bin_hz(52), summedHz);
+
+    // Per channel outputs, one FFT per channel
+    spectral_config(TEST_CHANNELS);
+    spectral.channelHz = channelHz;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+    TEST_ASSERT_EQUAL(1, ns_spectral_process(&spectral, frames, TEST_WINDOW));
+    TEST_ASSERT_EQUAL_FLOAT(summedHz, spectral.dominantHz);
+    TEST_ASSERT_FLOAT_WITHIN(summedPower * 1e-3f, summedPower, spectral.dominantPower);
+
+    TEST_ASSERT_EQUAL_FLOAT(bin_hz(52), channelHz[0]);
+    for (uint32_t ch = 1; ch < TEST_CHANNELS; ch++) {
+        TEST_ASSERT_FLOAT_WITHIN(bin_hz(1), 1.0f + 0.5f * ch, channelHz[ch]);
+    }
+}
+
+void ns_spectral_band_power_test() {
+    spectral_config(TEST_CHANNELS);
+    spectral.bands = bands;
+    spectral.numBands = 2;
+    spectral.bandPower = bandPower;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+
+    // Channel 0 at 5 Hz (band 1), channels 1 to 3 at 1.5, 2 and 2.5 Hz (band 0)
+    make_frames(TEST_WINDOW, TEST_CHANNELS, 5.0f);
+    TEST_ASSERT_EQUAL(1, ns_spectral_process(&spectral, frames, TEST_WINDOW));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, bandPower[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.5f, bandPower[1]);
+    for (uint32_t ch = 1; ch < TEST_CHANNELS; ch++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.02f, bandPower[ch * 2]);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, bandPower[ch * 2 + 1]);
+    }
+}
+
+void ns_spectral_batching_invariance_test() {
+    const uint32_t batches[] = {1, 5, 7, 25, 250, 1000};
+    const uint32_t total = TEST_WINDOW * 4;
+    float reference[64];
+    uint32_t referenceLen = 0;
+
+    make_frames(total, TEST_CHANNELS, bin_hz(30));
+    for (uint32_t i = 0; i < 250; i++) {
+        // Ramp channel 0 up over the last window so consecutive analyses differ
+        frames[(total - 1 - i) * TEST_CHANNELS] *= 1.0f + (250 - i) / 100.0f;
+    }
+
+    for (uint32_t b = 0; b < sizeof(batches) / sizeof(batches[0]); b++) {
+        spectral_config(TEST_CHANNELS);
+        spectral.channelHz = channelHz;
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+
+        uint32_t ran = 0;
+        for (uint32_t n = 0; n < total; n += batches[b]) {
+            uint32_t count = MIN(batches[b], total - n);
+            ran += ns_spectral_process(&spectral, frames + n * TEST_CHANNELS, count);
+        }
+        // First analysis once the window is full, then every hop
+        TEST_ASSERT_EQUAL(1 + (total - TEST_WINDOW) / TEST_HOP, ran);
+        TEST_ASSERT_EQUAL(ran, historyLen);
+
+        if (b == 0) {
+            memcpy(reference, history, sizeof(reference));
+            referenceLen = historyLen;
+        } else {
+            TEST_ASSERT_EQUAL(referenceLen, historyLen);
+            TEST_ASSERT_EQUAL_FLOAT_ARRAY(reference, history, historyLen);
+        }
+    }
+}
+
+void ns_spectral_sched_wakeup_test() {
+    ns_spectral_sched_t sched = {.spectral = &spectral, .fifo = fifo, .batch = 5};
+    uint32_t wakeups = 0;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_sched_init(&sched));
+
+    make_frames(TEST_WINDOW + 2 * TEST_HOP, TEST_CHANNELS, bin_hz(20));
+    for (uint32_t n = 0; n < TEST_WINDOW + 2 * TEST_HOP; n++) {
+        bool woke = ns_spectral_sched_push(&sched, frames + n * TEST_CHANNELS);
+        TEST_ASSERT_EQUAL((n % 5) == 4, woke);
+        wakeups += woke;
+    }
+    TEST_ASSERT_EQUAL((TEST_WINDOW + 2 * TEST_HOP) / 5, wakeups);
+    TEST_ASSERT_EQUAL(wakeups, sched.wakeups);
+    TEST_ASSERT_EQUAL(3, spectral.analyses);
+    TEST_ASSERT_EQUAL_FLOAT(bin_hz(20), spectral.dominantHz);
+
+    sched.batch = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_spectral_sched_init(&sched));
+}
+
+void ns_spectral_benchmark_test() {
+    // The MODE_25HZ, MODE_5HZ and MODE_1HZ wakeup rates of the algo experiment
+    const uint16_t batches[] = {1, 5, 25};
+    ns_spectral_bench_result_t results[3];
+    const uint32_t seconds = 20;
+
+    spectral.channelHz = channelHz;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_spectral_init(&spectral));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_spectral_benchmark(&spectral, fifo, batches, 3, seconds, bench_counter, results));
+
+    for (uint32_t b = 0; b < 3; b++) {
+        TEST_ASSERT_EQUAL(batches[b], results[b].batch);
+        TEST_ASSERT_EQUAL((uint32_t)(TEST_RATE * seconds) / batches[b], results[b].wakeups);
+        TEST_ASSERT_EQUAL(1 + (TEST_RATE * seconds - TEST_WINDOW) / TEST_HOP, results[b].analyses);
+        TEST_ASSERT_TRUE(results[b].cyclesPerChannelSecond >= 0.0f);
+        ns_lp_printf(
+            "K=%2d: %4d wakeups, %2d analyses, %.1f ticks/channel-second\n", results[b].batch,
+            results[b].wakeups, results[b].analyses, results[b].cyclesPerChannelSecond);
+    }
+    // The analyzer is left reset
+    TEST_ASSERT_EQUAL(0, spectral.analyses);
+
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_spectral_benchmark(&spectral, fifo, batches, 3, seconds, NULL, results));
+}
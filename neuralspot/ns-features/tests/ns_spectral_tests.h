@@ -0,0 +1,13 @@
+#include "ns_spectral.h"
+#include "ns_core.h"
+
+void ns_spectral_tests_pre_test_hook();
+void ns_spectral_tests_post_test_hook();
+void ns_spectral_init_validation_test();
+void ns_spectral_channel_major_rings_test();
+void ns_spectral_dominant_frequency_test();
+void ns_spectral_summed_matches_per_channel_test();
+void ns_spectral_band_power_test();
+void ns_spectral_batching_invariance_test();
+void ns_spectral_sched_wakeup_test();
+void ns_spectral_benchmark_test();
@@ -19,6 +19,9 @@ limitations under the License.
 #include "ns_timer.h"
 #ifdef AM_PART_APOLLO5B
 #include "ns_pmu_utils.h"
+#include "ns_pmu_mux.h"
+#include "ns_pmu_metrics.h"
+#include "ns_timer_wheel.h"
 #endif
 
 #ifdef __cplusplus
@@ -88,6 +91,9 @@ typedef struct {
     const ns_perf_mac_count_t *m;
     uint32_t estimated_mac_count[NS_PROFILER_MAX_EVENTS];
     uint32_t captured_event_num; ///< How many events have been captured so far
+    #ifdef AM_PART_APOLLO5B
+    ns_pmu_mux_t *pmu_mux; ///< Set when characterizing in sampling mode
+    #endif
 } ns_profiler_sidecar_t;
 
 #ifdef NS_MLPROFILE
@@ -105,6 +111,9 @@ typedef struct {
     const ns_perf_mac_count_t *m;
     #ifdef AM_PART_APOLLO5B
     ns_pmu_config_t *pmu;
+    ns_pmu_mux_t *mux;        ///< Optional, enables sampling mode in ns_characterize_model
+    ns_timer_wheel_t *wheel;  ///< Optional, drives mux rotation every muxSliceUs
+    uint32_t muxSliceUs;
     #endif
 } ns_debug_log_init_t;
 
@@ -118,6 +127,10 @@ extern uint32_t ns_get_layer_counters(uint32_t layer,
                       uint32_t num_layers,
                       uint32_t rv,
                       uint32_t *out_counters);
+extern uint32_t ns_get_layer_metrics(uint32_t layer,
+                      uint32_t num_layers,
+                      uint32_t rv,
+                      ns_pmu_metrics_t *metrics);
 #endif // AM_PART_APOLLO5B
 #ifdef __cplusplus
 } // extern "C"
@@ -36,6 +36,9 @@ ns_cache_config_t ns_microProfiler_cache_config;
 #ifdef AM_PART_APOLLO5B
 ns_pmu_config_t ns_microProfilerPMU;
 AM_SHARED_RW char ns_profiler_pmu_header[2048];
+static ns_timer_wheel_t *ns_microProfilerWheel = NULL;
+static ns_timer_wheel_timer_t ns_microProfilerSliceTimer;
+static uint32_t ns_microProfilerSliceUs = 0;
 #endif  // AM_PART_APOLLO5B
 AM_SHARED_RW ns_profiler_sidecar_t ns_microProfilerSidecar;
 AM_SHARED_RW ns_profiler_event_stats_t ns_profiler_events_stats[NS_PROFILER_RPC_EVENTS_MAX];
@@ -73,6 +76,18 @@ ns_TFDebugLogInit(ns_debug_log_init_t *cfg) {
         memcpy(&ns_microProfilerPMU, cfg->pmu, sizeof(ns_pmu_config_t));
         am_util_pmu_enable();
     }
+    // Sampling mode: all events in one run, rotated by the mux
+    ns_microProfilerSidecar.pmu_mux = NULL;
+    if (cfg->mux != NULL) {
+        if (ns_pmu_mux_init(cfg->mux) == NS_STATUS_SUCCESS) {
+            ns_microProfilerSidecar.pmu_mux = cfg->mux;
+            am_util_pmu_enable();
+        } else {
+            ns_lp_printf("PMU mux init failed, using rerun characterization\n");
+        }
+    }
+    ns_microProfilerWheel = cfg->wheel;
+    ns_microProfilerSliceUs = cfg->muxSliceUs;
     #else
     ns_microProfiler_cache_config.enable = true;
     ns_cache_profiler_init(&ns_microProfiler_cache_config);
@@ -81,16 +96,49 @@ ns_TFDebugLogInit(ns_debug_log_init_t *cfg) {
 #endif
 }
 
+#ifdef NS_MLPROFILE
+#ifdef AM_PART_APOLLO5B
+static void ns_pmu_mux_slice_cb(ns_timer_wheel_timer_t *timer, void *arg) {
+    ns_pmu_mux_rotate((ns_pmu_mux_t *)arg);
+}
+#endif // AM_PART_APOLLO5B
+#endif // NS_MLPROFILE
+
 /**
- * @brief Given a model, characterize it by running it repeatedly and capturing PMU events.
- * 
- * 
- * @return uint32_t 
+ * @brief Given a model, characterize it by capturing PMU events for every layer.
+ *
+ * If a PMU mux was passed to ns_TFDebugLogInit, the model is run once while the mux rotates
+ * through its event groups (every muxSliceUs if a timer wheel was passed, and at every layer
+ * boundary), and counts are scaled by the time each group was active. Otherwise the model
+ * is run once for every 4 events in ns_pmu_map.
+ *
+ * @return uint32_t
  */
 uint32_t ns_characterize_model(invoke_fp func) {
-    // Repeatedly run the model, capturing different PMU every time.
 #ifdef NS_MLPROFILE
 #ifdef AM_PART_APOLLO5B
+    ns_pmu_mux_t *mux = ns_microProfilerSidecar.pmu_mux;
+    if (mux != NULL) {
+        ns_lp_printf("Starting model characterization, sampling %d PMU events per layer\n",
+                     mux->numEvents);
+        ns_pmu_mux_reset(mux);
+        ns_pmu_mux_start(mux);
+        if ((ns_microProfilerWheel != NULL) && (ns_microProfilerSliceUs != 0)) {
+            ns_microProfilerSliceTimer.callback = ns_pmu_mux_slice_cb;
+            ns_microProfilerSliceTimer.arg = mux;
+            ns_timer_wheel_start(ns_microProfilerWheel, &ns_microProfilerSliceTimer,
+                                 ns_microProfilerSliceUs, ns_microProfilerSliceUs);
+        }
+        func();
+        if (ns_microProfilerWheel != NULL) {
+            ns_timer_wheel_stop(ns_microProfilerWheel, &ns_microProfilerSliceTimer);
+        }
+        ns_pmu_mux_stop(mux);
+        ns_lp_printf(".");
+        return NS_STATUS_SUCCESS;
+    }
+
+    // Rerun mode: run the model repeatedly, capturing different PMU every time.
     uint32_t map_index = 0;
     ns_lp_printf("Starting model characterization, capturing %d (%d/%d) PMU events per layer\n", NS_NUM_PMU_MAP_SIZE, g_ns_pmu_map_length, sizeof(ns_pmu_map_t));
     for (map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index = map_index + 4) {
@@ -145,6 +193,37 @@ find_call_once_layer(uint32_t num_layers)
     }
     return -1;
 }
+
+/**
+ * @brief Value of a PMU event for a (source) layer, from whichever mode characterized the model
+ *
+ * @return false if the event wasn't captured
+ */
+static bool
+ns_get_source_layer_event(uint32_t source_layer, uint32_t num_layers, uint32_t rv,
+                          uint32_t eventId, uint32_t *value)
+{
+    ns_pmu_mux_t *mux = ns_microProfilerSidecar.pmu_mux;
+    uint32_t slot;
+    *value = 0;
+    if (mux != NULL) {
+        for (uint32_t i = 0; i < mux->numEvents; i++) {
+            if (mux->eventIds[i] == eventId) {
+                return ns_pmu_mux_estimate(mux, source_layer, i, value) == NS_STATUS_SUCCESS;
+            }
+        }
+        return false;
+    }
+    for (uint32_t map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++) {
+        if (ns_pmu_map[map_index].eventId == eventId) {
+            uint32_t index =
+                ns_pmu_rerun_snapshot_index(source_layer, num_layers, rv, map_index, &slot);
+            *value = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[slot];
+            return true;
+        }
+    }
+    return false;
+}
 #endif // AM_PART_APOLLO5B
 #endif // NS_MLPROFILE
 
@@ -173,21 +252,17 @@ uint32_t ns_set_pmu_header(void) {
 /**
  * @brief  Retrieves PMU counters for a given layer.
  *
- * This function determines if the 
- * layer is within a "skip" range for PMU counters (related to CALL_ONCE), then 
- * either returns zeros or calculates the counters based on the "non-obvious" index 
- * formula:
+ * In sampling mode (a PMU mux was configured) the counters are the mux's time-scaled
+ * estimates; events the mux wasn't asked to capture read as 0.
  *
- * \code
- *   index = (num_layers + source_layer) + (source_layer_count) * (map_index / 4);
- *   counterValue = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[ map_index % 4 ];
- * \endcode
+ * In rerun mode the counters are read from the snapshots of the repeated runs. Layers that
+ * only ran in the first run (after a CALL_ONCE layer, see ns_pmu_rerun_source_layer) return
+ * zeros, and the rest are located with ns_pmu_rerun_snapshot_index.
  *
  * @param[in]  layer         The layer index for which PMU values are requested.
  * @param[in]  num_layers    Total layers in the pipeline.
  * @param[in]  rv            Number of "resource variables" used to offset certain layers.
- * @param[out] out_counters  Pointer to an array in which to store the retrieved counter values.
- * @param[in]  max_counters  Size of the out_counters array (e.g. number of PMU registers).
+ * @param[out] out_counters  Array of NS_NUM_PMU_MAP_SIZE counter values, in ns_pmu_map order.
  *
  * @return NS_STATUS_SUCCESS on success. Could return an error code if desired.
  */
@@ -199,50 +274,59 @@ ns_get_layer_counters(uint32_t layer,
 {
 #ifdef NS_MLPROFILE
 #ifdef AM_PART_APOLLO5B
-    // 1. Find if a CALL_ONCE layer exists
-    int32_t call_once_layer = find_call_once_layer(num_layers);
-    // ns_lp_printf("[INFO] NS_GET_LAYER_COUNTERS: CALL_ONCE %d, layer %d num_layers %d, rv %d\n", call_once_layer, layer, num_layers, rv);
-
-    // 2. If found, figure out if the requested layer is in the skip region
-    //    The skip region is: call_once_layer < layer <= (call_once_layer + rv*2)
-    //    as per the snippet logic
-    if (call_once_layer != -1 &&
-        (layer > (uint32_t)call_once_layer) &&
-        (layer <= (uint32_t)(call_once_layer + rv * 2)))
-    {
-        //  Return all zeros for these "skipped" layers
-        for (uint32_t i = 0; i < NS_NUM_PMU_MAP_SIZE; i++)
-        {
-            out_counters[i] = 0;
+    uint32_t source_layer;
+    bool has_counters =
+        ns_pmu_rerun_source_layer(layer, rv, find_call_once_layer(num_layers), &source_layer);
+
+    for (uint32_t map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++) {
+        out_counters[map_index] = 0;
+        if (has_counters) {
+            ns_get_source_layer_event(source_layer, num_layers, rv, ns_pmu_map[map_index].eventId,
+                                      &out_counters[map_index]);
         }
-        // ns_lp_printf("Layer %d is in the skip region, returning zeros\n", layer);
-        return NS_STATUS_SUCCESS;
     }
+#endif
+#endif
 
-    // 3. Otherwise, proceed with the "source layer" calculation
-    //    We also define source_layer_count = num_layers - rv*2
-    uint32_t source_layer_count = num_layers - rv * 2;
-
-    // 4. Determine the actual "source_layer" for reading PMU counters
-    //    (some layers are offset by rv*2 if after the skip region)
-    uint32_t source_layer = layer;
-    if (call_once_layer != -1 && layer > (uint32_t)(call_once_layer + rv * 2))
-    {
-        source_layer = layer - rv * 2;
-    }
-    // ns_lp_printf("Layer %d, source layer %d, source layer count %d\n", layer, source_layer, source_layer_count);
+    return NS_STATUS_SUCCESS;
+}
 
-    // 5. For each PMU counter index (map_index), compute the "non-obvious" index
-    //    and extract the PMU counter from the sidecar
-    for (uint32_t map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++)
-    {
-        // index formula from the snippet
-        uint32_t index = (num_layers + source_layer) + source_layer_count * (map_index / 4);
-        // retrieve the PMU snapshot (mocked by g_ns_microProfilerSidecar)
-        uint32_t counterValue = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[map_index % 4];
-        // ns_lp_printf("Layer %d, map_index %d, index %d, counterValue %d\n", layer, map_index, index, counterValue);
-        out_counters[map_index] = counterValue;
+/**
+ * @brief  Derived metrics (IPC, MVE beat utilization, load/store stalls, MPKI and roofline
+ * class) for a given layer.
+ *
+ * Works in both characterization modes, as long as the events in ns_pmu_metrics_events were
+ * captured. Metrics whose events are missing are left out of metrics->valid.
+ *
+ * @param[in]  layer       The layer index
+ * @param[in]  num_layers  Total layers in the pipeline.
+ * @param[in]  rv          Number of "resource variables"
+ * @param[out] metrics
+ *
+ * @return NS_STATUS_SUCCESS on success.
+ */
+uint32_t
+ns_get_layer_metrics(uint32_t layer,
+                     uint32_t num_layers,
+                     uint32_t rv,
+                     ns_pmu_metrics_t *metrics)
+{
+#ifdef NS_MLPROFILE
+#ifdef AM_PART_APOLLO5B
+    ns_pmu_sample_t samples[NS_PMU_METRICS_NUM_EVENTS];
+    uint32_t num_samples = 0;
+    uint32_t source_layer;
+
+    if (ns_pmu_rerun_source_layer(layer, rv, find_call_once_layer(num_layers), &source_layer)) {
+        for (uint32_t i = 0; i < NS_PMU_METRICS_NUM_EVENTS; i++) {
+            samples[num_samples].eventId = ns_pmu_metrics_events[i];
+            if (ns_get_source_layer_event(source_layer, num_layers, rv, ns_pmu_metrics_events[i],
+                                          &samples[num_samples].value)) {
+                num_samples++;
+            }
+        }
     }
+    ns_pmu_metrics_compute(samples, num_samples, NULL, metrics);
 #endif
 #endif
 
@@ -252,25 +336,10 @@ ns_get_layer_counters(uint32_t layer,
 /**
  * @brief     Parses and prints performance monitoring unit (PMU) statistics for each layer.
  *
- * This function retrieves PMU counter values from a global profiler sidecar and prints them
- * in a CSV-like format for external analysis. It supports the concept of a "CALL_ONCE" layer,
- * whereby certain layers are "skipped" on subsequent runs (and thus display zero counters).
- *
- * The high-level logic:
- *  1) Search for a layer tagged as "CALL_ONCE". If found, record its index.
- *  2) Print CSV headers, including names of PMU registers.
- *  3) For each layer:
- *     - Print basic profiling data (layer index, tag, time, estimated MACs).
- *     - Print detailed sidecar information (e.g., output shape, filter shape, strides).
- *     - Determine if the layer is in the "skipped" region. If so, print zeros.
- *       Otherwise, compute a non-obvious index for accessing PMU counters and print them.
- *
- * The non-obvious indexing formula for the PMU counters follows:
- * @code
- *     // source_layer is either the current layer or offset by rv*2 if we are beyond the skip region
- *     uint32_t index = (num_layers + source_layer) + (num_layers - rv * 2) * (map_index / 4);
- *     uint32_t counterValue = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[ map_index % 4 ];
- * @endcode
+ * This function retrieves PMU counter values (see ns_get_layer_counters) and prints them
+ * in a CSV-like format for external analysis, followed by the derived metrics of
+ * ns_get_layer_metrics. It supports the concept of a "CALL_ONCE" layer, whereby certain
+ * layers are "skipped" on subsequent runs (and thus display zero counters).
  *
  * Skipped region logic:
  *   - If a CALL_ONCE layer is present at index C, then any layer in the range
@@ -285,50 +354,37 @@ ns_get_layer_counters(uint32_t layer,
 uint32_t ns_parse_pmu_stats(uint32_t num_layers, uint32_t rv) {
 #ifdef NS_MLPROFILE
 #ifdef AM_PART_APOLLO5B
-    char name[50];
     uint32_t map_index = 0;
-    int call_once_layer = -1;
-    uint32_t source_layer = 0; // The source of the PMU data starts from the second run, so we need to offset the layer index
-                               // it increments by (num_layers-28) for each pmu block
-    // uint32_t rv = model.rv_count;
-    uint32_t source_layer_count = num_layers - rv*2;
-    // Once PMU data is collected using ns_characterize_model, parse it and print it out in CSV format
-    
-    // Adjust for CALL_ONCE layers. The heuristic is this (IMPORTANT: not widely tested):
-    // If a CALL_ONCE layer is present:
-    //   - All layers before it are run normally, as is the CALL_ONCE layer
-    //   - RV*2 layers are skipped (RV - number of resource variables) on subsequent runs
-    //   - The number of layers captured per run is num_layers minus RV*2
-
-    // Search layer tags for the CALL_ONCE layer
-    for (uint32_t i = 0; i < num_layers; i++) {
-        if (strcmp(ns_profiler_events_stats[i].tag, "CALL_ONCE") == 0) {
-            call_once_layer = i;
-            break;
-        }
-    }
+    uint32_t source_layer;
+    uint32_t counter_value;
+    ns_pmu_metrics_t metrics;
+    int32_t call_once_layer = find_call_once_layer(num_layers);
+
     if (call_once_layer != -1) {
         ns_lp_printf("CALL_ONCE layer found at layer %d\n", call_once_layer);
-    } 
-
-
-    ns_lp_printf("Number of layers: %d, RV: %d, Source layer count: %d\n", num_layers, rv, source_layer_count);
+    }
+    if (ns_microProfilerSidecar.pmu_mux != NULL) {
+        ns_lp_printf("Number of layers: %d, RV: %d, sampled over %d mux rotations\n", num_layers,
+                     rv, ns_microProfilerSidecar.pmu_mux->rotations);
+    } else {
+        ns_lp_printf("Number of layers: %d, RV: %d, Source layer count: %d\n", num_layers, rv,
+                     num_layers - rv * 2);
+    }
     ns_lp_printf("\n");
     ns_delay_us(10000);
 
     // Start with the header
-    ns_lp_printf("\"Event\",\"Tag\",\"uSeconds\",\"Est MACs\",\"MAC Eq\",\"Output Mag\",\"Output Shape\",\"Filter Shape\", \"Stride H\", \"Stride W\", \"Dilation H\", \"Dilation W\""); 
+    ns_lp_printf("\"Event\",\"Tag\",\"uSeconds\",\"Est MACs\",\"MAC Eq\",\"Output Mag\",\"Output Shape\",\"Filter Shape\", \"Stride H\", \"Stride W\", \"Dilation H\", \"Dilation W\"");
     ns_delay_us(10000);
     for (map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++) {
-        strcpy(name, ns_pmu_map[map_index].regname);
-        ns_lp_printf(",\"%s\"", name); 
+        ns_lp_printf(",\"%s\"", ns_pmu_map[map_index].regname);
         ns_delay_us(10000);
     };
-    ns_lp_printf("\n");
+    ns_lp_printf(",\"IPC\",\"MVE Beat Util\",\"LDST Stall Ratio\",\"MPKI\",\"Bound\"\n");
 
     // Now the data
-    for (int print_layer = 0; print_layer < num_layers; print_layer++) {
-        
+    for (uint32_t print_layer = 0; print_layer < num_layers; print_layer++) {
+
         // Print event number, tag, time, and estimated MACs
         ns_lp_printf("%d, %s, %d, %d, ",
             print_layer,
@@ -340,45 +396,30 @@ uint32_t ns_parse_pmu_stats(uint32_t num_layers, uint32_t rv) {
                     ns_microProfilerSidecar.m->output_magnitudes[print_layer], ns_microProfilerSidecar.m->output_shapes[print_layer],
                     ns_microProfilerSidecar.m->filter_shapes[print_layer], ns_microProfilerSidecar.m->stride_h[print_layer],
                     ns_microProfilerSidecar.m->stride_w[print_layer], ns_microProfilerSidecar.m->dilation_h[print_layer],
-                    ns_microProfilerSidecar.m->dilation_w[print_layer]);               
-
-        // Print the PMU counters if not the call-once layers
-        if ((call_once_layer != -1) &&  (print_layer > call_once_layer) && (print_layer<=(rv*2 + call_once_layer))) {
-            // print zeros for all pmu values
-            for (map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++) {
-                ns_lp_printf(", 0");
-            }
-            // ns_lp_printf(", no pmu values");
-        } 
-        else {
-            for (map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++) {
-                // Fetch all the PMU counters for event i, spread out in the ns_profiler_events_stats[index].pmu_delta.counterValue array
-                // The index is  num_layers * (4/map_index), and counterValue index is map_index%4
-                if (call_once_layer == -1) {
-                    source_layer = print_layer;
-                } else if (print_layer > (rv*2 + call_once_layer)) {
-                    source_layer = print_layer - rv*2;
-                } else {
-                    source_layer = print_layer;
-                }
-                uint32_t index = (num_layers + source_layer) + source_layer_count * (map_index/4);
-                uint32_t counterValue = ns_microProfilerSidecar.pmu_snapshot[index].counterValue[map_index%4];
-                // ns_lp_printf(", (%d, %d, %d,)%u", index, map_index, source_layer, counterValue);
-                ns_lp_printf(", %u", counterValue);
-            // source_layer++;
+                    ns_microProfilerSidecar.m->dilation_w[print_layer]);
+
+        // Layers skipped after a CALL_ONCE layer print zeros
+        bool has_counters =
+            ns_pmu_rerun_source_layer(print_layer, rv, call_once_layer, &source_layer);
+        for (map_index = 0; map_index < NS_NUM_PMU_MAP_SIZE; map_index++) {
+            counter_value = 0;
+            if (has_counters) {
+                ns_get_source_layer_event(source_layer, num_layers, rv,
+                                          ns_pmu_map[map_index].eventId, &counter_value);
             }
+            ns_lp_printf(", %u", counter_value);
         }
-        // ns_delay_us(10000);
-        
-        ns_lp_printf("\n");
-    }   
+
+        ns_get_layer_metrics(print_layer, num_layers, rv, &metrics);
+        ns_lp_printf(", %0.3f, %0.3f, %0.3f, %0.2f, %s\n", metrics.ipc, metrics.mveBeatUtil,
+                     metrics.ldstStallRatio, metrics.mpki, ns_pmu_bound_name(metrics.bound));
+    }
 #endif
 #endif
     return NS_STATUS_SUCCESS;
 }
 
 
-
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
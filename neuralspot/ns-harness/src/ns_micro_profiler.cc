@@ -74,10 +74,13 @@ MicroProfiler::BeginEvent(const char *tag) {
     ns_reset_perf_counters();
     // #ifndef AM_PART_APOLLO5A
     #if defined(AM_PART_APOLLO5B)
-    // ns_pmu_get_counters(&(ns_microProfilerSidecar.pmu_snapshot[num_events_])); // this implicitly resets the counters
-    // ns_lp_printf("Start PMUs for %d (%s)\n", num_events_, tag);
-    ns_pmu_reset_counters();
-    capture_pmu_counters(&(ns_microProfilerSidecar.pmu_snapshot[num_events_])); // this implicitly resets the counters
+    if ((ns_microProfilerSidecar.pmu_mux != NULL) && ns_microProfilerSidecar.pmu_mux->running) {
+        // Sampling mode, the mux owns the PMU
+        ns_pmu_mux_layer_begin(ns_microProfilerSidecar.pmu_mux);
+    } else {
+        ns_pmu_reset_counters();
+        capture_pmu_counters(&(ns_microProfilerSidecar.pmu_snapshot[num_events_])); // this implicitly resets the counters
+    }
 
 
     #endif
@@ -116,6 +119,10 @@ MicroProfiler::EndEvent(uint32_t event_handle) {
                   &(ns_microProfilerSidecar.perf_snapshot[event_handle]));
     // ns_capture_cache_stats(&(ns_microProfilerSidecar.cache_end[event_handle]));
     #elif defined(AM_PART_APOLLO5B)
+    if ((ns_microProfilerSidecar.pmu_mux != NULL) && ns_microProfilerSidecar.pmu_mux->running) {
+        ns_pmu_mux_layer_end(ns_microProfilerSidecar.pmu_mux);
+        return;
+    }
     ns_pmu_counters_t pmu;
     // ns_lp_printf("End PMUs for %d\n", event_handle);
     capture_pmu_counters(&pmu);
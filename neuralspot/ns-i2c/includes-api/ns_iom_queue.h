@@ -0,0 +1,319 @@
+/**
+ * @file ns_iom_queue.h
+ * @author Ambiq
+ * @brief Asynchronous IOM (I2C/SPI) transaction queue with batched register access
+ * @version 0.1
+ * @date 2025-08-14
+ *
+ * ns_i2c_read()/ns_spi_read() and friends block the CPU for the whole bus transfer: reading
+ * 14 bytes from an IMU at 400 kHz stalls the core for about 400 us. This queue lets a driver
+ * describe its register accesses (ns_iom_xfer_t), for one or several devices on the same IOM,
+ * submit them as a batch and go back to work or to sleep while the IOM runs them.
+ *
+ * - Batches are owned by the caller and linked into a FIFO, so there is no fixed queue size
+ *   and no allocation. Transactions run in submission order.
+ * - Up to port->depth transactions are handed to the port at once. The hardware port puts
+ *   them in the IOM command queue (am_hal_iom_nonblocking_transfer), which runs them back to
+ *   back with DMA and interrupts only on completion.
+ * - A batch finishes with its optional callback (from the completion context, the IOM
+ *   interrupt on hardware); ns_iom_batch_done() polls and ns_iom_wait() sleeps until it is
+ *   done.
+ * - A failed transaction (e.g. an I2C NAK) fails its batch; the batch's remaining
+ *   transactions are skipped, later batches run normally.
+ * - Per-bus statistics count transactions, bytes, errors, bus busy time and batch latency.
+ *
+ * The queue reaches the IOM through ns_iom_port_t. ns_iom_hw drives an IOM already set up by
+ * ns_i2c_interface_init() or ns_spi_interface_init(); ns_iom_sim models I2C/SPI bus timing
+ * against a virtual clock, so drivers and schedules can be tested on the host.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-i2c
+ *  @{
+ */
+
+#ifndef NS_IOM_QUEUE_H
+    #define NS_IOM_QUEUE_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_IOM_QUEUE_V0_0_1                                                                    \
+        { .major = 0, .minor = 0, .revision = 1 }
+
+    #define NS_IOM_QUEUE_OLDEST_SUPPORTED_VERSION NS_IOM_QUEUE_V0_0_1
+    #define NS_IOM_QUEUE_CURRENT_VERSION NS_IOM_QUEUE_V0_0_1
+    #define NS_IOM_QUEUE_API_ID 0xCA0015
+
+    #define NS_IOM_MAX_REG_LEN 4 ///< Register/command bytes per transaction (3 on Apollo3)
+
+extern const ns_core_api_t ns_iom_queue_V0_0_1;
+extern const ns_core_api_t ns_iom_queue_oldest_supported_version;
+extern const ns_core_api_t ns_iom_queue_current_version;
+
+typedef enum { NS_IOM_WRITE = 0, NS_IOM_READ = 1 } ns_iom_dir_e;
+
+/// One bus transaction: regLen bytes of reg (MSB first), then len bytes read or written
+typedef struct {
+    uint16_t dev;   ///< I2C device address, or SPI chip select
+    uint8_t dir;    ///< ns_iom_dir_e
+    uint8_t regLen; ///< 0 to NS_IOM_MAX_REG_LEN
+    uint32_t reg;   ///< Register address or command
+    void *buf;      ///< Read into or written from, word aligned for DMA
+    uint32_t len;   ///< Bytes, at most 4095
+} ns_iom_xfer_t;
+
+/// Read len bytes starting at an 8-bit register
+    #define NS_IOM_READ_REG(_dev, _reg, _buf, _len)                                                \
+        { .dev = (_dev), .dir = NS_IOM_READ, .regLen = 1, .reg = (_reg), .buf = (_buf),            \
+          .len = (_len) }
+
+/// Write len bytes starting at an 8-bit register
+    #define NS_IOM_WRITE_REG(_dev, _reg, _buf, _len)                                               \
+        { .dev = (_dev), .dir = NS_IOM_WRITE, .regLen = 1, .reg = (_reg), .buf = (_buf),           \
+          .len = (_len) }
+
+typedef enum {
+    NS_IOM_BATCH_IDLE = 0, ///< Never submitted
+    NS_IOM_BATCH_QUEUED,   ///< Waiting or running
+    NS_IOM_BATCH_DONE      ///< Finished, status is valid and the batch may be resubmitted
+} ns_iom_batch_state_e;
+
+struct ns_iom_queue;
+struct ns_iom_batch;
+typedef void (*ns_iom_batch_cb)(struct ns_iom_batch *batch, void *arg);
+
+/// A list of transactions run back to back. Owned by the caller, must stay valid until done.
+typedef struct ns_iom_batch {
+    const ns_iom_xfer_t *xfers;
+    uint32_t count;
+    ns_iom_batch_cb callback; ///< Optional, called from the completion context
+    void *arg;                ///< Passed to the callback
+
+    volatile uint8_t state;   ///< ns_iom_batch_state_e
+    volatile uint32_t status; ///< NS_STATUS_SUCCESS, or NS_STATUS_FAILURE once a transaction fails
+    uint32_t submitUs;
+    uint32_t doneUs;
+
+    // Internal state
+    struct ns_iom_batch *next;
+    uint32_t issued;    ///< Transactions handed to the port
+    uint32_t completed; ///< Transactions finished
+} ns_iom_batch_t;
+
+/**
+ * @brief IOM access used by the queue
+ *
+ * start() hands one transaction to the IOM without waiting for it. The port must then call
+ * ns_iom_queue_complete() once per started transaction, in the order they were started, and
+ * never from within start() itself. The queue never has more than depth transactions started
+ * and not completed.
+ */
+typedef struct ns_iom_port {
+    uint32_t depth;                                      ///< Transactions the port holds at once
+    uint32_t (*start)(void *ctx, const ns_iom_xfer_t *xfer); ///< Returns a status
+    uint32_t (*now_us)(void *ctx);                       ///< Free running microsecond clock
+    void (*idle)(void *ctx); ///< Optional, called locked by ns_iom_wait(), sleeps until an event
+    uint32_t (*lock)(void *ctx);               ///< Optional, e.g. mask interrupts
+    void (*unlock)(void *ctx, uint32_t state); ///< Optional, undo lock()
+    void *ctx;                                 ///< Passed to every port function
+} ns_iom_port_t;
+
+/// Per-bus statistics
+typedef struct {
+    uint32_t batches;      ///< Batches finished
+    uint32_t transactions; ///< Transactions finished
+    uint32_t bytesRead;
+    uint32_t bytesWritten; ///< Data bytes, not counting register bytes
+    uint32_t errors;       ///< Transactions that failed
+    uint32_t maxQueued;    ///< Most batches waiting or running at once
+    uint64_t busyUs;       ///< Time with at least one transaction on the bus
+    uint32_t latencyMaxUs; ///< Worst submit to done time of a batch
+    uint64_t latencySumUs; ///< For the average, latencySumUs / batches
+} ns_iom_queue_stats_t;
+
+/// Queue for one IOM
+typedef struct ns_iom_queue {
+    const ns_core_api_t *api;   ///< API prefix
+    const ns_iom_port_t *port;  ///< IOM access
+    ns_iom_queue_stats_t stats;
+
+    // Internal state
+    ns_iom_batch_t *head;  ///< Oldest unfinished batch
+    ns_iom_batch_t *tail;
+    ns_iom_batch_t *issue; ///< Batch the next transaction is started from
+    uint32_t queued;       ///< Unfinished batches
+    uint32_t inFlight;     ///< Transactions started and not completed
+    uint32_t busySinceUs;
+} ns_iom_queue_t;
+
+/**
+ * @brief Initialize a queue
+ *
+ * @param q api and port must be set
+ * @return uint32_t status
+ */
+extern uint32_t ns_iom_queue_init(ns_iom_queue_t *q);
+
+/**
+ * @brief Queue a batch, returns without waiting for the bus
+ *
+ * @param q Queue
+ * @param batch xfers and count set, callback optional. Not already queued.
+ * @return uint32_t NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG for an empty or queued batch
+ */
+extern uint32_t ns_iom_submit(ns_iom_queue_t *q, ns_iom_batch_t *batch);
+
+/**
+ * @brief Has a batch finished
+ *
+ * @param batch Submitted batch
+ * @return true once batch->status is valid
+ */
+static inline bool ns_iom_batch_done(const ns_iom_batch_t *batch) {
+    return batch->state == NS_IOM_BATCH_DONE;
+}
+
+/**
+ * @brief Sleep until a batch has finished
+ *
+ * @param q Queue the batch was submitted to
+ * @param batch Submitted batch
+ * @return uint32_t batch->status
+ */
+extern uint32_t ns_iom_wait(ns_iom_queue_t *q, ns_iom_batch_t *batch);
+
+/**
+ * @brief Sleep until every submitted batch has finished
+ *
+ * @param q Queue
+ */
+extern void ns_iom_flush(ns_iom_queue_t *q);
+
+/**
+ * @brief Report the oldest started transaction as finished (port use only)
+ *
+ * Finishes batches and starts queued transactions; batch callbacks run from here.
+ *
+ * @param q Queue
+ * @param status NS_STATUS_SUCCESS if the transaction succeeded
+ */
+extern void ns_iom_queue_complete(ns_iom_queue_t *q, uint32_t status);
+
+    #ifndef NS_IOM_HW_DEPTH
+        #define NS_IOM_HW_DEPTH 4 ///< Transactions in the IOM command queue at once
+    #endif
+    #ifndef NS_IOM_HW_CMD_WORDS
+        #define NS_IOM_HW_CMD_WORDS 256 ///< Command queue buffer, words
+    #endif
+
+/// Hardware port for one IOM, driving its command queue
+typedef struct {
+    ns_iom_port_t port;
+    ns_iom_queue_t *q;
+    void *iomHandle;
+    uint32_t iom;
+    bool spi;
+    uint32_t cmdBuf[NS_IOM_HW_CMD_WORDS];
+} ns_iom_hw_t;
+
+/**
+ * @brief Attach a queue to an initialized IOM (sets q->port), call before ns_iom_queue_init()
+ *
+ * Gives the IOM a command queue buffer and enables its interrupt. Blocking ns_i2c_xxx() and
+ * ns_spi_xxx() calls keep working on the same IOM, they wait for queued transactions first.
+ *
+ * @param hw Port state, must stay valid while the queue is used
+ * @param q Queue
+ * @param iomHandle cfg.iomHandle of an initialized ns_i2c_config_t or ns_spi_config_t
+ * @param iomConfig &cfg.sIomCfg of the same configuration
+ * @param iom cfg.iom of the same configuration
+ * @return uint32_t status
+ */
+extern uint32_t ns_iom_hw_init(
+    ns_iom_hw_t *hw, ns_iom_queue_t *q, void *iomHandle, void *iomConfig, uint32_t iom);
+
+/**
+ * @brief IOM interrupt service, call from am_iomasterN_isr() of the attached IOM
+ *
+ * @param hw Port state
+ */
+extern void ns_iom_hw_service(ns_iom_hw_t *hw);
+
+    #ifndef NS_IOM_SIM_DEPTH
+        #define NS_IOM_SIM_DEPTH 8
+    #endif
+
+/// Simulated device: carries out a transaction on its registers, returns a status (NAK)
+typedef uint32_t (*ns_iom_sim_device_fn)(void *ctx, const ns_iom_xfer_t *xfer);
+
+/// Host-side bus simulator: I2C or SPI timing on a virtual clock behind an ns_iom_port_t
+typedef struct {
+    ns_iom_port_t port;
+    ns_iom_queue_t *q;
+    uint32_t clockHz;            ///< Bus clock
+    bool spi;                    ///< SPI framing instead of I2C
+    uint32_t setupUs;            ///< Per transaction, between transfers on the bus
+    ns_iom_sim_device_fn device; ///< Optional
+    void *deviceCtx;
+    uint32_t nowUs; ///< Virtual clock
+
+    // Internal state
+    const ns_iom_xfer_t *pending[NS_IOM_SIM_DEPTH];
+    uint32_t doneUs[NS_IOM_SIM_DEPTH];
+    uint32_t first;
+    uint32_t count;
+    uint32_t busyUntilUs;
+} ns_iom_sim_t;
+
+/**
+ * @brief Attach a simulator to a queue (sets q->port), call before ns_iom_queue_init()
+ *
+ * @param sim Simulator, device and setupUs may be set afterwards
+ * @param q Queue
+ * @param clockHz Bus clock
+ * @param spi SPI framing instead of I2C
+ */
+extern void ns_iom_sim_init(ns_iom_sim_t *sim, ns_iom_queue_t *q, uint32_t clockHz, bool spi);
+
+/**
+ * @brief Bus time of one transaction, setupUs included
+ *
+ * I2C: start, address, register bytes, repeated start and address for reads, data, stop,
+ * 9 clocks per byte. SPI: 8 clocks per register and data byte.
+ *
+ * @param sim Simulator
+ * @param xfer Transaction
+ * @return uint32_t Microseconds
+ */
+extern uint32_t ns_iom_sim_xfer_us(const ns_iom_sim_t *sim, const ns_iom_xfer_t *xfer);
+
+/**
+ * @brief Advance the virtual clock, completing the transactions that finish meanwhile
+ *
+ * @param sim Simulator
+ * @param us Microseconds
+ */
+extern void ns_iom_sim_advance(ns_iom_sim_t *sim, uint32_t us);
+
+/**
+ * @brief Run a transaction the blocking way, as ns_i2c_read() and friends do
+ *
+ * Waits for the queue to drain, then advances the clock by the transaction time.
+ *
+ * @param sim Simulator
+ * @param xfer Transaction
+ * @return uint32_t Device status
+ */
+extern uint32_t ns_iom_sim_blocking(ns_iom_sim_t *sim, const ns_iom_xfer_t *xfer);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_IOM_QUEUE_H
+/** @} */
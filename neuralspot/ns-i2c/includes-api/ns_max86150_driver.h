@@ -37,14 +37,28 @@ typedef int (*pfnI2cWriteRead)(
     uint16_t addr, const void *write_buf, size_t num_write, void *read_buf, size_t num_read);
 typedef int (*pfnI2cRead)(const void *buf, uint32_t num_bytes, uint16_t addr);
 typedef int (*pfnI2cWrite)(const void *buf, uint32_t num_bytes, uint16_t addr);
+typedef uint32_t (*pfnNowUs)(void);
 
 typedef struct {
     uint32_t addr;
     pfnI2cWriteRead i2c_write_read;
     pfnI2cRead i2c_read;
     pfnI2cWrite i2c_write;
+    pfnNowUs now_us; ///< Optional, timestamps FIFO batches
 } max86150_context_t;
 
+    #define MAX86150_FIFO_MAX_BYTES (32 * 3 * 4) ///< Full FIFO with all four slots enabled
+
+/// One burst drain of the FIFO
+typedef struct {
+    uint8_t raw[MAX86150_FIFO_MAX_BYTES]; ///< Packed samples, 3 bytes per slot, oldest first
+    uint32_t numSamples;                  ///< Samples in raw
+    uint32_t overflow;       ///< Samples lost before this batch (saturates at 31)
+    uint32_t overflowTotal;  ///< Samples lost since the struct was zeroed
+    uint32_t timestampUs;    ///< ctx->now_us() when the FIFO pointers were read (newest sample)
+    uint32_t batches;        ///< Drains with at least one sample
+} max86150_fifo_batch_t;
+
 uint8_t max86150_get_register(const max86150_context_t *ctx, uint8_t reg, uint8_t mask);
 int max86150_set_register(const max86150_context_t *ctx, uint8_t reg, uint8_t value, uint8_t mask);
 
@@ -66,6 +80,34 @@ void max86150_set_fifo_slots(const max86150_context_t *ctx, max86150_slot_type *
 void max86150_disable_slots(const max86150_context_t *ctx);
 uint32_t max86150_read_fifo_samples(
     const max86150_context_t *ctx, uint32_t *buffer, max86150_slot_type *slots, uint8_t numSlots);
+
+/**
+ * @brief Drain the whole FIFO in one burst read
+ *
+ * One read of the pointer and overflow registers, one read of every available sample.
+ *
+ * @param ctx Device context
+ * @param numSlots Enabled FIFO slots (1-4)
+ * @param batch Receives the packed samples, counters and timestamp
+ * @return uint32_t Number of samples read
+ */
+uint32_t max86150_read_fifo_burst(
+    const max86150_context_t *ctx, uint8_t numSlots, max86150_fifo_batch_t *batch);
+
+/**
+ * @brief Unpack drained samples into one int32 plane per slot
+ *
+ * ECG slots are sign extended from 18 bits, PPG slots masked to 19 bits.
+ *
+ * @param batch Drained FIFO
+ * @param slots Slot types, as configured with max86150_set_fifo_slots()
+ * @param numSlots Enabled FIFO slots
+ * @param dst Plane for slot j starts at dst + j * stride
+ * @param stride Distance between planes, at least batch->numSamples
+ */
+void max86150_unpack_fifo(
+    const max86150_fifo_batch_t *batch, const max86150_slot_type *slots, uint8_t numSlots,
+    int32_t *dst, uint32_t stride);
 uint8_t max86150_get_fifo_overflow_counter(const max86150_context_t *ctx);
 uint8_t max86150_set_fifo_overflow_counter(const max86150_context_t *ctx, uint8_t value);
 uint8_t max86150_get_fifo_rd_pointer(const max86150_context_t *ctx);
@@ -85,6 +85,18 @@ typedef struct {
     uint8_t fsyncEnable;
 } mpu6050_int_config_t;
 
+#define MPU6050_FIFO_SIZE 1024
+
+/*! One burst drain of the FIFO */
+typedef struct {
+    uint8_t raw[MPU6050_FIFO_SIZE]; //!< Whole frames, oldest first
+    uint16_t frameBytes;            //!< Set by the caller, see mpu6050_fifo_frame_bytes()
+    uint32_t numFrames;             //!< Frames in raw
+    uint32_t overflows;             //!< Drains that found the FIFO overflowed and reset it
+    uint32_t timestampUs;           //!< now_us() when the FIFO count was read (newest frame)
+    uint32_t (*now_us)(void);       //!< Optional, timestamps batches
+} mpu6050_fifo_batch_t;
+
 #define MPU_I2CADDRESS_AD0_LOW 0x68
 #define MPU_I2CADDRESS_AD0_HIGH 0x69
 
@@ -199,6 +211,44 @@ uint32_t mpu6050_get_fifo_count(ns_i2c_config_t *cfg, uint32_t devAddr, uint16_t
  */
 uint32_t mpu6050_fifo_pop(ns_i2c_config_t *cfg, uint32_t devAddr, int16_t *value);
 
+/**
+ * @brief Bytes per FIFO frame for a FIFO configuration
+ *
+ * Frames hold the enabled values in register order: accel x, y, z, temperature, gyro x, y, z,
+ * 2 bytes each, big-endian. Slave data is not counted.
+ *
+ * @param fifoConfig FIFO configuration
+ * @return uint16_t Bytes per frame
+ */
+uint16_t mpu6050_fifo_frame_bytes(const mpu6050_fifo_config_t *fifoConfig);
+
+/**
+ * @brief Drain every whole frame in the FIFO with one burst read
+ *
+ * Reads the interrupt status (clearing it) and FIFO count, then the frames. If the FIFO has
+ * overflowed, frame alignment is lost: the FIFO is reset, batch->overflows counted and no
+ * frames returned.
+ *
+ * @param cfg I2C configuration
+ * @param devAddr Device I2C address
+ * @param batch frameBytes set, receives the frames
+ * @return uint32_t status
+ */
+uint32_t
+mpu6050_read_fifo_burst(ns_i2c_config_t *cfg, uint32_t devAddr, mpu6050_fifo_batch_t *batch);
+
+/**
+ * @brief Unpack drained frames into one float plane per value
+ *
+ * @param batch Drained FIFO
+ * @param scale Per value in the frame, e.g. mpu6050_accel_resolution() for accel values.
+ * Temperature is raw / 340 + 36.53 degC, add the offset afterwards.
+ * @param dst Plane for value c starts at dst + c * stride
+ * @param stride Distance between planes, at least batch->numFrames
+ */
+void mpu6050_unpack_fifo(
+    const mpu6050_fifo_batch_t *batch, const float *scale, float *dst, uint32_t stride);
+
 /**
  * @brief Configure interrupts
  *
@@ -0,0 +1,92 @@
+/**
+ * @file ns_sensor_unpack.h
+ * @author Ambiq
+ * @brief Unpack big-endian sensor FIFO frames into planar int32 or float arrays
+ * @version 0.1
+ * @date 2025-08-15
+ *
+ * Sensor FIFOs deliver interleaved frames of big-endian words: 24-bit PPG/ECG samples on the
+ * MAX86150, 16-bit accel/temp/gyro values on the MPU6050. These unpackers convert a whole
+ * burst read at once into one plane per channel (plane c starts at dst + c * stride).
+ *
+ * Each channel is a straight loop over frames with a fixed source stride and no per-sample
+ * branches or copies, so the compiler can vectorize it (Helium on Apollo5). Signed fields are
+ * sign extended, unsigned fields masked, to the given width.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-i2c
+ *  @{
+ */
+
+#ifndef NS_SENSOR_UNPACK_H
+    #define NS_SENSOR_UNPACK_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdint.h>
+
+/**
+ * @brief Unpack 24-bit big-endian fields to int32 planes
+ *
+ * @param src Frames of channels * 3 bytes
+ * @param frames Number of frames
+ * @param channels Fields per frame
+ * @param bits Significant bits of each channel's field (1-24)
+ * @param signedMask Bit c set if channel c is two's complement
+ * @param dst Output planes
+ * @param stride Distance between planes, in elements (at least frames)
+ */
+extern void ns_unpack_be24_i32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, const uint8_t *bits,
+    uint32_t signedMask, int32_t *dst, uint32_t stride);
+
+/**
+ * @brief Unpack 24-bit big-endian fields to scaled float planes
+ *
+ * @param src Frames of channels * 3 bytes
+ * @param frames Number of frames
+ * @param channels Fields per frame
+ * @param bits Significant bits of each channel's field (1-24)
+ * @param signedMask Bit c set if channel c is two's complement
+ * @param scale Per channel, multiplies the integer value
+ * @param dst Output planes
+ * @param stride Distance between planes, in elements
+ */
+extern void ns_unpack_be24_f32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, const uint8_t *bits,
+    uint32_t signedMask, const float *scale, float *dst, uint32_t stride);
+
+/**
+ * @brief Unpack signed 16-bit big-endian fields to int32 planes
+ *
+ * @param src Frames of channels * 2 bytes
+ * @param frames Number of frames
+ * @param channels Fields per frame
+ * @param dst Output planes
+ * @param stride Distance between planes, in elements
+ */
+extern void ns_unpack_be16_i32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, int32_t *dst, uint32_t stride);
+
+/**
+ * @brief Unpack signed 16-bit big-endian fields to scaled float planes
+ *
+ * @param src Frames of channels * 2 bytes
+ * @param frames Number of frames
+ * @param channels Fields per frame
+ * @param scale Per channel, multiplies the integer value (e.g. g or deg/s per LSB)
+ * @param dst Output planes
+ * @param stride Distance between planes, in elements
+ */
+extern void ns_unpack_be16_f32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, const float *scale, float *dst,
+    uint32_t stride);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_SENSOR_UNPACK_H
+/** @} */
@@ -0,0 +1,245 @@
+/**
+ * @file ns_iom_queue.c
+ * @author Ambiq
+ * @brief Asynchronous IOM transaction queue
+ * @version 0.1
+ * @date 2025-08-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_iom_queue.h"
+#include "ns_core.h"
+#include <stddef.h>
+
+const ns_core_api_t ns_iom_queue_V0_0_1 = {
+    .apiId = NS_IOM_QUEUE_API_ID, .version = NS_IOM_QUEUE_V0_0_1};
+const ns_core_api_t ns_iom_queue_oldest_supported_version = {
+    .apiId = NS_IOM_QUEUE_API_ID, .version = NS_IOM_QUEUE_V0_0_1};
+const ns_core_api_t ns_iom_queue_current_version = {
+    .apiId = NS_IOM_QUEUE_API_ID, .version = NS_IOM_QUEUE_V0_0_1};
+
+static inline uint32_t ns_iom_lock(ns_iom_queue_t *q) {
+    return q->port->lock ? q->port->lock(q->port->ctx) : 0;
+}
+
+static inline void ns_iom_unlock(ns_iom_queue_t *q, uint32_t state) {
+    if (q->port->unlock) {
+        q->port->unlock(q->port->ctx, state);
+    }
+}
+
+static inline uint32_t ns_iom_now(ns_iom_queue_t *q) { return q->port->now_us(q->port->ctx); }
+
+// Start transactions until the port is full or nothing is left. Called locked.
+static void ns_iom_issue(ns_iom_queue_t *q) {
+    ns_iom_batch_t *b;
+
+    while ((q->inFlight < q->port->depth) && (q->issue != NULL)) {
+        b = q->issue;
+        if ((b->issued == b->count) || (b->status != NS_STATUS_SUCCESS)) {
+            q->issue = b->next;
+            continue;
+        }
+        if (q->inFlight == 0) {
+            q->busySinceUs = ns_iom_now(q);
+        }
+        q->inFlight++;
+        b->issued++;
+        if (q->port->start(q->port->ctx, &b->xfers[b->issued - 1]) != NS_STATUS_SUCCESS) {
+            q->inFlight--;
+            b->issued--;
+            b->status = NS_STATUS_FAILURE;
+            q->stats.errors++;
+            if (q->inFlight == 0) {
+                q->stats.busyUs += ns_iom_now(q) - q->busySinceUs;
+            }
+        }
+    }
+}
+
+// Unlink finished batches from the head of the queue onto done (in order). Called locked.
+static void ns_iom_retire(ns_iom_queue_t *q, ns_iom_batch_t **done) {
+    ns_iom_batch_t *b;
+    uint32_t latency;
+
+    while ((b = q->head) != NULL) {
+        if ((b->completed != b->issued) ||
+            ((b->issued != b->count) && (b->status == NS_STATUS_SUCCESS))) {
+            break;
+        }
+        q->head = b->next;
+        if (q->head == NULL) {
+            q->tail = NULL;
+        }
+        if (q->issue == b) {
+            q->issue = b->next;
+        }
+        q->queued--;
+
+        b->doneUs = ns_iom_now(q);
+        latency = b->doneUs - b->submitUs;
+        q->stats.batches++;
+        q->stats.latencySumUs += latency;
+        if (latency > q->stats.latencyMaxUs) {
+            q->stats.latencyMaxUs = latency;
+        }
+        b->next = NULL;
+        *done = b;
+        done = &b->next;
+    }
+}
+
+// Mark batches done and call their callbacks. Called unlocked: a callback may resubmit.
+static void ns_iom_finish(ns_iom_batch_t *done) {
+    ns_iom_batch_t *next;
+
+    while (done != NULL) {
+        next = done->next;
+        done->state = NS_IOM_BATCH_DONE;
+        if (done->callback) {
+            done->callback(done, done->arg);
+        }
+        done = next;
+    }
+}
+
+uint32_t ns_iom_queue_init(ns_iom_queue_t *q) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (q == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(
+            q->api, &ns_iom_queue_oldest_supported_version, &ns_iom_queue_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((q->port == NULL) || (q->port->start == NULL) || (q->port->now_us == NULL) ||
+        (q->port->depth == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    q->head = NULL;
+    q->tail = NULL;
+    q->issue = NULL;
+    q->queued = 0;
+    q->inFlight = 0;
+    q->busySinceUs = 0;
+    q->stats = (ns_iom_queue_stats_t){0};
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_iom_submit(ns_iom_queue_t *q, ns_iom_batch_t *batch) {
+    ns_iom_batch_t *done = NULL;
+    uint32_t state;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((q == NULL) || (batch == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    if ((batch->xfers == NULL) || (batch->count == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    state = ns_iom_lock(q);
+    if (batch->state == NS_IOM_BATCH_QUEUED) {
+        ns_iom_unlock(q, state);
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    batch->state = NS_IOM_BATCH_QUEUED;
+    batch->status = NS_STATUS_SUCCESS;
+    batch->issued = 0;
+    batch->completed = 0;
+    batch->next = NULL;
+    batch->submitUs = ns_iom_now(q);
+    if (q->tail) {
+        q->tail->next = batch;
+    } else {
+        q->head = batch;
+    }
+    q->tail = batch;
+    if (q->issue == NULL) {
+        q->issue = batch;
+    }
+    if (++q->queued > q->stats.maxQueued) {
+        q->stats.maxQueued = q->queued;
+    }
+
+    ns_iom_issue(q);
+    ns_iom_retire(q, &done); // Only when the port refused to start the batch
+    ns_iom_unlock(q, state);
+    ns_iom_finish(done);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_iom_queue_complete(ns_iom_queue_t *q, uint32_t status) {
+    ns_iom_batch_t *done = NULL;
+    ns_iom_batch_t *b;
+    const ns_iom_xfer_t *x;
+    uint32_t state;
+
+    state = ns_iom_lock(q);
+    // Transactions finish in order, so this one is the first unfinished one of the oldest batch
+    b = q->head;
+    if ((b == NULL) || (q->inFlight == 0)) {
+        ns_iom_unlock(q, state);
+        return;
+    }
+    x = &b->xfers[b->completed++];
+    if (--q->inFlight == 0) {
+        q->stats.busyUs += ns_iom_now(q) - q->busySinceUs;
+    }
+    q->stats.transactions++;
+    if (status != NS_STATUS_SUCCESS) {
+        b->status = NS_STATUS_FAILURE;
+        q->stats.errors++;
+    } else if (x->dir == NS_IOM_READ) {
+        q->stats.bytesRead += x->len;
+    } else {
+        q->stats.bytesWritten += x->len;
+    }
+
+    ns_iom_issue(q);
+    ns_iom_retire(q, &done);
+    ns_iom_unlock(q, state);
+    ns_iom_finish(done);
+}
+
+uint32_t ns_iom_wait(ns_iom_queue_t *q, ns_iom_batch_t *batch) {
+    uint32_t state;
+
+    for (;;) {
+        state = ns_iom_lock(q);
+        if (batch->state != NS_IOM_BATCH_QUEUED) {
+            ns_iom_unlock(q, state);
+            break;
+        }
+        // Sleeping with interrupts masked: the completion interrupt still wakes the core and
+        // is taken once unlocked, so it cannot slip in between the check and the sleep
+        if (q->port->idle) {
+            q->port->idle(q->port->ctx);
+        }
+        ns_iom_unlock(q, state);
+    }
+    return batch->status;
+}
+
+void ns_iom_flush(ns_iom_queue_t *q) {
+    uint32_t state;
+
+    for (;;) {
+        state = ns_iom_lock(q);
+        if (q->head == NULL) {
+            ns_iom_unlock(q, state);
+            break;
+        }
+        if (q->port->idle) {
+            q->port->idle(q->port->ctx);
+        }
+        ns_iom_unlock(q, state);
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * @file ns_iom_queue_hw.c
+ * @author Ambiq
+ * @brief IOM queue port for the AmbiqSuite IOM command queue
+ * @version 0.1
+ * @date 2025-08-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "am_mcu_apollo.h"
+#include "ns_iom_queue.h"
+#include "ns_timer.h"
+
+static ns_timer_config_t ns_iom_hw_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+// Called by the HAL from the IOM interrupt, once per transaction, in order
+static void ns_iom_hw_done(void *ctx, uint32_t status) {
+    ns_iom_hw_t *hw = (ns_iom_hw_t *)ctx;
+    ns_iom_queue_complete(hw->q, status == AM_HAL_STATUS_SUCCESS ? NS_STATUS_SUCCESS
+                                                                : NS_STATUS_FAILURE);
+}
+
+static uint32_t ns_iom_hw_start(void *ctx, const ns_iom_xfer_t *xfer) {
+    ns_iom_hw_t *hw = (ns_iom_hw_t *)ctx;
+    am_hal_iom_transfer_t t;
+
+#if defined(AM_PART_APOLLO3) || defined(AM_PART_APOLLO3P)
+    if (xfer->regLen > 3) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    t.ui8Priority = 1;
+    t.ui32InstrLen = xfer->regLen;
+#if defined(AM_PART_APOLLO4B) || defined(AM_PART_APOLLO4P) || defined(AM_PART_APOLLO4L) ||      \
+    defined(AM_PART_APOLLO5A) || defined(AM_PART_APOLLO5B)
+    t.ui64Instr = xfer->reg;
+#else
+    t.ui32Instr = xfer->reg;
+#endif
+    t.ui32NumBytes = xfer->len;
+    if (xfer->dir == NS_IOM_READ) {
+        t.eDirection = AM_HAL_IOM_RX;
+        t.pui32RxBuffer = (uint32_t *)xfer->buf;
+    } else {
+        t.eDirection = AM_HAL_IOM_TX;
+        t.pui32TxBuffer = (uint32_t *)xfer->buf;
+    }
+    t.bContinue = false;
+    t.ui8RepeatCount = 0;
+    t.ui32PauseCondition = 0;
+    t.ui32StatusSetClr = 0;
+    if (hw->spi) {
+        t.uPeerInfo.ui32SpiChipSelect = xfer->dev;
+    } else {
+        t.uPeerInfo.ui32I2CDevAddr = xfer->dev;
+    }
+    if (am_hal_iom_nonblocking_transfer(hw->iomHandle, &t, ns_iom_hw_done, hw)) {
+        return NS_STATUS_FAILURE;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_iom_hw_now_us(void *ctx) {
+    return ns_us_ticker_read(ns_timer_get_config(NS_TIMER_COUNTER));
+}
+
+static void ns_iom_hw_idle(void *ctx) { am_hal_sysctrl_sleep(AM_HAL_SYSCTRL_SLEEP_NORMAL); }
+
+static uint32_t ns_iom_hw_lock(void *ctx) { return am_hal_interrupt_master_disable(); }
+
+static void ns_iom_hw_unlock(void *ctx, uint32_t state) { am_hal_interrupt_master_set(state); }
+
+uint32_t ns_iom_hw_init(
+    ns_iom_hw_t *hw, ns_iom_queue_t *q, void *iomHandle, void *iomConfig, uint32_t iom) {
+    am_hal_iom_config_t *cfg = (am_hal_iom_config_t *)iomConfig;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((hw == NULL) || (q == NULL) || (iomHandle == NULL) || (iomConfig == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+
+    // Share the counter if the application already started it
+    if ((ns_timer_get_config(NS_TIMER_COUNTER) == NULL) &&
+        (ns_timer_init(&ns_iom_hw_timer) != NS_STATUS_SUCCESS)) {
+        return NS_STATUS_FAILURE;
+    }
+
+    hw->q = q;
+    hw->iomHandle = iomHandle;
+    hw->iom = iom;
+    hw->spi = (cfg->eInterfaceMode == AM_HAL_IOM_SPI_MODE);
+
+    // Non-blocking transfers need a command queue buffer, which ns_i2c leaves unset
+    if (cfg->pNBTxnBuf == NULL) {
+        cfg->pNBTxnBuf = hw->cmdBuf;
+        cfg->ui32NBTxnBufLength = NS_IOM_HW_CMD_WORDS;
+        if (am_hal_iom_disable(iomHandle) || am_hal_iom_configure(iomHandle, cfg) ||
+            am_hal_iom_enable(iomHandle)) {
+            return NS_STATUS_FAILURE;
+        }
+    }
+
+    hw->port.depth = NS_IOM_HW_DEPTH;
+    hw->port.start = ns_iom_hw_start;
+    hw->port.now_us = ns_iom_hw_now_us;
+    hw->port.idle = ns_iom_hw_idle;
+    hw->port.lock = ns_iom_hw_lock;
+    hw->port.unlock = ns_iom_hw_unlock;
+    hw->port.ctx = hw;
+    q->port = &hw->port;
+
+    NVIC_ClearPendingIRQ((IRQn_Type)(IOMSTR0_IRQn + iom));
+    NVIC_EnableIRQ((IRQn_Type)(IOMSTR0_IRQn + iom));
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_iom_hw_service(ns_iom_hw_t *hw) {
+    uint32_t status;
+
+    if (!am_hal_iom_interrupt_status_get(hw->iomHandle, true, &status) && status) {
+        am_hal_iom_interrupt_clear(hw->iomHandle, status);
+        am_hal_iom_interrupt_service(hw->iomHandle, status);
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * @file ns_iom_queue_sim.c
+ * @author Ambiq
+ * @brief Host-side IOM simulator - I2C/SPI bus timing on a virtual clock
+ * @version 0.1
+ * @date 2025-08-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_iom_queue.h"
+
+uint32_t ns_iom_sim_xfer_us(const ns_iom_sim_t *sim, const ns_iom_xfer_t *xfer) {
+    uint64_t clocks;
+
+    if (sim->spi) {
+        clocks = 8ull * (xfer->regLen + xfer->len);
+    } else {
+        // Start, address + ack, register bytes, (repeated start, address), data, stop
+        clocks = 1 + 9 + 9ull * (xfer->regLen + xfer->len) + 1;
+        if ((xfer->dir == NS_IOM_READ) && (xfer->regLen != 0)) {
+            clocks += 1 + 9;
+        }
+    }
+    return sim->setupUs + (uint32_t)((clocks * 1000000 + sim->clockHz - 1) / sim->clockHz);
+}
+
+static uint32_t ns_iom_sim_start(void *ctx, const ns_iom_xfer_t *xfer) {
+    ns_iom_sim_t *sim = (ns_iom_sim_t *)ctx;
+    uint32_t slot;
+
+    if (sim->count == NS_IOM_SIM_DEPTH) {
+        return NS_STATUS_FAILURE;
+    }
+    // The bus runs transactions back to back, starting now if it is idle
+    if ((int32_t)(sim->busyUntilUs - sim->nowUs) < 0) {
+        sim->busyUntilUs = sim->nowUs;
+    }
+    sim->busyUntilUs += ns_iom_sim_xfer_us(sim, xfer);
+    slot = (sim->first + sim->count) % NS_IOM_SIM_DEPTH;
+    sim->pending[slot] = xfer;
+    sim->doneUs[slot] = sim->busyUntilUs;
+    sim->count++;
+    return NS_STATUS_SUCCESS;
+}
+
+// Finish the oldest pending transaction, the clock must have reached its end
+static void ns_iom_sim_complete_one(ns_iom_sim_t *sim) {
+    const ns_iom_xfer_t *xfer = sim->pending[sim->first];
+    uint32_t status = NS_STATUS_SUCCESS;
+
+    sim->first = (sim->first + 1) % NS_IOM_SIM_DEPTH;
+    sim->count--;
+    if (sim->device) {
+        status = sim->device(sim->deviceCtx, xfer);
+    }
+    ns_iom_queue_complete(sim->q, status);
+}
+
+static uint32_t ns_iom_sim_now_us(void *ctx) { return ((ns_iom_sim_t *)ctx)->nowUs; }
+
+// Sleep until the next completion, the way WFI waits for the IOM interrupt
+static void ns_iom_sim_idle(void *ctx) {
+    ns_iom_sim_t *sim = (ns_iom_sim_t *)ctx;
+
+    if (sim->count == 0) {
+        return;
+    }
+    if ((int32_t)(sim->doneUs[sim->first] - sim->nowUs) > 0) {
+        sim->nowUs = sim->doneUs[sim->first];
+    }
+    ns_iom_sim_complete_one(sim);
+}
+
+void ns_iom_sim_init(ns_iom_sim_t *sim, ns_iom_queue_t *q, uint32_t clockHz, bool spi) {
+    sim->port.depth = NS_IOM_SIM_DEPTH;
+    sim->port.start = ns_iom_sim_start;
+    sim->port.now_us = ns_iom_sim_now_us;
+    sim->port.idle = ns_iom_sim_idle;
+    sim->port.lock = NULL;
+    sim->port.unlock = NULL;
+    sim->port.ctx = sim;
+    sim->q = q;
+    sim->clockHz = clockHz;
+    sim->spi = spi;
+    sim->setupUs = 0;
+    sim->device = NULL;
+    sim->deviceCtx = NULL;
+    sim->nowUs = 0;
+    sim->first = 0;
+    sim->count = 0;
+    sim->busyUntilUs = 0;
+    q->port = &sim->port;
+}
+
+void ns_iom_sim_advance(ns_iom_sim_t *sim, uint32_t us) {
+    uint32_t end = sim->nowUs + us;
+
+    while ((sim->count != 0) && ((int32_t)(sim->doneUs[sim->first] - end) <= 0)) {
+        if ((int32_t)(sim->doneUs[sim->first] - sim->nowUs) > 0) {
+            sim->nowUs = sim->doneUs[sim->first];
+        }
+        ns_iom_sim_complete_one(sim);
+    }
+    sim->nowUs = end;
+}
+
+uint32_t ns_iom_sim_blocking(ns_iom_sim_t *sim, const ns_iom_xfer_t *xfer) {
+    while (sim->count != 0) {
+        ns_iom_sim_idle(sim);
+    }
+    if ((int32_t)(sim->busyUntilUs - sim->nowUs) > 0) {
+        sim->nowUs = sim->busyUntilUs;
+    }
+    sim->nowUs += ns_iom_sim_xfer_us(sim, xfer);
+    sim->busyUntilUs = sim->nowUs;
+    return sim->device ? sim->device(sim->deviceCtx, xfer) : NS_STATUS_SUCCESS;
+}
@@ -9,6 +9,7 @@
  *
  */
 #include "ns_max86150_driver.h"
+#include "ns_sensor_unpack.h"
 #include <ctype.h>
 #include <stdint.h>
 #include <string.h>
@@ -226,6 +227,43 @@ max86150_disable_slots(const max86150_context_t *ctx) {
     max86150_set_register(ctx, MAX86150_FIFO_CONTROL2, 0x00, 0xFF);
 }
 
+// Read the FIFO pointers and every available sample in two transactions
+static uint32_t max86150_drain_fifo(
+    const max86150_context_t *ctx, uint8_t numSlots, uint8_t *raw, uint32_t *overflow,
+    uint32_t *timestampUs) {
+    uint8_t regAddr = MAX86150_FIFO_WR_PTR;
+    uint8_t ptrs[3];
+    uint32_t numSamples;
+
+    *overflow = 0;
+    if ((numSlots == 0) || (numSlots > 4) ||
+        ctx->i2c_write_read(ctx->addr, &regAddr, 1, ptrs, 3)) {
+        return 0;
+    }
+    if (timestampUs) {
+        *timestampUs = ctx->now_us ? ctx->now_us() : 0;
+    }
+    uint8_t wrPtr = ptrs[0] & 0x1F;
+    uint8_t ovrCnt = ptrs[1] & 0x1F;
+    uint8_t rdPtr = ptrs[2] & 0x1F;
+    // Equal pointers mean empty unless samples have been lost, which only happens when full
+    *overflow = ovrCnt;
+    if (ovrCnt) {
+        numSamples = MAX86150_FIFO_DEPTH;
+    } else {
+        numSamples = (uint32_t)(wrPtr - rdPtr) & (MAX86150_FIFO_DEPTH - 1);
+    }
+    if (numSamples == 0) {
+        return 0;
+    }
+    // FIFO_DATA does not auto-increment, one burst pops every sample
+    regAddr = MAX86150_FIFO_DATA;
+    if (ctx->i2c_write_read(ctx->addr, &regAddr, 1, raw, numSamples * 3 * numSlots)) {
+        return 0;
+    }
+    return numSamples;
+}
+
 /**
  * @brief Reads all data available in FIFO
  * @param ctx Device context
@@ -238,52 +276,63 @@ max86150_disable_slots(const max86150_context_t *ctx) {
 uint32_t
 max86150_read_fifo_samples(const max86150_context_t *ctx, uint32_t *buffer,
                            max86150_slot_type *slots, uint8_t numSlots) {
-    uint8_t temp[4];
-    uint8_t rdBytes[3 * 4];
-    uint32_t rdBytesIdx;
-    uint32_t bufferIdx;
-    uint32_t regAddr = MAX86150_FIFO_WR_PTR;
-    ctx->i2c_write_read(ctx->addr, &regAddr, 1, temp, 3);
-    uint8_t wrPtr = temp[0] & 0x1F;
-    uint8_t ovrCnt = temp[1] & 0x1F;
-    uint8_t rdPtr = temp[2] & 0x1F;
-    uint32_t bytesPerSample = 3 * numSlots;
-    uint32_t numSamples;
-    // If overflow or pointers are equal, then FIFO is full
-    // NOTE: When FIFO cleared wr=rd=ovr=0 not sure how to handle this
-    if (ovrCnt || (wrPtr && (rdPtr == wrPtr))) {
-        numSamples = MAX86150_FIFO_DEPTH;
-    } else if (wrPtr > rdPtr) {
-        numSamples = wrPtr - rdPtr;
-    } else {
-        numSamples = MAX86150_FIFO_DEPTH + wrPtr - rdPtr;
-    }
-    if (numSamples == 0) {
-        return numSamples;
-    }
-    regAddr = MAX86150_FIFO_DATA;
-    ctx->i2c_write(&regAddr, 1, ctx->addr);
-    bufferIdx = 0;
-    for (size_t i = 0; i < numSamples; i++) {
-        ctx->i2c_read((void *)rdBytes, bytesPerSample, ctx->addr);
-        rdBytesIdx = 0;
-        for (size_t j = 0; j < numSlots; j++) {
-            temp[3] = 0;
-            temp[2] = rdBytes[rdBytesIdx++];
-            temp[1] = rdBytes[rdBytesIdx++];
-            temp[0] = rdBytes[rdBytesIdx++];
-            memcpy(&buffer[bufferIdx], temp, 4);
-            if (slots[j] == Max86150SlotEcg) {
-                buffer[bufferIdx] &= 0x3FFFF;
-            } else {
-                buffer[bufferIdx] &= 0x7FFFF;
-            }
-            bufferIdx += 1;
+    uint8_t raw[MAX86150_FIFO_MAX_BYTES];
+    uint32_t overflow;
+    uint32_t numSamples = max86150_drain_fifo(ctx, numSlots, raw, &overflow, NULL);
+    const uint8_t *p = raw;
+
+    for (uint32_t i = 0; i < numSamples; i++) {
+        for (uint32_t j = 0; j < numSlots; j++, p += 3) {
+            uint32_t mask = slots[j] == Max86150SlotEcg ? 0x3FFFF : 0x7FFFF;
+            *buffer++ = (((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2]) & mask;
         }
     }
     return numSamples;
 }
 
+/**
+ * @brief Drain the whole FIFO in one burst read
+ * @param ctx Device context
+ * @param numSlots Enabled FIFO slots (1-4)
+ * @param batch Receives the packed samples, counters and timestamp
+ * @return Number of samples read
+ */
+uint32_t max86150_read_fifo_burst(
+    const max86150_context_t *ctx, uint8_t numSlots, max86150_fifo_batch_t *batch) {
+    batch->numSamples =
+        max86150_drain_fifo(ctx, numSlots, batch->raw, &batch->overflow, &batch->timestampUs);
+    batch->overflowTotal += batch->overflow;
+    if (batch->numSamples) {
+        batch->batches++;
+    }
+    return batch->numSamples;
+}
+
+/**
+ * @brief Unpack drained samples into one int32 plane per slot
+ * @param batch Drained FIFO
+ * @param slots Slot types
+ * @param numSlots Enabled FIFO slots
+ * @param dst Plane for slot j starts at dst + j * stride
+ * @param stride Distance between planes
+ */
+void max86150_unpack_fifo(
+    const max86150_fifo_batch_t *batch, const max86150_slot_type *slots, uint8_t numSlots,
+    int32_t *dst, uint32_t stride) {
+    uint8_t bits[4];
+    uint32_t signedMask = 0;
+
+    if (numSlots > 4) {
+        numSlots = 4;
+    }
+    for (uint32_t j = 0; j < numSlots; j++) {
+        // ECG is 18-bit two's complement, PPG 19-bit unsigned
+        bits[j] = slots[j] == Max86150SlotEcg ? 18 : 19;
+        signedMask |= (slots[j] == Max86150SlotEcg) << j;
+    }
+    ns_unpack_be24_i32(batch->raw, batch->numSamples, numSlots, bits, signedMask, dst, stride);
+}
+
 /**
  * @brief Get FIFO overflow counter
  * @param  ctx Device context
@@ -14,6 +14,7 @@
 #include "am_mcu_apollo.h"
 #include "am_util.h"
 #include "ns_i2c_register_driver.h"
+#include "ns_sensor_unpack.h"
 #include <limits.h>
 #include <stdlib.h>
 
@@ -419,12 +420,79 @@ uint32_t mpu6050_get_fifo_count(ns_i2c_config_t *cfg, uint32_t devAddr, uint16_t
  * @return uint32_t status
  */
 uint32_t mpu6050_fifo_pop(ns_i2c_config_t *cfg, uint32_t devAddr, int16_t *value) {
-    if (read_word_register(cfg, devAddr, FIFO_COUNT_H, (uint16_t *)value)) {
+    // FIFO_R_W does not auto-increment, both bytes come from the FIFO
+    if (read_word_register(cfg, devAddr, FIFO_R_W, (uint16_t *)value)) {
         return MPU6050_STATUS_ERROR;
     }
     return MPU6050_STATUS_SUCCESS;
 }
 
+/**
+ * @brief Bytes per FIFO frame for a FIFO configuration
+ *
+ * @param fifoConfig FIFO configuration
+ * @return uint16_t Bytes per frame
+ */
+uint16_t mpu6050_fifo_frame_bytes(const mpu6050_fifo_config_t *fifoConfig) {
+    return 6 * (fifoConfig->accelEnable != 0) + 2 * (fifoConfig->tempEnable != 0) +
+           2 * ((fifoConfig->xgEnable != 0) + (fifoConfig->ygEnable != 0) +
+                (fifoConfig->zgEnable != 0));
+}
+
+/**
+ * @brief Drain every whole frame in the FIFO with one burst read
+ *
+ * @param cfg I2C configuration
+ * @param devAddr Device I2C address
+ * @param batch frameBytes set, receives the frames
+ * @return uint32_t status
+ */
+uint32_t
+mpu6050_read_fifo_burst(ns_i2c_config_t *cfg, uint32_t devAddr, mpu6050_fifo_batch_t *batch) {
+    uint8_t status;
+    uint16_t count;
+
+    batch->numFrames = 0;
+    if ((batch->frameBytes == 0) || (batch->frameBytes > MPU6050_FIFO_SIZE) ||
+        ns_i2c_read_reg(cfg, devAddr, INT_STATUS, &status, 0xFF) ||
+        read_word_register(cfg, devAddr, FIFO_COUNT_H, &count)) {
+        return MPU6050_STATUS_ERROR;
+    }
+    batch->timestampUs = batch->now_us ? batch->now_us() : 0;
+
+    // The oldest bytes were overwritten, so the FIFO no longer starts on a frame
+    if (status & (1 << INT_STATUS_FIFO_OFLOW_BIT)) {
+        batch->overflows++;
+        return mpu6050_reset_fifo(cfg, devAddr);
+    }
+    // A count past the FIFO size is a bad read, never drain more than raw holds
+    if (count > MPU6050_FIFO_SIZE) {
+        count = MPU6050_FIFO_SIZE;
+    }
+    count -= count % batch->frameBytes;
+    if (count == 0) {
+        return MPU6050_STATUS_SUCCESS;
+    }
+    if (ns_i2c_read_sequential_regs(cfg, devAddr, FIFO_R_W, batch->raw, count)) {
+        return MPU6050_STATUS_ERROR;
+    }
+    batch->numFrames = count / batch->frameBytes;
+    return MPU6050_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Unpack drained frames into one float plane per value
+ *
+ * @param batch Drained FIFO
+ * @param scale Per value in the frame
+ * @param dst Plane for value c starts at dst + c * stride
+ * @param stride Distance between planes
+ */
+void mpu6050_unpack_fifo(
+    const mpu6050_fifo_batch_t *batch, const float *scale, float *dst, uint32_t stride) {
+    ns_unpack_be16_f32(batch->raw, batch->numFrames, batch->frameBytes / 2, scale, dst, stride);
+}
+
 /**
  * @brief Configure interrupts
  *
@@ -0,0 +1,99 @@
+/**
+ * @file ns_sensor_unpack.c
+ * @author Ambiq
+ * @brief Unpack big-endian sensor FIFO frames into planar int32 or float arrays
+ * @version 0.1
+ * @date 2025-08-15
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_sensor_unpack.h"
+
+// One channel of 24-bit fields. The field is placed in the top bits of a word and shifted
+// back down, arithmetically for signed fields, which masks and sign extends in one step.
+static void ns_unpack_be24_plane(
+    const uint8_t *restrict src, uint32_t frames, uint32_t frameBytes, uint32_t bits,
+    int isSigned, int32_t *restrict dst) {
+    uint32_t shift = 32 - bits;
+    uint32_t v;
+
+    if (isSigned) {
+        for (uint32_t i = 0; i < frames; i++) {
+            const uint8_t *p = src + i * frameBytes;
+            v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+            dst[i] = (int32_t)(v << shift) >> shift;
+        }
+    } else {
+        for (uint32_t i = 0; i < frames; i++) {
+            const uint8_t *p = src + i * frameBytes;
+            v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+            dst[i] = (int32_t)((v << shift) >> shift);
+        }
+    }
+}
+
+void ns_unpack_be24_i32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, const uint8_t *bits,
+    uint32_t signedMask, int32_t *dst, uint32_t stride) {
+    for (uint32_t c = 0; c < channels; c++) {
+        ns_unpack_be24_plane(
+            src + 3 * c, frames, 3 * channels, bits[c], (signedMask >> c) & 1, dst + c * stride);
+    }
+}
+
+void ns_unpack_be24_f32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, const uint8_t *bits,
+    uint32_t signedMask, const float *scale, float *dst, uint32_t stride) {
+    for (uint32_t c = 0; c < channels; c++) {
+        const uint8_t *restrict s = src + 3 * c;
+        float *restrict d = dst + c * stride;
+        uint32_t shift = 32 - bits[c];
+        uint32_t frameBytes = 3 * channels;
+        float k = scale[c];
+        uint32_t v;
+
+        if ((signedMask >> c) & 1) {
+            for (uint32_t i = 0; i < frames; i++) {
+                const uint8_t *p = s + i * frameBytes;
+                v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+                d[i] = (float)((int32_t)(v << shift) >> shift) * k;
+            }
+        } else {
+            for (uint32_t i = 0; i < frames; i++) {
+                const uint8_t *p = s + i * frameBytes;
+                v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+                d[i] = (float)((v << shift) >> shift) * k;
+            }
+        }
+    }
+}
+
+void ns_unpack_be16_i32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, int32_t *dst, uint32_t stride) {
+    uint32_t frameBytes = 2 * channels;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        const uint8_t *restrict s = src + 2 * c;
+        int32_t *restrict d = dst + c * stride;
+        for (uint32_t i = 0; i < frames; i++) {
+            d[i] = (int16_t)(((uint32_t)s[i * frameBytes] << 8) | s[i * frameBytes + 1]);
+        }
+    }
+}
+
+void ns_unpack_be16_f32(
+    const uint8_t *src, uint32_t frames, uint32_t channels, const float *scale, float *dst,
+    uint32_t stride) {
+    uint32_t frameBytes = 2 * channels;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        const uint8_t *restrict s = src + 2 * c;
+        float *restrict d = dst + c * stride;
+        float k = scale[c];
+        for (uint32_t i = 0; i < frames; i++) {
+            d[i] = (float)(int16_t)(((uint32_t)s[i * frameBytes] << 8) | s[i * frameBytes + 1]) * k;
+        }
+    }
+}
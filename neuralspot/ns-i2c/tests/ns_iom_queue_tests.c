@@ -0,0 +1,339 @@
+#include "unity/unity.h"
+#include "ns_iom_queue_tests.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_timer.h"
+#include <string.h>
+
+// The queue runs against ns_iom_sim: a 400 kHz I2C bus (or 8 MHz SPI) on a virtual clock with
+// two register-file devices. Transactions only complete when virtual time is advanced.
+
+#define IQ_IMU 0x68
+#define IQ_PPG 0x5E
+#define IQ_MISSING 0x7F
+#define IQ_I2C_HZ 400000
+#define IQ_SPI_HZ 8000000
+
+typedef struct {
+    uint8_t regs[2][256]; // [0] IMU, [1] PPG
+    uint32_t log[64];     // dev << 8 | reg of each transaction, in bus order
+    uint32_t logged;
+} iq_devices_t;
+
+static iq_devices_t devs;
+static ns_iom_queue_t q;
+static ns_iom_sim_t sim;
+
+static uint32_t iq_device(void *ctx, const ns_iom_xfer_t *x) {
+    iq_devices_t *d = (iq_devices_t *)ctx;
+    uint8_t *regs;
+
+    if (d->logged < 64) {
+        d->log[d->logged++] = ((uint32_t)x->dev << 8) | x->reg;
+    }
+    if ((x->dev == IQ_IMU) || (x->dev == 1)) {
+        regs = d->regs[0];
+    } else if ((x->dev == IQ_PPG) || (x->dev == 2)) {
+        regs = d->regs[1];
+    } else {
+        return NS_STATUS_FAILURE; // NAK
+    }
+    for (uint32_t i = 0; i < x->len; i++) {
+        if (x->dir == NS_IOM_READ) {
+            ((uint8_t *)x->buf)[i] = regs[(x->reg + i) & 0xFF];
+        } else {
+            regs[(x->reg + i) & 0xFF] = ((uint8_t *)x->buf)[i];
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static void iq_setup(bool spi) {
+    memset(&q, 0, sizeof(q));
+    memset(&devs, 0, sizeof(devs));
+    for (uint32_t i = 0; i < 256; i++) {
+        devs.regs[0][i] = (uint8_t)i;
+        devs.regs[1][i] = (uint8_t)(0xFF - i);
+    }
+    q.api = &ns_iom_queue_V0_0_1;
+    ns_iom_sim_init(&sim, &q, spi ? IQ_SPI_HZ : IQ_I2C_HZ, spi);
+    sim.device = iq_device;
+    sim.deviceCtx = &devs;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_queue_init(&q));
+}
+
+typedef struct {
+    uint32_t calls;
+    uint32_t order[32];
+    ns_iom_batch_t *resubmit; // Submitted again from the callback, once
+} iq_cb_log_t;
+
+static iq_cb_log_t cbLog;
+
+static void iq_cb(ns_iom_batch_t *b, void *arg) {
+    if (cbLog.calls < 32) {
+        cbLog.order[cbLog.calls] = (uint32_t)(uintptr_t)arg;
+    }
+    cbLog.calls++;
+    TEST_ASSERT_TRUE(ns_iom_batch_done(b));
+    if (cbLog.resubmit == b) {
+        cbLog.resubmit = NULL;
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_submit(&q, b));
+    }
+}
+
+void ns_iom_queue_tests_pre_test_hook() {}
+
+void ns_iom_queue_tests_post_test_hook() {}
+
+void ns_iom_queue_init_test() {
+    ns_iom_port_t bad = {0};
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_iom_queue_init(NULL));
+
+    memset(&q, 0, sizeof(q));
+    ns_iom_sim_init(&sim, &q, IQ_I2C_HZ, false);
+    q.api = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_iom_queue_init(&q));
+
+    q.api = &ns_iom_queue_V0_0_1;
+    q.port = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_iom_queue_init(&q));
+    q.port = &bad;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_iom_queue_init(&q));
+
+    iq_setup(false);
+    ns_iom_batch_t empty = {0};
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_iom_submit(&q, &empty));
+}
+
+// Register reads and writes for two devices in one batch
+void ns_iom_queue_batch_test() {
+    uint8_t accel[6], ppg[3], cfg[2] = {0xA5, 0x5A}, back[2];
+    ns_iom_xfer_t xfers[] = {
+        NS_IOM_WRITE_REG(IQ_IMU, 0x1B, cfg, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x3B, accel, 6),
+        NS_IOM_READ_REG(IQ_PPG, 0x07, ppg, 3),
+        NS_IOM_READ_REG(IQ_IMU, 0x1B, back, 2),
+    };
+    ns_iom_batch_t batch = {.xfers = xfers, .count = 4, .callback = iq_cb, .arg = (void *)1};
+
+    iq_setup(false);
+    memset(&cbLog, 0, sizeof(cbLog));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_submit(&q, &batch));
+
+    // Submitting returns at once, nothing has happened on the bus yet
+    TEST_ASSERT_EQUAL(0, sim.nowUs);
+    TEST_ASSERT_FALSE(ns_iom_batch_done(&batch));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_iom_submit(&q, &batch));
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_wait(&q, &batch));
+    TEST_ASSERT_EQUAL(1, cbLog.calls);
+    for (uint32_t i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0x3B + i, accel[i]);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xFF - 0x07 - i, ppg[i]);
+    }
+    TEST_ASSERT_EQUAL_HEX8(0xA5, back[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x5A, back[1]);
+
+    TEST_ASSERT_EQUAL(1, q.stats.batches);
+    TEST_ASSERT_EQUAL(4, q.stats.transactions);
+    TEST_ASSERT_EQUAL(11, q.stats.bytesRead);
+    TEST_ASSERT_EQUAL(2, q.stats.bytesWritten);
+    TEST_ASSERT_EQUAL(0, q.stats.errors);
+
+    // Done batches can be submitted again
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_submit(&q, &batch));
+    ns_iom_flush(&q);
+    TEST_ASSERT_EQUAL(2, cbLog.calls);
+    TEST_ASSERT_EQUAL(2, q.stats.batches);
+}
+
+// Transactions run back to back, the CPU is free meanwhile
+void ns_iom_queue_timing_test() {
+    uint8_t buf[14];
+    ns_iom_xfer_t x = NS_IOM_READ_REG(IQ_IMU, 0x3B, buf, 14);
+    ns_iom_xfer_t xfers[] = {x, x, x};
+    ns_iom_batch_t batch = {.xfers = xfers, .count = 3};
+    uint32_t oneUs;
+
+    iq_setup(false);
+    // Start, addr, reg, repeated start, addr, 14 bytes, stop = 1 + 9 + 9 + 1 + 9 + 126 + 1
+    oneUs = ns_iom_sim_xfer_us(&sim, &x);
+    TEST_ASSERT_EQUAL((156 * 1000000 + IQ_I2C_HZ - 1) / IQ_I2C_HZ, oneUs);
+
+    ns_iom_submit(&q, &batch);
+    ns_iom_sim_advance(&sim, oneUs);
+    TEST_ASSERT_FALSE(ns_iom_batch_done(&batch));
+    TEST_ASSERT_EQUAL(1, q.stats.transactions);
+    ns_iom_sim_advance(&sim, 2 * oneUs - 1);
+    TEST_ASSERT_FALSE(ns_iom_batch_done(&batch));
+    ns_iom_sim_advance(&sim, 1);
+    TEST_ASSERT_TRUE(ns_iom_batch_done(&batch));
+    TEST_ASSERT_EQUAL(3 * oneUs, batch.doneUs - batch.submitUs);
+    TEST_ASSERT_EQUAL(3 * oneUs, q.stats.busyUs);
+    TEST_ASSERT_EQUAL(3 * oneUs, q.stats.latencyMaxUs);
+
+    // Idle time is not busy time
+    ns_iom_sim_advance(&sim, 1000);
+    ns_iom_submit(&q, &batch);
+    ns_iom_wait(&q, &batch);
+    TEST_ASSERT_EQUAL(6 * oneUs, q.stats.busyUs);
+    TEST_ASSERT_EQUAL(3 * oneUs, batch.doneUs - batch.submitUs);
+}
+
+// Many batches, more transactions than the port holds, callbacks in submission order
+void ns_iom_queue_order_test() {
+    static uint8_t bufs[20][4];
+    static ns_iom_xfer_t xfers[20][3];
+    static ns_iom_batch_t batches[20];
+    uint32_t lfsr = 0x1234567;
+
+    iq_setup(false);
+    memset(&cbLog, 0, sizeof(cbLog));
+    for (uint32_t b = 0; b < 20; b++) {
+        lfsr ^= lfsr << 13;
+        lfsr ^= lfsr >> 17;
+        lfsr ^= lfsr << 5;
+        uint32_t n = 1 + lfsr % 3;
+        for (uint32_t i = 0; i < n; i++) {
+            ns_iom_xfer_t x = NS_IOM_READ_REG(i & 1 ? IQ_PPG : IQ_IMU, b * 4 + i, bufs[b], 1);
+            xfers[b][i] = x;
+        }
+        batches[b] = (ns_iom_batch_t){
+            .xfers = xfers[b], .count = n, .callback = iq_cb, .arg = (void *)(uintptr_t)b};
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_submit(&q, &batches[b]));
+        if (b % 7 == 6) {
+            ns_iom_sim_advance(&sim, 200);
+        }
+    }
+    cbLog.resubmit = &batches[3];
+    ns_iom_flush(&q);
+
+    TEST_ASSERT_EQUAL(21, cbLog.calls);
+    for (uint32_t i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL(i, cbLog.order[i]);
+    }
+    TEST_ASSERT_EQUAL(3, cbLog.order[20]);
+    TEST_ASSERT_EQUAL(21, q.stats.batches);
+    TEST_ASSERT_TRUE(q.stats.maxQueued > 1);
+
+    // Bus order is submission order
+    uint32_t k = 0;
+    for (uint32_t b = 0; b < 20; b++) {
+        for (uint32_t i = 0; i < batches[b].count; i++, k++) {
+            TEST_ASSERT_EQUAL_HEX32((xfers[b][i].dev << 8) | xfers[b][i].reg, devs.log[k]);
+        }
+    }
+}
+
+// A NAK fails its batch and skips the rest of it, later batches are unaffected
+void ns_iom_queue_error_test() {
+    uint8_t a[2], b[2], c[2];
+    ns_iom_xfer_t bad[] = {
+        NS_IOM_READ_REG(IQ_IMU, 0x10, a, 2),
+        NS_IOM_READ_REG(IQ_MISSING, 0x00, b, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x20, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x30, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x40, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x50, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x60, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x70, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x80, c, 2),
+        NS_IOM_READ_REG(IQ_IMU, 0x90, c, 2),
+    };
+    ns_iom_xfer_t good[] = {NS_IOM_READ_REG(IQ_PPG, 0x01, b, 2)};
+    ns_iom_batch_t b1 = {.xfers = bad, .count = 10};
+    ns_iom_batch_t b2 = {.xfers = good, .count = 1};
+
+    iq_setup(false);
+    ns_iom_submit(&q, &b1);
+    ns_iom_submit(&q, &b2);
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_iom_wait(&q, &b1));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_wait(&q, &b2));
+    TEST_ASSERT_EQUAL_HEX8(0xFE, b[0]);
+
+    // Only what was already in the port ran after the NAK: the first NS_IOM_SIM_DEPTH, and
+    // the one started when the first completed
+    TEST_ASSERT_EQUAL(NS_IOM_SIM_DEPTH + 1, b1.issued);
+    TEST_ASSERT_EQUAL(1, q.stats.errors);
+    TEST_ASSERT_EQUAL(NS_IOM_SIM_DEPTH + 2, q.stats.transactions);
+    TEST_ASSERT_EQUAL(2, q.stats.batches);
+    TEST_ASSERT_EQUAL(NULL, q.head);
+}
+
+void ns_iom_queue_spi_test() {
+    uint8_t fifo[96];
+    ns_iom_xfer_t x = {
+        .dev = 1, .dir = NS_IOM_READ, .regLen = 1, .reg = 0x80, .buf = fifo, .len = 96};
+    ns_iom_batch_t batch = {.xfers = &x, .count = 1};
+
+    iq_setup(true);
+    sim.setupUs = 2;
+    TEST_ASSERT_EQUAL(2 + (97 * 8 * 1000000 + IQ_SPI_HZ - 1) / IQ_SPI_HZ,
+                      ns_iom_sim_xfer_us(&sim, &x));
+    ns_iom_submit(&q, &batch);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_iom_wait(&q, &batch));
+    TEST_ASSERT_EQUAL_HEX8(0x80, fifo[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xDF, fifo[95]);
+    TEST_ASSERT_EQUAL(96, q.stats.bytesRead);
+}
+
+// A sensor loop reading an IMU and a PPG every 10 ms: CPU time stalled on the bus when every
+// register read blocks, against a queued batch per frame. Also measures the host cost of the
+// queue bookkeeping per transaction.
+void ns_iom_queue_benchmark_test() {
+    uint8_t accel[6], gyro[6], temp[2], ppg[9], status[1];
+    ns_iom_xfer_t xfers[] = {
+        NS_IOM_READ_REG(IQ_IMU, 0x3A, status, 1), NS_IOM_READ_REG(IQ_IMU, 0x3B, accel, 6),
+        NS_IOM_READ_REG(IQ_IMU, 0x41, temp, 2),   NS_IOM_READ_REG(IQ_IMU, 0x43, gyro, 6),
+        NS_IOM_READ_REG(IQ_PPG, 0x00, status, 1), NS_IOM_READ_REG(IQ_PPG, 0x07, ppg, 9),
+    };
+    ns_iom_batch_t batch = {.xfers = xfers, .count = 6};
+    const uint32_t frames = 1000, periodUs = 10000;
+    uint32_t blockedUs = 0, start;
+
+    iq_setup(false);
+    for (uint32_t f = 0; f < frames; f++) {
+        start = sim.nowUs;
+        for (uint32_t i = 0; i < 6; i++) {
+            ns_iom_sim_blocking(&sim, &xfers[i]);
+        }
+        blockedUs += sim.nowUs - start;
+        ns_iom_sim_advance(&sim, periodUs - (sim.nowUs - start));
+    }
+
+    iq_setup(false);
+    for (uint32_t f = 0; f < frames; f++) {
+        start = sim.nowUs;
+        ns_iom_submit(&q, &batch);
+        TEST_ASSERT_EQUAL(start, sim.nowUs); // The CPU is free for the whole frame
+        ns_iom_sim_advance(&sim, periodUs);
+        TEST_ASSERT_TRUE(ns_iom_batch_done(&batch));
+    }
+    TEST_ASSERT_EQUAL(frames, q.stats.batches);
+    TEST_ASSERT_EQUAL(frames * 6, q.stats.transactions);
+    TEST_ASSERT_EQUAL(blockedUs, q.stats.busyUs);
+
+    ns_lp_printf("IOM queue, %u frames of 6 register reads at 400 kHz:\n", frames);
+    ns_lp_printf("  blocking: CPU stalled %u us per frame (%u%% of the frame)\n",
+                 blockedUs / frames, 100 * blockedUs / (frames * periodUs));
+    ns_lp_printf("  queued:   CPU stalled 0 us, bus busy %u us per frame, latency avg %u us\n",
+                 (uint32_t)(q.stats.busyUs / frames),
+                 (uint32_t)(q.stats.latencySumUs / q.stats.batches));
+
+    // Host cost of the queue itself: submit plus six completions
+    ns_timer_config_t bench_timer = {
+        .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+    ns_timer_init(&bench_timer);
+    const uint32_t loops = 100000;
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t i = 0; i < loops; i++) {
+        ns_iom_submit(&q, &batch);
+        ns_iom_wait(&q, &batch);
+    }
+    uint32_t hostUs = ns_us_ticker_read(&bench_timer) - start;
+    ns_lp_printf("  bookkeeping: %u ns per transaction (host)\n",
+                 (uint32_t)((uint64_t)hostUs * 1000 / (loops * 6)));
+}
@@ -0,0 +1,12 @@
+#include "ns_iom_queue.h"
+#include "ns_core.h"
+
+void ns_iom_queue_tests_pre_test_hook();
+void ns_iom_queue_tests_post_test_hook();
+void ns_iom_queue_init_test();
+void ns_iom_queue_batch_test();
+void ns_iom_queue_timing_test();
+void ns_iom_queue_order_test();
+void ns_iom_queue_error_test();
+void ns_iom_queue_spi_test();
+void ns_iom_queue_benchmark_test();
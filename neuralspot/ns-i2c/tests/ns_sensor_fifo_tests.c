@@ -0,0 +1,419 @@
+#include "unity/unity.h"
+#include "ns_sensor_fifo_tests.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_timer.h"
+#include <string.h>
+
+// Byte streams below were laid out as the sensors deliver them (big-endian, interleaved
+// frames). The MAX86150 drain runs against a simulated device behind the driver's I2C hooks,
+// the MPU6050 drain against one behind the register layer defined below.
+
+// MAX86150, 3 slots (PPG LED1, PPG LED2, ECG), 4 samples. Unused top bits of PPG words set.
+static const uint8_t ppgEcgCapture[] = {
+    0xF9, 0x23, 0x45, 0x00, 0x00, 0x01, 0x03, 0xFF, 0xFF, // 0x12345, 1, -1
+    0x07, 0xFF, 0xFF, 0x00, 0x10, 0x00, 0x02, 0x00, 0x00, // 0x7FFFF, 0x1000, -131072
+    0x00, 0x00, 0x00, 0x05, 0x55, 0x55, 0x01, 0xFF, 0xFF, // 0, 0x55555, 131071
+    0x01, 0x00, 0x00, 0xF8, 0x00, 0x07, 0xFC, 0x00, 0x10, // 0x10000, 7, 16
+};
+static const int32_t ppgEcgExpected[3][4] = {
+    {0x12345, 0x7FFFF, 0, 0x10000},
+    {1, 0x1000, 0x55555, 7},
+    {-1, -131072, 131071, 16},
+};
+
+// MPU6050, accel + temp + gyro (14 byte frames), 3 frames, 2 g and 250 dps ranges
+static const uint8_t imuCapture[] = {
+    0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0xF2, 0x06, 0x00, 0x83, 0xFF, 0x7D, 0x00, 0x00,
+    0xC0, 0x00, 0x20, 0x00, 0x00, 0x00, 0xF2, 0x06, 0x80, 0x00, 0x7F, 0xFF, 0xFF, 0xFF,
+    0x01, 0x00, 0xFF, 0x00, 0xBF, 0xFF, 0xF2, 0x10, 0x00, 0x01, 0x00, 0x00, 0xFF, 0xFE,
+};
+static const int32_t imuExpected[7][3] = {
+    {0, -16384, 256},       // accel x
+    {0, 8192, -256},        // accel y
+    {16384, 0, -16385},     // accel z
+    {-3578, -3578, -3568},  // temp
+    {131, -32768, 1},       // gyro x
+    {-131, 32767, 0},       // gyro y
+    {0, -1, -2},            // gyro z
+};
+
+void ns_sensor_fifo_tests_pre_test_hook() {}
+
+void ns_sensor_fifo_tests_post_test_hook() {}
+
+void ns_sensor_fifo_unpack_be24_test() {
+    const uint8_t bits[3] = {19, 19, 18};
+    const float scale[3] = {1.0f, 0.5f, 2.0f};
+    int32_t planes[3 * 5];
+    float fplanes[3 * 4];
+
+    // Stride larger than the frame count leaves the gaps alone
+    memset(planes, 0x5A, sizeof(planes));
+    ns_unpack_be24_i32(ppgEcgCapture, 4, 3, bits, 1 << 2, planes, 5);
+    for (uint32_t c = 0; c < 3; c++) {
+        TEST_ASSERT_EQUAL_INT32_ARRAY(ppgEcgExpected[c], &planes[c * 5], 4);
+        TEST_ASSERT_EQUAL_HEX32(0x5A5A5A5A, planes[c * 5 + 4]);
+    }
+
+    ns_unpack_be24_f32(ppgEcgCapture, 4, 3, bits, 1 << 2, scale, fplanes, 4);
+    for (uint32_t c = 0; c < 3; c++) {
+        for (uint32_t i = 0; i < 4; i++) {
+            TEST_ASSERT_EQUAL_FLOAT((float)ppgEcgExpected[c][i] * scale[c], fplanes[c * 4 + i]);
+        }
+    }
+}
+
+void ns_sensor_fifo_unpack_be16_test() {
+    int32_t planes[7 * 3];
+    float fplanes[7 * 3];
+    float scale[7];
+
+    ns_unpack_be16_i32(imuCapture, 3, 7, planes, 3);
+    for (uint32_t c = 0; c < 7; c++) {
+        TEST_ASSERT_EQUAL_INT32_ARRAY(imuExpected[c], &planes[c * 3], 3);
+    }
+
+    // The scales mpu6050_unpack_fifo() would be given for 2 g / 250 dps
+    for (uint32_t c = 0; c < 7; c++) {
+        scale[c] = c < 3 ? 1.0f / 16384 : c == 3 ? 1.0f / 340 : 1.0f / 131;
+    }
+    ns_unpack_be16_f32(imuCapture, 3, 7, scale, fplanes, 3);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, fplanes[2 * 3 + 0]);  // z at rest, 1 g
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, fplanes[0 * 3 + 1]); // x, -1 g
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 26.0f, fplanes[3 * 3 + 0] + 36.53f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, fplanes[4 * 3 + 0]); // 1 dps
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, fplanes[5 * 3 + 0]);
+}
+
+// Simulated MAX86150: pointer registers and a FIFO of packed samples
+typedef struct {
+    uint8_t wrPtr, ovfCnt, rdPtr;
+    uint8_t fifo[32 * 12];
+    uint32_t transactions;
+    uint32_t bytes;
+} sf_max86150_t;
+
+static sf_max86150_t dev;
+
+static int sf_write_read(
+    uint16_t addr, const void *writeBuf, size_t numWrite, void *readBuf, size_t numRead) {
+    uint8_t reg = *(const uint8_t *)writeBuf;
+    uint8_t *out = (uint8_t *)readBuf;
+
+    TEST_ASSERT_EQUAL(0x5E, addr);
+    TEST_ASSERT_EQUAL(1, numWrite);
+    dev.transactions++;
+    dev.bytes += numRead;
+    if (reg == 0x04) {
+        TEST_ASSERT_EQUAL(3, numRead);
+        out[0] = dev.wrPtr;
+        out[1] = dev.ovfCnt;
+        out[2] = dev.rdPtr;
+    } else if (reg == 0x07) {
+        TEST_ASSERT_TRUE(numRead <= sizeof(dev.fifo));
+        memcpy(out, dev.fifo, numRead);
+        dev.ovfCnt = 0;
+    } else {
+        TEST_FAIL_MESSAGE("unexpected register");
+    }
+    return 0;
+}
+
+static int sf_unused_read(const void *buf, uint32_t n, uint16_t addr) {
+    TEST_FAIL_MESSAGE("per-sample read");
+    return 0;
+}
+
+static int sf_unused_write(const void *buf, uint32_t n, uint16_t addr) {
+    TEST_FAIL_MESSAGE("separate register write");
+    return 0;
+}
+
+static uint32_t sf_clock;
+static uint32_t sf_now_us(void) { return sf_clock; }
+
+static const max86150_context_t sfCtx = {
+    .addr = 0x5E,
+    .i2c_write_read = sf_write_read,
+    .i2c_read = sf_unused_read,
+    .i2c_write = sf_unused_write,
+    .now_us = sf_now_us,
+};
+
+static void sf_fill(void) {
+    for (uint32_t i = 0; i < sizeof(dev.fifo); i++) {
+        dev.fifo[i] = ppgEcgCapture[i % sizeof(ppgEcgCapture)];
+    }
+}
+
+void ns_sensor_fifo_max86150_drain_test() {
+    static max86150_fifo_batch_t batch;
+    const max86150_slot_type slots[3] = {
+        Max86150SlotPpgLed1, Max86150SlotPpgLed2, Max86150SlotEcg};
+    int32_t planes[3 * 32];
+
+    memset(&batch, 0, sizeof(batch));
+    memset(&dev, 0, sizeof(dev));
+    sf_fill();
+
+    // 4 samples, one transaction for the pointers and one for the data
+    dev.wrPtr = 5;
+    dev.rdPtr = 1;
+    sf_clock = 1000;
+    TEST_ASSERT_EQUAL(4, max86150_read_fifo_burst(&sfCtx, 3, &batch));
+    TEST_ASSERT_EQUAL(2, dev.transactions);
+    TEST_ASSERT_EQUAL(3 + 4 * 9, dev.bytes);
+    TEST_ASSERT_EQUAL(1000, batch.timestampUs);
+    TEST_ASSERT_EQUAL(0, batch.overflow);
+    max86150_unpack_fifo(&batch, slots, 3, planes, 32);
+    for (uint32_t c = 0; c < 3; c++) {
+        TEST_ASSERT_EQUAL_INT32_ARRAY(ppgEcgExpected[c], &planes[c * 32], 4);
+    }
+
+    // Pointers wrap
+    dev.wrPtr = 2;
+    dev.rdPtr = 30;
+    TEST_ASSERT_EQUAL(4, max86150_read_fifo_burst(&sfCtx, 3, &batch));
+
+    // Equal pointers without overflow: empty, a single transaction
+    dev.transactions = 0;
+    dev.wrPtr = 7;
+    dev.rdPtr = 7;
+    TEST_ASSERT_EQUAL(0, max86150_read_fifo_burst(&sfCtx, 3, &batch));
+    TEST_ASSERT_EQUAL(1, dev.transactions);
+
+    // Overflow: full FIFO, lost samples counted
+    dev.ovfCnt = 5;
+    sf_clock = 2000;
+    TEST_ASSERT_EQUAL(32, max86150_read_fifo_burst(&sfCtx, 3, &batch));
+    TEST_ASSERT_EQUAL(5, batch.overflow);
+    dev.ovfCnt = 2;
+    TEST_ASSERT_EQUAL(32, max86150_read_fifo_burst(&sfCtx, 3, &batch));
+    TEST_ASSERT_EQUAL(2, batch.overflow);
+    TEST_ASSERT_EQUAL(7, batch.overflowTotal);
+    TEST_ASSERT_EQUAL(4, batch.batches);
+    TEST_ASSERT_EQUAL(2000, batch.timestampUs);
+    max86150_unpack_fifo(&batch, slots, 3, planes, 32);
+    TEST_ASSERT_EQUAL_INT32(-131072, planes[2 * 32 + 1]);
+    TEST_ASSERT_EQUAL_INT32(16, planes[2 * 32 + 31]);
+
+    // All four slots, a full FIFO is the largest burst
+    dev.ovfCnt = 1;
+    TEST_ASSERT_EQUAL(32, max86150_read_fifo_burst(&sfCtx, 4, &batch));
+    TEST_ASSERT_EQUAL(0, max86150_read_fifo_burst(&sfCtx, 5, &batch));
+}
+
+// Simulated MPU6050. The test provides the ns_i2c_register_driver.h functions, so the driver's
+// register accesses land here instead of on the IOM.
+typedef struct {
+    uint8_t intStatus;
+    uint16_t count; // FIFO_COUNT as the device reports it, a bad read can exceed the FIFO
+    uint8_t fifo[MPU6050_FIFO_SIZE];
+    uint32_t fifoReads;
+    uint32_t fifoBytes;
+    uint32_t resets;
+} sf_mpu6050_t;
+
+static sf_mpu6050_t imu;
+static ns_i2c_config_t sfI2c;
+
+uint32_t ns_i2c_read_sequential_regs(
+    ns_i2c_config_t *cfg, uint32_t devAddr, uint32_t regAddr, void *buf, uint32_t size) {
+    uint8_t *out = (uint8_t *)buf;
+
+    TEST_ASSERT_EQUAL_PTR(&sfI2c, cfg);
+    TEST_ASSERT_EQUAL(MPU_I2CADDRESS_AD0_LOW, devAddr);
+    if (regAddr == 0x3A) { // INT_STATUS, cleared by the read
+        TEST_ASSERT_EQUAL(1, size);
+        out[0] = imu.intStatus;
+        imu.intStatus = 0;
+    } else if (regAddr == 0x72) { // FIFO_COUNT_H, FIFO_COUNT_L
+        TEST_ASSERT_EQUAL(2, size);
+        out[0] = (uint8_t)(imu.count >> 8);
+        out[1] = (uint8_t)imu.count;
+    } else if (regAddr == 0x74) { // FIFO_R_W
+        TEST_ASSERT_TRUE(size <= sizeof(imu.fifo));
+        memcpy(out, imu.fifo, size);
+        imu.fifoReads++;
+        imu.fifoBytes += size;
+    } else {
+        TEST_FAIL_MESSAGE("unexpected register");
+    }
+    return NS_I2C_STATUS_SUCCESS;
+}
+
+uint32_t ns_i2c_write_sequential_regs(
+    ns_i2c_config_t *cfg, uint32_t devAddr, uint32_t regAddr, void *buf, uint32_t size) {
+    TEST_FAIL_MESSAGE("unexpected burst write");
+    return NS_I2C_STATUS_ERROR;
+}
+
+uint32_t ns_i2c_read_reg(
+    ns_i2c_config_t *cfg, uint32_t devAddr, uint8_t regAddr, uint8_t *value, uint8_t mask) {
+    uint32_t status = ns_i2c_read_sequential_regs(cfg, devAddr, regAddr, value, 1);
+
+    *value &= mask;
+    return status;
+}
+
+uint32_t ns_i2c_write_reg(
+    ns_i2c_config_t *cfg, uint32_t devAddr, uint8_t regAddr, uint8_t value, uint8_t mask) {
+    TEST_ASSERT_EQUAL_PTR(&sfI2c, cfg);
+    TEST_ASSERT_EQUAL(0x6A, regAddr); // USER_CTRL
+    if (value & mask & (1 << 2)) {     // FIFO_RESET
+        imu.resets++;
+        imu.count = 0;
+    }
+    return NS_I2C_STATUS_SUCCESS;
+}
+
+void ns_sensor_fifo_mpu6050_drain_test() {
+    static mpu6050_fifo_batch_t batch;
+    const uint32_t addr = MPU_I2CADDRESS_AD0_LOW;
+    const mpu6050_fifo_config_t fifoConfig = {
+        .tempEnable = 1, .xgEnable = 1, .ygEnable = 1, .zgEnable = 1, .accelEnable = 1};
+    float scale[7];
+    float planes[7 * 3];
+
+    memset(&imu, 0, sizeof(imu));
+    memset(&batch, 0, sizeof(batch));
+    for (uint32_t i = 0; i < sizeof(imu.fifo); i++) {
+        imu.fifo[i] = imuCapture[i % sizeof(imuCapture)];
+    }
+    for (uint32_t c = 0; c < 7; c++) {
+        scale[c] = 1.0f;
+    }
+    batch.frameBytes = mpu6050_fifo_frame_bytes(&fifoConfig);
+    batch.now_us = sf_now_us;
+    TEST_ASSERT_EQUAL(14, batch.frameBytes);
+
+    // 3 frames and part of a fourth: the whole frames in one read, the rest left for later
+    imu.count = 3 * 14 + 5;
+    sf_clock = 3000;
+    TEST_ASSERT_EQUAL(MPU6050_STATUS_SUCCESS, mpu6050_read_fifo_burst(&sfI2c, addr, &batch));
+    TEST_ASSERT_EQUAL(3, batch.numFrames);
+    TEST_ASSERT_EQUAL(1, imu.fifoReads);
+    TEST_ASSERT_EQUAL(3 * 14, imu.fifoBytes);
+    TEST_ASSERT_EQUAL(3000, batch.timestampUs);
+    mpu6050_unpack_fifo(&batch, scale, planes, 3);
+    for (uint32_t c = 0; c < 7; c++) {
+        for (uint32_t i = 0; i < 3; i++) {
+            TEST_ASSERT_EQUAL_FLOAT((float)imuExpected[c][i], planes[c * 3 + i]);
+        }
+    }
+
+    // Less than a frame: no FIFO read
+    imu.count = 13;
+    TEST_ASSERT_EQUAL(MPU6050_STATUS_SUCCESS, mpu6050_read_fifo_burst(&sfI2c, addr, &batch));
+    TEST_ASSERT_EQUAL(0, batch.numFrames);
+    TEST_ASSERT_EQUAL(1, imu.fifoReads);
+
+    // Overflow: frame alignment is lost, the FIFO is reset rather than read
+    imu.count = MPU6050_FIFO_SIZE;
+    imu.intStatus = 1 << 4;
+    TEST_ASSERT_EQUAL(MPU6050_STATUS_SUCCESS, mpu6050_read_fifo_burst(&sfI2c, addr, &batch));
+    TEST_ASSERT_EQUAL(0, batch.numFrames);
+    TEST_ASSERT_EQUAL(1, batch.overflows);
+    TEST_ASSERT_EQUAL(1, imu.resets);
+    TEST_ASSERT_EQUAL(1, imu.fifoReads);
+
+    // A count past the FIFO size (bad read) is clamped to what raw can hold
+    imu.count = 0xFFFF;
+    TEST_ASSERT_EQUAL(MPU6050_STATUS_SUCCESS, mpu6050_read_fifo_burst(&sfI2c, addr, &batch));
+    TEST_ASSERT_EQUAL(MPU6050_FIFO_SIZE / 14, batch.numFrames);
+    TEST_ASSERT_EQUAL(2, imu.fifoReads);
+    TEST_ASSERT_EQUAL(3 * 14 + (MPU6050_FIFO_SIZE / 14) * 14, imu.fifoBytes);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(
+        imuCapture + ((MPU6050_FIFO_SIZE / 14 - 1) % 3) * 14,
+        batch.raw + (MPU6050_FIFO_SIZE / 14 - 1) * 14, 14);
+
+    // Frames larger than the FIFO are rejected
+    batch.frameBytes = MPU6050_FIFO_SIZE + 2;
+    TEST_ASSERT_EQUAL(MPU6050_STATUS_ERROR, mpu6050_read_fifo_burst(&sfI2c, addr, &batch));
+    TEST_ASSERT_EQUAL(2, imu.fifoReads);
+}
+
+// max86150_read_fifo_samples keeps its interleaved, masked output
+void ns_sensor_fifo_max86150_legacy_test() {
+    max86150_slot_type slots[3] = {Max86150SlotPpgLed1, Max86150SlotPpgLed2, Max86150SlotEcg};
+    uint32_t buffer[32 * 3];
+
+    memset(&dev, 0, sizeof(dev));
+    sf_fill();
+    dev.wrPtr = 4;
+    TEST_ASSERT_EQUAL(4, max86150_read_fifo_samples(&sfCtx, buffer, slots, 3));
+    TEST_ASSERT_EQUAL(2, dev.transactions);
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_HEX32(ppgEcgExpected[0][i], buffer[i * 3 + 0]);
+        TEST_ASSERT_EQUAL_HEX32(ppgEcgExpected[1][i], buffer[i * 3 + 1]);
+        TEST_ASSERT_EQUAL_HEX32((uint32_t)ppgEcgExpected[2][i] & 0x3FFFF, buffer[i * 3 + 2]);
+    }
+}
+
+// The previous unpack: a temp[4] memcpy per slot per sample, interleaved output
+static void sf_unpack_reference(
+    const uint8_t *rdBytes, uint32_t numSamples, const max86150_slot_type *slots,
+    uint8_t numSlots, uint32_t *buffer) {
+    uint8_t temp[4];
+    uint32_t rdBytesIdx = 0, bufferIdx = 0;
+    for (uint32_t i = 0; i < numSamples; i++) {
+        for (uint32_t j = 0; j < numSlots; j++) {
+            temp[3] = 0;
+            temp[2] = rdBytes[rdBytesIdx++];
+            temp[1] = rdBytes[rdBytesIdx++];
+            temp[0] = rdBytes[rdBytesIdx++];
+            memcpy(&buffer[bufferIdx], temp, 4);
+            buffer[bufferIdx] &= slots[j] == Max86150SlotEcg ? 0x3FFFF : 0x7FFFF;
+            bufferIdx++;
+        }
+    }
+}
+
+void ns_sensor_fifo_benchmark_test() {
+    static max86150_fifo_batch_t batch;
+    static uint32_t interleaved[32 * 4];
+    static int32_t planes[4 * 32];
+    const max86150_slot_type slots[4] = {
+        Max86150SlotPpgLed1, Max86150SlotPpgLed2, Max86150SlotPilotLed1, Max86150SlotEcg};
+    const uint32_t loops = 20000;
+    uint32_t start, refUs, newUs, check = 0;
+
+    for (uint32_t i = 0; i < sizeof(batch.raw); i++) {
+        batch.raw[i] = (uint8_t)(i * 37 + 11);
+    }
+    batch.numSamples = 32;
+
+    ns_timer_config_t bench_timer = {
+        .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+    ns_timer_init(&bench_timer);
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t l = 0; l < loops; l++) {
+        batch.raw[0] = (uint8_t)l;
+        sf_unpack_reference(batch.raw, 32, slots, 4, interleaved);
+        check += interleaved[l & 127];
+    }
+    refUs = ns_us_ticker_read(&bench_timer) - start;
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t l = 0; l < loops; l++) {
+        batch.raw[0] = (uint8_t)l;
+        max86150_unpack_fifo(&batch, slots, 4, planes, 32);
+        check += (uint32_t)planes[l & 127];
+    }
+    newUs = ns_us_ticker_read(&bench_timer) - start;
+
+    // Same samples either way, ECG now sign extended
+    for (uint32_t i = 0; i < 32; i++) {
+        for (uint32_t j = 0; j < 4; j++) {
+            uint32_t mask = j == 3 ? 0x3FFFF : 0x7FFFF;
+            TEST_ASSERT_EQUAL_HEX32(interleaved[i * 4 + j], (uint32_t)planes[j * 32 + i] & mask);
+        }
+    }
+
+    ns_lp_printf("MAX86150 full FIFO (32 samples x 4 slots), %u drains:\n", loops);
+    ns_lp_printf("  I2C transactions per drain: %u per-sample, 2 burst\n", 2 + 32);
+    ns_lp_printf("  unpack: %u ns byte-wise, %u ns planar (host), check %u\n",
+                 (uint32_t)((uint64_t)refUs * 1000 / loops),
+                 (uint32_t)((uint64_t)newUs * 1000 / loops), check & 1);
+}
@@ -0,0 +1,14 @@
+#include "ns_max86150_driver.h"
+#include "ns_mpu6050_i2c_driver.h"
+#include "ns_i2c_register_driver.h"
+#include "ns_sensor_unpack.h"
+#include "ns_core.h"
+
+void ns_sensor_fifo_tests_pre_test_hook();
+void ns_sensor_fifo_tests_post_test_hook();
+void ns_sensor_fifo_unpack_be24_test();
+void ns_sensor_fifo_unpack_be16_test();
+void ns_sensor_fifo_max86150_drain_test();
+void ns_sensor_fifo_max86150_legacy_test();
+void ns_sensor_fifo_mpu6050_drain_test();
+void ns_sensor_fifo_benchmark_test();
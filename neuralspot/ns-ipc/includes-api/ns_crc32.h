@@ -0,0 +1,107 @@
+/**
+ * @file ns_crc32.h
+ * @author Ambiq
+ * @brief CRC-32 engine: slicing-by-8, incremental, combinable, optional hardware backend
+ * @version 0.1
+ * @date 2025-08-13
+ *
+ * The standard (IEEE 802.3, zlib) CRC-32, the same value CalcCrc32(0xFFFFFFFF, ...) returns.
+ *
+ * - Software path processes 8 bytes per step with eight 256-entry tables (8 KB of flash)
+ *   instead of one byte per step.
+ * - ns_crc32_update() carries the running register, so a CRC is computed while data streams
+ *   in; ns_crc32_final() finishes it.
+ * - ns_crc32_combine() gives the CRC of A followed by B from the CRCs of A and B, so chunks
+ *   received out of order can be checked separately and still yield the CRC of the whole.
+ * - A hardware backend (e.g. the Apollo security block, see ns_crc32_use_hw()) takes the
+ *   word-aligned bulk of long buffers.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef NS_CRC32_H
+#define NS_CRC32_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define NS_CRC32_INIT 0xFFFFFFFF ///< Starting value for ns_crc32_update()
+
+/// Computes the finished CRC-32 of len bytes at words (word aligned, len a multiple of 4),
+/// returns NS_STATUS_SUCCESS or an error to fall back to software
+typedef uint32_t (*ns_crc32_hw_fn_t)(void *ctx, const uint32_t *words, uint32_t len,
+                                     uint32_t *crc);
+
+typedef struct {
+    ns_crc32_hw_fn_t compute;
+    void *ctx;
+    uint32_t minLen; ///< Shorter buffers stay in software, where setup costs more than it saves
+} ns_crc32_backend_t;
+
+/**
+ * @brief Continue a CRC over more data
+ *
+ * @param crc NS_CRC32_INIT, or the value returned by the previous update
+ * @param buf Data
+ * @param len Bytes
+ * @return uint32_t Running CRC, pass it to ns_crc32_final() once all data is in
+ */
+extern uint32_t ns_crc32_update(uint32_t crc, const void *buf, uint32_t len);
+
+/**
+ * @brief Finish a running CRC
+ *
+ * @param crc Value from ns_crc32_update()
+ * @return uint32_t CRC-32
+ */
+static inline uint32_t ns_crc32_final(uint32_t crc) { return crc ^ 0xFFFFFFFF; }
+
+/**
+ * @brief CRC-32 of a buffer
+ *
+ * @param buf Data
+ * @param len Bytes
+ * @return uint32_t CRC-32
+ */
+extern uint32_t ns_crc32(const void *buf, uint32_t len);
+
+/**
+ * @brief CRC-32 of A followed by B
+ *
+ * Costs about log2(lenB) 32-bit carry-less multiplies, independent of the data.
+ *
+ * @param crcA CRC-32 of A
+ * @param crcB CRC-32 of B
+ * @param lenB Length of B in bytes
+ * @return uint32_t CRC-32 of A then B
+ */
+extern uint32_t ns_crc32_combine(uint32_t crcA, uint32_t crcB, uint32_t lenB);
+
+/**
+ * @brief Route long buffers through a hardware backend
+ *
+ * The backend is checked against the software path first and refused if it disagrees. It is
+ * shared, so do not compute CRCs from interrupt handlers while one is set.
+ *
+ * @param backend Backend, NULL to go back to software only
+ * @return uint32_t NS_STATUS_SUCCESS, NS_STATUS_INVALID_CONFIG without a compute function, or
+ *         NS_STATUS_FAILURE if the backend gave a wrong CRC
+ */
+extern uint32_t ns_crc32_set_backend(const ns_crc32_backend_t *backend);
+
+/**
+ * @brief Use the Apollo security block CRC engine (am_hal_crc32) as the backend
+ *
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE where there is no such engine
+ */
+extern uint32_t ns_crc32_use_hw(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_CRC32_H
@@ -0,0 +1,222 @@
+#include "unity/unity.h"
+
+#include "crc32.h"
+#include "ns_crc32_tests.h"
+#include "ns_timer.h"
+#include <stdint.h>
+#include <string.h>
+
+#define BUF_SIZE 4096
+#define BENCH_SIZE 2048
+#define BENCH_REPS 1000
+
+static uint8_t buf[BUF_SIZE + 8];
+static uint32_t rng;
+
+static ns_timer_config_t bench_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+static uint32_t test_rand(void) {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+// One bit at a time, straight from the polynomial
+static uint32_t reference_crc(uint32_t crc, const uint8_t *p, uint32_t len) {
+    uint32_t k;
+    while (len--) {
+        crc ^= *p++;
+        for (k = 0; k < 8; k++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+// The byte-at-a-time table loop CalcCrc32 used before, for the benchmark
+static uint32_t bytewise_table[256];
+
+static uint32_t bytewise_crc(uint32_t crc, const uint8_t *p, uint32_t len) {
+    while (len--) {
+        crc = bytewise_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// Stand-in for a hardware engine: counts what it was given, optionally gets it wrong
+static uint32_t fakeBytes, fakeCalls, fakeError;
+
+static uint32_t fake_hw(void *ctx, const uint32_t *words, uint32_t len, uint32_t *crc) {
+    TEST_ASSERT_EQUAL(0, (uintptr_t)words & 3);
+    TEST_ASSERT_EQUAL(0, len & 3);
+    fakeCalls++;
+    fakeBytes += len;
+    *crc = ~reference_crc(0xFFFFFFFF, (const uint8_t *)words, len) ^ fakeError;
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_crc32_tests_pre_test_hook() {
+    uint32_t i;
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(i * 31 + 7);
+    }
+    for (i = 0; i < 256; i++) {
+        bytewise_table[i] = reference_crc(0, (const uint8_t *)&i, 1);
+    }
+}
+
+void ns_crc32_tests_post_test_hook() {}
+
+void ns_crc32_known_answer_test() {
+    // Values from the byte-at-a-time CalcCrc32 this replaces
+    static const struct {
+        uint32_t offset, len, crc;
+    } kat[] = {
+        {0, 0, 0x00000000U},    {1, 1, 0x000F6A70U},    {3, 3, 0x98E9B3A2U},
+        {0, 7, 0x3E483922U},    {5, 8, 0x76AC9B2AU},    {2, 9, 0xFB3C7B5DU},
+        {7, 15, 0x03C2A7CDU},   {0, 16, 0x0636A895U},   {1, 63, 0x02861533U},
+        {0, 64, 0x84C86088U},   {3, 65, 0x0A3F27E9U},   {6, 255, 0xCF862733U},
+        {11, 1000, 0x990B51BFU}, {0, 1024, 0x7C321B5DU}};
+    uint32_t i, offset, len;
+
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, ns_crc32("123456789", 9));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, CalcCrc32(0xFFFFFFFF, 9, (uint8_t *)"123456789"));
+    TEST_ASSERT_EQUAL_HEX32(0x427C6838, CalcCrc32(0x12345678, 100, buf));
+    for (i = 0; i < sizeof(kat) / sizeof(kat[0]); i++) {
+        TEST_ASSERT_EQUAL_HEX32(kat[i].crc, ns_crc32(buf + kat[i].offset, kat[i].len));
+        TEST_ASSERT_EQUAL_HEX32(kat[i].crc, CalcCrc32(0xFFFFFFFF, kat[i].len, buf + kat[i].offset));
+    }
+
+    // Every length around the 8-byte step, at every alignment
+    for (offset = 0; offset < 8; offset++) {
+        for (len = 0; len < 300; len++) {
+            TEST_ASSERT_EQUAL_HEX32(~reference_crc(0xFFFFFFFF, buf + offset, len),
+                                    ns_crc32(buf + offset, len));
+        }
+    }
+}
+
+void ns_crc32_incremental_test() {
+    uint32_t whole = ns_crc32(buf, BUF_SIZE);
+    uint32_t crc, split, i, n;
+
+    for (split = 0; split <= 64; split++) {
+        crc = ns_crc32_update(NS_CRC32_INIT, buf, split);
+        crc = ns_crc32_update(crc, buf + split, BUF_SIZE - split);
+        TEST_ASSERT_EQUAL_HEX32(whole, ns_crc32_final(crc));
+    }
+
+    rng = 7;
+    crc = NS_CRC32_INIT;
+    for (i = 0; i < BUF_SIZE; i += n) {
+        n = test_rand() % 100;
+        if (n > BUF_SIZE - i) {
+            n = BUF_SIZE - i;
+        }
+        crc = ns_crc32_update(crc, buf + i, n);
+    }
+    TEST_ASSERT_EQUAL_HEX32(whole, ns_crc32_final(crc));
+}
+
+void ns_crc32_combine_test() {
+    uint32_t chunkCrc[16];
+    uint32_t order[16];
+    uint32_t whole = ns_crc32(buf, BUF_SIZE);
+    uint32_t chunk = BUF_SIZE / 16;
+    uint32_t i, j, t, crc;
+
+    TEST_ASSERT_EQUAL_HEX32(whole, ns_crc32_combine(ns_crc32(buf, 1000),
+                                                    ns_crc32(buf + 1000, BUF_SIZE - 1000),
+                                                    BUF_SIZE - 1000));
+    TEST_ASSERT_EQUAL_HEX32(whole, ns_crc32_combine(whole, ns_crc32(buf, 0), 0));
+    TEST_ASSERT_EQUAL_HEX32(whole, ns_crc32_combine(ns_crc32(buf, 0), whole, BUF_SIZE));
+
+    // Chunks checked as they arrive, in any order, then folded into the CRC of the image
+    rng = 3;
+    for (i = 0; i < 16; i++) {
+        order[i] = i;
+    }
+    for (i = 15; i > 0; i--) {
+        j = test_rand() % (i + 1);
+        t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (i = 0; i < 16; i++) {
+        chunkCrc[order[i]] = ns_crc32(buf + order[i] * chunk, chunk);
+    }
+    crc = chunkCrc[0];
+    for (i = 1; i < 16; i++) {
+        crc = ns_crc32_combine(crc, chunkCrc[i], chunk);
+    }
+    TEST_ASSERT_EQUAL_HEX32(whole, crc);
+}
+
+void ns_crc32_backend_test() {
+    ns_crc32_backend_t fake = {.compute = fake_hw, .ctx = NULL, .minLen = 64};
+    uint32_t offset, len, crc;
+
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_crc32_use_hw()); // No engine on the host
+
+    fake.compute = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_crc32_set_backend(&fake));
+    fake.compute = fake_hw;
+    fakeError = 1;
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_crc32_set_backend(&fake));
+    fakeError = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_crc32_set_backend(&fake));
+
+    // Misaligned heads and odd tails go to software, the rest to the engine
+    for (offset = 0; offset < 8; offset++) {
+        for (len = 0; len < 200; len += 13) {
+            fakeCalls = fakeBytes = 0;
+            TEST_ASSERT_EQUAL_HEX32(~reference_crc(0xFFFFFFFF, buf + offset, len),
+                                    ns_crc32(buf + offset, len));
+            TEST_ASSERT_EQUAL(len >= fake.minLen, fakeCalls);
+        }
+    }
+    fakeBytes = 0;
+    crc = ns_crc32_update(NS_CRC32_INIT, buf, 5);
+    crc = ns_crc32_update(crc, buf + 5, BUF_SIZE - 5);
+    TEST_ASSERT_EQUAL_HEX32(ns_crc32_final(reference_crc(0xFFFFFFFF, buf, BUF_SIZE)),
+                            ns_crc32_final(crc));
+    TEST_ASSERT_TRUE(fakeBytes > BUF_SIZE - 12);
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_crc32_set_backend(NULL));
+    fakeCalls = 0;
+    ns_crc32(buf, BUF_SIZE);
+    TEST_ASSERT_EQUAL(0, fakeCalls);
+}
+
+// Not a pass/fail check beyond agreement: reports software throughput of both table walks
+void ns_crc32_benchmark_test() {
+    volatile uint32_t sink = 0;
+    uint32_t t0, tBytewise, tSliced, r;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_init(&bench_timer));
+    TEST_ASSERT_EQUAL_HEX32(bytewise_crc(0xFFFFFFFF, buf, BENCH_SIZE),
+                            ns_crc32_update(NS_CRC32_INIT, buf, BENCH_SIZE));
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (r = 0; r < BENCH_REPS; r++) {
+        sink ^= bytewise_crc(0xFFFFFFFF, buf + (r & 7), BENCH_SIZE);
+    }
+    tBytewise = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (r = 0; r < BENCH_REPS; r++) {
+        sink ^= ns_crc32_update(NS_CRC32_INIT, buf + (r & 7), BENCH_SIZE);
+    }
+    tSliced = ns_us_ticker_read(&bench_timer) - t0;
+
+    ns_lp_printf("CRC-32 over %d x %d bytes: byte-at-a-time %d us (%d KB/s), slicing-by-8 %d us "
+                 "(%d KB/s)\n",
+                 BENCH_REPS, BENCH_SIZE, tBytewise,
+                 (uint32_t)((uint64_t)BENCH_REPS * BENCH_SIZE * 1000 / (tBytewise ? tBytewise : 1)),
+                 tSliced,
+                 (uint32_t)((uint64_t)BENCH_REPS * BENCH_SIZE * 1000 / (tSliced ? tSliced : 1)));
+    (void)sink;
+}
@@ -0,0 +1,10 @@
+#include "ns_core.h"
+#include "ns_crc32.h"
+
+void ns_crc32_tests_pre_test_hook();
+void ns_crc32_tests_post_test_hook();
+void ns_crc32_known_answer_test();
+void ns_crc32_incremental_test();
+void ns_crc32_combine_test();
+void ns_crc32_backend_test();
+void ns_crc32_benchmark_test();
@@ -0,0 +1,87 @@
+/**
+ * @file ns_aot_model.h
+ * @author Ambiq
+ * @brief Interface to models compiled ahead-of-time into direct CMSIS-NN calls
+ * @version 0.1
+ * @date 2025-07-14
+ *
+ * tools/autodeploy/aot_compiler.py turns a .tflite file into a C source/header
+ * pair exposing one ns_aot_model_t. Everything the TFLM interpreter works out
+ * at init time - tensor placement, requantization multipliers, padding,
+ * activation ranges - is computed by the compiler and emitted as constants, so
+ * invoking the model is a straight sequence of CMSIS-NN kernel calls over a
+ * statically planned arena.
+ *
+ * An AOT model can be used on its own, or through ns_model_state_t by setting
+ * runtime = AOT and aot_model before calling ns_model_init(). C++ callers get
+ * ns_aot_tensor_view() to expose the model's inputs and outputs as TfLiteTensors.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_AOT_MODEL_H
+    #define NS_AOT_MODEL_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdint.h>
+
+    #define NS_AOT_ARENA_ALIGNMENT 16 ///< Required alignment of the arena passed to init/invoke
+
+    // helios_rt's CMSIS-NN adds a weight-sum context to the convolution wrappers
+    #if defined(NS_TF_VERSION_helios_rt_v1_2_0)
+        #define NS_AOT_WEIGHT_SUM_ARG(ctx) (ctx),
+    #else
+        #define NS_AOT_WEIGHT_SUM_ARG(ctx)
+    #endif
+
+/// Location and quantization of a model input or output
+typedef struct {
+    uint32_t offset;    ///< Byte offset of the tensor in the arena
+    uint32_t bytes;     ///< Size of the tensor in bytes
+    float scale;        ///< Quantization scale
+    int32_t zero_point; ///< Quantization zero point
+} ns_aot_tensor_t;
+
+/// An ahead-of-time compiled model (generated by aot_compiler.py)
+typedef struct ns_aot_model {
+    const char *name;
+    uint32_t arena_size; ///< Bytes of arena needed: activations, kernel scratch and sums
+    uint32_t num_inputs;
+    uint32_t num_outputs;
+    const ns_aot_tensor_t *inputs;
+    const ns_aot_tensor_t *outputs;
+
+    /// Checks kernel scratch needs and precomputes per-kernel constants. Returns 0 on success.
+    int (*init)(uint8_t *arena, uint32_t arena_size);
+
+    /// Runs the model on the inputs in the arena. Returns 0 on success.
+    int (*invoke)(uint8_t *arena);
+} ns_aot_model_t;
+
+    #ifdef __cplusplus
+}
+
+        #include "tensorflow/lite/c/common.h"
+        #include <string.h>
+
+/// Describe an AOT input or output as a TfLiteTensor over the arena, so code written
+/// against TFLM's model_input/model_output works with either runtime
+static inline void
+ns_aot_tensor_view(TfLiteTensor *t, const ns_aot_tensor_t *a, uint8_t *arena) {
+    memset(t, 0, sizeof(TfLiteTensor));
+    t->type = kTfLiteInt8;
+    t->bytes = a->bytes;
+    t->data.raw = (char *)(arena + a->offset);
+    t->params.scale = a->scale;
+    t->params.zero_point = a->zero_point;
+}
+    #endif
+#endif // NS_AOT_MODEL_H
+/** @}*/
@@ -30,23 +30,33 @@
 extern "C" {
     #endif
 
+    #include "ns_aot_model.h"
+    #include "ns_model_graph.h"
+    #include "ns_model_stream.h"
+
     #ifdef NS_MLPROFILE
         #include "ns_ambiqsuite_harness.h"
         #include "ns_debug_log.h"
     #endif
 
 typedef enum { READY, NOT_READY, ERROR } ns_model_states_e;
-typedef enum { TFLM } ns_model_runtime_e;
+typedef enum { TFLM, AOT } ns_model_runtime_e;
 
     #define NS_MAX_INPUT_TENSORS 3
     #define NS_MAX_OUTPUT_TENSORS 3
 
+    #ifndef NS_MODEL_MAX_INSTANCES
+        #define NS_MODEL_MAX_INSTANCES 4 ///< Model states ns_model_init() can hold at once
+    #endif
+
 typedef struct {
     ns_model_states_e state;
 
     // Configuration (init by application)
-    ns_model_runtime_e runtime; ///< Future use
-    const unsigned char *model_array;
+    ns_model_runtime_e runtime;              ///< TFLM interpreter or ahead-of-time compiled model
+    const unsigned char *model_array;        ///< Flatbuffer (TFLM only)
+    const tflite::MicroOpResolver *resolver; ///< The model's ops (TFLM only, for ns_model_init)
+    const ns_aot_model_t *aot_model;         ///< Compiled model (AOT only, see ns_aot_model.h)
     uint8_t *arena;            ///< Tensor Arena
     uint32_t arena_size;       ///< Size of tensor arena, in bytes
     uint8_t *rv_arena;         ///< ResourceVariable Arena
@@ -71,6 +81,8 @@ typedef struct {
     // State (init by baseline code)
     const tflite::Model *model;                        ///< Model structure, initialized during init
     tflite::MicroInterpreter *interpreter;             ///< Interpreter, initialized during init
+    // For AOT models, input and output tensors are views into the arena; only
+    // type, bytes, data and params are set
     TfLiteTensor *model_input[NS_MAX_INPUT_TENSORS];   ///< Input tensors, initialized during init
     TfLiteTensor *model_output[NS_MAX_OUTPUT_TENSORS]; ///< Output tensors, initialized during init
     tflite::MicroProfiler *profiler;                   ///< Profiler, initialized during init
@@ -82,11 +94,77 @@ typedef struct {
 
 /**
  * @brief Initialize the model
+ *
+ * TFLM models need ms->resolver, with every op the model uses added (e.g. a
+ * MicroMutableOpResolver filled in like a generated init's). Initializing an initialized
+ * model again tears down its interpreter, which reads the arena, then rebuilds it. If
+ * another model has used the arena since, call ns_model_release() before that model
+ * initializes instead.
+ *
  * @param ms Model state and configuration struct
  * @return int status
  */
 extern int ns_model_init(ns_model_state_t *ms);
 
+/**
+ * @brief Tear down the model's interpreter and free its ns_model_init() slot
+ *
+ * Call while the arena still holds this model's allocations, i.e. before another model
+ * sharing the arena is initialized. The model must be initialized again before use.
+ *
+ * @param ms Model state and configuration struct
+ * @return int status
+ */
+extern int ns_model_release(ns_model_state_t *ms);
+
+/**
+ * @brief Run the model on the current contents of the input tensors
+ * @param ms Model state and configuration struct
+ * @return int status
+ */
+extern int ns_model_invoke(ns_model_state_t *ms);
+
+/**
+ * @brief Bind a stream to a TFLM model converted by stream_converter.py
+ *
+ * Resolves the frame input and state tensors named in desc, checks their sizes, and resets
+ * the stream (state caches to their zero point, interpreter variables to zero). The model
+ * must already be initialized. The stream's output callback is left to the caller.
+ *
+ * @param s stream to fill
+ * @param ms initialized TFLM model state
+ * @param desc from the converter's generated header
+ * @return int status
+ */
+extern int
+ns_model_stream_init_tflm(ns_model_stream_t *s, ns_model_state_t *ms,
+                          const ns_model_stream_desc_t *desc);
+
+/// An ns_model_graph node's model
+typedef struct {
+    ns_model_state_t *ms;              ///< Configured, initialized by the graph
+    int (*init)(ns_model_state_t *ms); ///< NULL for ns_model_init(), see below
+} ns_model_graph_model_t;
+
+/**
+ * @brief Make a model a graph node
+ *
+ * The model is initialized when the graph first needs it, and again whenever it takes back a
+ * shared arena. The node releases the model (ns_model_release()) when another node takes the
+ * arena, so re-initializing needs an init that rebuilds the interpreter in its
+ * ns_model_init() slot: leave model->init NULL and set ms->resolver. A custom init must do
+ * the same. A generated init (e.g. minimal_init) builds a function-local static interpreter
+ * once, so it only suits nodes with a private arena, which are initialized once.
+ * After init, the node's outputs are the model's output tensors and its scores are output 0.
+ * Each run copies the node's inputs into the model's input tensors (skipped when a producer
+ * already wrote there) and invokes the model.
+ *
+ * @param node node to fill, with name, parent, condition and arenaGroup left to the caller
+ * @param model must outlive the graph
+ * @return int status
+ */
+extern int ns_model_graph_bind_model(ns_model_graph_node_t *node, ns_model_graph_model_t *model);
+
     #ifdef __cplusplus
 }
     #endif
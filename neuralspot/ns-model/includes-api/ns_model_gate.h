@@ -0,0 +1,146 @@
+/**
+ * @file ns_model_gate.h
+ * @author Ambiq
+ * @brief Skip model invokes when the input hasn't changed, reusing the previous output
+ * @version 0.1
+ * @date 2025-08-25
+ *
+ * Always-on pipelines (KWS, HAR, speech enhancement) invoke their model every stride, even
+ * when the input is silence or the device is lying still. A gate sits in front of the invoke:
+ * each step the application computes a cheap novelty value for the new frame (frame energy,
+ * spectral flux or IMU variance, below), and the gate decides whether the model runs or its
+ * previous output is reused.
+ *
+ * The decision has hysteresis: the gate opens when novelty reaches onThreshold and closes
+ * once it has stayed below offThreshold for more than holdSteps steps, so a word or gesture
+ * is not cut off mid-way. With floorAlpha set, both thresholds are relative to a tracked
+ * noise floor instead of absolute. refreshSteps bounds how stale a reused output can get.
+ *
+ * The gate counts steps, invokes and skips; tools/ns_gate_replay.py runs the same policy
+ * over recorded logs to pick thresholds against an accuracy budget.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_MODEL_GATE_H
+    #define NS_MODEL_GATE_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+typedef int (*ns_model_gate_invoke_fn)(void *ctx);
+
+typedef struct {
+    uint32_t steps;       ///< Decisions made
+    uint32_t invokes;     ///< Steps the model ran
+    uint32_t skips;       ///< Steps the previous output was reused
+    uint32_t refreshes;   ///< Invokes forced by refreshSteps while the gate was closed
+    uint32_t opens;       ///< Closed to open transitions
+    uint32_t longestSkip; ///< Longest run of consecutive skips
+    uint32_t failures;    ///< ns_model_gate_step() invokes that failed (not in invokes)
+} ns_model_gate_stats_t;
+
+typedef struct {
+    // Configuration (init by application)
+    float onThreshold;     ///< Novelty at or above this opens the gate
+    float offThreshold;    ///< Novelty below this starts closing it (<= onThreshold)
+    uint32_t holdSteps;    ///< Steps below offThreshold before the gate closes
+    uint32_t refreshSteps; ///< Invoke at least every this many steps, 0 for never
+    float floorAlpha;      ///< Noise floor tracking rate (0..1), 0 for absolute thresholds
+
+    // Optional, for ns_model_gate_step()
+    ns_model_gate_invoke_fn invoke; ///< Run the model once
+    void *ctx;                      ///< Passed to invoke
+    const void *output;             ///< Model output, copied to cache after each invoke
+    void *cache;                    ///< Output to use: the latest invoke's result
+    uint32_t outputBytes;
+
+    // State (managed by ns_model_gate)
+    bool open;
+    bool primed; ///< The model has run at least once since reset
+    uint32_t below;
+    uint32_t sinceInvoke;
+    uint32_t skipRun;
+    float floor;
+    ns_model_gate_stats_t stats;
+} ns_model_gate_t;
+
+/**
+ * @brief Check a gate's configuration and reset it
+ *
+ * @param g gate with its configuration filled in
+ * @return uint32_t status
+ */
+extern uint32_t ns_model_gate_init(ns_model_gate_t *g);
+
+/**
+ * @brief Close the gate and forget the cached output and noise floor (statistics are kept)
+ */
+extern void ns_model_gate_reset(ns_model_gate_t *g);
+
+/**
+ * @brief Decide whether the model should run for this step
+ *
+ * For applications that invoke the model themselves. The first decision after reset is
+ * always true.
+ *
+ * @param g
+ * @param novelty this step's novelty
+ * @return true to invoke, false to reuse the previous output
+ */
+extern bool ns_model_gate_decide(ns_model_gate_t *g, float novelty);
+
+/**
+ * @brief Decide, and invoke the model and refresh the cache if needed
+ *
+ * @param g gate with invoke (and optionally output, cache and outputBytes) set
+ * @param novelty this step's novelty
+ * @param invoked set to whether the model ran, may be NULL
+ * @return uint32_t status; an invoke failure is returned and leaves the cache unchanged. It is
+ * counted in stats.failures only, so the first invoke or a due refresh is retried next step.
+ */
+extern uint32_t ns_model_gate_step(ns_model_gate_t *g, float novelty, bool *invoked);
+
+/**
+ * @brief Print the statistics
+ */
+extern void ns_model_gate_print_stats(const ns_model_gate_t *g, const char *name);
+
+/**
+ * @brief Frame energy in dB relative to full scale (-100 for silence)
+ */
+extern float ns_gate_energy_db(const int16_t *pcm, uint32_t samples);
+
+/**
+ * @brief Spectral flux: rectified increase of a magnitude (or mel energy) spectrum since the
+ * previous frame, relative to the current frame's total
+ *
+ * @param spectrum this frame's bins
+ * @param prev previous frame's bins, updated to this frame (zero it before the first frame)
+ * @param bins
+ * @return float 0 for an unchanged spectrum, up to 1 for sound out of silence
+ */
+extern float ns_gate_spectral_flux(const float *spectrum, float *prev, uint32_t bins);
+
+/**
+ * @brief Motion: sum of the per-axis variances of a block of IMU samples
+ *
+ * @param data interleaved, samples * axes values
+ * @param samples number of samples
+ * @param axes values per sample (e.g. 3 for an accelerometer, 6 with a gyro)
+ */
+extern float ns_gate_imu_variance(const float *data, uint32_t samples, uint32_t axes);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_MODEL_GATE_H
+/** @}*/
@@ -0,0 +1,188 @@
+/**
+ * @file ns_model_graph.h
+ * @author Ambiq
+ * @brief Cascaded execution of feature stages and models with conditional wake-up
+ * @version 0.1
+ * @date 2025-08-27
+ *
+ * A graph chains small always-on stages with larger models that only run when an upstream
+ * stage asks for them: a VAD waking KWS, KWS waking speaker ID after the wake word, a motion
+ * detector waking HAR.
+ *
+ * Nodes are listed parents first. A source node (parent -1) runs on every
+ * ns_model_graph_run(). Any other node can only run right after its parent ran, and only
+ * while its condition on the parent's scores holds (with optional debounce and hold). A node
+ * whose parent didn't run goes back to sleep.
+ *
+ * Edges pass data by reference: a consumer's in[] entries point at its producers' out[]
+ * buffers (usually tensors inside a model's arena), refreshed before every run. A producer
+ * must be an ancestor of its consumer, so its output is always from the same graph run.
+ *
+ * Nodes are initialized lazily, on their first wake-up. Nodes can share one arena by giving
+ * them the same arenaGroup: a node taking over the arena is initialized again, and the
+ * previous owner is released (while its arena is still intact) and re-initialized when it
+ * next runs. The previous owner's outputs are first copied to its outCopy buffer, so they
+ * stay valid for its children and the application even when both nodes run in one pass.
+ * Share between models that are rarely awake together, since every takeover costs an init.
+ * Nodes in the same group must not be ancestors of one another, and must not carry state
+ * between runs (e.g. streaming models).
+ *
+ * Per-node run counts, wake-ups, initializations and latencies are kept for
+ * ns_model_graph_print_stats(). ns_model_graph_bind_model() (ns_model.h) makes an
+ * ns_model_state_t a node.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_MODEL_GRAPH_H
+    #define NS_MODEL_GRAPH_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_tensor_adapter.h"
+    #include "ns_timer.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_MODEL_GRAPH_MAX_NODES 8
+    #define NS_MODEL_GRAPH_MAX_PORTS 2  ///< Inputs and outputs per node
+    #define NS_MODEL_GRAPH_MAX_ARENAS 4 ///< Shared arena groups, numbered from 1
+
+typedef struct ns_model_graph_node ns_model_graph_node_t;
+
+typedef int (*ns_model_graph_fn)(ns_model_graph_node_t *node);
+typedef bool (*ns_model_graph_test_fn)(const ns_model_graph_node_t *parent, void *arg);
+
+/// A buffer passed along an edge
+typedef struct {
+    void *data;
+    uint32_t bytes;
+} ns_model_graph_ref_t;
+
+/// How a node's conditions read its parent's output
+typedef struct {
+    const void *data;
+    ns_tensor_type_e type;
+    uint32_t count;
+    float scale; ///< real = scale * (q - zeroPoint), 1 and 0 for float
+    int32_t zeroPoint;
+} ns_model_graph_scores_t;
+
+typedef enum {
+    NS_MODEL_GRAPH_ALWAYS,      ///< Every time the parent runs
+    NS_MODEL_GRAPH_SCORE_ABOVE, ///< scores[index] >= threshold
+    NS_MODEL_GRAPH_SCORE_BELOW, ///< scores[index] < threshold
+    NS_MODEL_GRAPH_ARGMAX,      ///< argmax(scores) == index, and scores[index] >= threshold
+    NS_MODEL_GRAPH_CUSTOM,      ///< test(parent, arg)
+} ns_model_graph_cond_e;
+
+typedef struct {
+    ns_model_graph_cond_e type;
+    uint32_t index;
+    float threshold;
+    uint32_t consecutive; ///< Parent runs the condition must hold for to wake (0 is 1)
+    uint32_t holdRuns;    ///< Parent runs to stay awake after the condition stops holding
+    ns_model_graph_test_fn test;
+    void *arg;
+} ns_model_graph_cond_t;
+
+typedef struct {
+    uint32_t runs;
+    uint32_t wakes; ///< Asleep to awake transitions
+    uint32_t inits;
+    uint64_t runUs; ///< Total, for the average
+    uint32_t maxRunUs;
+    uint32_t initUs; ///< Total
+} ns_model_graph_node_stats_t;
+
+struct ns_model_graph_node {
+    // Configuration (init by application)
+    const char *name;
+    int8_t parent; ///< Index of the node whose runs wake this one, -1 for a source
+    ns_model_graph_cond_t when;
+    ns_model_graph_fn init; ///< Called before the first run, may be NULL
+    ns_model_graph_fn run;
+    ns_model_graph_fn release; ///< Called before another node re-plans the arena, may be NULL
+    void *ctx;
+    uint8_t arenaGroup;    ///< 0 for a private arena, else 1..NS_MODEL_GRAPH_MAX_ARENAS
+    void *outCopy;         ///< Word aligned, needed with an arenaGroup: out[] after a takeover
+    uint32_t outCopyBytes; ///< At least out[]'s bytes, each rounded up to a word
+    bool eager;            ///< Initialize in ns_model_graph_init() rather than on first use
+
+    // Set by the application or by init
+    ns_model_graph_ref_t out[NS_MODEL_GRAPH_MAX_PORTS];
+    ns_model_graph_scores_t scores; ///< Read by the children's conditions
+
+    // State (managed by ns_model_graph)
+    ns_model_graph_ref_t in[NS_MODEL_GRAPH_MAX_PORTS]; ///< From the edges, before each run
+    bool ready;
+    bool awake;
+    bool ran; ///< In the latest ns_model_graph_run()
+    uint32_t streak;
+    uint32_t holdLeft;
+    ns_model_graph_node_stats_t stats;
+};
+
+/// Producer output port to consumer input port
+typedef struct {
+    uint8_t from;
+    uint8_t fromPort;
+    uint8_t to;
+    uint8_t toPort;
+} ns_model_graph_edge_t;
+
+typedef struct {
+    // Configuration (init by application)
+    ns_model_graph_node_t *nodes; ///< Parents before children
+    uint32_t numNodes;
+    const ns_model_graph_edge_t *edges;
+    uint32_t numEdges;
+    ns_timer_config_t *timer; ///< Initialized timer for latencies, may be NULL
+
+    // State (managed by ns_model_graph)
+    uint32_t runs;
+    int8_t arenaOwner[NS_MODEL_GRAPH_MAX_ARENAS];
+} ns_model_graph_t;
+
+/**
+ * @brief Check the graph and initialize its eager nodes
+ *
+ * @param g graph with its nodes and edges filled in
+ * @return uint32_t status
+ */
+extern uint32_t ns_model_graph_init(ns_model_graph_t *g);
+
+/**
+ * @brief Run the sources, and whichever nodes their results wake, in order
+ *
+ * @param g
+ * @return uint32_t status; a failed init or run stops the pass
+ */
+extern uint32_t ns_model_graph_run(ns_model_graph_t *g);
+
+/**
+ * @brief Put every non-source node to sleep (initialized nodes stay initialized)
+ */
+extern void ns_model_graph_reset(ns_model_graph_t *g);
+
+/**
+ * @brief Print per-node run rates (relative to graph runs), wake-ups, inits and latencies
+ */
+extern void ns_model_graph_print_stats(const ns_model_graph_t *g);
+
+/**
+ * @brief A node's score, dequantized
+ */
+extern float ns_model_graph_score(const ns_model_graph_node_t *node, uint32_t index);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_MODEL_GRAPH_H
+/** @}*/
@@ -0,0 +1,156 @@
+/**
+ * @file ns_model_stream.h
+ * @author Ambiq
+ * @brief Streaming inference: run a temporal model on new frames only, carrying state across steps
+ * @version 0.1
+ * @date 2025-08-22
+ *
+ * A windowed model (e.g. KWS on 49 MFCC frames) recomputes the whole window every stride even
+ * though most of it overlaps the previous one. In streaming form (see
+ * tools/autodeploy/stream_converter.py) each temporal convolution or pooling layer instead
+ * takes the frames it still needs from a state tensor: the model consumes framesPerStep new
+ * frames per invoke and produces the same output the windowed model would for the window
+ * ending at the newest frame. Models with SAME padding in time lag by a fixed delay and
+ * only approximate the windowed model near the window edges (see the converter).
+ *
+ * The state can live in two places:
+ * - NS_MODEL_STREAM_EXTERNAL_STATE: every state is a model input/output pair. After each
+ *   invoke the output (the updated cache) is copied back to the input. This works with any
+ *   runtime and is what the converter emits by default. A runtime may place a state output
+ *   over a state input it has finished reading, so the copies are ordered to read every
+ *   output before it is overwritten; states that would overwrite each other's outputs both
+ *   ways are rejected.
+ * - NS_MODEL_STREAM_RESOURCE_VARIABLES: the model keeps its state in TFLM resource variables
+ *   (ns_model_state_t rv_arena and rv_count) or variable tensors (LSTM state). Nothing is
+ *   copied; reset goes through the runtime.
+ *
+ * ns_model_stream_init_tflm() (ns_model.h) binds a stream to an ns_model TFLM model; other
+ * runtimes fill input, states, invoke and reset themselves and call ns_model_stream_init().
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_MODEL_STREAM_H
+    #define NS_MODEL_STREAM_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+/// Most state tensors a streaming model may have
+    #define NS_MODEL_STREAM_MAX_STATES 16
+
+typedef enum {
+    NS_MODEL_STREAM_EXTERNAL_STATE,     ///< State tensors are model inputs and outputs
+    NS_MODEL_STREAM_RESOURCE_VARIABLES, ///< State lives inside the runtime
+} ns_model_stream_mode_e;
+
+/**
+ * @brief Description of a streaming model, as emitted by stream_converter.py
+ */
+typedef struct {
+    ns_model_stream_mode_e mode;
+    uint32_t frameInput;    ///< Index of the input tensor that takes the new frames
+    uint32_t framesPerStep; ///< New frames consumed by each invoke
+    uint32_t frameBytes;    ///< Bytes per frame in the frame input
+    uint32_t windowFrames;  ///< Window of the original model plus the output delay: outputs no
+                            ///< longer depend on the reset state once this many frames have been
+                            ///< pushed since reset
+    uint32_t numStates;
+    uint8_t stateInput[NS_MODEL_STREAM_MAX_STATES];  ///< Input tensor index of each state
+    uint8_t stateOutput[NS_MODEL_STREAM_MAX_STATES]; ///< Output tensor index of each state
+} ns_model_stream_desc_t;
+
+/// One external state: the cache the model reads and the updated cache it writes
+typedef struct {
+    uint8_t *in;
+    const uint8_t *out;
+    uint32_t bytes;
+    uint8_t resetValue; ///< Byte the cache is filled with on reset (the zero point for int8)
+} ns_model_stream_state_t;
+
+struct ns_model_stream;
+
+typedef int (*ns_model_stream_invoke_fn)(void *ctx);
+typedef int (*ns_model_stream_reset_fn)(void *ctx);
+typedef void (*ns_model_stream_output_cb)(struct ns_model_stream *s, void *arg);
+
+typedef struct ns_model_stream {
+    // Configuration (filled by ns_model_stream_init_tflm(), or by the application)
+    const ns_model_stream_desc_t *desc;
+    uint8_t *input; ///< Frame input tensor data, framesPerStep * frameBytes
+    ns_model_stream_state_t states[NS_MODEL_STREAM_MAX_STATES];
+    ns_model_stream_invoke_fn invoke; ///< Run the model once
+    ns_model_stream_reset_fn reset;   ///< Reset runtime-held state, may be NULL
+    void *ctx;                        ///< Passed to invoke and reset
+
+    // Optional, called after every step run by ns_model_stream_push()
+    ns_model_stream_output_cb output;
+    void *outputArg;
+
+    // State (managed by ns_model_stream)
+    uint32_t pending; ///< Frames gathered in input toward the next step
+    uint32_t frames;  ///< Frames stepped through since reset (saturates at windowFrames)
+    uint32_t steps;   ///< Invokes since reset
+    uint8_t copyOrder[NS_MODEL_STREAM_MAX_STATES]; ///< States in the order they are copied back
+} ns_model_stream_t;
+
+/**
+ * @brief Check a stream's configuration and reset it
+ *
+ * @param s stream with desc, input, states (external state mode) and invoke filled in
+ * @return uint32_t status
+ */
+extern uint32_t ns_model_stream_init(ns_model_stream_t *s);
+
+/**
+ * @brief Forget all history: caches go back to their reset value, runtime state is reset
+ *
+ * @param s
+ * @return uint32_t status
+ */
+extern uint32_t ns_model_stream_reset(ns_model_stream_t *s);
+
+/**
+ * @brief Run one step on the framesPerStep frames already in the frame input
+ *
+ * Use this when the input is written in place, e.g. by ns_tensor_quantize_f32(). The output
+ * tensors hold the result until the next step.
+ *
+ * @param s
+ * @return uint32_t status
+ */
+extern uint32_t ns_model_stream_step(ns_model_stream_t *s);
+
+/**
+ * @brief Feed frames (already in the frame input's format), stepping whenever enough are
+ * gathered
+ *
+ * Frames left over are kept for the next call. The output callback, if any, runs after each
+ * step while its result is in the output tensors.
+ *
+ * @param s
+ * @param frames numFrames * frameBytes bytes
+ * @param numFrames may be any number
+ * @return uint32_t status
+ */
+extern uint32_t ns_model_stream_push(ns_model_stream_t *s, const void *frames, uint32_t numFrames);
+
+/**
+ * @brief True once the outputs match the windowed model's, i.e. a full window of frames has
+ * been stepped through since reset
+ */
+extern bool ns_model_stream_warm(const ns_model_stream_t *s);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_MODEL_STREAM_H
+/** @}*/
@@ -0,0 +1,191 @@
+/**
+ * @file ns_tensor_adapter.h
+ * @author Ambiq
+ * @brief Typed model input/output adapters: fused normalize + quantize, dequantize, softmax, top-k
+ * @version 0.1
+ * @date 2025-08-20
+ *
+ * An adapter describes one model tensor: element type, shape (batches x spatial x channels,
+ * channels innermost as in TFLite), quantization (per tensor, or per channel along the
+ * channel dimension) and the kernels for its type. ns_tensor_adapter_init() fills it once
+ * from a TfLiteTensor; after that no per-inference code reads the tensor params.
+ *
+ * Input side, ns_tensor_quantize_f32() and ns_tensor_quantize_s16() do
+ *
+ *     q = saturate(round(((x - mean[c]) * invStd[c]) / scale[c] + zeroPoint[c]))
+ *
+ * as one multiply-add per element: the per-channel factors are folded into a single
+ * (mul, add) pair before the loop. The source can be channel-interleaved (NHWC, the tensor's
+ * own order) or planar (NCHW), which is transposed on the way in. Output side,
+ * ns_tensor_dequantize() is the inverse (into either layout), ns_tensor_softmax() works along
+ * the channel dimension, and ns_tensor_top_k() ranks the raw quantized values when the
+ * quantization is per tensor, dequantizing only the winners.
+ *
+ * Contiguous runs use Helium (MVE) kernels when the core has them and portable C otherwise;
+ * the choice is made at init time through the adapter's kernel table.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-model
+ * @{
+ *
+ */
+
+#ifndef NS_TENSOR_ADAPTER_H
+    #define NS_TENSOR_ADAPTER_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+/// Largest channel count with per-channel normalization or quantization
+    #define NS_TENSOR_MAX_CHANNELS 64
+
+/// Coefficients are expanded to a whole number of channel groups up to this many elements
+    #define NS_TENSOR_COEFF_LEN 64
+
+typedef enum {
+    NS_TENSOR_INT8,
+    NS_TENSOR_INT16,
+    NS_TENSOR_FLOAT32,
+} ns_tensor_type_e;
+
+typedef enum {
+    NS_TENSOR_NHWC, ///< Channels interleaved, innermost (the TFLite tensor order)
+    NS_TENSOR_NCHW, ///< One plane per channel
+} ns_tensor_layout_e;
+
+/**
+ * @brief Elementwise y = saturate(round(x * mul[i % period] + add[i % period]))
+ *
+ * Strides are in elements. With period 1, mul and add are single values. Float destinations
+ * are not rounded or saturated.
+ */
+typedef void (*ns_tensor_affine_fn)(
+    const void *src, uint32_t srcStride, void *dst, uint32_t dstStride, uint32_t n,
+    const float *mul, const float *add, uint32_t period);
+
+/// Kernels for one tensor type
+typedef struct {
+    ns_tensor_affine_fn fromF32; ///< float source into the tensor
+    ns_tensor_affine_fn fromS16; ///< int16 source into the tensor
+    ns_tensor_affine_fn toF32;   ///< tensor into float
+    uint32_t elementBytes;
+} ns_tensor_kernels_t;
+
+/// A model tensor and what is needed to convert into and out of it
+typedef struct {
+    ns_tensor_type_e type;
+    void *data;
+    uint32_t batches;  ///< Outermost dimension (1 for 1-D tensors)
+    uint32_t spatial;  ///< Product of the dimensions between batch and channels
+    uint32_t channels; ///< Innermost dimension
+    uint32_t elements;
+
+    // Quantization, as read from the tensor (scale 1, zero point 0 for float tensors)
+    uint32_t numScales; ///< 1 for per-tensor, channels for per-channel
+    float scale[NS_TENSOR_MAX_CHANNELS];
+    int32_t zeroPoint[NS_TENSOR_MAX_CHANNELS];
+
+    const ns_tensor_kernels_t *kernels; ///< Bound by ns_tensor_adapter_config()
+} ns_tensor_adapter_t;
+
+struct TfLiteTensor;
+
+/**
+ * @brief Fill an adapter from a TFLM (or ns_model AOT) tensor
+ *
+ * int8, int16 and float32 tensors are supported. Per-channel quantization must be along the
+ * last dimension. Tensors without dims (AOT views) are treated as one channel.
+ *
+ * @param t adapter to fill
+ * @param tensor e.g. ns_model_state_t.model_input[0]
+ * @return uint32_t status
+ */
+extern uint32_t ns_tensor_adapter_init(ns_tensor_adapter_t *t, const struct TfLiteTensor *tensor);
+
+/**
+ * @brief Fill an adapter from explicit parameters
+ *
+ * @param t adapter to fill
+ * @param type element type
+ * @param data tensor storage
+ * @param dims shape, channels last
+ * @param numDims entries in dims (0 means a single element)
+ * @param scales numScales scales, NULL for an unquantized (scale 1) tensor
+ * @param zeroPoints numScales zero points, may be NULL for all zero
+ * @param numScales 1, or the channel count for per-channel quantization
+ * @return uint32_t status
+ */
+extern uint32_t ns_tensor_adapter_config(
+    ns_tensor_adapter_t *t, ns_tensor_type_e type, void *data, const int32_t *dims,
+    uint32_t numDims, const float *scales, const int32_t *zeroPoints, uint32_t numScales);
+
+/**
+ * @brief Normalize, quantize and saturate float data into the tensor
+ *
+ * @param t
+ * @param src elements in srcLayout
+ * @param srcLayout NS_TENSOR_NHWC or NS_TENSOR_NCHW
+ * @param mean per-channel value to subtract, NULL for none
+ * @param invStd per-channel factor applied after the mean, NULL for none
+ * @return uint32_t status
+ */
+extern uint32_t ns_tensor_quantize_f32(
+    const ns_tensor_adapter_t *t, const float *src, ns_tensor_layout_e srcLayout,
+    const float *mean, const float *invStd);
+
+/**
+ * @brief Normalize, quantize and saturate int16 data (e.g. PCM or features) into the tensor
+ *
+ * As ns_tensor_quantize_f32(), with the int16 values taken as real numbers.
+ */
+extern uint32_t ns_tensor_quantize_s16(
+    const ns_tensor_adapter_t *t, const int16_t *src, ns_tensor_layout_e srcLayout,
+    const float *mean, const float *invStd);
+
+/**
+ * @brief Dequantize the tensor into float
+ *
+ * @param t
+ * @param dst elements in dstLayout
+ * @param dstLayout NS_TENSOR_NHWC or NS_TENSOR_NCHW
+ * @return uint32_t status
+ */
+extern uint32_t
+ns_tensor_dequantize(const ns_tensor_adapter_t *t, float *dst, ns_tensor_layout_e dstLayout);
+
+/**
+ * @brief Dequantize and apply softmax along the channel dimension
+ *
+ * @param t
+ * @param probs elements, in the tensor's (NHWC) order
+ * @return uint32_t status
+ */
+extern uint32_t ns_tensor_softmax(const ns_tensor_adapter_t *t, float *probs);
+
+/**
+ * @brief Find the k largest elements, largest first, lower index first on ties
+ *
+ * @param t
+ * @param k number wanted
+ * @param indices k flat element indices
+ * @param values k dequantized values, may be NULL
+ * @return uint32_t number found, min(k, elements)
+ */
+extern uint32_t
+ns_tensor_top_k(const ns_tensor_adapter_t *t, uint32_t k, uint32_t *indices, float *values);
+
+/**
+ * @brief Index of the largest element (the first one on ties)
+ */
+extern uint32_t ns_tensor_argmax(const ns_tensor_adapter_t *t);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_TENSOR_ADAPTER_H
+/** @}*/
@@ -1,5 +1,5 @@
 local_src := $(wildcard $(subdirectory)/src/*.c)
-local_src := $(wildcard $(subdirectory)/src/*.cc)
+local_src += $(wildcard $(subdirectory)/src/*.cc)
 includes_api += $(subdirectory)/includes-api
 
 local_bin := $(BINDIR)/$(subdirectory)
@@ -13,6 +13,7 @@
 #include "ns_model.h"
 #include "ns_ambiqsuite_harness.h"
 #include "ns_debug_log.h"
+#include <string.h>
 
 // Tensorflow Lite for Microcontroller includes (somewhat boilerplate)
 // #include "tensorflow/lite/micro/all_ops_resolver.h"
@@ -29,6 +30,90 @@
     #include "tensorflow/lite/micro/micro_error_reporter.h"
 #endif
 
+#include <new>
+
+// Interpreter storage and AOT tensor views, one slot per model state passed to
+// ns_model_init(), so several models (e.g. the nodes of an ns_model_graph) can be resident
+// at once. Initializing a model again rebuilds its interpreter in the same slot. Models
+// sharing an arena take turns by releasing the slot before the next model plans the arena:
+// the interpreter's destructor walks allocations inside the arena.
+typedef struct {
+    const ns_model_state_t *owner;
+    bool constructed;
+    alignas(tflite::MicroInterpreter) uint8_t interpreter[sizeof(tflite::MicroInterpreter)];
+    TfLiteTensor aot_inputs[NS_MAX_INPUT_TENSORS];
+    TfLiteTensor aot_outputs[NS_MAX_OUTPUT_TENSORS];
+} ns_model_slot_t;
+
+static ns_model_slot_t ns_model_slots[NS_MODEL_MAX_INSTANCES];
+
+static ns_model_slot_t *
+ns_model_slot(const ns_model_state_t *ms) {
+    ns_model_slot_t *free_slot = NULL;
+
+    for (uint32_t i = 0; i < NS_MODEL_MAX_INSTANCES; i++) {
+        if (ns_model_slots[i].owner == ms) {
+            return &ns_model_slots[i];
+        }
+        if ((ns_model_slots[i].owner == NULL) && (free_slot == NULL)) {
+            free_slot = &ns_model_slots[i];
+        }
+    }
+    if (free_slot != NULL) {
+        free_slot->owner = ms;
+    }
+    return free_slot;
+}
+
+static ns_model_slot_t *
+ns_model_find_slot(const ns_model_state_t *ms) {
+    for (uint32_t i = 0; i < NS_MODEL_MAX_INSTANCES; i++) {
+        if (ns_model_slots[i].owner == ms) {
+            return &ns_model_slots[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Initialize an ahead-of-time compiled model
+ *
+ * There is nothing to parse or allocate: the compiler already planned the
+ * arena, so init checks that the arena is big enough and lets the model
+ * precompute its kernel constants.
+ */
+static int
+ns_model_aot_init(ns_model_state_t *ms, ns_model_slot_t *slot) {
+    const ns_aot_model_t *m = ms->aot_model;
+
+    if ((m == NULL) || (ms->arena == NULL) || (ms->arena_size < m->arena_size) ||
+        ((uintptr_t)ms->arena % NS_AOT_ARENA_ALIGNMENT) || (m->num_inputs > NS_MAX_INPUT_TENSORS) ||
+        (m->num_outputs > NS_MAX_OUTPUT_TENSORS)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    if (m->init(ms->arena, ms->arena_size) != 0) {
+        return NS_STATUS_FAILURE;
+    }
+
+    ms->numInputTensors = m->num_inputs;
+    ms->numOutputTensors = m->num_outputs;
+    for (uint32_t t = 0; t < m->num_inputs; t++) {
+        ns_aot_tensor_view(&slot->aot_inputs[t], &m->inputs[t], ms->arena);
+        ms->model_input[t] = &slot->aot_inputs[t];
+    }
+    for (uint32_t t = 0; t < m->num_outputs; t++) {
+        ns_aot_tensor_view(&slot->aot_outputs[t], &m->outputs[t], ms->arena);
+        ms->model_output[t] = &slot->aot_outputs[t];
+    }
+
+    ms->model = NULL;
+    ms->interpreter = NULL;
+    ms->computed_arena_size = m->arena_size;
+    ms->state = READY;
+    return NS_STATUS_SUCCESS;
+}
+
 /**
  * @brief Initialize TF with model
  *
@@ -41,6 +126,20 @@ int
 ns_model_init(ns_model_state_t *ms) {
     ms->state = NOT_READY;
 
+    ns_model_slot_t *slot = ns_model_slot(ms);
+    if (slot == NULL) {
+        return NS_STATUS_INVALID_CONFIG; // more than NS_MODEL_MAX_INSTANCES models
+    }
+    if (slot->constructed) {
+        ((tflite::MicroInterpreter *)slot->interpreter)->~MicroInterpreter();
+        slot->constructed = false;
+        ms->interpreter = NULL;
+    }
+
+    if (ms->runtime == AOT) {
+        return ns_model_aot_init(ms, slot);
+    }
+
     tflite::MicroErrorReporter micro_error_reporter;
     ms->error_reporter = &micro_error_reporter;
 
@@ -78,8 +177,9 @@ ns_model_init(ns_model_state_t *ms) {
         return NS_STATUS_FAILURE;
     }
 
-    // static tflite::AllOpsResolver resolver;
-    static tflite::MicroMutableOpResolver<6> resolver;
+    // Without the model's ops, AllocateTensors() fails on any op the model uses
+    static tflite::MicroMutableOpResolver<6> no_ops;
+    const tflite::MicroOpResolver &resolver = (ms->resolver != NULL) ? *ms->resolver : no_ops;
 
     // Allocate ResourceVariable stuff if needed
     tflite::MicroResourceVariables *resource_variables;
@@ -94,13 +194,13 @@ ns_model_init(ns_model_state_t *ms) {
 
     // Build an interpreter to run the model with.
 #ifdef NS_TFSTRUCTURE_RECENT
-    static tflite::MicroInterpreter static_interpreter(
+    ms->interpreter = new (slot->interpreter) tflite::MicroInterpreter(
         ms->model, resolver, ms->arena, ms->arena_size, resource_variables, ms->profiler);
 #else
-    static tflite::MicroInterpreter static_interpreter(
+    ms->interpreter = new (slot->interpreter) tflite::MicroInterpreter(
         ms->model, resolver, ms->arena, ms->arena_size, ms->error_reporter, nullptr, ms->profiler);
 #endif
-    ms->interpreter = &static_interpreter;
+    slot->constructed = true;
 
     // Allocate memory from the tensor_arena for the model's tensors.
     TfLiteStatus allocate_status = ms->interpreter->AllocateTensors();
@@ -126,6 +226,166 @@ ns_model_init(ns_model_state_t *ms) {
     return NS_STATUS_SUCCESS;
 }
 
+int
+ns_model_release(ns_model_state_t *ms) {
+    if (ms == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    ns_model_slot_t *slot = ns_model_find_slot(ms);
+    if (slot != NULL) {
+        if (slot->constructed) {
+            ((tflite::MicroInterpreter *)slot->interpreter)->~MicroInterpreter();
+            slot->constructed = false;
+        }
+        slot->owner = NULL;
+    }
+    ms->interpreter = NULL;
+    ms->state = NOT_READY;
+    return NS_STATUS_SUCCESS;
+}
+
+int
+ns_model_invoke(ns_model_state_t *ms) {
+    if (ms->state != READY) {
+        return NS_STATUS_FAILURE;
+    }
+
+    if (ms->runtime == AOT) {
+        return (ms->aot_model->invoke(ms->arena) == 0) ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+    }
+
+    return (ms->interpreter->Invoke() == kTfLiteOk) ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+}
+
+static int
+ns_model_stream_invoke(void *ctx) {
+    return ns_model_invoke((ns_model_state_t *)ctx);
+}
+
+static int
+ns_model_stream_reset_tflm(void *ctx) {
+    // Zeroes variable tensors (e.g. LSTM state) and resource variables
+    ns_model_state_t *ms = (ns_model_state_t *)ctx;
+    return (ms->interpreter->Reset() == kTfLiteOk) ? NS_STATUS_SUCCESS : NS_STATUS_FAILURE;
+}
+
+int
+ns_model_stream_init_tflm(ns_model_stream_t *s, ns_model_state_t *ms,
+                          const ns_model_stream_desc_t *desc) {
+    if ((s == NULL) || (ms == NULL) || (desc == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    // The AOT compiler has no CONCATENATION/STRIDED_SLICE, so streaming is TFLM only
+    if ((ms->state != READY) || (ms->runtime != TFLM)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if ((desc->numStates > NS_MODEL_STREAM_MAX_STATES) ||
+        (desc->frameInput >= ms->interpreter->inputs_size())) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    TfLiteTensor *in = ms->interpreter->input(desc->frameInput);
+    if (in->bytes != desc->framesPerStep * desc->frameBytes) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    s->desc = desc;
+    s->input = (uint8_t *)in->data.raw;
+    s->invoke = ns_model_stream_invoke;
+    s->reset = ns_model_stream_reset_tflm;
+    s->ctx = ms;
+
+    for (uint32_t i = 0; (desc->mode == NS_MODEL_STREAM_EXTERNAL_STATE) && (i < desc->numStates);
+         i++) {
+        if ((desc->stateInput[i] >= ms->interpreter->inputs_size()) ||
+            (desc->stateOutput[i] >= ms->interpreter->outputs_size())) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        TfLiteTensor *si = ms->interpreter->input(desc->stateInput[i]);
+        TfLiteTensor *so = ms->interpreter->output(desc->stateOutput[i]);
+        if ((si->bytes != so->bytes) || (si->type != so->type) ||
+            ((si->type != kTfLiteInt8) && (si->params.zero_point != 0))) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        s->states[i].in = (uint8_t *)si->data.raw;
+        s->states[i].out = (const uint8_t *)so->data.raw;
+        s->states[i].bytes = si->bytes;
+        s->states[i].resetValue = (si->type == kTfLiteInt8) ? (uint8_t)si->params.zero_point : 0;
+    }
+    return ns_model_stream_init(s);
+}
+
+static int
+ns_model_graph_model_init(ns_model_graph_node_t *node) {
+    ns_model_graph_model_t *m = (ns_model_graph_model_t *)node->ctx;
+    ns_model_state_t *ms = m->ms;
+    int status = (m->init != NULL) ? m->init(ms) : ns_model_init(ms);
+
+    if (status != NS_STATUS_SUCCESS) {
+        return status;
+    }
+    // The arena has just been planned, so the outputs may have moved
+    for (uint32_t t = 0; t < NS_MODEL_GRAPH_MAX_PORTS; t++) {
+        TfLiteTensor *o = (t < ms->numOutputTensors) ? ms->model_output[t] : NULL;
+        node->out[t].data = (o != NULL) ? o->data.raw : NULL;
+        node->out[t].bytes = (o != NULL) ? o->bytes : 0;
+    }
+
+    TfLiteTensor *scores = ms->model_output[0];
+    node->scores.data = scores->data.raw;
+    node->scores.scale = 1.0f;
+    node->scores.zeroPoint = 0;
+    if (scores->type == kTfLiteInt8) {
+        node->scores.type = NS_TENSOR_INT8;
+        node->scores.count = scores->bytes;
+    } else if (scores->type == kTfLiteInt16) {
+        node->scores.type = NS_TENSOR_INT16;
+        node->scores.count = scores->bytes / sizeof(int16_t);
+    } else if (scores->type == kTfLiteFloat32) {
+        node->scores.type = NS_TENSOR_FLOAT32;
+        node->scores.count = scores->bytes / sizeof(float);
+    } else {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (scores->type != kTfLiteFloat32) {
+        node->scores.scale = scores->params.scale;
+        node->scores.zeroPoint = scores->params.zero_point;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static int
+ns_model_graph_model_release(ns_model_graph_node_t *node) {
+    return ns_model_release(((ns_model_graph_model_t *)node->ctx)->ms);
+}
+
+static int
+ns_model_graph_model_run(ns_model_graph_node_t *node) {
+    ns_model_state_t *ms = ((ns_model_graph_model_t *)node->ctx)->ms;
+
+    // TFLM kernels read inputs from the arena, so an upstream buffer is copied in unless the
+    // producer already wrote it there
+    for (uint32_t t = 0; (t < NS_MODEL_GRAPH_MAX_PORTS) && (t < ms->numInputTensors); t++) {
+        TfLiteTensor *in = ms->model_input[t];
+        const ns_model_graph_ref_t *ref = &node->in[t];
+        if ((ref->data != NULL) && (ref->data != in->data.raw)) {
+            memcpy(in->data.raw, ref->data, ref->bytes < in->bytes ? ref->bytes : in->bytes);
+        }
+    }
+    return ns_model_invoke(ms);
+}
+
+int
+ns_model_graph_bind_model(ns_model_graph_node_t *node, ns_model_graph_model_t *model) {
+    if ((node == NULL) || (model == NULL) || (model->ms == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    node->init = ns_model_graph_model_init;
+    node->run = ns_model_graph_model_run;
+    node->release = ns_model_graph_model_release;
+    node->ctx = model;
+    return NS_STATUS_SUCCESS;
+}
+
 uint32_t
 ns_tf_get_num_input_tensors(ns_model_state_t *ms) {
     return ms->interpreter->inputs_size();
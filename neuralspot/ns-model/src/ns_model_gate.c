@@ -0,0 +1,188 @@
+/**
+ * @file ns_model_gate.c
+ * @author Ambiq
+ * @brief Novelty-gated model invokes with output reuse
+ * @version 0.1
+ * @date 2025-08-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_model_gate.h"
+#include "ns_core.h"
+#include <math.h>
+#include <string.h>
+
+uint32_t ns_model_gate_init(ns_model_gate_t *g) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (g == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    if ((g->offThreshold > g->onThreshold) || (g->floorAlpha < 0.0f) || (g->floorAlpha > 1.0f)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if ((g->outputBytes != 0) && ((g->output == NULL) || (g->cache == NULL))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    memset(&g->stats, 0, sizeof(g->stats));
+    ns_model_gate_reset(g);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_model_gate_reset(ns_model_gate_t *g) {
+    g->open = false;
+    g->primed = false;
+    g->below = 0;
+    g->sinceInvoke = 0;
+    g->skipRun = 0;
+    g->floor = NAN;
+}
+
+// Hysteresis and noise floor for this step, without the invoke/skip bookkeeping
+static bool ns_model_gate_want(ns_model_gate_t *g, float novelty) {
+    float level = novelty;
+
+    // Thresholds are relative to the floor seen before this step, so a burst can't raise
+    // the floor it is measured against
+    if (g->floorAlpha > 0.0f) {
+        if (isnan(g->floor)) {
+            g->floor = novelty;
+        }
+        level = novelty - g->floor;
+    }
+
+    if (!g->open) {
+        if (level >= g->onThreshold) {
+            g->open = true;
+            g->below = 0;
+            g->stats.opens++;
+        }
+    } else if (level < g->offThreshold) {
+        if (++g->below > g->holdSteps) {
+            g->open = false;
+        }
+    } else {
+        g->below = 0;
+    }
+
+    // The floor follows drops immediately and rises slowly, and only while closed
+    if (g->floorAlpha > 0.0f) {
+        if (novelty < g->floor) {
+            g->floor = novelty;
+        } else if (!g->open) {
+            g->floor += g->floorAlpha * (novelty - g->floor);
+        }
+    }
+
+    return g->open || !g->primed ||
+           ((g->refreshSteps != 0) && (g->sinceInvoke + 1 >= g->refreshSteps));
+}
+
+// Record a step that invoked the model or reused its previous output
+static void ns_model_gate_account(ns_model_gate_t *g, bool invoke) {
+    g->stats.steps++;
+    if (invoke) {
+        if (!g->open && g->primed) {
+            g->stats.refreshes++;
+        }
+        g->stats.invokes++;
+        g->primed = true;
+        g->sinceInvoke = 0;
+        g->skipRun = 0;
+    } else {
+        g->stats.skips++;
+        g->sinceInvoke++;
+        if (++g->skipRun > g->stats.longestSkip) {
+            g->stats.longestSkip = g->skipRun;
+        }
+    }
+}
+
+bool ns_model_gate_decide(ns_model_gate_t *g, float novelty) {
+    bool invoke = ns_model_gate_want(g, novelty);
+
+    ns_model_gate_account(g, invoke);
+    return invoke;
+}
+
+uint32_t ns_model_gate_step(ns_model_gate_t *g, float novelty, bool *invoked) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((g == NULL) || (g->invoke == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    bool run = ns_model_gate_want(g, novelty);
+
+    if (invoked != NULL) {
+        *invoked = run;
+    }
+    if (run && (g->invoke(g->ctx) != NS_STATUS_SUCCESS)) {
+        // Nothing was refreshed: the step is only counted as a failure, so a pending first
+        // invoke or refresh is retried on the next step
+        g->stats.steps++;
+        g->stats.failures++;
+        return NS_STATUS_FAILURE;
+    }
+    ns_model_gate_account(g, run);
+    if (run && (g->outputBytes != 0)) {
+        memcpy(g->cache, g->output, g->outputBytes);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_model_gate_print_stats(const ns_model_gate_t *g, const char *name) {
+    const ns_model_gate_stats_t *s = &g->stats;
+    uint32_t pct = s->steps ? (uint32_t)((uint64_t)s->skips * 100 / s->steps) : 0;
+
+    ns_lp_printf("Gate %s: %u steps, %u invokes, %u skipped (%u%%), %u refreshes, %u opens, "
+                 "longest skip %u, %u failed invokes\n",
+                 name, s->steps, s->invokes, s->skips, pct, s->refreshes, s->opens,
+                 s->longestSkip, s->failures);
+}
+
+float ns_gate_energy_db(const int16_t *pcm, uint32_t samples) {
+    int64_t sum = 0;
+
+    for (uint32_t i = 0; i < samples; i++) {
+        sum += (int32_t)pcm[i] * pcm[i];
+    }
+    if ((samples == 0) || (sum == 0)) {
+        return -100.0f;
+    }
+    float db = 10.0f * log10f((float)sum / ((float)samples * 32768.0f * 32768.0f));
+    return db < -100.0f ? -100.0f : db;
+}
+
+float ns_gate_spectral_flux(const float *spectrum, float *prev, uint32_t bins) {
+    float rise = 0.0f, total = 0.0f;
+
+    for (uint32_t i = 0; i < bins; i++) {
+        float d = spectrum[i] - prev[i];
+        rise += d > 0.0f ? d : 0.0f;
+        total += spectrum[i];
+        prev[i] = spectrum[i];
+    }
+    return total > 0.0f ? rise / total : 0.0f;
+}
+
+float ns_gate_imu_variance(const float *data, uint32_t samples, uint32_t axes) {
+    float var = 0.0f;
+
+    if (samples < 2) {
+        return 0.0f;
+    }
+    for (uint32_t a = 0; a < axes; a++) {
+        // Shifted by the first sample, so a large constant offset (gravity) doesn't cancel out
+        // the precision of the sums
+        float k = data[a], sum = 0.0f, sum2 = 0.0f;
+        for (uint32_t i = 0; i < samples; i++) {
+            float d = data[i * axes + a] - k;
+            sum += d;
+            sum2 += d * d;
+        }
+        var += (sum2 - sum * sum / (float)samples) / (float)samples;
+    }
+    return var;
+}
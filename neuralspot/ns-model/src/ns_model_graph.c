@@ -0,0 +1,285 @@
+/**
+ * @file ns_model_graph.c
+ * @author Ambiq
+ * @brief Cascaded execution of feature stages and models with conditional wake-up
+ * @version 0.1
+ * @date 2025-08-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_model_graph.h"
+#include "ns_core.h"
+#include <string.h>
+
+static bool ns_model_graph_is_ancestor(const ns_model_graph_t *g, uint32_t a, uint32_t n) {
+    for (int32_t p = g->nodes[n].parent; p >= 0; p = g->nodes[p].parent) {
+        if ((uint32_t)p == a) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t ns_model_graph_ticks(const ns_model_graph_t *g) {
+    return (g->timer != NULL) ? ns_us_ticker_read(g->timer) : 0;
+}
+
+float ns_model_graph_score(const ns_model_graph_node_t *node, uint32_t index) {
+    const ns_model_graph_scores_t *s = &node->scores;
+
+    if ((s->data == NULL) || (index >= s->count)) {
+        return 0.0f;
+    }
+    switch (s->type) {
+    case NS_TENSOR_INT8:
+        return s->scale * (float)(((const int8_t *)s->data)[index] - s->zeroPoint);
+    case NS_TENSOR_INT16:
+        return s->scale * (float)(((const int16_t *)s->data)[index] - s->zeroPoint);
+    default:
+        return ((const float *)s->data)[index];
+    }
+}
+
+static bool ns_model_graph_test(const ns_model_graph_cond_t *c, const ns_model_graph_node_t *p) {
+    float score;
+
+    switch (c->type) {
+    case NS_MODEL_GRAPH_ALWAYS:
+        return true;
+    case NS_MODEL_GRAPH_SCORE_ABOVE:
+        return ns_model_graph_score(p, c->index) >= c->threshold;
+    case NS_MODEL_GRAPH_SCORE_BELOW:
+        return ns_model_graph_score(p, c->index) < c->threshold;
+    case NS_MODEL_GRAPH_ARGMAX:
+        score = ns_model_graph_score(p, c->index);
+        if ((c->index >= p->scores.count) || (score < c->threshold)) {
+            return false;
+        }
+        // Lower indices win ties, as with ns_tensor_argmax()
+        for (uint32_t i = 0; i < p->scores.count; i++) {
+            float other = ns_model_graph_score(p, i);
+            if ((other > score) || ((i < c->index) && (other == score))) {
+                return false;
+            }
+        }
+        return true;
+    case NS_MODEL_GRAPH_CUSTOM:
+        return c->test(p, c->arg);
+    }
+    return false;
+}
+
+static void ns_model_graph_wake(ns_model_graph_node_t *n, const ns_model_graph_node_t *p) {
+    bool hit = ns_model_graph_test(&n->when, p);
+    uint32_t need = n->when.consecutive ? n->when.consecutive : 1;
+
+    n->streak = hit ? n->streak + 1 : 0;
+    if (!n->awake) {
+        if (n->streak >= need) {
+            n->awake = true;
+            n->holdLeft = n->when.holdRuns;
+            n->stats.wakes++;
+        }
+    } else if (hit) {
+        n->holdLeft = n->when.holdRuns;
+    } else if (n->holdLeft > 0) {
+        n->holdLeft--;
+    } else {
+        n->awake = false;
+    }
+}
+
+// Move a node's outputs (and the scores among them) out of its arena before another node
+// re-plans it
+static uint32_t ns_model_graph_keep_outputs(ns_model_graph_node_t *n) {
+    uint8_t *copy = (uint8_t *)n->outCopy;
+    uint32_t offset = 0;
+
+    for (uint32_t p = 0; p < NS_MODEL_GRAPH_MAX_PORTS; p++) {
+        offset += (n->out[p].data != NULL) ? (n->out[p].bytes + 3) & ~3u : 0;
+    }
+    if (offset > n->outCopyBytes) {
+        return NS_STATUS_FAILURE;
+    }
+    offset = 0;
+    for (uint32_t p = 0; p < NS_MODEL_GRAPH_MAX_PORTS; p++) {
+        const uint8_t *src = (const uint8_t *)n->out[p].data;
+        const uint8_t *scores = (const uint8_t *)n->scores.data;
+        if (src == NULL) {
+            continue;
+        }
+        memcpy(copy + offset, src, n->out[p].bytes);
+        if ((scores >= src) && (scores < src + n->out[p].bytes)) {
+            n->scores.data = copy + offset + (scores - src);
+        }
+        n->out[p].data = copy + offset;
+        offset += (n->out[p].bytes + 3) & ~3u;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+// Initialize a node if it hasn't been, or if another node has used its arena since
+static uint32_t ns_model_graph_prepare(ns_model_graph_t *g, uint32_t i) {
+    ns_model_graph_node_t *n = &g->nodes[i];
+    int8_t *owner = n->arenaGroup ? &g->arenaOwner[n->arenaGroup - 1] : NULL;
+    uint32_t start;
+
+    if (n->ready && ((owner == NULL) || (*owner == (int8_t)i))) {
+        return NS_STATUS_SUCCESS;
+    }
+    if (owner != NULL) {
+        if ((*owner >= 0) && (*owner != (int8_t)i)) {
+            // Keep the previous owner's outputs, and let it tear down whatever it built in
+            // the arena, before the new owner re-plans it
+            ns_model_graph_node_t *prev = &g->nodes[*owner];
+            if (prev->ready && (ns_model_graph_keep_outputs(prev) != NS_STATUS_SUCCESS)) {
+                return NS_STATUS_FAILURE;
+            }
+            if ((prev->release != NULL) && (prev->release(prev) != NS_STATUS_SUCCESS)) {
+                return NS_STATUS_FAILURE;
+            }
+            prev->ready = false;
+        }
+        *owner = (int8_t)i;
+    }
+    start = ns_model_graph_ticks(g);
+    if ((n->init != NULL) && (n->init(n) != NS_STATUS_SUCCESS)) {
+        n->ready = false;
+        return NS_STATUS_FAILURE;
+    }
+    n->ready = true;
+    n->stats.inits++;
+    n->stats.initUs += ns_model_graph_ticks(g) - start;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_graph_init(ns_model_graph_t *g) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((g == NULL) || (g->nodes == NULL) || ((g->edges == NULL) && (g->numEdges != 0))) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    if ((g->numNodes == 0) || (g->numNodes > NS_MODEL_GRAPH_MAX_NODES)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    for (uint32_t i = 0; i < g->numNodes; i++) {
+        const ns_model_graph_node_t *n = &g->nodes[i];
+        if ((n->run == NULL) || (n->parent < -1) || (n->parent >= (int32_t)i) ||
+            (n->arenaGroup > NS_MODEL_GRAPH_MAX_ARENAS) ||
+            ((n->arenaGroup != 0) && (n->outCopy == NULL)) ||
+            ((n->parent >= 0) && (n->when.type == NS_MODEL_GRAPH_CUSTOM) &&
+             (n->when.test == NULL))) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        // Taking over the arena would clobber an ancestor's outputs mid-pass
+        for (uint32_t j = 0; (n->arenaGroup != 0) && (j < i); j++) {
+            if ((g->nodes[j].arenaGroup == n->arenaGroup) && ns_model_graph_is_ancestor(g, j, i)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+        }
+    }
+    for (uint32_t e = 0; e < g->numEdges; e++) {
+        const ns_model_graph_edge_t *edge = &g->edges[e];
+        if ((edge->to >= g->numNodes) || (edge->fromPort >= NS_MODEL_GRAPH_MAX_PORTS) ||
+            (edge->toPort >= NS_MODEL_GRAPH_MAX_PORTS) ||
+            !ns_model_graph_is_ancestor(g, edge->from, edge->to)) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    }
+
+    memset(g->arenaOwner, -1, sizeof(g->arenaOwner));
+    g->runs = 0;
+    for (uint32_t i = 0; i < g->numNodes; i++) {
+        ns_model_graph_node_t *n = &g->nodes[i];
+        memset(n->in, 0, sizeof(n->in));
+        memset(&n->stats, 0, sizeof(n->stats));
+        n->ready = false;
+    }
+    ns_model_graph_reset(g);
+    for (uint32_t i = 0; i < g->numNodes; i++) {
+        if (g->nodes[i].eager && (ns_model_graph_prepare(g, i) != NS_STATUS_SUCCESS)) {
+            return NS_STATUS_FAILURE;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_model_graph_reset(ns_model_graph_t *g) {
+    for (uint32_t i = 0; i < g->numNodes; i++) {
+        ns_model_graph_node_t *n = &g->nodes[i];
+        n->awake = n->parent < 0;
+        n->ran = false;
+        n->streak = 0;
+        n->holdLeft = 0;
+    }
+}
+
+uint32_t ns_model_graph_run(ns_model_graph_t *g) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((g == NULL) || (g->nodes == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    g->runs++;
+    for (uint32_t i = 0; i < g->numNodes; i++) {
+        ns_model_graph_node_t *n = &g->nodes[i];
+        uint32_t start, us;
+
+        n->ran = false;
+        if (n->parent >= 0) {
+            const ns_model_graph_node_t *p = &g->nodes[n->parent];
+            if (!p->ran) {
+                n->awake = false;
+                n->streak = 0;
+                n->holdLeft = 0;
+                continue;
+            }
+            ns_model_graph_wake(n, p);
+            if (!n->awake) {
+                continue;
+            }
+        }
+
+        if (ns_model_graph_prepare(g, i) != NS_STATUS_SUCCESS) {
+            return NS_STATUS_FAILURE;
+        }
+        // Producers may have been (re)initialized since the last pass, so their buffers can
+        // have moved
+        for (uint32_t e = 0; e < g->numEdges; e++) {
+            const ns_model_graph_edge_t *edge = &g->edges[e];
+            if (edge->to == i) {
+                n->in[edge->toPort] = g->nodes[edge->from].out[edge->fromPort];
+            }
+        }
+
+        start = ns_model_graph_ticks(g);
+        if (n->run(n) != NS_STATUS_SUCCESS) {
+            return NS_STATUS_FAILURE;
+        }
+        us = ns_model_graph_ticks(g) - start;
+        n->ran = true;
+        n->stats.runs++;
+        n->stats.runUs += us;
+        if (us > n->stats.maxRunUs) {
+            n->stats.maxRunUs = us;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_model_graph_print_stats(const ns_model_graph_t *g) {
+    ns_lp_printf("Graph: %u runs\n", g->runs);
+    for (uint32_t i = 0; i < g->numNodes; i++) {
+        const ns_model_graph_node_t *n = &g->nodes[i];
+        const ns_model_graph_node_stats_t *s = &n->stats;
+        uint32_t permille = g->runs ? (uint32_t)((uint64_t)s->runs * 1000 / g->runs) : 0;
+        uint32_t avg = s->runs ? (uint32_t)(s->runUs / s->runs) : 0;
+
+        ns_lp_printf("  %s: %u runs (%u.%u%%), %u wakes, %u inits, %u us avg, %u us max, "
+                     "%u us init\n",
+                     n->name ? n->name : "?", s->runs, permille / 10, permille % 10, s->wakes,
+                     s->inits, avg, s->maxRunUs, s->initUs);
+    }
+}
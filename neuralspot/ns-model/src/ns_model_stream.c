@@ -0,0 +1,153 @@
+/**
+ * @file ns_model_stream.c
+ * @author Ambiq
+ * @brief Streaming inference: frame gathering and state carry between invokes
+ * @version 0.1
+ * @date 2025-08-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_model_stream.h"
+#include "ns_core.h"
+#include <string.h>
+
+static bool ns_model_stream_overlap(const uint8_t *a, uint32_t aBytes, const uint8_t *b,
+                                    uint32_t bBytes) {
+    return ((uintptr_t)a < (uintptr_t)b + bBytes) && ((uintptr_t)b < (uintptr_t)a + aBytes);
+}
+
+// TFLM's planner can place a state output over another state's input once that input has
+// been consumed. Copy a state back only when no other pending copy still has to read from
+// where it writes; a cycle would need a staging buffer and is rejected.
+static uint32_t ns_model_stream_order_copies(ns_model_stream_t *s) {
+    uint32_t n = s->desc->numStates, done = 0;
+
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t pick = n;
+        for (uint32_t i = 0; (i < n) && (pick == n); i++) {
+            bool blocked = (done >> i) & 1u;
+            for (uint32_t j = 0; (j < n) && !blocked; j++) {
+                blocked = (j != i) && !((done >> j) & 1u) &&
+                          ns_model_stream_overlap(s->states[i].in, s->states[i].bytes,
+                                                  s->states[j].out, s->states[j].bytes);
+            }
+            pick = blocked ? n : i;
+        }
+        if (pick == n) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        s->copyOrder[k] = (uint8_t)pick;
+        done |= 1u << pick;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_stream_init(ns_model_stream_t *s) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((s == NULL) || (s->desc == NULL) || (s->input == NULL) || (s->invoke == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    const ns_model_stream_desc_t *d = s->desc;
+    if ((d->framesPerStep == 0) || (d->frameBytes == 0) ||
+        (d->numStates > NS_MODEL_STREAM_MAX_STATES)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if (d->mode == NS_MODEL_STREAM_EXTERNAL_STATE) {
+        for (uint32_t i = 0; i < d->numStates; i++) {
+            if ((s->states[i].in == NULL) || (s->states[i].out == NULL) ||
+                (s->states[i].bytes == 0)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+        }
+        if (ns_model_stream_order_copies(s) != NS_STATUS_SUCCESS) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    } else if (d->mode != NS_MODEL_STREAM_RESOURCE_VARIABLES) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    return ns_model_stream_reset(s);
+}
+
+uint32_t ns_model_stream_reset(ns_model_stream_t *s) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((s == NULL) || (s->desc == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    if (s->desc->mode == NS_MODEL_STREAM_EXTERNAL_STATE) {
+        for (uint32_t i = 0; i < s->desc->numStates; i++) {
+            memset(s->states[i].in, s->states[i].resetValue, s->states[i].bytes);
+        }
+    }
+    if ((s->reset != NULL) && (s->reset(s->ctx) != NS_STATUS_SUCCESS)) {
+        return NS_STATUS_FAILURE;
+    }
+    s->pending = 0;
+    s->frames = 0;
+    s->steps = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_stream_step(ns_model_stream_t *s) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((s == NULL) || (s->desc == NULL) || (s->invoke == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    const ns_model_stream_desc_t *d = s->desc;
+
+    if (s->invoke(s->ctx) != NS_STATUS_SUCCESS) {
+        return NS_STATUS_FAILURE;
+    }
+    // The updated caches become next step's state. A state's output may overlap its own
+    // input, and other states' inputs, hence the order and memmove.
+    if (d->mode == NS_MODEL_STREAM_EXTERNAL_STATE) {
+        for (uint32_t i = 0; i < d->numStates; i++) {
+            const ns_model_stream_state_t *st = &s->states[s->copyOrder[i]];
+            memmove(st->in, st->out, st->bytes);
+        }
+    }
+    s->pending = 0;
+    s->steps++;
+    s->frames += d->framesPerStep;
+    if (s->frames > d->windowFrames) {
+        s->frames = d->windowFrames;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_model_stream_push(ns_model_stream_t *s, const void *frames, uint32_t numFrames) {
+    const uint8_t *src = (const uint8_t *)frames;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((s == NULL) || (s->desc == NULL) || ((frames == NULL) && (numFrames != 0))) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    const ns_model_stream_desc_t *d = s->desc;
+
+    while (numFrames > 0) {
+        uint32_t n = d->framesPerStep - s->pending;
+        n = n < numFrames ? n : numFrames;
+        memcpy(s->input + s->pending * d->frameBytes, src, n * d->frameBytes);
+        s->pending += n;
+        src += n * d->frameBytes;
+        numFrames -= n;
+        if (s->pending == d->framesPerStep) {
+            if (ns_model_stream_step(s) != NS_STATUS_SUCCESS) {
+                return NS_STATUS_FAILURE;
+            }
+            if (s->output != NULL) {
+                s->output(s, s->outputArg);
+            }
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+bool ns_model_stream_warm(const ns_model_stream_t *s) {
+    return (s != NULL) && (s->desc != NULL) && (s->frames >= s->desc->windowFrames);
+}
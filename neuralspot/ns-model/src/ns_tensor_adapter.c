@@ -0,0 +1,428 @@
+/**
+ * @file ns_tensor_adapter.c
+ * @author Ambiq
+ * @brief Typed model input/output adapters: fused normalize + quantize, dequantize, softmax, top-k
+ * @version 0.1
+ * @date 2025-08-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_tensor_adapter.h"
+#include "ns_core.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+    #include <arm_mve.h>
+    #define NS_TENSOR_MVE
+#endif
+
+/// Top-k keeps its candidates on the stack
+#define NS_TENSOR_TOPK_MAX 32
+
+// Saturating conversions, rounding half away from zero like TFLite's quantize
+static inline int8_t ns_tensor_sat_s8(float y) {
+    y = y < -128.0f ? -128.0f : (y > 127.0f ? 127.0f : y);
+    return (int8_t)(int32_t)(y < 0.0f ? y - 0.5f : y + 0.5f);
+}
+
+static inline int16_t ns_tensor_sat_s16(float y) {
+    y = y < -32768.0f ? -32768.0f : (y > 32767.0f ? 32767.0f : y);
+    return (int16_t)(int32_t)(y < 0.0f ? y - 0.5f : y + 0.5f);
+}
+
+static inline float ns_tensor_f32(float y) { return y; }
+
+// Portable kernels. A period above 1 is only used for contiguous runs.
+#define NS_TENSOR_AFFINE(name, srcT, dstT, convert)                                               \
+    static void name(                                                                              \
+        const void *src, uint32_t srcStride, void *dst, uint32_t dstStride, uint32_t n,           \
+        const float *mul, const float *add, uint32_t period) {                                     \
+        const srcT *s = (const srcT *)src;                                                         \
+        dstT *d = (dstT *)dst;                                                                     \
+        if (period == 1) {                                                                         \
+            float m = mul[0], a = add[0];                                                          \
+            if ((srcStride == 1) && (dstStride == 1)) {                                            \
+                for (uint32_t i = 0; i < n; i++) {                                                 \
+                    d[i] = convert((float)s[i] * m + a);                                           \
+                }                                                                                  \
+            } else {                                                                               \
+                for (uint32_t i = 0; i < n; i++) {                                                 \
+                    d[i * dstStride] = convert((float)s[i * srcStride] * m + a);                   \
+                }                                                                                  \
+            }                                                                                      \
+            return;                                                                                \
+        }                                                                                          \
+        for (uint32_t i = 0; i < n; i += period) {                                                 \
+            uint32_t len = n - i < period ? n - i : period;                                        \
+            for (uint32_t j = 0; j < len; j++) {                                                   \
+                d[i + j] = convert((float)s[i + j] * mul[j] + add[j]);                             \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+NS_TENSOR_AFFINE(ns_tensor_f32_s8, float, int8_t, ns_tensor_sat_s8)
+NS_TENSOR_AFFINE(ns_tensor_f32_s16, float, int16_t, ns_tensor_sat_s16)
+NS_TENSOR_AFFINE(ns_tensor_f32_f32, float, float, ns_tensor_f32)
+NS_TENSOR_AFFINE(ns_tensor_s16_s8, int16_t, int8_t, ns_tensor_sat_s8)
+NS_TENSOR_AFFINE(ns_tensor_s16_s16, int16_t, int16_t, ns_tensor_sat_s16)
+NS_TENSOR_AFFINE(ns_tensor_s16_f32, int16_t, float, ns_tensor_f32)
+NS_TENSOR_AFFINE(ns_tensor_s8_f32, int8_t, float, ns_tensor_f32)
+
+#ifdef NS_TENSOR_MVE
+// Helium versions of the two hot paths (float into an int8 input, int8 output into float).
+// Runs are tail predicated; periodic coefficients need a period that is a multiple of 4,
+// which ns_tensor_coeffs() arranges whenever it can.
+static void ns_tensor_f32_s8_mve(
+    const void *src, uint32_t srcStride, void *dst, uint32_t dstStride, uint32_t n,
+    const float *mul, const float *add, uint32_t period) {
+    const float *s = (const float *)src;
+    int8_t *d = (int8_t *)dst;
+    int32x4_t lo = vdupq_n_s32(-128), hi = vdupq_n_s32(127);
+
+    if ((srcStride != 1) || (dstStride != 1) || ((period != 1) && (period & 3))) {
+        ns_tensor_f32_s8(src, srcStride, dst, dstStride, n, mul, add, period);
+        return;
+    }
+    if (period == 1) {
+        float32x4_t vm = vdupq_n_f32(mul[0]), va = vdupq_n_f32(add[0]);
+        for (uint32_t i = 0; i < n; i += 4) {
+            mve_pred16_t p = vctp32q(n - i);
+            float32x4_t y = vfmaq_f32(va, vld1q_z_f32(s + i, p), vm);
+            vstrbq_p_s32(d + i, vmaxq_s32(vminq_s32(vcvtaq_s32_f32(y), hi), lo), p);
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < n; i += period) {
+        uint32_t len = n - i < period ? n - i : period;
+        for (uint32_t j = 0; j < len; j += 4) {
+            mve_pred16_t p = vctp32q(len - j);
+            float32x4_t y = vfmaq_f32(vld1q_f32(add + j), vld1q_z_f32(s + i + j, p),
+                                      vld1q_f32(mul + j));
+            vstrbq_p_s32(d + i + j, vmaxq_s32(vminq_s32(vcvtaq_s32_f32(y), hi), lo), p);
+        }
+    }
+}
+
+static void ns_tensor_s8_f32_mve(
+    const void *src, uint32_t srcStride, void *dst, uint32_t dstStride, uint32_t n,
+    const float *mul, const float *add, uint32_t period) {
+    const int8_t *s = (const int8_t *)src;
+    float *d = (float *)dst;
+
+    if ((srcStride != 1) || (dstStride != 1) || ((period != 1) && (period & 3))) {
+        ns_tensor_s8_f32(src, srcStride, dst, dstStride, n, mul, add, period);
+        return;
+    }
+    if (period == 1) {
+        float32x4_t vm = vdupq_n_f32(mul[0]), va = vdupq_n_f32(add[0]);
+        for (uint32_t i = 0; i < n; i += 4) {
+            mve_pred16_t p = vctp32q(n - i);
+            float32x4_t x = vcvtq_f32_s32(vldrbq_z_s32(s + i, p));
+            vstrwq_p_f32(d + i, vfmaq_f32(va, x, vm), p);
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < n; i += period) {
+        uint32_t len = n - i < period ? n - i : period;
+        for (uint32_t j = 0; j < len; j += 4) {
+            mve_pred16_t p = vctp32q(len - j);
+            float32x4_t x = vcvtq_f32_s32(vldrbq_z_s32(s + i + j, p));
+            vstrwq_p_f32(d + i + j, vfmaq_f32(vld1q_f32(add + j), x, vld1q_f32(mul + j)), p);
+        }
+    }
+}
+
+static const ns_tensor_kernels_t ns_tensor_kernels_s8 = {
+    ns_tensor_f32_s8_mve, ns_tensor_s16_s8, ns_tensor_s8_f32_mve, 1};
+#else
+static const ns_tensor_kernels_t ns_tensor_kernels_s8 = {
+    ns_tensor_f32_s8, ns_tensor_s16_s8, ns_tensor_s8_f32, 1};
+#endif
+
+static const ns_tensor_kernels_t ns_tensor_kernels_s16 = {
+    ns_tensor_f32_s16, ns_tensor_s16_s16, ns_tensor_s16_f32, 2};
+
+static const ns_tensor_kernels_t ns_tensor_kernels_f32 = {
+    ns_tensor_f32_f32, ns_tensor_s16_f32, ns_tensor_f32_f32, 4};
+
+uint32_t ns_tensor_adapter_config(
+    ns_tensor_adapter_t *t, ns_tensor_type_e type, void *data, const int32_t *dims,
+    uint32_t numDims, const float *scales, const int32_t *zeroPoints, uint32_t numScales) {
+    uint32_t elements = 1;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((t == NULL) || (data == NULL) || ((dims == NULL) && (numDims > 0))) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    for (uint32_t i = 0; i < numDims; i++) {
+        if (dims[i] <= 0) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        elements *= (uint32_t)dims[i];
+    }
+    switch (type) {
+    case NS_TENSOR_INT8:
+        t->kernels = &ns_tensor_kernels_s8;
+        break;
+    case NS_TENSOR_INT16:
+        t->kernels = &ns_tensor_kernels_s16;
+        break;
+    case NS_TENSOR_FLOAT32:
+        t->kernels = &ns_tensor_kernels_f32;
+        scales = NULL; // Float tensors carry no quantization
+        break;
+    default:
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    t->type = type;
+    t->data = data;
+    t->elements = elements;
+    t->channels = numDims ? (uint32_t)dims[numDims - 1] : 1;
+    t->batches = numDims > 1 ? (uint32_t)dims[0] : 1;
+    t->spatial = elements / (t->batches * t->channels);
+
+    if (scales == NULL) {
+        t->numScales = 1;
+        t->scale[0] = 1.0f;
+        t->zeroPoint[0] = 0;
+        return NS_STATUS_SUCCESS;
+    }
+    if ((numScales == 0) || (numScales > NS_TENSOR_MAX_CHANNELS) ||
+        ((numScales > 1) && (numScales != t->channels))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    for (uint32_t c = 0; c < numScales; c++) {
+        if (!(scales[c] > 0.0f)) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+        t->scale[c] = scales[c];
+        t->zeroPoint[c] = zeroPoints ? zeroPoints[c] : 0;
+    }
+    t->numScales = numScales;
+    return NS_STATUS_SUCCESS;
+}
+
+// Per-channel (mul, add) for tensor = src * mul + add, or for the inverse. Returns the
+// coefficient period: 1 if every channel is the same, otherwise a whole number of channel
+// groups (a multiple of 4 too, when that fits) so contiguous kernels can run without
+// tracking the channel. 0 if there are too many channels.
+static uint32_t ns_tensor_coeffs(
+    const ns_tensor_adapter_t *t, const float *mean, const float *invStd, bool inverse,
+    float *mul, float *add) {
+    uint32_t C = t->channels, group = C, period;
+
+    if ((C == 1) || ((mean == NULL) && (invStd == NULL) && (t->numScales == 1))) {
+        C = 1;
+    } else if (C > NS_TENSOR_MAX_CHANNELS) {
+        return 0;
+    }
+    for (uint32_t c = 0; c < C; c++) {
+        float s = t->scale[t->numScales == 1 ? 0 : c];
+        float z = (float)t->zeroPoint[t->numScales == 1 ? 0 : c];
+        if (inverse) {
+            mul[c] = s;
+            add[c] = -z * s;
+        } else {
+            float k = (invStd ? invStd[c] : 1.0f) / s;
+            mul[c] = k;
+            add[c] = z - (mean ? mean[c] : 0.0f) * k;
+        }
+    }
+    if (C == 1) {
+        return 1;
+    }
+    while ((group & 3) && (group + C <= NS_TENSOR_COEFF_LEN)) {
+        group += C;
+    }
+    if (group & 3) {
+        group = C;
+    }
+    period = group * (NS_TENSOR_COEFF_LEN / group);
+    for (uint32_t i = C; i < period; i++) {
+        mul[i] = mul[i - C];
+        add[i] = add[i - C];
+    }
+    return period;
+}
+
+static uint32_t ns_tensor_quantize(
+    const ns_tensor_adapter_t *t, const void *src, uint32_t srcBytes, ns_tensor_affine_fn fn,
+    ns_tensor_layout_e srcLayout, const float *mean, const float *invStd) {
+    float mul[NS_TENSOR_COEFF_LEN], add[NS_TENSOR_COEFF_LEN];
+    uint32_t period, C = t->channels, S = t->spatial;
+
+    period = ns_tensor_coeffs(t, mean, invStd, false, mul, add);
+    if (period == 0) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    if ((srcLayout == NS_TENSOR_NHWC) || (C == 1) || (S == 1)) {
+        fn(src, 1, t->data, 1, t->elements, mul, add, period);
+        return NS_STATUS_SUCCESS;
+    }
+    // Planar source: one contiguous read per channel plane, strided writes into the tensor
+    for (uint32_t b = 0; b < t->batches; b++) {
+        for (uint32_t c = 0; c < C; c++) {
+            uint32_t k = period == 1 ? 0 : c;
+            fn((const uint8_t *)src + (size_t)(b * S * C + c * S) * srcBytes, 1,
+               (uint8_t *)t->data + (size_t)(b * S * C + c) * t->kernels->elementBytes, C, S,
+               &mul[k], &add[k], 1);
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_tensor_quantize_f32(
+    const ns_tensor_adapter_t *t, const float *src, ns_tensor_layout_e srcLayout,
+    const float *mean, const float *invStd) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((t == NULL) || (t->kernels == NULL) || (src == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    return ns_tensor_quantize(t, src, sizeof(float), t->kernels->fromF32, srcLayout, mean, invStd);
+}
+
+uint32_t ns_tensor_quantize_s16(
+    const ns_tensor_adapter_t *t, const int16_t *src, ns_tensor_layout_e srcLayout,
+    const float *mean, const float *invStd) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((t == NULL) || (t->kernels == NULL) || (src == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    return ns_tensor_quantize(
+        t, src, sizeof(int16_t), t->kernels->fromS16, srcLayout, mean, invStd);
+}
+
+uint32_t
+ns_tensor_dequantize(const ns_tensor_adapter_t *t, float *dst, ns_tensor_layout_e dstLayout) {
+    float mul[NS_TENSOR_COEFF_LEN], add[NS_TENSOR_COEFF_LEN];
+    uint32_t period, C, S;
+    uint32_t eb;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((t == NULL) || (t->kernels == NULL) || (dst == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    C = t->channels;
+    S = t->spatial;
+    eb = t->kernels->elementBytes;
+    period = ns_tensor_coeffs(t, NULL, NULL, true, mul, add);
+    if ((dstLayout == NS_TENSOR_NHWC) || (C == 1) || (S == 1)) {
+        t->kernels->toF32(t->data, 1, dst, 1, t->elements, mul, add, period);
+        return NS_STATUS_SUCCESS;
+    }
+    for (uint32_t b = 0; b < t->batches; b++) {
+        for (uint32_t c = 0; c < C; c++) {
+            uint32_t k = period == 1 ? 0 : c;
+            t->kernels->toF32((const uint8_t *)t->data + (size_t)(b * S * C + c) * eb, C,
+                              dst + b * S * C + c * S, 1, S, &mul[k], &add[k], 1);
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_tensor_softmax(const ns_tensor_adapter_t *t, float *probs) {
+    uint32_t status = ns_tensor_dequantize(t, probs, NS_TENSOR_NHWC);
+    uint32_t C;
+
+    if (status != NS_STATUS_SUCCESS) {
+        return status;
+    }
+    C = t->channels;
+    for (uint32_t r = 0; r < t->elements; r += C) {
+        float *x = probs + r;
+        float max = x[0], sum = 0.0f;
+        for (uint32_t c = 1; c < C; c++) {
+            max = x[c] > max ? x[c] : max;
+        }
+        for (uint32_t c = 0; c < C; c++) {
+            x[c] = expf(x[c] - max);
+            sum += x[c];
+        }
+        sum = 1.0f / sum;
+        for (uint32_t c = 0; c < C; c++) {
+            x[c] *= sum;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static inline float ns_tensor_raw(const ns_tensor_adapter_t *t, uint32_t i) {
+    switch (t->type) {
+    case NS_TENSOR_INT8:
+        return (float)((const int8_t *)t->data)[i];
+    case NS_TENSOR_INT16:
+        return (float)((const int16_t *)t->data)[i];
+    default:
+        return ((const float *)t->data)[i];
+    }
+}
+
+static inline float ns_tensor_value(const ns_tensor_adapter_t *t, uint32_t i) {
+    uint32_t c = t->numScales == 1 ? 0 : i % t->channels;
+    return (ns_tensor_raw(t, i) - (float)t->zeroPoint[c]) * t->scale[c];
+}
+
+uint32_t
+ns_tensor_top_k(const ns_tensor_adapter_t *t, uint32_t k, uint32_t *indices, float *values) {
+    float keys[NS_TENSOR_TOPK_MAX];
+    uint32_t found = 0;
+    bool raw;
+
+    if ((t == NULL) || (indices == NULL) || (k == 0)) {
+        return 0;
+    }
+    // With one positive scale the raw values rank the same as the real ones
+    raw = t->numScales == 1;
+    k = k > NS_TENSOR_TOPK_MAX ? NS_TENSOR_TOPK_MAX : k;
+    for (uint32_t i = 0; i < t->elements; i++) {
+        float key = raw ? ns_tensor_raw(t, i) : ns_tensor_value(t, i);
+        uint32_t pos;
+        if ((found == k) && !(key > keys[k - 1])) {
+            continue;
+        }
+        pos = found < k ? found++ : k - 1;
+        while ((pos > 0) && (key > keys[pos - 1])) {
+            keys[pos] = keys[pos - 1];
+            indices[pos] = indices[pos - 1];
+            pos--;
+        }
+        keys[pos] = key;
+        indices[pos] = i;
+    }
+    if (values != NULL) {
+        for (uint32_t j = 0; j < found; j++) {
+            values[j] = ns_tensor_value(t, indices[j]);
+        }
+    }
+    return found;
+}
+
+uint32_t ns_tensor_argmax(const ns_tensor_adapter_t *t) {
+    uint32_t i = 0, best = 0;
+
+    if ((t != NULL) && (t->type == NS_TENSOR_INT8) && (t->numScales == 1)) {
+        // The common classifier output: find the max, then its first position
+        const int8_t *x = (const int8_t *)t->data;
+        int8_t max = -128;
+#ifdef NS_TENSOR_MVE
+        for (; i + 16 <= t->elements; i += 16) {
+            max = vmaxvq_s8(max, vld1q_s8(x + i));
+        }
+#endif
+        for (; i < t->elements; i++) {
+            max = x[i] > max ? x[i] : max;
+        }
+        for (i = 0; (i + 1 < t->elements) && (x[i] != max); i++) {
+        }
+        return i;
+    }
+    ns_tensor_top_k(t, 1, &best, NULL);
+    return best;
+}
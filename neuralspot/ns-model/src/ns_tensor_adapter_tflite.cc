@@ -0,0 +1,76 @@
+/**
+ * @file ns_tensor_adapter_tflite.cc
+ * @author Ambiq
+ * @brief Fill a tensor adapter from a TfLiteTensor
+ * @version 0.1
+ * @date 2025-08-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_core.h"
+#include "ns_tensor_adapter.h"
+#include "tensorflow/lite/c/common.h"
+
+uint32_t ns_tensor_adapter_init(ns_tensor_adapter_t *t, const TfLiteTensor *tensor) {
+    ns_tensor_type_e type;
+    const int32_t *dims;
+    int32_t flat[1];
+    uint32_t numDims, elementBytes;
+    const float *scales = NULL;
+    const int32_t *zeroPoints = NULL;
+    uint32_t numScales = 1;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((t == NULL) || (tensor == NULL) || (tensor->data.data == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    switch (tensor->type) {
+    case kTfLiteInt8:
+        type = NS_TENSOR_INT8;
+        elementBytes = 1;
+        break;
+    case kTfLiteInt16:
+        type = NS_TENSOR_INT16;
+        elementBytes = 2;
+        break;
+    case kTfLiteFloat32:
+        type = NS_TENSOR_FLOAT32;
+        elementBytes = 4;
+        break;
+    default:
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    if ((tensor->dims != NULL) && (tensor->dims->size > 0)) {
+        dims = tensor->dims->data;
+        numDims = tensor->dims->size;
+    } else {
+        // AOT tensor views only carry their size
+        flat[0] = tensor->bytes / elementBytes;
+        dims = flat;
+        numDims = 1;
+    }
+
+    if (type != NS_TENSOR_FLOAT32) {
+        const TfLiteAffineQuantization *q =
+            (const TfLiteAffineQuantization *)tensor->quantization.params;
+        if ((tensor->quantization.type == kTfLiteAffineQuantization) && (q != NULL) &&
+            (q->scale != NULL) && (q->scale->size > 1)) {
+            if ((q->quantized_dimension != (int32_t)numDims - 1) || (q->zero_point == NULL) ||
+                (q->zero_point->size != q->scale->size)) {
+                return NS_STATUS_INVALID_CONFIG;
+            }
+            scales = q->scale->data;
+            zeroPoints = q->zero_point->data;
+            numScales = q->scale->size;
+        } else if (tensor->params.scale > 0.0f) {
+            scales = &tensor->params.scale;
+            zeroPoints = &tensor->params.zero_point;
+        }
+    }
+    return ns_tensor_adapter_config(
+        t, type, tensor->data.data, dims, numDims, scales, zeroPoints, numScales);
+}
@@ -0,0 +1,168 @@
+#include "ns_model_aot_tests.h"
+#include "ns_core.h"
+#include "ns_model_aot_tests_tiny_aot.h"
+#include "ns_timer.h"
+#include "unity/unity.h"
+#include <string.h>
+
+// ns_model_aot_tests_tiny.tflite runs on both of ns_model's runtimes: the TFLM interpreter,
+// and ns_model_aot_tests_tiny_aot.c, its aot_compiler.py output (checked in, kept current by
+// tools/autodeploy/tests/test_aot_compiler.py). The model has one of each op the compiler
+// supports: CONV_2D, DEPTHWISE_CONV_2D, ADD, MAX_POOL_2D, AVERAGE_POOL_2D, RESHAPE,
+// FULLY_CONNECTED and SOFTMAX, on a 49x10 int8 input.
+
+#define AT_AOT_ARENA ns_model_aot_tests_tiny_AOT_ARENA_SIZE
+#define AT_TFLM_ARENA (32 * 1024)
+#define AT_INPUT_BYTES (49 * 10)
+#define AT_OUTPUT_BYTES 12
+#define AT_RUNS 32
+#define AT_BENCH_INITS 10
+#define AT_BENCH_INVOKES 100
+
+static uint8_t tflmArena[AT_TFLM_ARENA] __attribute__((aligned(16)));
+static uint8_t aotArena[AT_AOT_ARENA + NS_AOT_ARENA_ALIGNMENT] __attribute__((aligned(16)));
+static ns_model_aot_tests_model_t tflm, aot;
+static uint32_t lfsr;
+
+static void at_random_input(void) {
+    for (uint32_t i = 0; i < AT_INPUT_BYTES; i++) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        tflm.input[i] = (int8_t)lfsr;
+    }
+    memcpy(aot.input, tflm.input, AT_INPUT_BYTES);
+}
+
+static void at_init_both(void) {
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_model_aot_tests_init(NS_MODEL_AOT_TESTS_TFLM, NULL, tflmArena, AT_TFLM_ARENA, &tflm));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_model_aot_tests_init(
+            NS_MODEL_AOT_TESTS_AOT, &ns_model_aot_tests_tiny_aot_model, aotArena, AT_AOT_ARENA,
+            &aot));
+}
+
+// Runs both runtimes on the same random inputs; returns the runs whose output changed
+static uint32_t at_compare(uint32_t runs) {
+    int8_t last[AT_OUTPUT_BYTES];
+    uint32_t changed = 0;
+
+    memset(last, 0, sizeof(last));
+    for (uint32_t r = 0; r < runs; r++) {
+        at_random_input();
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_aot_tests_invoke(NS_MODEL_AOT_TESTS_TFLM));
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_aot_tests_invoke(NS_MODEL_AOT_TESTS_AOT));
+        TEST_ASSERT_EQUAL_INT8_ARRAY(tflm.output, aot.output, AT_OUTPUT_BYTES);
+        changed += memcmp(last, aot.output, AT_OUTPUT_BYTES) != 0;
+        memcpy(last, aot.output, AT_OUTPUT_BYTES);
+    }
+    return changed;
+}
+
+void ns_model_aot_tests_pre_test_hook() {
+    lfsr = 0xACE1u;
+    memset(&tflm, 0, sizeof(tflm));
+    memset(&aot, 0, sizeof(aot));
+}
+
+void ns_model_aot_tests_post_test_hook() {}
+
+void ns_model_aot_test_config() {
+    const ns_aot_model_t *m = &ns_model_aot_tests_tiny_aot_model;
+    const int rt = NS_MODEL_AOT_TESTS_AOT;
+
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG, ns_model_aot_tests_init(rt, NULL, aotArena, AT_AOT_ARENA, &aot));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG, ns_model_aot_tests_init(rt, m, NULL, AT_AOT_ARENA, &aot));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG, ns_model_aot_tests_init(rt, m, aotArena, AT_AOT_ARENA - 1, &aot));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG, ns_model_aot_tests_init(rt, m, aotArena + 1, AT_AOT_ARENA, &aot));
+    TEST_ASSERT_EQUAL(NS_STATUS_FAILURE, ns_model_aot_tests_invoke(rt)); // not initialized
+
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS, ns_model_aot_tests_init(rt, m, aotArena, AT_AOT_ARENA, &aot));
+    TEST_ASSERT_EQUAL(AT_AOT_ARENA, aot.arenaBytes);
+    TEST_ASSERT_EQUAL(AT_INPUT_BYTES, aot.inputBytes);
+    TEST_ASSERT_EQUAL(AT_OUTPUT_BYTES, aot.outputBytes);
+    TEST_ASSERT_TRUE(aot.input >= (int8_t *)aotArena);
+    TEST_ASSERT_TRUE(aot.output + AT_OUTPUT_BYTES <= (int8_t *)aotArena + AT_AOT_ARENA);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_aot_tests_invoke(rt));
+
+    // An arena too small for TFLM fails in AllocateTensors()
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_FAILURE,
+        ns_model_aot_tests_init(NS_MODEL_AOT_TESTS_TFLM, NULL, tflmArena, 1024, &tflm));
+}
+
+void ns_model_aot_test_matches_tflm() {
+    at_init_both();
+
+    // The compiler emits the flatbuffer's quantization parameters as they are
+    TEST_ASSERT_EQUAL(tflm.inputBytes, aot.inputBytes);
+    TEST_ASSERT_EQUAL(tflm.outputBytes, aot.outputBytes);
+    TEST_ASSERT_EQUAL_FLOAT(tflm.inputScale, aot.inputScale);
+    TEST_ASSERT_EQUAL(tflm.inputZeroPoint, aot.inputZeroPoint);
+    TEST_ASSERT_EQUAL_FLOAT(tflm.outputScale, aot.outputScale);
+    TEST_ASSERT_EQUAL(tflm.outputZeroPoint, aot.outputZeroPoint);
+
+    // Byte for byte, and on outputs that actually move with the input
+    TEST_ASSERT_TRUE(at_compare(AT_RUNS) > AT_RUNS / 2);
+}
+
+void ns_model_aot_test_reinit() {
+    at_init_both();
+    at_compare(4);
+
+    // Init again on a used arena: kernel sums and scratch are rebuilt, results don't change
+    at_init_both();
+    TEST_ASSERT_TRUE(at_compare(AT_RUNS) > AT_RUNS / 2);
+}
+
+void ns_model_aot_test_benchmark() {
+    ns_timer_config_t bench_timer = {
+        .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+    uint32_t start, tflmInitUs, aotInitUs, tflmInvokeUs, aotInvokeUs;
+
+    ns_timer_init(&bench_timer);
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t i = 0; i < AT_BENCH_INITS; i++) {
+        ns_model_aot_tests_init(NS_MODEL_AOT_TESTS_TFLM, NULL, tflmArena, AT_TFLM_ARENA, &tflm);
+    }
+    tflmInitUs = (ns_us_ticker_read(&bench_timer) - start) / AT_BENCH_INITS;
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t i = 0; i < AT_BENCH_INITS; i++) {
+        ns_model_aot_tests_init(
+            NS_MODEL_AOT_TESTS_AOT, &ns_model_aot_tests_tiny_aot_model, aotArena, AT_AOT_ARENA,
+            &aot);
+    }
+    aotInitUs = (ns_us_ticker_read(&bench_timer) - start) / AT_BENCH_INITS;
+    at_compare(4);
+
+    at_random_input();
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t i = 0; i < AT_BENCH_INVOKES; i++) {
+        ns_model_aot_tests_invoke(NS_MODEL_AOT_TESTS_TFLM);
+    }
+    tflmInvokeUs = ns_us_ticker_read(&bench_timer) - start;
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t i = 0; i < AT_BENCH_INVOKES; i++) {
+        ns_model_aot_tests_invoke(NS_MODEL_AOT_TESTS_AOT);
+    }
+    aotInvokeUs = ns_us_ticker_read(&bench_timer) - start;
+    TEST_ASSERT_EQUAL_INT8_ARRAY(tflm.output, aot.output, AT_OUTPUT_BYTES);
+
+    // Both run the same CMSIS-NN kernels, so the invoke difference is the interpreter's overhead
+    ns_lp_printf("AOT vs TFLM, %s:\n", ns_model_aot_tests_tiny_aot_model.name);
+    ns_lp_printf("  init:   %u us TFLM, %u us AOT\n", tflmInitUs, aotInitUs);
+    ns_lp_printf("  invoke: %u ns TFLM, %u ns AOT, interpreter overhead %d ns\n",
+                 (uint32_t)((uint64_t)tflmInvokeUs * 1000 / AT_BENCH_INVOKES),
+                 (uint32_t)((uint64_t)aotInvokeUs * 1000 / AT_BENCH_INVOKES),
+                 (int32_t)(((int64_t)tflmInvokeUs - aotInvokeUs) * 1000 / AT_BENCH_INVOKES));
+    ns_lp_printf("  arena:  %u bytes TFLM, %u bytes AOT\n", tflm.arenaBytes, aot.arenaBytes);
+}
@@ -0,0 +1,43 @@
+#include "ns_aot_model.h"
+#include <stdint.h>
+
+#define NS_MODEL_AOT_TESTS_TFLM 0
+#define NS_MODEL_AOT_TESTS_AOT 1
+
+typedef struct {
+    int8_t *input;
+    uint32_t inputBytes;
+    float inputScale;
+    int32_t inputZeroPoint;
+    int8_t *output;
+    uint32_t outputBytes;
+    float outputScale;
+    int32_t outputZeroPoint;
+    uint32_t arenaBytes; // computed_arena_size: arena_used_bytes() for TFLM
+} ns_model_aot_tests_model_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+    ns_model_init() ns_model_aot_tests_tiny.tflite on runtime (NS_MODEL_AOT_TESTS_TFLM or _AOT)
+    over arena. aot is the compiled model, ignored by TFLM. On success, fills m from the
+    model's input and output tensors. Returns ns_model_init()'s status.
+    In ns_model_aot_tests_runtime.cc, as ns_model.h is C++ only.
+*/
+int ns_model_aot_tests_init(
+    int runtime, const ns_aot_model_t *aot, uint8_t *arena, uint32_t arenaSize,
+    ns_model_aot_tests_model_t *m);
+
+/* ns_model_invoke() the model last initialized on runtime */
+int ns_model_aot_tests_invoke(int runtime);
+#ifdef __cplusplus
+}
+#endif
+
+void ns_model_aot_tests_pre_test_hook();
+void ns_model_aot_tests_post_test_hook();
+void ns_model_aot_test_config();
+void ns_model_aot_test_matches_tflm();
+void ns_model_aot_test_reinit();
+void ns_model_aot_test_benchmark();
@@ -0,0 +1,64 @@
+// The TFLM and AOT runtimes behind ns_model_aot_tests.c. Kept out of the library: autotest
+// builds it next to the test.
+#include "ns_core.h"
+#include "ns_model.h"
+#include "ns_model_aot_tests.h"
+#include "ns_model_aot_tests_tiny_model.h"
+
+static ns_model_state_t models[2];
+
+// Every op of ns_model_aot_tests_tiny.tflite
+static const tflite::MicroOpResolver *ns_model_aot_tests_resolver() {
+    static tflite::MicroMutableOpResolver<8> resolver;
+    static bool filled = false;
+    if (!filled) {
+        resolver.AddConv2D();
+        resolver.AddDepthwiseConv2D();
+        resolver.AddAdd();
+        resolver.AddMaxPool2D();
+        resolver.AddAveragePool2D();
+        resolver.AddReshape();
+        resolver.AddFullyConnected();
+        resolver.AddSoftmax();
+        filled = true;
+    }
+    return &resolver;
+}
+
+int ns_model_aot_tests_init(
+    int runtime, const ns_aot_model_t *aot, uint8_t *arena, uint32_t arenaSize,
+    ns_model_aot_tests_model_t *m) {
+    ns_model_state_t *ms = &models[runtime];
+    int status;
+
+    ms->runtime = (runtime == NS_MODEL_AOT_TESTS_AOT) ? AOT : TFLM;
+    ms->model_array = ns_model_aot_tests_tiny_model;
+    ms->resolver = ns_model_aot_tests_resolver();
+    ms->aot_model = aot;
+    ms->arena = arena;
+    ms->arena_size = arenaSize;
+    ms->rv_arena = NULL;
+    ms->rv_arena_size = 0;
+    ms->rv_count = 0;
+    ms->numInputTensors = 1;
+    ms->numOutputTensors = 1;
+
+    status = ns_model_init(ms);
+    if (status != NS_STATUS_SUCCESS) {
+        return status;
+    }
+    m->input = ms->model_input[0]->data.int8;
+    m->inputBytes = ms->model_input[0]->bytes;
+    m->inputScale = ms->model_input[0]->params.scale;
+    m->inputZeroPoint = ms->model_input[0]->params.zero_point;
+    m->output = ms->model_output[0]->data.int8;
+    m->outputBytes = ms->model_output[0]->bytes;
+    m->outputScale = ms->model_output[0]->params.scale;
+    m->outputZeroPoint = ms->model_output[0]->params.zero_point;
+    m->arenaBytes = ms->computed_arena_size;
+    return status;
+}
+
+int ns_model_aot_tests_invoke(int runtime) {
+    return ns_model_invoke(&models[runtime]);
+}
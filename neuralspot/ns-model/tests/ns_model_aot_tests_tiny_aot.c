@@ -0,0 +1,184 @@
+/**
+ * @file ns_model_aot_tests_tiny_aot.c
+ * @brief Generated by aot_compiler.py - 8 ops compiled to direct CMSIS-NN calls
+ *
+ * Arena layout (7536 bytes):
+ *   [0, 3024) activations
+ *   [3024, 7488) kernel scratch
+ *   [7488, 7536) persistent kernel sums
+ */
+
+#include "ns_model_aot_tests_tiny_aot.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(NS_TF_VERSION_Oct_08_2024_e86d97b6)
+    #include "cmsis_nn/Include/arm_nnfunctions.h"
+#else
+    #include "ns_cmsis_nn/Include/arm_nnfunctions.h"
+#endif
+
+#define ns_model_aot_tests_tiny_AOT_SCRATCH_OFFSET 3024
+#define ns_model_aot_tests_tiny_AOT_SCRATCH_SIZE 4464
+
+// Weights, biases and requantization constants
+static const int32_t ns_model_aot_tests_tiny_mult0[8] __attribute__((aligned(16))) = {
+    1717986854, 1889785572, 2061584289, 1116691503, 1202590862, 1288490141, 1374389580,
+    1460288938,
+};
+static const int32_t ns_model_aot_tests_tiny_shift0[8] __attribute__((aligned(16))) = {
+    -5, -5, -5, -4, -4, -4, -4, -4,
+};
+static const int8_t ns_model_aot_tests_tiny_const0[320] __attribute__((aligned(16))) = {
+    91, 23, 13, -14, -26, 73, 20, 126, -121, 96, -103, 126, 111, -29, 75, -31, -91, -41, -98,
+    116, 95, 120, 63, 83, 12, -79, 51, 35, 29, -36, -42, 86, 121, 67, -87, 68, 9, 30, 78, 121,
+    -44, -46, 95, -30, 125, -124, 69, -109, -19, 111, -19, -12, 65, 82, -60, -47, -103, -62,
+    53, -4, 47, 123, -25, 107, 27, 124, -81, 119, 45, 73, -123, 45, -74, 86, 56, 34, 46, 82,
+    -85, -55, 24, -99, 89, -125, -8, -105, 57, -29, -100, -26, -50, -12, -58, 43, 111, -70, 2,
+    2, -6, 75, -55, 119, 61, -86, 109, -56, 81, -6, -100, 28, -57, -89, 70, 71, 127, -40, 94,
+    -110, -34, 121, -76, -95, -80, 43, -71, -16, 4, -20, -29, 71, -59, -72, 66, -78, -86, -112,
+    123, 14, 38, 97, 33, 28, 88, -3, 78, 105, 81, 31, -112, 95, 80, -55, 39, 62, -34, -114,
+    100, -4, -84, -74, 105, -11, -77, -93, 92, -55, -102, -75, -112, 99, 43, -92, -4, 48, -70,
+    20, 58, -35, -102, -99, -9, 118, -63, 23, 43, -60, -97, 18, 73, -79, -40, 99, 68, 16, -37,
+    -5, -72, -125, -98, -100, -86, -73, -21, -46, -81, 40, -115, -1, 100, 34, -102, -50, 39,
+    -101, -58, -54, -91, 28, -32, -64, 65, 66, -32, -4, -65, -20, -19, 102, -81, -84, 82, 114,
+    -117, 7, 54, 116, 49, -81, 109, 52, 75, -116, 127, -73, 118, 21, 66, -118, 118, 39, 92,
+    -127, 91, -78, 72, -85, 4, 18, -10, 41, 121, -92, -57, -62, -114, -111, 113, -64, 88, 2, 4,
+    35, 40, -122, -99, -30, -115, 121, 77, -78, -83, -6, -112, -14, -61, -103, 68, -85, 82, 30,
+    -56, -38, 0, 91, 18, -124, 108, -71, 32, 106, 37, 118, 89, -24, 25, -75, 116, 14, -38, -98,
+    90, -83, -55, -17, -10, -119, 29, -127, -33, -92,
+};
+static const int32_t ns_model_aot_tests_tiny_const1[8] __attribute__((aligned(16))) = {
+    -86, -321, -398, -310, 621, -384, -13, -666,
+};
+static const int32_t ns_model_aot_tests_tiny_mult1[8] __attribute__((aligned(16))) = {
+    1832519293, 1832519293, 1832519293, 1832519293, 1832519293, 1832519293, 1832519293,
+    1832519293,
+};
+static const int32_t ns_model_aot_tests_tiny_shift1[8] __attribute__((aligned(16))) = {
+    -5, -5, -5, -5, -5, -5, -5, -5,
+};
+static const int8_t ns_model_aot_tests_tiny_const2[72] __attribute__((aligned(16))) = {
+    -58, -31, -97, 16, 116, 87, 0, 111, 75, -121, -39, -5, 42, 87, 22, -25, -79, -18, 122, -64,
+    117, -67, 51, -55, 37, -12, 72, 123, 125, 14, 90, -93, 12, 25, 126, 12, -59, 1, 118, -10,
+    -111, -62, 120, 112, -104, -114, -15, -28, -37, 55, -71, -71, -116, -6, -77, -72, -13, 102,
+    -13, -88, -38, -65, -123, -76, 35, -46, -88, -124, -69, 40, -47, 1,
+};
+static const int32_t ns_model_aot_tests_tiny_const3[8] __attribute__((aligned(16))) = {
+    -994, 426, 310, 506, 729, 937, -914, 910,
+};
+static const int8_t ns_model_aot_tests_tiny_const4[96] __attribute__((aligned(16))) = {
+    66, 115, 81, 65, -88, 100, -38, 110, -118, -48, 18, -38, -122, 110, -83, 35, 31, -60, 115,
+    119, 57, 38, -27, -26, 74, 75, 92, 114, 64, 34, 104, -93, 16, -78, 113, -58, -41, 67, -124,
+    -29, 120, 72, -85, 117, 42, -102, 47, -48, 60, 67, 111, 37, -100, 74, -12, 28, -51, 47, 40,
+    -76, -104, 15, 83, 14, -54, 76, -33, 12, -24, -12, -104, -100, -40, 57, 101, -58, 9, -55,
+    112, -6, -9, -112, -111, 47, -82, 92, 4, 86, 12, 33, 96, 35, -74, -67, -25, 40,
+};
+static const int32_t ns_model_aot_tests_tiny_const5[12] __attribute__((aligned(16))) = {
+    -682, -880, 843, -831, 975, -666, -60, 650, -262, 977, -851, -177,
+};
+
+// Per-op parameters
+static const cmsis_nn_per_channel_quant_params ns_model_aot_tests_tiny_quant0 = {.multiplier = (int32_t *)ns_model_aot_tests_tiny_mult0, .shift = (int32_t *)ns_model_aot_tests_tiny_shift0};
+static const cmsis_nn_conv_params ns_model_aot_tests_tiny_params0 = {.input_offset = 3, .output_offset = -128, .stride = {.w = 2, .h = 2}, .padding = {.w = 1, .h = 4}, .dilation = {.w = 1, .h = 1}, .activation = {.min = -128, .max = 127}};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_in0 = {.n = 1, .h = 49, .w = 10, .c = 1};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_filter0 = {.n = 8, .h = 10, .w = 4, .c = 1};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_bias_dims0 = {.n = 1, .h = 1, .w = 1, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_out0 = {.n = 1, .h = 25, .w = 5, .c = 8};
+static const cmsis_nn_per_channel_quant_params ns_model_aot_tests_tiny_quant1 = {.multiplier = (int32_t *)ns_model_aot_tests_tiny_mult1, .shift = (int32_t *)ns_model_aot_tests_tiny_shift1};
+static const cmsis_nn_dw_conv_params ns_model_aot_tests_tiny_params1 = {.input_offset = 128, .output_offset = -128, .ch_mult = 1, .stride = {.w = 1, .h = 1}, .padding = {.w = 1, .h = 1}, .dilation = {.w = 1, .h = 1}, .activation = {.min = -128, .max = -88}};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_in1 = {.n = 1, .h = 25, .w = 5, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_filter1 = {.n = 1, .h = 3, .w = 3, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_bias_dims1 = {.n = 1, .h = 1, .w = 1, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_out1 = {.n = 1, .h = 25, .w = 5, .c = 8};
+static const cmsis_nn_pool_params ns_model_aot_tests_tiny_params3 = {.stride = {.w = 1, .h = 2}, .padding = {.w = 0, .h = 0}, .activation = {.min = -128, .max = 127}};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_in3 = {.n = 1, .h = 25, .w = 5, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_filter3 = {.n = 1, .h = 2, .w = 1, .c = 1};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_out3 = {.n = 1, .h = 12, .w = 5, .c = 8};
+static const cmsis_nn_pool_params ns_model_aot_tests_tiny_params4 = {.stride = {.w = 5, .h = 12}, .padding = {.w = 0, .h = 0}, .activation = {.min = -128, .max = 127}};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_in4 = {.n = 1, .h = 12, .w = 5, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_filter4 = {.n = 1, .h = 12, .w = 5, .c = 1};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_out4 = {.n = 1, .h = 1, .w = 1, .c = 8};
+static const cmsis_nn_fc_params ns_model_aot_tests_tiny_params6 = {.input_offset = 100, .filter_offset = 0, .output_offset = 5, .activation = {.min = -128, .max = 127}};
+static const cmsis_nn_per_tensor_quant_params ns_model_aot_tests_tiny_quant6 = {.multiplier = 1979121024, .shift = -8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_in6 = {.n = 1, .h = 1, .w = 1, .c = 8};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_filter6 = {.n = 8, .h = 1, .w = 1, .c = 12};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_bias_dims6 = {.n = 1, .h = 1, .w = 1, .c = 12};
+static const cmsis_nn_dims ns_model_aot_tests_tiny_out6 = {.n = 1, .h = 1, .w = 1, .c = 12};
+
+static const ns_aot_tensor_t ns_model_aot_tests_tiny_aot_inputs[1] = {
+    {.offset = 1008, .bytes = 490, .scale = 0.5f, .zero_point = -3}};
+
+static const ns_aot_tensor_t ns_model_aot_tests_tiny_aot_outputs[1] = {
+    {.offset = 16, .bytes = 12, .scale = 0.00390625f, .zero_point = -128}};
+
+static int ns_model_aot_tests_tiny_aot_init(uint8_t *arena, uint32_t arena_size) {
+    if (arena_size < ns_model_aot_tests_tiny_AOT_ARENA_SIZE) {
+        return -1;
+    }
+
+    // The plan reserves a worst-case scratch size; check the kernels picked for this core fit
+    if (arm_convolve_wrapper_s8_get_buffer_size(&ns_model_aot_tests_tiny_params0, &ns_model_aot_tests_tiny_in0, &ns_model_aot_tests_tiny_filter0, &ns_model_aot_tests_tiny_out0) > ns_model_aot_tests_tiny_AOT_SCRATCH_SIZE) {
+        return -1;
+    }
+    if (arm_depthwise_conv_wrapper_s8_get_buffer_size(&ns_model_aot_tests_tiny_params1, &ns_model_aot_tests_tiny_in1, &ns_model_aot_tests_tiny_filter1, &ns_model_aot_tests_tiny_out1) > ns_model_aot_tests_tiny_AOT_SCRATCH_SIZE) {
+        return -1;
+    }
+    if (arm_avgpool_s8_get_buffer_size(1, 8) > ns_model_aot_tests_tiny_AOT_SCRATCH_SIZE) {
+        return -1;
+    }
+    if (arm_fully_connected_s8_get_buffer_size(&ns_model_aot_tests_tiny_filter6) > 48) {
+        return -1;
+    }
+
+    if (arm_fully_connected_s8_get_buffer_size(&ns_model_aot_tests_tiny_filter6) > 0) {
+        arm_vector_sum_s8((int32_t *)&arena[7488], 8, 12, ns_model_aot_tests_tiny_const4, 100, 0, ns_model_aot_tests_tiny_const5);
+    }
+    return 0;
+}
+
+static int ns_model_aot_tests_tiny_aot_invoke(uint8_t *arena) {
+    cmsis_nn_context ctx = {.buf = &arena[ns_model_aot_tests_tiny_AOT_SCRATCH_OFFSET], .size = ns_model_aot_tests_tiny_AOT_SCRATCH_SIZE};
+#if defined(NS_TF_VERSION_helios_rt_v1_2_0)
+    cmsis_nn_context weight_sum = {.buf = NULL, .size = 0};
+#endif
+
+    // 0: CONV_2D -> conv
+    if (arm_convolve_wrapper_s8(&ctx, NS_AOT_WEIGHT_SUM_ARG(&weight_sum) &ns_model_aot_tests_tiny_params0, &ns_model_aot_tests_tiny_quant0, &ns_model_aot_tests_tiny_in0, (const int8_t *)&arena[1008], &ns_model_aot_tests_tiny_filter0, ns_model_aot_tests_tiny_const0, &ns_model_aot_tests_tiny_bias_dims0, ns_model_aot_tests_tiny_const1, &ns_model_aot_tests_tiny_out0, (int8_t *)&arena[0]) != ARM_CMSIS_NN_SUCCESS) {
+        return 1;
+    }
+    // 1: DEPTHWISE_CONV_2D -> depthwise
+    if (arm_depthwise_conv_wrapper_s8(&ctx, NS_AOT_WEIGHT_SUM_ARG(&weight_sum) &ns_model_aot_tests_tiny_params1, &ns_model_aot_tests_tiny_quant1, &ns_model_aot_tests_tiny_in1, (const int8_t *)&arena[0], &ns_model_aot_tests_tiny_filter1, ns_model_aot_tests_tiny_const2, &ns_model_aot_tests_tiny_bias_dims1, ns_model_aot_tests_tiny_const3, &ns_model_aot_tests_tiny_out1, (int8_t *)&arena[1008]) != ARM_CMSIS_NN_SUCCESS) {
+        return 2;
+    }
+    // 2: ADD -> add
+    if (arm_elementwise_add_s8((const int8_t *)&arena[0], (const int8_t *)&arena[1008], 128, 1073741824, 0, 128, 1610612776, -1, 20, (int8_t *)&arena[2016], -100, 1431655730, -19, -128, 127, 1000) != ARM_CMSIS_NN_SUCCESS) {
+        return 3;
+    }
+    // 3: MAX_POOL_2D -> max_pool
+    if (arm_max_pool_s8(&ctx, &ns_model_aot_tests_tiny_params3, &ns_model_aot_tests_tiny_in3, (const int8_t *)&arena[2016], &ns_model_aot_tests_tiny_filter3, &ns_model_aot_tests_tiny_out3, (int8_t *)&arena[0]) != ARM_CMSIS_NN_SUCCESS) {
+        return 4;
+    }
+    // 4: AVERAGE_POOL_2D -> avg_pool
+    if (arm_avgpool_s8(&ctx, &ns_model_aot_tests_tiny_params4, &ns_model_aot_tests_tiny_in4, (const int8_t *)&arena[0], &ns_model_aot_tests_tiny_filter4, &ns_model_aot_tests_tiny_out4, (int8_t *)&arena[480]) != ARM_CMSIS_NN_SUCCESS) {
+        return 5;
+    }
+    // 6: FULLY_CONNECTED -> logits
+    if (arm_fully_connected_s8(&(cmsis_nn_context){.buf = &arena[7488], .size = 48}, &ns_model_aot_tests_tiny_params6, &ns_model_aot_tests_tiny_quant6, &ns_model_aot_tests_tiny_in6, (const int8_t *)&arena[480], &ns_model_aot_tests_tiny_filter6, ns_model_aot_tests_tiny_const4, &ns_model_aot_tests_tiny_bias_dims6, ns_model_aot_tests_tiny_const5, &ns_model_aot_tests_tiny_out6, (int8_t *)&arena[0]) != ARM_CMSIS_NN_SUCCESS) {
+        return 7;
+    }
+    // 7: SOFTMAX -> output
+    arm_softmax_s8((const int8_t *)&arena[0], 1, 12, 1073741824, 25, -62, (int8_t *)&arena[16]);
+    return 0;
+}
+
+const ns_aot_model_t ns_model_aot_tests_tiny_aot_model = {
+    .name = "ns_model_aot_tests_tiny",
+    .arena_size = ns_model_aot_tests_tiny_AOT_ARENA_SIZE,
+    .num_inputs = 1,
+    .num_outputs = 1,
+    .inputs = ns_model_aot_tests_tiny_aot_inputs,
+    .outputs = ns_model_aot_tests_tiny_aot_outputs,
+    .init = ns_model_aot_tests_tiny_aot_init,
+    .invoke = ns_model_aot_tests_tiny_aot_invoke,
+};
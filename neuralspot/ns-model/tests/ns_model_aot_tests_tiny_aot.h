@@ -0,0 +1,21 @@
+/**
+ * @file ns_model_aot_tests_tiny_aot.h
+ * @brief Generated by aot_compiler.py
+ */
+
+#ifndef NS_MODEL_AOT_TESTS_TINY_AOT_H
+#define NS_MODEL_AOT_TESTS_TINY_AOT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ns_aot_model.h"
+
+#define ns_model_aot_tests_tiny_AOT_ARENA_SIZE 7536
+
+extern const ns_aot_model_t ns_model_aot_tests_tiny_aot_model;
+
+#ifdef __cplusplus
+}
+#endif
+#endif // NS_MODEL_AOT_TESTS_TINY_AOT_H
@@ -0,0 +1,227 @@
+// ns_model_aot_tests_tiny.tflite as a C array, for the TFLM side of ns_model_aot_tests.
+// Regenerate both with tools/autodeploy/tests/test_aot_compiler.py --regenerate.
+#ifndef NS_MODEL_AOT_TESTS_TINY_MODEL_H
+#define NS_MODEL_AOT_TESTS_TINY_MODEL_H
+
+alignas(16) const unsigned char ns_model_aot_tests_tiny_model[] = {
+    0x0c, 0x00, 0x00, 0x00, 0x54, 0x46, 0x4c, 0x33, 0x00, 0x00, 0x00, 0x00, 0xde, 0xfc, 0xff, 0xff,
+    0x14, 0x00, 0x00, 0x00, 0xec, 0x02, 0x00, 0x00, 0x0c, 0x03, 0x00, 0x00, 0xb0, 0x0c, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xd4, 0x02, 0x00, 0x00, 0x84, 0x01, 0x00, 0x00,
+    0x54, 0x01, 0x00, 0x00, 0xfc, 0x00, 0x00, 0x00, 0xcc, 0x00, 0x00, 0x00, 0xb4, 0x00, 0x00, 0x00,
+    0x44, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x46, 0xfc, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00,
+    0x30, 0x00, 0x00, 0x00, 0x56, 0xfd, 0xff, 0xff, 0x90, 0xfc, 0xff, 0xff, 0x4b, 0x03, 0x00, 0x00,
+    0xc1, 0xfc, 0xff, 0xff, 0xcf, 0x03, 0x00, 0x00, 0x66, 0xfd, 0xff, 0xff, 0xc4, 0xff, 0xff, 0xff,
+    0x8a, 0x02, 0x00, 0x00, 0xfa, 0xfe, 0xff, 0xff, 0xd1, 0x03, 0x00, 0x00, 0xad, 0xfc, 0xff, 0xff,
+    0x4f, 0xff, 0xff, 0xff, 0x82, 0xfc, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00,
+    0x42, 0x73, 0x51, 0x41, 0xa8, 0x64, 0xda, 0x6e, 0x8a, 0xd0, 0x12, 0xda, 0x86, 0x6e, 0xad, 0x23,
+    0x1f, 0xc4, 0x73, 0x77, 0x39, 0x26, 0xe5, 0xe6, 0x4a, 0x4b, 0x5c, 0x72, 0x40, 0x22, 0x68, 0xa3,
+    0x10, 0xb2, 0x71, 0xc6, 0xd7, 0x43, 0x84, 0xe3, 0x78, 0x48, 0xab, 0x75, 0x2a, 0x9a, 0x2f, 0xd0,
+    0x3c, 0x43, 0x6f, 0x25, 0x9c, 0x4a, 0xf4, 0x1c, 0xcd, 0x2f, 0x28, 0xb4, 0x98, 0x0f, 0x53, 0x0e,
+    0xca, 0x4c, 0xdf, 0x0c, 0xe8, 0xf4, 0x98, 0x9c, 0xd8, 0x39, 0x65, 0xc6, 0x09, 0xc9, 0x70, 0xfa,
+    0xf7, 0x90, 0x91, 0x2f, 0xae, 0x5c, 0x04, 0x56, 0x0c, 0x21, 0x60, 0x23, 0xb6, 0xbd, 0xe7, 0x28,
+    0xee, 0xfc, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x02, 0xfd, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+    0x1e, 0xfc, 0xff, 0xff, 0xaa, 0x01, 0x00, 0x00, 0x36, 0x01, 0x00, 0x00, 0xfa, 0x01, 0x00, 0x00,
+    0xd9, 0x02, 0x00, 0x00, 0xa9, 0x03, 0x00, 0x00, 0x6e, 0xfc, 0xff, 0xff, 0x8e, 0x03, 0x00, 0x00,
+    0x2e, 0xfd, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00, 0xc6, 0xe1, 0x9f, 0x10,
+    0x74, 0x57, 0x00, 0x6f, 0x4b, 0x87, 0xd9, 0xfb, 0x2a, 0x57, 0x16, 0xe7, 0xb1, 0xee, 0x7a, 0xc0,
+    0x75, 0xbd, 0x33, 0xc9, 0x25, 0xf4, 0x48, 0x7b, 0x7d, 0x0e, 0x5a, 0xa3, 0x0c, 0x19, 0x7e, 0x0c,
+    0xc5, 0x01, 0x76, 0xf6, 0x91, 0xc2, 0x78, 0x70, 0x98, 0x8e, 0xf1, 0xe4, 0xdb, 0x37, 0xb9, 0xb9,
+    0x8c, 0xfa, 0xb3, 0xb8, 0xf3, 0x66, 0xf3, 0xa8, 0xda, 0xbf, 0x85, 0xb4, 0x23, 0xd2, 0xa8, 0x84,
+    0xbb, 0x28, 0xd1, 0x01, 0x82, 0xfd, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+    0xaa, 0xff, 0xff, 0xff, 0xbf, 0xfe, 0xff, 0xff, 0x72, 0xfe, 0xff, 0xff, 0xca, 0xfe, 0xff, 0xff,
+    0x6d, 0x02, 0x00, 0x00, 0x80, 0xfe, 0xff, 0xff, 0xf3, 0xff, 0xff, 0xff, 0x66, 0xfd, 0xff, 0xff,
+    0xae, 0xfd, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x40, 0x01, 0x00, 0x00, 0x5b, 0x17, 0x0d, 0xf2,
+    0xe6, 0x49, 0x14, 0x7e, 0x87, 0x60, 0x99, 0x7e, 0x6f, 0xe3, 0x4b, 0xe1, 0xa5, 0xd7, 0x9e, 0x74,
+    0x5f, 0x78, 0x3f, 0x53, 0x0c, 0xb1, 0x33, 0x23, 0x1d, 0xdc, 0xd6, 0x56, 0x79, 0x43, 0xa9, 0x44,
+    0x09, 0x1e, 0x4e, 0x79, 0xd4, 0xd2, 0x5f, 0xe2, 0x7d, 0x84, 0x45, 0x93, 0xed, 0x6f, 0xed, 0xf4,
+    0x41, 0x52, 0xc4, 0xd1, 0x99, 0xc2, 0x35, 0xfc, 0x2f, 0x7b, 0xe7, 0x6b, 0x1b, 0x7c, 0xaf, 0x77,
+    0x2d, 0x49, 0x85, 0x2d, 0xb6, 0x56, 0x38, 0x22, 0x2e, 0x52, 0xab, 0xc9, 0x18, 0x9d, 0x59, 0x83,
+    0xf8, 0x97, 0x39, 0xe3, 0x9c, 0xe6, 0xce, 0xf4, 0xc6, 0x2b, 0x6f, 0xba, 0x02, 0x02, 0xfa, 0x4b,
+    0xc9, 0x77, 0x3d, 0xaa, 0x6d, 0xc8, 0x51, 0xfa, 0x9c, 0x1c, 0xc7, 0xa7, 0x46, 0x47, 0x7f, 0xd8,
+    0x5e, 0x92, 0xde, 0x79, 0xb4, 0xa1, 0xb0, 0x2b, 0xb9, 0xf0, 0x04, 0xec, 0xe3, 0x47, 0xc5, 0xb8,
+    0x42, 0xb2, 0xaa, 0x90, 0x7b, 0x0e, 0x26, 0x61, 0x21, 0x1c, 0x58, 0xfd, 0x4e, 0x69, 0x51, 0x1f,
+    0x90, 0x5f, 0x50, 0xc9, 0x27, 0x3e, 0xde, 0x8e, 0x64, 0xfc, 0xac, 0xb6, 0x69, 0xf5, 0xb3, 0xa3,
+    0x5c, 0xc9, 0x9a, 0xb5, 0x90, 0x63, 0x2b, 0xa4, 0xfc, 0x30, 0xba, 0x14, 0x3a, 0xdd, 0x9a, 0x9d,
+    0xf7, 0x76, 0xc1, 0x17, 0x2b, 0xc4, 0x9f, 0x12, 0x49, 0xb1, 0xd8, 0x63, 0x44, 0x10, 0xdb, 0xfb,
+    0xb8, 0x83, 0x9e, 0x9c, 0xaa, 0xb7, 0xeb, 0xd2, 0xaf, 0x28, 0x8d, 0xff, 0x64, 0x22, 0x9a, 0xce,
+    0x27, 0x9b, 0xc6, 0xca, 0xa5, 0x1c, 0xe0, 0xc0, 0x41, 0x42, 0xe0, 0xfc, 0xbf, 0xec, 0xed, 0x66,
+    0xaf, 0xac, 0x52, 0x72, 0x8b, 0x07, 0x36, 0x74, 0x31, 0xaf, 0x6d, 0x34, 0x4b, 0x8c, 0x7f, 0xb7,
+    0x76, 0x15, 0x42, 0x8a, 0x76, 0x27, 0x5c, 0x81, 0x5b, 0xb2, 0x48, 0xab, 0x04, 0x12, 0xf6, 0x29,
+    0x79, 0xa4, 0xc7, 0xc2, 0x8e, 0x91, 0x71, 0xc0, 0x58, 0x02, 0x04, 0x23, 0x28, 0x86, 0x9d, 0xe2,
+    0x8d, 0x79, 0x4d, 0xb2, 0xad, 0xfa, 0x90, 0xf2, 0xc3, 0x99, 0x44, 0xab, 0x52, 0x1e, 0xc8, 0xda,
+    0x00, 0x5b, 0x12, 0x84, 0x6c, 0xb9, 0x20, 0x6a, 0x25, 0x76, 0x59, 0xe8, 0x19, 0xb5, 0x74, 0x0e,
+    0xda, 0x9e, 0x5a, 0xad, 0xc9, 0xef, 0xf6, 0x89, 0x1d, 0x81, 0xdf, 0xa4, 0x14, 0xfe, 0xff, 0xff,
+    0x1d, 0x00, 0x00, 0x00, 0x6e, 0x73, 0x2d, 0x6d, 0x6f, 0x64, 0x65, 0x6c, 0x20, 0x41, 0x4f, 0x54,
+    0x20, 0x72, 0x65, 0x67, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x6d, 0x6f, 0x64, 0x65,
+    0x6c, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00,
+    0x18, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x78, 0x02, 0x00, 0x00, 0x7c, 0x02, 0x00, 0x00,
+    0x80, 0x02, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x6d, 0x61, 0x69, 0x6e, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x14, 0x02, 0x00, 0x00, 0xac, 0x01, 0x00, 0x00, 0x64, 0x01, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0xbc, 0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0xc2, 0xfe, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,
+    0x14, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x9a, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x80, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x0e, 0x00, 0x00, 0x00, 0xf2, 0xfe, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+    0x10, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0xe4, 0xfe, 0xff, 0xff,
+    0x01, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0xe2, 0xfe, 0xff, 0xff, 0x1c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x11, 0x28, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x04, 0x00, 0x06, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x0b, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+    0x6e, 0xff, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x24, 0x00, 0x00, 0x00,
+    0x28, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xbe, 0xff, 0xff, 0xff, 0x0c, 0x00, 0x00, 0x00,
+    0x05, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x6a, 0xff, 0xff, 0xff, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x34, 0x00, 0x00, 0x00,
+    0x38, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x18, 0x00, 0x17, 0x00,
+    0x10, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0e, 0x00, 0x18, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x0b, 0x00, 0x04, 0x00,
+    0x0e, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x14, 0x00, 0x00, 0x00,
+    0x18, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x1a, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0c, 0x00,
+    0x0b, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    0x30, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x07, 0x00, 0x0e, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x0c, 0x00, 0x0b, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x24, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x10, 0x00,
+    0x00, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x07, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x94, 0x06, 0x00, 0x00, 0xd0, 0x05, 0x00, 0x00, 0x1c, 0x05, 0x00, 0x00,
+    0xc4, 0x04, 0x00, 0x00, 0xfc, 0x03, 0x00, 0x00, 0x48, 0x03, 0x00, 0x00, 0xe8, 0x02, 0x00, 0x00,
+    0x94, 0x02, 0x00, 0x00, 0x38, 0x02, 0x00, 0x00, 0xdc, 0x01, 0x00, 0x00, 0xb0, 0x01, 0x00, 0x00,
+    0x54, 0x01, 0x00, 0x00, 0xfc, 0x00, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0xba, 0xf9, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x34, 0x00, 0x00, 0x00, 0xac, 0xf9, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3b, 0x06, 0x00, 0x00, 0x00,
+    0x6f, 0x75, 0x74, 0x70, 0x75, 0x74, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x0a, 0xfa, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x30, 0x00, 0x00, 0x00, 0xfc, 0xf9, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3e, 0x06, 0x00, 0x00, 0x00, 0x6c, 0x6f, 0x67, 0x69,
+    0x74, 0x73, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x16, 0xfb, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x02, 0x34, 0x00, 0x00, 0x00, 0x4c, 0xfa, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xfa, 0xed, 0x6b, 0x3a, 0x04, 0x00, 0x00, 0x00,
+    0x66, 0x63, 0x5f, 0x62, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x66, 0xfb, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x34, 0x00, 0x00, 0x00, 0x9c, 0xfa, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xa6, 0x9b, 0x44, 0x3b, 0x04, 0x00, 0x00, 0x00,
+    0x66, 0x63, 0x5f, 0x77, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0xfa, 0xfa, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x30, 0x00, 0x00, 0x00, 0xec, 0xfa, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x9c, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x01, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x99, 0x3e, 0x07, 0x00, 0x00, 0x00, 0x66, 0x6c, 0x61, 0x74,
+    0x74, 0x65, 0x6e, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x0c, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0f, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x10, 0x00, 0x00, 0x00,
+    0x05, 0x00, 0x00, 0x00, 0x73, 0x68, 0x61, 0x70, 0x65, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x7a, 0xfb, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x34, 0x00, 0x00, 0x00, 0x6c, 0xfb, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x9c, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x01, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x99, 0x3e, 0x08, 0x00, 0x00, 0x00, 0x61, 0x76, 0x67, 0x5f,
+    0x70, 0x6f, 0x6f, 0x6c, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xd2, 0xfb, 0xff, 0xff,
+    0x10, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x34, 0x00, 0x00, 0x00,
+    0xc4, 0xfb, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x9c, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x99, 0x3e,
+    0x08, 0x00, 0x00, 0x00, 0x6d, 0x61, 0x78, 0x5f, 0x70, 0x6f, 0x6f, 0x6c, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x2a, 0xfc, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x2c, 0x00, 0x00, 0x00, 0x1c, 0xfc, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x9c, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x01, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x99, 0x3e, 0x03, 0x00, 0x00, 0x00, 0x61, 0x64, 0x64, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x7a, 0xfc, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x38, 0x00, 0x00, 0x00, 0x6c, 0xfc, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x9a, 0x99, 0x19, 0x3e, 0x09, 0x00, 0x00, 0x00,
+    0x64, 0x65, 0x70, 0x74, 0x68, 0x77, 0x69, 0x73, 0x65, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x96, 0xfd, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x02, 0x84, 0x00, 0x00, 0x00, 0xcc, 0xfc, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x48, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x6f, 0x12, 0x83, 0x3b,
+    0x6f, 0x12, 0x83, 0x3b, 0x6f, 0x12, 0x83, 0x3b, 0x6f, 0x12, 0x83, 0x3b, 0x6f, 0x12, 0x83, 0x3b,
+    0x6f, 0x12, 0x83, 0x3b, 0x6f, 0x12, 0x83, 0x3b, 0x6f, 0x12, 0x83, 0x3b, 0x04, 0x00, 0x00, 0x00,
+    0x64, 0x77, 0x5f, 0x62, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0e, 0x00, 0x1a, 0x00, 0x14, 0x00, 0x13, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00,
+    0x0e, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x9c, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x9c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x12, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x0a, 0xd7, 0xa3, 0x3c, 0x0a, 0xd7, 0xa3, 0x3c, 0x0a, 0xd7, 0xa3, 0x3c,
+    0x0a, 0xd7, 0xa3, 0x3c, 0x0a, 0xd7, 0xa3, 0x3c, 0x0a, 0xd7, 0xa3, 0x3c, 0x0a, 0xd7, 0xa3, 0x3c,
+    0x0a, 0xd7, 0xa3, 0x3c, 0x04, 0x00, 0x00, 0x00, 0x64, 0x77, 0x5f, 0x77, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x4a, 0xfe, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x09, 0x30, 0x00, 0x00, 0x00, 0x3c, 0xfe, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x01, 0x00, 0x00, 0x00, 0xcd, 0xcc, 0x4c, 0x3e, 0x04, 0x00, 0x00, 0x00, 0x63, 0x6f, 0x6e, 0x76,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00,
+    0x05, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x5e, 0xff, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00,
+    0x84, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x84, 0x00, 0x00, 0x00,
+    0x94, 0xfe, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x0a, 0xd7, 0xa3, 0x3b, 0x58, 0x39, 0xb4, 0x3b, 0xa6, 0x9b, 0xc4, 0x3b,
+    0xf4, 0xfd, 0xd4, 0x3b, 0x42, 0x60, 0xe5, 0x3b, 0x8f, 0xc2, 0xf5, 0x3b, 0x6f, 0x12, 0x03, 0x3c,
+    0x96, 0x43, 0x0b, 0x3c, 0x06, 0x00, 0x00, 0x00, 0x63, 0x6f, 0x6e, 0x76, 0x5f, 0x62, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x18, 0x00, 0x14, 0x00,
+    0x13, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+    0x88, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x88, 0x00, 0x00, 0x00,
+    0x44, 0xff, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00, 0x4c, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x0a, 0xd7, 0x23, 0x3c, 0x58, 0x39, 0x34, 0x3c,
+    0xa6, 0x9b, 0x44, 0x3c, 0xf4, 0xfd, 0x54, 0x3c, 0x42, 0x60, 0x65, 0x3c, 0x8f, 0xc2, 0x75, 0x3c,
+    0x6f, 0x12, 0x83, 0x3c, 0x96, 0x43, 0x8b, 0x3c, 0x06, 0x00, 0x00, 0x00, 0x63, 0x6f, 0x6e, 0x76,
+    0x5f, 0x77, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x14, 0x00, 0x10, 0x00,
+    0x0f, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
+    0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x40, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x0c, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xfd, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x05, 0x00, 0x00, 0x00,
+    0x69, 0x6e, 0x70, 0x75, 0x74, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x31, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0xb0, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x84, 0x00, 0x00, 0x00, 0x68, 0x00, 0x00, 0x00,
+    0x48, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x7c, 0xff, 0xff, 0xff, 0x19, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19,
+    0x8c, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,
+    0x0c, 0x00, 0x0c, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00,
+    0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0xb4, 0xff, 0xff, 0xff, 0x01, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x0e, 0x00, 0x0d, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x11, 0x0a, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x0a, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x00, 0xf0, 0xff, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x0c, 0x00, 0x10, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04, 0x00,
+    0x0c, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+};
+const unsigned int ns_model_aot_tests_tiny_model_len = 3472;
+
+#endif // NS_MODEL_AOT_TESTS_TINY_MODEL_H
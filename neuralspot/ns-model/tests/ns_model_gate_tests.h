@@ -0,0 +1,11 @@
+#include "ns_model_gate.h"
+void ns_model_gate_tests_pre_test_hook();
+void ns_model_gate_tests_post_test_hook();
+void ns_model_gate_test_config();
+void ns_model_gate_test_hysteresis();
+void ns_model_gate_test_refresh();
+void ns_model_gate_test_noise_floor();
+void ns_model_gate_test_step_cache();
+void ns_model_gate_test_metrics();
+void ns_model_gate_test_audio_replay();
+void ns_model_gate_test_imu_replay();
@@ -0,0 +1,766 @@
+#include "ns_model_graph_tests.h"
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "unity/unity.h"
+#include <math.h>
+#include <string.h>
+
+// Toy models stand in for TFLM ones. Init "plans" the arena: it wipes it, stamps it with the
+// model's tag and places the output in it (at an offset that changes on every init, like a
+// re-planned arena can). Run fails if the tag isn't its own, i.e. if another model used the
+// arena without the graph re-initializing this one. Release notes whether the arena still
+// held its tag, as a TFLM interpreter's destructor needs.
+
+typedef struct gr_model gr_model_t;
+struct gr_model {
+    uint8_t *arena;
+    uint32_t arenaBytes;
+    uint8_t tag;
+    uint32_t outBytes;
+    ns_tensor_type_e type;
+    uint32_t count;
+    float scale;
+    int32_t zeroPoint;
+    uint32_t macs; ///< Busy work per run, for the latencies
+    int (*compute)(ns_model_graph_node_t *n, void *out);
+    uint32_t inits;
+    uint32_t runs;
+    uint32_t releases;
+    uint32_t intactReleases;
+    int failInit;
+    int failRun;
+};
+
+static volatile int32_t gr_sink;
+
+static int gr_model_init(ns_model_graph_node_t *n) {
+    gr_model_t *m = (gr_model_t *)n->ctx;
+    uint8_t *out;
+
+    if (m->failInit) {
+        return NS_STATUS_FAILURE;
+    }
+    memset(m->arena, 0, m->arenaBytes);
+    m->arena[0] = m->tag;
+    out = m->arena + 16 + (m->inits % 2) * 16;
+    n->out[0].data = out;
+    n->out[0].bytes = m->outBytes;
+    n->scores.data = out;
+    n->scores.type = m->type;
+    n->scores.count = m->count;
+    n->scores.scale = m->scale;
+    n->scores.zeroPoint = m->zeroPoint;
+    m->inits++;
+    return NS_STATUS_SUCCESS;
+}
+
+static int gr_model_run(ns_model_graph_node_t *n) {
+    gr_model_t *m = (gr_model_t *)n->ctx;
+    int32_t acc = 0;
+
+    if (m->failRun || (m->arena[0] != m->tag)) {
+        return NS_STATUS_FAILURE;
+    }
+    for (uint32_t i = 0; i < m->macs; i++) {
+        acc += (int8_t)m->arena[i % m->arenaBytes] * (int8_t)i;
+    }
+    gr_sink = acc;
+    m->runs++;
+    return (m->compute != NULL) ? m->compute(n, n->out[0].data) : NS_STATUS_SUCCESS;
+}
+
+static int gr_model_release(ns_model_graph_node_t *n) {
+    gr_model_t *m = (gr_model_t *)n->ctx;
+
+    m->releases++;
+    m->intactReleases += m->arena[0] == m->tag;
+    return NS_STATUS_SUCCESS;
+}
+
+static void gr_model_node(ns_model_graph_node_t *n, const char *name, int8_t parent,
+                          gr_model_t *m) {
+    memset(n, 0, sizeof(*n));
+    n->name = name;
+    n->parent = parent;
+    n->init = gr_model_init;
+    n->run = gr_model_run;
+    n->release = gr_model_release;
+    n->ctx = m;
+}
+
+// A source that replays a script of float scores, one row per graph run
+
+#define GR_SCORES 3
+
+typedef struct {
+    const float (*rows)[GR_SCORES];
+    uint32_t numRows;
+    uint32_t next;
+    float scores[GR_SCORES];
+} gr_script_t;
+
+static int gr_script_run(ns_model_graph_node_t *n) {
+    gr_script_t *s = (gr_script_t *)n->ctx;
+    memcpy(s->scores, s->rows[s->next % s->numRows], sizeof(s->scores));
+    s->next++;
+    return NS_STATUS_SUCCESS;
+}
+
+static void gr_script_node(ns_model_graph_node_t *n, gr_script_t *s,
+                           const float (*rows)[GR_SCORES], uint32_t numRows) {
+    memset(n, 0, sizeof(*n));
+    memset(s, 0, sizeof(*s));
+    s->rows = rows;
+    s->numRows = numRows;
+    n->name = "script";
+    n->parent = -1;
+    n->run = gr_script_run;
+    n->ctx = s;
+    n->scores.data = s->scores;
+    n->scores.type = NS_TENSOR_FLOAT32;
+    n->scores.count = GR_SCORES;
+    n->scores.scale = 1.0f;
+}
+
+static void gr_when(ns_model_graph_node_t *n, ns_model_graph_cond_e type, uint32_t index,
+                    float threshold) {
+    n->when.type = type;
+    n->when.index = index;
+    n->when.threshold = threshold;
+}
+
+static void gr_shared(ns_model_graph_node_t *n, void *keep, uint32_t bytes) {
+    n->arenaGroup = 1;
+    n->outCopy = keep;
+    n->outCopyBytes = bytes;
+}
+
+static uint8_t gr_arena_a[256] __attribute__((aligned(16)));
+static uint8_t gr_arena_b[256] __attribute__((aligned(16)));
+static uint8_t gr_arena_shared[256] __attribute__((aligned(16)));
+
+static gr_model_t gr_toy(uint8_t *arena, uint8_t tag) {
+    gr_model_t m;
+    memset(&m, 0, sizeof(m));
+    m.arena = arena;
+    m.arenaBytes = 256;
+    m.tag = tag;
+    m.outBytes = sizeof(float);
+    m.type = NS_TENSOR_FLOAT32;
+    m.count = 1;
+    m.scale = 1.0f;
+    return m;
+}
+
+void ns_model_graph_tests_pre_test_hook() {}
+
+void ns_model_graph_tests_post_test_hook() {}
+
+void ns_model_graph_test_config() {
+    static const float rows[1][GR_SCORES] = {{0}};
+    ns_model_graph_node_t nodes[3];
+    ns_model_graph_edge_t edges[1] = {{0, 0, 2, 0}};
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 3, .edges = edges, .numEdges = 1};
+    gr_model_t a = gr_toy(gr_arena_a, 1), b = gr_toy(gr_arena_b, 2);
+    gr_script_t s;
+    uint32_t keep[4];
+
+    gr_script_node(&nodes[0], &s, rows, 1);
+    gr_model_node(&nodes[1], "a", 0, &a);
+    gr_model_node(&nodes[2], "b", 1, &b);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_model_graph_init(NULL));
+    g.numNodes = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    g.numNodes = NS_MODEL_GRAPH_MAX_NODES + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    g.numNodes = 3;
+
+    // Children after parents
+    nodes[1].parent = 2;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    nodes[1].parent = 0;
+    nodes[2].run = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    nodes[2].run = gr_model_run;
+    nodes[2].when.type = NS_MODEL_GRAPH_CUSTOM;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    nodes[2].when.type = NS_MODEL_GRAPH_ALWAYS;
+
+    // An arena can't be shared with an ancestor, nor without somewhere to keep the outputs
+    nodes[2].arenaGroup = NS_MODEL_GRAPH_MAX_ARENAS + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    nodes[2].arenaGroup = 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    nodes[0].outCopy = nodes[2].outCopy = keep;
+    nodes[0].outCopyBytes = nodes[2].outCopyBytes = sizeof(keep);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+    nodes[0].arenaGroup = 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    nodes[0].arenaGroup = nodes[2].arenaGroup = 0;
+
+    // Edges must come from an ancestor, between valid ports
+    edges[0].to = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    edges[0].to = 2;
+    edges[0].toPort = NS_MODEL_GRAPH_MAX_PORTS;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    edges[0].toPort = 0;
+    nodes[2].parent = 0;
+    edges[0].from = 1; // a and b are now siblings
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_graph_init(&g));
+    edges[0].from = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+}
+
+void ns_model_graph_test_wake_and_hold() {
+    static const float rows[][GR_SCORES] = {{0.9f}, {0.1f}, {0.9f}, {0.9f}, {0.2f},
+                                            {0.2f}, {0.2f}, {0.9f}, {0.0f}};
+    const bool expected[] = {0, 0, 0, 1, 1, 1, 0, 0, 0};
+    ns_model_graph_node_t nodes[3];
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 3};
+    gr_model_t a = gr_toy(gr_arena_a, 1), b = gr_toy(gr_arena_b, 2);
+    gr_script_t s;
+
+    gr_script_node(&nodes[0], &s, rows, 9);
+    gr_model_node(&nodes[1], "a", 0, &a);
+    gr_when(&nodes[1], NS_MODEL_GRAPH_SCORE_ABOVE, 0, 0.5f);
+    nodes[1].when.consecutive = 2;
+    nodes[1].when.holdRuns = 2;
+    gr_model_node(&nodes[2], "b", 1, &b);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    // Two consecutive hits to wake, two misses held, then asleep; b follows a
+    for (uint32_t r = 0; r < 9; r++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_run(&g));
+        TEST_ASSERT_TRUE(nodes[0].ran);
+        TEST_ASSERT_EQUAL_MESSAGE(expected[r], nodes[1].ran, "a");
+        TEST_ASSERT_EQUAL_MESSAGE(expected[r], nodes[2].ran, "b");
+    }
+    TEST_ASSERT_EQUAL(9, g.runs);
+    TEST_ASSERT_EQUAL(9, nodes[0].stats.runs);
+    TEST_ASSERT_EQUAL(3, nodes[1].stats.runs);
+    TEST_ASSERT_EQUAL(1, nodes[1].stats.wakes);
+    TEST_ASSERT_EQUAL(1, nodes[2].stats.wakes);
+    TEST_ASSERT_EQUAL(3, b.runs);
+
+    // Reset puts everything downstream to sleep and restarts the debounce
+    s.next = 2;
+    ns_model_graph_run(&g);
+    ns_model_graph_reset(&g);
+    TEST_ASSERT_FALSE(nodes[1].awake);
+    ns_model_graph_run(&g);
+    TEST_ASSERT_FALSE(nodes[1].ran);
+    TEST_ASSERT_TRUE(nodes[0].awake);
+}
+
+static bool gr_sum_above_one(const ns_model_graph_node_t *parent, void *arg) {
+    float sum = 0;
+    for (uint32_t i = 0; i < parent->scores.count; i++) {
+        sum += ns_model_graph_score(parent, i);
+    }
+    (*(uint32_t *)arg)++;
+    return sum > 1.0f;
+}
+
+void ns_model_graph_test_conditions() {
+    static const float rows[][GR_SCORES] = {
+        {0.1f, 0.5f, 0.4f}, {0.5f, 0.5f, 0.2f}, {0.0f, 0.35f, 0.2f}};
+    const bool below[] = {1, 0, 1}, argmax[] = {1, 0, 0}, custom[] = {0, 1, 0};
+    ns_model_graph_node_t nodes[4];
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 4};
+    gr_model_t a = gr_toy(gr_arena_a, 1), b = gr_toy(gr_arena_b, 2);
+    gr_model_t c = gr_toy(gr_arena_shared, 3);
+    gr_script_t s;
+    uint32_t tests = 0;
+    int8_t q[2] = {10, -10};
+
+    gr_script_node(&nodes[0], &s, rows, 3);
+    gr_model_node(&nodes[1], "below", 0, &a);
+    gr_when(&nodes[1], NS_MODEL_GRAPH_SCORE_BELOW, 0, 0.3f);
+    gr_model_node(&nodes[2], "argmax", 0, &b);
+    gr_when(&nodes[2], NS_MODEL_GRAPH_ARGMAX, 1, 0.4f);
+    gr_model_node(&nodes[3], "custom", 0, &c);
+    gr_when(&nodes[3], NS_MODEL_GRAPH_CUSTOM, 0, 0);
+    nodes[3].when.test = gr_sum_above_one;
+    nodes[3].when.arg = &tests;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    // Ties go to the lower index; argmax also needs the threshold
+    for (uint32_t r = 0; r < 3; r++) {
+        ns_model_graph_run(&g);
+        TEST_ASSERT_EQUAL_MESSAGE(below[r], nodes[1].ran, "below");
+        TEST_ASSERT_EQUAL_MESSAGE(argmax[r], nodes[2].ran, "argmax");
+        TEST_ASSERT_EQUAL_MESSAGE(custom[r], nodes[3].ran, "custom");
+    }
+    TEST_ASSERT_EQUAL(3, tests);
+
+    // Quantized scores
+    nodes[0].scores.data = q;
+    nodes[0].scores.type = NS_TENSOR_INT8;
+    nodes[0].scores.count = 2;
+    nodes[0].scores.scale = 0.5f;
+    nodes[0].scores.zeroPoint = -10;
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, ns_model_graph_score(&nodes[0], 0));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ns_model_graph_score(&nodes[0], 1));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ns_model_graph_score(&nodes[0], 2));
+}
+
+void ns_model_graph_test_lazy_init() {
+    static const float rows[][GR_SCORES] = {{0.0f}, {0.0f}, {1.0f}, {1.0f}, {0.0f}, {1.0f}};
+    ns_model_graph_node_t nodes[3];
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 3};
+    gr_model_t lazy = gr_toy(gr_arena_a, 1), eager = gr_toy(gr_arena_b, 2);
+    gr_script_t s;
+
+    gr_script_node(&nodes[0], &s, rows, 6);
+    gr_model_node(&nodes[1], "lazy", 0, &lazy);
+    gr_when(&nodes[1], NS_MODEL_GRAPH_SCORE_ABOVE, 0, 0.5f);
+    gr_model_node(&nodes[2], "eager", 0, &eager);
+    gr_when(&nodes[2], NS_MODEL_GRAPH_SCORE_ABOVE, 0, 0.5f);
+    nodes[2].eager = true;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+    TEST_ASSERT_EQUAL(0, lazy.inits);
+    TEST_ASSERT_EQUAL(1, eager.inits);
+
+    ns_model_graph_run(&g);
+    ns_model_graph_run(&g);
+    TEST_ASSERT_EQUAL(0, lazy.inits);
+    for (int r = 0; r < 4; r++) {
+        ns_model_graph_run(&g);
+    }
+    TEST_ASSERT_EQUAL(1, lazy.inits);
+    TEST_ASSERT_EQUAL(1, nodes[1].stats.inits);
+    TEST_ASSERT_EQUAL(3, lazy.runs);
+    TEST_ASSERT_EQUAL(2, nodes[1].stats.wakes);
+    TEST_ASSERT_EQUAL(1, eager.inits);
+    TEST_ASSERT_EQUAL(3, eager.runs);
+}
+
+void ns_model_graph_test_shared_arena() {
+    static const float rows[][GR_SCORES] = {{1, 0}, {1, 0}, {0, 1}, {0, 1}, {1, 1}, {1, 0}};
+    ns_model_graph_node_t nodes[3];
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 3};
+    gr_model_t a = gr_toy(gr_arena_shared, 1), b = gr_toy(gr_arena_shared, 2);
+    gr_script_t s;
+    uint32_t keepA[1], keepB[1];
+
+    gr_script_node(&nodes[0], &s, rows, 6);
+    gr_model_node(&nodes[1], "a", 0, &a);
+    gr_when(&nodes[1], NS_MODEL_GRAPH_SCORE_ABOVE, 0, 0.5f);
+    gr_shared(&nodes[1], keepA, sizeof(keepA));
+    gr_model_node(&nodes[2], "b", 0, &b);
+    gr_when(&nodes[2], NS_MODEL_GRAPH_SCORE_ABOVE, 1, 0.5f);
+    gr_shared(&nodes[2], keepB, sizeof(keepB));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    // Each takeover releases the previous owner before re-initializing, including both in
+    // one pass; a run on a clobbered arena would fail
+    for (int r = 0; r < 6; r++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_run(&g));
+    }
+    TEST_ASSERT_EQUAL(2, a.releases);
+    TEST_ASSERT_EQUAL(2, b.releases);
+    TEST_ASSERT_EQUAL(2, a.intactReleases);
+    TEST_ASSERT_EQUAL(2, b.intactReleases);
+    TEST_ASSERT_EQUAL(3, a.inits);
+    TEST_ASSERT_EQUAL(2, b.inits);
+    TEST_ASSERT_EQUAL(4, a.runs);
+    TEST_ASSERT_EQUAL(3, b.runs);
+    TEST_ASSERT_EQUAL(1, g.arenaOwner[0]);
+    TEST_ASSERT_TRUE(nodes[1].ready);
+    TEST_ASSERT_FALSE(nodes[2].ready);
+}
+
+static const void *gr_seen;
+static float gr_seen_value;
+
+static int gr_count_compute(ns_model_graph_node_t *n, void *out) {
+    *(float *)out = (float)((gr_model_t *)n->ctx)->runs;
+    return NS_STATUS_SUCCESS;
+}
+
+static int gr_tag_compute(ns_model_graph_node_t *n, void *out) {
+    *(float *)out = -(float)((gr_model_t *)n->ctx)->tag;
+    return NS_STATUS_SUCCESS;
+}
+
+static int gr_peek_compute(ns_model_graph_node_t *n, void *out) {
+    gr_seen = n->in[1].data;
+    gr_seen_value = *(const float *)n->in[1].data;
+    *(float *)out = 2 * gr_seen_value;
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_model_graph_test_shared_arena_same_pass() {
+    static const float rows[][GR_SCORES] = {{1, 1}};
+    ns_model_graph_node_t nodes[4];
+    const ns_model_graph_edge_t edges[] = {{1, 0, 3, 1}};
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 4, .edges = edges, .numEdges = 1};
+    gr_model_t a = gr_toy(gr_arena_shared, 1), b = gr_toy(gr_arena_shared, 2);
+    gr_model_t c = gr_toy(gr_arena_a, 3);
+    gr_script_t s;
+    uint32_t keepA[1], keepB[1];
+
+    a.compute = gr_count_compute;
+    b.compute = gr_tag_compute;
+    c.compute = gr_peek_compute;
+    gr_script_node(&nodes[0], &s, rows, 1);
+    gr_model_node(&nodes[1], "a", 0, &a);
+    gr_shared(&nodes[1], keepA, sizeof(keepA));
+    gr_model_node(&nodes[2], "b", 0, &b);
+    gr_shared(&nodes[2], keepB, sizeof(keepB));
+    gr_model_node(&nodes[3], "c", 1, &c); // reads a's output after b took the arena
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    // Both siblings run in every pass. Each takeover moves the previous owner's output out of
+    // the arena, so a's child and the application still see it after b re-planned the arena
+    for (int r = 1; r <= 3; r++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_run(&g));
+        TEST_ASSERT_TRUE(nodes[1].ran && nodes[2].ran && nodes[3].ran);
+        TEST_ASSERT_EQUAL_PTR(keepA, gr_seen);
+        TEST_ASSERT_EQUAL_FLOAT((float)r, gr_seen_value);
+        TEST_ASSERT_EQUAL_PTR(keepA, nodes[1].out[0].data);
+        TEST_ASSERT_EQUAL_PTR(keepA, nodes[1].scores.data);
+        TEST_ASSERT_EQUAL_FLOAT((float)r, ns_model_graph_score(&nodes[1], 0));
+        TEST_ASSERT_EQUAL_FLOAT(-2.0f, ns_model_graph_score(&nodes[2], 0));
+        TEST_ASSERT_EQUAL_FLOAT(2.0f * r, ns_model_graph_score(&nodes[3], 0));
+    }
+    TEST_ASSERT_EQUAL(3, a.inits);
+    TEST_ASSERT_EQUAL(3, b.inits);
+    TEST_ASSERT_EQUAL(3, a.intactReleases);
+    TEST_ASSERT_EQUAL(2, b.intactReleases);
+
+    // Outputs that don't fit fail the takeover, before the arena is touched
+    nodes[1].outCopyBytes = 2;
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_model_graph_run(&g));
+    TEST_ASSERT_FALSE(nodes[2].ran);
+    TEST_ASSERT_EQUAL(1, g.arenaOwner[0]);
+    TEST_ASSERT_EQUAL(a.tag, gr_arena_shared[0]);
+}
+
+void ns_model_graph_test_edges_by_reference() {
+    ns_model_graph_node_t nodes[3];
+    const ns_model_graph_edge_t edges[] = {{0, 0, 2, 1}};
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 3, .edges = edges, .numEdges = 1};
+    gr_model_t p = gr_toy(gr_arena_a, 1), mid = gr_toy(gr_arena_b, 2);
+    gr_model_t c = gr_toy(gr_arena_shared, 3);
+    const void *first;
+
+    p.compute = gr_count_compute;
+    c.compute = gr_peek_compute;
+    gr_model_node(&nodes[0], "producer", -1, &p);
+    gr_model_node(&nodes[1], "mid", 0, &mid);
+    gr_model_node(&nodes[2], "consumer", 1, &c);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    // The grandchild reads the producer's output in place, from the same pass
+    ns_model_graph_run(&g);
+    ns_model_graph_run(&g);
+    TEST_ASSERT_EQUAL_PTR(nodes[0].out[0].data, gr_seen);
+    TEST_ASSERT_EQUAL_PTR(nodes[0].out[0].data, nodes[2].in[1].data);
+    TEST_ASSERT_EQUAL(sizeof(float), nodes[2].in[1].bytes);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, gr_seen_value);
+    first = gr_seen;
+
+    // Re-initializing the producer moves its output; the reference follows
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+    ns_model_graph_run(&g);
+    TEST_ASSERT_TRUE(first != gr_seen);
+    TEST_ASSERT_EQUAL_PTR(nodes[0].out[0].data, gr_seen);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, gr_seen_value);
+}
+
+void ns_model_graph_test_failures() {
+    static const float rows[][GR_SCORES] = {{1.0f}};
+    ns_model_graph_node_t nodes[3];
+    ns_model_graph_t g = {.nodes = nodes, .numNodes = 3};
+    gr_model_t a = gr_toy(gr_arena_a, 1), b = gr_toy(gr_arena_b, 2);
+    gr_script_t s;
+
+    gr_script_node(&nodes[0], &s, rows, 1);
+    gr_model_node(&nodes[1], "a", 0, &a);
+    gr_model_node(&nodes[2], "b", 1, &b);
+
+    nodes[1].eager = true;
+    a.failInit = 1;
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_model_graph_init(&g));
+    nodes[1].eager = false;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+
+    // A failed init is retried on the next wake-up; nothing downstream runs meanwhile
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_model_graph_run(&g));
+    TEST_ASSERT_FALSE(nodes[1].ready);
+    TEST_ASSERT_FALSE(nodes[2].ran);
+    a.failInit = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_run(&g));
+    TEST_ASSERT_TRUE(nodes[2].ran);
+
+    b.failRun = 1;
+    TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE, ns_model_graph_run(&g));
+    TEST_ASSERT_FALSE(nodes[2].ran);
+    TEST_ASSERT_EQUAL(1, nodes[2].stats.runs);
+}
+
+// Example pipeline, run on 30 s of synthesized audio and IMU data at one pass per 20 ms:
+//
+//   mic (features) -> vad -> kws -> nnid (speaker ID, after the wake word)
+//   imu (motion)   -> har
+//
+// nnid and har share an arena. The audio has four words, one of them the wake word said
+// twice; the IMU data ends with 6 s of walking.
+
+#define GP_FRAMES 1500
+#define GP_HOP 320
+#define GP_WINDOW 50
+#define GP_IMU_WINDOW 100
+#define GP_WAKE 2
+
+typedef struct {
+    uint32_t start;
+    float hz;
+} gp_word_t;
+
+static const gp_word_t gp_words[] = {{200, 500}, {500, 1000}, {800, 2000}, {1100, 1000}};
+
+static uint32_t gp_frame, gp_seed;
+static float gp_features[2];                 // energy (dBFS), zero crossings
+static float gp_window[GP_WINDOW][2];        // last second of features
+static float gp_imu[GP_IMU_WINDOW][3];       // last two seconds of accelerometer
+static float gp_motion;                      // variance over the last half second
+static uint32_t gp_nnid_frames[GP_FRAMES];
+static uint8_t gp_vad_arena[512] __attribute__((aligned(16)));
+static uint8_t gp_kws_arena[4096] __attribute__((aligned(16)));
+static uint8_t gp_shared_arena[8192] __attribute__((aligned(16)));
+
+static float gp_noise(float amp) {
+    gp_seed = gp_seed * 1664525u + 1013904223u;
+    return amp * ((float)(gp_seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f);
+}
+
+static int gp_mic_run(ns_model_graph_node_t *n) {
+    int16_t pcm[GP_HOP];
+    double sum = 0;
+    uint32_t zcr = 0;
+
+    for (uint32_t i = 0; i < GP_HOP; i++) {
+        uint32_t t = gp_frame * GP_HOP + i;
+        float s = gp_noise(60.0f);
+        for (uint32_t w = 0; w < sizeof(gp_words) / sizeof(gp_words[0]); w++) {
+            uint32_t start = gp_words[w].start * GP_HOP;
+            if ((t >= start) && (t < start + 30 * GP_HOP)) {
+                s += 4000.0f * sinf(3.14159265f * (t - start) / (30 * GP_HOP)) *
+                     sinf(2 * 3.14159265f * gp_words[w].hz * t / 16000);
+            }
+        }
+        pcm[i] = (int16_t)s;
+        sum += (double)pcm[i] * pcm[i];
+        zcr += (i > 0) && ((pcm[i - 1] < 0) != (pcm[i] < 0));
+    }
+    gp_features[0] = sum > 0 ? 10.0f * log10f((float)(sum / GP_HOP) / (32768.0f * 32768.0f))
+                             : -100.0f;
+    gp_features[1] = (float)zcr;
+    memmove(gp_window[0], gp_window[1], sizeof(gp_window) - sizeof(gp_window[0]));
+    memcpy(gp_window[GP_WINDOW - 1], gp_features, sizeof(gp_features));
+    n->out[0].data = gp_features;
+    n->out[0].bytes = sizeof(gp_features);
+    n->out[1].data = gp_window;
+    n->out[1].bytes = sizeof(gp_window);
+    return NS_STATUS_SUCCESS;
+}
+
+static int gp_imu_run(ns_model_graph_node_t *n) {
+    float t = gp_frame / 50.0f, amp = (gp_frame >= 1200) && (gp_frame < 1500) ? 0.3f : 0.0f;
+    float mean = 0, var = 0;
+
+    memmove(gp_imu[0], gp_imu[1], sizeof(gp_imu) - sizeof(gp_imu[0]));
+    gp_imu[GP_IMU_WINDOW - 1][0] = gp_noise(0.02f) + 0.1f * amp * sinf(3.14159265f * 1.8f * t);
+    gp_imu[GP_IMU_WINDOW - 1][1] = gp_noise(0.02f);
+    gp_imu[GP_IMU_WINDOW - 1][2] = 1.0f + gp_noise(0.02f) + amp * sinf(2 * 3.14159265f * 1.8f * t);
+    for (uint32_t i = GP_IMU_WINDOW - 25; i < GP_IMU_WINDOW; i++) {
+        mean += gp_imu[i][2] / 25;
+    }
+    for (uint32_t i = GP_IMU_WINDOW - 25; i < GP_IMU_WINDOW; i++) {
+        var += (gp_imu[i][2] - mean) * (gp_imu[i][2] - mean) / 25;
+    }
+    gp_motion = var;
+    n->out[0].data = gp_imu;
+    n->out[0].bytes = sizeof(gp_imu);
+    return NS_STATUS_SUCCESS;
+}
+
+// int8 probabilities, scale 1/256 and zero point -128
+static int8_t gp_q(float p) {
+    int32_t q = (int32_t)lrintf(p * 256.0f) - 128;
+    return (int8_t)(q > 127 ? 127 : q);
+}
+
+static int gp_vad_compute(ns_model_graph_node_t *n, void *out) {
+    const float *features = (const float *)n->in[0].data;
+    float p = 1.0f / (1.0f + expf(-(features[0] + 45.0f) / 3.0f));
+    ((int8_t *)out)[0] = gp_q(1.0f - p);
+    ((int8_t *)out)[1] = gp_q(p);
+    return NS_STATUS_SUCCESS;
+}
+
+// Silence, unknown word, wake word or "stop", from the loudest frame of the window
+static int gp_kws_compute(ns_model_graph_node_t *n, void *out) {
+    const float(*window)[2] = (const float(*)[2])n->in[0].data;
+    uint32_t loudest = 0, cls = 0;
+
+    for (uint32_t f = 1; f < GP_WINDOW; f++) {
+        if (window[f][0] > window[loudest][0]) {
+            loudest = f;
+        }
+    }
+    if (window[loudest][0] > -40.0f) {
+        cls = window[loudest][1] < 30 ? 1 : (window[loudest][1] < 60 ? GP_WAKE : 3);
+    }
+    for (uint32_t c = 0; c < 4; c++) {
+        ((int8_t *)out)[c] = gp_q(c == cls ? 0.9f : 0.03f);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static int gp_nnid_compute(ns_model_graph_node_t *n, void *out) {
+    const int8_t *kws = (const int8_t *)n->in[1].data;
+    const float(*window)[2] = (const float(*)[2])n->in[0].data;
+
+    // Only ever woken by a wake word, with the KWS result of the same pass
+    for (uint32_t c = 0; c < 4; c++) {
+        if ((c != GP_WAKE) && (kws[c] >= kws[GP_WAKE])) {
+            return NS_STATUS_FAILURE;
+        }
+    }
+    for (uint32_t d = 0; d < 4; d++) {
+        ((float *)out)[d] = window[GP_WINDOW - 1 - d][0];
+    }
+    gp_nnid_frames[gp_frame] = 1;
+    return NS_STATUS_SUCCESS;
+}
+
+static int gp_har_compute(ns_model_graph_node_t *n, void *out) {
+    const float(*imu)[3] = (const float(*)[3])n->in[0].data;
+    float mean = 0, var = 0;
+
+    for (uint32_t i = 0; i < GP_IMU_WINDOW; i++) {
+        mean += imu[i][2] / GP_IMU_WINDOW;
+    }
+    for (uint32_t i = 0; i < GP_IMU_WINDOW; i++) {
+        var += (imu[i][2] - mean) * (imu[i][2] - mean) / GP_IMU_WINDOW;
+    }
+    ((int8_t *)out)[0] = gp_q(var < 0.01f ? 0.9f : 0.05f);
+    ((int8_t *)out)[1] = gp_q(var < 0.01f ? 0.05f : 0.9f);
+    ((int8_t *)out)[2] = gp_q(0.05f);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_model_graph_test_example_pipeline() {
+    ns_timer_config_t timer = {
+        .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+    enum { MIC, VAD, KWS, NNID, IMU, HAR };
+    static ns_model_graph_node_t nodes[6];
+    static const ns_model_graph_edge_t edges[] = {
+        {MIC, 0, VAD, 0}, {MIC, 1, KWS, 0}, {MIC, 1, NNID, 0}, {KWS, 0, NNID, 1}, {IMU, 0, HAR, 0}};
+    ns_model_graph_t g = {
+        .nodes = nodes, .numNodes = 6, .edges = edges, .numEdges = 5, .timer = &timer};
+    gr_model_t vad = gr_toy(gp_vad_arena, 1), kws = gr_toy(gp_kws_arena, 2);
+    gr_model_t nnid = gr_toy(gp_shared_arena, 3), har = gr_toy(gp_shared_arena, 4);
+    uint32_t wakeFrames = 0, nnidFrames = 0, missed = 0;
+    uint32_t nnidKeep[4], harKeep[1];
+
+    vad.arenaBytes = sizeof(gp_vad_arena);
+    vad.outBytes = vad.count = 2;
+    vad.type = NS_TENSOR_INT8;
+    vad.scale = 1.0f / 256;
+    vad.zeroPoint = -128;
+    vad.macs = 1000;
+    vad.compute = gp_vad_compute;
+    kws = vad;
+    kws.arena = gp_kws_arena;
+    kws.arenaBytes = sizeof(gp_kws_arena);
+    kws.tag = 2;
+    kws.outBytes = kws.count = 4;
+    kws.macs = 100000;
+    kws.compute = gp_kws_compute;
+    nnid.arenaBytes = har.arenaBytes = sizeof(gp_shared_arena);
+    nnid.outBytes = 4 * sizeof(float);
+    nnid.count = 4;
+    nnid.macs = 400000;
+    nnid.compute = gp_nnid_compute;
+    har = kws;
+    har.arena = gp_shared_arena;
+    har.arenaBytes = sizeof(gp_shared_arena);
+    har.tag = 4;
+    har.outBytes = har.count = 3;
+    har.macs = 50000;
+    har.compute = gp_har_compute;
+
+    memset(nodes, 0, sizeof(nodes));
+    nodes[MIC].name = "mic";
+    nodes[MIC].parent = -1;
+    nodes[MIC].run = gp_mic_run;
+    gr_model_node(&nodes[VAD], "vad", MIC, &vad);
+    nodes[VAD].eager = true;
+    gr_model_node(&nodes[KWS], "kws", VAD, &kws);
+    gr_when(&nodes[KWS], NS_MODEL_GRAPH_SCORE_ABOVE, 1, 0.5f);
+    nodes[KWS].when.consecutive = 3;
+    nodes[KWS].when.holdRuns = GP_WINDOW; // until the word has left the KWS window
+    gr_model_node(&nodes[NNID], "nnid", KWS, &nnid);
+    gr_when(&nodes[NNID], NS_MODEL_GRAPH_ARGMAX, GP_WAKE, 0.5f);
+    gr_shared(&nodes[NNID], nnidKeep, sizeof(nnidKeep));
+    nodes[IMU].name = "imu";
+    nodes[IMU].parent = -1;
+    nodes[IMU].run = gp_imu_run;
+    nodes[IMU].scores.data = &gp_motion;
+    nodes[IMU].scores.type = NS_TENSOR_FLOAT32;
+    nodes[IMU].scores.count = 1;
+    nodes[IMU].scores.scale = 1.0f;
+    gr_model_node(&nodes[HAR], "har", IMU, &har);
+    gr_when(&nodes[HAR], NS_MODEL_GRAPH_SCORE_ABOVE, 0, 0.005f);
+    nodes[HAR].when.consecutive = 5;
+    nodes[HAR].when.holdRuns = 25;
+    gr_shared(&nodes[HAR], harKeep, sizeof(harKeep));
+
+    ns_timer_init(&timer);
+    gp_seed = 3;
+    for (uint32_t i = 0; i < GP_IMU_WINDOW; i++) {
+        gp_imu[i][2] = 1.0f; // lying still
+    }
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_init(&g));
+    TEST_ASSERT_EQUAL(1, vad.inits);
+    TEST_ASSERT_EQUAL(0, kws.inits);
+    for (gp_frame = 0; gp_frame < GP_FRAMES; gp_frame++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_graph_run(&g));
+    }
+    ns_model_graph_print_stats(&g);
+
+    // Every word wakes KWS, and only the wake word wakes speaker ID, through the whole word
+    TEST_ASSERT_EQUAL(GP_FRAMES, nodes[VAD].stats.runs);
+    TEST_ASSERT_EQUAL(4, nodes[KWS].stats.wakes);
+    TEST_ASSERT_TRUE(nodes[KWS].stats.runs < GP_FRAMES / 3);
+    TEST_ASSERT_EQUAL(2, nodes[NNID].stats.wakes);
+    for (uint32_t w = 0; w < sizeof(gp_words) / sizeof(gp_words[0]); w++) {
+        for (uint32_t f = gp_words[w].start + 10; f < gp_words[w].start + 30; f++) {
+            bool wake = gp_words[w].hz == 1000;
+            wakeFrames += wake;
+            nnidFrames += gp_nnid_frames[f];
+            missed += wake != gp_nnid_frames[f];
+        }
+    }
+    TEST_ASSERT_EQUAL(0, missed);
+    TEST_ASSERT_EQUAL(wakeFrames, nnidFrames);
+
+    // HAR runs while walking, which starts after the second wake word. Neither model was
+    // resident until first needed, and HAR's takeover of the shared arena leaves speaker ID
+    // to be re-initialized if it is woken again
+    TEST_ASSERT_EQUAL(1, nodes[HAR].stats.wakes);
+    TEST_ASSERT_TRUE(nodes[HAR].stats.runs >= 290);
+    TEST_ASSERT_TRUE(nodes[HAR].stats.runs <= 300);
+    TEST_ASSERT_EQUAL(1, har.inits);
+    TEST_ASSERT_EQUAL(1, nnid.inits);
+    TEST_ASSERT_EQUAL(HAR, g.arenaOwner[0]);
+    TEST_ASSERT_FALSE(nodes[NNID].ready);
+    TEST_ASSERT_EQUAL_PTR(nnidKeep, nodes[NNID].out[0].data);
+}
@@ -0,0 +1,12 @@
+#include "ns_model_graph.h"
+void ns_model_graph_tests_pre_test_hook();
+void ns_model_graph_tests_post_test_hook();
+void ns_model_graph_test_config();
+void ns_model_graph_test_wake_and_hold();
+void ns_model_graph_test_conditions();
+void ns_model_graph_test_lazy_init();
+void ns_model_graph_test_shared_arena();
+void ns_model_graph_test_shared_arena_same_pass();
+void ns_model_graph_test_edges_by_reference();
+void ns_model_graph_test_failures();
+void ns_model_graph_test_example_pipeline();
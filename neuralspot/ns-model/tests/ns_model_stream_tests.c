@@ -0,0 +1,458 @@
+#include "ns_model_stream_tests.h"
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "unity/unity.h"
+#include <string.h>
+
+// A small int8 temporal convolution network stands in for a converted TFLM model: five
+// dilated convolutions (VALID in time) whose receptive field is 49 frames of 8 features, the
+// shape of the KWS MFCC window. The windowed form runs on all 49 frames; the streaming form
+// is what stream_converter.py produces, each convolution reading its history from a state
+// input and writing the updated history to a state output.
+
+#define SM_FEATURES 8
+#define SM_CHANNELS 8
+#define SM_CLASSES 4
+#define SM_LAYERS 5
+#define SM_WINDOW 49
+#define SM_MAX_STEP 8
+#define SM_MAX_HISTORY 20
+#define SM_ZP (-5)
+#define SM_FRAMES 400
+
+typedef struct {
+    uint8_t k, d, cin, cout;
+} sm_layer_t;
+
+static const sm_layer_t layers[SM_LAYERS] = {
+    {3, 1, SM_FEATURES, SM_CHANNELS},
+    {5, 2, SM_CHANNELS, SM_CHANNELS},
+    {5, 4, SM_CHANNELS, SM_CHANNELS},
+    {5, 5, SM_CHANNELS, SM_CHANNELS},
+    {3, 1, SM_CHANNELS, SM_CLASSES}};
+
+static int8_t weights[SM_LAYERS][5][SM_CHANNELS][SM_CHANNELS]; // [k][cin][cout]
+static int32_t bias[SM_LAYERS][SM_CHANNELS];
+static int8_t frames[SM_FRAMES][SM_FEATURES];
+
+static uint32_t sm_history(int l) { return (layers[l].k - 1) * layers[l].d; }
+
+static void sm_conv(int l, const int8_t *x, uint32_t len, int8_t *y) {
+    const sm_layer_t *ly = &layers[l];
+    for (uint32_t t = 0; t + sm_history(l) < len; t++) {
+        for (uint32_t co = 0; co < ly->cout; co++) {
+            int32_t acc = bias[l][co];
+            for (uint32_t k = 0; k < ly->k; k++) {
+                const int8_t *xk = x + (t + k * ly->d) * ly->cin;
+                for (uint32_t ci = 0; ci < ly->cin; ci++) {
+                    acc += weights[l][k][ci][co] * (xk[ci] - SM_ZP);
+                }
+            }
+            acc = (acc >> 7) + SM_ZP;
+            if ((l < SM_LAYERS - 1) && (acc < SM_ZP)) {
+                acc = SM_ZP; // ReLU
+            }
+            y[t * ly->cout + co] = (int8_t)(acc > 127 ? 127 : (acc < -128 ? -128 : acc));
+        }
+    }
+}
+
+// Windowed model: SM_WINDOW frames in, SM_CLASSES out
+static void sm_windowed(const int8_t *window, int8_t *out) {
+    static int8_t a[SM_WINDOW * SM_CHANNELS], b[SM_WINDOW * SM_CHANNELS];
+    uint32_t len = SM_WINDOW;
+    const int8_t *x = window;
+    int8_t *y = a;
+
+    for (int l = 0; l < SM_LAYERS; l++) {
+        sm_conv(l, x, len, l == SM_LAYERS - 1 ? out : y);
+        len -= sm_history(l);
+        x = y;
+        y = (y == a) ? b : a;
+    }
+}
+
+// The window ending at frame 'last', padded with zero-point frames before frame 0
+static void sm_window_at(int32_t last, int8_t *window) {
+    for (int32_t i = 0; i < SM_WINDOW; i++) {
+        int32_t f = last - (SM_WINDOW - 1) + i;
+        for (uint32_t c = 0; c < SM_FEATURES; c++) {
+            window[i * SM_FEATURES + c] = f < 0 ? SM_ZP : frames[f][c];
+        }
+    }
+}
+
+// Streaming model: framesPerStep frames plus one history cache per layer
+typedef struct {
+    uint32_t step;
+    bool internalState; // keep the caches inside, as resource variables would
+    int8_t input[SM_MAX_STEP * SM_FEATURES];
+    int8_t stateIn[SM_LAYERS][SM_MAX_HISTORY * SM_CHANNELS];
+    int8_t stateOut[SM_LAYERS][SM_MAX_HISTORY * SM_CHANNELS];
+    int8_t output[SM_MAX_STEP * SM_CLASSES];
+    uint32_t invokes;
+    uint32_t resets;
+} sm_stream_model_t;
+
+static int sm_stream_invoke(void *ctx) {
+    sm_stream_model_t *m = (sm_stream_model_t *)ctx;
+    static int8_t cat[(SM_MAX_HISTORY + SM_MAX_STEP) * SM_CHANNELS];
+    static int8_t y[SM_MAX_STEP * SM_CHANNELS];
+    const int8_t *x = m->input;
+
+    for (int l = 0; l < SM_LAYERS; l++) {
+        uint32_t hist = sm_history(l) * layers[l].cin, now = m->step * layers[l].cin;
+        memcpy(cat, m->stateIn[l], hist);
+        memcpy(cat + hist, x, now);
+        memcpy(m->stateOut[l], cat + now, hist);
+        sm_conv(l, cat, sm_history(l) + m->step, l == SM_LAYERS - 1 ? m->output : y);
+        x = y;
+    }
+    if (m->internalState) {
+        memcpy(m->stateIn, m->stateOut, sizeof(m->stateIn));
+    }
+    m->invokes++;
+    return NS_STATUS_SUCCESS;
+}
+
+static int sm_stream_reset(void *ctx) {
+    sm_stream_model_t *m = (sm_stream_model_t *)ctx;
+    if (m->internalState) {
+        memset(m->stateIn, (uint8_t)SM_ZP, sizeof(m->stateIn));
+    }
+    m->resets++;
+    return NS_STATUS_SUCCESS;
+}
+
+static sm_stream_model_t model;
+static ns_model_stream_desc_t desc;
+static ns_model_stream_t stream;
+
+static void sm_bind(uint32_t step, ns_model_stream_mode_e mode) {
+    memset(&model, 0x55, sizeof(model)); // caches must be set by reset, not by luck
+    model.step = step;
+    model.internalState = mode == NS_MODEL_STREAM_RESOURCE_VARIABLES;
+    model.invokes = model.resets = 0;
+
+    memset(&desc, 0, sizeof(desc));
+    desc.mode = mode;
+    desc.framesPerStep = step;
+    desc.frameBytes = SM_FEATURES;
+    desc.windowFrames = SM_WINDOW;
+    desc.numStates = mode == NS_MODEL_STREAM_EXTERNAL_STATE ? SM_LAYERS : 0;
+
+    memset(&stream, 0, sizeof(stream));
+    stream.desc = &desc;
+    stream.input = (uint8_t *)model.input;
+    stream.invoke = sm_stream_invoke;
+    stream.reset = sm_stream_reset;
+    stream.ctx = &model;
+    for (uint32_t l = 0; l < desc.numStates; l++) {
+        desc.stateInput[l] = desc.stateOutput[l] = l + 1;
+        stream.states[l].in = (uint8_t *)model.stateIn[l];
+        stream.states[l].out = (const uint8_t *)model.stateOut[l];
+        stream.states[l].bytes = sm_history(l) * layers[l].cin;
+        stream.states[l].resetValue = (uint8_t)SM_ZP;
+    }
+}
+
+typedef struct {
+    int32_t nextFrame; // newest frame of the first output in the step
+    uint32_t checked;
+    uint32_t mismatches;
+} sm_check_t;
+
+// Output callback: every frame of the step against the windowed model
+static void sm_check_output(ns_model_stream_t *s, void *arg) {
+    sm_check_t *c = (sm_check_t *)arg;
+    int8_t window[SM_WINDOW * SM_FEATURES], ref[SM_CLASSES];
+
+    for (uint32_t i = 0; i < s->desc->framesPerStep; i++) {
+        sm_window_at(c->nextFrame + i, window);
+        sm_windowed(window, ref);
+        c->mismatches += memcmp(ref, model.output + i * SM_CLASSES, SM_CLASSES) != 0;
+        c->checked++;
+    }
+    c->nextFrame += s->desc->framesPerStep;
+}
+
+void ns_model_stream_tests_pre_test_hook() {
+    uint32_t lfsr = 0xACE1u;
+    int8_t *w = &weights[0][0][0][0];
+    for (uint32_t i = 0; i < sizeof(weights); i++) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        w[i] = (int8_t)((int32_t)(lfsr & 0x3F) - 32);
+    }
+    for (uint32_t l = 0; l < SM_LAYERS; l++) {
+        for (uint32_t c = 0; c < SM_CHANNELS; c++) {
+            bias[l][c] = (int32_t)(l * 37 + c * 11) - 60;
+        }
+    }
+    for (uint32_t f = 0; f < SM_FRAMES; f++) {
+        for (uint32_t c = 0; c < SM_FEATURES; c++) {
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            frames[f][c] = (int8_t)(lfsr & 0xFF);
+        }
+    }
+}
+
+void ns_model_stream_tests_post_test_hook() {}
+
+void ns_model_stream_test_config() {
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_model_stream_init(NULL));
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    stream.invoke = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_model_stream_init(&stream));
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    desc.framesPerStep = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_stream_init(&stream));
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    desc.numStates = NS_MODEL_STREAM_MAX_STATES + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_stream_init(&stream));
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    stream.states[3].out = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_stream_init(&stream));
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    desc.mode = (ns_model_stream_mode_e)5;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_stream_init(&stream));
+
+    // Init resets: caches hold the zero point, the runtime was reset once
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_init(&stream));
+    TEST_ASSERT_EQUAL(1, model.resets);
+    for (uint32_t i = 0; i < sm_history(1) * SM_CHANNELS; i++) {
+        TEST_ASSERT_EQUAL_INT8(SM_ZP, model.stateIn[1][i]);
+    }
+    TEST_ASSERT_EQUAL_INT8(0x55, model.stateIn[1][sm_history(1) * SM_CHANNELS]);
+    TEST_ASSERT_FALSE(ns_model_stream_warm(&stream));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_model_stream_push(&stream, NULL, 1));
+}
+
+// One frame per step: every output matches the windowed model on the same 49 frames
+void ns_model_stream_test_matches_window() {
+    sm_check_t check = {0};
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_init(&stream));
+    stream.output = sm_check_output;
+    stream.outputArg = &check;
+    for (uint32_t f = 0; f < SM_FRAMES; f++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_push(&stream, frames[f], 1));
+        TEST_ASSERT_EQUAL(f + 1 >= SM_WINDOW, ns_model_stream_warm(&stream));
+    }
+    TEST_ASSERT_EQUAL(SM_FRAMES, check.checked);
+    TEST_ASSERT_EQUAL(0, check.mismatches);
+    TEST_ASSERT_EQUAL(SM_FRAMES, model.invokes);
+    TEST_ASSERT_EQUAL(SM_FRAMES, stream.steps);
+}
+
+// Several frames per step, fed in chunks that don't line up with steps
+void ns_model_stream_test_multi_frame_steps() {
+    static const uint32_t chunks[] = {1, 3, 7, 2, 8, 13, 1, 1, 5};
+    sm_check_t check = {0};
+    uint32_t f = 0, c = 0;
+
+    sm_bind(4, NS_MODEL_STREAM_EXTERNAL_STATE);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_init(&stream));
+    stream.output = sm_check_output;
+    stream.outputArg = &check;
+    while (f < SM_FRAMES) {
+        uint32_t n = chunks[c++ % (sizeof(chunks) / sizeof(chunks[0]))];
+        n = (f + n > SM_FRAMES) ? SM_FRAMES - f : n;
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_push(&stream, frames[f], n));
+        f += n;
+        TEST_ASSERT_EQUAL(f % 4, stream.pending);
+    }
+    TEST_ASSERT_EQUAL(SM_FRAMES / 4, model.invokes);
+    TEST_ASSERT_EQUAL(SM_FRAMES, check.checked);
+    TEST_ASSERT_EQUAL(0, check.mismatches);
+
+    // Writing the input in place and stepping is the same as pushing
+    memcpy(model.input, frames[0], 4 * SM_FEATURES);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_step(&stream));
+    TEST_ASSERT_EQUAL(SM_FRAMES / 4 + 1, stream.steps);
+}
+
+// Before a full window has arrived the output is the windowed model's on zero-point padding
+void ns_model_stream_test_cold_start() {
+    int8_t window[SM_WINDOW * SM_FEATURES], ref[SM_CLASSES];
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    ns_model_stream_init(&stream);
+    for (int32_t f = 0; f < 10; f++) {
+        ns_model_stream_push(&stream, frames[f], 1);
+        sm_window_at(f, window);
+        sm_windowed(window, ref);
+        TEST_ASSERT_EQUAL_INT8_ARRAY(ref, model.output, SM_CLASSES);
+        TEST_ASSERT_FALSE(ns_model_stream_warm(&stream));
+    }
+}
+
+void ns_model_stream_test_reset() {
+    static int8_t first[60][SM_CLASSES];
+
+    sm_bind(2, NS_MODEL_STREAM_EXTERNAL_STATE);
+    ns_model_stream_init(&stream);
+    for (uint32_t f = 0; f < 60; f += 2) {
+        ns_model_stream_push(&stream, frames[f + 100], 2);
+        memcpy(first[f], model.output, 2 * SM_CLASSES);
+    }
+    TEST_ASSERT_TRUE(ns_model_stream_warm(&stream));
+
+    // A half-gathered step is dropped too
+    ns_model_stream_push(&stream, frames[7], 1);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_reset(&stream));
+    TEST_ASSERT_EQUAL(0, stream.pending);
+    TEST_ASSERT_EQUAL(0, stream.steps);
+    TEST_ASSERT_FALSE(ns_model_stream_warm(&stream));
+    TEST_ASSERT_EQUAL(2, model.resets);
+    for (uint32_t f = 0; f < 60; f += 2) {
+        ns_model_stream_push(&stream, frames[f + 100], 2);
+        TEST_ASSERT_EQUAL_INT8_ARRAY(first[f], model.output, 2 * SM_CLASSES);
+    }
+}
+
+// State kept by the runtime: nothing copied, reset goes through the callback
+void ns_model_stream_test_resource_variables() {
+    sm_check_t check = {0};
+
+    sm_bind(1, NS_MODEL_STREAM_RESOURCE_VARIABLES);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_init(&stream));
+    TEST_ASSERT_EQUAL(1, model.resets);
+    stream.output = sm_check_output;
+    stream.outputArg = &check;
+    ns_model_stream_push(&stream, frames, 120);
+    TEST_ASSERT_EQUAL(120, check.checked);
+    TEST_ASSERT_EQUAL(0, check.mismatches);
+
+    ns_model_stream_reset(&stream);
+    check.nextFrame = 0;
+    ns_model_stream_push(&stream, frames, 60);
+    TEST_ASSERT_EQUAL(2, model.resets);
+    TEST_ASSERT_EQUAL(0, check.mismatches);
+}
+
+// Three counter states packed into one arena the way a planner may lay them out once the
+// inputs are consumed: state 1's output sits on state 0's input, and state 2's output
+// overlaps its own input. Every step adds (i + 1 + k) to byte k of state i.
+
+#define SM_ALIAS_BYTES 8
+
+static uint8_t sm_alias_arena[48];
+static uint8_t sm_alias_frame;
+
+static int sm_alias_invoke(void *ctx) {
+    ns_model_stream_t *s = (ns_model_stream_t *)ctx;
+    uint8_t in[3][SM_ALIAS_BYTES];
+
+    for (uint32_t i = 0; i < 3; i++) {
+        memcpy(in[i], s->states[i].in, SM_ALIAS_BYTES);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        for (uint32_t k = 0; k < SM_ALIAS_BYTES; k++) {
+            ((uint8_t *)s->states[i].out)[k] = in[i][k] + i + 1 + k;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static void sm_alias_bind(void) {
+    static const uint8_t inAt[3] = {0, 8, 32}, outAt[3] = {20, 0, 36};
+
+    memset(&desc, 0, sizeof(desc));
+    desc.mode = NS_MODEL_STREAM_EXTERNAL_STATE;
+    desc.framesPerStep = 1;
+    desc.frameBytes = 1;
+    desc.windowFrames = 1;
+    desc.numStates = 3;
+    memset(&stream, 0, sizeof(stream));
+    stream.desc = &desc;
+    stream.input = &sm_alias_frame;
+    stream.invoke = sm_alias_invoke;
+    stream.ctx = &stream;
+    for (uint32_t i = 0; i < 3; i++) {
+        stream.states[i].in = sm_alias_arena + inAt[i];
+        stream.states[i].out = sm_alias_arena + outAt[i];
+        stream.states[i].bytes = SM_ALIAS_BYTES;
+    }
+}
+
+void ns_model_stream_test_aliased_states() {
+    sm_alias_bind();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_init(&stream));
+    TEST_ASSERT_EQUAL(1, stream.copyOrder[0]); // reads state 1's output before state 0 lands
+    for (uint32_t t = 1; t <= 3; t++) {
+        TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_model_stream_step(&stream));
+        for (uint32_t i = 0; i < 3; i++) {
+            for (uint32_t k = 0; k < SM_ALIAS_BYTES; k++) {
+                TEST_ASSERT_EQUAL_UINT8(t * (i + 1 + k), stream.states[i].in[k]);
+            }
+        }
+    }
+
+    // Two states writing over each other's outputs can't be ordered
+    sm_alias_bind();
+    stream.states[0].out = stream.states[1].in;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_model_stream_init(&stream));
+}
+
+void ns_model_stream_test_benchmark() {
+    ns_timer_config_t bench_timer = {
+        .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+    int8_t window[SM_WINDOW * SM_FEATURES], ref[SM_CLASSES];
+    uint32_t windowMacs = 0, streamMacs = 0, len = SM_WINDOW, start, windowUs, streamUs;
+    uint32_t agree = 0, steps = 0;
+    const uint32_t reps = 20;
+
+    for (int l = 0; l < SM_LAYERS; l++) {
+        uint32_t perFrame = layers[l].k * layers[l].cin * layers[l].cout;
+        len -= sm_history(l);
+        windowMacs += len * perFrame;
+        streamMacs += perFrame;
+    }
+    ns_timer_init(&bench_timer);
+
+    // Hop of one frame: the windowed model recomputes 49 frames for each new one
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t r = 0; r < reps; r++) {
+        for (int32_t f = SM_WINDOW - 1; f < SM_FRAMES; f++) {
+            sm_window_at(f, window);
+            sm_windowed(window, ref);
+        }
+    }
+    windowUs = ns_us_ticker_read(&bench_timer) - start;
+
+    sm_bind(1, NS_MODEL_STREAM_EXTERNAL_STATE);
+    ns_model_stream_init(&stream);
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t r = 0; r < reps; r++) {
+        ns_model_stream_reset(&stream);
+        ns_model_stream_push(&stream, frames, SM_FRAMES);
+    }
+    streamUs = ns_us_ticker_read(&bench_timer) - start;
+
+    // Accuracy over the warm steps of the last pass: decision and bit-exact agreement
+    ns_model_stream_reset(&stream);
+    for (int32_t f = 0; f < SM_FRAMES; f++) {
+        ns_model_stream_push(&stream, frames[f], 1);
+        if (ns_model_stream_warm(&stream)) {
+            sm_window_at(f, window);
+            sm_windowed(window, ref);
+            agree += memcmp(ref, model.output, SM_CLASSES) == 0;
+            steps++;
+        }
+    }
+    TEST_ASSERT_EQUAL(steps, agree);
+
+    ns_lp_printf("Streaming vs windowed, %u-frame window, 1 new frame per step:\n", SM_WINDOW);
+    ns_lp_printf("  MACs/step:  %u windowed, %u streaming\n", windowMacs, streamMacs);
+    ns_lp_printf("  ns/step:    %u windowed, %u streaming (host)\n",
+                 (uint32_t)((uint64_t)windowUs * 1000 / (reps * (SM_FRAMES - SM_WINDOW + 1))),
+                 (uint32_t)((uint64_t)streamUs * 1000 / (reps * SM_FRAMES)));
+    ns_lp_printf("  exact outputs: %u of %u warm steps\n", agree, steps);
+}
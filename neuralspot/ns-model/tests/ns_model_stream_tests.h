@@ -0,0 +1,11 @@
+#include "ns_model_stream.h"
+void ns_model_stream_tests_pre_test_hook();
+void ns_model_stream_tests_post_test_hook();
+void ns_model_stream_test_config();
+void ns_model_stream_test_matches_window();
+void ns_model_stream_test_multi_frame_steps();
+void ns_model_stream_test_cold_start();
+void ns_model_stream_test_reset();
+void ns_model_stream_test_resource_variables();
+void ns_model_stream_test_aliased_states();
+void ns_model_stream_test_benchmark();
@@ -0,0 +1,426 @@
+#include "ns_tensor_adapter_tests.h"
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "unity/unity.h"
+#include <math.h>
+#include <string.h>
+
+// Results are checked against a double precision reference of the unfused formula. The fused
+// multiply-add can land on the other side of a rounding tie, so quantized values may differ by
+// one LSB in rare cases; anything larger is a failure.
+
+#define TA_STEPS 200 // HAR window: 200 samples of 6 axes
+#define TA_AXES 6
+
+static uint32_t lfsr = 0x1234567;
+
+static float ta_rand(float lo, float hi) {
+    lfsr ^= lfsr << 13;
+    lfsr ^= lfsr >> 17;
+    lfsr ^= lfsr << 5;
+    return lo + (hi - lo) * (float)(lfsr >> 8) / (float)(1 << 24);
+}
+
+static int32_t ta_ref_q(double y, int32_t lo, int32_t hi) {
+    double r = y < 0 ? ceil(y - 0.5) : floor(y + 0.5);
+    return r < lo ? lo : (r > hi ? hi : (int32_t)r);
+}
+
+static float imu[TA_STEPS * TA_AXES];
+static float mean[TA_AXES], invStd[TA_AXES];
+static int8_t tensorS8[TA_STEPS * TA_AXES];
+static int16_t tensorS16[TA_STEPS * TA_AXES];
+static float tensorF32[TA_STEPS * TA_AXES];
+static float outF32[TA_STEPS * TA_AXES];
+
+static const int32_t imuDims[3] = {1, TA_STEPS, TA_AXES};
+
+static void ta_make_imu() {
+    for (uint32_t a = 0; a < TA_AXES; a++) {
+        mean[a] = ta_rand(-2.0f, 2.0f);
+        invStd[a] = 1.0f / ta_rand(0.2f, 3.0f);
+    }
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        uint32_t a = i % TA_AXES;
+        imu[i] = mean[a] + ta_rand(-4.0f, 4.0f) / invStd[a];
+    }
+}
+
+void ns_tensor_adapter_tests_pre_test_hook() {}
+
+void ns_tensor_adapter_tests_post_test_hook() {}
+
+void ns_tensor_adapter_test_config() {
+    ns_tensor_adapter_t t;
+    const int32_t img[4] = {2, 8, 8, 3};
+    const int32_t bad[2] = {4, 0};
+    const float scale = 0.05f, zero = 0.0f, scales3[3] = {0.1f, 0.2f, 0.3f};
+    const int32_t zp = -3;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE,
+                      ns_tensor_adapter_config(NULL, NS_TENSOR_INT8, tensorS8, img, 4, NULL, NULL,
+                                               1));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE,
+                      ns_tensor_adapter_config(&t, NS_TENSOR_INT8, NULL, img, 4, NULL, NULL, 1));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, bad, 2, &scale, &zp, 1));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, img, 4, &zero, &zp, 1));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, img, 4, scales3, NULL, 2));
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_INVALID_CONFIG,
+        ns_tensor_adapter_config(&t, (ns_tensor_type_e)7, tensorS8, img, 4, &scale, &zp, 1));
+
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, img, 4, scales3, NULL, 3));
+    TEST_ASSERT_EQUAL(2, t.batches);
+    TEST_ASSERT_EQUAL(64, t.spatial);
+    TEST_ASSERT_EQUAL(3, t.channels);
+    TEST_ASSERT_EQUAL(384, t.elements);
+    TEST_ASSERT_EQUAL(3, t.numScales);
+    TEST_ASSERT_EQUAL(0, t.zeroPoint[2]);
+    TEST_ASSERT_EQUAL(1, t.kernels->elementBytes);
+
+    // Float tensors ignore quantization; a 1-D tensor is one row of channels
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_FLOAT32, tensorF32, &img[3], 1, &scale, &zp, 1));
+    TEST_ASSERT_EQUAL(1, t.batches);
+    TEST_ASSERT_EQUAL(1, t.spatial);
+    TEST_ASSERT_EQUAL(3, t.channels);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, t.scale[0]);
+    TEST_ASSERT_EQUAL(0, t.zeroPoint[0]);
+}
+
+void ns_tensor_adapter_test_quantize_per_tensor() {
+    ns_tensor_adapter_t t;
+    const float scale = 0.0625f;
+    const int32_t zp = 5;
+    // Ties, saturation and the edges of the range
+    static const float edge[] = {0.03125f, -0.03125f, -0.34375f, 7.6875f, 7.75f, 100.0f,
+                                 -8.3125f, -8.34375f, -100.0f, 0.0f, 7.7187f};
+    static const int8_t edgeQ[] = {6, 5, -1, 127, 127, 127, -128, -128, -128, 5, 127};
+    int32_t diff;
+
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, imuDims, 3, &scale, &zp, 1));
+    memcpy(imu, edge, sizeof(edge));
+    for (uint32_t i = sizeof(edge) / sizeof(edge[0]); i < TA_STEPS * TA_AXES; i++) {
+        imu[i] = ta_rand(-10.0f, 10.0f);
+    }
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS,
+                      ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, NULL, NULL));
+    TEST_ASSERT_EQUAL_INT8_ARRAY(edgeQ, tensorS8, sizeof(edgeQ));
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        diff = tensorS8[i] - ta_ref_q((double)imu[i] / scale + zp, -128, 127);
+        TEST_ASSERT_TRUE(diff >= -1 && diff <= 1);
+    }
+
+    // int16 tensor
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT16, tensorS16, imuDims, 3, &scale, &zp, 1));
+    ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, NULL, NULL);
+    TEST_ASSERT_EQUAL_INT16(6, tensorS16[0]);
+    TEST_ASSERT_EQUAL_INT16(1605, tensorS16[5]);
+    TEST_ASSERT_EQUAL_INT16(-1595, tensorS16[8]);
+}
+
+// The har.cc input: per-axis standardization folded into the quantization
+void ns_tensor_adapter_test_normalize_per_channel() {
+    ns_tensor_adapter_t t;
+    const float scale = 0.031f;
+    const int32_t zp = -7;
+    uint32_t offByOne = 0;
+
+    ta_make_imu();
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, imuDims, 3, &scale, &zp, 1));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS,
+                      ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, mean, invStd));
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        uint32_t a = i % TA_AXES;
+        double y = ((double)imu[i] - mean[a]) * invStd[a] / scale + zp;
+        int32_t diff = tensorS8[i] - ta_ref_q(y, -128, 127);
+        TEST_ASSERT_TRUE(diff >= -1 && diff <= 1);
+        offByOne += diff != 0;
+    }
+    TEST_ASSERT_TRUE(offByOne < 4);
+
+    // Mean only, and standard deviation only
+    ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, mean, NULL);
+    TEST_ASSERT_INT_WITHIN(1, ta_ref_q(((double)imu[7] - mean[1]) / scale + zp, -128, 127),
+                           tensorS8[7]);
+    ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, NULL, invStd);
+    TEST_ASSERT_INT_WITHIN(1, ta_ref_q((double)imu[9] * invStd[3] / scale + zp, -128, 127),
+                           tensorS8[9]);
+}
+
+// Planar (NCHW) sources are transposed into the NHWC tensor
+void ns_tensor_adapter_test_planar_source() {
+    ns_tensor_adapter_t t;
+    static float planar[2 * 4 * 5 * 3];
+    const int32_t dims[4] = {2, 4, 5, 3};
+    const float one = 1.0f;
+    const float offs[3] = {0.0f, 100.0f, -100.0f};
+    const int32_t zp = 0;
+
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT16, tensorS16, dims, 4, &one, &zp, 1));
+    for (uint32_t b = 0; b < 2; b++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            for (uint32_t s = 0; s < 20; s++) {
+                planar[b * 60 + c * 20 + s] = (float)(b * 1000 + c * 100 + s) + offs[c];
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS,
+                      ns_tensor_quantize_f32(&t, planar, NS_TENSOR_NCHW, offs, NULL));
+    for (uint32_t b = 0; b < 2; b++) {
+        for (uint32_t s = 0; s < 20; s++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                TEST_ASSERT_EQUAL_INT16(b * 1000 + c * 100 + s, tensorS16[b * 60 + s * 3 + c]);
+            }
+        }
+    }
+
+    // And back out again, planar
+    memset(outF32, 0, sizeof(outF32));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_tensor_dequantize(&t, outF32, NS_TENSOR_NCHW));
+    for (uint32_t i = 0; i < 120; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(planar[i] - offs[(i % 60) / 20], outF32[i]);
+    }
+}
+
+void ns_tensor_adapter_test_per_channel_quantization() {
+    ns_tensor_adapter_t t;
+    float scales[TA_AXES];
+    int32_t zps[TA_AXES];
+
+    ta_make_imu();
+    for (uint32_t a = 0; a < TA_AXES; a++) {
+        scales[a] = 0.01f * (float)(a + 1);
+        zps[a] = (int32_t)a * 10 - 20;
+    }
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, imuDims, 3, scales, zps,
+                                 TA_AXES));
+    ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, NULL, NULL);
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        uint32_t a = i % TA_AXES;
+        TEST_ASSERT_INT_WITHIN(1, ta_ref_q((double)imu[i] / scales[a] + zps[a], -128, 127),
+                               tensorS8[i]);
+    }
+    ns_tensor_dequantize(&t, outF32, NS_TENSOR_NHWC);
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        uint32_t a = i % TA_AXES;
+        TEST_ASSERT_EQUAL_FLOAT((float)(tensorS8[i] - zps[a]) * scales[a], outF32[i]);
+    }
+}
+
+void ns_tensor_adapter_test_int16_source() {
+    ns_tensor_adapter_t t;
+    static int16_t pcm[TA_STEPS * TA_AXES];
+    const float scale = 1.0f / 256;
+    const int32_t zp = 0;
+    const float featMean = 1000.0f, featInvStd = 1.0f / 16384;
+
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        pcm[i] = (int16_t)ta_rand(-32768.0f, 32767.0f);
+    }
+    pcm[0] = -32768;
+    pcm[1] = 32767;
+    TEST_ASSERT_EQUAL(
+        NS_STATUS_SUCCESS,
+        ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, imuDims, 3, &scale, &zp, 1));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_tensor_quantize_s16(&t, pcm, NS_TENSOR_NHWC, NULL,
+                                                                NULL));
+    TEST_ASSERT_EQUAL_INT8(-128, tensorS8[0]);
+    TEST_ASSERT_EQUAL_INT8(127, tensorS8[1]);
+
+    // One mean and deviation for every channel still goes through the per-channel path
+    float means[TA_AXES], invStds[TA_AXES];
+    for (uint32_t a = 0; a < TA_AXES; a++) {
+        means[a] = featMean;
+        invStds[a] = featInvStd;
+    }
+    ns_tensor_quantize_s16(&t, pcm, NS_TENSOR_NHWC, means, invStds);
+    for (uint32_t i = 0; i < TA_STEPS * TA_AXES; i++) {
+        double y = ((double)pcm[i] - featMean) * featInvStd / scale;
+        TEST_ASSERT_INT_WITHIN(1, ta_ref_q(y, -128, 127), tensorS8[i]);
+    }
+
+    // int16 into int16 is exact for a unit scale
+    const float one = 1.0f;
+    ns_tensor_adapter_config(&t, NS_TENSOR_INT16, tensorS16, imuDims, 3, &one, &zp, 1);
+    ns_tensor_quantize_s16(&t, pcm, NS_TENSOR_NHWC, NULL, NULL);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(pcm, tensorS16, TA_STEPS * TA_AXES);
+}
+
+void ns_tensor_adapter_test_dequantize() {
+    ns_tensor_adapter_t t;
+    const float scale = 0.00390625f;
+    const int32_t zp = -128, dims[2] = {1, 10};
+
+    for (uint32_t i = 0; i < 10; i++) {
+        tensorS8[i] = (int8_t)(i * 25 - 128);
+    }
+    ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, dims, 2, &scale, &zp, 1);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_tensor_dequantize(&t, outF32, NS_TENSOR_NHWC));
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_FLOAT((float)(i * 25) / 256, outF32[i]);
+    }
+
+    // Float tensors copy straight through
+    for (uint32_t i = 0; i < 10; i++) {
+        tensorF32[i] = (float)i - 4.5f;
+    }
+    ns_tensor_adapter_config(&t, NS_TENSOR_FLOAT32, tensorF32, dims, 2, NULL, NULL, 1);
+    ns_tensor_dequantize(&t, outF32, NS_TENSOR_NCHW);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(tensorF32, outF32, 10);
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_tensor_dequantize(&t, NULL, NS_TENSOR_NHWC));
+}
+
+void ns_tensor_adapter_test_softmax() {
+    ns_tensor_adapter_t t;
+    const float scale = 0.1f;
+    const int32_t zp = 3, dims[2] = {2, 5};
+    static const int8_t logits[10] = {13, 3, -7, 23, 3, 127, 127, -128, 0, 126};
+    double ref[5], sum;
+
+    memcpy(tensorS8, logits, sizeof(logits));
+    ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, dims, 2, &scale, &zp, 1);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_tensor_softmax(&t, outF32));
+    for (uint32_t r = 0; r < 2; r++) {
+        sum = 0;
+        for (uint32_t c = 0; c < 5; c++) {
+            ref[c] = exp((logits[r * 5 + c] - zp) * (double)scale);
+            sum += ref[c];
+        }
+        for (uint32_t c = 0; c < 5; c++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-6f, (float)(ref[c] / sum), outF32[r * 5 + c]);
+        }
+    }
+}
+
+void ns_tensor_adapter_test_top_k() {
+    ns_tensor_adapter_t t;
+    const float scale = 0.5f, scales[4] = {1.0f, 0.1f, 2.0f, 0.5f};
+    const int32_t zp = 0, zps[4] = {0, 0, 0, 0}, dims[2] = {1, 8}, dims4[2] = {2, 4};
+    static const int8_t scores[8] = {5, -3, 40, 7, 40, -128, 7, 39};
+    uint32_t idx[10];
+    float val[10];
+
+    memcpy(tensorS8, scores, sizeof(scores));
+    ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, dims, 2, &scale, &zp, 1);
+    TEST_ASSERT_EQUAL(3, ns_tensor_top_k(&t, 3, idx, val));
+    TEST_ASSERT_EQUAL(2, idx[0]); // Tie with 4, lower index first
+    TEST_ASSERT_EQUAL(4, idx[1]);
+    TEST_ASSERT_EQUAL(7, idx[2]);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, val[0]);
+    TEST_ASSERT_EQUAL_FLOAT(19.5f, val[2]);
+    TEST_ASSERT_EQUAL(2, ns_tensor_argmax(&t));
+
+    // k beyond the element count returns everything, sorted
+    TEST_ASSERT_EQUAL(8, ns_tensor_top_k(&t, 10, idx, NULL));
+    TEST_ASSERT_EQUAL(3, idx[3]);
+    TEST_ASSERT_EQUAL(6, idx[4]);
+    TEST_ASSERT_EQUAL(5, idx[7]);
+    TEST_ASSERT_EQUAL(0, ns_tensor_top_k(&t, 0, idx, NULL));
+
+    // Per-channel scales rank by real value: 5, -0.3, 80, 3.5, 40, -12.8, 14, 19.5
+    ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, dims4, 2, scales, zps, 4);
+    TEST_ASSERT_EQUAL(2, ns_tensor_top_k(&t, 2, idx, val));
+    TEST_ASSERT_EQUAL(2, idx[0]);
+    TEST_ASSERT_EQUAL(4, idx[1]);
+    TEST_ASSERT_EQUAL_FLOAT(80.0f, val[0]);
+    TEST_ASSERT_EQUAL(2, ns_tensor_argmax(&t));
+}
+
+// har.cc's loops, for comparison
+static void ta_har_input(const float *x, int8_t *q, float scale, int32_t zp) {
+    int idx = 0;
+    for (int i = 0; i < TA_STEPS; i++) {
+        for (int a = 0; a < TA_AXES; a++) {
+            float norm = (x[i * TA_AXES + a] - mean[a]) / (1.0f / invStd[a]);
+            norm = norm / scale + zp;
+            norm = MAX(MIN(norm, 127), -128);
+            q[idx++] = (int8_t)norm;
+        }
+    }
+}
+
+static uint32_t ta_har_output(const int8_t *q, uint32_t n, float scale, int32_t zp) {
+    float maxVal = -1e30f;
+    uint32_t best = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        float score = (q[i] - zp) * scale;
+        if (score > maxVal) {
+            maxVal = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void ns_tensor_adapter_test_benchmark() {
+    ns_tensor_adapter_t t;
+    const float scale = 0.031f;
+    const int32_t zp = -7;
+    const uint32_t loops = 2000, n = TA_STEPS * TA_AXES;
+    uint32_t start, refUs, fusedUs, deqRefUs, deqUs, check = 0;
+
+    ns_timer_config_t bench_timer = {
+        .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+    ns_timer_init(&bench_timer);
+    ta_make_imu();
+    ns_tensor_adapter_config(&t, NS_TENSOR_INT8, tensorS8, imuDims, 3, &scale, &zp, 1);
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t l = 0; l < loops; l++) {
+        imu[l % n] += 1e-3f;
+        ta_har_input(imu, tensorS8, scale, zp);
+        check += (uint8_t)tensorS8[l % n];
+    }
+    refUs = ns_us_ticker_read(&bench_timer) - start;
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t l = 0; l < loops; l++) {
+        imu[l % n] += 1e-3f;
+        ns_tensor_quantize_f32(&t, imu, NS_TENSOR_NHWC, mean, invStd);
+        check += (uint8_t)tensorS8[l % n];
+    }
+    fusedUs = ns_us_ticker_read(&bench_timer) - start;
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t l = 0; l < loops; l++) {
+        tensorS8[l % n] ^= 1;
+        check += ta_har_output(tensorS8, n, scale, zp);
+    }
+    deqRefUs = ns_us_ticker_read(&bench_timer) - start;
+
+    start = ns_us_ticker_read(&bench_timer);
+    for (uint32_t l = 0; l < loops; l++) {
+        tensorS8[l % n] ^= 1;
+        check += ns_tensor_argmax(&t);
+    }
+    deqUs = ns_us_ticker_read(&bench_timer) - start;
+
+    TEST_ASSERT_EQUAL(ta_har_output(tensorS8, n, scale, zp), ns_tensor_argmax(&t));
+    ns_lp_printf("Tensor adapter, %u elements (200 x 6, per-axis normalization):\n", n);
+    ns_lp_printf("  input:  %u ps/element har.cc loop, %u ps/element fused (host)\n",
+                 (uint32_t)((uint64_t)refUs * 1000000 / ((uint64_t)loops * n)),
+                 (uint32_t)((uint64_t)fusedUs * 1000000 / ((uint64_t)loops * n)));
+    ns_lp_printf("  argmax: %u ps/element dequantize + compare, %u ps/element raw (check %u)\n",
+                 (uint32_t)((uint64_t)deqRefUs * 1000000 / ((uint64_t)loops * n)),
+                 (uint32_t)((uint64_t)deqUs * 1000000 / ((uint64_t)loops * n)), check & 1);
+}
@@ -0,0 +1,13 @@
+#include "ns_tensor_adapter.h"
+void ns_tensor_adapter_tests_pre_test_hook();
+void ns_tensor_adapter_tests_post_test_hook();
+void ns_tensor_adapter_test_config();
+void ns_tensor_adapter_test_quantize_per_tensor();
+void ns_tensor_adapter_test_normalize_per_channel();
+void ns_tensor_adapter_test_planar_source();
+void ns_tensor_adapter_test_per_channel_quantization();
+void ns_tensor_adapter_test_int16_source();
+void ns_tensor_adapter_test_dequantize();
+void ns_tensor_adapter_test_softmax();
+void ns_tensor_adapter_test_top_k();
+void ns_tensor_adapter_test_benchmark();
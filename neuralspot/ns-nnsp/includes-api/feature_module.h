@@ -12,8 +12,11 @@ typedef struct {
     int32_t feature[MAX_SIZE_FEATURE];
     int16_t num_mfltrBank;
     const int16_t *p_melBanks;
-    // contextual normalized features
-    int16_t normFeatContext[NUM_FEATURE_CONTEXT * MAX_SIZE_FEATURE];
+    // contextual normalized features: a history ring of num_context rows, mirrored so the
+    // num_context most recent rows are always contiguous (oldest first) at pt_normFeatContext
+    int16_t normFeatContext[(2 * NUM_FEATURE_CONTEXT - 1) * MAX_SIZE_FEATURE];
+    int16_t *pt_normFeatContext;
+    int16_t idx_context;
     int16_t num_context;
     int16_t dim_feat;
     const int32_t *pt_norm_mean;
@@ -36,6 +39,12 @@ void FeatureClass_construct(
 void FeatureClass_setDefault(FeatureClass *ps);
 
 void FeatureClass_execute(FeatureClass *ps, int16_t *input);
+
+/*
+    FeatureClass_pushContext: normalizes ps->feature and appends it to the
+    context history as the newest row
+*/
+void FeatureClass_pushContext(FeatureClass *ps);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,422 @@
+#ifndef __NEURAL_NETS_STATIC_H__
+#define __NEURAL_NETS_STATIC_H__
+/*
+    Compile-time specialized front end for NeuralNetClass networks.
+
+    The topology is a type list of layers whose dims, activations and Q formats are template
+    parameters:
+
+        using VadNet = nnsp::Net<
+            nnsp::Fc<240, 28, 7, 8, 14, ftanh>,   // DimIn, DimOut, QKernel, QInput, QBias, Act
+            nnsp::Lstm<28, 28, 5, 15, 13>,        // DimIn, DimOut, QKernel, QInput, QBias
+            nnsp::Fc<28, 2, 7, 12, 15, linear>>;
+
+    Weights are the same def_nn*.c tables the runtime dispatcher uses, taken from a
+    NeuralNetClass with bind(), which refuses descriptors that do not match the type. exe() is
+    output-compatible with NeuralNetClass_exe() (bit exact): the layers are fully specialized
+    affine and LSTM kernels with compile-time trip counts and constant shifts, no function
+    pointers, and statically sized ping-pong buffers and LSTM states.
+
+    On Helium builds (ARM_OPTIMIZED == 3) the layers call the MVE kernels of affine.c and
+    lstm.c with constant dims instead, which are already vectorized.
+
+    Requires C++14. tests/ns_nnsp_static_net_tests_nnvad.cc times both paths on the nnvad
+    topology.
+*/
+#include <stdint.h>
+#include "activation.h"
+#include "affine.h"
+#include "ambiq_nnsp_debug.h"
+#include "ambiq_stdint.h"
+#include "lstm.h"
+#include "minmax.h"
+#include "neural_nets.h"
+
+#ifdef __cplusplus
+    #include <type_traits>
+
+namespace nnsp {
+
+typedef void *(*ActFunc)(void *, int32_t *, int);
+typedef int *(*LayerFunc)();
+
+struct LayerWeights {
+    const int8_t *kernel;
+    const int8_t *kernel_rec;
+    const int16_t *bias;
+};
+
+namespace detail {
+
+template <int Shift, int Sign = (Shift > 0) - (Shift < 0)> struct Shift64;
+template <int Shift> struct Shift64<Shift, 0> {
+    static inline int64_t apply(int64_t x) { return x; }
+};
+template <int Shift> struct Shift64<Shift, -1> {
+    static inline int64_t apply(int64_t x) { return x >> -Shift; }
+};
+template <int Shift> struct Shift64<Shift, 1> {
+    static inline int64_t apply(int64_t x) {
+        const int64_t M = ((int64_t)1 << (63 - Shift)) - 1;
+        return (int64_t)((uint64_t)MIN(MAX(x, -M - 1), M) << Shift);
+    }
+};
+
+// shift_64b() with a constant shift
+template <int Shift> static inline int64_t shift64(int64_t x) { return Shift64<Shift>::apply(x); }
+
+// Bias alignment of affine_Krows_8x16()
+template <int Shift> static inline int64_t align_bias(int16_t b) {
+    return (Shift >= 0) ? (int64_t)((uint64_t)(int64_t)b << (Shift >= 0 ? Shift : 0))
+                        : (int64_t)b >> (Shift < 0 ? -Shift : 0);
+}
+
+// Offset of the weight of row j for input e (0, 1) of a pair, within the 2*K weights of a pair
+template <int K> static constexpr int pair_offset(int j, int e) {
+#if ARM_OPTIMIZED == 0
+    return 2 * j + e;
+#else
+    // Layout read by __SMLALD: rows in 2x2 blocks, column major, then a last odd row's pair
+    return ((K % 2) && (j == K - 1)) ? 2 * j + e : 4 * (j / 2) + (j % 2) + 2 * e;
+#endif
+}
+
+/*
+    K rows of a matrix*vec in the kernel table layout of affine_Krows_8x16(): for each pair of
+    inputs, 2*K weights (pair_offset), then K weights for an odd last input. Products are at
+    most 2^22, so below 512 inputs the sums are exact in 32 bits.
+*/
+template <int K, int DimIn>
+static inline void dot_rows(const int8_t *w, const int16_t *x, int64_t *acc) {
+    typedef typename std::conditional<(DimIn < 512), int32_t, int64_t>::type acc_t;
+    acc_t sum[K] = {};
+
+    for (int i = 0; i < DimIn / 2; i++) {
+        acc_t x0 = x[2 * i];
+        acc_t x1 = x[2 * i + 1];
+        for (int j = 0; j < K; j++) {
+            sum[j] += (acc_t)w[pair_offset<K>(j, 0)] * x0 + (acc_t)w[pair_offset<K>(j, 1)] * x1;
+        }
+        w += 2 * K;
+    }
+    if (DimIn % 2) {
+        for (int j = 0; j < K; j++) {
+            sum[j] += (acc_t)w[j] * x[DimIn - 1];
+        }
+    }
+    for (int j = 0; j < K; j++) {
+        acc[j] += sum[j];
+    }
+}
+
+template <ACTIVATION_TYPE Act, int K> static inline void activate(void *y, int32_t *x) {
+    if (Act == relu6) {
+        for (int j = 0; j < K; j++) {
+            ((int16_t *)y)[j] = (int16_t)MAX(MIN((int32_t)6 << 12, x[j] >> 3), 0);
+        }
+    } else if (Act == ftanh) {
+        tanh_fix((int16_t *)y, x, K);
+    } else if (Act == sigmoid) {
+        sigmoid_fix((int16_t *)y, x, K);
+    } else {
+        for (int j = 0; j < K; j++) {
+            ((int32_t *)y)[j] = x[j];
+        }
+    }
+}
+
+static inline ActFunc act_func(ACTIVATION_TYPE act) {
+    switch (act) {
+    case relu6:
+        return (ActFunc)&relu6_fix;
+    case ftanh:
+        return (ActFunc)&tanh_fix;
+    case sigmoid:
+        return (ActFunc)&sigmoid_fix;
+    default:
+        return (ActFunc)&linear_fix;
+    }
+}
+
+/*
+    K rows of rc_Krows_8x16(), i.e. one LSTM gate: W*x aligned to the Q of the recurrent
+    input, plus W_rec*h and bias, activated. Advances the table pointers.
+*/
+template <int K, int DimIn, int DimRec, int QK, int QI, int QIR, int QB, ACTIVATION_TYPE Act>
+static inline void gate_rows(
+    const int8_t *&w, const int8_t *&wr, const int16_t *&b, const int16_t *x, const int16_t *h,
+    int16_t *out) {
+    constexpr int qbit_s = MAX(15, QIR + QK);
+    int64_t acc[K] = {};
+    int32_t acc32[K];
+
+    dot_rows<K, DimIn>(w, x, acc);
+    for (int j = 0; j < K; j++) {
+        acc[j] = shift64<QIR - QI>(acc[j]);
+    }
+    dot_rows<K, DimRec>(wr, h, acc);
+    for (int j = 0; j < K; j++) {
+        int64_t a = shift64<qbit_s - (QIR + QK)>(acc[j]) + align_bias<qbit_s - QB>(b[j]);
+        a = shift64<15 - qbit_s>(a);
+        acc32[j] = (int32_t)MIN(MAX(a, MIN_INT32_T), MAX_INT32_T);
+    }
+    activate<Act, K>(out, acc32);
+    w += K * DimIn;
+    wr += K * DimRec;
+    b += K;
+}
+
+} // namespace detail
+
+/// Fully connected layer (fc_8x16)
+template <int DimIn_, int DimOut_, int QKernel, int QInput, int QBias, ACTIVATION_TYPE Act>
+struct Fc {
+    static constexpr int DimIn = DimIn_;
+    static constexpr int DimOut = DimOut_;
+    static constexpr int QIn = QInput;
+    static constexpr int StateSize = 0;
+    static constexpr ACTIVATION_TYPE Activation = Act;
+    static_assert(DimIn > 0 && DimOut > 0, "empty layer");
+
+    static bool matches(const NeuralNetClass *net, int i) {
+        return (net->net_layer_type[i] == fc) && (net->layer_func[i] == (LayerFunc)&fc_8x16) &&
+               (net->qbit_kernel[i] == QKernel) && (net->qbit_input[i] == QInput) &&
+               (net->qbit_bias[i] == QBias) && (net->activation_type[i] == Act) &&
+               (net->act_func[i] == detail::act_func(Act));
+    }
+
+    // out is int16_t, or int32_t for a linear activation
+    template <int QNext>
+    static void exe(const LayerWeights &lw, const int16_t *in, void *out, int32_t *, int16_t *) {
+#if ARM_OPTIMIZED == 3
+        fc_8x16(
+            (int16_t *)out, (int8_t *)lw.kernel, (int8_t *)0, (int16_t *)lw.bias, (int16_t *)in,
+            (int16_t *)0, (int32_t *)0, DimOut, DimIn, DimOut, QKernel, QBias, QInput, QNext, Act,
+            detail::act_func(Act));
+#else
+        constexpr int qbit_s = MAX(15, QInput + QKernel);
+        constexpr int width = (Act == linear) ? 2 : 1; // int16_t per output
+        const int8_t *w = lw.kernel;
+        const int16_t *b = lw.bias;
+        int16_t *po = (int16_t *)out;
+
+        for (int r = 0; r < DimOut / 4; r++) {
+            rows<4, qbit_s>(w, b, in, po);
+            w += 4 * DimIn;
+            b += 4;
+            po += 4 * width;
+        }
+        if (DimOut % 4) {
+            rows<Tail, qbit_s>(w, b, in, po);
+        }
+#endif
+    }
+
+  private:
+    // Rows of the last partial block (4 when there is none, then never run)
+    static constexpr int Tail = (DimOut % 4) ? DimOut % 4 : 4;
+
+    template <int K, int qbit_s>
+    static inline void rows(const int8_t *w, const int16_t *b, const int16_t *in, int16_t *po) {
+        int64_t acc[K] = {};
+        int32_t acc32[K];
+
+        detail::dot_rows<K, DimIn>(w, in, acc);
+        for (int j = 0; j < K; j++) {
+            int64_t a = detail::shift64<qbit_s - (QInput + QKernel)>(acc[j]) +
+                        detail::align_bias<qbit_s - QBias>(b[j]);
+            a = detail::shift64<15 - qbit_s>(a);
+            acc32[j] = (int32_t)MIN(MAX(a, MIN_INT32_T), MAX_INT32_T);
+        }
+        detail::activate<Act, K>(po, acc32);
+    }
+};
+
+/// LSTM layer (lstm_8x16). The recurrent input is in the Q format of the next layer's input.
+template <int DimIn_, int DimOut_, int QKernel, int QInput, int QBias> struct Lstm {
+    static constexpr int DimIn = DimIn_;
+    static constexpr int DimOut = DimOut_;
+    static constexpr int QIn = QInput;
+    static constexpr int StateSize = DimOut_;
+    static constexpr ACTIVATION_TYPE Activation = ftanh;
+    static_assert(DimIn > 0 && DimOut > 0, "empty layer");
+
+    static bool matches(const NeuralNetClass *net, int i) {
+        return (net->net_layer_type[i] == lstm) &&
+               (net->layer_func[i] == (LayerFunc)&lstm_8x16) && (net->qbit_kernel[i] == QKernel) &&
+               (net->qbit_input[i] == QInput) && (net->qbit_bias[i] == QBias) &&
+               (net->pt_kernel_rec[i] != 0);
+    }
+
+    template <int QNext>
+    static void exe(const LayerWeights &lw, const int16_t *in, void *out, int32_t *c, int16_t *h) {
+#if ARM_OPTIMIZED == 3
+        lstm_8x16(
+            (int16_t *)out, (int8_t *)lw.kernel, (int8_t *)lw.kernel_rec, (int16_t *)lw.bias,
+            (int16_t *)in, h, c, DimOut, DimIn, DimOut, QKernel, QBias, QInput, QNext, ftanh,
+            (ActFunc)&tanh_fix);
+#else
+        const int8_t *w = lw.kernel;
+        const int8_t *wr = lw.kernel_rec;
+        const int16_t *b = lw.bias;
+        int16_t *po = (int16_t *)out;
+
+        for (int r = 0; r < DimOut / 4; r++) {
+            cells<4, QNext>(w, wr, b, in, h, c + 4 * r, po + 4 * r);
+        }
+        if (DimOut % 4) {
+            constexpr int r = DimOut / 4;
+            cells<Tail, QNext>(w, wr, b, in, h, c + 4 * r, po + 4 * r);
+        }
+        for (int j = 0; j < DimOut; j++) {
+            h[j] = po[j];
+        }
+#endif
+    }
+
+  private:
+    static constexpr int Tail = (DimOut % 4) ? DimOut % 4 : 4; // see Fc
+
+    template <int K, int QIR>
+    static inline void cells(
+        const int8_t *&w, const int8_t *&wr, const int16_t *&b, const int16_t *in,
+        const int16_t *h, int32_t *c, int16_t *po) {
+        int16_t gi[K], gj[K], gf[K], go[K];
+
+        detail::gate_rows<K, DimIn, DimOut, QKernel, QInput, QIR, QBias, sigmoid>(
+            w, wr, b, in, h, gi);
+        detail::gate_rows<K, DimIn, DimOut, QKernel, QInput, QIR, QBias, ftanh>(
+            w, wr, b, in, h, gj);
+        detail::gate_rows<K, DimIn, DimOut, QKernel, QInput, QIR, QBias, sigmoid>(
+            w, wr, b, in, h, gf);
+        detail::gate_rows<K, DimIn, DimOut, QKernel, QInput, QIR, QBias, sigmoid>(
+            w, wr, b, in, h, go);
+        for (int j = 0; j < K; j++) {
+            int64_t t = ((int64_t)gi[j] * gj[j] + (int64_t)gf[j] * c[j]) >> 15;
+            c[j] = (int32_t)MIN(MAX(t, MIN_INT32_T), MAX_INT32_T);
+        }
+        tanh_fix(po, c, K);
+        for (int j = 0; j < K; j++) {
+            po[j] = (int16_t)MIN(
+                MAX((((int32_t)po[j] * (int32_t)go[j]) >> 15), MIN_INT16_T), MAX_INT16_T);
+        }
+    }
+};
+
+namespace detail {
+
+template <int I, class L, class... Ls> struct At {
+    typedef typename At<I - 1, Ls...>::type type;
+};
+template <class L, class... Ls> struct At<0, L, Ls...> {
+    typedef L type;
+};
+
+template <class... Ls> constexpr int max_dim_out_but_last() {
+    constexpr int dims[] = {Ls::DimOut...};
+    int m = 1;
+    for (unsigned i = 0; i + 1 < sizeof...(Ls); i++) {
+        m = MAX(m, dims[i]);
+    }
+    return m;
+}
+
+template <class... Ls> constexpr int sum_state_size(int first = 0, int last = sizeof...(Ls)) {
+    constexpr int sizes[] = {Ls::StateSize..., 0};
+    int s = 0;
+    for (int i = first; i < last; i++) {
+        s += sizes[i];
+    }
+    return s;
+}
+
+} // namespace detail
+
+/// Network of Fc and Lstm layers, see the top of this file
+template <class... Layers> class Net {
+  public:
+    static constexpr int numLayers = sizeof...(Layers);
+    static constexpr int DimIn = detail::At<0, Layers...>::type::DimIn;
+    static constexpr int DimOut = detail::At<numLayers - 1, Layers...>::type::DimOut;
+
+    static_assert(numLayers > 0 && numLayers <= 10, "NeuralNetClass holds up to 10 layers");
+
+    /// Take the weight tables of a runtime descriptor, false if it is not this topology
+    bool bind(const NeuralNetClass *net) {
+        if ((net == 0) || (net->numlayers != numLayers) || !matches<0>(net)) {
+            return false;
+        }
+        for (int i = 0; i < numLayers; i++) {
+            weights[i].kernel = net->pt_kernel[i];
+            weights[i].kernel_rec = net->pt_kernel_rec[i];
+            weights[i].bias = net->pt_bias[i];
+        }
+        setDefault();
+        return true;
+    }
+
+    /// Reset the LSTM states (NeuralNetClass_setDefault)
+    void setDefault() {
+        for (int i = 0; i < stateSize; i++) {
+            cstate[i] = 0;
+            hstate[i] = 0;
+        }
+    }
+
+    /// Same as NeuralNetClass_exe(net, input, output, -1)
+    void exe(const int16_t *input, int32_t *output) { run<0>(input, output); }
+
+  private:
+    static constexpr int stateSize = detail::sum_state_size<Layers...>();
+    static constexpr int bufSize = detail::max_dim_out_but_last<Layers...>();
+
+    LayerWeights weights[numLayers];
+    int16_t buf[2][bufSize];
+    int32_t cstate[stateSize ? stateSize : 1];
+    int16_t hstate[stateSize ? stateSize : 1];
+
+    // Layer I is followed by another one
+    template <int I> using HasNext = std::integral_constant<bool, (I + 1 < sizeof...(Layers))>;
+
+    template <int I> static bool matches(const NeuralNetClass *net) {
+        typedef typename detail::At<I, Layers...>::type L;
+        if ((net->size_layer[I] != L::DimIn) || (net->size_layer[I + 1] != L::DimOut) ||
+            !L::matches(net, I)) {
+            return false;
+        }
+        return matchesNext<I>(net, HasNext<I>());
+    }
+    template <int I> static bool matchesNext(const NeuralNetClass *net, std::true_type) {
+        return matches<I + 1>(net);
+    }
+    template <int I> static bool matchesNext(const NeuralNetClass *, std::false_type) {
+        return true;
+    }
+
+    template <int I> void run(const int16_t *in, int32_t *output) {
+        run<I>(in, output, HasNext<I>());
+    }
+
+    template <int I> void run(const int16_t *in, int32_t *output, std::true_type) {
+        typedef typename detail::At<I, Layers...>::type L;
+        typedef typename detail::At<I + 1, Layers...>::type Next;
+        constexpr int off = detail::sum_state_size<Layers...>(0, I);
+
+        static_assert(L::DimOut == Next::DimIn, "layer dims do not chain");
+        static_assert(L::Activation != linear, "linear (32 bit) output only on the last layer");
+        L::template exe<Next::QIn>(weights[I], in, buf[I % 2], cstate + off, hstate + off);
+        run<I + 1>(buf[I % 2], output);
+    }
+
+    template <int I> void run(const int16_t *in, int32_t *output, std::false_type) {
+        typedef typename detail::At<I, Layers...>::type L;
+        constexpr int off = detail::sum_state_size<Layers...>(0, I);
+
+        // The runtime reads the Q of a last LSTM's recurrent input from an unset entry (0)
+        L::template exe<0>(weights[I], in, output, cstate + off, hstate + off);
+    }
+};
+
+} // namespace nnsp
+#endif // __cplusplus
+#endif
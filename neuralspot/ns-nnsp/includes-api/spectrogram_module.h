@@ -9,18 +9,23 @@ extern "C" {
     #include <arm_math.h>
 #endif
 #include "ambiq_nnsp_const.h"
+#define LEN_STFT_SPEC (2 * LEN_FFT_NNSP + 2)
+
+// All buffers are per instance, so several STFTs (e.g. one per model) can run side by side
 typedef struct {
     int16_t len_win;
     int16_t hop;
     int16_t len_fft;
-    int16_t *dataBuffer;
-    int32_t *odataBuffer;
+    int16_t dataBuffer[LEN_FFT_NNSP];  // history ring of len_win samples
+    int16_t idx_data;                  // oldest sample in dataBuffer, next hop is written here
+    int32_t odataBuffer[LEN_FFT_NNSP]; // overlap-add of the synthesized frames
     const int16_t *window;
 #if ARM_FFT == 1
     arm_rfft_instance_q31 fft_st;
     arm_rfft_instance_q31 ifft_st;
 #endif
-    int32_t *spec;
+    int32_t spec[LEN_STFT_SPEC];
+    int32_t fft_buf[LEN_STFT_SPEC]; // windowed frame for the FFT, or the inverse FFT's output
 } stftModule;
 
 int stftModule_construct(
@@ -29,6 +34,17 @@ int stftModule_construct(
 
 int stftModule_setDefault(stftModule *ps);
 
+/*
+    stftModule_push: writes one hop into the history ring
+*/
+void stftModule_push(stftModule *ps, int16_t *x);
+
+/*
+    stftModule_window_q30: windows the history ring, oldest sample first,
+    reading across the wrap boundary directly (Q15 x Q15 = Q30)
+*/
+void stftModule_window_q30(stftModule *ps, int32_t *y);
+
 #if ARM_FFT == 0
 void spec2pspec(int32_t *y, int32_t *x, int len);
 
@@ -4,7 +4,7 @@
 #include "minmax.h"
 #include "ambiq_nnsp_const.h"
 #include "melSpecProc.h"
-#include "fixlog10.h"
+#include "ns_fast_log.h"
 #include "ambiq_nnsp_debug.h"
 #include "ns_ambiqsuite_harness.h"
 #if ARM_OPTIMIZED == 3
@@ -35,6 +35,8 @@ void FeatureClass_construct(
     ps->pt_norm_mean = norm_mean;
     ps->pt_norm_stdR = norm_stdR;
     ps->num_context = NUM_FEATURE_CONTEXT;
+    ps->idx_context = 0;
+    ps->pt_normFeatContext = ps->normFeatContext;
     ps->dim_feat = num_mfltrBank;
     ps->qbit_output = qbit_output;
     ps->num_mfltrBank = num_mfltrBank;
@@ -58,33 +60,51 @@ void FeatureClass_setDefault(FeatureClass *ps) {
         tmp64 = MIN(MAX(tmp64, (int64_t)MIN_INT16_T), (int64_t)MAX_INT16_T);
         tmp = (int16_t)tmp64;
 
-        for (j = 0; j < (ps->num_context - 1); j++) {
+        // every row of the ring (and its mirror) starts out as 'silence'
+        for (j = 0; j < (2 * ps->num_context - 1); j++) {
             ps->normFeatContext[i + j * ps->dim_feat] = tmp;
         }
     }
+    ps->idx_context = 0;
+    ps->pt_normFeatContext = ps->normFeatContext;
+}
+
+void FeatureClass_pushContext(FeatureClass *ps) {
+    int i;
+    int64_t tmp;
+    int16_t *pt_row = ps->normFeatContext + ps->idx_context * ps->dim_feat;
+
+    for (i = 0; i < ps->dim_feat; i++) {
+        tmp = (int64_t)ps->feature[i] - (int64_t)ps->pt_norm_mean[i];
+        tmp = (tmp * ((int64_t)ps->pt_norm_stdR[i])) >>
+              (30 - ps->qbit_output); // Bit_frac_out = 30-22 = 8
+        tmp = MIN(MAX(tmp, (int64_t)MIN_INT16_T), (int64_t)MAX_INT16_T);
+        pt_row[i] = (int16_t)tmp;
+    }
+
+    // The last slot has no mirror: when it is the newest row, the window starts at row 0
+    if (ps->idx_context < ps->num_context - 1) {
+#if ARM_OPTIMIZED == 3
+        move_data_16b(pt_row, pt_row + ps->num_context * ps->dim_feat, ps->dim_feat);
+#else
+        for (i = 0; i < ps->dim_feat; i++)
+            pt_row[i + ps->num_context * ps->dim_feat] = pt_row[i];
+#endif
+    }
+
+    ps->idx_context++;
+    if (ps->idx_context == ps->num_context)
+        ps->idx_context = 0;
+    ps->pt_normFeatContext = ps->normFeatContext + ps->idx_context * ps->dim_feat;
 }
 
 void FeatureClass_execute(FeatureClass *ps, int16_t *input) {
     int16_t qbit_out;
     int32_t *pspec = GLOBAL_PSPEC;
     int32_t *spec = ps->state_stftModule.spec;
-    int shift = (ps->num_context - 1) * ps->dim_feat;
+#if AMBIQ_NNSP_DEBUG == 1
     int i;
-    int64_t tmp;
-    if (ps->num_context > 1)
-    {
-    #if ARM_OPTIMIZED == 3
-        move_data_16b(
-            ps->normFeatContext+ps->dim_feat, 
-            ps->normFeatContext,
-            shift);
-    #else
-        for (i = 0; i < shift; i++) {
-            ps->normFeatContext[i] = ps->normFeatContext[i + ps->dim_feat];
-        }
-
-    #endif
-    }
+#endif
 #if ARM_FFT == 0
     stftModule_analyze(&ps->state_stftModule, input, spec);
     #if AMBIQ_NNSP_DEBUG == 1
@@ -128,7 +148,7 @@ void FeatureClass_execute(FeatureClass *ps, int16_t *input) {
     }
     fprintf(file_melSpec_c, "\n");
 #endif
-    log10_vec(ps->feature, pt_feature, ps->dim_feat, 15);
+    ns_log10_q31_vec(ps->feature, pt_feature, ps->dim_feat, 15);
 #if AMBIQ_NNSP_DEBUG == 1
     for (i = 0; i < ps->dim_feat; i++) {
         fprintf(file_feat_c, "%d ", ps->feature[i]);
@@ -136,12 +156,5 @@ void FeatureClass_execute(FeatureClass *ps, int16_t *input) {
     fprintf(file_feat_c, "\n");
 #endif
 
-    for (i = 0; i < ps->dim_feat; i++) {
-        tmp = (int64_t)ps->feature[i] - (int64_t)ps->pt_norm_mean[i];
-        tmp = (tmp * ((int64_t)ps->pt_norm_stdR[i])) >>
-              (30 - ps->qbit_output); // Bit_frac_out = 30-22 = 8
-        tmp = MIN(MAX(tmp, (int64_t)MIN_INT16_T), (int64_t)MAX_INT16_T);
-        ps->normFeatContext[i + shift] = (int16_t)tmp;
-    }
-
+    FeatureClass_pushContext(ps);
 }
@@ -170,7 +170,7 @@ int16_t NNSPClass_exec(NNSPClass *pt_inst, int16_t *rawPCM) {
         // for (int i = 0; i < 432; i++) {
         //     pt_feat->normFeatContext[i] = 1;
         // }
-        NeuralNetClass_exe(pt_net, pt_feat->normFeatContext, glob_nn_output, debug_layer);
+        NeuralNetClass_exe(pt_net, pt_feat->pt_normFeatContext, glob_nn_output, debug_layer);
         // int16_t *po = (int16_t *)glob_nn_output;
         // ns_printf("output: \n\n");
         // for (int i = 0; i < 257; i++) {
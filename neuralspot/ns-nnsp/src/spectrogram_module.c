@@ -9,18 +9,14 @@
 #else
     #include "fft_arm.h"
 #endif
-
-int16_t dataBuffer[LEN_FFT_NNSP];
-int32_t odataBuffer[LEN_FFT_NNSP];
-int32_t glob_spec[1026];
-int32_t glob_fft_buf[1026];
+#if ARM_OPTIMIZED == 3
+    #include "basic_mve.h"
+#endif
 
 int stftModule_construct(
     stftModule *ps, int16_t len_win, int16_t hopsize, int16_t fftsize,
     const int16_t *pt_stft_win_coeff) {
-    ps->spec = glob_spec;
-    ps->dataBuffer = dataBuffer;
-    ps->odataBuffer = odataBuffer;
+    ps->idx_data = 0;
     ps->len_win = len_win;
     ps->hop = hopsize;
     ps->len_fft = fftsize;
@@ -37,9 +33,50 @@ int stftModule_setDefault(stftModule *ps) {
         ps->dataBuffer[i] = 0;
         ps->odataBuffer[i] = 0;
     }
+    ps->idx_data = 0;
     return 0;
 }
 
+void stftModule_push(stftModule *ps, int16_t *x) {
+    int16_t len_tail = MIN(ps->hop, ps->len_win - ps->idx_data);
+    int16_t len_head = ps->hop - len_tail;
+#if ARM_OPTIMIZED == 3
+    move_data_16b(x, ps->dataBuffer + ps->idx_data, len_tail);
+    if (len_head)
+        move_data_16b(x + len_tail, ps->dataBuffer, len_head);
+#else
+    int i;
+    for (i = 0; i < len_tail; i++)
+        ps->dataBuffer[ps->idx_data + i] = x[i];
+    for (i = 0; i < len_head; i++)
+        ps->dataBuffer[i] = x[len_tail + i];
+#endif
+    ps->idx_data += ps->hop;
+    if (ps->idx_data >= ps->len_win)
+        ps->idx_data -= ps->len_win;
+}
+
+void stftModule_window_q30(stftModule *ps, int32_t *y) {
+    // ring[idx_data..len_win) is the oldest part of the frame, ring[0..idx_data) the newest
+    int16_t len_old = ps->len_win - ps->idx_data;
+#if ARM_OPTIMIZED == 3
+    vec16_vec16_mul_32b(
+        y, (int16_t *)ps->window, ps->dataBuffer + ps->idx_data, len_old);
+    if (ps->idx_data)
+        vec16_vec16_mul_32b(
+            y + len_old, (int16_t *)ps->window + len_old, ps->dataBuffer, ps->idx_data);
+#else
+    int i;
+    const int16_t *pt_win = ps->window;
+    int16_t *pt_data = ps->dataBuffer + ps->idx_data;
+    for (i = 0; i < len_old; i++)
+        *y++ = (int32_t)*pt_win++ * (int32_t)*pt_data++;
+    pt_data = ps->dataBuffer;
+    for (i = 0; i < ps->idx_data; i++)
+        *y++ = (int32_t)*pt_win++ * (int32_t)*pt_data++;
+#endif
+}
+
 #if ARM_FFT == 0
 void spec2pspec(int32_t *y, int32_t *x, int len) {
     int i;
@@ -53,16 +90,12 @@ void spec2pspec(int32_t *y, int32_t *x, int len) {
 int stftModule_analyze(stftModule *ps, int16_t *x, int32_t *y) {
     int i;
     int32_t tmp;
-    static int32_t fft_in[LEN_FFT_NNSP];
-    for (i = 0; i < (ps->len_win - ps->hop); i++)
-        ps->dataBuffer[i] = ps->dataBuffer[i + ps->hop];
-
-    tmp = ps->len_win - ps->hop;
-    for (i = 0; i < ps->hop; i++)
-        ps->dataBuffer[i + tmp] = x[i];
+    int32_t *fft_in = ps->fft_buf;
+    stftModule_push(ps, x);
 
+    stftModule_window_q30(ps, fft_in);
     for (i = 0; i < ps->len_win; i++) {
-        tmp = ((int32_t)ps->window[i] * (int32_t)ps->dataBuffer[i]);
+        tmp = fft_in[i];
         fft_in[i] = tmp >> 15; // Frac15
     }
 
@@ -111,29 +144,20 @@ int stftModule_analyze_arm(
     int32_t *spec,       // q21
     int16_t fftsize, int16_t *pt_qbit_out) {
     int i;
-    int32_t tmp;
     stftModule *ps = (stftModule *)ps_t;
 
-    for (i = 0; i < (ps->len_win - ps->hop); i++)
-        ps->dataBuffer[i] = ps->dataBuffer[i + ps->hop];
-
-    tmp = ps->len_win - ps->hop;
-    for (i = 0; i < ps->hop; i++)
-        ps->dataBuffer[i + tmp] = fft_in_q16[i];
+    stftModule_push(ps, fft_in_q16);
 
-    for (i = 0; i < ps->len_win; i++) {
-        tmp = (int32_t)ps->window[i] * (int32_t)ps->dataBuffer[i];
-        glob_fft_buf[i] = tmp; // Q30
-    }
+    stftModule_window_q30(ps, ps->fft_buf); // Q30
 
     for (i = 0; i < (ps->len_fft - ps->len_win); i++) {
-        glob_fft_buf[i + ps->len_win] = 0;
+        ps->fft_buf[i + ps->len_win] = 0;
     }
 
     arm_fft_exec(
         &ps->fft_st,
         spec,          // fft_out, Q21
-        glob_fft_buf); // fft_in,  Q30    
+        ps->fft_buf); // fft_in,  Q30    
 
     if (fftsize == 512)
         *pt_qbit_out = 21;
@@ -159,10 +183,10 @@ int stftModule_synthesize_arm(
     arm_rfft_q31(
         &ps->ifft_st,
         spec,          // Q21
-        glob_fft_buf); // Q21
+        ps->fft_buf); // Q21
 
     for (i = 0; i < ps->len_win; i++) {
-        tmp64 = ((int64_t)ps->window[i]) * (int64_t)glob_fft_buf[i];
+        tmp64 = ((int64_t)ps->window[i]) * (int64_t)ps->fft_buf[i];
         tmp64 >>= 21;
         tmp64 = (int64_t)ps->odataBuffer[i] + (int64_t)tmp64;
         tmp64 = MIN(MAX(tmp64, INT32_MIN), INT32_MAX);
@@ -184,7 +208,6 @@ int stftModule_synthesize_arm(
     return 0;
 }
 #elif ARM_OPTIMIZED == 3
-#include "basic_mve.h"
 #include <arm_mve.h>
 void spec2pspec_arm(
     int32_t *pspec, // q15
@@ -218,30 +241,18 @@ int stftModule_analyze_arm(
 
     stftModule *ps = (stftModule *)ps_t;
 
-    move_data_16b(
-        ps->dataBuffer+ps->hop,
-        ps->dataBuffer,
-        ps->len_win - ps->hop);
-
-    move_data_16b(
-        fft_in_q16,
-        ps->dataBuffer+ps->len_win - ps->hop,
-        ps->hop);
+    stftModule_push(ps, fft_in_q16);
 
-    vec16_vec16_mul_32b(
-        glob_fft_buf,
-        (int16_t*) ps->window,
-        ps->dataBuffer,
-        ps->len_win);
+    stftModule_window_q30(ps, ps->fft_buf); // Q30
 
     set_zero_32b(
-        glob_fft_buf+ps->len_win,
+        ps->fft_buf+ps->len_win,
         ps->len_fft - ps->len_win);
 
     arm_fft_exec(
         &ps->fft_st,
         spec,          // fft_out, Q21
-        glob_fft_buf); // fft_in,  Q30
+        ps->fft_buf); // fft_in,  Q30
 
     if (fftsize == 512)
         *pt_qbit_out = 21;
@@ -266,10 +277,10 @@ int stftModule_synthesize_arm(
     arm_rfft_q31(
         &ps->ifft_st,
         spec,          // Q21
-        glob_fft_buf); // Q21
+        ps->fft_buf); // Q21
 
     for (i = 0; i < ps->len_win; i++) {
-        tmp64 = ((int64_t)ps->window[i]) * (int64_t)glob_fft_buf[i];
+        tmp64 = ((int64_t)ps->window[i]) * (int64_t)ps->fft_buf[i];
         tmp64 >>= 21;
         tmp64 = (int64_t)ps->odataBuffer[i] + (int64_t)tmp64;
         tmp64 = MIN(MAX(tmp64, INT32_MIN), INT32_MAX);
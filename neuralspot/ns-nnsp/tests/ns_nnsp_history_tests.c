@@ -0,0 +1,149 @@
+#include "unity/unity.h"
+
+#include "ambiq_stdint.h"
+#include "feature_module.h"
+#include "minmax.h"
+#include "spectrogram_module.h"
+#include <stdint.h>
+#include <string.h>
+
+#define NUM_HOPS 64
+
+extern const int16_t stft_win_coeff_w480_h160[];
+extern const int16_t stft_win_coeff_w240_h80[];
+
+static stftModule stft;
+static FeatureClass feat;
+static int16_t pcm[LEN_STFT_HOP];
+static int16_t ref_data[LEN_FFT_NNSP];
+static int32_t ref_frame[LEN_FFT_NNSP];
+static int32_t frame[LEN_FFT_NNSP];
+static int16_t ref_context[NUM_FEATURE_CONTEXT * MAX_SIZE_FEATURE];
+static int32_t norm_mean[MAX_SIZE_FEATURE];
+static int32_t norm_stdR[MAX_SIZE_FEATURE];
+
+static uint32_t lcg_state;
+static int16_t lcg_rand16() {
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return (int16_t)(lcg_state >> 16);
+}
+
+// The shift-register STFT history as it was implemented before the ring
+static void reference_stft_window(
+    int16_t *x, int16_t len_win, int16_t hop, const int16_t *window, int32_t *y) {
+    int i;
+    for (i = 0; i < (len_win - hop); i++)
+        ref_data[i] = ref_data[i + hop];
+    for (i = 0; i < hop; i++)
+        ref_data[i + len_win - hop] = x[i];
+    for (i = 0; i < len_win; i++)
+        y[i] = (int32_t)window[i] * (int32_t)ref_data[i];
+}
+
+// The shifted normFeatContext as it was implemented before the ring
+static void reference_context_push(FeatureClass *ps) {
+    int i;
+    int64_t tmp;
+    int shift = (ps->num_context - 1) * ps->dim_feat;
+    for (i = 0; i < shift; i++)
+        ref_context[i] = ref_context[i + ps->dim_feat];
+    for (i = 0; i < ps->dim_feat; i++) {
+        tmp = (int64_t)ps->feature[i] - (int64_t)ps->pt_norm_mean[i];
+        tmp = (tmp * ((int64_t)ps->pt_norm_stdR[i])) >> (30 - ps->qbit_output);
+        tmp = MIN(MAX(tmp, (int64_t)MIN_INT16_T), (int64_t)MAX_INT16_T);
+        ref_context[i + shift] = (int16_t)tmp;
+    }
+}
+
+static void run_stft_bitexact(int16_t len_win, int16_t hop, int16_t fftsize, const int16_t *win) {
+    stftModule_construct(&stft, len_win, hop, fftsize, win);
+    stftModule_setDefault(&stft);
+    memset(ref_data, 0, sizeof(ref_data));
+
+    for (int n = 0; n < NUM_HOPS; n++) {
+        for (int i = 0; i < hop; i++) {
+            pcm[i] = lcg_rand16();
+        }
+        reference_stft_window(pcm, len_win, hop, win, ref_frame);
+        stftModule_push(&stft, pcm);
+        stftModule_window_q30(&stft, frame);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(ref_frame, frame, len_win);
+    }
+}
+
+void ns_nnsp_history_tests_pre_test_hook() {
+    lcg_state = 0x1234;
+    for (int i = 0; i < MAX_SIZE_FEATURE; i++) {
+        norm_mean[i] = (int32_t)lcg_rand16() * 16;
+        norm_stdR[i] = (1 << 22) + ((int32_t)lcg_rand16() * 16);
+    }
+}
+
+void ns_nnsp_history_tests_post_test_hook() {}
+
+void ns_nnsp_stft_window_bitexact_w480_h160_test() {
+    run_stft_bitexact(480, 160, 512, stft_win_coeff_w480_h160);
+}
+
+void ns_nnsp_stft_window_bitexact_w240_h80_test() {
+    run_stft_bitexact(240, 80, 256, stft_win_coeff_w240_h80);
+}
+
+// hop does not divide the window, so hops straddle the wrap boundary
+void ns_nnsp_stft_window_bitexact_uneven_hop_test() {
+    run_stft_bitexact(480, 112, 512, stft_win_coeff_w480_h160);
+}
+
+// Each instance keeps its own history: pushing to a second STFT leaves the first untouched
+void ns_nnsp_stft_two_instances_test() {
+    static stftModule other;
+    int16_t other_pcm[LEN_STFT_HOP];
+
+    stftModule_construct(&stft, 480, 160, 512, stft_win_coeff_w480_h160);
+    stftModule_setDefault(&stft);
+    stftModule_construct(&other, 480, 160, 512, stft_win_coeff_w480_h160);
+    stftModule_setDefault(&other);
+    memset(ref_data, 0, sizeof(ref_data));
+
+    for (int n = 0; n < NUM_HOPS; n++) {
+        for (int i = 0; i < 160; i++) {
+            pcm[i] = lcg_rand16();
+            other_pcm[i] = lcg_rand16();
+        }
+        reference_stft_window(pcm, 480, 160, stft_win_coeff_w480_h160, ref_frame);
+        stftModule_push(&stft, pcm);
+        stftModule_push(&other, other_pcm);
+        stftModule_window_q30(&stft, frame);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(ref_frame, frame, 480);
+    }
+}
+
+void ns_nnsp_feature_context_bitexact_test() {
+    FeatureClass_construct(
+        &feat, norm_mean, norm_stdR, 8, NUM_MELBANKS, LEN_STFT_WIN_COEFF, LEN_STFT_HOP,
+        LEN_FFT_NNSP, stft_win_coeff_w480_h160);
+    FeatureClass_setDefault(&feat);
+    memcpy(ref_context, feat.pt_normFeatContext, sizeof(int16_t) * feat.num_context * feat.dim_feat);
+
+    for (int n = 0; n < 4 * NUM_FEATURE_CONTEXT + 3; n++) {
+        for (int i = 0; i < feat.dim_feat; i++) {
+            feat.feature[i] = (int32_t)lcg_rand16() * 8;
+        }
+        reference_context_push(&feat);
+        FeatureClass_pushContext(&feat);
+        TEST_ASSERT_EQUAL_INT16_ARRAY(
+            ref_context, feat.pt_normFeatContext, feat.num_context * feat.dim_feat);
+    }
+}
+
+// After setDefault, the whole window reads as the normalized 'silence' feature
+void ns_nnsp_feature_context_default_test() {
+    FeatureClass_construct(
+        &feat, norm_mean, norm_stdR, 8, NUM_MELBANKS, LEN_STFT_WIN_COEFF, LEN_STFT_HOP,
+        LEN_FFT_NNSP, stft_win_coeff_w480_h160);
+    FeatureClass_setDefault(&feat);
+    for (int j = 1; j < feat.num_context; j++) {
+        TEST_ASSERT_EQUAL_INT16_ARRAY(
+            feat.pt_normFeatContext, feat.pt_normFeatContext + j * feat.dim_feat, feat.dim_feat);
+    }
+}
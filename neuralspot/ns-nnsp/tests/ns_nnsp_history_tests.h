@@ -0,0 +1,10 @@
+#include "spectrogram_module.h"
+#include "feature_module.h"
+void ns_nnsp_history_tests_pre_test_hook();
+void ns_nnsp_history_tests_post_test_hook();
+void ns_nnsp_stft_window_bitexact_w480_h160_test();
+void ns_nnsp_stft_window_bitexact_w240_h80_test();
+void ns_nnsp_stft_window_bitexact_uneven_hop_test();
+void ns_nnsp_stft_two_instances_test();
+void ns_nnsp_feature_context_bitexact_test();
+void ns_nnsp_feature_context_default_test();
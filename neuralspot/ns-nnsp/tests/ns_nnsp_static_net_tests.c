@@ -0,0 +1,159 @@
+#include "unity/unity.h"
+
+#include "activation.h"
+#include "affine.h"
+#include "affine_acc32b.h"
+#include "lstm.h"
+#include "neural_nets.h"
+#include "ns_ambiqsuite_harness.h"
+#include "ns_nnsp_static_net_tests.h"
+#include "ns_timer.h"
+#include <stdint.h>
+#include <string.h>
+
+#define NUM_FRAMES 50
+#define DIM_IN 240
+#define DIM_H 28
+
+// Tables shaped like def_nn1_nnvad.c, filled with random weights
+static int8_t kernel0[DIM_IN * DIM_H];
+static int8_t kernel1[4 * DIM_H * DIM_H];
+static int8_t kernel_rec1[4 * DIM_H * DIM_H];
+static int8_t kernel2[DIM_H * DIM_H];
+static int8_t kernel3[DIM_H * DIM_H];
+static int8_t kernel4[DIM_H * 2];
+static int16_t bias0[DIM_H];
+static int16_t bias1[4 * DIM_H];
+static int16_t bias2[DIM_H];
+static int16_t bias3[DIM_H];
+static int16_t bias4[2];
+static int32_t cstate1[DIM_H];
+static int16_t hstate1[DIM_H];
+static int16_t inputs[NUM_FRAMES * DIM_IN];
+
+static NeuralNetClass net;
+
+static uint32_t lcg_state;
+static int16_t lcg_rand16() {
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return (int16_t)(lcg_state >> 16);
+}
+
+static void fill8(int8_t *x, int len, int shift) {
+    for (int i = 0; i < len; i++) {
+        x[i] = (int8_t)(lcg_rand16() >> shift);
+    }
+}
+
+static void fill16(int16_t *x, int len, int shift) {
+    for (int i = 0; i < len; i++) {
+        x[i] = (int16_t)(lcg_rand16() >> shift);
+    }
+}
+
+static void net_nnvad_shape(int weight_shift, int input_shift) {
+    static const int16_t sizes[] = {DIM_IN, DIM_H, DIM_H, DIM_H, DIM_H, 2};
+    static const NET_LAYER_TYPE types[] = {fc, lstm, fc, fc, fc};
+    static const int8_t qk[] = {7, 5, 5, 5, 7};
+    static const int8_t qi[] = {8, 15, 15, 12, 12};
+    static const int8_t qb[] = {14, 13, 15, 15, 15};
+    static const ACTIVATION_TYPE acts[] = {ftanh, ftanh, relu6, relu6, linear};
+    int8_t *kernels[] = {kernel0, kernel1, kernel2, kernel3, kernel4};
+    int16_t *biases[] = {bias0, bias1, bias2, bias3, bias4};
+
+    memset(&net, 0, sizeof(net));
+    net.numlayers = 5;
+    for (int i = 0; i < 5; i++) {
+        net.size_layer[i] = sizes[i];
+        net.net_layer_type[i] = types[i];
+        net.qbit_kernel[i] = qk[i];
+        net.qbit_input[i] = qi[i];
+        net.qbit_bias[i] = qb[i];
+        net.activation_type[i] = acts[i];
+        net.pt_kernel[i] = kernels[i];
+        net.pt_bias[i] = biases[i];
+        net.layer_func[i] = (types[i] == lstm) ? (int *(*)()) & lstm_8x16 : (int *(*)()) & fc_8x16;
+    }
+    net.size_layer[5] = sizes[5];
+    net.act_func[0] = (void *(*)(void *, int32_t *, int)) & tanh_fix;
+    net.act_func[1] = (void *(*)(void *, int32_t *, int)) & tanh_fix;
+    net.act_func[2] = (void *(*)(void *, int32_t *, int)) & relu6_fix;
+    net.act_func[3] = (void *(*)(void *, int32_t *, int)) & relu6_fix;
+    net.act_func[4] = (void *(*)(void *, int32_t *, int)) & linear_fix;
+    net.pt_kernel_rec[1] = kernel_rec1;
+    net.pt_cstate[1] = cstate1;
+    net.pt_hstate[1] = hstate1;
+
+    fill8(kernel0, sizeof(kernel0), weight_shift);
+    fill8(kernel1, sizeof(kernel1), weight_shift);
+    fill8(kernel_rec1, sizeof(kernel_rec1), weight_shift);
+    fill8(kernel2, sizeof(kernel2), weight_shift);
+    fill8(kernel3, sizeof(kernel3), weight_shift);
+    fill8(kernel4, sizeof(kernel4), weight_shift);
+    fill16(bias0, DIM_H, 2);
+    fill16(bias1, 4 * DIM_H, 2);
+    fill16(bias2, DIM_H, 2);
+    fill16(bias3, DIM_H, 2);
+    fill16(bias4, 2, 2);
+    fill16(inputs, NUM_FRAMES * DIM_IN, input_shift);
+}
+
+static ns_timer_config_t bench_timer = {
+    .api = &ns_timer_V1_0_0, .timer = NS_TIMER_COUNTER, .enableInterrupt = false};
+
+static uint32_t bench_counter(void) { return ns_us_ticker_read(&bench_timer); }
+
+void ns_nnsp_static_net_tests_pre_test_hook() {
+    lcg_state = 0x5eed;
+    ns_timer_init(&bench_timer);
+}
+
+void ns_nnsp_static_net_tests_post_test_hook() {}
+
+// Same outputs as NeuralNetClass_exe, frame after frame (LSTM state carried over)
+void ns_nnsp_static_net_bitexact_test() {
+    NeuralNetBenchResult r;
+
+    net_nnvad_shape(10, 4);
+    TEST_ASSERT_EQUAL(
+        0, NeuralNetClass_benchmark_nnvad(&net, inputs, NUM_FRAMES, bench_counter, &r));
+    TEST_ASSERT_EQUAL(NUM_FRAMES, r.frames);
+    TEST_ASSERT_EQUAL(0, r.mismatches);
+    ns_lp_printf(
+        "nnvad %d frames: runtime dispatcher %d, compile-time specialized %d (us)\n",
+        r.frames, r.runtimeCycles, r.staticCycles);
+}
+
+// Full-range weights and inputs, so accumulators, gates and states saturate
+void ns_nnsp_static_net_saturation_test() {
+    NeuralNetBenchResult r;
+
+    net_nnvad_shape(8, 0);
+    TEST_ASSERT_EQUAL(
+        0, NeuralNetClass_benchmark_nnvad(&net, inputs, NUM_FRAMES, bench_counter, &r));
+    TEST_ASSERT_EQUAL(0, r.mismatches);
+}
+
+void ns_nnsp_static_net_descriptor_mismatch_test() {
+    NeuralNetBenchResult r;
+
+    net_nnvad_shape(10, 4);
+    net.qbit_input[3] = 13;
+    TEST_ASSERT_EQUAL(-1, NeuralNetClass_benchmark_nnvad(&net, inputs, 1, bench_counter, &r));
+
+    net_nnvad_shape(10, 4);
+    net.size_layer[2] = 32;
+    TEST_ASSERT_EQUAL(-1, NeuralNetClass_benchmark_nnvad(&net, inputs, 1, bench_counter, &r));
+
+    net_nnvad_shape(10, 4);
+    net.layer_func[2] = (int *(*)()) & fc_8x16_acc32b; // different arithmetic
+    TEST_ASSERT_EQUAL(-1, NeuralNetClass_benchmark_nnvad(&net, inputs, 1, bench_counter, &r));
+
+    net_nnvad_shape(10, 4);
+    net.act_func[3] = (void *(*)(void *, int32_t *, int)) & tanh_fix;
+    TEST_ASSERT_EQUAL(-1, NeuralNetClass_benchmark_nnvad(&net, inputs, 1, bench_counter, &r));
+
+    net_nnvad_shape(10, 4);
+    net.numlayers = 4;
+    TEST_ASSERT_EQUAL(-1, NeuralNetClass_benchmark_nnvad(&net, inputs, 1, bench_counter, &r));
+}
@@ -0,0 +1,33 @@
+#include "neural_nets.h"
+#include <stdint.h>
+
+typedef struct {
+    int32_t frames;
+    uint32_t runtimeCycles; // NeuralNetClass_exe, in units of the counter
+    uint32_t staticCycles;  // nnsp::Net::exe
+    int32_t mismatches;     // Output values that differ between the two
+} NeuralNetBenchResult;
+
+typedef uint32_t (*NeuralNetBenchCounter)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+    Runs frames inputs (size_layer[0] each) through net with NeuralNetClass_exe and with its
+    compile-time specialization for the nnid VAD topology (def_nn1_nnvad.c), comparing outputs.
+    LSTM states of net are reset first. In ns_nnsp_static_net_tests_nnvad.cc.
+    Returns 0, or -1 if net does not have that topology.
+*/
+int NeuralNetClass_benchmark_nnvad(
+    NeuralNetClass *pt_inst, const int16_t *inputs, int frames, NeuralNetBenchCounter counter,
+    NeuralNetBenchResult *result);
+#ifdef __cplusplus
+}
+#endif
+
+void ns_nnsp_static_net_tests_pre_test_hook();
+void ns_nnsp_static_net_tests_post_test_hook();
+void ns_nnsp_static_net_bitexact_test();
+void ns_nnsp_static_net_saturation_test();
+void ns_nnsp_static_net_descriptor_mismatch_test();
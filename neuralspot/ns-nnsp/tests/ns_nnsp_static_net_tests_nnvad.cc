@@ -0,0 +1,53 @@
+// The nnvad benchmark behind ns_nnsp_static_net_tests.c. Kept out of the library: autotest
+// builds it next to the test.
+#include <stdint.h>
+#include "neural_nets_static.h"
+#include "ns_nnsp_static_net_tests.h"
+
+// Topology of net_nnvad (def_nn1_nnvad.c, nnid demo)
+typedef nnsp::Net<
+    nnsp::Fc<240, 28, 7, 8, 14, ftanh>, nnsp::Lstm<28, 28, 5, 15, 13>,
+    nnsp::Fc<28, 28, 5, 15, 15, relu6>, nnsp::Fc<28, 28, 5, 12, 15, relu6>,
+    nnsp::Fc<28, 2, 7, 12, 15, linear>>
+    NnvadNet;
+
+static NnvadNet nnvad_static;
+
+int NeuralNetClass_benchmark_nnvad(
+    NeuralNetClass *pt_inst, const int16_t *inputs, int frames, NeuralNetBenchCounter counter,
+    NeuralNetBenchResult *result) {
+    int16_t input[NnvadNet::DimIn];
+    int32_t out_runtime[NnvadNet::DimOut];
+    int32_t out_static[NnvadNet::DimOut];
+    uint32_t start;
+    int i, j;
+
+    if (!nnvad_static.bind(pt_inst)) {
+        return -1;
+    }
+    NeuralNetClass_setDefault(pt_inst);
+
+    result->frames = frames;
+    result->runtimeCycles = 0;
+    result->staticCycles = 0;
+    result->mismatches = 0;
+    for (i = 0; i < frames; i++) {
+        // NeuralNetClass_exe takes a non-const input
+        for (j = 0; j < NnvadNet::DimIn; j++) {
+            input[j] = inputs[i * NnvadNet::DimIn + j];
+        }
+
+        start = counter();
+        NeuralNetClass_exe(pt_inst, input, out_runtime, -1);
+        result->runtimeCycles += counter() - start;
+
+        start = counter();
+        nnvad_static.exe(input, out_static);
+        result->staticCycles += counter() - start;
+
+        for (j = 0; j < NnvadNet::DimOut; j++) {
+            result->mismatches += (out_runtime[j] != out_static[j]);
+        }
+    }
+    return 0;
+}
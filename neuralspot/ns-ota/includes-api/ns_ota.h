@@ -0,0 +1,371 @@
+/**
+ * @file ns_ota.h
+ * @author Ambiq
+ * @brief Resumable, pipelined image (model) transfer into A/B slots
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * An image is sent as fixed size chunks, each carrying its byte offset and a CRC32. The
+ * receiver (ns_ota_t) writes every valid chunk straight into the inactive slot through a
+ * storage port, in any order, and tracks it in a chunk bitmap. The bitmap is saved to
+ * persistent storage every few chunks, so after a reset the receiver picks up where it left
+ * off and the sender only resends what is missing.
+ *
+ * Acknowledgements are cumulative plus selective: an ACK carries the first missing chunk
+ * (base) and a bitmap of the 32 chunks after it, so the sender (ns_ota_sender_t) keeps a window
+ * of chunks in flight and resends only the ones that were lost.
+ *
+ * Once every chunk is in, the receiver hashes the slot (SHA-256, read back from storage) and,
+ * if it matches the hash announced at the start, switches the active slot by writing a new
+ * boot record. There are two boot record copies, written alternately with an increasing
+ * generation and each covered by a CRC, so a reset at any point leaves either the old or the
+ * new image active, never a partial one.
+ *
+ * A START flagged NS_OTA_START_DELTA announces a patch against the active image instead of an
+ * image (see ns_ota_delta.h): the chunks are the patch, applied in order as they arrive, and
+ * the hash is that of the rebuilt image.
+ *
+ * Messages are little-endian and transport agnostic: the caller moves them over USB, UART, BLE
+ * or eRPC and hands received ones to ns_ota_receive() or ns_ota_sender_on_message().
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-ota
+ *  @{
+ */
+
+#ifndef NS_OTA_H
+    #define NS_OTA_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include "ns_ota_sha256.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_OTA_V0_0_1                                                                          \
+        { .major = 0, .minor = 0, .revision = 1 }
+    #define NS_OTA_OLDEST_SUPPORTED_VERSION NS_OTA_V0_0_1
+    #define NS_OTA_CURRENT_VERSION NS_OTA_V0_0_1
+    #define NS_OTA_API_ID 0xCA0014
+
+extern const ns_core_api_t ns_ota_V0_0_1;
+extern const ns_core_api_t ns_ota_oldest_supported_version;
+extern const ns_core_api_t ns_ota_current_version;
+
+    #ifndef NS_OTA_MAX_CHUNKS
+        #define NS_OTA_MAX_CHUNKS 2048 ///< Chunks per image (size of the resume bitmap)
+    #endif
+    #define NS_OTA_WINDOW_MAX 32 ///< Chunks in flight, limited by the ACK bitmap
+
+/// Message types (first byte of every message)
+typedef enum {
+    NS_OTA_MSG_START = 1, ///< Sender -> receiver, announces (or resumes) a transfer
+    NS_OTA_MSG_DATA = 2,  ///< Sender -> receiver, one chunk
+    NS_OTA_MSG_ACK = 3    ///< Receiver -> sender
+} ns_ota_msg_e;
+
+/// ACK status
+typedef enum {
+    NS_OTA_ACK_OK = 0,            ///< Transfer in progress
+    NS_OTA_ACK_COMPLETE = 1,      ///< Image verified and active
+    NS_OTA_ACK_HASH_MISMATCH = 2, ///< All chunks received but the hash differs, transfer dropped
+    NS_OTA_ACK_REJECTED = 3,      ///< START refused (image too large, bad chunk size)
+    NS_OTA_ACK_UNKNOWN = 4,       ///< DATA for a transfer the receiver does not know, send START
+    NS_OTA_ACK_STORAGE_ERROR = 5, ///< Storage port failed, transfer dropped
+    NS_OTA_ACK_PATCH_ERROR = 6    ///< Delta patch malformed or for another image, transfer dropped
+} ns_ota_ack_status_e;
+
+/// START flags
+    #define NS_OTA_START_DELTA 0x01 ///< The chunks are a patch against the active image
+
+typedef struct __attribute__((packed)) {
+    uint8_t type; ///< NS_OTA_MSG_START
+    uint8_t flags; ///< NS_OTA_START_*
+    uint16_t chunkSize; ///< Bytes per chunk, the last one may be shorter
+    uint32_t transferId; ///< Chosen by the sender, the same id and hash resume a transfer
+    uint32_t imageSize; ///< Bytes sent (the patch size for a delta)
+    uint8_t hash[NS_OTA_HASH_SIZE]; ///< SHA-256 of the image (the rebuilt one for a delta)
+} ns_ota_start_t;
+
+/// Followed by length bytes of image data
+typedef struct __attribute__((packed)) {
+    uint8_t type; ///< NS_OTA_MSG_DATA
+    uint8_t reserved;
+    uint16_t length;
+    uint32_t transferId;
+    uint32_t offset; ///< Byte offset in the image, a multiple of chunkSize
+    uint32_t crc32;  ///< CRC-32 of the data, ns_crc32()
+} ns_ota_data_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;   ///< NS_OTA_MSG_ACK
+    uint8_t status; ///< ns_ota_ack_status_e
+    uint16_t reserved;
+    uint32_t transferId;
+    uint32_t base;     ///< First chunk not received yet (numChunks when all are in)
+    uint32_t sack;     ///< Bit i set: chunk base + 1 + i received
+    uint32_t received; ///< Chunks received
+} ns_ota_ack_t;
+
+/// Storage regions behind the port
+typedef enum {
+    NS_OTA_REGION_SLOT_A = 0,
+    NS_OTA_REGION_SLOT_B = 1,
+    NS_OTA_REGION_PROGRESS = 2, ///< Resume record, sizeof(ns_ota_progress_t)
+    NS_OTA_REGION_BOOT0 = 3,    ///< Boot record copies, sizeof(ns_ota_boot_t) each
+    NS_OTA_REGION_BOOT1 = 4,
+    NS_OTA_REGION_COUNT
+} ns_ota_region_e;
+
+/// Persistent storage for the slots and records, e.g. MRAM, external flash or RAM. A region
+/// that was never written may read as anything, the records are validated with a CRC.
+typedef struct {
+    uint32_t (*read)(void *ctx, ns_ota_region_e region, uint32_t offset, void *buf, uint32_t len);
+    uint32_t (*write)(
+        void *ctx, ns_ota_region_e region, uint32_t offset, const void *buf, uint32_t len);
+    /// Optional, called before a slot is written from scratch (flash that needs erasing)
+    uint32_t (*erase)(void *ctx, ns_ota_region_e region, uint32_t len);
+    uint32_t slotSize; ///< Bytes per slot
+    void *ctx;
+} ns_ota_storage_t;
+
+/// Outgoing messages, returns NS_STATUS_SUCCESS once the message is queued or sent
+typedef struct {
+    uint32_t (*send)(void *ctx, const uint8_t *msg, uint32_t len);
+    void *ctx;
+} ns_ota_link_t;
+
+/// Resume record (NS_OTA_REGION_PROGRESS)
+typedef struct {
+    uint32_t magic;
+    uint32_t transferId;
+    uint32_t imageSize;
+    uint16_t chunkSize;
+    uint8_t slot; ///< Slot being written
+    uint8_t flags; ///< From START
+    uint32_t received;
+    uint8_t hash[NS_OTA_HASH_SIZE];
+    uint32_t bitmap[NS_OTA_MAX_CHUNKS / 32];
+    uint32_t crc; ///< Of everything above
+} ns_ota_progress_t;
+
+/// Boot record (NS_OTA_REGION_BOOT0/1)
+typedef struct {
+    uint32_t magic;
+    uint32_t generation; ///< The valid copy with the highest generation wins
+    uint32_t slot;
+    uint32_t imageSize;
+    uint8_t hash[NS_OTA_HASH_SIZE];
+    uint32_t crc; ///< Of everything above
+} ns_ota_boot_t;
+
+/// The active image, see ns_ota_get_active()
+typedef struct {
+    ns_ota_region_e slot;
+    uint32_t size;
+    uint32_t generation;
+    uint8_t hash[NS_OTA_HASH_SIZE];
+} ns_ota_image_t;
+
+typedef struct {
+    uint32_t chunks;     ///< New chunks written
+    uint32_t duplicates; ///< Chunks received again
+    uint32_t crcErrors;
+    uint32_t badChunks;  ///< Wrong transfer, offset or length
+    uint32_t acks;
+    uint32_t saves;      ///< Progress records written
+    uint32_t resumes;    ///< Transfers picked up from a progress record
+    uint32_t outOfOrder; ///< Delta chunks dropped because an earlier one is missing
+} ns_ota_stats_t;
+
+struct ns_ota_delta;
+
+typedef struct {
+    const ns_core_api_t *api;
+    const ns_ota_storage_t *storage;
+    ns_ota_link_t link;      ///< ACKs go out here
+    uint16_t ackEvery;       ///< ACK after this many in-order chunks (1 to ACK each one)
+    uint16_t persistEvery;   ///< Save the progress record after this many new chunks
+    struct ns_ota_delta *delta; ///< Patch applier state, NULL to refuse delta transfers
+
+    // Internal state
+    bool hasActive;
+    ns_ota_boot_t boot;      ///< Current boot record
+    bool receiving;
+    ns_ota_progress_t progress;
+    uint32_t numChunks;
+    uint32_t base;           ///< First missing chunk
+    uint32_t highest;        ///< One past the highest chunk received
+    uint32_t sinceAck;
+    uint32_t sinceSave;
+    uint32_t lastTransferId; ///< Last finished transfer, its repeats are answered again
+    uint8_t lastStatus;
+    ns_ota_stats_t stats;
+} ns_ota_t;
+
+/**
+ * @brief Load the boot records and pick up an interrupted transfer, if any
+ *
+ * @param o Receiver
+ * @return uint32_t status
+ */
+extern uint32_t ns_ota_init(ns_ota_t *o);
+
+/**
+ * @brief Handle a message from the sender, sending an ACK on the link when one is due
+ *
+ * Malformed messages and chunks with a bad CRC are dropped (the sender resends them). A patch
+ * is applied strictly in order, so during a delta transfer chunks past the first missing one
+ * are dropped too and the sender goes back to it. Delta transfers are not resumed after a
+ * reset; the sender starts over.
+ *
+ * @param o Receiver
+ * @param msg Message
+ * @param len Message length
+ * @return uint32_t NS_STATUS_SUCCESS, or the storage port error that dropped the transfer
+ */
+extern uint32_t ns_ota_receive(ns_ota_t *o, const uint8_t *msg, uint32_t len);
+
+/**
+ * @brief Get the active image
+ *
+ * @param o Receiver
+ * @param image Filled with the active image
+ * @return true if there is one
+ */
+extern bool ns_ota_get_active(const ns_ota_t *o, ns_ota_image_t *image);
+
+/**
+ * @brief Forget the interrupted transfer, if any, so the next START begins from scratch
+ *
+ * @param o Receiver
+ * @return uint32_t status
+ */
+extern uint32_t ns_ota_abort(ns_ota_t *o);
+
+typedef enum {
+    NS_OTA_SENDER_STARTING = 0, ///< Waiting for the first ACK
+    NS_OTA_SENDER_SENDING,
+    NS_OTA_SENDER_DONE,         ///< Image verified and active on the receiver
+    NS_OTA_SENDER_FAILED        ///< Receiver rejected the image, see lastStatus
+} ns_ota_sender_state_e;
+
+typedef struct {
+    uint32_t chunks;      ///< DATA messages sent
+    uint32_t retransmits; ///< Of which resends
+    uint32_t timeouts;    ///< Resends because no ACK came in time
+    uint32_t acks;
+} ns_ota_sender_stats_t;
+
+typedef struct {
+    const ns_core_api_t *api;
+    const uint8_t *image;
+    uint32_t imageSize;
+    uint16_t chunkSize;
+    uint32_t transferId;
+    uint8_t window;    ///< Chunks in flight, 1 (stop-and-wait) to NS_OTA_WINDOW_MAX
+    uint32_t timeout;  ///< Resend a chunk (or START) not acknowledged after this long
+    ns_ota_link_t link;
+    uint8_t *txBuf;    ///< sizeof(ns_ota_data_t) + chunkSize bytes
+    const uint8_t *hash; ///< SHA-256 of the image, NULL to compute it (or take it from a patch)
+    uint8_t flags;     ///< NS_OTA_START_*, NS_OTA_START_DELTA when image is a patch
+
+    // Internal state
+    ns_ota_sender_state_e state;
+    uint8_t lastStatus;
+    uint8_t digest[NS_OTA_HASH_SIZE];
+    uint32_t numChunks;
+    uint32_t base;  ///< First chunk not acknowledged
+    uint32_t acked; ///< Bit i: chunk base + i acknowledged
+    uint32_t next;  ///< Next chunk never sent
+    uint32_t txSeq; ///< DATA messages sent so far
+    uint32_t ackedSeq; ///< Highest txSeq known to have arrived
+    uint32_t sentSeq[NS_OTA_WINDOW_MAX]; ///< txSeq of the last send of each chunk in flight
+    uint32_t sentAt[NS_OTA_WINDOW_MAX];
+    uint32_t startAt;
+    ns_ota_sender_stats_t stats;
+} ns_ota_sender_t;
+
+/**
+ * @brief Validate the configuration and send START
+ *
+ * @param s Sender
+ * @param now Current time, in the units of timeout
+ * @return uint32_t status
+ */
+extern uint32_t ns_ota_sender_init(ns_ota_sender_t *s, uint32_t now);
+
+/**
+ * @brief Handle a message from the receiver
+ *
+ * @param s Sender
+ * @param msg Message
+ * @param len Message length
+ * @param now Current time
+ */
+extern void ns_ota_sender_on_message(
+    ns_ota_sender_t *s, const uint8_t *msg, uint32_t len, uint32_t now);
+
+/**
+ * @brief Send what the window allows: lost chunks first, then new ones
+ *
+ * Call whenever the link can take more messages. A chunk counts as lost when a chunk sent
+ * after it was acknowledged (the link is expected to keep messages in order) or when it has
+ * not been acknowledged within timeout. An ACK that goes backwards means the receiver
+ * reset, sending resumes from its base. Stops at the first send the link refuses.
+ *
+ * @param s Sender
+ * @param now Current time
+ * @return ns_ota_sender_state_e state
+ */
+extern ns_ota_sender_state_e ns_ota_sender_poll(ns_ota_sender_t *s, uint32_t now);
+
+/**
+ * @brief Storage port over plain memory (RAM, or MRAM for reads), regions at fixed addresses
+ *
+ * Writes are memcpy, so this suits RAM slots (or tests); see ns_ota_mram_storage_init() for
+ * MRAM.
+ */
+typedef struct {
+    uint8_t *region[NS_OTA_REGION_COUNT];
+    uint32_t regionSize[NS_OTA_REGION_COUNT];
+} ns_ota_mem_storage_t;
+
+/**
+ * @brief Fill a storage port for an ns_ota_mem_storage_t
+ *
+ * @param port Port to fill
+ * @param mem Region addresses and sizes, slotSize is the smaller slot
+ */
+extern void ns_ota_mem_storage_init(ns_ota_storage_t *port, ns_ota_mem_storage_t *mem);
+
+/**
+ * @brief Fill a storage port that programs MRAM (Apollo4 and Apollo5)
+ *
+ * Regions must be word aligned and reserved for OTA in the linker script. Reads go straight to
+ * the memory mapped MRAM.
+ *
+ * @param port Port to fill
+ * @param mem Region addresses and sizes
+ */
+extern void ns_ota_mram_storage_init(ns_ota_storage_t *port, ns_ota_mem_storage_t *mem);
+
+/**
+ * @brief Address of a region of a memory backed port, e.g. to run the active image in place
+ *
+ * @param mem Memory storage
+ * @param region Region
+ * @return const uint8_t* Start of the region
+ */
+extern const uint8_t *ns_ota_mem_storage_addr(const ns_ota_mem_storage_t *mem,
+                                              ns_ota_region_e region);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @} */
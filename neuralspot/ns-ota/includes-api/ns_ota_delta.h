@@ -0,0 +1,137 @@
+/**
+ * @file ns_ota_delta.h
+ * @author Ambiq
+ * @brief Streaming delta (binary patch) applier for OTA images
+ * @version 0.1
+ * @date 2025-08-12
+ *
+ * A retrained model usually differs from the deployed one in a small part of its weights, so
+ * sending a patch against the running image is much cheaper than sending the image.
+ * tools/ns_ota_delta.py builds the patch; this applier rebuilds the new image from the active
+ * slot and the patch, writing it into the inactive slot in order, as the patch streams in.
+ * Memory use is constant (one NS_OTA_DELTA_BLOCK staging block), whatever the image size.
+ *
+ * Patch layout (little-endian): an ns_ota_delta_header_t, then ops until targetSize bytes are
+ * produced. Each op starts with a byte holding the op in its top two bits and the length in
+ * the low six; a length field of 0 means a LEB128 length follows.
+ *
+ * - INSERT (0x00): length bytes of new data follow
+ * - COPY (0x40): a zigzag LEB128 source offset follows, relative to the expected position
+ *   (end of the previous COPY, advanced by the bytes inserted since). A changed weight is
+ *   thus an INSERT of the new bytes followed by a COPY at relative offset 0.
+ *
+ * The output is hashed as it is written and checked against the target hash at the end;
+ * the patch is refused up front if it was made for a different source image.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-ota
+ *  @{
+ */
+
+#ifndef NS_OTA_DELTA_H
+    #define NS_OTA_DELTA_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_ota.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_OTA_DELTA_MAGIC 0x5044534E // 'NSDP'
+    #define NS_OTA_DELTA_VERSION 1
+    #define NS_OTA_DELTA_OP_INSERT 0x00
+    #define NS_OTA_DELTA_OP_COPY 0x40
+    #define NS_OTA_DELTA_OP_MASK 0xC0
+    #define NS_OTA_DELTA_LEN_MASK 0x3F
+
+    #ifndef NS_OTA_DELTA_BLOCK
+        #define NS_OTA_DELTA_BLOCK 256 ///< Output staging, bytes per storage write
+    #endif
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic; ///< NS_OTA_DELTA_MAGIC
+    uint16_t version;
+    uint16_t headerSize; ///< Bytes before the first op
+    uint32_t sourceSize;
+    uint32_t targetSize;
+    uint8_t sourceHash[NS_OTA_HASH_SIZE]; ///< SHA-256 of the image the patch applies to
+    uint8_t targetHash[NS_OTA_HASH_SIZE]; ///< SHA-256 of the rebuilt image
+} ns_ota_delta_header_t;
+
+typedef enum {
+    NS_OTA_DELTA_OK = 0,
+    NS_OTA_DELTA_ERR_HEADER,  ///< Not a patch, or an unsupported version
+    NS_OTA_DELTA_ERR_SOURCE,  ///< Made for another source image
+    NS_OTA_DELTA_ERR_OP,      ///< Malformed op
+    NS_OTA_DELTA_ERR_RANGE,   ///< Op reads past the source or writes past the target
+    NS_OTA_DELTA_ERR_STORAGE, ///< Storage port failed
+    NS_OTA_DELTA_ERR_LENGTH,  ///< Patch ended early or has trailing bytes
+    NS_OTA_DELTA_ERR_HASH     ///< Rebuilt image does not match the target hash
+} ns_ota_delta_error_e;
+
+typedef struct ns_ota_delta {
+    const ns_ota_storage_t *storage;
+    ns_ota_region_e source; ///< Slot holding the current image
+    ns_ota_region_e target; ///< Slot receiving the new image
+    uint32_t sourceSize;
+    uint8_t sourceHash[NS_OTA_HASH_SIZE];
+
+    // Parser state
+    ns_ota_delta_header_t header;
+    uint32_t headerUsed;
+    uint8_t state;
+    uint8_t op;
+    uint8_t shift;     ///< LEB128 bits gathered so far
+    uint32_t value;    ///< LEB128 being gathered
+    uint32_t len;      ///< Bytes left in the current op
+    uint32_t expected; ///< Source position COPY offsets are relative to
+    uint32_t outPos;   ///< Bytes of output produced
+    uint32_t blockUsed;
+    uint8_t block[NS_OTA_DELTA_BLOCK];
+    ns_ota_sha256_t sha;
+    ns_ota_delta_error_e error;
+    uint32_t copied;   ///< Bytes produced by COPY
+    uint32_t inserted; ///< Bytes produced by INSERT
+} ns_ota_delta_t;
+
+/**
+ * @brief Start applying a patch
+ *
+ * @param d Applier
+ * @param storage Storage port
+ * @param source Slot holding the current image
+ * @param sourceSize Size of the current image
+ * @param sourceHash SHA-256 of the current image (e.g. from its boot record)
+ * @param target Slot receiving the new image
+ * @return uint32_t status
+ */
+extern uint32_t ns_ota_delta_begin(
+    ns_ota_delta_t *d, const ns_ota_storage_t *storage, ns_ota_region_e source,
+    uint32_t sourceSize, const uint8_t sourceHash[NS_OTA_HASH_SIZE], ns_ota_region_e target);
+
+/**
+ * @brief Apply the next bytes of the patch, split anywhere
+ *
+ * @param d Applier
+ * @param patch Patch bytes
+ * @param len Number of bytes
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE with d->error set (sticky)
+ */
+extern uint32_t ns_ota_delta_write(ns_ota_delta_t *d, const uint8_t *patch, uint32_t len);
+
+/**
+ * @brief Check that the whole patch was applied and the result matches the target hash
+ *
+ * @param d Applier
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE with d->error set
+ */
+extern uint32_t ns_ota_delta_finish(ns_ota_delta_t *d);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif
+/** @} */
@@ -0,0 +1,43 @@
+/**
+ * @file ns_ota_sha256.h
+ * @author Ambiq
+ * @brief SHA-256, used to verify OTA images
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *  \addtogroup ns-ota
+ *  @{
+ */
+
+#ifndef NS_OTA_SHA256_H
+#define NS_OTA_SHA256_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define NS_OTA_HASH_SIZE 32
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t length; ///< Bytes hashed so far
+    uint8_t block[64];
+    uint32_t used; ///< Bytes in block
+} ns_ota_sha256_t;
+
+extern void ns_ota_sha256_init(ns_ota_sha256_t *h);
+extern void ns_ota_sha256_update(ns_ota_sha256_t *h, const uint8_t *data, uint32_t len);
+extern void ns_ota_sha256_final(ns_ota_sha256_t *h, uint8_t digest[NS_OTA_HASH_SIZE]);
+
+/// One-shot hash of a buffer
+extern void ns_ota_sha256(const uint8_t *data, uint32_t len, uint8_t digest[NS_OTA_HASH_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+/** @} */
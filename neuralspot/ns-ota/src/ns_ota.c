@@ -0,0 +1,435 @@
+/**
+ * @file ns_ota.c
+ * @author Ambiq
+ * @brief OTA receiver: chunks into the inactive slot, resume bitmap, verified A/B switch
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_ota.h"
+#include "ns_core.h"
+#include "ns_crc32.h"
+#include "ns_ota_delta.h"
+#include <stddef.h>
+#include <string.h>
+
+const ns_core_api_t ns_ota_V0_0_1 = {.apiId = NS_OTA_API_ID, .version = NS_OTA_V0_0_1};
+
+const ns_core_api_t ns_ota_oldest_supported_version = {
+    .apiId = NS_OTA_API_ID, .version = NS_OTA_V0_0_1};
+
+const ns_core_api_t ns_ota_current_version = {.apiId = NS_OTA_API_ID, .version = NS_OTA_V0_0_1};
+
+#define NS_OTA_PROGRESS_MAGIC 0x4F544150 // 'OTAP'
+#define NS_OTA_BOOT_MAGIC 0x4F544142     // 'OTAB'
+#define NS_OTA_VERIFY_BLOCK 256          // Bytes read back per step when hashing a slot
+
+static bool ns_ota_test_bit(const uint32_t *bitmap, uint32_t chunk) {
+    return (bitmap[chunk >> 5] >> (chunk & 31)) & 1;
+}
+
+static uint32_t ns_ota_num_chunks(uint32_t imageSize, uint32_t chunkSize) {
+    return (imageSize + chunkSize - 1) / chunkSize;
+}
+
+static uint32_t ns_ota_save_progress(ns_ota_t *o) {
+    o->progress.crc = ns_crc32(&o->progress, offsetof(ns_ota_progress_t, crc));
+    o->sinceSave = 0;
+    o->stats.saves++;
+    return o->storage->write(
+        o->storage->ctx, NS_OTA_REGION_PROGRESS, 0, &o->progress, sizeof(o->progress));
+}
+
+static uint32_t ns_ota_clear_progress(ns_ota_t *o) {
+    uint32_t magic = 0;
+    o->receiving = false;
+    return o->storage->write(o->storage->ctx, NS_OTA_REGION_PROGRESS, 0, &magic, sizeof(magic));
+}
+
+// Recompute base and highest from the bitmap (after a resume)
+static void ns_ota_scan(ns_ota_t *o) {
+    uint32_t i;
+    o->base = o->numChunks;
+    o->highest = 0;
+    for (i = 0; i < o->numChunks; i++) {
+        if (ns_ota_test_bit(o->progress.bitmap, i)) {
+            o->highest = i + 1;
+        } else if (o->base == o->numChunks) {
+            o->base = i;
+        }
+    }
+}
+
+static ns_ota_region_e ns_ota_inactive_slot(const ns_ota_t *o) {
+    if (o->hasActive && (o->boot.slot == NS_OTA_REGION_SLOT_A)) {
+        return NS_OTA_REGION_SLOT_B;
+    }
+    return NS_OTA_REGION_SLOT_A;
+}
+
+static bool ns_ota_load_boot(ns_ota_t *o, ns_ota_region_e region, ns_ota_boot_t *boot) {
+    if (o->storage->read(o->storage->ctx, region, 0, boot, sizeof(*boot)) != NS_STATUS_SUCCESS) {
+        return false;
+    }
+    return (boot->magic == NS_OTA_BOOT_MAGIC) &&
+           (boot->crc == ns_crc32(boot, offsetof(ns_ota_boot_t, crc))) &&
+           ((boot->slot == NS_OTA_REGION_SLOT_A) || (boot->slot == NS_OTA_REGION_SLOT_B)) &&
+           (boot->imageSize <= o->storage->slotSize);
+}
+
+static bool ns_ota_load_progress(ns_ota_t *o) {
+    ns_ota_progress_t *p = &o->progress;
+    if (o->storage->read(o->storage->ctx, NS_OTA_REGION_PROGRESS, 0, p, sizeof(*p)) !=
+        NS_STATUS_SUCCESS) {
+        return false;
+    }
+    if ((p->magic != NS_OTA_PROGRESS_MAGIC) ||
+        (p->crc != ns_crc32(p, offsetof(ns_ota_progress_t, crc)))) {
+        return false;
+    }
+    // A record for the slot that is now active belongs to a transfer that already switched
+    return (p->slot == ns_ota_inactive_slot(o)) && (p->chunkSize != 0) && (p->imageSize != 0) &&
+           (p->imageSize <= o->storage->slotSize) &&
+           (ns_ota_num_chunks(p->imageSize, p->chunkSize) <= NS_OTA_MAX_CHUNKS);
+}
+
+uint32_t ns_ota_init(ns_ota_t *o) {
+    ns_ota_boot_t boot[2];
+    bool valid[2];
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if (o == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(o->api, &ns_ota_oldest_supported_version, &ns_ota_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((o->storage == NULL) || (o->storage->read == NULL) || (o->storage->write == NULL) ||
+        (o->storage->slotSize == 0) || (o->link.send == NULL) || (o->ackEvery == 0) ||
+        (o->ackEvery > NS_OTA_WINDOW_MAX) || (o->persistEvery == 0)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    memset(&o->stats, 0, sizeof(o->stats));
+    o->sinceAck = 0;
+    o->sinceSave = 0;
+    o->lastTransferId = 0;
+    o->lastStatus = NS_OTA_ACK_UNKNOWN;
+
+    valid[0] = ns_ota_load_boot(o, NS_OTA_REGION_BOOT0, &boot[0]);
+    valid[1] = ns_ota_load_boot(o, NS_OTA_REGION_BOOT1, &boot[1]);
+    o->hasActive = valid[0] || valid[1];
+    if (valid[0] && (!valid[1] || (boot[0].generation > boot[1].generation))) {
+        o->boot = boot[0];
+    } else if (valid[1]) {
+        o->boot = boot[1];
+    } else {
+        memset(&o->boot, 0, sizeof(o->boot));
+    }
+
+    o->receiving = ns_ota_load_progress(o);
+    if (o->receiving) {
+        o->numChunks = ns_ota_num_chunks(o->progress.imageSize, o->progress.chunkSize);
+        ns_ota_scan(o);
+        o->stats.resumes++;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_ota_send_ack(ns_ota_t *o, uint32_t transferId, uint8_t status) {
+    ns_ota_ack_t ack;
+    uint32_t i;
+
+    memset(&ack, 0, sizeof(ack));
+    ack.type = NS_OTA_MSG_ACK;
+    ack.status = status;
+    ack.transferId = transferId;
+    if (o->receiving && (transferId == o->progress.transferId)) {
+        ack.base = o->base;
+        ack.received = o->progress.received;
+        for (i = 0; (i < 32) && (o->base + 1 + i < o->numChunks); i++) {
+            if (ns_ota_test_bit(o->progress.bitmap, o->base + 1 + i)) {
+                ack.sack |= 1u << i;
+            }
+        }
+    } else if (status == NS_OTA_ACK_COMPLETE) {
+        ack.base = o->numChunks;
+        ack.received = o->numChunks;
+    }
+    o->sinceAck = 0;
+    o->stats.acks++;
+    return o->link.send(o->link.ctx, (const uint8_t *)&ack, sizeof(ack));
+}
+
+// Transfer over (verified, mismatched or failed): remember the outcome for repeated messages
+static uint32_t ns_ota_finish(ns_ota_t *o, uint8_t status) {
+    uint32_t transferId = o->progress.transferId;
+    uint32_t err = ns_ota_clear_progress(o);
+    o->lastTransferId = transferId;
+    o->lastStatus = status;
+    ns_ota_send_ack(o, transferId, status);
+    return err;
+}
+
+static bool ns_ota_is_delta(const ns_ota_t *o) {
+    return (o->progress.flags & NS_OTA_START_DELTA) != 0;
+}
+
+// Make the freshly written slot active
+static uint32_t ns_ota_switch(ns_ota_t *o, uint32_t imageSize, const uint8_t *hash) {
+    ns_ota_boot_t boot;
+    uint32_t err;
+
+    // The new record goes over the older copy; the current one stays valid until it is complete
+    memset(&boot, 0, sizeof(boot));
+    boot.magic = NS_OTA_BOOT_MAGIC;
+    boot.generation = o->boot.generation + 1;
+    boot.slot = o->progress.slot;
+    boot.imageSize = imageSize;
+    memcpy(boot.hash, hash, NS_OTA_HASH_SIZE);
+    boot.crc = ns_crc32(&boot, offsetof(ns_ota_boot_t, crc));
+    err = o->storage->write(o->storage->ctx,
+                            (boot.generation & 1) ? NS_OTA_REGION_BOOT1 : NS_OTA_REGION_BOOT0, 0,
+                            &boot, sizeof(boot));
+    if (err != NS_STATUS_SUCCESS) {
+        ns_ota_finish(o, NS_OTA_ACK_STORAGE_ERROR);
+        return err;
+    }
+    o->boot = boot;
+    o->hasActive = true;
+    return ns_ota_finish(o, NS_OTA_ACK_COMPLETE);
+}
+
+// The rebuilt image was hashed as it was written, no need to read it back
+static uint32_t ns_ota_delta_complete(ns_ota_t *o) {
+    ns_ota_delta_t *d = o->delta;
+
+    if (ns_ota_delta_finish(d) != NS_STATUS_SUCCESS) {
+        return ns_ota_finish(o, (d->error == NS_OTA_DELTA_ERR_HASH) ? NS_OTA_ACK_HASH_MISMATCH
+                                                                    : NS_OTA_ACK_PATCH_ERROR);
+    }
+    if (memcmp(d->header.targetHash, o->progress.hash, NS_OTA_HASH_SIZE) != 0) {
+        return ns_ota_finish(o, NS_OTA_ACK_HASH_MISMATCH);
+    }
+    return ns_ota_switch(o, d->header.targetSize, d->header.targetHash);
+}
+
+static uint32_t ns_ota_verify_and_switch(ns_ota_t *o) {
+    uint8_t block[NS_OTA_VERIFY_BLOCK];
+    uint8_t digest[NS_OTA_HASH_SIZE];
+    ns_ota_sha256_t h;
+    uint32_t offset, len, err;
+
+    ns_ota_sha256_init(&h);
+    for (offset = 0; offset < o->progress.imageSize; offset += len) {
+        len = o->progress.imageSize - offset;
+        if (len > sizeof(block)) {
+            len = sizeof(block);
+        }
+        err = o->storage->read(
+            o->storage->ctx, (ns_ota_region_e)o->progress.slot, offset, block, len);
+        if (err != NS_STATUS_SUCCESS) {
+            ns_ota_finish(o, NS_OTA_ACK_STORAGE_ERROR);
+            return err;
+        }
+        ns_ota_sha256_update(&h, block, len);
+    }
+    ns_ota_sha256_final(&h, digest);
+    if (memcmp(digest, o->progress.hash, NS_OTA_HASH_SIZE) != 0) {
+        return ns_ota_finish(o, NS_OTA_ACK_HASH_MISMATCH);
+    }
+    return ns_ota_switch(o, o->progress.imageSize, o->progress.hash);
+}
+
+static uint32_t ns_ota_on_start(ns_ota_t *o, const ns_ota_start_t *start) {
+    ns_ota_progress_t *p = &o->progress;
+    bool delta = (start->flags & NS_OTA_START_DELTA) != 0;
+    uint32_t numChunks, err;
+
+    if (o->receiving && (start->transferId == p->transferId) && (start->flags == p->flags) &&
+        (start->imageSize == p->imageSize) && (start->chunkSize == p->chunkSize) &&
+        (memcmp(start->hash, p->hash, NS_OTA_HASH_SIZE) == 0)) {
+        return ns_ota_send_ack(o, start->transferId, NS_OTA_ACK_OK);
+    }
+    if (o->hasActive && (delta || (start->imageSize == o->boot.imageSize)) &&
+        (memcmp(start->hash, o->boot.hash, NS_OTA_HASH_SIZE) == 0)) {
+        // Already running this image
+        o->lastTransferId = start->transferId;
+        o->lastStatus = NS_OTA_ACK_COMPLETE;
+        return ns_ota_send_ack(o, start->transferId, NS_OTA_ACK_COMPLETE);
+    }
+
+    numChunks = start->chunkSize ? ns_ota_num_chunks(start->imageSize, start->chunkSize) : 0;
+    if ((numChunks == 0) || (numChunks > NS_OTA_MAX_CHUNKS) ||
+        (start->flags & ~NS_OTA_START_DELTA) ||
+        (delta ? ((o->delta == NULL) || !o->hasActive)
+               : (start->imageSize > o->storage->slotSize))) {
+        return ns_ota_send_ack(o, start->transferId, NS_OTA_ACK_REJECTED);
+    }
+
+    err = NS_STATUS_SUCCESS;
+    if (delta) {
+        // The applier state lives in RAM, so a delta cannot be resumed: drop any saved record
+        // rather than leave one that no longer matches the slot
+        err = ns_ota_clear_progress(o);
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->magic = NS_OTA_PROGRESS_MAGIC;
+    p->transferId = start->transferId;
+    p->imageSize = start->imageSize;
+    p->chunkSize = start->chunkSize;
+    p->slot = ns_ota_inactive_slot(o);
+    p->flags = start->flags;
+    memcpy(p->hash, start->hash, NS_OTA_HASH_SIZE);
+    o->numChunks = numChunks;
+    o->base = 0;
+    o->highest = 0;
+    o->receiving = true;
+
+    if ((err == NS_STATUS_SUCCESS) && (o->storage->erase != NULL)) {
+        err = o->storage->erase(o->storage->ctx, (ns_ota_region_e)p->slot,
+                                delta ? o->storage->slotSize : p->imageSize);
+    }
+    if (err == NS_STATUS_SUCCESS) {
+        err = delta ? ns_ota_delta_begin(o->delta, o->storage, (ns_ota_region_e)o->boot.slot,
+                                         o->boot.imageSize, o->boot.hash,
+                                         (ns_ota_region_e)p->slot)
+                    : ns_ota_save_progress(o);
+    }
+    if (err != NS_STATUS_SUCCESS) {
+        ns_ota_finish(o, NS_OTA_ACK_STORAGE_ERROR);
+        return err;
+    }
+    return ns_ota_send_ack(o, start->transferId, NS_OTA_ACK_OK);
+}
+
+static uint32_t ns_ota_on_data(ns_ota_t *o, const ns_ota_data_t *hdr, const uint8_t *data) {
+    ns_ota_progress_t *p = &o->progress;
+    uint32_t chunk, expected, err;
+    bool inOrder;
+
+    if (!o->receiving || (hdr->transferId != p->transferId)) {
+        if (hdr->transferId == o->lastTransferId) {
+            return ns_ota_send_ack(o, hdr->transferId, o->lastStatus);
+        }
+        return ns_ota_send_ack(o, hdr->transferId, NS_OTA_ACK_UNKNOWN);
+    }
+
+    chunk = hdr->offset / p->chunkSize;
+    expected = (chunk + 1 < o->numChunks) ? p->chunkSize
+                                          : p->imageSize - (o->numChunks - 1) * p->chunkSize;
+    if ((hdr->offset % p->chunkSize) || (chunk >= o->numChunks) || (hdr->length != expected)) {
+        o->stats.badChunks++;
+        return NS_STATUS_SUCCESS;
+    }
+    if (ns_crc32(data, hdr->length) != hdr->crc32) {
+        o->stats.crcErrors++;
+        return NS_STATUS_SUCCESS;
+    }
+    if (ns_ota_test_bit(p->bitmap, chunk)) {
+        // The sender missed an ACK, tell it again where things stand
+        o->stats.duplicates++;
+        return ns_ota_send_ack(o, hdr->transferId, NS_OTA_ACK_OK);
+    }
+
+    if (ns_ota_is_delta(o)) {
+        if (chunk != o->base) {
+            // The patch is applied in order, the sender goes back to base
+            o->stats.outOfOrder++;
+            return ns_ota_send_ack(o, hdr->transferId, NS_OTA_ACK_OK);
+        }
+        if (ns_ota_delta_write(o->delta, data, hdr->length) != NS_STATUS_SUCCESS) {
+            if (o->delta->error == NS_OTA_DELTA_ERR_STORAGE) {
+                ns_ota_finish(o, NS_OTA_ACK_STORAGE_ERROR);
+                return NS_STATUS_FAILURE;
+            }
+            return ns_ota_finish(o, NS_OTA_ACK_PATCH_ERROR);
+        }
+    } else {
+        // Data first, then the bitmap: a saved bit always stands for a written chunk
+        err = o->storage->write(
+            o->storage->ctx, (ns_ota_region_e)p->slot, hdr->offset, data, hdr->length);
+        if (err != NS_STATUS_SUCCESS) {
+            ns_ota_finish(o, NS_OTA_ACK_STORAGE_ERROR);
+            return err;
+        }
+    }
+    p->bitmap[chunk >> 5] |= 1u << (chunk & 31);
+    p->received++;
+    o->stats.chunks++;
+
+    // A gap or a filled hole means the sender has something to resend, tell it right away
+    inOrder = (chunk == o->highest) && (o->base == o->highest);
+    if (chunk >= o->highest) {
+        o->highest = chunk + 1;
+    }
+    while ((o->base < o->numChunks) && ns_ota_test_bit(p->bitmap, o->base)) {
+        o->base++;
+    }
+
+    if (p->received == o->numChunks) {
+        return ns_ota_is_delta(o) ? ns_ota_delta_complete(o) : ns_ota_verify_and_switch(o);
+    }
+    if (!ns_ota_is_delta(o) && (++o->sinceSave >= o->persistEvery)) {
+        err = ns_ota_save_progress(o);
+        if (err != NS_STATUS_SUCCESS) {
+            ns_ota_finish(o, NS_OTA_ACK_STORAGE_ERROR);
+            return err;
+        }
+    }
+    if (!inOrder || (++o->sinceAck >= o->ackEvery)) {
+        return ns_ota_send_ack(o, hdr->transferId, NS_OTA_ACK_OK);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ota_receive(ns_ota_t *o, const uint8_t *msg, uint32_t len) {
+    ns_ota_start_t start;
+    ns_ota_data_t hdr;
+
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((o == NULL) || (msg == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+
+    if ((len >= sizeof(start)) && (msg[0] == NS_OTA_MSG_START)) {
+        memcpy(&start, msg, sizeof(start));
+        return ns_ota_on_start(o, &start);
+    }
+    if ((len >= sizeof(hdr)) && (msg[0] == NS_OTA_MSG_DATA)) {
+        memcpy(&hdr, msg, sizeof(hdr));
+        if (hdr.length == len - sizeof(hdr)) {
+            return ns_ota_on_data(o, &hdr, msg + sizeof(hdr));
+        }
+    }
+    o->stats.badChunks++;
+    return NS_STATUS_SUCCESS;
+}
+
+bool ns_ota_get_active(const ns_ota_t *o, ns_ota_image_t *image) {
+    if ((o == NULL) || !o->hasActive) {
+        return false;
+    }
+    image->slot = (ns_ota_region_e)o->boot.slot;
+    image->size = o->boot.imageSize;
+    image->generation = o->boot.generation;
+    memcpy(image->hash, o->boot.hash, NS_OTA_HASH_SIZE);
+    return true;
+}
+
+uint32_t ns_ota_abort(ns_ota_t *o) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (o == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+    return ns_ota_clear_progress(o);
+}
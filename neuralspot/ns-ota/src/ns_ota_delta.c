@@ -0,0 +1,284 @@
+/**
+ * @file ns_ota_delta.c
+ * @author Ambiq
+ * @brief Streaming delta applier: copy/insert ops from a patch into the inactive slot
+ * @version 0.1
+ * @date 2025-08-12
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_ota_delta.h"
+#include "ns_core.h"
+#include <string.h>
+
+typedef enum {
+    NS_OTA_DELTA_STATE_HEADER = 0,
+    NS_OTA_DELTA_STATE_OP,
+    NS_OTA_DELTA_STATE_LEN,    ///< Gathering a LEB128 op length
+    NS_OTA_DELTA_STATE_OFFSET, ///< Gathering a COPY offset
+    NS_OTA_DELTA_STATE_INSERT, ///< Inside INSERT data
+    NS_OTA_DELTA_STATE_DONE,
+    NS_OTA_DELTA_STATE_ERROR
+} ns_ota_delta_state_e;
+
+static uint32_t ns_ota_delta_fail(ns_ota_delta_t *d, ns_ota_delta_error_e error) {
+    d->error = error;
+    d->state = NS_OTA_DELTA_STATE_ERROR;
+    return NS_STATUS_FAILURE;
+}
+
+// Write the staged output block (hashing it on the way)
+static uint32_t ns_ota_delta_flush(ns_ota_delta_t *d) {
+    uint32_t err;
+
+    if (d->blockUsed == 0) {
+        return NS_STATUS_SUCCESS;
+    }
+    err = d->storage->write(d->storage->ctx, d->target, d->outPos - d->blockUsed, d->block,
+                            d->blockUsed);
+    if (err != NS_STATUS_SUCCESS) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_STORAGE);
+    }
+    ns_ota_sha256_update(&d->sha, d->block, d->blockUsed);
+    d->blockUsed = 0;
+    return NS_STATUS_SUCCESS;
+}
+
+// Account for n bytes just placed in the block, flushing it when full
+static uint32_t ns_ota_delta_produced(ns_ota_delta_t *d, uint32_t n) {
+    d->blockUsed += n;
+    d->outPos += n;
+    if (d->blockUsed == NS_OTA_DELTA_BLOCK) {
+        return ns_ota_delta_flush(d);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+// Current op is finished: the image is complete or the next op follows
+static uint32_t ns_ota_delta_next_op(ns_ota_delta_t *d) {
+    if (d->outPos == d->header.targetSize) {
+        d->state = NS_OTA_DELTA_STATE_DONE;
+        return ns_ota_delta_flush(d);
+    }
+    d->state = NS_OTA_DELTA_STATE_OP;
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_ota_delta_have_len(ns_ota_delta_t *d) {
+    if (d->len > d->header.targetSize - d->outPos) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_RANGE);
+    }
+    d->value = 0;
+    d->shift = 0;
+    d->state = (d->op == NS_OTA_DELTA_OP_COPY) ? NS_OTA_DELTA_STATE_OFFSET
+                                               : NS_OTA_DELTA_STATE_INSERT;
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_ota_delta_copy(ns_ota_delta_t *d, int32_t rel) {
+    int64_t src = (int64_t)d->expected + rel;
+    uint32_t n, err;
+
+    if ((src < 0) || ((uint64_t)src + d->len > d->sourceSize)) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_RANGE);
+    }
+    d->expected = (uint32_t)src + d->len;
+    d->copied += d->len;
+    while (d->len) {
+        n = NS_OTA_DELTA_BLOCK - d->blockUsed;
+        if (n > d->len) {
+            n = d->len;
+        }
+        err = d->storage->read(d->storage->ctx, d->source, (uint32_t)src, d->block + d->blockUsed,
+                               n);
+        if (err != NS_STATUS_SUCCESS) {
+            return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_STORAGE);
+        }
+        src += n;
+        d->len -= n;
+        if (ns_ota_delta_produced(d, n) != NS_STATUS_SUCCESS) {
+            return NS_STATUS_FAILURE;
+        }
+    }
+    return ns_ota_delta_next_op(d);
+}
+
+// Gather one LEB128 byte, returns true once the value is complete
+static bool ns_ota_delta_leb128(ns_ota_delta_t *d, uint8_t b, bool *overflow) {
+    *overflow = (d->shift > 28) || ((d->shift == 28) && (b & 0x70));
+    d->value |= (uint32_t)(b & 0x7F) << d->shift;
+    d->shift += 7;
+    return !(b & 0x80);
+}
+
+static uint32_t ns_ota_delta_check_header(ns_ota_delta_t *d) {
+    const ns_ota_delta_header_t *h = &d->header;
+
+    if ((h->magic != NS_OTA_DELTA_MAGIC) || (h->version != NS_OTA_DELTA_VERSION) ||
+        (h->headerSize != sizeof(*h))) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_HEADER);
+    }
+    if ((h->sourceSize != d->sourceSize) ||
+        (memcmp(h->sourceHash, d->sourceHash, NS_OTA_HASH_SIZE) != 0)) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_SOURCE);
+    }
+    if (h->targetSize > d->storage->slotSize) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_RANGE);
+    }
+    if (h->targetSize == 0) {
+        d->state = NS_OTA_DELTA_STATE_DONE;
+    } else {
+        d->state = NS_OTA_DELTA_STATE_OP;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ota_delta_begin(
+    ns_ota_delta_t *d, const ns_ota_storage_t *storage, ns_ota_region_e source,
+    uint32_t sourceSize, const uint8_t sourceHash[NS_OTA_HASH_SIZE], ns_ota_region_e target) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((d == NULL) || (storage == NULL) || (sourceHash == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if ((storage->read == NULL) || (storage->write == NULL) || (source == target) ||
+        (source > NS_OTA_REGION_SLOT_B) || (target > NS_OTA_REGION_SLOT_B) ||
+        (sourceSize > storage->slotSize)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    memset(d, 0, sizeof(*d));
+    d->storage = storage;
+    d->source = source;
+    d->target = target;
+    d->sourceSize = sourceSize;
+    memcpy(d->sourceHash, sourceHash, NS_OTA_HASH_SIZE);
+    d->state = NS_OTA_DELTA_STATE_HEADER;
+    d->error = NS_OTA_DELTA_OK;
+    ns_ota_sha256_init(&d->sha);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ota_delta_write(ns_ota_delta_t *d, const uint8_t *patch, uint32_t len) {
+    uint32_t n;
+    uint8_t b;
+    bool overflow;
+
+    if (d->state == NS_OTA_DELTA_STATE_ERROR) {
+        return NS_STATUS_FAILURE;
+    }
+
+    while (len) {
+        switch (d->state) {
+        case NS_OTA_DELTA_STATE_HEADER:
+            n = sizeof(d->header) - d->headerUsed;
+            if (n > len) {
+                n = len;
+            }
+            memcpy((uint8_t *)&d->header + d->headerUsed, patch, n);
+            d->headerUsed += n;
+            patch += n;
+            len -= n;
+            if ((d->headerUsed == sizeof(d->header)) &&
+                (ns_ota_delta_check_header(d) != NS_STATUS_SUCCESS)) {
+                return NS_STATUS_FAILURE;
+            }
+            break;
+
+        case NS_OTA_DELTA_STATE_OP:
+            b = *patch++;
+            len--;
+            d->op = b & NS_OTA_DELTA_OP_MASK;
+            if ((d->op != NS_OTA_DELTA_OP_INSERT) && (d->op != NS_OTA_DELTA_OP_COPY)) {
+                return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_OP);
+            }
+            d->len = b & NS_OTA_DELTA_LEN_MASK;
+            if (d->len == 0) {
+                d->value = 0;
+                d->shift = 0;
+                d->state = NS_OTA_DELTA_STATE_LEN;
+            } else if (ns_ota_delta_have_len(d) != NS_STATUS_SUCCESS) {
+                return NS_STATUS_FAILURE;
+            }
+            break;
+
+        case NS_OTA_DELTA_STATE_LEN:
+            b = *patch++;
+            len--;
+            if (ns_ota_delta_leb128(d, b, &overflow)) {
+                if (overflow || (d->value == 0)) {
+                    return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_OP);
+                }
+                d->len = d->value;
+                if (ns_ota_delta_have_len(d) != NS_STATUS_SUCCESS) {
+                    return NS_STATUS_FAILURE;
+                }
+            } else if (overflow) {
+                return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_OP);
+            }
+            break;
+
+        case NS_OTA_DELTA_STATE_OFFSET:
+            b = *patch++;
+            len--;
+            if (ns_ota_delta_leb128(d, b, &overflow)) {
+                if (overflow) {
+                    return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_OP);
+                }
+                // Zigzag: 0, -1, 1, -2, ... as 0, 1, 2, 3, ...
+                if (ns_ota_delta_copy(d, (int32_t)((d->value >> 1) ^ (0u - (d->value & 1)))) !=
+                    NS_STATUS_SUCCESS) {
+                    return NS_STATUS_FAILURE;
+                }
+            } else if (overflow) {
+                return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_OP);
+            }
+            break;
+
+        case NS_OTA_DELTA_STATE_INSERT:
+            n = NS_OTA_DELTA_BLOCK - d->blockUsed;
+            if (n > d->len) {
+                n = d->len;
+            }
+            if (n > len) {
+                n = len;
+            }
+            memcpy(d->block + d->blockUsed, patch, n);
+            patch += n;
+            len -= n;
+            d->len -= n;
+            d->expected += n;
+            d->inserted += n;
+            if (ns_ota_delta_produced(d, n) != NS_STATUS_SUCCESS) {
+                return NS_STATUS_FAILURE;
+            }
+            if ((d->len == 0) && (ns_ota_delta_next_op(d) != NS_STATUS_SUCCESS)) {
+                return NS_STATUS_FAILURE;
+            }
+            break;
+
+        default: // DONE, anything more is not part of this patch
+            return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_LENGTH);
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_ota_delta_finish(ns_ota_delta_t *d) {
+    uint8_t digest[NS_OTA_HASH_SIZE];
+
+    if (d->state == NS_OTA_DELTA_STATE_ERROR) {
+        return NS_STATUS_FAILURE;
+    }
+    if (d->state != NS_OTA_DELTA_STATE_DONE) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_LENGTH);
+    }
+    ns_ota_sha256_final(&d->sha, digest);
+    if (memcmp(digest, d->header.targetHash, NS_OTA_HASH_SIZE) != 0) {
+        return ns_ota_delta_fail(d, NS_OTA_DELTA_ERR_HASH);
+    }
+    return NS_STATUS_SUCCESS;
+}
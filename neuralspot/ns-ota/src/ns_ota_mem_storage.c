@@ -0,0 +1,121 @@
+/**
+ * @file ns_ota_mem_storage.c
+ * @author Ambiq
+ * @brief OTA storage port over plain memory
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_ota.h"
+#include "ns_core.h"
+#include <string.h>
+
+static uint32_t ns_ota_mem_check(
+    const ns_ota_mem_storage_t *mem, ns_ota_region_e region, uint32_t offset, uint32_t len) {
+    if ((region >= NS_OTA_REGION_COUNT) || (mem->region[region] == NULL) ||
+        (offset > mem->regionSize[region]) || (len > mem->regionSize[region] - offset)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t
+ns_ota_mem_read(void *ctx, ns_ota_region_e region, uint32_t offset, void *buf, uint32_t len) {
+    ns_ota_mem_storage_t *mem = (ns_ota_mem_storage_t *)ctx;
+    uint32_t err = ns_ota_mem_check(mem, region, offset, len);
+    if (err == NS_STATUS_SUCCESS) {
+        memcpy(buf, mem->region[region] + offset, len);
+    }
+    return err;
+}
+
+static uint32_t ns_ota_mem_write(
+    void *ctx, ns_ota_region_e region, uint32_t offset, const void *buf, uint32_t len) {
+    ns_ota_mem_storage_t *mem = (ns_ota_mem_storage_t *)ctx;
+    uint32_t err = ns_ota_mem_check(mem, region, offset, len);
+    if (err == NS_STATUS_SUCCESS) {
+        memcpy(mem->region[region] + offset, buf, len);
+    }
+    return err;
+}
+
+static void ns_ota_mem_port(
+    ns_ota_storage_t *port, ns_ota_mem_storage_t *mem,
+    uint32_t (*write)(void *, ns_ota_region_e, uint32_t, const void *, uint32_t)) {
+    port->read = ns_ota_mem_read;
+    port->write = write;
+    port->erase = NULL;
+    port->slotSize = mem->regionSize[NS_OTA_REGION_SLOT_A];
+    if (mem->regionSize[NS_OTA_REGION_SLOT_B] < port->slotSize) {
+        port->slotSize = mem->regionSize[NS_OTA_REGION_SLOT_B];
+    }
+    port->ctx = mem;
+}
+
+void ns_ota_mem_storage_init(ns_ota_storage_t *port, ns_ota_mem_storage_t *mem) {
+    ns_ota_mem_port(port, mem, ns_ota_mem_write);
+}
+
+const uint8_t *ns_ota_mem_storage_addr(const ns_ota_mem_storage_t *mem, ns_ota_region_e region) {
+    return (region < NS_OTA_REGION_COUNT) ? mem->region[region] : NULL;
+}
+
+#if defined(AM_PART_APOLLO3) || defined(AM_PART_APOLLO3P)
+void ns_ota_mram_storage_init(ns_ota_storage_t *port, ns_ota_mem_storage_t *mem) {
+    // No MRAM on Apollo3, fall back to plain memory writes
+    ns_ota_mem_port(port, mem, ns_ota_mem_write);
+}
+#elif defined(AM_PART_APOLLO4B) || defined(AM_PART_APOLLO4P) || defined(AM_PART_APOLLO4L) ||   \
+    defined(AM_PART_APOLLO5A) || defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510)
+    #include "am_mcu_apollo.h"
+
+    #define NS_OTA_MRAM_WORDS 64 // Words programmed per HAL call
+
+// MRAM is programmed a word at a time, partial words at either end keep their other bytes
+static uint32_t ns_ota_mram_write(
+    void *ctx, ns_ota_region_e region, uint32_t offset, const void *buf, uint32_t len) {
+    ns_ota_mem_storage_t *mem = (ns_ota_mem_storage_t *)ctx;
+    uint32_t words[NS_OTA_MRAM_WORDS];
+    const uint8_t *src = (const uint8_t *)buf;
+    uint32_t start, end, addr, n, i;
+    uint32_t err = ns_ota_mem_check(mem, region, offset, len);
+
+    if ((err != NS_STATUS_SUCCESS) || (len == 0)) {
+        return err;
+    }
+    start = (uint32_t)(uintptr_t)mem->region[region] + offset;
+    end = start + len;
+    for (addr = start & ~3u; addr < end; addr += n * 4) {
+        n = ((end - addr + 3) >> 2);
+        if (n > NS_OTA_MRAM_WORDS) {
+            n = NS_OTA_MRAM_WORDS;
+        }
+        memcpy(words, (const void *)(uintptr_t)addr, n * 4);
+        for (i = 0; i < n * 4; i++) {
+            if ((addr + i >= start) && (addr + i < end)) {
+                ((uint8_t *)words)[i] = src[addr + i - start];
+            }
+        }
+        if (am_hal_mram_main_words_program(
+                AM_HAL_MRAM_PROGRAM_KEY, words, (uint32_t *)(uintptr_t)addr, n) != 0) {
+            return NS_STATUS_FAILURE;
+        }
+    }
+    #if defined(AM_PART_APOLLO5A) || defined(AM_PART_APOLLO5B) || defined(AM_PART_APOLLO510)
+    {
+        // Reads go through the data cache
+        am_hal_cachectrl_range_t range = {.ui32StartAddr = start & ~31u,
+                                          .ui32Size = ((end + 31) & ~31u) - (start & ~31u)};
+        am_hal_cachectrl_dcache_invalidate(&range, false);
+    }
+    #endif
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_ota_mram_storage_init(ns_ota_storage_t *port, ns_ota_mem_storage_t *mem) {
+    ns_ota_mem_port(port, mem, ns_ota_mram_write);
+}
+#endif
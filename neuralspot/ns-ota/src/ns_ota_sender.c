@@ -0,0 +1,218 @@
+/**
+ * @file ns_ota_sender.c
+ * @author Ambiq
+ * @brief OTA sender: sliding window of chunks with selective retransmit
+ * @version 0.1
+ * @date 2025-08-11
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_ota.h"
+#include "ns_core.h"
+#include "ns_crc32.h"
+#include "ns_ota_delta.h"
+#include <stddef.h>
+#include <string.h>
+
+#define NS_OTA_SLOT(chunk) ((chunk) % NS_OTA_WINDOW_MAX)
+
+static uint32_t ns_ota_sender_send_start(ns_ota_sender_t *s) {
+    ns_ota_start_t start;
+
+    memset(&start, 0, sizeof(start));
+    start.type = NS_OTA_MSG_START;
+    start.flags = s->flags;
+    start.chunkSize = s->chunkSize;
+    start.transferId = s->transferId;
+    start.imageSize = s->imageSize;
+    memcpy(start.hash, s->digest, NS_OTA_HASH_SIZE);
+    return s->link.send(s->link.ctx, (const uint8_t *)&start, sizeof(start));
+}
+
+static uint32_t ns_ota_sender_send_chunk(ns_ota_sender_t *s, uint32_t chunk, uint32_t now) {
+    ns_ota_data_t hdr;
+    uint32_t offset = chunk * s->chunkSize;
+    uint32_t len = s->imageSize - offset;
+    uint32_t err;
+
+    if (len > s->chunkSize) {
+        len = s->chunkSize;
+    }
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.type = NS_OTA_MSG_DATA;
+    hdr.length = len;
+    hdr.transferId = s->transferId;
+    hdr.offset = offset;
+    hdr.crc32 = ns_crc32(s->image + offset, len);
+    memcpy(s->txBuf, &hdr, sizeof(hdr));
+    memcpy(s->txBuf + sizeof(hdr), s->image + offset, len);
+
+    err = s->link.send(s->link.ctx, s->txBuf, sizeof(hdr) + len);
+    if (err == NS_STATUS_SUCCESS) {
+        s->sentSeq[NS_OTA_SLOT(chunk)] = ++s->txSeq;
+        s->sentAt[NS_OTA_SLOT(chunk)] = now;
+        s->stats.chunks++;
+    }
+    return err;
+}
+
+uint32_t ns_ota_sender_init(ns_ota_sender_t *s, uint32_t now) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (s == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(s->api, &ns_ota_oldest_supported_version, &ns_ota_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((s->image == NULL) || (s->imageSize == 0) || (s->chunkSize == 0) ||
+        (s->window == 0) || (s->window > NS_OTA_WINDOW_MAX) || (s->timeout == 0) ||
+        (s->link.send == NULL) || (s->txBuf == NULL) ||
+        ((s->flags & NS_OTA_START_DELTA) && (s->imageSize < sizeof(ns_ota_delta_header_t)))) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    if (s->hash != NULL) {
+        memcpy(s->digest, s->hash, NS_OTA_HASH_SIZE);
+    } else if (s->flags & NS_OTA_START_DELTA) {
+        // A patch names the image it rebuilds
+        memcpy(s->digest, s->image + offsetof(ns_ota_delta_header_t, targetHash),
+               NS_OTA_HASH_SIZE);
+    } else {
+        ns_ota_sha256(s->image, s->imageSize, s->digest);
+    }
+    s->numChunks = (s->imageSize + s->chunkSize - 1) / s->chunkSize;
+    s->state = NS_OTA_SENDER_STARTING;
+    s->lastStatus = NS_OTA_ACK_OK;
+    s->base = 0;
+    s->acked = 0;
+    s->next = 0;
+    s->txSeq = 0;
+    s->ackedSeq = 0;
+    s->startAt = now - s->timeout; // START goes out on the first poll
+    memset(&s->stats, 0, sizeof(s->stats));
+    ns_ota_sender_poll(s, now);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_ota_sender_on_message(
+    ns_ota_sender_t *s, const uint8_t *msg, uint32_t len, uint32_t now) {
+    ns_ota_ack_t ack;
+    uint32_t chunk, bit;
+
+    if ((s == NULL) || (msg == NULL) || (len < sizeof(ack)) || (msg[0] != NS_OTA_MSG_ACK)) {
+        return;
+    }
+    memcpy(&ack, msg, sizeof(ack));
+    if ((ack.transferId != s->transferId) || (s->state == NS_OTA_SENDER_DONE) ||
+        (s->state == NS_OTA_SENDER_FAILED)) {
+        return;
+    }
+    s->stats.acks++;
+
+    switch (ack.status) {
+    case NS_OTA_ACK_OK:
+        break;
+    case NS_OTA_ACK_COMPLETE:
+        s->state = NS_OTA_SENDER_DONE;
+        s->lastStatus = ack.status;
+        return;
+    case NS_OTA_ACK_UNKNOWN:
+        // Receiver lost the transfer (reset without a saved record), announce it again
+        s->state = NS_OTA_SENDER_STARTING;
+        s->startAt = now - s->timeout;
+        return;
+    default:
+        s->state = NS_OTA_SENDER_FAILED;
+        s->lastStatus = ack.status;
+        return;
+    }
+
+    if (s->state == NS_OTA_SENDER_STARTING) {
+        // Fresh or resumed, the receiver tells us what it already has
+        s->state = NS_OTA_SENDER_SENDING;
+        s->base = ack.base;
+        s->acked = ack.sack << 1;
+        s->next = ack.base;
+        return;
+    }
+    if (ack.base > s->numChunks) {
+        return;
+    }
+    if (ack.base < s->base) {
+        // The receiver reset and lost chunks acknowledged after its last saved record
+        s->base = ack.base;
+        s->acked = ack.sack << 1;
+        s->next = ack.base;
+        return;
+    }
+
+    // Chunks acknowledged for the first time tell how far the link has delivered
+    for (chunk = s->base; chunk < s->next; chunk++) {
+        if ((s->acked >> (chunk - s->base)) & 1) {
+            continue;
+        }
+        bit = chunk - ack.base - 1;
+        if ((chunk < ack.base) || ((chunk > ack.base) && (bit < 32) && ((ack.sack >> bit) & 1))) {
+            if (s->sentSeq[NS_OTA_SLOT(chunk)] > s->ackedSeq) {
+                s->ackedSeq = s->sentSeq[NS_OTA_SLOT(chunk)];
+            }
+        }
+    }
+    s->base = ack.base;
+    s->acked = ack.sack << 1;
+    if (s->next < s->base) {
+        s->next = s->base;
+    }
+}
+
+ns_ota_sender_state_e ns_ota_sender_poll(ns_ota_sender_t *s, uint32_t now) {
+    uint32_t chunk, slot;
+    bool lost, late;
+
+    if (s == NULL) {
+        return NS_OTA_SENDER_FAILED;
+    }
+
+    if (s->state == NS_OTA_SENDER_STARTING) {
+        if ((now - s->startAt >= s->timeout) &&
+            (ns_ota_sender_send_start(s) == NS_STATUS_SUCCESS)) {
+            s->startAt = now;
+        }
+        return s->state;
+    }
+    if (s->state != NS_OTA_SENDER_SENDING) {
+        return s->state;
+    }
+
+    // Resend lost chunks first, they hold the window back
+    for (chunk = s->base; chunk < s->next; chunk++) {
+        if ((s->acked >> (chunk - s->base)) & 1) {
+            continue;
+        }
+        slot = NS_OTA_SLOT(chunk);
+        lost = s->sentSeq[slot] < s->ackedSeq;
+        late = (now - s->sentAt[slot]) >= s->timeout;
+        if (lost || late) {
+            if (ns_ota_sender_send_chunk(s, chunk, now) != NS_STATUS_SUCCESS) {
+                return s->state;
+            }
+            s->stats.retransmits++;
+            s->stats.timeouts += !lost;
+        }
+    }
+
+    while ((s->next < s->numChunks) && (s->next < s->base + s->window)) {
+        if (!((s->acked >> (s->next - s->base)) & 1)) {
+            if (ns_ota_sender_send_chunk(s, s->next, now) != NS_STATUS_SUCCESS) {
+                return s->state;
+            }
+        }
+        s->next++;
+    }
+    return s->state;
+}
@@ -0,0 +1,747 @@
+#include "unity/unity.h"
+
+#include "crc32.h"
+#include "ns_ota_delta.h"
+#include "ns_ota_tests.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define IMAGE_SIZE (32 * 1024 + 100) // Last chunk is short
+#define SLOT_SIZE (40 * 1024)
+#define CHUNK_SIZE 256
+#define NUM_CHUNKS ((IMAGE_SIZE + CHUNK_SIZE - 1) / CHUNK_SIZE)
+#define MSG_MAX (sizeof(ns_ota_data_t) + CHUNK_SIZE)
+
+// Simulated link, times in us: a message occupies its direction for its length times
+// usPerByte, arrives latency later, in order, unless it is lost
+#define TICK_US 10
+#define LINK_QUEUE 64
+#define TIMEOUT_US 6000
+#define MAX_SIM_US 5000000
+
+typedef struct {
+    uint32_t deliverAt;
+    uint32_t len;
+    uint8_t data[MSG_MAX];
+} sim_msg_t;
+
+typedef struct {
+    sim_msg_t queue[LINK_QUEUE];
+    uint32_t head, tail;
+    uint32_t busyUntil;
+    uint32_t usPerByte;
+    uint32_t latency;
+    uint32_t lossPermille;
+    uint32_t sent, lost;
+} sim_channel_t;
+
+static uint32_t now_us;
+static uint32_t rng;
+static sim_channel_t toRx, toTx;
+
+static uint8_t image[IMAGE_SIZE + CHUNK_SIZE]; // Room for the oversized chunk in bad_chunk
+static uint8_t image2[IMAGE_SIZE];
+static uint8_t slotA[SLOT_SIZE];
+static uint8_t slotB[SLOT_SIZE];
+static uint8_t progressRec[sizeof(ns_ota_progress_t)];
+static uint8_t boot0[sizeof(ns_ota_boot_t)];
+static uint8_t boot1[sizeof(ns_ota_boot_t)];
+static ns_ota_mem_storage_t mem;
+static ns_ota_storage_t storage;
+
+static ns_ota_t rx;
+static ns_ota_sender_t tx;
+static uint8_t txBuf[MSG_MAX];
+static ns_ota_ack_t lastAck;
+static uint32_t ackCount;
+
+// Delta patch of image into target, built op by op
+#define PATCH_MAX 4096
+static ns_ota_delta_t delta;
+static uint8_t patch[PATCH_MAX];
+static uint32_t patchLen;
+static uint8_t target[SLOT_SIZE];
+static uint32_t targetLen;
+static uint32_t patchExpected;
+
+static uint32_t sim_rand(void) {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+static uint32_t sim_send(sim_channel_t *ch, const uint8_t *msg, uint32_t len) {
+    sim_msg_t *m;
+    uint32_t start = (ch->busyUntil > now_us) ? ch->busyUntil : now_us;
+
+    if (ch->head - ch->tail == LINK_QUEUE) {
+        return NS_STATUS_FAILURE;
+    }
+    ch->busyUntil = start + len * ch->usPerByte;
+    ch->sent++;
+    if (sim_rand() % 1000 < ch->lossPermille) {
+        ch->lost++;
+        return NS_STATUS_SUCCESS;
+    }
+    m = &ch->queue[ch->head % LINK_QUEUE];
+    m->deliverAt = ch->busyUntil + ch->latency;
+    m->len = len;
+    memcpy(m->data, msg, len);
+    ch->head++;
+    return NS_STATUS_SUCCESS;
+}
+
+static sim_msg_t *sim_ready(sim_channel_t *ch) {
+    sim_msg_t *m = &ch->queue[ch->tail % LINK_QUEUE];
+    return ((ch->tail != ch->head) && (m->deliverAt <= now_us)) ? m : NULL;
+}
+
+// The sender only hands over a message once the previous one is on the wire
+static uint32_t tx_send(void *ctx, const uint8_t *msg, uint32_t len) {
+    if (toRx.busyUntil > now_us) {
+        return NS_STATUS_FAILURE;
+    }
+    return sim_send(&toRx, msg, len);
+}
+
+static uint32_t rx_send(void *ctx, const uint8_t *msg, uint32_t len) {
+    memcpy(&lastAck, msg, sizeof(lastAck));
+    ackCount++;
+    return sim_send(&toTx, msg, len);
+}
+
+static void link_config(uint32_t usPerByte, uint32_t latency, uint32_t lossPermille) {
+    memset(&toRx, 0, sizeof(toRx));
+    memset(&toTx, 0, sizeof(toTx));
+    toRx.usPerByte = toTx.usPerByte = usPerByte;
+    toRx.latency = toTx.latency = latency;
+    toRx.lossPermille = toTx.lossPermille = lossPermille;
+}
+
+// Power cycle the receiver: messages in flight are gone, storage survives
+static uint32_t rx_boot(uint16_t ackEvery, uint16_t persistEvery) {
+    toRx.tail = toRx.head;
+    memset(&rx, 0, sizeof(rx));
+    rx.api = &ns_ota_V0_0_1;
+    rx.storage = &storage;
+    rx.link.send = rx_send;
+    rx.ackEvery = ackEvery;
+    rx.persistEvery = persistEvery;
+    return ns_ota_init(&rx);
+}
+
+// (Re)start the sender, like a host tool launched again
+static uint32_t tx_start(const uint8_t *img, uint32_t transferId, uint8_t window) {
+    toTx.tail = toTx.head;
+    memset(&tx, 0, sizeof(tx));
+    tx.api = &ns_ota_V0_0_1;
+    tx.image = img;
+    tx.imageSize = IMAGE_SIZE;
+    tx.chunkSize = CHUNK_SIZE;
+    tx.transferId = transferId;
+    tx.window = window;
+    tx.timeout = TIMEOUT_US;
+    tx.link.send = tx_send;
+    tx.txBuf = txBuf;
+    return ns_ota_sender_init(&tx, now_us);
+}
+
+// Advance the simulation until the sender is done, stopAfter chunks are written or time is up
+static ns_ota_sender_state_e sim_run(uint32_t stopAfter) {
+    ns_ota_sender_state_e state = tx.state;
+    uint32_t end = now_us + MAX_SIM_US;
+    sim_msg_t *m;
+
+    for (; now_us < end; now_us += TICK_US) {
+        while ((m = sim_ready(&toRx)) != NULL) {
+            ns_ota_receive(&rx, m->data, m->len);
+            toRx.tail++;
+        }
+        while ((m = sim_ready(&toTx)) != NULL) {
+            ns_ota_sender_on_message(&tx, m->data, m->len, now_us);
+            toTx.tail++;
+        }
+        state = ns_ota_sender_poll(&tx, now_us);
+        if ((state == NS_OTA_SENDER_DONE) || (state == NS_OTA_SENDER_FAILED) ||
+            (rx.stats.chunks >= stopAfter)) {
+            break;
+        }
+    }
+    return state;
+}
+
+static void storage_reset(void) {
+    // Never written storage holds garbage, not zeros
+    memset(slotA, 0xFF, sizeof(slotA));
+    memset(slotB, 0xFF, sizeof(slotB));
+    memset(progressRec, 0xFF, sizeof(progressRec));
+    memset(boot0, 0xFF, sizeof(boot0));
+    memset(boot1, 0xFF, sizeof(boot1));
+    mem.region[NS_OTA_REGION_SLOT_A] = slotA;
+    mem.regionSize[NS_OTA_REGION_SLOT_A] = sizeof(slotA);
+    mem.region[NS_OTA_REGION_SLOT_B] = slotB;
+    mem.regionSize[NS_OTA_REGION_SLOT_B] = sizeof(slotB);
+    mem.region[NS_OTA_REGION_PROGRESS] = progressRec;
+    mem.regionSize[NS_OTA_REGION_PROGRESS] = sizeof(progressRec);
+    mem.region[NS_OTA_REGION_BOOT0] = boot0;
+    mem.regionSize[NS_OTA_REGION_BOOT0] = sizeof(boot0);
+    mem.region[NS_OTA_REGION_BOOT1] = boot1;
+    mem.regionSize[NS_OTA_REGION_BOOT1] = sizeof(boot1);
+    ns_ota_mem_storage_init(&storage, &mem);
+    now_us = 0;
+    rng = 12345;
+    ackCount = 0;
+}
+
+static uint32_t send_data(uint32_t transferId, uint32_t offset, uint32_t len, bool corrupt) {
+    ns_ota_data_t hdr;
+    uint8_t msg[MSG_MAX];
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.type = NS_OTA_MSG_DATA;
+    hdr.length = len;
+    hdr.transferId = transferId;
+    hdr.offset = offset;
+    hdr.crc32 = CalcCrc32(0xFFFFFFFF, len, image + offset) ^ (corrupt ? 1 : 0);
+    memcpy(msg, &hdr, sizeof(hdr));
+    memcpy(msg + sizeof(hdr), image + offset, len);
+    return ns_ota_receive(&rx, msg, sizeof(hdr) + len);
+}
+
+static void patch_leb128(uint32_t v) {
+    while (v >= 0x80) {
+        patch[patchLen++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    patch[patchLen++] = (uint8_t)v;
+}
+
+static void patch_op(uint8_t op, uint32_t len) {
+    if (len <= NS_OTA_DELTA_LEN_MASK) {
+        patch[patchLen++] = op | len;
+    } else {
+        patch[patchLen++] = op;
+        patch_leb128(len);
+    }
+}
+
+static void patch_copy(uint32_t offset, uint32_t len) {
+    int32_t rel = (int32_t)(offset - patchExpected);
+    patch_op(NS_OTA_DELTA_OP_COPY, len);
+    patch_leb128(((uint32_t)rel << 1) ^ (uint32_t)(rel >> 31));
+    memcpy(target + targetLen, image + offset, len);
+    targetLen += len;
+    patchExpected = offset + len;
+}
+
+static void patch_insert(const uint8_t *data, uint32_t len) {
+    patch_op(NS_OTA_DELTA_OP_INSERT, len);
+    memcpy(patch + patchLen, data, len);
+    memcpy(target + targetLen, data, len);
+    patchLen += len;
+    targetLen += len;
+    patchExpected += len;
+}
+
+// A retrained image: bytes inserted, scattered weights changed, a span removed, and a copy
+// from before the expected position
+static void patch_build(const uint8_t *source, uint32_t sourceSize) {
+    ns_ota_delta_header_t h;
+    uint32_t pos;
+    uint8_t b;
+
+    patchLen = sizeof(h);
+    targetLen = 0;
+    patchExpected = 0;
+    patch_copy(0, 1000);
+    patch_insert(image2, 50);
+    for (pos = 1000; pos < 20000; pos += 500) {
+        patch_copy(pos, 499);
+        b = image[pos + 499] ^ 0x5A;
+        patch_insert(&b, 1);
+    }
+    patch_copy(20100, IMAGE_SIZE - 20100);
+    patch_copy(0, 300);
+
+    memset(&h, 0, sizeof(h));
+    h.magic = NS_OTA_DELTA_MAGIC;
+    h.version = NS_OTA_DELTA_VERSION;
+    h.headerSize = sizeof(h);
+    h.sourceSize = sourceSize;
+    h.targetSize = targetLen;
+    ns_ota_sha256(source, sourceSize, h.sourceHash);
+    ns_ota_sha256(target, targetLen, h.targetHash);
+    memcpy(patch, &h, sizeof(h));
+}
+
+// Apply the patch to slot A (holding image) in pieces of at most step bytes, 0 for random
+static ns_ota_delta_error_e delta_apply(const uint8_t *p, uint32_t len, uint32_t step) {
+    uint8_t hash[NS_OTA_HASH_SIZE];
+    uint32_t i, n;
+
+    memcpy(slotA, image, IMAGE_SIZE);
+    memset(slotB, 0xFF, sizeof(slotB));
+    ns_ota_sha256(image, IMAGE_SIZE, hash);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS,
+                      ns_ota_delta_begin(&delta, &storage, NS_OTA_REGION_SLOT_A, IMAGE_SIZE, hash,
+                                         NS_OTA_REGION_SLOT_B));
+    for (i = 0; i < len; i += n) {
+        n = step ? step : 1 + sim_rand() % 700;
+        if (n > len - i) {
+            n = len - i;
+        }
+        if (ns_ota_delta_write(&delta, p + i, n) != NS_STATUS_SUCCESS) {
+            return delta.error;
+        }
+    }
+    ns_ota_delta_finish(&delta);
+    return delta.error;
+}
+
+void ns_ota_tests_pre_test_hook() {
+    uint32_t i;
+    rng = 1;
+    for (i = 0; i < IMAGE_SIZE; i++) {
+        image[i] = (uint8_t)(sim_rand() >> 4);
+        image2[i] = (uint8_t)(image[i] ^ (i * 7));
+    }
+}
+
+void ns_ota_tests_post_test_hook() {}
+
+void ns_ota_init_test() {
+    storage_reset();
+    link_config(1, 1000, 0);
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_ota_init(NULL));
+
+    memset(&rx, 0, sizeof(rx));
+    rx.api = NULL;
+    rx.storage = &storage;
+    rx.link.send = rx_send;
+    rx.ackEvery = 1;
+    rx.persistEvery = 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_ota_init(&rx));
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, rx_boot(0, 1));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, rx_boot(NS_OTA_WINDOW_MAX + 1, 1));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, rx_boot(1, 0));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 8));
+    TEST_ASSERT_FALSE(rx.hasActive);
+    TEST_ASSERT_FALSE(rx.receiving);
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, tx_start(image, 1, 0));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, tx_start(image, 1, NS_OTA_WINDOW_MAX + 1));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 1, NS_OTA_WINDOW_MAX));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_STARTING, tx.state);
+    TEST_ASSERT_EQUAL(NUM_CHUNKS, tx.numChunks);
+}
+
+void ns_ota_sha256_test() {
+    // FIPS 180-4 examples
+    static const uint8_t abc[NS_OTA_HASH_SIZE] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde,
+        0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+        0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+    static const uint8_t two_blocks[NS_OTA_HASH_SIZE] = {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93,
+        0x0c, 0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+        0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1};
+    static const uint8_t empty[NS_OTA_HASH_SIZE] = {
+        0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8,
+        0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+        0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55};
+    const char *msg = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    uint8_t digest[NS_OTA_HASH_SIZE];
+    uint8_t split[NS_OTA_HASH_SIZE];
+    ns_ota_sha256_t h;
+    uint32_t i;
+
+    ns_ota_sha256((const uint8_t *)"abc", 3, digest);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(abc, digest, NS_OTA_HASH_SIZE);
+    ns_ota_sha256((const uint8_t *)msg, strlen(msg), digest);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(two_blocks, digest, NS_OTA_HASH_SIZE);
+    ns_ota_sha256(NULL, 0, digest);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(empty, digest, NS_OTA_HASH_SIZE);
+
+    // Piecewise updates of odd sizes give the same hash as one update
+    ns_ota_sha256(image, IMAGE_SIZE, digest);
+    ns_ota_sha256_init(&h);
+    for (i = 0; i < IMAGE_SIZE; i += 77) {
+        ns_ota_sha256_update(&h, image + i, (IMAGE_SIZE - i < 77) ? IMAGE_SIZE - i : 77);
+    }
+    ns_ota_sha256_final(&h, split);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(digest, split, NS_OTA_HASH_SIZE);
+}
+
+void ns_ota_transfer_test() {
+    ns_ota_image_t active;
+
+    storage_reset();
+    link_config(1, 1000, 0);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 1, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(NUM_CHUNKS, tx.stats.chunks);
+    TEST_ASSERT_EQUAL(0, tx.stats.retransmits);
+    TEST_ASSERT_EQUAL(NUM_CHUNKS, rx.stats.chunks);
+    TEST_ASSERT_TRUE(rx.stats.acks < NUM_CHUNKS / 2);
+
+    TEST_ASSERT_TRUE(ns_ota_get_active(&rx, &active));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_A, active.slot);
+    TEST_ASSERT_EQUAL(IMAGE_SIZE, active.size);
+    TEST_ASSERT_EQUAL(1, active.generation);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image, ns_ota_mem_storage_addr(&mem, active.slot), IMAGE_SIZE);
+
+    // The next image goes to the other slot, the running one is untouched
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image2, 2, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_TRUE(ns_ota_get_active(&rx, &active));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_B, active.slot);
+    TEST_ASSERT_EQUAL(2, active.generation);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image2, slotB, IMAGE_SIZE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image, slotA, IMAGE_SIZE);
+
+    // Survives a reboot
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_TRUE(ns_ota_get_active(&rx, &active));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_B, active.slot);
+    TEST_ASSERT_EQUAL(2, active.generation);
+    TEST_ASSERT_FALSE(rx.receiving);
+
+    // Offering the running image again completes without sending any data
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image2, 3, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(0, tx.stats.chunks);
+    TEST_ASSERT_EQUAL(2, rx.boot.generation);
+}
+
+void ns_ota_bad_chunk_test() {
+    ns_ota_start_t start;
+    uint32_t acks;
+
+    storage_reset();
+    link_config(1, 0, 0);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 4));
+
+    // DATA before START
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, send_data(7, 0, CHUNK_SIZE, false));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_UNKNOWN, lastAck.status);
+    TEST_ASSERT_EQUAL(0, rx.stats.chunks);
+
+    memset(&start, 0, sizeof(start));
+    start.type = NS_OTA_MSG_START;
+    start.chunkSize = CHUNK_SIZE;
+    start.transferId = 7;
+    start.imageSize = SLOT_SIZE + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_ota_receive(&rx, (uint8_t *)&start, sizeof(start)));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_REJECTED, lastAck.status);
+    TEST_ASSERT_FALSE(rx.receiving);
+
+    start.imageSize = IMAGE_SIZE;
+    ns_ota_sha256(image, IMAGE_SIZE, start.hash);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_ota_receive(&rx, (uint8_t *)&start, sizeof(start)));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_OK, lastAck.status);
+    TEST_ASSERT_EQUAL(0, lastAck.base);
+    TEST_ASSERT_TRUE(rx.receiving);
+
+    // Bad CRC, misaligned offset, wrong length, truncated message: dropped without an ACK
+    acks = ackCount;
+    send_data(7, 0, CHUNK_SIZE, true);
+    TEST_ASSERT_EQUAL(1, rx.stats.crcErrors);
+    send_data(7, 10, CHUNK_SIZE, false);
+    send_data(7, 0, CHUNK_SIZE - 1, false);
+    send_data(7, (NUM_CHUNKS - 1) * CHUNK_SIZE, CHUNK_SIZE, false);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_ota_receive(&rx, (uint8_t *)&start, 10));
+    TEST_ASSERT_EQUAL(4, rx.stats.badChunks);
+    TEST_ASSERT_EQUAL(acks, ackCount);
+    TEST_ASSERT_EQUAL(0, rx.stats.chunks);
+
+    // In order chunks are acknowledged every ackEvery
+    send_data(7, 0, CHUNK_SIZE, false);
+    send_data(7, CHUNK_SIZE, CHUNK_SIZE, false);
+    send_data(7, 2 * CHUNK_SIZE, CHUNK_SIZE, false);
+    TEST_ASSERT_EQUAL(acks, ackCount);
+    send_data(7, 3 * CHUNK_SIZE, CHUNK_SIZE, false);
+    TEST_ASSERT_EQUAL(acks + 1, ackCount);
+    TEST_ASSERT_EQUAL(4, lastAck.base);
+    TEST_ASSERT_EQUAL(2, rx.stats.saves); // One at START, one after 4 chunks
+
+    // A gap is reported at once, with the chunks past it in the selective bitmap
+    send_data(7, 6 * CHUNK_SIZE, CHUNK_SIZE, false);
+    TEST_ASSERT_EQUAL(acks + 2, ackCount);
+    TEST_ASSERT_EQUAL(4, lastAck.base);
+    TEST_ASSERT_EQUAL_HEX32(1u << 1, lastAck.sack);
+    TEST_ASSERT_EQUAL(5, lastAck.received);
+
+    // So is a duplicate
+    send_data(7, 0, CHUNK_SIZE, false);
+    TEST_ASSERT_EQUAL(acks + 3, ackCount);
+    TEST_ASSERT_EQUAL(1, rx.stats.duplicates);
+    TEST_ASSERT_EQUAL(5, rx.stats.chunks);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image, slotA, 4 * CHUNK_SIZE);
+}
+
+void ns_ota_resume_test() {
+    uint32_t before, sentBefore, saved;
+
+    storage_reset();
+    link_config(1, 1000, 20);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 8));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 9, 16));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_SENDING, sim_run(NUM_CHUNKS / 2));
+    before = rx.stats.chunks;
+    TEST_ASSERT_EQUAL(NUM_CHUNKS / 2, before);
+
+    // Receiver reset: everything since the last saved record is lost
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 8));
+    TEST_ASSERT_TRUE(rx.receiving);
+    saved = rx.progress.received;
+    TEST_ASSERT_TRUE(saved + 8 > before);
+    TEST_ASSERT_TRUE(saved <= before);
+
+    // The host restarts too and offers the same transfer, only the missing chunks are sent
+    sentBefore = tx.stats.chunks;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 9, 16));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(1, rx.stats.resumes);
+    TEST_ASSERT_EQUAL(NUM_CHUNKS - saved, rx.stats.chunks);
+    TEST_ASSERT_TRUE(tx.stats.chunks < NUM_CHUNKS - saved + 16);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image, slotA, IMAGE_SIZE);
+    TEST_ASSERT_TRUE(rx.hasActive);
+    ns_lp_printf("Resume: %d of %d chunks kept across the reset, %d + %d chunks sent\n", saved,
+                 NUM_CHUNKS, sentBefore, tx.stats.chunks);
+
+    // A reset without a new START: the sender keeps going on its own
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image2, 10, 16));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_SENDING, sim_run(rx.stats.chunks + NUM_CHUNKS / 3));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_B, rx.progress.slot);
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image2, slotB, IMAGE_SIZE);
+    TEST_ASSERT_EQUAL(2, rx.boot.generation);
+}
+
+void ns_ota_hash_mismatch_test() {
+    uint8_t wrong[NS_OTA_HASH_SIZE];
+    ns_ota_image_t active;
+
+    storage_reset();
+    link_config(1, 1000, 0);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 1, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+
+    // Announce one image, send another
+    ns_ota_sha256(image2, IMAGE_SIZE, wrong);
+    wrong[0] ^= 1;
+    memset(&tx, 0, sizeof(tx));
+    tx.api = &ns_ota_V0_0_1;
+    tx.image = image2;
+    tx.imageSize = IMAGE_SIZE;
+    tx.chunkSize = CHUNK_SIZE;
+    tx.transferId = 2;
+    tx.window = 8;
+    tx.timeout = TIMEOUT_US;
+    tx.link.send = tx_send;
+    tx.txBuf = txBuf;
+    tx.hash = wrong;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_ota_sender_init(&tx, now_us));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_FAILED, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_HASH_MISMATCH, tx.lastStatus);
+
+    // Still running the first image, and the dropped transfer does not resume
+    TEST_ASSERT_TRUE(ns_ota_get_active(&rx, &active));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_A, active.slot);
+    TEST_ASSERT_EQUAL(1, active.generation);
+    TEST_ASSERT_FALSE(rx.receiving);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_FALSE(rx.receiving);
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_A, rx.boot.slot);
+}
+
+void ns_ota_switch_power_loss_test() {
+    ns_ota_boot_t saved;
+
+    storage_reset();
+    link_config(1, 1000, 0);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 1, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image2, 2, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(2, rx.boot.generation);
+
+    // Generation 2 went to BOOT0; had power failed halfway through writing it, the CRC fails
+    // and generation 1 (slot A) is still the one that boots
+    memcpy(&saved, boot0, sizeof(saved));
+    boot0[sizeof(boot0) / 2] ^= 0x5A;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(1, rx.boot.generation);
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_A, rx.boot.slot);
+
+    // Power lost after the switch but before the progress record was cleared: the record
+    // points at the now active slot and is ignored
+    memcpy(boot0, &saved, sizeof(saved));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 3, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_SENDING, sim_run(NUM_CHUNKS / 2));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_A, rx.progress.slot);
+    saved.generation = 3;
+    saved.slot = NS_OTA_REGION_SLOT_A;
+    saved.crc = CalcCrc32(0xFFFFFFFF, offsetof(ns_ota_boot_t, crc), (uint8_t *)&saved);
+    memcpy(boot1, &saved, sizeof(saved));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(3, rx.boot.generation);
+    TEST_ASSERT_FALSE(rx.receiving);
+}
+
+// Effective throughput of the same lossy link with stop-and-wait and with a window
+static uint32_t throughput(uint8_t window, uint16_t ackEvery, uint32_t lossPermille) {
+    uint32_t elapsed;
+
+    storage_reset();
+    link_config(1, 1000, lossPermille); // ~1 MB/s, 1 ms each way
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(ackEvery, 16));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 1, window));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image, slotA, IMAGE_SIZE);
+    elapsed = now_us;
+
+    ns_lp_printf("Window %2d, loss %2d%%: %d ms, %d KB/s, %d retransmits (%d on timeout), %d "
+                 "acks, %d of %d messages lost\n",
+                 window, lossPermille / 10, elapsed / 1000,
+                 (uint32_t)((uint64_t)IMAGE_SIZE * 1000 / elapsed), tx.stats.retransmits,
+                 tx.stats.timeouts, rx.stats.acks, toRx.lost + toTx.lost, toRx.sent + toTx.sent);
+    return (uint32_t)((uint64_t)IMAGE_SIZE * 1000000 / elapsed);
+}
+
+void ns_ota_lossy_throughput_test() {
+    uint32_t stopAndWait, windowed, lossless;
+
+    lossless = throughput(16, 4, 0);
+    stopAndWait = throughput(1, 1, 50);
+    windowed = throughput(16, 4, 50);
+
+    // Stop-and-wait pays a round trip per chunk, the window keeps the link busy
+    TEST_ASSERT_TRUE(windowed > 3 * stopAndWait);
+    TEST_ASSERT_TRUE(windowed > lossless / 2);
+}
+
+void ns_ota_delta_test() {
+    static uint8_t bad[PATCH_MAX];
+    uint8_t hash[NS_OTA_HASH_SIZE];
+    uint32_t steps[] = {UINT32_MAX, 1, 7, 0};
+    uint32_t i, op;
+
+    storage_reset();
+    patch_build(image, IMAGE_SIZE);
+    TEST_ASSERT_TRUE(patchLen < targetLen / 20);
+
+    // Any split of the patch rebuilds the same image
+    for (i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        TEST_ASSERT_EQUAL(NS_OTA_DELTA_OK, delta_apply(patch, patchLen, steps[i]));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(target, slotB, targetLen);
+        TEST_ASSERT_EQUAL(targetLen, delta.copied + delta.inserted);
+        TEST_ASSERT_EQUAL(50 + 38, delta.inserted);
+    }
+
+    // Made for another image
+    patch_build(image2, IMAGE_SIZE);
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_SOURCE, delta_apply(patch, patchLen, 0));
+    ns_ota_sha256(image, IMAGE_SIZE, hash);
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG,
+                      ns_ota_delta_begin(&delta, &storage, NS_OTA_REGION_SLOT_A, IMAGE_SIZE, hash,
+                                         NS_OTA_REGION_SLOT_A));
+
+    patch_build(image, IMAGE_SIZE);
+    op = sizeof(ns_ota_delta_header_t); // First op, COPY 1000 with a LEB128 length
+    memcpy(bad, patch, patchLen);
+    bad[0] ^= 1;
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_HEADER, delta_apply(bad, patchLen, 0));
+    memcpy(bad, patch, patchLen);
+    bad[op] = 0x80;
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_OP, delta_apply(bad, patchLen, 0));
+    memcpy(bad, patch, patchLen);
+    bad[op + 5] ^= 1; // Inserted data
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_HASH, delta_apply(bad, patchLen, 0));
+    memcpy(bad, patch, patchLen);
+    bad[op + 3] = 2; // Offset +1, the copies after it run past the end of the source
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_RANGE, delta_apply(bad, patchLen, 0));
+    memcpy(bad, patch, patchLen);
+    bad[op + 3] = 1; // Offset -1, before the start of the source
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_RANGE, delta_apply(bad, patchLen, 0));
+    memcpy(bad, patch, patchLen);
+    bad[op + 2] = 0xFF; // Length far beyond the target
+    bad[op + 3] = 0x7F;
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_RANGE, delta_apply(bad, patchLen, 0));
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_LENGTH, delta_apply(patch, patchLen - 1, 0));
+    memcpy(bad, patch, patchLen);
+    bad[patchLen] = 0;
+    TEST_ASSERT_EQUAL(NS_OTA_DELTA_ERR_LENGTH, delta_apply(bad, patchLen + 1, 0));
+}
+
+// Delta transfer over the lossy link, on top of a full one
+static ns_ota_sender_state_e delta_send(uint32_t transferId, uint32_t lossPermille,
+                                        uint32_t stopAfter) {
+    toRx.lossPermille = toTx.lossPermille = lossPermille;
+    toTx.tail = toTx.head;
+    memset(&tx, 0, sizeof(tx));
+    tx.api = &ns_ota_V0_0_1;
+    tx.image = patch;
+    tx.imageSize = patchLen;
+    tx.chunkSize = 32;
+    tx.transferId = transferId;
+    tx.window = 8;
+    tx.timeout = TIMEOUT_US;
+    tx.link.send = tx_send;
+    tx.txBuf = txBuf;
+    tx.flags = NS_OTA_START_DELTA;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_ota_sender_init(&tx, now_us));
+    return sim_run(stopAfter);
+}
+
+void ns_ota_delta_transfer_test() {
+    ns_ota_image_t active;
+
+    storage_reset();
+    link_config(1, 1000, 0);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    patch_build(image, IMAGE_SIZE);
+
+    // Nothing to patch yet, and a receiver without an applier refuses deltas
+    rx.delta = &delta;
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_FAILED, delta_send(1, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_REJECTED, tx.lastStatus);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, tx_start(image, 2, 8));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, sim_run(UINT32_MAX));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_FAILED, delta_send(3, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_REJECTED, tx.lastStatus);
+
+    // An interrupted delta is not resumed, the sender starts it over
+    rx.delta = &delta;
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_SENDING, delta_send(4, 0, 3));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, rx_boot(4, 16));
+    TEST_ASSERT_FALSE(rx.receiving);
+
+    // Lost chunks make the sender go back, the patch is still applied in order
+    rx.delta = &delta;
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, delta_send(4, 100, UINT32_MAX));
+    TEST_ASSERT_TRUE(tx.stats.retransmits > 0);
+    TEST_ASSERT_TRUE(rx.stats.outOfOrder > 0);
+    TEST_ASSERT_TRUE(ns_ota_get_active(&rx, &active));
+    TEST_ASSERT_EQUAL(NS_OTA_REGION_SLOT_B, active.slot);
+    TEST_ASSERT_EQUAL(2, active.generation);
+    TEST_ASSERT_EQUAL(targetLen, active.size);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(target, slotB, targetLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(image, slotA, IMAGE_SIZE);
+
+    // The same patch again is already done; one for another target no longer applies
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_DONE, delta_send(5, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL(0, tx.stats.chunks);
+    ns_ota_sha256(image2, IMAGE_SIZE, patch + offsetof(ns_ota_delta_header_t, targetHash));
+    TEST_ASSERT_EQUAL(NS_OTA_SENDER_FAILED, delta_send(6, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL(NS_OTA_ACK_PATCH_ERROR, tx.lastStatus);
+    TEST_ASSERT_EQUAL(2, rx.boot.generation);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(target, slotB, targetLen);
+}
@@ -0,0 +1,15 @@
+#include "ns_core.h"
+#include "ns_ota.h"
+
+void ns_ota_tests_pre_test_hook();
+void ns_ota_tests_post_test_hook();
+void ns_ota_init_test();
+void ns_ota_sha256_test();
+void ns_ota_transfer_test();
+void ns_ota_bad_chunk_test();
+void ns_ota_resume_test();
+void ns_ota_hash_mismatch_test();
+void ns_ota_switch_power_loss_test();
+void ns_ota_lossy_throughput_test();
+void ns_ota_delta_test();
+void ns_ota_delta_transfer_test();
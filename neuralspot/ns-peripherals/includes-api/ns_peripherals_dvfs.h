@@ -0,0 +1,232 @@
+/**
+ * @file ns_peripherals_dvfs.h
+ * @author Ambiq
+ * @brief Deadline-driven performance mode governor
+ * @version 0.1
+ * @date 2025-07-23
+ *
+ * Instead of picking one ns_power_mode_e for the whole application, the governor switches
+ * modes around pipeline stages. The application declares its stages (e.g. capture, features,
+ * inference) with a deadline each, and brackets every execution with ns_dvfs_stage_begin()
+ * and ns_dvfs_stage_end(). The governor:
+ *
+ * - measures each stage's execution time in the mode it ran in
+ * - runs a stage in lowMode when its predicted time (plus margin) meets the deadline, and in
+ *   highMode only when it would otherwise miss it
+ * - drops back to lowMode as soon as the stage ends
+ * - estimates energy per inference (one ns_dvfs_frame_begin() to the next) from a calibrated
+ *   cost table
+ *
+ * Hardware is reached through ns_dvfs_port_t. ns_dvfs_hw_port drives ns_set_performance_mode()
+ * and NS_TIMER_COUNTER; ns_dvfs_sim replays recorded stage timings on the host, so policies
+ * can be evaluated without a board.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-dvfs
+ *  @{
+ */
+
+#ifndef NS_DVFS_H
+    #define NS_DVFS_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include "ns_peripherals_power.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_DVFS_V0_0_1                                                                         \
+        { .major = 0, .minor = 0, .revision = 1 }
+
+    #define NS_DVFS_OLDEST_SUPPORTED_VERSION NS_DVFS_V0_0_1
+    #define NS_DVFS_CURRENT_VERSION NS_DVFS_V0_0_1
+    #define NS_DVFS_API_ID 0xCA0011
+
+    #define NS_DVFS_NUM_MODES (NS_MAXIMUM_PERF + 1)
+
+extern const ns_core_api_t ns_dvfs_V0_0_1;
+extern const ns_core_api_t ns_dvfs_oldest_supported_version;
+extern const ns_core_api_t ns_dvfs_current_version;
+
+/// Hardware access used by the governor
+typedef struct {
+    uint32_t (*init)(void *ctx); ///< Optional, called by ns_dvfs_init
+    void (*set_mode)(void *ctx, ns_power_mode_e mode);
+    uint32_t (*now_us)(void *ctx); ///< Free-running microsecond clock
+    void *ctx;
+} ns_dvfs_port_t;
+
+/// Calibrated cost of running in one mode
+typedef struct {
+    float activeUw; ///< Power while executing a stage, in microwatts
+    float speedup;  ///< Throughput relative to NS_MINIMUM_PERF, used until a stage is measured
+    float switchUs; ///< Time to switch into this mode
+    float switchUj; ///< Energy to switch into this mode
+} ns_dvfs_mode_cost_t;
+
+typedef struct {
+    ns_dvfs_mode_cost_t mode[NS_DVFS_NUM_MODES];
+    float idleUw; ///< Power outside of stages (sleeping, waiting for data)
+} ns_dvfs_cost_table_t;
+
+/// Representative Apollo4/5 EVB numbers - calibrate for your board (e.g. with ns_energy_monitor)
+extern const ns_dvfs_cost_table_t ns_dvfs_default_costs;
+
+/// A pipeline stage, declared by the application
+typedef struct {
+    const char *name;
+    uint32_t deadlineUs; ///< Time budget from ns_dvfs_stage_begin(), including mode switch
+
+    // Measured by the governor
+    uint32_t estUs[NS_DVFS_NUM_MODES]; ///< Smoothed execution time per mode, 0 if never run
+    uint32_t lastUs;
+    uint32_t worstUs;
+    ns_power_mode_e lastMode;
+    uint32_t runs;
+    uint32_t boosts; ///< Runs in highMode
+    uint32_t misses; ///< Runs that took longer than deadlineUs
+    uint32_t probes; ///< Runs in lowMode to refresh its estimate, see probePeriod
+    uint32_t boostStreak; ///< Consecutive runs in highMode
+    float lastEnergyUj;
+} ns_dvfs_stage_t;
+
+typedef struct {
+    uint32_t frames;          ///< Closed frames (inferences)
+    uint32_t stageRuns;
+    uint32_t boosts;
+    uint32_t misses;
+    uint32_t switches;        ///< Mode changes requested from the port
+    float totalEnergyUj;      ///< Sum over closed frames
+    float lastFrameEnergyUj;
+    uint32_t lastFrameUs;
+} ns_dvfs_stats_t;
+
+typedef struct {
+    const ns_core_api_t *api;
+    const ns_dvfs_port_t *port;
+    const ns_dvfs_cost_table_t *costs; ///< NULL for ns_dvfs_default_costs
+    ns_dvfs_stage_t *stages;
+    uint32_t numStages;
+    ns_power_mode_e lowMode;  ///< Mode outside of boosted stages, usually NS_MINIMUM_PERF
+    ns_power_mode_e highMode; ///< Boost mode, usually NS_MAXIMUM_PERF
+    uint32_t marginPct;       ///< Safety margin added to predicted stage times
+    uint8_t ewmaShift;        ///< Estimate smoothing, new = old + (sample - old) >> ewmaShift
+    uint32_t probePeriod;     ///< Run a stage in lowMode after this many boosts in a row, 0 never
+
+    // Internal state
+    ns_power_mode_e mode;
+    int32_t current;          ///< Stage in progress, -1 if none
+    uint32_t stageStartUs;
+    bool frameOpen;
+    uint32_t frameStartUs;
+    uint32_t frameActiveUs;
+    float frameEnergyUj;
+    ns_dvfs_stats_t stats;
+} ns_dvfs_t;
+
+/// Drives ns_set_performance_mode() and times stages with NS_TIMER_COUNTER
+extern const ns_dvfs_port_t ns_dvfs_hw_port;
+
+/**
+ * @brief Initialize the governor and switch to lowMode
+ *
+ * @param g api, port, stages and numStages must be set, every stage needs a deadline
+ * @return uint32_t status
+ */
+extern uint32_t ns_dvfs_init(ns_dvfs_t *g);
+
+/**
+ * @brief Start a stage, switching to highMode if lowMode is predicted to miss the deadline
+ *
+ * A stage that has never run in any mode is run in highMode. A stage that has only run in
+ * highMode is predicted from the cost table's speedup, which is optimistic for memory bound
+ * stages - set probePeriod to measure lowMode now and then (at the risk of a miss).
+ *
+ * @param g
+ * @param stage index into g->stages
+ * @return ns_power_mode_e the mode the stage runs in
+ */
+extern ns_power_mode_e ns_dvfs_stage_begin(ns_dvfs_t *g, uint32_t stage);
+
+/**
+ * @brief End the current stage: record its time and energy, and return to lowMode
+ *
+ * @return uint32_t the stage's execution time in microseconds
+ */
+extern uint32_t ns_dvfs_stage_end(ns_dvfs_t *g);
+
+/**
+ * @brief Predicted execution time of a stage in a mode, 0 if unknown
+ */
+extern uint32_t ns_dvfs_predict_us(const ns_dvfs_t *g, uint32_t stage, ns_power_mode_e mode);
+
+/**
+ * @brief Start a frame (one inference period). Closes the previous frame, if any, so its
+ * energy includes the idle time up to now.
+ */
+extern void ns_dvfs_frame_begin(ns_dvfs_t *g);
+
+/**
+ * @brief Close the current frame without starting another
+ */
+extern void ns_dvfs_frame_end(ns_dvfs_t *g);
+
+/**
+ * @brief Average estimated energy per closed frame, in microjoules
+ */
+extern float ns_dvfs_energy_per_inference_uj(const ns_dvfs_t *g);
+
+/**
+ * @brief Clear statistics and measurements (stage estimates are kept)
+ */
+extern void ns_dvfs_stats_reset(ns_dvfs_t *g);
+
+/// Replayed timing of one stage execution
+typedef struct {
+    uint32_t us[NS_DVFS_NUM_MODES]; ///< Time per mode, 0 to scale from us[NS_MINIMUM_PERF]
+} ns_dvfs_sim_sample_t;
+
+/// Host-side simulator: a virtual clock and power mode behind an ns_dvfs_port_t
+typedef struct {
+    ns_dvfs_port_t port;
+    const ns_dvfs_cost_table_t *costs;
+    uint32_t nowUs;
+    ns_power_mode_e mode;
+} ns_dvfs_sim_t;
+
+/**
+ * @brief Attach a simulator to a governor (sets g->port), call before ns_dvfs_init()
+ */
+extern void ns_dvfs_sim_init(ns_dvfs_sim_t *sim, ns_dvfs_t *g);
+
+/**
+ * @brief Advance virtual time, e.g. for work outside of stages
+ */
+extern void ns_dvfs_sim_advance(ns_dvfs_sim_t *sim, uint32_t us);
+
+/**
+ * @brief Replay recorded stage timings through the governor
+ *
+ * Each frame starts every framePeriodUs (or immediately, if the previous one overran) and
+ * runs every stage in order. Switching modes costs the table's switchUs.
+ *
+ * @param g initialized governor attached to sim
+ * @param sim
+ * @param trace [numFrames][g->numStages] stage timings
+ * @param numFrames
+ * @param framePeriodUs 0 to run frames back to back
+ * @return uint32_t status
+ */
+extern uint32_t ns_dvfs_sim_run(
+    ns_dvfs_t *g, ns_dvfs_sim_t *sim, const ns_dvfs_sim_sample_t *trace, uint32_t numFrames,
+    uint32_t framePeriodUs);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_DVFS_H
+/** @}*/
@@ -0,0 +1,35 @@
+/**
+ * @file ns_peripherals_sched.h
+ * @author Ambiq
+ * @brief Apollo port for the ns-core scheduler
+ * @version 0.1
+ * @date 2025-08-18
+ *
+ * The scheduler itself (ns_sched.h) only knows the platform through ns_sched_port_t, so it
+ * stays in ns-core. The Apollo port needs ns_deep_sleep() and ns-utils' NS_TIMER_COUNTER,
+ * so it lives here with the other power management code.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-sched
+ *  @{
+ */
+
+#ifndef NS_PERIPHERALS_SCHED_H
+    #define NS_PERIPHERALS_SCHED_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_sched.h"
+
+/// Sleeps in ns_deep_sleep() and times with NS_TIMER_COUNTER, started by ns_sched_init().
+/// Shares the counter if the application already started it.
+extern const ns_sched_port_t ns_sched_hw_port;
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_PERIPHERALS_SCHED_H
+/** @}*/
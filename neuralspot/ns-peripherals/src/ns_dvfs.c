@@ -0,0 +1,222 @@
+/**
+ * @file ns_dvfs.c
+ * @author Ambiq
+ * @brief Deadline-driven performance mode governor
+ * @version 0.1
+ * @date 2025-07-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_peripherals_dvfs.h"
+#include <string.h>
+
+const ns_core_api_t ns_dvfs_V0_0_1 = {.apiId = NS_DVFS_API_ID, .version = NS_DVFS_V0_0_1};
+const ns_core_api_t ns_dvfs_oldest_supported_version = {
+    .apiId = NS_DVFS_API_ID, .version = NS_DVFS_V0_0_1};
+const ns_core_api_t ns_dvfs_current_version = {
+    .apiId = NS_DVFS_API_ID, .version = NS_DVFS_V0_0_1};
+
+// NS_MEDIUM_PERF selects the same high performance MCU mode as NS_MAXIMUM_PERF
+const ns_dvfs_cost_table_t ns_dvfs_default_costs = {
+    .mode =
+        {
+            [NS_MINIMUM_PERF] = {.activeUw = 2400.0f, .speedup = 1.0f},
+            [NS_MEDIUM_PERF] =
+                {.activeUw = 5200.0f, .speedup = 2.0f, .switchUs = 20.0f, .switchUj = 0.1f},
+            [NS_MAXIMUM_PERF] =
+                {.activeUw = 5200.0f, .speedup = 2.0f, .switchUs = 20.0f, .switchUj = 0.1f},
+        },
+    .idleUw = 20.0f,
+};
+
+static const ns_dvfs_cost_table_t *ns_dvfs_costs(const ns_dvfs_t *g) {
+    return g->costs ? g->costs : &ns_dvfs_default_costs;
+}
+
+static void ns_dvfs_set_mode(ns_dvfs_t *g, ns_power_mode_e mode) {
+    if (mode == g->mode) {
+        return;
+    }
+    g->port->set_mode(g->port->ctx, mode);
+    g->mode = mode;
+    g->stats.switches++;
+    g->frameEnergyUj += ns_dvfs_costs(g)->mode[mode].switchUj;
+}
+
+uint32_t ns_dvfs_init(ns_dvfs_t *g) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (g == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(g->api, &ns_dvfs_oldest_supported_version, &ns_dvfs_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((g->port == NULL) || (g->port->set_mode == NULL) || (g->port->now_us == NULL) ||
+        (g->stages == NULL) || (g->numStages == 0) || (g->lowMode > g->highMode) ||
+        (g->highMode >= NS_DVFS_NUM_MODES) || (g->ewmaShift > 8)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    for (uint32_t i = 0; i < g->numStages; i++) {
+        if (g->stages[i].deadlineUs == 0) {
+            return NS_STATUS_INVALID_CONFIG;
+        }
+    }
+#endif
+
+    if (g->port->init != NULL) {
+        uint32_t status = g->port->init(g->port->ctx);
+        if (status != NS_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    for (uint32_t i = 0; i < g->numStages; i++) {
+        memset(g->stages[i].estUs, 0, sizeof(g->stages[i].estUs));
+    }
+    ns_dvfs_stats_reset(g);
+
+    g->current = -1;
+    g->frameOpen = false;
+    g->mode = g->lowMode;
+    g->port->set_mode(g->port->ctx, g->lowMode);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_dvfs_stats_reset(ns_dvfs_t *g) {
+    memset(&g->stats, 0, sizeof(g->stats));
+    for (uint32_t i = 0; i < g->numStages; i++) {
+        ns_dvfs_stage_t *s = &g->stages[i];
+        s->lastUs = 0;
+        s->worstUs = 0;
+        s->lastMode = g->lowMode;
+        s->runs = 0;
+        s->boosts = 0;
+        s->misses = 0;
+        s->probes = 0;
+        s->boostStreak = 0;
+        s->lastEnergyUj = 0.0f;
+    }
+}
+
+uint32_t ns_dvfs_predict_us(const ns_dvfs_t *g, uint32_t stage, ns_power_mode_e mode) {
+    const ns_dvfs_stage_t *s = &g->stages[stage];
+    const ns_dvfs_cost_table_t *costs = ns_dvfs_costs(g);
+
+    if (s->estUs[mode] != 0) {
+        return s->estUs[mode];
+    }
+    // Not measured in this mode yet - scale from the mode that was measured most recently
+    if (s->runs != 0 && s->estUs[s->lastMode] != 0) {
+        return (uint32_t)(s->estUs[s->lastMode] * costs->mode[s->lastMode].speedup /
+                          costs->mode[mode].speedup);
+    }
+    return 0;
+}
+
+ns_power_mode_e ns_dvfs_stage_begin(ns_dvfs_t *g, uint32_t stage) {
+    ns_power_mode_e mode = g->highMode;
+
+    if (stage >= g->numStages) {
+        return g->mode;
+    }
+
+    ns_dvfs_stage_t *s = &g->stages[stage];
+    uint32_t predicted = ns_dvfs_predict_us(g, stage, g->lowMode);
+    if (predicted != 0) {
+        // Staying in lowMode costs nothing to switch, so only the margin is added
+        uint64_t withMargin = (uint64_t)predicted * (100 + g->marginPct) / 100;
+        if (withMargin <= s->deadlineUs) {
+            mode = g->lowMode;
+        } else if (g->probePeriod != 0 && s->boostStreak >= g->probePeriod) {
+            mode = g->lowMode;
+            s->probes++;
+        }
+    }
+
+    // The switch itself counts against the deadline
+    g->stageStartUs = g->port->now_us(g->port->ctx);
+    g->current = (int32_t)stage;
+    ns_dvfs_set_mode(g, mode);
+    return mode;
+}
+
+uint32_t ns_dvfs_stage_end(ns_dvfs_t *g) {
+    if (g->current < 0) {
+        return 0;
+    }
+
+    ns_dvfs_stage_t *s = &g->stages[g->current];
+    uint32_t elapsed = g->port->now_us(g->port->ctx) - g->stageStartUs;
+    ns_power_mode_e mode = g->mode;
+
+    if (s->estUs[mode] == 0 || g->ewmaShift == 0) {
+        s->estUs[mode] = elapsed;
+    } else {
+        int32_t delta = (int32_t)(elapsed - s->estUs[mode]);
+        s->estUs[mode] = (uint32_t)((int32_t)s->estUs[mode] + (delta >> g->ewmaShift));
+    }
+    if (s->estUs[mode] == 0) {
+        s->estUs[mode] = 1; // 0 means unknown
+    }
+
+    s->lastUs = elapsed;
+    s->worstUs = MAX(s->worstUs, elapsed);
+    s->lastMode = mode;
+    s->runs++;
+    g->stats.stageRuns++;
+    if (mode != g->lowMode) {
+        s->boosts++;
+        s->boostStreak++;
+        g->stats.boosts++;
+    } else {
+        s->boostStreak = 0;
+    }
+    if (elapsed > s->deadlineUs) {
+        s->misses++;
+        g->stats.misses++;
+    }
+
+    s->lastEnergyUj = ns_dvfs_costs(g)->mode[mode].activeUw * elapsed / 1e6f;
+    g->frameEnergyUj += s->lastEnergyUj;
+    g->frameActiveUs += elapsed;
+    g->current = -1;
+
+    ns_dvfs_set_mode(g, g->lowMode);
+    return elapsed;
+}
+
+static void ns_dvfs_frame_close(ns_dvfs_t *g, uint32_t now) {
+    uint32_t frameUs = now - g->frameStartUs;
+    uint32_t idleUs = (frameUs > g->frameActiveUs) ? frameUs - g->frameActiveUs : 0;
+
+    g->frameEnergyUj += ns_dvfs_costs(g)->idleUw * idleUs / 1e6f;
+    g->stats.lastFrameEnergyUj = g->frameEnergyUj;
+    g->stats.lastFrameUs = frameUs;
+    g->stats.totalEnergyUj += g->frameEnergyUj;
+    g->stats.frames++;
+    g->frameOpen = false;
+}
+
+void ns_dvfs_frame_begin(ns_dvfs_t *g) {
+    uint32_t now = g->port->now_us(g->port->ctx);
+    if (g->frameOpen) {
+        ns_dvfs_frame_close(g, now);
+    }
+    g->frameOpen = true;
+    g->frameStartUs = now;
+    g->frameActiveUs = 0;
+    g->frameEnergyUj = 0.0f;
+}
+
+void ns_dvfs_frame_end(ns_dvfs_t *g) {
+    if (g->frameOpen) {
+        ns_dvfs_frame_close(g, g->port->now_us(g->port->ctx));
+    }
+}
+
+float ns_dvfs_energy_per_inference_uj(const ns_dvfs_t *g) {
+    return g->stats.frames ? g->stats.totalEnergyUj / g->stats.frames : 0.0f;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file ns_dvfs_hw.c
+ * @author Ambiq
+ * @brief DVFS governor port for ns_set_performance_mode and NS_TIMER_COUNTER
+ * @version 0.1
+ * @date 2025-07-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "am_mcu_apollo.h"
+#include "ns_peripherals_dvfs.h"
+#include "ns_timer.h"
+
+static ns_timer_config_t ns_dvfs_hw_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+static uint32_t ns_dvfs_hw_init(void *ctx) {
+    // Share the counter if the application already started it, restarting it would disturb
+    // the application's own timing
+    if (ns_timer_get_config(NS_TIMER_COUNTER) != NULL) {
+        return NS_STATUS_SUCCESS;
+    }
+    return ns_timer_init(&ns_dvfs_hw_timer);
+}
+
+static void ns_dvfs_hw_set_mode(void *ctx, ns_power_mode_e mode) {
+    ns_set_performance_mode(mode);
+}
+
+static uint32_t ns_dvfs_hw_now_us(void *ctx) {
+    return ns_us_ticker_read(ns_timer_get_config(NS_TIMER_COUNTER));
+}
+
+const ns_dvfs_port_t ns_dvfs_hw_port = {
+    .init = ns_dvfs_hw_init,
+    .set_mode = ns_dvfs_hw_set_mode,
+    .now_us = ns_dvfs_hw_now_us,
+    .ctx = NULL,
+};
@@ -0,0 +1,69 @@
+/**
+ * @file ns_dvfs_sim.c
+ * @author Ambiq
+ * @brief Host-side simulator for the DVFS governor - replays recorded stage timings
+ * @version 0.1
+ * @date 2025-07-23
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_peripherals_dvfs.h"
+
+static void ns_dvfs_sim_set_mode(void *ctx, ns_power_mode_e mode) {
+    ns_dvfs_sim_t *sim = (ns_dvfs_sim_t *)ctx;
+    sim->nowUs += (uint32_t)sim->costs->mode[mode].switchUs;
+    sim->mode = mode;
+}
+
+static uint32_t ns_dvfs_sim_now_us(void *ctx) { return ((ns_dvfs_sim_t *)ctx)->nowUs; }
+
+void ns_dvfs_sim_init(ns_dvfs_sim_t *sim, ns_dvfs_t *g) {
+    sim->port.init = NULL;
+    sim->port.set_mode = ns_dvfs_sim_set_mode;
+    sim->port.now_us = ns_dvfs_sim_now_us;
+    sim->port.ctx = sim;
+    sim->costs = g->costs ? g->costs : &ns_dvfs_default_costs;
+    sim->nowUs = 0;
+    sim->mode = g->lowMode;
+    g->port = &sim->port;
+}
+
+void ns_dvfs_sim_advance(ns_dvfs_sim_t *sim, uint32_t us) { sim->nowUs += us; }
+
+static uint32_t ns_dvfs_sim_stage_us(const ns_dvfs_sim_t *sim, const ns_dvfs_sim_sample_t *s) {
+    if (s->us[sim->mode] != 0) {
+        return s->us[sim->mode];
+    }
+    return (uint32_t)(s->us[NS_MINIMUM_PERF] * sim->costs->mode[NS_MINIMUM_PERF].speedup /
+                      sim->costs->mode[sim->mode].speedup);
+}
+
+uint32_t ns_dvfs_sim_run(
+    ns_dvfs_t *g, ns_dvfs_sim_t *sim, const ns_dvfs_sim_sample_t *trace, uint32_t numFrames,
+    uint32_t framePeriodUs) {
+    if (g->port != &sim->port) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+
+    uint32_t frameStart = sim->nowUs;
+    for (uint32_t f = 0; f < numFrames; f++) {
+        // Sleep until the next period, unless the previous frame overran
+        if ((int32_t)(frameStart - sim->nowUs) > 0) {
+            sim->nowUs = frameStart;
+        }
+        ns_dvfs_frame_begin(g);
+        for (uint32_t s = 0; s < g->numStages; s++) {
+            ns_dvfs_stage_begin(g, s);
+            sim->nowUs += ns_dvfs_sim_stage_us(sim, &trace[f * g->numStages + s]);
+            ns_dvfs_stage_end(g);
+        }
+        frameStart += framePeriodUs;
+    }
+    if ((int32_t)(frameStart - sim->nowUs) > 0) {
+        sim->nowUs = frameStart;
+    }
+    ns_dvfs_frame_end(g);
+    return NS_STATUS_SUCCESS;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file ns_sched_hw.c
+ * @author Ambiq
+ * @brief Scheduler port for Apollo: deep sleep when idle, NS_TIMER_COUNTER for timing
+ * @version 0.1
+ * @date 2025-08-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "am_mcu_apollo.h"
+#include "ns_peripherals_power.h"
+#include "ns_peripherals_sched.h"
+#include "ns_timer.h"
+
+static ns_timer_config_t ns_sched_hw_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+static uint32_t ns_sched_hw_init(void *ctx) {
+    // Share the counter if the application already started it
+    if (ns_timer_get_config(NS_TIMER_COUNTER) == NULL) {
+        return ns_timer_init(&ns_sched_hw_timer);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static uint32_t ns_sched_hw_now_us(void *ctx) {
+    return ns_us_ticker_read(ns_timer_get_config(NS_TIMER_COUNTER));
+}
+
+// Entered with interrupts masked: WFI still wakes on a pending interrupt, whose handler
+// runs (and posts) once ns_sched_run() unmasks.
+static void ns_sched_hw_idle(void *ctx) { ns_deep_sleep(); }
+
+static uint32_t ns_sched_hw_lock(void *ctx) { return am_hal_interrupt_master_disable(); }
+
+static void ns_sched_hw_unlock(void *ctx, uint32_t state) { am_hal_interrupt_master_set(state); }
+
+const ns_sched_port_t ns_sched_hw_port = {
+    .init = ns_sched_hw_init,
+    .now_us = ns_sched_hw_now_us,
+    .idle = ns_sched_hw_idle,
+    .wake = NULL,
+    .lock = ns_sched_hw_lock,
+    .unlock = ns_sched_hw_unlock,
+    .ctx = NULL,
+};
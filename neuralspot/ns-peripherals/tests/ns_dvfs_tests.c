@@ -0,0 +1,281 @@
+#include "unity/unity.h"
+#include "ns_dvfs_tests.h"
+#include <string.h>
+
+// All tests run the governor against ns_dvfs_sim's virtual clock, replaying synthetic stage
+// timings. Times in the traces are for NS_MINIMUM_PERF unless given per mode.
+
+#define DV_MAX_FRAMES 64
+#define DV_CAPTURE 0
+#define DV_FEATURES 1
+#define DV_INFERENCE 2
+
+static const ns_dvfs_cost_table_t dv_costs = {
+    .mode =
+        {
+            [NS_MINIMUM_PERF] = {.activeUw = 1000.0f, .speedup = 1.0f},
+            [NS_MEDIUM_PERF] = {.activeUw = 1500.0f, .speedup = 1.5f, .switchUs = 10.0f},
+            [NS_MAXIMUM_PERF] =
+                {.activeUw = 3000.0f, .speedup = 2.0f, .switchUs = 10.0f, .switchUj = 0.5f},
+        },
+    .idleUw = 10.0f,
+};
+
+static ns_dvfs_stage_t stages[3];
+static ns_dvfs_t gov;
+static ns_dvfs_sim_t sim;
+static ns_dvfs_sim_sample_t trace[DV_MAX_FRAMES * 3];
+
+static void dv_setup(uint32_t numStages, uint32_t marginPct) {
+    memset(stages, 0, sizeof(stages));
+    memset(&gov, 0, sizeof(gov));
+    stages[DV_CAPTURE].name = "capture";
+    stages[DV_CAPTURE].deadlineUs = 10000;
+    stages[DV_FEATURES].name = "features";
+    stages[DV_FEATURES].deadlineUs = 4000;
+    stages[DV_INFERENCE].name = "inference";
+    stages[DV_INFERENCE].deadlineUs = 20000;
+
+    gov.api = &ns_dvfs_V0_0_1;
+    gov.costs = &dv_costs;
+    gov.stages = stages;
+    gov.numStages = numStages;
+    gov.lowMode = NS_MINIMUM_PERF;
+    gov.highMode = NS_MAXIMUM_PERF;
+    gov.marginPct = marginPct;
+    gov.ewmaShift = 2;
+    ns_dvfs_sim_init(&sim, &gov);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_dvfs_init(&gov));
+}
+
+// Fill a trace where every frame has the same low-mode timings
+static void dv_trace(uint32_t numFrames, uint32_t capture, uint32_t features, uint32_t inference) {
+    memset(trace, 0, sizeof(trace));
+    for (uint32_t f = 0; f < numFrames; f++) {
+        trace[f * 3 + DV_CAPTURE].us[NS_MINIMUM_PERF] = capture;
+        trace[f * 3 + DV_FEATURES].us[NS_MINIMUM_PERF] = features;
+        trace[f * 3 + DV_INFERENCE].us[NS_MINIMUM_PERF] = inference;
+    }
+}
+
+void ns_dvfs_tests_pre_test_hook() {}
+
+void ns_dvfs_tests_post_test_hook() {}
+
+void ns_dvfs_init_validation_test() {
+    ns_dvfs_t bad;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_dvfs_init(NULL));
+
+    dv_setup(3, 0);
+    ns_core_api_t future = {.apiId = NS_DVFS_API_ID, .version = {.major = 9}};
+    bad = gov;
+    bad.api = &future;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_dvfs_init(&bad));
+
+    bad = gov;
+    bad.port = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_dvfs_init(&bad));
+
+    bad = gov;
+    bad.numStages = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_dvfs_init(&bad));
+
+    bad = gov;
+    bad.lowMode = NS_MAXIMUM_PERF;
+    bad.highMode = NS_MINIMUM_PERF;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_dvfs_init(&bad));
+
+    stages[DV_FEATURES].deadlineUs = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_dvfs_init(&gov));
+
+    // Init leaves the SoC in lowMode
+    dv_setup(3, 0);
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, sim.mode);
+    TEST_ASSERT_EQUAL(0, gov.stats.switches);
+}
+
+void ns_dvfs_unknown_stage_boosts_test() {
+    // Nothing is known about a stage the first time, so it is run safely in highMode. The
+    // measurement scaled by the cost table shows lowMode fits, and the next run is low.
+    dv_setup(1, 0);
+    TEST_ASSERT_EQUAL(0, ns_dvfs_predict_us(&gov, DV_CAPTURE, NS_MINIMUM_PERF));
+
+    TEST_ASSERT_EQUAL(NS_MAXIMUM_PERF, ns_dvfs_stage_begin(&gov, DV_CAPTURE));
+    ns_dvfs_sim_advance(&sim, 2000);
+    TEST_ASSERT_EQUAL(2010, ns_dvfs_stage_end(&gov)); // includes the switch
+    TEST_ASSERT_EQUAL(4020, ns_dvfs_predict_us(&gov, DV_CAPTURE, NS_MINIMUM_PERF));
+
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, ns_dvfs_stage_begin(&gov, DV_CAPTURE));
+    ns_dvfs_sim_advance(&sim, 4000);
+    TEST_ASSERT_EQUAL(4000, ns_dvfs_stage_end(&gov));
+    TEST_ASSERT_EQUAL(4000, ns_dvfs_predict_us(&gov, DV_CAPTURE, NS_MINIMUM_PERF));
+    TEST_ASSERT_EQUAL(1, stages[DV_CAPTURE].boosts);
+    TEST_ASSERT_EQUAL(0, stages[DV_CAPTURE].misses);
+}
+
+void ns_dvfs_boost_only_late_stages_test() {
+    // capture and features fit in lowMode, inference needs 30ms low / 15ms high for a 20ms
+    // deadline
+    dv_setup(3, 5);
+    dv_trace(20, 2000, 3000, 30000);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_dvfs_sim_run(&gov, &sim, trace, 20, 100000));
+
+    // One warm-up boost each for capture and features, inference boosts every time
+    TEST_ASSERT_EQUAL(1, stages[DV_CAPTURE].boosts);
+    TEST_ASSERT_EQUAL(1, stages[DV_FEATURES].boosts);
+    TEST_ASSERT_EQUAL(20, stages[DV_INFERENCE].boosts);
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, stages[DV_CAPTURE].lastMode);
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, stages[DV_FEATURES].lastMode);
+    TEST_ASSERT_EQUAL(NS_MAXIMUM_PERF, stages[DV_INFERENCE].lastMode);
+    TEST_ASSERT_EQUAL(0, gov.stats.misses);
+    TEST_ASSERT_EQUAL(20, gov.stats.frames);
+}
+
+void ns_dvfs_drop_back_to_low_test() {
+    dv_setup(3, 0);
+    dv_trace(1, 2000, 3000, 30000);
+    ns_dvfs_sim_run(&gov, &sim, trace, 1, 0);
+    ns_dvfs_frame_begin(&gov);
+    ns_dvfs_stage_begin(&gov, DV_INFERENCE);
+    TEST_ASSERT_EQUAL(NS_MAXIMUM_PERF, sim.mode);
+    ns_dvfs_sim_advance(&sim, 15000);
+    ns_dvfs_stage_end(&gov);
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, sim.mode);
+
+    // Every boost is one switch up and one back down
+    TEST_ASSERT_EQUAL(2 * gov.stats.boosts, gov.stats.switches);
+}
+
+void ns_dvfs_margin_test() {
+    // Features takes 3900us of a 4000us deadline in lowMode
+    dv_setup(3, 0);
+    dv_trace(4, 1000, 3900, 1000);
+    ns_dvfs_sim_run(&gov, &sim, trace, 4, 0);
+    TEST_ASSERT_EQUAL(1, stages[DV_FEATURES].boosts);
+
+    // A 5% margin doesn't trust 3900us against 4000us
+    dv_setup(3, 5);
+    ns_dvfs_sim_run(&gov, &sim, trace, 4, 0);
+    TEST_ASSERT_EQUAL(4, stages[DV_FEATURES].boosts);
+    TEST_ASSERT_EQUAL(0, gov.stats.misses);
+}
+
+void ns_dvfs_measured_scaling_test() {
+    // A memory bound stage barely speeds up in highMode: 9000us low, 8000us high. Scaled by
+    // the table's 2x speedup, lowMode looks like 16ms against a 10ms deadline.
+    dv_setup(1, 0);
+    memset(trace, 0, sizeof(trace));
+    for (uint32_t f = 0; f < 8; f++) {
+        trace[f].us[NS_MINIMUM_PERF] = 9000;
+        trace[f].us[NS_MAXIMUM_PERF] = 8000;
+    }
+    ns_dvfs_sim_run(&gov, &sim, trace, 8, 0);
+    TEST_ASSERT_EQUAL(8, stages[DV_CAPTURE].boosts);
+    TEST_ASSERT_EQUAL(0, stages[DV_CAPTURE].estUs[NS_MINIMUM_PERF]);
+
+    // Probing measures lowMode after 4 boosts, and the stage stays low from then on
+    dv_setup(1, 0);
+    gov.probePeriod = 4;
+    ns_dvfs_sim_run(&gov, &sim, trace, 8, 0);
+    TEST_ASSERT_EQUAL(4, stages[DV_CAPTURE].boosts);
+    TEST_ASSERT_EQUAL(1, stages[DV_CAPTURE].probes);
+    TEST_ASSERT_EQUAL(9000, stages[DV_CAPTURE].estUs[NS_MINIMUM_PERF]);
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, stages[DV_CAPTURE].lastMode);
+    TEST_ASSERT_EQUAL(0, gov.stats.misses);
+
+    // When lowMode really is too slow, a probe costs one miss per period
+    dv_setup(1, 0);
+    gov.probePeriod = 4;
+    stages[DV_CAPTURE].deadlineUs = 8500;
+    ns_dvfs_sim_run(&gov, &sim, trace, 8, 0);
+    TEST_ASSERT_EQUAL(1, gov.stats.misses);
+    TEST_ASSERT_EQUAL(NS_MAXIMUM_PERF, stages[DV_CAPTURE].lastMode);
+}
+
+void ns_dvfs_tracks_slowdown_test() {
+    // Inference gets 1% slower every frame, crossing the deadline in lowMode halfway through.
+    // The smoothed estimate lags a little, so allow a couple of misses around the crossing.
+    dv_setup(3, 5);
+    memset(trace, 0, sizeof(trace));
+    for (uint32_t f = 0; f < DV_MAX_FRAMES; f++) {
+        trace[f * 3 + DV_CAPTURE].us[NS_MINIMUM_PERF] = 1000;
+        trace[f * 3 + DV_FEATURES].us[NS_MINIMUM_PERF] = 1000;
+        trace[f * 3 + DV_INFERENCE].us[NS_MINIMUM_PERF] = 14000 + 14000 * f / 100;
+    }
+    ns_dvfs_sim_run(&gov, &sim, trace, DV_MAX_FRAMES, 0);
+
+    TEST_ASSERT_UINT32_WITHIN(2, 0, stages[DV_INFERENCE].misses);
+    TEST_ASSERT_EQUAL(NS_MAXIMUM_PERF, stages[DV_INFERENCE].lastMode);
+    TEST_ASSERT_TRUE(stages[DV_INFERENCE].boosts < DV_MAX_FRAMES / 2);
+}
+
+void ns_dvfs_energy_accounting_test() {
+    // Frame: capture boosted (first run), 1000us work at 2x -> 500us + 10us switch at 3000uW
+    // plus 0.5uJ to switch up, then 9490us idle at 10uW
+    dv_setup(1, 0);
+    dv_trace(1, 1000, 0, 0);
+    for (uint32_t f = 0; f < 2; f++) {
+        trace[f].us[NS_MINIMUM_PERF] = 1000;
+    }
+    ns_dvfs_sim_run(&gov, &sim, trace, 1, 10000);
+
+    float boosted = 3000.0f * 510 / 1e6f + 0.5f + 10.0f * 9490 / 1e6f;
+    TEST_ASSERT_EQUAL(1, gov.stats.frames);
+    TEST_ASSERT_EQUAL(10000, gov.stats.lastFrameUs);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, boosted, gov.stats.lastFrameEnergyUj);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3000.0f * 510 / 1e6f, stages[DV_CAPTURE].lastEnergyUj);
+
+    // Second frame runs low: 1000us at 1000uW, 9000us idle
+    ns_dvfs_sim_run(&gov, &sim, trace, 1, 10000);
+    float low = 1000.0f * 1000 / 1e6f + 10.0f * 9000 / 1e6f;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, low, gov.stats.lastFrameEnergyUj);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (boosted + low) / 2, ns_dvfs_energy_per_inference_uj(&gov));
+
+    ns_dvfs_stats_reset(&gov);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, ns_dvfs_energy_per_inference_uj(&gov));
+    TEST_ASSERT_EQUAL(1000, stages[DV_CAPTURE].estUs[NS_MINIMUM_PERF]); // estimates are kept
+}
+
+void ns_dvfs_beats_static_modes_test() {
+    // Compare the governor against the two static choices the examples make today
+    float governed, allHigh;
+    uint32_t lowMisses;
+
+    dv_trace(32, 2000, 3000, 30000);
+
+    dv_setup(3, 5);
+    ns_dvfs_sim_run(&gov, &sim, trace, 32, 100000);
+    governed = ns_dvfs_energy_per_inference_uj(&gov);
+    TEST_ASSERT_EQUAL(0, gov.stats.misses);
+
+    // Always NS_MAXIMUM_PERF (e.g. ns_development_default)
+    dv_setup(3, 5);
+    gov.lowMode = NS_MAXIMUM_PERF;
+    ns_dvfs_sim_init(&sim, &gov);
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_dvfs_init(&gov));
+    sim.mode = NS_MAXIMUM_PERF;
+    ns_dvfs_sim_run(&gov, &sim, trace, 32, 100000);
+    allHigh = ns_dvfs_energy_per_inference_uj(&gov);
+    TEST_ASSERT_EQUAL(0, gov.stats.misses);
+
+    // Always NS_MINIMUM_PERF (e.g. HAR)
+    dv_setup(3, 5);
+    gov.highMode = NS_MINIMUM_PERF;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_dvfs_init(&gov));
+    ns_dvfs_sim_run(&gov, &sim, trace, 32, 100000);
+    lowMisses = gov.stats.misses;
+
+    TEST_ASSERT_TRUE(governed < allHigh);
+    TEST_ASSERT_EQUAL(32, lowMisses);
+}
+
+void ns_dvfs_unbalanced_calls_test() {
+    dv_setup(3, 0);
+    TEST_ASSERT_EQUAL(0, ns_dvfs_stage_end(&gov));
+    TEST_ASSERT_EQUAL(NS_MINIMUM_PERF, ns_dvfs_stage_begin(&gov, 7)); // not a stage
+    TEST_ASSERT_EQUAL(0, ns_dvfs_stage_end(&gov));
+    ns_dvfs_frame_end(&gov); // no frame open
+    TEST_ASSERT_EQUAL(0, gov.stats.frames);
+    TEST_ASSERT_EQUAL(0, gov.stats.stageRuns);
+}
@@ -0,0 +1,15 @@
+#include "ns_peripherals_dvfs.h"
+#include "ns_core.h"
+
+void ns_dvfs_tests_pre_test_hook();
+void ns_dvfs_tests_post_test_hook();
+void ns_dvfs_init_validation_test();
+void ns_dvfs_unknown_stage_boosts_test();
+void ns_dvfs_boost_only_late_stages_test();
+void ns_dvfs_drop_back_to_low_test();
+void ns_dvfs_margin_test();
+void ns_dvfs_measured_scaling_test();
+void ns_dvfs_tracks_slowdown_test();
+void ns_dvfs_energy_accounting_test();
+void ns_dvfs_beats_static_modes_test();
+void ns_dvfs_unbalanced_calls_test();
@@ -0,0 +1,20 @@
+/**
+ * @file ns_ambiqsuite_harness.h
+ * @author Ambiq
+ * @brief Host stand-in for the harness, for building eRPC and the shims off target
+ * @version 0.1
+ * @date 2025-08-28
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef NS_AMBIQSUITE_HARNESS_H
+    #define NS_AMBIQSUITE_HARNESS_H
+
+    #include <stdio.h>
+
+    #define ns_lp_printf printf
+    #define ns_printf printf
+
+#endif // NS_AMBIQSUITE_HARNESS_H
@@ -0,0 +1,362 @@
+/**
+ * @file ns_rpc_loopback_bench.cpp
+ * @author Ambiq
+ * @brief Host loopback benchmark of the generic-data eRPC server, copying vs zero-copy blocks
+ * @version 0.1
+ * @date 2025-08-28
+ *
+ * Feeds pre-encoded sendBlockToEVB, fetchBlockFromEVB and computeOnEVB requests through the
+ * PcToEvb server shims and the eRPC SimpleServer, over a transport that hands back the same
+ * request on every poll, and reports blocks/s and peak heap for a range of block sizes. Heap
+ * use is counted in erpc_malloc, capped at NS_RPC_MALLOC_SIZE_IN_K, with heap_4's 8 byte block
+ * header, so blocks that wouldn't fit on the EVB fail here too. The handlers do what an
+ * application must in each mode: ns_malloc and fill result blocks when copying, fill a static
+ * buffer in zero-copy mode.
+ *
+ * From neuralspot/ns-rpc:
+ *
+ *     E=../../extern/erpc/R1.9.1
+ *     g++ -O2 -std=c++11 -Ibench/host -Iincludes-api -I$E/includes-api \
+ *         bench/ns_rpc_loopback_bench.cpp src/GenericDataOperations_PcToEvb_server.cpp \
+ *         $E/src/erpc_basic_codec.cpp $E/src/erpc_message_buffer.cpp $E/src/erpc_server.cpp \
+ *         $E/src/erpc_simple_server.cpp $E/src/erpc_pre_post_action.cpp -o ns_rpc_loopback_bench
+ *     ./ns_rpc_loopback_bench [seconds per case]
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "GenericDataOperations_PcToEvb_server.h"
+#include "erpc_basic_codec.hpp"
+#include "erpc_port.h"
+#include "erpc_simple_server.hpp"
+#include "erpc_transport.hpp"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ns_rpc_generic_data.h needs the AmbiqSuite headers, so mirror its heap size
+#define NS_RPC_MALLOC_SIZE_IN_K 8
+#define HEAP_BLOCK_HEADER 8 // heap_4's per-allocation overhead
+
+using namespace erpc;
+
+// erpc_malloc/erpc_free go to ns_malloc on the EVB; count what they would use of its heap
+static size_t g_heapUsed, g_heapPeak, g_heapAllocs;
+
+void *
+erpc_malloc(size_t size) {
+    size_t bytes = ((size + 7) & ~(size_t)7) + HEAP_BLOCK_HEADER;
+    if ((size == 0) || (g_heapUsed + bytes > NS_RPC_MALLOC_SIZE_IN_K * 1024)) {
+        return NULL;
+    }
+    size_t *p = (size_t *)malloc(sizeof(size_t) + size);
+    *p = bytes;
+    g_heapUsed += bytes;
+    g_heapAllocs++;
+    if (g_heapUsed > g_heapPeak) {
+        g_heapPeak = g_heapUsed;
+    }
+    return p + 1;
+}
+
+void
+erpc_free(void *ptr) {
+    if (ptr) {
+        size_t *p = (size_t *)ptr - 1;
+        g_heapUsed -= *p;
+        free(p);
+    }
+}
+
+// Hands the same request to the server on every receive(), and keeps the reply
+class LoopbackTransport : public Transport {
+  public:
+    const uint8_t *request;
+    uint16_t requestLength;
+    uint8_t reply[ERPC_DEFAULT_BUFFER_SIZE];
+    uint16_t replyLength;
+
+    virtual erpc_status_t
+    receive(MessageBuffer *message) {
+        memcpy(message->get(), request, requestLength);
+        message->setUsed(requestLength);
+        return kErpcStatus_Success;
+    }
+
+    virtual erpc_status_t
+    send(MessageBuffer *message) {
+        replyLength = message->getUsed();
+        memcpy(reply, message->get(), replyLength);
+        return kErpcStatus_Success;
+    }
+};
+
+// One message buffer, like erpc_mbf_static_init() with a single buffer
+class SingleBufferFactory : public MessageBufferFactory {
+  public:
+    virtual MessageBuffer
+    create(void) {
+        return MessageBuffer((uint8_t *)m_buffer, ERPC_DEFAULT_BUFFER_SIZE);
+    }
+
+    virtual void
+    dispose(MessageBuffer *buf) {
+        (void)buf;
+    }
+
+  private:
+    uint64_t m_buffer[ERPC_DEFAULT_BUFFER_SIZE / sizeof(uint64_t)];
+};
+
+static bool g_zeroCopy;
+static bool g_resultInPlace; // computeOnEVB answers in its in_block, which zero-copy rejects
+static uint32_t g_checksum;
+static uint32_t g_resultLength;
+static uint8_t g_result[ERPC_DEFAULT_BUFFER_SIZE];
+static char g_resultDescription[] = "Result";
+static const char *g_inDescription = "Block";
+
+// Checks that the request's fields came through, in either mode
+static bool
+check_block(const dataBlock *block) {
+    if ((strcmp(block->description, g_inDescription) != 0) ||
+        (block->length != block->buffer.dataLength)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < block->buffer.dataLength; i++) {
+        g_checksum += block->buffer.data[i];
+    }
+    return true;
+}
+
+static void
+fill_result(dataBlock *block, uint8_t *data, char *description) {
+    block->length = g_resultLength;
+    block->dType = uint8_e;
+    block->description = description;
+    block->cmd = generic_cmd;
+    block->buffer.data = data;
+    block->buffer.dataLength = g_resultLength;
+}
+
+extern "C" status
+ns_rpc_data_sendBlockToEVB(const dataBlock *block) {
+    return check_block(block) ? ns_rpc_data_success : ns_rpc_data_failure;
+}
+
+extern "C" status
+ns_rpc_data_fetchBlockFromEVB(dataBlock *block) {
+    if (g_zeroCopy) {
+        fill_result(block, g_result, g_resultDescription);
+        return ns_rpc_data_success;
+    }
+    uint8_t *data = (uint8_t *)erpc_malloc(g_resultLength);
+    char *description = (char *)erpc_malloc(sizeof(g_resultDescription));
+    if ((data == NULL) || (description == NULL)) {
+        erpc_free(data);
+        erpc_free(description);
+        return ns_rpc_data_blockTooLarge;
+    }
+    memcpy(data, g_result, g_resultLength);
+    memcpy(description, g_resultDescription, sizeof(g_resultDescription));
+    fill_result(block, data, description);
+    return ns_rpc_data_success;
+}
+
+extern "C" status
+ns_rpc_data_computeOnEVB(const dataBlock *in_block, dataBlock *result_block) {
+    uint8_t *data = g_result;
+    char *description = g_resultDescription;
+
+    if (!check_block(in_block)) {
+        return ns_rpc_data_failure;
+    }
+    if (g_resultInPlace) {
+        data = in_block->buffer.data;
+    } else if (!g_zeroCopy) {
+        data = (uint8_t *)erpc_malloc(g_resultLength);
+        description = (char *)erpc_malloc(sizeof(g_resultDescription));
+        if ((data == NULL) || (description == NULL)) {
+            erpc_free(data);
+            erpc_free(description);
+            return ns_rpc_data_blockTooLarge;
+        }
+        memcpy(description, g_resultDescription, sizeof(g_resultDescription));
+    }
+    for (uint32_t i = 0; i < g_resultLength; i++) {
+        data[i] = (uint8_t)(in_block->buffer.data[i] * 2);
+    }
+    fill_result(result_block, data, description);
+    return ns_rpc_data_success;
+}
+
+// Encodes a request the way the PC's client does
+static uint16_t
+encode_request(uint8_t *buf, uint16_t size, uint32_t method, uint32_t bytes) {
+    static uint8_t payload[ERPC_DEFAULT_BUFFER_SIZE];
+    MessageBuffer message(buf, size);
+    BasicCodec codec;
+
+    for (uint32_t i = 0; i < bytes; i++) {
+        payload[i] = (uint8_t)(i * 7 + 3);
+    }
+    codec.setBuffer(message);
+    codec.startWriteMessage(kInvocationMessage, kpc_to_evb_service_id, method, 1);
+    if (method != kpc_to_evb_ns_rpc_data_fetchBlockFromEVB_id) {
+        codec.write(bytes);
+        codec.write(static_cast<int32_t>(uint8_e));
+        codec.writeString(strlen(g_inDescription), g_inDescription);
+        codec.write(static_cast<int32_t>(generic_cmd));
+        codec.writeBinary(bytes, payload);
+    }
+    return (codec.getStatus() == kErpcStatus_Success) ? codec.getBuffer()->getUsed() : 0;
+}
+
+// The status at the end of the reply, and the reply's block checked against the request
+static status
+decode_reply(const LoopbackTransport *t, uint32_t method, uint32_t bytes, bool *blockOk) {
+    MessageBuffer message((uint8_t *)t->reply, t->replyLength);
+    message.setUsed(t->replyLength);
+    BasicCodec codec;
+    message_type_t type;
+    uint32_t service, request, sequence, length;
+    int32_t result = ns_rpc_data_failure, tmp;
+    char *description = NULL;
+    uint8_t *data = NULL;
+
+    codec.setBuffer(message);
+    codec.startReadMessage(&type, &service, &request, &sequence);
+    *blockOk = true;
+    if (method != kpc_to_evb_ns_rpc_data_sendBlockToEVB_id) {
+        uint32_t descriptionLength = 0, dataLength = 0;
+        codec.read(&length);
+        codec.read(&tmp);
+        codec.readString(&descriptionLength, &description);
+        codec.read(&tmp);
+        codec.readBinary(&dataLength, &data);
+        *blockOk = (codec.getStatus() == kErpcStatus_Success) && (dataLength == bytes) &&
+                   (descriptionLength == strlen(g_resultDescription));
+        for (uint32_t i = 0; *blockOk && (i < bytes); i++) {
+            uint8_t in = (uint8_t)(i * 7 + 3);
+            bool computed = method == kpc_to_evb_ns_rpc_data_computeOnEVB_id;
+            uint8_t want = computed ? (uint8_t)(in * 2) : g_result[i];
+            *blockOk = data[i] == want;
+        }
+    }
+    codec.read(&result);
+    return (codec.getStatus() == kErpcStatus_Success) ? (status)result : ns_rpc_data_failure;
+}
+
+typedef struct {
+    double blocksPerSecond;
+    size_t peakHeap;
+    double allocsPerBlock;
+    erpc_status_t err;
+    status result;
+    bool blockOk;
+} bench_result_t;
+
+static void
+bench(SimpleServer *server, LoopbackTransport *t, uint32_t method, uint32_t bytes, double seconds,
+      bench_result_t *r) {
+    static uint8_t request[ERPC_DEFAULT_BUFFER_SIZE];
+    uint64_t blocks = 0;
+
+    g_resultLength = bytes;
+    t->requestLength = encode_request(request, sizeof(request), method, bytes);
+    t->request = request;
+    g_heapPeak = g_heapUsed;
+    g_heapAllocs = 0;
+    r->err = kErpcStatus_Fail;
+    r->result = ns_rpc_data_failure;
+    r->blockOk = false;
+    if (t->requestLength == 0) {
+        return;
+    }
+
+    // One call to check the reply, then as many as fit in the time
+    r->err = server->poll();
+    if (r->err != kErpcStatus_Success) {
+        return;
+    }
+    r->result = decode_reply(t, method, bytes, &r->blockOk);
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        for (uint32_t i = 0; i < 256; i++) {
+            server->poll();
+        }
+        blocks += 256;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < seconds);
+    r->blocksPerSecond = blocks / elapsed;
+    r->peakHeap = g_heapPeak;
+    r->allocsPerBlock = (double)g_heapAllocs / (blocks + 1);
+}
+
+int
+main(int argc, char **argv) {
+    static const char *methods[] = {"", "sendBlockToEVB", "fetchBlockFromEVB", "computeOnEVB"};
+    static const uint32_t sizes[] = {64, 256, 1024, 2048, 4000};
+    double seconds = (argc > 1) ? atof(argv[1]) : 0.5;
+    static LoopbackTransport transport;
+    static SingleBufferFactory buffers;
+    BasicCodecFactory codecs;
+    SimpleServer server;
+    erpc_service_t service = create_pc_to_evb_service();
+    int failures = 0;
+
+    for (uint32_t i = 0; i < sizeof(g_result); i++) {
+        g_result[i] = (uint8_t)(i * 13 + 1);
+    }
+    server.setTransport(&transport);
+    server.setCodecFactory(&codecs);
+    server.setMessageBufferFactory(&buffers);
+    server.addService((Service *)service);
+
+    printf("eRPC message buffer %u bytes, heap %u KB\n", ERPC_DEFAULT_BUFFER_SIZE,
+           NS_RPC_MALLOC_SIZE_IN_K);
+    printf("%-18s %6s  %12s %10s %6s  %12s %10s %6s\n", "", "", "copying", "", "", "zero-copy",
+           "", "");
+    printf("%-18s %6s  %12s %10s %6s  %12s %10s %6s\n", "method", "bytes", "blocks/s", "peak heap",
+           "allocs", "blocks/s", "peak heap", "allocs");
+    for (uint32_t m = 1; m <= 3; m++) {
+        for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            bench_result_t r[2];
+            printf("%-18s %6u", methods[m], sizes[s]);
+            for (int zc = 0; zc < 2; zc++) {
+                g_zeroCopy = zc;
+                set_pc_to_evb_service_zero_copy(service, g_zeroCopy);
+                bench(&server, &transport, m, sizes[s], seconds, &r[zc]);
+                bool noHeap = (r[zc].err == kErpcStatus_MemoryError) ||
+                              (r[zc].result == ns_rpc_data_blockTooLarge);
+                if ((r[zc].err == kErpcStatus_Success) && (r[zc].result == ns_rpc_data_success) &&
+                    r[zc].blockOk) {
+                    printf("  %12.0f %10zu %6.1f", r[zc].blocksPerSecond, r[zc].peakHeap,
+                           r[zc].allocsPerBlock);
+                } else {
+                    printf("  %12s %10s %6s", noHeap ? "no heap" : "FAILED", "", "");
+                    // Only the copying path may run out of heap
+                    failures += zc || !noHeap;
+                }
+            }
+            printf("\n");
+        }
+    }
+
+    // A zero-copy result in the message buffer would be overwritten by the reply as it is written
+    bench_result_t r;
+    g_zeroCopy = true;
+    g_resultInPlace = true;
+    set_pc_to_evb_service_zero_copy(service, true);
+    bench(&server, &transport, kpc_to_evb_ns_rpc_data_computeOnEVB_id, 256, 0, &r);
+    g_resultInPlace = false;
+    printf("zero-copy result inside the request: %s\n",
+           (r.result == ns_rpc_data_failure) ? "rejected" : "NOT REJECTED");
+    failures += r.result != ns_rpc_data_failure;
+
+    destroy_pc_to_evb_service();
+    return failures ? 1 : 0;
+}
@@ -25,13 +25,18 @@ extern "C" {
  */
 class pc_to_evb_service : public erpc::Service {
   public:
-    pc_to_evb_service() : Service(kpc_to_evb_service_id) {}
+    pc_to_evb_service() : Service(kpc_to_evb_service_id), m_zeroCopy(false) {}
 
     /*! @brief Call the correct server shim based on method unique ID. */
     virtual erpc_status_t
     handleInvocation(uint32_t methodId, uint32_t sequence, erpc::Codec *codec,
                      erpc::MessageBufferFactory *messageFactory);
 
+    /*! @brief Pass received blocks as pointers into the message buffer, and send result blocks
+     * from application memory without freeing them. */
+    void
+    setZeroCopy(bool zeroCopy);
+
   private:
     /*! @brief Server shim for ns_rpc_data_sendBlockToEVB of pc_to_evb interface. */
     erpc_status_t
@@ -48,6 +53,8 @@ class pc_to_evb_service : public erpc::Service {
     erpc_status_t
     ns_rpc_data_computeOnEVB_shim(erpc::Codec *codec, erpc::MessageBufferFactory *messageFactory,
                                   uint32_t sequence);
+
+    bool m_zeroCopy;
 };
 
 extern "C" {
@@ -70,6 +77,9 @@ destroy_pc_to_evb_service(void);
         #warning "Unknown eRPC allocation policy!"
     #endif
 
+void
+set_pc_to_evb_service_zero_copy(erpc_service_t service, bool zeroCopy);
+
     #ifdef __cplusplus
 }
     #endif // __cplusplus
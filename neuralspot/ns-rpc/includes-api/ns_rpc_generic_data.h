@@ -33,18 +33,37 @@ extern "C" {
         { .major = 1, .minor = 0, .revision = 0 }
     #define NS_RPC_GDO_V1_1_0                                                                      \
         { .major = 1, .minor = 1, .revision = 0 }
+    #define NS_RPC_GDO_V1_2_0                                                                      \
+        { .major = 1, .minor = 2, .revision = 0 }
+    #define NS_RPC_GDO_V1_3_0                                                                      \
+        { .major = 1, .minor = 3, .revision = 0 }
 
     #define NS_RPC_GDO_OLDEST_SUPPORTED_VERSION NS_RPC_GDO_V0_0_1
-    #define NS_RPC_GDO_CURRENT_VERSION NS_RPC_GDO_V1_1_0
+    #define NS_RPC_GDO_CURRENT_VERSION NS_RPC_GDO_V1_3_0
     #define NS_RPC_GDO_API_ID 0xCA0100
 
     #define NS_RPC_MALLOC_SIZE_IN_K 8
+    #define NS_RPC_UART_COBS_FRAMES 4 ///< rx_buf is split into this many frame buffers
 extern const ns_core_api_t ns_rpc_gdo_V0_0_1;
 extern const ns_core_api_t ns_rpc_gdo_V1_0_0;
 extern const ns_core_api_t ns_rpc_gdo_V1_1_0;
+extern const ns_core_api_t ns_rpc_gdo_V1_2_0;
+extern const ns_core_api_t ns_rpc_gdo_V1_3_0;
 extern const ns_core_api_t ns_rpc_gdo_oldest_supported_version;
 extern const ns_core_api_t ns_rpc_gdo_current_version;
 
+/**
+ * In zeroCopy server mode (API v1.3.0), no block memory comes from the heap:
+ *  - Received blocks' description and buffer.data point into the eRPC message buffer, and are
+ *    only valid until the callback returns. buffer.data starts 28 + strlen(description) bytes
+ *    into the message, so it is only 4-byte aligned if the description length is a multiple of 4.
+ *  - Result blocks are sent straight from the memory the callback points them at, which the
+ *    application owns (static buffers, not ns_malloc). The reply is written over the request, so
+ *    a result must not point into a received block; such a result is sent empty, with
+ *    ns_rpc_data_failure.
+ * Otherwise received blocks are copied to the heap, and result blocks must be ns_malloc'd
+ * because they are freed after being sent.
+ */
 typedef status (*ns_rpc_data_sendBlockToEVB_cb)(const dataBlock *block);
 
 typedef status (*ns_rpc_data_fetchBlockFromEVB_cb)(dataBlock *block);
@@ -53,7 +72,13 @@ typedef status (*ns_rpc_data_computeOnEVB_cb)(const dataBlock *in_block, dataBlo
 
 typedef enum { NS_RPC_GENERICDATA_CLIENT, NS_RPC_GENERICDATA_SERVER } rpcGenericDataMode_e;
 
-typedef enum { NS_RPC_TRANSPORT_USB, NS_RPC_TRANSPORT_UART } ns_rpc_transport_e;
+/// UART_COBS frames messages with COBS and a CRC-16 and receives them without copying
+/// (rx_buf holds NS_RPC_UART_COBS_FRAMES frame buffers, tx_buf the encoded frame being sent)
+typedef enum {
+    NS_RPC_TRANSPORT_USB,
+    NS_RPC_TRANSPORT_UART,
+    NS_RPC_TRANSPORT_UART_COBS
+} ns_rpc_transport_e;
 /**
  * @brief RPC Configuration Struct
  *
@@ -73,6 +98,7 @@ typedef struct {
     ns_rpc_data_fetchBlockFromEVB_cb fetchBlockFromEVB_cb; ///< Callback for fetchBlockFromEVB
     ns_rpc_data_computeOnEVB_cb computeOnEVB_cb;           ///< Callback for computeOnEVB
     ns_rpc_transport_e transport; ///< Transport type USB or UART
+    bool zeroCopy; ///< Server mode: pass blocks in place, see ns_rpc_data_sendBlockToEVB_cb
 } ns_rpc_config_t;
 
 /**
@@ -0,0 +1,108 @@
+"""COBS framed serial transport, the PC side of NS_RPC_TRANSPORT_UART_COBS.
+
+Each eRPC message travels as COBS(message + CRC-16 little endian) followed by a 0x00
+delimiter. The CRC is eRPC's CRC-16 (CCITT polynomial, start value 0xEF4A).
+"""
+
+import threading
+
+import erpc
+import serial
+
+CRC16_START = 0xEF4A
+
+
+def crc16(data, crc=CRC16_START):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+    return crc & 0xFFFF
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos = 0
+    code = 1
+    for byte in data:
+        if byte == 0:
+            out[code_pos] = code
+            code_pos = len(out)
+            out.append(0)
+            code = 1
+        else:
+            out.append(byte)
+            code += 1
+            if code == 0xFF:
+                out[code_pos] = code
+                code_pos = len(out)
+                out.append(0)
+                code = 1
+    out[code_pos] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("invalid COBS frame")
+        out += data[i + 1 : i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(message):
+    crc = crc16(message)
+    return cobs_encode(bytes(message) + bytes([crc & 0xFF, crc >> 8])) + b"\x00"
+
+
+def decode_frame(frame):
+    """Decode one frame (without its delimiter), None if it is corrupted."""
+    try:
+        data = cobs_decode(frame)
+    except ValueError:
+        return None
+    if len(data) <= 2:
+        return None
+    payload = data[:-2]
+    if crc16(payload) != data[-2] | (data[-1] << 8):
+        return None
+    return bytearray(payload)
+
+
+class CobsSerialTransport(erpc.transport.Transport):
+    def __init__(self, url, baudrate, **kwargs):
+        super(CobsSerialTransport, self).__init__()
+        self._serial = serial.serial_for_url(url, baudrate=baudrate, **kwargs)
+        self._sendLock = threading.Lock()
+        self._receiveLock = threading.Lock()
+        self._pending = bytearray()
+        self.crc_errors = 0
+
+    def close(self):
+        self._serial.close()
+
+    def send(self, message):
+        with self._sendLock:
+            self._serial.write(encode_frame(message))
+
+    def receive(self):
+        with self._receiveLock:
+            while True:
+                end = self._pending.find(b"\x00")
+                while end < 0:
+                    self._pending += self._serial.read(max(1, self._serial.in_waiting))
+                    end = self._pending.find(b"\x00")
+                frame = bytes(self._pending[:end])
+                del self._pending[: end + 1]
+                if not frame:
+                    continue  # resynchronization delimiter
+                message = decode_frame(frame)
+                if message is not None:
+                    return message
+                self.crc_errors += 1
@@ -179,6 +179,12 @@ if __name__ == "__main__":
     argParser.add_argument(
         "-B", "--baud", default="115200", help="Baud (default value is 115200)"
     )
+    argParser.add_argument(
+        "-f",
+        "--framing",
+        default="header",
+        help="Serial framing: header (eRPC default) or cobs for NS_RPC_TRANSPORT_UART_COBS",
+    )
     argParser.add_argument(
         "-o",
         "--out",
@@ -187,7 +193,12 @@ if __name__ == "__main__":
     )
 
     args = argParser.parse_args()
-    transport = erpc.transport.SerialTransport(args.tty, int(args.baud))
+    if args.framing == "cobs":
+        from cobs_transport import CobsSerialTransport
+
+        transport = CobsSerialTransport(args.tty, int(args.baud))
+    else:
+        transport = erpc.transport.SerialTransport(args.tty, int(args.baud))
     outFileName = args.out
     my_calls = 0
 
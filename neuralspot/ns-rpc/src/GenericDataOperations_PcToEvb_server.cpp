@@ -27,15 +27,16 @@ ERPC_MANUALLY_CONSTRUCTED_STATIC(pc_to_evb_service, s_pc_to_evb_service);
 
 //! @brief Function to read struct dataBlock
 static void
-read_dataBlock_struct(erpc::Codec *codec, dataBlock *data);
+read_dataBlock_struct(erpc::Codec *codec, dataBlock *data, bool zeroCopy);
 
 //! @brief Function to read struct binary_t
 static void
-read_binary_t_struct(erpc::Codec *codec, binary_t *data);
+read_binary_t_struct(erpc::Codec *codec, binary_t *data, bool zeroCopy);
 
-// Read struct dataBlock function implementation
+// Read struct dataBlock function implementation. With zeroCopy, description and buffer.data
+// point into the message buffer instead of erpc_malloc'd copies.
 static void
-read_dataBlock_struct(erpc::Codec *codec, dataBlock *data) {
+read_dataBlock_struct(erpc::Codec *codec, dataBlock *data, bool zeroCopy) {
     int32_t _tmp_local;
 
     if (NULL == data) {
@@ -47,32 +48,45 @@ read_dataBlock_struct(erpc::Codec *codec, dataBlock *data) {
     codec->read(&_tmp_local);
     data->dType = static_cast<dataType>(_tmp_local);
 
-    uint32_t description_len;
-    char *description_local;
+    uint32_t description_len = 0;
+    char *description_local = NULL;
     codec->readString(&description_len, &description_local);
-    data->description = (char *)erpc_malloc((description_len + 1) * sizeof(char));
-    if ((data->description == NULL) || (description_local == NULL)) {
-        codec->updateStatus(kErpcStatus_MemoryError);
+    if (zeroCopy) {
+        data->description = description_local;
     } else {
-        memcpy(data->description, description_local, description_len);
-        (data->description)[description_len] = 0;
+        data->description = (char *)erpc_malloc((description_len + 1) * sizeof(char));
+        if ((data->description == NULL) || (description_local == NULL)) {
+            codec->updateStatus(kErpcStatus_MemoryError);
+        } else {
+            memcpy(data->description, description_local, description_len);
+            (data->description)[description_len] = 0;
+        }
     }
 
     codec->read(&_tmp_local);
     data->cmd = static_cast<command>(_tmp_local);
 
-    read_binary_t_struct(codec, &(data->buffer));
+    if (zeroCopy && (codec->getStatus() == kErpcStatus_Success)) {
+        // cmd, which follows the string, has been read, so its first byte can be the terminator
+        (data->description)[description_len] = 0;
+    }
+
+    read_binary_t_struct(codec, &(data->buffer), zeroCopy);
 }
 
 // Read struct binary_t function implementation
 static void
-read_binary_t_struct(erpc::Codec *codec, binary_t *data) {
+read_binary_t_struct(erpc::Codec *codec, binary_t *data, bool zeroCopy) {
     if (NULL == data) {
         return;
     }
 
-    uint8_t *data_local;
+    uint8_t *data_local = NULL;
     codec->readBinary(&data->dataLength, &data_local);
+    if (zeroCopy) {
+        data->data = data_local;
+        return;
+    }
     data->data = (uint8_t *)erpc_malloc(data->dataLength * sizeof(uint8_t));
     if ((data->data == NULL) && (data->dataLength > 0)) {
         codec->updateStatus(kErpcStatus_MemoryError);
@@ -100,7 +114,8 @@ write_dataBlock_struct(erpc::Codec *codec, const dataBlock *data) {
 
     codec->write(static_cast<int32_t>(data->dType));
 
-    codec->writeString(strlen((const char *)data->description), (const char *)data->description);
+    codec->writeString(data->description ? strlen((const char *)data->description) : 0,
+                       (const char *)data->description);
 
     codec->write(static_cast<int32_t>(data->cmd));
 
@@ -139,6 +154,26 @@ free_binary_t_struct(binary_t *data) {
     erpc_free(data->data);
 }
 
+// The reply is serialized over the request, in the same message buffer, so in zero-copy mode a
+// result block must not point into it
+static bool
+dataBlock_in_buffer(const dataBlock *data, const MessageBuffer *buffer) {
+    const uint8_t *start = buffer->get();
+    const uint8_t *end = start + buffer->getLength();
+    const uint8_t *description = (const uint8_t *)data->description;
+    const uint8_t *bytes = data->buffer.data;
+
+    return ((description != NULL) && (description + strlen(data->description) >= start) &&
+            (description < end)) ||
+           ((bytes != NULL) && (data->buffer.dataLength > 0) &&
+            (bytes + data->buffer.dataLength > start) && (bytes < end));
+}
+
+void
+pc_to_evb_service::setZeroCopy(bool zeroCopy) {
+    m_zeroCopy = zeroCopy;
+}
+
 // Call the correct server shim based on method unique ID.
 erpc_status_t
 pc_to_evb_service::handleInvocation(uint32_t methodId, uint32_t sequence, Codec *codec,
@@ -176,16 +211,12 @@ pc_to_evb_service::ns_rpc_data_sendBlockToEVB_shim(Codec *codec,
                                                    uint32_t sequence) {
     erpc_status_t err = kErpcStatus_Success;
 
-    dataBlock *block = NULL;
-    block = (dataBlock *)erpc_malloc(sizeof(dataBlock));
-    if (block == NULL) {
-        codec->updateStatus(kErpcStatus_MemoryError);
-    }
+    dataBlock block = {};
     status result;
 
     // startReadMessage() was already called before this shim was invoked.
 
-    read_dataBlock_struct(codec, block);
+    read_dataBlock_struct(codec, &block, m_zeroCopy);
 
     err = codec->getStatus();
     if (err == kErpcStatus_Success) {
@@ -193,7 +224,7 @@ pc_to_evb_service::ns_rpc_data_sendBlockToEVB_shim(Codec *codec,
 #if ERPC_NESTED_CALLS_DETECTION
         nestingDetection = true;
 #endif
-        result = ns_rpc_data_sendBlockToEVB(block);
+        result = ns_rpc_data_sendBlockToEVB(&block);
 #if ERPC_NESTED_CALLS_DETECTION
         nestingDetection = false;
 #endif
@@ -215,10 +246,9 @@ pc_to_evb_service::ns_rpc_data_sendBlockToEVB_shim(Codec *codec,
         err = codec->getStatus();
     }
 
-    if (block) {
-        free_dataBlock_struct(block);
+    if (!m_zeroCopy) {
+        free_dataBlock_struct(&block);
     }
-    erpc_free(block);
 
     return err;
 }
@@ -230,24 +260,25 @@ pc_to_evb_service::ns_rpc_data_fetchBlockFromEVB_shim(Codec *codec,
                                                       uint32_t sequence) {
     erpc_status_t err = kErpcStatus_Success;
 
-    dataBlock *block = NULL;
+    dataBlock block = {};
     status result;
 
     // startReadMessage() was already called before this shim was invoked.
-    block = (dataBlock *)erpc_malloc(sizeof(dataBlock));
-    if (block == NULL) {
-        codec->updateStatus(kErpcStatus_MemoryError);
-    }
     err = codec->getStatus();
     if (err == kErpcStatus_Success) {
         // Invoke the actual served function.
 #if ERPC_NESTED_CALLS_DETECTION
         nestingDetection = true;
 #endif
-        result = ns_rpc_data_fetchBlockFromEVB(block);
+        result = ns_rpc_data_fetchBlockFromEVB(&block);
 #if ERPC_NESTED_CALLS_DETECTION
         nestingDetection = false;
 #endif
+        if (m_zeroCopy && dataBlock_in_buffer(&block, codec->getBuffer())) {
+            block = dataBlock();
+            result = ns_rpc_data_failure;
+        }
+
         // preparing MessageBuffer for serializing data
         err = messageFactory->prepareServerBufferForSend(codec->getBuffer());
     }
@@ -260,17 +291,17 @@ pc_to_evb_service::ns_rpc_data_fetchBlockFromEVB_shim(Codec *codec,
         codec->startWriteMessage(kReplyMessage, kpc_to_evb_service_id,
                                  kpc_to_evb_ns_rpc_data_fetchBlockFromEVB_id, sequence);
 
-        write_dataBlock_struct(codec, block);
+        write_dataBlock_struct(codec, &block);
         
         codec->write(static_cast<int32_t>(result));
 
         err = codec->getStatus();
     }
 
-    if (block) {
-        free_dataBlock_struct(block);
+    // In zero-copy mode the block is owned by the application
+    if (!m_zeroCopy) {
+        free_dataBlock_struct(&block);
     }
-    erpc_free(block);
 
     return err;
 }
@@ -281,22 +312,13 @@ pc_to_evb_service::ns_rpc_data_computeOnEVB_shim(Codec *codec, MessageBufferFact
                                                  uint32_t sequence) {
     erpc_status_t err = kErpcStatus_Success;
 
-    dataBlock *in_block = NULL;
-    in_block = (dataBlock *)erpc_malloc(sizeof(dataBlock));
-    if (in_block == NULL) {
-        codec->updateStatus(kErpcStatus_MemoryError);
-    }
-    dataBlock *result_block = NULL;
+    dataBlock in_block = {};
+    dataBlock result_block = {};
     status result;
 
     // startReadMessage() was already called before this shim was invoked.
 
-    read_dataBlock_struct(codec, in_block);
-
-    result_block = (dataBlock *)erpc_malloc(sizeof(dataBlock));
-    if (result_block == NULL) {
-        codec->updateStatus(kErpcStatus_MemoryError);
-    }
+    read_dataBlock_struct(codec, &in_block, m_zeroCopy);
 
     err = codec->getStatus();
     if (err == kErpcStatus_Success) {
@@ -304,10 +326,14 @@ pc_to_evb_service::ns_rpc_data_computeOnEVB_shim(Codec *codec, MessageBufferFact
 #if ERPC_NESTED_CALLS_DETECTION
         nestingDetection = true;
 #endif
-        result = ns_rpc_data_computeOnEVB(in_block, result_block);
+        result = ns_rpc_data_computeOnEVB(&in_block, &result_block);
 #if ERPC_NESTED_CALLS_DETECTION
         nestingDetection = false;
 #endif
+        if (m_zeroCopy && dataBlock_in_buffer(&result_block, codec->getBuffer())) {
+            result_block = dataBlock();
+            result = ns_rpc_data_failure;
+        }
 
         // preparing MessageBuffer for serializing data
         err = messageFactory->prepareServerBufferForSend(codec->getBuffer());
@@ -321,22 +347,19 @@ pc_to_evb_service::ns_rpc_data_computeOnEVB_shim(Codec *codec, MessageBufferFact
         codec->startWriteMessage(kReplyMessage, kpc_to_evb_service_id,
                                  kpc_to_evb_ns_rpc_data_computeOnEVB_id, sequence);
 
-        write_dataBlock_struct(codec, result_block);
+        write_dataBlock_struct(codec, &result_block);
 
         codec->write(static_cast<int32_t>(result));
 
         err = codec->getStatus();
     }
 
-    if (in_block) {
-        free_dataBlock_struct(in_block);
+    // In zero-copy mode the in_block is the message buffer and the result_block is owned by the
+    // application
+    if (!m_zeroCopy) {
+        free_dataBlock_struct(&in_block);
+        free_dataBlock_struct(&result_block);
     }
-    erpc_free(in_block);
-
-    if (result_block) {
-        free_dataBlock_struct(result_block);
-    }
-    erpc_free(result_block);
 
     return err;
 }
@@ -367,3 +390,10 @@ destroy_pc_to_evb_service() {
 #else
     #warning "Unknown eRPC allocation policy!"
 #endif
+
+void
+set_pc_to_evb_service_zero_copy(erpc_service_t service, bool zeroCopy) {
+    if (service) {
+        ((pc_to_evb_service *)service)->setZeroCopy(zeroCopy);
+    }
+}
@@ -38,11 +38,15 @@ const ns_core_api_t ns_rpc_gdo_V1_0_0 = {.apiId = NS_RPC_GDO_API_ID, .version =
 
 const ns_core_api_t ns_rpc_gdo_V1_1_0 = {.apiId = NS_RPC_GDO_API_ID, .version = NS_RPC_GDO_V1_1_0};
 
+const ns_core_api_t ns_rpc_gdo_V1_2_0 = {.apiId = NS_RPC_GDO_API_ID, .version = NS_RPC_GDO_V1_2_0};
+
+const ns_core_api_t ns_rpc_gdo_V1_3_0 = {.apiId = NS_RPC_GDO_API_ID, .version = NS_RPC_GDO_V1_3_0};
+
 const ns_core_api_t ns_rpc_gdo_oldest_supported_version = {.apiId = NS_RPC_GDO_API_ID,
                                                            .version = NS_RPC_GDO_V0_0_1};
 
 const ns_core_api_t ns_rpc_gdo_current_version = {
-    .apiId = NS_RPC_GDO_API_ID, .version = NS_RPC_GDO_V1_1_0};
+    .apiId = NS_RPC_GDO_API_ID, .version = NS_RPC_GDO_V1_3_0};
 
 #ifdef NS_USB_PRESENT
 static ns_tusb_desc_webusb_url_t ns_rpc_url;
@@ -64,6 +68,8 @@ ns_uart_config_t g_RpcGenericUARTHandle = {
     .rx_cb = NULL,
     .tx_cb = NULL};
 
+static ns_uart_framer_t g_RpcUartFramer;
+
 ns_rpc_config_t g_RpcGenericDataConfig = {
     .api = &ns_rpc_gdo_current_version,
     .mode = NS_RPC_GENERICDATA_CLIENT,
@@ -77,7 +83,8 @@ ns_rpc_config_t g_RpcGenericDataConfig = {
     .uartHandle = NULL,
     .sendBlockToEVB_cb = NULL,
     .fetchBlockFromEVB_cb = NULL,
-    .computeOnEVB_cb = NULL};
+    .computeOnEVB_cb = NULL,
+    .zeroCopy = false};
 
 
 // GenericDataOperations implements 3 function calls that service
@@ -133,6 +140,12 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
         return NS_STATUS_INVALID_VERSION;
     }
     #endif
+    if (cfg->zeroCopy &&
+        ns_core_check_api(cfg->api, &ns_rpc_gdo_oldest_supported_version, &ns_rpc_gdo_V1_2_0) ==
+            NS_STATUS_SUCCESS) {
+        ns_lp_printf("Zero-copy blocks not supported in this API version\n");
+        return NS_STATUS_INVALID_CONFIG;
+    }
     // will default to usb if cfg->transport is not explicitly set
     if(cfg->transport == NS_RPC_TRANSPORT_USB) {
     #ifdef NS_USB_PRESENT
@@ -162,6 +175,7 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
             g_RpcGenericDataConfig.tx_buf = cfg->tx_buf;
             g_RpcGenericDataConfig.tx_bufLength = cfg->tx_bufLength;
             g_RpcGenericDataConfig.transport = cfg->transport;
+            g_RpcGenericDataConfig.zeroCopy = cfg->zeroCopy;
             g_RpcGenericDataConfig.usbHandle = usb_handle;
 
             // Common ERPC init
@@ -178,15 +192,20 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
                 // Initialize the server and service
                 erpc_server_init(transport, message_buffer_factory);
                 erpc_service_t service = create_pc_to_evb_service();
+                set_pc_to_evb_service_zero_copy(service, cfg->zeroCopy);
                 erpc_add_service_to_server(service);
             }
     #endif
         }
-        else if(cfg->transport == NS_RPC_TRANSPORT_UART) {
+        else if(cfg->transport == NS_RPC_TRANSPORT_UART || cfg->transport == NS_RPC_TRANSPORT_UART_COBS) {
             if(ns_core_check_api(cfg->api, &ns_rpc_gdo_oldest_supported_version, &ns_rpc_gdo_V1_0_0) == NS_STATUS_SUCCESS) {
                 ns_lp_printf("UART transport not supported in this API version\n");
                 return NS_STATUS_INVALID_CONFIG;
             }
+            if(cfg->transport == NS_RPC_TRANSPORT_UART_COBS && ns_core_check_api(cfg->api, &ns_rpc_gdo_oldest_supported_version, &ns_rpc_gdo_V1_1_0) == NS_STATUS_SUCCESS) {
+                ns_lp_printf("UART COBS transport not supported in this API version\n");
+                return NS_STATUS_INVALID_CONFIG;
+            }
             ns_uart_handle_t uart_handle = NULL;
             if(cfg->uartHandle == NULL) {
                 ns_lp_printf("Must provide a UART handle to declare blocking or nonblocking UART transport layer\n");
@@ -202,7 +221,25 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
             g_RpcGenericUARTHandle.uart_config->pui8TxBuffer = cfg->tx_buf;
             g_RpcGenericUARTHandle.uart_config->ui32TxBufferSize = cfg->tx_bufLength;
     #endif
-            ns_uart_init(&g_RpcGenericUARTHandle, &uart_handle);
+            g_RpcGenericUARTHandle.framer = NULL;
+            if(cfg->transport == NS_RPC_TRANSPORT_UART_COBS) {
+                // rx_buf becomes the frame buffers, which double as eRPC message buffers
+                g_RpcUartFramer.pool = cfg->rx_buf;
+                g_RpcUartFramer.frameSize = cfg->rx_bufLength / NS_RPC_UART_COBS_FRAMES;
+                g_RpcUartFramer.numFrames = NS_RPC_UART_COBS_FRAMES;
+                g_RpcUartFramer.rxDepth = NS_RPC_UART_COBS_FRAMES / 2;
+                if(ns_uart_framer_init(&g_RpcUartFramer) != NS_STATUS_SUCCESS) {
+                    ns_lp_printf("UART COBS transport needs rx_buf for its frame buffers\n");
+                    return NS_STATUS_INVALID_CONFIG;
+                }
+                g_RpcGenericUARTHandle.framer = &g_RpcUartFramer;
+            }
+            // Fails e.g. for COBS framing on Apollo3, leaving uart_handle NULL
+            uint32_t uart_status = ns_uart_init(&g_RpcGenericUARTHandle, &uart_handle);
+            if(uart_status != NS_STATUS_SUCCESS) {
+                ns_lp_printf("UART Init Failed\n");
+                return uart_status;
+            }
 
             g_RpcGenericDataConfig.mode = cfg->mode;
             g_RpcGenericDataConfig.sendBlockToEVB_cb = cfg->sendBlockToEVB_cb;
@@ -214,13 +251,26 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
             g_RpcGenericDataConfig.tx_buf = cfg->tx_buf;
             g_RpcGenericDataConfig.tx_bufLength = cfg->tx_bufLength;
             g_RpcGenericDataConfig.transport = cfg->transport;
+            g_RpcGenericDataConfig.zeroCopy = cfg->zeroCopy;
             g_RpcGenericDataConfig.uartHandle = uart_handle;
             // Common ERPC init
-            /* UART transport layer initialization */
-            erpc_transport_t transport = erpc_transport_uart_init(uart_handle);
+            erpc_transport_t transport;
+            erpc_mbf_t message_buffer_factory;
+            if(cfg->transport == NS_RPC_TRANSPORT_UART_COBS) {
+                /* COBS framed UART transport, message buffers are its frame buffers */
+                transport = erpc_transport_uart_cobs_init(uart_handle, cfg->tx_buf, cfg->tx_bufLength);
+                if(transport == NULL) {
+                    return NS_STATUS_INVALID_CONFIG;
+                }
+                message_buffer_factory = erpc_mbf_uart_cobs_init(transport);
+            }
+            else {
+                /* UART transport layer initialization */
+                transport = erpc_transport_uart_init(uart_handle);
 
-            /* MessageBufferFactory initialization */
-            erpc_mbf_t message_buffer_factory = erpc_mbf_static_init();
+                /* MessageBufferFactory initialization */
+                message_buffer_factory = erpc_mbf_static_init();
+            }
 
             if (cfg->mode == NS_RPC_GENERICDATA_CLIENT) {
                 /* Init eRPC client environment */
@@ -229,6 +279,7 @@ uint16_t ns_rpc_genericDataOperations_init(ns_rpc_config_t *cfg) {
                 // Initialize the server and service
                 erpc_server_init(transport, message_buffer_factory);
                 erpc_service_t service = create_pc_to_evb_service();
+                set_pc_to_evb_service_zero_copy(service, cfg->zeroCopy);
                 erpc_add_service_to_server(service);
             } 
     }
@@ -22,6 +22,7 @@ extern "C" {
     #include "am_mcu_apollo.h"
     #include "am_util.h"
     #include "ns_core.h"
+    #include "ns_uart_frame.h"
 
     #define NS_UART_V0_0_1                                                                          \
         { .major = 0, .minor = 0, .revision = 1 }
@@ -62,6 +63,7 @@ typedef struct
     ns_uart_tx_cb tx_cb;            ///< Callback for tx events 
     bool tx_blocking;
     bool rx_blocking;
+    ns_uart_framer_t *framer;       ///< Optional, receive COBS frames straight from the RX FIFO
 }
 ns_uart_config_t;
 
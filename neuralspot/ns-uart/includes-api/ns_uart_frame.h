@@ -0,0 +1,161 @@
+/**
+ * @file ns_uart_frame.h
+ * @author Ambiq
+ * @brief COBS framed UART reception into a pool of frame buffers
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * Frames on the wire are COBS encoded and terminated by a 0x00 delimiter, so the receiver
+ * can resynchronize after any error by waiting for the next zero. The RX interrupt drains
+ * the UART FIFO straight into the tail of the frame buffer being filled; when a delimiter
+ * arrives the frame is decoded in place and queued. A consumer (e.g. the eRPC COBS transport)
+ * takes the decoded frame by pointer and gives a free buffer back, so payloads are never
+ * copied between the FIFO and the application.
+ *
+ * Threading: the rx side (ns_uart_framer_rx_window/commit/rx) is called from one interrupt,
+ * everything else from one thread. They communicate through single-producer, single-consumer
+ * queues and need no locks.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-uart
+ * @{
+ */
+
+#ifndef NS_UART_FRAME_H
+    #define NS_UART_FRAME_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_UART_FRAMER_MAX_FRAMES 8 ///< Power of 2
+    #define NS_UART_FRAMER_NONE 0xFF
+
+    /// Worst-case COBS encoded size of n bytes, excluding the delimiter
+    #define NS_UART_COBS_MAX_ENCODED(n) ((n) + ((n) / 254) + 1)
+
+typedef struct {
+    // Config
+    uint8_t *pool;      ///< numFrames * frameSize bytes
+    uint32_t frameSize; ///< Largest encoded frame (without delimiter) that can be received
+    uint8_t numFrames;  ///< Up to NS_UART_FRAMER_MAX_FRAMES
+    uint8_t rxDepth;    ///< Free buffers kept for reception, the rest can be lent out
+
+    // Internal state - rx interrupt
+    uint8_t filling; ///< Buffer being received into, NS_UART_FRAMER_NONE if none was free
+    uint32_t fill;
+    bool discarding; ///< Dropping bytes until the next delimiter
+    uint8_t sink[16]; ///< Drains the FIFO while no buffer is free
+
+    // Queues
+    uint8_t rxFree[NS_UART_FRAMER_MAX_FRAMES];
+    volatile uint8_t rxFreeHead; ///< Written by the thread
+    volatile uint8_t rxFreeTail; ///< Written by the interrupt
+    uint8_t ready[NS_UART_FRAMER_MAX_FRAMES];
+    uint32_t readyLen[NS_UART_FRAMER_MAX_FRAMES];
+    volatile uint8_t readyHead; ///< Written by the interrupt
+    volatile uint8_t readyTail; ///< Written by the thread
+
+    // Internal state - thread
+    uint8_t spare[NS_UART_FRAMER_MAX_FRAMES];
+    uint8_t numSpare;
+
+    // Statistics, written by the interrupt
+    uint32_t frames;       ///< Frames decoded and queued
+    uint32_t overruns;     ///< Frames dropped because no buffer was free
+    uint32_t oversize;     ///< Frames dropped because they exceeded frameSize
+    uint32_t decodeErrors; ///< Frames dropped because of invalid COBS
+} ns_uart_framer_t;
+
+/**
+ * @brief Initialize a framer, rxDepth buffers are reserved for reception
+ *
+ * @param f pool, frameSize, numFrames and rxDepth must be set, numFrames > rxDepth > 0
+ * @return uint32_t status
+ */
+extern uint32_t ns_uart_framer_init(ns_uart_framer_t *f);
+
+/**
+ * @brief Where the next received bytes should be written (rx interrupt)
+ *
+ * Read up to *space bytes from the UART FIFO into the returned pointer, then call
+ * ns_uart_framer_rx_commit() with the number of bytes read.
+ */
+extern uint8_t *ns_uart_framer_rx_window(ns_uart_framer_t *f, uint32_t *space);
+
+/**
+ * @brief Process bytes written to the window, decoding and queueing any completed frames
+ */
+extern void ns_uart_framer_rx_commit(ns_uart_framer_t *f, uint32_t count);
+
+/**
+ * @brief Feed received bytes from elsewhere (copies them into the window)
+ */
+extern void ns_uart_framer_rx(ns_uart_framer_t *f, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief True if a decoded frame is waiting
+ */
+extern bool ns_uart_framer_available(const ns_uart_framer_t *f);
+
+/**
+ * @brief Take the oldest decoded frame
+ *
+ * @param f
+ * @param frame set to the frame buffer (frameSize bytes), decoded data starts at frame[0]
+ * @param len set to the decoded length
+ * @return true if a frame was taken, it must be given back with ns_uart_framer_release()
+ */
+extern bool ns_uart_framer_get(ns_uart_framer_t *f, uint8_t **frame, uint32_t *len);
+
+/**
+ * @brief Lend a free buffer to the application, NULL if none is spare
+ */
+extern uint8_t *ns_uart_framer_alloc(ns_uart_framer_t *f);
+
+/**
+ * @brief Give a taken or lent buffer back, refilling the reception reserve first
+ */
+extern void ns_uart_framer_release(ns_uart_framer_t *f, uint8_t *frame);
+
+/**
+ * @brief True if buf is one of the framer's buffers
+ */
+extern bool ns_uart_framer_owns(const ns_uart_framer_t *f, const uint8_t *buf);
+
+/**
+ * @brief Largest payload whose encoding fits in a frame buffer
+ */
+extern uint32_t ns_uart_framer_payload_max(const ns_uart_framer_t *f);
+
+/**
+ * @brief COBS encode data followed by trailer (e.g. a CRC), and append the delimiter
+ *
+ * @param data
+ * @param len
+ * @param trailer may be NULL
+ * @param trailerLen
+ * @param dst
+ * @param cap needs NS_UART_COBS_MAX_ENCODED(len + trailerLen) + 1 bytes
+ * @return uint32_t encoded length including the delimiter, 0 if it does not fit
+ */
+extern uint32_t ns_uart_cobs_encode(
+    const uint8_t *data, uint32_t len, const uint8_t *trailer, uint32_t trailerLen, uint8_t *dst,
+    uint32_t cap);
+
+/**
+ * @brief COBS decode in place (without the delimiter)
+ *
+ * @return int32_t decoded length, -1 if the encoding is invalid
+ */
+extern int32_t ns_uart_cobs_decode(uint8_t *buf, uint32_t len);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_UART_FRAME_H
+/** @}*/
@@ -19,6 +19,19 @@ am_hal_uart_config_t g_sUartConfig =
     .eRXFifoLevel = AM_HAL_UART_FIFO_LEVEL_16,
 };
 
+// Drain the RX FIFO straight into the framer's current frame buffer
+static void ns_uart_framed_rx(ns_uart_framer_t *framer)
+{
+    uint32_t space;
+    uint32_t ui32BytesRead;
+    do {
+        uint8_t *window = ns_uart_framer_rx_window(framer, &space);
+        ui32BytesRead = 0;
+        am_hal_uart_fifo_read(phUART, window, space, &ui32BytesRead);
+        ns_uart_framer_rx_commit(framer, ui32BytesRead);
+    } while (ui32BytesRead == space);
+}
+
 ns_uart_transaction_t g_sUartTransaction =
 {
     .status = 0,
@@ -30,10 +43,16 @@ void am_uart_isr(void)
     uint32_t ui32Status;
     am_hal_uart_interrupt_status_get(phUART, &ui32Status, true);
     am_hal_uart_interrupt_clear(phUART, ui32Status);
-    am_hal_uart_interrupt_service(phUART, ui32Status);
 
     ns_uart_config_t * ctx = &ns_uart_config;
 
+    // RX fires at the FIFO threshold, RX_TMOUT when the line goes idle with bytes left over
+    if ((ctx->framer != NULL) && (ui32Status & (AM_HAL_UART_INT_RX | AM_HAL_UART_INT_RX_TMOUT)))
+    {
+        ns_uart_framed_rx(ctx->framer);
+    }
+    am_hal_uart_interrupt_service(phUART, ui32Status);
+
     // Set the data available flag if RX interrupt is set
     if (ui32Status & (AM_HAL_UART_INT_RX | AM_HAL_UART_INT_RX_TMOUT))
     {
@@ -59,6 +78,11 @@ void am_uart2_isr(void) {
     uint32_t ui32Status;
     am_hal_uart_interrupt_status_get(phUART, &ui32Status, true);
     am_hal_uart_interrupt_clear(phUART, ui32Status);
+    if ((ns_uart_config.framer != NULL) &&
+        (ui32Status & (AM_HAL_UART_INT_RX | AM_HAL_UART_INT_RX_TMOUT)))
+    {
+        ns_uart_framed_rx(ns_uart_config.framer);
+    }
     am_hal_uart_interrupt_service(phUART, ui32Status);
     // Set the data available flag if RX interrupt is set
     if (ui32Status & AM_HAL_UART_INT_RX)
@@ -58,6 +58,13 @@ uint32_t ns_uart_init(ns_uart_config_t *cfg, ns_uart_handle_t * handle) {
     ns_uart_config.uart_config = cfg->uart_config;
     ns_uart_config.rx_blocking = cfg->rx_blocking;
     ns_uart_config.tx_blocking = cfg->tx_blocking;
+    ns_uart_config.framer = cfg->framer;
+#if defined(AM_PART_APOLLO3) || defined(AM_PART_APOLLO3P)
+    if (cfg->framer != NULL) {
+        // Apollo3's HAL queues RX data itself, framed reception is not supported
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
     *handle = (void *)&ns_uart_config;
     return init_uart(cfg->uart_config);
 }
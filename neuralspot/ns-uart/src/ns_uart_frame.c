@@ -0,0 +1,263 @@
+/**
+ * @file ns_uart_frame.c
+ * @author Ambiq
+ * @brief COBS framed UART reception into a pool of frame buffers
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_uart_frame.h"
+#include "ns_core.h"
+#include <string.h>
+
+#define NS_UART_FRAMER_MASK (NS_UART_FRAMER_MAX_FRAMES - 1)
+
+// Queue entries must be written before the index that publishes them. The rx side runs in an
+// interrupt on the same core, so a compiler barrier is enough.
+#define NS_UART_FRAMER_BARRIER() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+static uint8_t *ns_uart_framer_buf(const ns_uart_framer_t *f, uint8_t idx) {
+    return f->pool + (uint32_t)idx * f->frameSize;
+}
+
+uint32_t ns_uart_framer_init(ns_uart_framer_t *f) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (f == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if ((f->pool == NULL) || (f->frameSize < 2) || (f->numFrames > NS_UART_FRAMER_MAX_FRAMES) ||
+        (f->rxDepth == 0) || (f->rxDepth >= f->numFrames)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    f->filling = NS_UART_FRAMER_NONE;
+    f->fill = 0;
+    f->discarding = false;
+    f->rxFreeHead = 0;
+    f->rxFreeTail = 0;
+    f->readyHead = 0;
+    f->readyTail = 0;
+    f->numSpare = 0;
+    f->frames = 0;
+    f->overruns = 0;
+    f->oversize = 0;
+    f->decodeErrors = 0;
+
+    for (uint8_t i = 0; i < f->numFrames; i++) {
+        if (i < f->rxDepth) {
+            f->rxFree[f->rxFreeHead++ & NS_UART_FRAMER_MASK] = i;
+        } else {
+            f->spare[f->numSpare++] = i;
+        }
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+static void ns_uart_framer_take(ns_uart_framer_t *f) {
+    if (f->filling == NS_UART_FRAMER_NONE && f->rxFreeTail != f->rxFreeHead) {
+        f->filling = f->rxFree[f->rxFreeTail & NS_UART_FRAMER_MASK];
+        NS_UART_FRAMER_BARRIER();
+        f->rxFreeTail++;
+        f->fill = 0;
+    }
+}
+
+uint8_t *ns_uart_framer_rx_window(ns_uart_framer_t *f, uint32_t *space) {
+    ns_uart_framer_take(f);
+    if (f->filling == NS_UART_FRAMER_NONE || f->discarding || f->fill == f->frameSize) {
+        // Still has to drain the FIFO - the bytes are dropped or, if they only hold the
+        // delimiter of a full frame, accepted by ns_uart_framer_rx_commit()
+        *space = sizeof(f->sink);
+        return f->sink;
+    }
+    *space = f->frameSize - f->fill;
+    return ns_uart_framer_buf(f, f->filling) + f->fill;
+}
+
+// Add bytes that belong to the frame in progress. src is either already in place (the window)
+// or the tail of a chunk that followed a delimiter.
+static void ns_uart_framer_bytes(ns_uart_framer_t *f, const uint8_t *src, uint32_t n) {
+    if (n == 0 || f->discarding) {
+        return;
+    }
+    ns_uart_framer_take(f);
+    if (f->filling == NS_UART_FRAMER_NONE) {
+        f->overruns++;
+        f->discarding = true;
+        return;
+    }
+    if (f->fill + n > f->frameSize) {
+        f->oversize++;
+        f->discarding = true;
+        return;
+    }
+    uint8_t *dst = ns_uart_framer_buf(f, f->filling) + f->fill;
+    if (dst != src) {
+        memmove(dst, src, n);
+    }
+    f->fill += n;
+}
+
+static void ns_uart_framer_end(ns_uart_framer_t *f) {
+    if (!f->discarding && f->filling != NS_UART_FRAMER_NONE && f->fill != 0) {
+        int32_t len = ns_uart_cobs_decode(ns_uart_framer_buf(f, f->filling), f->fill);
+        if (len < 0) {
+            f->decodeErrors++;
+        } else if (len > 0) {
+            uint8_t slot = f->readyHead & NS_UART_FRAMER_MASK;
+            f->ready[slot] = f->filling;
+            f->readyLen[slot] = (uint32_t)len;
+            NS_UART_FRAMER_BARRIER();
+            f->readyHead++;
+            f->frames++;
+            f->filling = NS_UART_FRAMER_NONE;
+        }
+    }
+    // Empty frames (back to back delimiters) are used to resynchronize and are skipped
+    f->fill = 0;
+    f->discarding = false;
+}
+
+void ns_uart_framer_rx_commit(ns_uart_framer_t *f, uint32_t count) {
+    const uint8_t *src;
+
+    if (f->filling == NS_UART_FRAMER_NONE || f->discarding || f->fill == f->frameSize) {
+        src = f->sink;
+    } else {
+        src = ns_uart_framer_buf(f, f->filling) + f->fill;
+    }
+
+    while (count != 0) {
+        const uint8_t *zero = memchr(src, 0, count);
+        uint32_t seg = zero ? (uint32_t)(zero - src) : count;
+
+        ns_uart_framer_bytes(f, src, seg);
+        if (zero == NULL) {
+            break;
+        }
+        ns_uart_framer_end(f);
+        src = zero + 1;
+        count -= seg + 1;
+    }
+}
+
+void ns_uart_framer_rx(ns_uart_framer_t *f, const uint8_t *data, uint32_t len) {
+    while (len != 0) {
+        uint32_t space;
+        uint8_t *window = ns_uart_framer_rx_window(f, &space);
+        uint32_t n = MIN(space, len);
+        memcpy(window, data, n);
+        ns_uart_framer_rx_commit(f, n);
+        data += n;
+        len -= n;
+    }
+}
+
+bool ns_uart_framer_available(const ns_uart_framer_t *f) {
+    return f->readyTail != f->readyHead;
+}
+
+bool ns_uart_framer_get(ns_uart_framer_t *f, uint8_t **frame, uint32_t *len) {
+    if (f->readyTail == f->readyHead) {
+        return false;
+    }
+    uint8_t slot = f->readyTail & NS_UART_FRAMER_MASK;
+    *frame = ns_uart_framer_buf(f, f->ready[slot]);
+    *len = f->readyLen[slot];
+    NS_UART_FRAMER_BARRIER();
+    f->readyTail++;
+    return true;
+}
+
+uint8_t *ns_uart_framer_alloc(ns_uart_framer_t *f) {
+    if (f->numSpare == 0) {
+        return NULL;
+    }
+    return ns_uart_framer_buf(f, f->spare[--f->numSpare]);
+}
+
+void ns_uart_framer_release(ns_uart_framer_t *f, uint8_t *frame) {
+    uint8_t idx = (uint8_t)((uint32_t)(frame - f->pool) / f->frameSize);
+
+    if ((uint8_t)(f->rxFreeHead - f->rxFreeTail) < f->rxDepth) {
+        f->rxFree[f->rxFreeHead & NS_UART_FRAMER_MASK] = idx;
+        NS_UART_FRAMER_BARRIER();
+        f->rxFreeHead++;
+    } else {
+        f->spare[f->numSpare++] = idx;
+    }
+}
+
+bool ns_uart_framer_owns(const ns_uart_framer_t *f, const uint8_t *buf) {
+    if (buf < f->pool || buf >= f->pool + (uint32_t)f->numFrames * f->frameSize) {
+        return false;
+    }
+    return ((uint32_t)(buf - f->pool) % f->frameSize) == 0;
+}
+
+uint32_t ns_uart_framer_payload_max(const ns_uart_framer_t *f) {
+    uint32_t n = f->frameSize - 1;
+    while (n != 0 && NS_UART_COBS_MAX_ENCODED(n) > f->frameSize) {
+        n--;
+    }
+    return n;
+}
+
+uint32_t ns_uart_cobs_encode(
+    const uint8_t *data, uint32_t len, const uint8_t *trailer, uint32_t trailerLen, uint8_t *dst,
+    uint32_t cap) {
+    uint32_t total = len + trailerLen;
+    uint32_t codePos = 0;
+    uint32_t out = 1;
+    uint8_t code = 1;
+
+    if (cap < NS_UART_COBS_MAX_ENCODED(total) + 1) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < total; i++) {
+        uint8_t b = (i < len) ? data[i] : trailer[i - len];
+        if (b == 0) {
+            dst[codePos] = code;
+            codePos = out++;
+            code = 1;
+        } else {
+            dst[out++] = b;
+            if (++code == 0xFF) {
+                dst[codePos] = code;
+                codePos = out++;
+                code = 1;
+            }
+        }
+    }
+    dst[codePos] = code;
+    dst[out++] = 0;
+    return out;
+}
+
+int32_t ns_uart_cobs_decode(uint8_t *buf, uint32_t len) {
+    uint32_t in = 0;
+    uint32_t out = 0;
+
+    // The output never overtakes the input, so decoding in place is safe
+    while (in < len) {
+        uint8_t code = buf[in++];
+        if (code == 0 || in + code - 1 > len) {
+            return -1;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (buf[in] == 0) {
+                return -1; // delimiters never appear inside a frame
+            }
+            buf[out++] = buf[in++];
+        }
+        if (code != 0xFF && in < len) {
+            buf[out++] = 0;
+        }
+    }
+    return (int32_t)out;
+}
@@ -0,0 +1,340 @@
+#if defined(__unix__) || defined(__APPLE__)
+    // posix_openpt() and cfmakeraw() for the pseudo-terminal test
+    #define _DEFAULT_SOURCE
+    #define _XOPEN_SOURCE 600
+    #define NS_UART_FRAME_TESTS_PTY
+#endif
+
+#include "ns_uart_frame_tests.h"
+#include "ns_core.h"
+#include "unity/unity.h"
+#include <string.h>
+
+#ifdef NS_UART_FRAME_TESTS_PTY
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <stdlib.h>
+    #include <termios.h>
+    #include <unistd.h>
+#endif
+
+#define FT_FRAME_SIZE 64
+#define FT_NUM_FRAMES 4
+
+static uint8_t pool[FT_NUM_FRAMES * FT_FRAME_SIZE];
+static uint8_t wire[1024];
+static ns_uart_framer_t framer;
+
+static void ft_setup(uint32_t frameSize, uint8_t numFrames, uint8_t rxDepth) {
+    memset(&framer, 0, sizeof(framer));
+    framer.pool = pool;
+    framer.frameSize = frameSize;
+    framer.numFrames = numFrames;
+    framer.rxDepth = rxDepth;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_uart_framer_init(&framer));
+}
+
+// Deterministic payload with zeros sprinkled in
+static void ft_payload(uint8_t *p, uint32_t len, uint32_t seed) {
+    for (uint32_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        p[i] = ((seed >> 16) % 5 == 0) ? 0 : (uint8_t)(seed >> 8);
+    }
+}
+
+// eRPC's CRC-16, as appended by the COBS transport
+static uint16_t ft_crc16(const uint8_t *data, uint32_t len) {
+    uint32_t crc = 0xEF4A;
+    for (uint32_t j = 0; j < len; j++) {
+        crc ^= (uint32_t)data[j] << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return (uint16_t)crc;
+}
+
+void ns_uart_frame_tests_pre_test_hook() {}
+
+void ns_uart_frame_tests_post_test_hook() {}
+
+void ns_uart_frame_test_cobs_roundtrip() {
+    static uint8_t data[600];
+    static uint8_t enc[NS_UART_COBS_MAX_ENCODED(sizeof(data) + 2) + 1];
+    const uint32_t lens[] = {1, 2, 253, 254, 255, 508, 600};
+
+    for (uint32_t t = 0; t < sizeof(lens) / sizeof(lens[0]); t++) {
+        ft_payload(data, lens[t], t);
+        uint32_t n = ns_uart_cobs_encode(data, lens[t], NULL, 0, enc, sizeof(enc));
+        TEST_ASSERT_TRUE(n != 0);
+        TEST_ASSERT_TRUE(n <= NS_UART_COBS_MAX_ENCODED(lens[t]) + 1);
+        TEST_ASSERT_EQUAL(0, enc[n - 1]);
+        TEST_ASSERT_NULL(memchr(enc, 0, n - 1));
+        TEST_ASSERT_EQUAL(lens[t], ns_uart_cobs_decode(enc, n - 1));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data, enc, lens[t]);
+    }
+
+    // Runs of non-zero bytes hit the 254 byte block limit
+    memset(data, 0x55, 600);
+    uint32_t n = ns_uart_cobs_encode(data, 600, NULL, 0, enc, sizeof(enc));
+    TEST_ASSERT_EQUAL(0xFF, enc[0]);
+    TEST_ASSERT_EQUAL(600, ns_uart_cobs_decode(enc, n - 1));
+    for (uint32_t i = 0; i < 600; i++) {
+        TEST_ASSERT_EQUAL(0x55, enc[i]);
+    }
+
+    // Trailer is encoded as if appended to the data
+    const uint8_t trailer[2] = {0x00, 0xAB};
+    ft_payload(data, 10, 7);
+    n = ns_uart_cobs_encode(data, 10, trailer, 2, enc, sizeof(enc));
+    TEST_ASSERT_EQUAL(12, ns_uart_cobs_decode(enc, n - 1));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, enc, 10);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(trailer, enc + 10, 2);
+
+    // Not enough room
+    TEST_ASSERT_EQUAL(0, ns_uart_cobs_encode(data, 10, NULL, 0, enc, 11));
+    TEST_ASSERT_EQUAL(12, ns_uart_cobs_encode(data, 10, NULL, 0, enc, 12));
+}
+
+void ns_uart_frame_test_cobs_invalid() {
+    uint8_t zero[] = {0x02, 0x00};
+    uint8_t past_end[] = {0x05, 0x11, 0x22};
+    uint8_t empty[] = {0x01};
+
+    TEST_ASSERT_EQUAL(-1, ns_uart_cobs_decode(zero, sizeof(zero)));
+    TEST_ASSERT_EQUAL(-1, ns_uart_cobs_decode(past_end, sizeof(past_end)));
+    TEST_ASSERT_EQUAL(0, ns_uart_cobs_decode(empty, sizeof(empty)));
+}
+
+void ns_uart_frame_test_init_validation() {
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_uart_framer_init(NULL));
+
+    memset(&framer, 0, sizeof(framer));
+    framer.frameSize = FT_FRAME_SIZE;
+    framer.numFrames = FT_NUM_FRAMES;
+    framer.rxDepth = 2;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_uart_framer_init(&framer));
+
+    framer.pool = pool;
+    framer.rxDepth = FT_NUM_FRAMES; // nothing left to lend
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_uart_framer_init(&framer));
+    framer.rxDepth = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_uart_framer_init(&framer));
+    framer.rxDepth = 1;
+    framer.numFrames = NS_UART_FRAMER_MAX_FRAMES + 1;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_uart_framer_init(&framer));
+    framer.numFrames = FT_NUM_FRAMES;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_uart_framer_init(&framer));
+    TEST_ASSERT_FALSE(ns_uart_framer_available(&framer));
+}
+
+// Feed bytes the way the RX interrupt does: read at most `chunk` bytes into the window
+static void ft_feed(const uint8_t *data, uint32_t len, uint32_t chunk) {
+    while (len != 0) {
+        uint32_t space;
+        uint8_t *window = ns_uart_framer_rx_window(&framer, &space);
+        uint32_t n = MIN(MIN(space, chunk), len);
+        memcpy(window, data, n);
+        ns_uart_framer_rx_commit(&framer, n);
+        data += n;
+        len -= n;
+    }
+}
+
+void ns_uart_frame_test_chunked_rx() {
+    uint8_t payloads[3][40];
+    const uint32_t lens[3] = {40, 1, 17};
+
+    for (uint32_t chunk = 1; chunk <= 40; chunk++) {
+        ft_setup(FT_FRAME_SIZE, FT_NUM_FRAMES, 3);
+        uint32_t wireLen = 1;
+        wire[0] = 0; // leading delimiter, as senders use to resynchronize
+        for (int i = 0; i < 3; i++) {
+            ft_payload(payloads[i], lens[i], i + chunk);
+            wireLen += ns_uart_cobs_encode(
+                payloads[i], lens[i], NULL, 0, wire + wireLen, sizeof(wire) - wireLen);
+        }
+        ft_feed(wire, wireLen, chunk);
+
+        for (int i = 0; i < 3; i++) {
+            uint8_t *frame;
+            uint32_t len;
+            TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+            TEST_ASSERT_TRUE(ns_uart_framer_owns(&framer, frame));
+            TEST_ASSERT_EQUAL(lens[i], len);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(payloads[i], frame, len);
+            ns_uart_framer_release(&framer, frame);
+        }
+        TEST_ASSERT_FALSE(ns_uart_framer_available(&framer));
+        TEST_ASSERT_EQUAL(3, framer.frames);
+        TEST_ASSERT_EQUAL(0, framer.overruns + framer.oversize + framer.decodeErrors);
+    }
+}
+
+void ns_uart_frame_test_overrun() {
+    uint8_t payload[20];
+    uint8_t *frame;
+    uint32_t len;
+
+    // Two buffers for reception and nobody consuming: the third frame has nowhere to go
+    ft_setup(FT_FRAME_SIZE, FT_NUM_FRAMES, 2);
+    uint32_t wireLen = 0;
+    for (int i = 0; i < 3; i++) {
+        ft_payload(payload, sizeof(payload), i);
+        wireLen += ns_uart_cobs_encode(
+            payload, sizeof(payload), NULL, 0, wire + wireLen, sizeof(wire) - wireLen);
+    }
+    ft_feed(wire, wireLen, 16);
+    TEST_ASSERT_EQUAL(2, framer.frames);
+    TEST_ASSERT_EQUAL(1, framer.overruns);
+
+    // Once a buffer is released reception resumes
+    TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+    ns_uart_framer_release(&framer, frame);
+    ft_payload(payload, sizeof(payload), 9);
+    wireLen = ns_uart_cobs_encode(payload, sizeof(payload), NULL, 0, wire, sizeof(wire));
+    ft_feed(wire, wireLen, 16);
+    TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+    TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, frame, sizeof(payload));
+    TEST_ASSERT_EQUAL(1, framer.overruns);
+}
+
+void ns_uart_frame_test_oversize() {
+    uint8_t payload[FT_FRAME_SIZE + 8];
+    uint8_t *frame;
+    uint32_t len;
+    uint32_t max;
+
+    ft_setup(FT_FRAME_SIZE, FT_NUM_FRAMES, 2);
+    max = ns_uart_framer_payload_max(&framer);
+    TEST_ASSERT_TRUE(NS_UART_COBS_MAX_ENCODED(max) <= FT_FRAME_SIZE);
+    TEST_ASSERT_TRUE(NS_UART_COBS_MAX_ENCODED(max + 1) > FT_FRAME_SIZE);
+
+    // Too big, followed by a frame that fills the buffer exactly
+    memset(payload, 0x33, sizeof(payload));
+    uint32_t wireLen = ns_uart_cobs_encode(payload, sizeof(payload), NULL, 0, wire, sizeof(wire));
+    wireLen += ns_uart_cobs_encode(
+        payload, FT_FRAME_SIZE - 1, NULL, 0, wire + wireLen, sizeof(wire) - wireLen);
+    ft_feed(wire, wireLen, 7);
+
+    TEST_ASSERT_EQUAL(1, framer.oversize);
+    TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+    TEST_ASSERT_EQUAL(FT_FRAME_SIZE - 1, len);
+    TEST_ASSERT_FALSE(ns_uart_framer_available(&framer));
+}
+
+void ns_uart_frame_test_resync() {
+    uint8_t payload[12];
+    uint8_t *frame;
+    uint32_t len;
+
+    ft_setup(FT_FRAME_SIZE, FT_NUM_FRAMES, 2);
+
+    // Tail of a frame whose start was lost, then a corrupted one (code byte past the end)
+    uint32_t wireLen = 0;
+    const uint8_t junk[] = {0x07, 0x01, 0x00, 0x09, 0x11, 0x22, 0x00};
+    memcpy(wire, junk, sizeof(junk));
+    wireLen = sizeof(junk);
+    ft_payload(payload, sizeof(payload), 3);
+    wireLen += ns_uart_cobs_encode(
+        payload, sizeof(payload), NULL, 0, wire + wireLen, sizeof(wire) - wireLen);
+    ft_feed(wire, wireLen, 5);
+
+    TEST_ASSERT_EQUAL(2, framer.decodeErrors);
+    TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+    TEST_ASSERT_EQUAL(sizeof(payload), len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, frame, len);
+}
+
+void ns_uart_frame_test_lend_release() {
+    uint8_t *lent[FT_NUM_FRAMES];
+    uint8_t *frame;
+    uint32_t len;
+
+    ft_setup(FT_FRAME_SIZE, FT_NUM_FRAMES, 2);
+    lent[0] = ns_uart_framer_alloc(&framer);
+    lent[1] = ns_uart_framer_alloc(&framer);
+    TEST_ASSERT_NOT_NULL(lent[0]);
+    TEST_ASSERT_NOT_NULL(lent[1]);
+    TEST_ASSERT_TRUE(lent[0] != lent[1]);
+    TEST_ASSERT_NULL(ns_uart_framer_alloc(&framer));
+    TEST_ASSERT_TRUE(ns_uart_framer_owns(&framer, lent[0]));
+    TEST_ASSERT_FALSE(ns_uart_framer_owns(&framer, lent[0] + 1));
+    TEST_ASSERT_FALSE(ns_uart_framer_owns(&framer, wire));
+
+    // A swap, as the eRPC transport does it: the received frame replaces the lent buffer,
+    // which goes back to reception
+    wire[0] = 0x02;
+    wire[1] = 0x42;
+    wire[2] = 0x00;
+    ft_feed(wire, 3, 3);
+    TEST_ASSERT_TRUE(ns_uart_framer_get(&framer, &frame, &len));
+    ns_uart_framer_release(&framer, lent[0]);
+    lent[0] = frame;
+    TEST_ASSERT_NULL(ns_uart_framer_alloc(&framer));
+
+    // With the reception reserve full, released buffers can be lent again
+    ns_uart_framer_release(&framer, lent[1]);
+    TEST_ASSERT_EQUAL_PTR(lent[1], ns_uart_framer_alloc(&framer));
+}
+
+#ifdef NS_UART_FRAME_TESTS_PTY
+// Frames with a CRC trailer written to one end of a pseudo-terminal, read from the other end
+// straight into the framer's window - the path the UART interrupt takes with the RX FIFO
+void ns_uart_frame_test_pty() {
+    static uint8_t payloads[24][FT_FRAME_SIZE];
+    uint32_t lens[24];
+    struct termios tio;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    TEST_ASSERT_TRUE(master >= 0);
+    TEST_ASSERT_EQUAL(0, grantpt(master));
+    TEST_ASSERT_EQUAL(0, unlockpt(master));
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    TEST_ASSERT_TRUE(slave >= 0);
+    TEST_ASSERT_EQUAL(0, tcgetattr(slave, &tio));
+    cfmakeraw(&tio);
+    TEST_ASSERT_EQUAL(0, tcsetattr(slave, TCSANOW, &tio));
+
+    ft_setup(FT_FRAME_SIZE, FT_NUM_FRAMES, 3);
+    uint32_t maxPayload = ns_uart_framer_payload_max(&framer) - 2;
+    uint32_t wireLen = 0;
+    for (uint32_t i = 0; i < 24; i++) {
+        lens[i] = 1 + (i * 7) % maxPayload;
+        ft_payload(payloads[i], lens[i], i);
+        uint16_t crc = ft_crc16(payloads[i], lens[i]);
+        uint8_t trailer[2] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+        wireLen += ns_uart_cobs_encode(
+            payloads[i], lens[i], trailer, 2, wire + wireLen, sizeof(wire) - wireLen);
+    }
+    TEST_ASSERT_EQUAL(wireLen, write(master, wire, wireLen));
+
+    uint32_t received = 0;
+    while (received < 24) {
+        struct pollfd pfd = {.fd = slave, .events = POLLIN};
+        TEST_ASSERT_TRUE_MESSAGE(poll(&pfd, 1, 1000) > 0, "pty read timed out");
+
+        uint32_t space;
+        uint8_t *window = ns_uart_framer_rx_window(&framer, &space);
+        ssize_t n = read(slave, window, MIN(space, 16)); // at most a FIFO's worth
+        TEST_ASSERT_TRUE(n > 0);
+        ns_uart_framer_rx_commit(&framer, (uint32_t)n);
+
+        uint8_t *frame;
+        uint32_t len;
+        while (ns_uart_framer_get(&framer, &frame, &len)) {
+            TEST_ASSERT_EQUAL(lens[received] + 2, len);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(payloads[received], frame, lens[received]);
+            TEST_ASSERT_EQUAL_HEX16(
+                ft_crc16(frame, len - 2), frame[len - 2] | (frame[len - 1] << 8));
+            ns_uart_framer_release(&framer, frame);
+            received++;
+        }
+    }
+    TEST_ASSERT_EQUAL(0, framer.overruns + framer.oversize + framer.decodeErrors);
+    close(slave);
+    close(master);
+}
+#else
+void ns_uart_frame_test_pty() { TEST_IGNORE_MESSAGE("needs a POSIX host"); }
+#endif
@@ -0,0 +1,12 @@
+#include "ns_uart_frame.h"
+void ns_uart_frame_tests_pre_test_hook();
+void ns_uart_frame_tests_post_test_hook();
+void ns_uart_frame_test_cobs_roundtrip();
+void ns_uart_frame_test_cobs_invalid();
+void ns_uart_frame_test_init_validation();
+void ns_uart_frame_test_chunked_rx();
+void ns_uart_frame_test_overrun();
+void ns_uart_frame_test_oversize();
+void ns_uart_frame_test_resync();
+void ns_uart_frame_test_lend_release();
+void ns_uart_frame_test_pty();
@@ -0,0 +1,99 @@
+/**
+ * @file ns_fast_log.h
+ * @author Ambiq
+ * @brief Table-driven vector logarithm kernels shared by the audio feature front ends
+ * @version 0.1
+ * @date 2025-07-08
+ *
+ * Logarithms are computed as exponent + log(mantissa):
+ *  - the exponent comes from a count-leading-zeros (fixed point) or the IEEE
+ *    exponent field (float), so there is no bit-search loop
+ *  - log(mantissa), mantissa in [1,2), is linearly interpolated from a
+ *    small table (128 Q15 segments, 256 float segments)
+ *
+ * Fixed point variants produce Q15 results in int32_t and, for non-negative
+ * inputs, are bit-exact with the ns-nnsp my_log10() implementation. The float
+ * variants have a maximum absolute error of 8e-6 versus libm for normal,
+ * positive inputs. Inputs <= 0 are treated as the smallest representable
+ * positive value (1 LSB for fixed point, FLT_MIN for float).
+ *
+ * On cores with Helium (MVE), vector paths are used automatically; otherwise
+ * portable C is compiled.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-fast-log
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_FAST_LOG_H
+    #define NS_FAST_LOG_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include <stdint.h>
+
+    #define NS_LOG2_DIV_LOG10_Q15 (0x2688) ///< log10(2) in Q15
+    #define NS_INV_LN10_Q15 (0x3796)       ///< 1 / ln(10) in Q15
+    #define NS_INV_LN2_Q15 (0xB8AA)        ///< 1 / ln(2) in Q15
+
+/// Interpolation table for ln(1+u), u in [0,1): 128 (value, slope) pairs in Q15
+extern const int16_t ns_log_mantissa_q15[256];
+
+/**
+ * @brief log10 of a vector of fixed point values
+ *
+ * @param out log10(x) in Q15
+ * @param x input, with bit_frac_in fractional bits
+ * @param len number of elements (in-place is allowed)
+ * @param bit_frac_in fractional bits of x
+ */
+extern void ns_log10_q31_vec(int32_t *out, const int32_t *x, uint32_t len, int16_t bit_frac_in);
+
+/**
+ * @brief log2 of a vector of fixed point values
+ *
+ * @param out log2(x) in Q15
+ * @param x input, with bit_frac_in fractional bits
+ * @param len number of elements (in-place is allowed)
+ * @param bit_frac_in fractional bits of x
+ */
+extern void ns_log2_q31_vec(int32_t *out, const int32_t *x, uint32_t len, int16_t bit_frac_in);
+
+/**
+ * @brief log10 of a vector of 16b fixed point values
+ *
+ * @param out log10(x) in Q15
+ * @param x input, with bit_frac_in fractional bits
+ * @param len number of elements
+ * @param bit_frac_in fractional bits of x
+ */
+extern void ns_log10_q15_vec(int32_t *out, const int16_t *x, uint32_t len, int16_t bit_frac_in);
+
+/**
+ * @brief Natural log of a vector of floats
+ *
+ * @param out ln(x)
+ * @param x input
+ * @param len number of elements (in-place is allowed)
+ */
+extern void ns_logf_vec(float *out, const float *x, uint32_t len);
+
+/**
+ * @brief log10 of a vector of floats
+ *
+ * @param out log10(x)
+ * @param x input
+ * @param len number of elements (in-place is allowed)
+ */
+extern void ns_log10f_vec(float *out, const float *x, uint32_t len);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_FAST_LOG_H
+/** @}*/
@@ -0,0 +1,102 @@
+/**
+ * @file ns_pmu_metrics.h
+ * @author Ambiq
+ * @brief Derived performance metrics from raw PMU event counts
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ * Turns a set of PMU event values (for example one layer's estimates from ns_pmu_mux) into:
+ *
+ * - IPC: INST_RETIRED / CPU_CYCLES
+ * - MVE beat utilization: MVE beats executed (4 per MVE instruction) / beats the core could
+ *   have executed (beatsPerCycle per cycle, 2 on Cortex-M55)
+ * - Load/store stall ratio: MVE memory resource stall cycles / CPU_CYCLES
+ * - MPKI: L1 D-cache refills per thousand instructions
+ * - Roofline class: arithmetic intensity (instructions per byte refilled) against the ridge
+ *   point peakIpc / memBytesPerCycle. Below the ridge the layer is memory bound.
+ *
+ * A metric is only computed when all of its events are present - see the valid mask.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-pmu-metrics
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_PMU_METRICS_H
+    #define NS_PMU_METRICS_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_pmu_mux.h"
+    #include <stdint.h>
+
+    // Valid mask bits
+    #define NS_PMU_METRIC_IPC (1 << 0)
+    #define NS_PMU_METRIC_MVE_BEATS (1 << 1)
+    #define NS_PMU_METRIC_LDST_STALL (1 << 2)
+    #define NS_PMU_METRIC_MPKI (1 << 3)
+    #define NS_PMU_METRIC_BOUND (1 << 4)
+
+    #define NS_PMU_METRICS_NUM_EVENTS 8 ///< Length of ns_pmu_metrics_events
+
+typedef enum {
+    NS_PMU_BOUND_UNKNOWN = 0,
+    NS_PMU_BOUND_COMPUTE,
+    NS_PMU_BOUND_MEMORY,
+} ns_pmu_bound_e;
+
+/// Machine parameters for the roofline classification
+typedef struct {
+    float peakIpc;          ///< Best sustainable instructions per cycle
+    float memBytesPerCycle; ///< Refill bandwidth from memory
+    uint32_t lineBytes;     ///< Bytes moved per cache refill
+    uint32_t beatsPerCycle; ///< MVE beats the core executes per cycle
+} ns_pmu_machine_t;
+
+/// Cortex-M55 on Apollo5: dual-issue limited, dual-beat MVE, 32B lines, 64-bit bus
+extern const ns_pmu_machine_t ns_pmu_machine_apollo5;
+
+typedef struct {
+    uint32_t valid;         ///< NS_PMU_METRIC_* bits for the fields below that were computed
+    float ipc;              ///< Instructions per cycle
+    float mveBeatUtil;      ///< 0..1
+    float ldstStallRatio;   ///< 0..1
+    float mpki;             ///< L1 D-cache misses per 1000 instructions
+    float intensity;        ///< Instructions per byte refilled
+    float attainableIpc;    ///< Roofline: MIN(peakIpc, intensity * memBytesPerCycle)
+    ns_pmu_bound_e bound;
+} ns_pmu_metrics_t;
+
+/**
+ * @brief Compute derived metrics
+ *
+ * @param samples - event values (order doesn't matter)
+ * @param numSamples
+ * @param machine - NULL for ns_pmu_machine_apollo5
+ * @param metrics - result
+ */
+extern void ns_pmu_metrics_compute(
+    const ns_pmu_sample_t *samples, uint32_t numSamples, const ns_pmu_machine_t *machine,
+    ns_pmu_metrics_t *metrics);
+
+/**
+ * @brief Name of a roofline class, for printing
+ */
+extern const char *ns_pmu_bound_name(ns_pmu_bound_e bound);
+
+/**
+ * @brief Events needed for all derived metrics, in a grouping that suits ns_pmu_mux
+ */
+extern const uint32_t ns_pmu_metrics_events[NS_PMU_METRICS_NUM_EVENTS];
+extern const uint32_t ns_pmu_metrics_num_events;
+
+    #ifdef __cplusplus
+}
+    #endif
+/** @} */
+#endif // NS_PMU_METRICS_H
@@ -0,0 +1,203 @@
+/**
+ * @file ns_pmu_mux.h
+ * @author Ambiq
+ * @brief Time-multiplexed PMU sampling - capture more events than there are counters in one run
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ * The PMU can count 4 32-bit events at a time. The multiplexer splits the requested events
+ * into groups of 4 and rotates through them, on a time slice (ns_pmu_mux_rotate(), usually
+ * from a timer) and at every layer boundary. Each group's counts are accumulated per layer
+ * along with the cycles that group was actually counting, and estimates are extrapolated to
+ * the full layer: estimate = count * layerCycles / groupCycles.
+ *
+ * A group that never got to count during a layer (a layer shorter than a time slice) has no
+ * estimate for that layer. Running the model again accumulates more coverage - estimates
+ * improve with every run, and a layer can be as short as one slice for full coverage after
+ * numGroups runs.
+ *
+ * The multiplexer reaches the PMU through ns_pmu_mux_port_t, so the bookkeeping can be
+ * tested against synthetic counter traces.
+ *
+ * This file also hosts ns_pmu_rerun_source_layer(), which maps profiler layers to the
+ * events captured by ns_characterize_model()'s rerun mode.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-pmu-mux
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_PMU_MUX_H
+    #define NS_PMU_MUX_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_PMU_MUX_V0_0_1                                                                      \
+        { .major = 0, .minor = 0, .revision = 1 }
+
+    #define NS_PMU_MUX_OLDEST_SUPPORTED_VERSION NS_PMU_MUX_V0_0_1
+    #define NS_PMU_MUX_CURRENT_VERSION NS_PMU_MUX_V0_0_1
+    #define NS_PMU_MUX_API_ID 0xCA0010
+
+    #define NS_PMU_MUX_GROUP_SIZE 4 ///< 32-bit (chained) counters available at once
+
+    /// Number of groups needed for numEvents, use to size groupCycles
+    #define NS_PMU_MUX_GROUPS(numEvents)                                                           \
+        (((numEvents) + NS_PMU_MUX_GROUP_SIZE - 1) / NS_PMU_MUX_GROUP_SIZE)
+
+extern const ns_core_api_t ns_pmu_mux_V0_0_1;
+extern const ns_core_api_t ns_pmu_mux_oldest_supported_version;
+extern const ns_core_api_t ns_pmu_mux_current_version;
+
+/**
+ * @brief PMU access used by the multiplexer
+ *
+ * program() starts counting a group of up to NS_PMU_MUX_GROUP_SIZE events from zero. read()
+ * returns the group's counts and the elapsed cycles since program() or the previous read(),
+ * and restarts counting from zero.
+ */
+typedef struct {
+    void (*program)(void *ctx, const uint32_t *eventIds, uint32_t count);
+    void (*read)(void *ctx, uint32_t *counts, uint32_t *cycles);
+    uint32_t (*lock)(void *ctx);               ///< Optional, e.g. mask interrupts
+    void (*unlock)(void *ctx, uint32_t state); ///< Optional, undo lock()
+    void *ctx;
+} ns_pmu_mux_port_t;
+
+/// An event value, e.g. an extrapolated per-layer estimate
+typedef struct {
+    uint32_t eventId;
+    uint32_t value;
+} ns_pmu_sample_t;
+
+typedef struct {
+    const ns_core_api_t *api;
+    const ns_pmu_mux_port_t *port;
+    const uint32_t *eventIds; ///< Events to capture, grouped in order (4 per group)
+    uint32_t numEvents;
+    uint32_t maxLayers;
+
+    // Storage, allocated by caller
+    uint32_t *counts;      ///< [maxLayers][numEvents] raw counts
+    uint32_t *groupCycles; ///< [maxLayers][NS_PMU_MUX_GROUPS(numEvents)] cycles counted
+
+    // Internal state
+    uint32_t numGroups;
+    uint32_t group;      ///< Group currently programmed
+    uint32_t startGroup; ///< Group each run starts on
+    uint32_t layer;      ///< Layer being captured
+    uint32_t numLayers;  ///< Layers seen in the current run
+    uint32_t runs;       ///< Runs accumulated, estimates are per run
+    uint32_t rotations;
+    bool inLayer;
+    bool running;
+} ns_pmu_mux_t;
+
+/// Drives the Apollo5 PMU (see ns_pmu_utils)
+extern const ns_pmu_mux_port_t ns_pmu_mux_hw_port;
+
+/**
+ * @brief Initialize the multiplexer and clear all accumulated counts
+ *
+ * @param m api, port, eventIds, numEvents, maxLayers, counts and groupCycles must be set
+ * @return uint32_t status
+ */
+extern uint32_t ns_pmu_mux_init(ns_pmu_mux_t *m);
+
+/**
+ * @brief Clear accumulated counts. Layer numbering restarts at 0.
+ */
+extern void ns_pmu_mux_reset(ns_pmu_mux_t *m);
+
+/**
+ * @brief Start counting a run. Layers are numbered in the order ns_pmu_mux_layer_begin() is
+ * called. For more coverage, call ns_pmu_mux_restart() before each additional run - counts
+ * accumulate into the same layers and estimates are averaged over the runs.
+ */
+extern void ns_pmu_mux_start(ns_pmu_mux_t *m);
+extern void ns_pmu_mux_restart(ns_pmu_mux_t *m);
+extern void ns_pmu_mux_stop(ns_pmu_mux_t *m);
+
+/**
+ * @brief Mark the start/end of a layer. Counts outside of layers are discarded.
+ *
+ * @return uint32_t the layer index, or maxLayers if out of storage
+ */
+extern uint32_t ns_pmu_mux_layer_begin(ns_pmu_mux_t *m);
+extern void ns_pmu_mux_layer_end(ns_pmu_mux_t *m);
+
+/**
+ * @brief Switch to the next group. Call on a time slice, e.g. from an ns_timer_wheel timer.
+ */
+extern void ns_pmu_mux_rotate(ns_pmu_mux_t *m);
+
+/**
+ * @brief Cycles captured for a layer (all groups)
+ */
+extern uint32_t ns_pmu_mux_layer_cycles(const ns_pmu_mux_t *m, uint32_t layer);
+
+/**
+ * @brief Extrapolated count of the event at eventIndex for a layer
+ *
+ * @return uint32_t NS_STATUS_SUCCESS, or NS_STATUS_FAILURE if the event's group never counted
+ * during the layer
+ */
+extern uint32_t
+ns_pmu_mux_estimate(const ns_pmu_mux_t *m, uint32_t layer, uint32_t eventIndex, uint32_t *value);
+
+/**
+ * @brief All available estimates for a layer
+ *
+ * @param out - room for numEvents samples
+ * @return uint32_t number of samples written (events without an estimate are left out)
+ */
+extern uint32_t
+ns_pmu_mux_layer_samples(const ns_pmu_mux_t *m, uint32_t layer, ns_pmu_sample_t *out);
+
+/**
+ * @brief Map a profiler layer to the layer that was captured in ns_characterize_model()'s
+ * rerun mode.
+ *
+ * The first run of a model executes every layer. If the model has a CALL_ONCE layer
+ * (variable initialization), later runs skip the rv*2 layers following it, so they only
+ * have num_layers - rv*2 layers.
+ *
+ * @param layer - profiler layer (first run numbering)
+ * @param rv - number of resource variables
+ * @param callOnceLayer - index of the CALL_ONCE layer, or -1
+ * @param source - layer index within a later run
+ * @return bool false if the layer doesn't run after the first run (no counters)
+ */
+extern bool
+ns_pmu_rerun_source_layer(uint32_t layer, uint32_t rv, int32_t callOnceLayer, uint32_t *source);
+
+/**
+ * @brief Locate a PMU event of the rerun mode in the profiler's snapshot array.
+ *
+ * Rerun mode captures one warm-up run of num_layers events, then one run per group of 4
+ * events (in ns_pmu_map order), each num_layers - rv*2 events long.
+ *
+ * @param source - from ns_pmu_rerun_source_layer()
+ * @param numLayers - layers in the first run
+ * @param rv - number of resource variables
+ * @param mapIndex - event index in ns_pmu_map
+ * @param slot - set to the counter slot (0-3) holding the event
+ * @return uint32_t index into pmu_snapshot
+ */
+extern uint32_t ns_pmu_rerun_snapshot_index(
+    uint32_t source, uint32_t numLayers, uint32_t rv, uint32_t mapIndex, uint32_t *slot);
+
+    #ifdef __cplusplus
+}
+    #endif
+/** @} */
+#endif // NS_PMU_MUX_H
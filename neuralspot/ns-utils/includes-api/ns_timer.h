@@ -29,13 +29,23 @@ extern "C" {
         { .major = 0, .minor = 0, .revision = 1 }
     #define NS_TIMER_V1_0_0                                                                        \
         { .major = 1, .minor = 0, .revision = 0 }
+    #define NS_TIMER_V1_1_0                                                                        \
+        { .major = 1, .minor = 1, .revision = 0 }
 
     #define NS_TIMER_OLDEST_SUPPORTED_VERSION NS_TIMER_V0_0_1
-    #define NS_TIMER_CURRENT_VERSION NS_TIMER_V1_0_0
+    #define NS_TIMER_CURRENT_VERSION NS_TIMER_V1_1_0
     #define NS_TIMER_API_ID 0xCA0002
 
+    // Counter frequency of the timers, in ticks per microsecond
+    #if defined(AM_PART_APOLLO3) || defined(AM_PART_APOLLO3P)
+        #define NS_TIMER_TICKS_PER_US 12
+    #else
+        #define NS_TIMER_TICKS_PER_US 6
+    #endif
+
 extern const ns_core_api_t ns_timer_V0_0_1;
 extern const ns_core_api_t ns_timer_V1_0_0;
+extern const ns_core_api_t ns_timer_V1_1_0;
 extern const ns_core_api_t ns_timer_oldest_supported_version;
 extern const ns_core_api_t ns_timer_current_version;
 
@@ -49,6 +59,7 @@ typedef void (*ns_timer_callback_cb)(struct ns_timer_config *);
 typedef enum {
     NS_TIMER_COUNTER = 0,   ///< Intended use is reading timerticks
     NS_TIMER_INTERRUPT = 1, ///< Calls a callback periodically
+    NS_TIMER_WHEEL = 2,     ///< Free running, compare driven; used by ns_timer_wheel
     NS_TIMER_USB = 3,       ///< Used by ns_usb to periodically service USB
     NS_TIMER_TEMPCO = 4     ///< Used by ns_tempco to periodically collect temps
 } ns_timers_e;
@@ -70,6 +81,8 @@ typedef struct ns_timer_config {
  *
  * NS_TIMER_COUNTER     Intended use is reading timerticks
  * NS_TIMER_INTERRUPT   Calls a callback periodically
+ * NS_TIMER_WHEEL       Free running; the callback is invoked when the counter
+ *                      reaches the value set by ns_timer_compare_set() (API v1.1.0)
  * NS_TIMER_USB         Used by ns_usb to periodically service USB
  * NS_TIMER_TEMPCO      Used by ns_tempco to periodically collect temps
  *
@@ -86,6 +99,37 @@ extern uint32_t ns_timer_init(ns_timer_config_t *cfg);
  */
 extern uint32_t ns_us_ticker_read(ns_timer_config_t *cfg);
 
+/**
+ * @brief Read the raw counter of a timer (NS_TIMER_TICKS_PER_US ticks per uS), API v1.1.0
+ *
+ * @param cfg
+ * @return uint32_t counter if success, 0xDEADBEEF if bad handle
+ */
+extern uint32_t ns_timer_ticks_read(ns_timer_config_t *cfg);
+
+/**
+ * @brief Invoke the NS_TIMER_WHEEL callback when the counter reaches tick, API v1.1.0
+ *
+ * If tick has already passed, the interrupt is pended so the callback runs
+ * right away.
+ *
+ * @param cfg
+ * @param tick absolute counter value
+ * @return uint32_t status
+ */
+extern uint32_t ns_timer_compare_set(ns_timer_config_t *cfg, uint32_t tick);
+
+/**
+ * @brief Get the configuration a timer was last initialized with, API v1.1.0
+ *
+ * Lets a module share a timer the application already started (typically
+ * NS_TIMER_COUNTER) instead of re-initializing it.
+ *
+ * @param timer
+ * @return ns_timer_config_t* the config passed to ns_timer_init(), NULL if none
+ */
+extern ns_timer_config_t *ns_timer_get_config(ns_timers_e timer);
+
 /**
  * @brief Clear timer
  *
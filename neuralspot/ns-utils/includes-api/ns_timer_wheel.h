@@ -0,0 +1,217 @@
+/**
+ * @file ns_timer_wheel.h
+ * @author Ambiq
+ * @brief Many one-shot and periodic software timers on a single hardware timer
+ * @version 0.1
+ * @date 2025-07-18
+ *
+ * Timers are kept in a 4 level hierarchical timing wheel (64 slots per level,
+ * 6 bits of the expiry per level). Each slot is an intrusive doubly linked list,
+ * so starting and stopping a timer is O(1) regardless of how many are running.
+ * Timers far in the future sit in coarse upper level slots and are cascaded
+ * down as their expiry approaches.
+ *
+ * The wheel is tickless: there is no periodic interrupt. The hardware timer runs
+ * freely and its compare is programmed only for the nearest event, so the core
+ * can stay in deep sleep between deadlines. Per-slot occupancy bitmaps make
+ * finding that event, and skipping over idle time, independent of the length of
+ * the sleep.
+ *
+ * Time is quantized to resolutionUs ("jiffies"). Periodic timers are scheduled
+ * from their previous expiry, not from when the callback ran, so they do not
+ * drift. Each timer records dispatch latency (callback time - deadline) and
+ * jitter (deviation of the interval between callbacks from the period).
+ *
+ * The wheel reaches the hardware through ns_timer_wheel_port_t. ns_timer_wheel_hw_port
+ * drives NS_TIMER_WHEEL; tests and simulations can supply a virtual clock instead.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * \addtogroup ns-timer-wheel
+ * @{
+ * @ingroup ns-utils
+ *
+ */
+
+#ifndef NS_TIMER_WHEEL_H
+    #define NS_TIMER_WHEEL_H
+
+    #ifdef __cplusplus
+extern "C" {
+    #endif
+
+    #include "ns_core.h"
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #define NS_TIMER_WHEEL_V0_0_1                                                                  \
+        { .major = 0, .minor = 0, .revision = 1 }
+
+    #define NS_TIMER_WHEEL_OLDEST_SUPPORTED_VERSION NS_TIMER_WHEEL_V0_0_1
+    #define NS_TIMER_WHEEL_CURRENT_VERSION NS_TIMER_WHEEL_V0_0_1
+    #define NS_TIMER_WHEEL_API_ID 0xCA000F
+
+    #define NS_TIMER_WHEEL_LEVELS 4
+    #define NS_TIMER_WHEEL_SLOT_BITS 6
+    #define NS_TIMER_WHEEL_SLOTS (1 << NS_TIMER_WHEEL_SLOT_BITS)
+
+/// Longest delay or period, in jiffies. Longer requests are clamped.
+    #define NS_TIMER_WHEEL_MAX_JIFFIES                                                             \
+        ((1UL << (NS_TIMER_WHEEL_LEVELS * NS_TIMER_WHEEL_SLOT_BITS)) - 1)
+
+extern const ns_core_api_t ns_timer_wheel_V0_0_1;
+extern const ns_core_api_t ns_timer_wheel_oldest_supported_version;
+extern const ns_core_api_t ns_timer_wheel_current_version;
+
+struct ns_timer_wheel;
+struct ns_timer_wheel_timer;
+typedef void (*ns_timer_wheel_cb)(struct ns_timer_wheel_timer *timer, void *arg);
+
+/**
+ * @brief Hardware access used by the wheel
+ *
+ * now() must be a free running, wrapping 32 bit up-counter. set_alarm() must
+ * arrange for ns_timer_wheel_service() to be called once now() reaches tick,
+ * replacing any earlier alarm. If tick has already passed when set_alarm() is
+ * called, the service call must happen right away (e.g. by pending the interrupt).
+ * Alarms are never programmed more than 2^31 ticks ahead.
+ */
+typedef struct ns_timer_wheel_port {
+    uint32_t ticksPerUs;                                       ///< Counter frequency in MHz
+    uint32_t (*init)(void *ctx, struct ns_timer_wheel *wheel); ///< Optional, called by init
+    uint32_t (*now)(void *ctx);                                ///< Current counter value
+    void (*set_alarm)(void *ctx, uint32_t tick);               ///< Service when now() reaches tick
+    uint32_t (*lock)(void *ctx);                               ///< Optional, e.g. mask interrupts
+    void (*unlock)(void *ctx, uint32_t state);                 ///< Optional, undo lock()
+    void *ctx;                                                 ///< Passed to every port function
+} ns_timer_wheel_port_t;
+
+/// Per-timer dispatch statistics, all times in microseconds
+typedef struct {
+    uint32_t fired;        ///< Callbacks made
+    uint32_t missed;       ///< Periods skipped because dispatch fell a full period behind
+    uint32_t latencyMaxUs; ///< Worst callback time - deadline
+    uint64_t latencySumUs; ///< For the average, latencySumUs / fired
+    uint32_t jitterMaxUs;  ///< Worst |interval between callbacks - period|
+} ns_timer_wheel_timer_stats_t;
+
+/// A software timer. Owned by the caller, must stay valid while running.
+typedef struct ns_timer_wheel_timer {
+    ns_timer_wheel_cb callback; ///< Called from ns_timer_wheel_service()
+    void *arg;                  ///< Passed to the callback
+    ns_timer_wheel_timer_stats_t stats;
+
+    // Internal state
+    struct ns_timer_wheel_timer *next;
+    struct ns_timer_wheel_timer **pprev; ///< NULL when not running
+    uint32_t expires;                    ///< Jiffy
+    uint32_t period;                     ///< Jiffies, 0 for one-shot
+    uint32_t lastLatency;                ///< Ticks, for jitter
+    uint8_t level;
+    uint8_t slot;
+} ns_timer_wheel_timer_t;
+
+/// Wheel-wide statistics
+typedef struct {
+    uint32_t services;     ///< Calls to ns_timer_wheel_service()
+    uint32_t alarms;       ///< Compares programmed
+    uint32_t cascades;     ///< Timers moved to a finer level
+    uint32_t fired;        ///< Callbacks made by all timers
+    uint32_t latencyMaxUs; ///< Worst latency of any timer
+} ns_timer_wheel_stats_t;
+
+/// Timer wheel configuration and state
+typedef struct ns_timer_wheel {
+    const ns_core_api_t *api;          ///< API prefix
+    uint32_t resolutionUs;             ///< Length of a jiffy
+    const ns_timer_wheel_port_t *port; ///< Hardware access
+    ns_timer_wheel_stats_t stats;
+
+    // Internal state
+    ns_timer_wheel_timer_t *slots[NS_TIMER_WHEEL_LEVELS][NS_TIMER_WHEEL_SLOTS];
+    uint64_t occupied[NS_TIMER_WHEEL_LEVELS]; ///< Non-empty slots
+    uint32_t cur;                             ///< Next jiffy to process
+    uint32_t baseJiffy;                       ///< Jiffy starting at baseTick
+    uint32_t baseTick;
+    uint32_t ticksPerJiffy;
+    uint32_t alarmJiffy; ///< Jiffy the hardware alarm is programmed for
+    uint32_t count;      ///< Running timers
+    bool armed;          ///< alarmJiffy is valid
+    bool synced;         ///< baseTick tracks the counter (false while idle)
+    bool servicing;
+} ns_timer_wheel_t;
+
+/// Drives NS_TIMER_WHEEL. ns_timer_wheel_init() configures the hardware timer.
+extern const ns_timer_wheel_port_t ns_timer_wheel_hw_port;
+
+/**
+ * @brief Initialize a timer wheel
+ *
+ * @param wheel api, resolutionUs and port must be set
+ * @return uint32_t status
+ */
+extern uint32_t ns_timer_wheel_init(ns_timer_wheel_t *wheel);
+
+/**
+ * @brief Start (or restart) a timer
+ *
+ * The first callback happens delayUs from now, rounded up to the next jiffy. If
+ * periodUs is non-zero the timer then repeats every periodUs, rounded to the
+ * nearest jiffy. May be called from a timer callback.
+ *
+ * @param wheel
+ * @param timer callback (and arg) must be set
+ * @param delayUs time to the first callback
+ * @param periodUs repeat period, 0 for a one-shot timer
+ * @return uint32_t status
+ */
+extern uint32_t ns_timer_wheel_start(
+    ns_timer_wheel_t *wheel, ns_timer_wheel_timer_t *timer, uint32_t delayUs, uint32_t periodUs);
+
+/**
+ * @brief Stop a timer. Stopping a timer that isn't running is harmless.
+ *
+ * @param wheel
+ * @param timer
+ * @return uint32_t status
+ */
+extern uint32_t ns_timer_wheel_stop(ns_timer_wheel_t *wheel, ns_timer_wheel_timer_t *timer);
+
+/**
+ * @brief Whether a timer is running
+ */
+extern bool ns_timer_wheel_active(const ns_timer_wheel_timer_t *timer);
+
+/**
+ * @brief Run the callbacks of every expired timer and program the next alarm
+ *
+ * Called from the hardware timer interrupt by ns_timer_wheel_hw_port. Can also
+ * be called from the main loop, e.g. after waking for another reason.
+ *
+ * @param wheel
+ */
+extern void ns_timer_wheel_service(ns_timer_wheel_t *wheel);
+
+/**
+ * @brief Microseconds until the nearest deadline
+ *
+ * Useful for deciding how deeply to sleep.
+ *
+ * @param wheel
+ * @return uint32_t microseconds, 0 if a timer is due, UINT32_MAX if none running
+ */
+extern uint32_t ns_timer_wheel_next_deadline_us(ns_timer_wheel_t *wheel);
+
+/**
+ * @brief Clear the wheel and per-timer statistics
+ *
+ * @param wheel
+ * @param timer may be NULL to reset only the wheel statistics
+ */
+extern void ns_timer_wheel_stats_reset(ns_timer_wheel_t *wheel, ns_timer_wheel_timer_t *timer);
+
+    #ifdef __cplusplus
+}
+    #endif
+#endif // NS_TIMER_WHEEL_H
+/** @}*/
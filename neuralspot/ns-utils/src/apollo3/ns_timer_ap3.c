@@ -52,6 +52,10 @@ static am_hal_ctimer_config_t g_sTimer = {
     0,
 };
 
+// Wheel timer: both halves linked into a free running 32 bit counter, interrupting on compare 0
+static am_hal_ctimer_config_t g_sWheelTimer = {
+    1, (AM_HAL_CTIMER_FN_CONTINUOUS | AM_HAL_CTIMER_INT_ENABLE | AM_HAL_CTIMER_HFRC_12MHZ), 0};
+
 #define AP3_CTIMER_FREQ_IN_MHZ 12
 
 // Timer Interrupt Service Routine (ISR)
@@ -73,8 +77,13 @@ uint32_t ns_timer_platform_init(ns_timer_config_t *cfg) {
     uint32_t ui32IntMask = (1 << cfg->timer * 2);
 
     am_hal_ctimer_clear(cfg->timer, AM_HAL_CTIMER_BOTH);
-    am_hal_ctimer_config(cfg->timer, &g_sTimer);
-    if (cfg->enableInterrupt) {
+    if (cfg->timer == NS_TIMER_WHEEL) {
+        am_hal_ctimer_config(cfg->timer, &g_sWheelTimer);
+        am_hal_ctimer_compare_set(cfg->timer, AM_HAL_CTIMER_BOTH, 0, 0xFFFFFFFF);
+    } else {
+        am_hal_ctimer_config(cfg->timer, &g_sTimer);
+    }
+    if (cfg->enableInterrupt && (cfg->timer != NS_TIMER_WHEEL)) {
         am_hal_ctimer_period_set(cfg->timer, AM_HAL_CTIMER_BOTH, ui32Period, (ui32Period >> 1));
     }
 
@@ -112,6 +121,33 @@ uint32_t ns_us_ticker_read(ns_timer_config_t *cfg) {
     return am_hal_ctimer_read(cfg->timer, AM_HAL_CTIMER_BOTH) / AP3_CTIMER_FREQ_IN_MHZ;
 }
 
+uint32_t ns_timer_ticks_read(ns_timer_config_t *cfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return 0xDEADBEEF;
+    }
+#endif
+    return am_hal_ctimer_read(cfg->timer, AM_HAL_CTIMER_BOTH);
+}
+
+uint32_t ns_timer_compare_set(ns_timer_config_t *cfg, uint32_t tick) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (cfg->timer != NS_TIMER_WHEEL) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    am_hal_ctimer_compare_set(cfg->timer, AM_HAL_CTIMER_BOTH, 0, tick);
+
+    // A compare behind the counter would only match after it wraps
+    if ((int32_t)(am_hal_ctimer_read(cfg->timer, AM_HAL_CTIMER_BOTH) - tick) >= 0) {
+        am_hal_ctimer_int_set(1 << (cfg->timer * 2));
+    }
+    return NS_STATUS_SUCCESS;
+}
+
 uint32_t ns_timer_clear(ns_timer_config_t *cfg) {
 #ifndef NS_DISABLE_API_VALIDATION
     if (cfg == NULL) {
@@ -31,10 +31,10 @@ void am_timer01_isr(void) {
 void am_timer02_isr(void) {
     ns_timers_e timerNum = ns_timer_config[2]->timer;
     //
-    // Clear the timer Interrupt (write to clear).
+    // Clear the timer Interrupt (write to clear). The wheel timer is free
+    // running, so its counter is left alone.
     //
-    am_hal_timer_interrupt_clear(AM_HAL_TIMER_MASK(timerNum, AM_HAL_TIMER_COMPARE1));
-    am_hal_timer_clear(timerNum);
+    am_hal_timer_interrupt_clear(AM_HAL_TIMER_MASK(timerNum, AM_HAL_TIMER_COMPARE0));
 
     ns_timer_config[2]->callback(ns_timer_config[2]);
 }
@@ -79,7 +79,11 @@ uint32_t ns_timer_platform_init(ns_timer_config_t *cfg) {
         TimerConfig.eInputClock = AM_HAL_TIMER_CLOCK_HFRC_DIV16;
     }
 
-    if ((cfg->enableInterrupt)) {
+    if (cfg->timer == NS_TIMER_WHEEL) {
+        // Count freely through wraps, interrupting on compare0 (set by ns_timer_compare_set)
+        TimerConfig.eFunction = AM_HAL_TIMER_FN_CONTINUOUS;
+        TimerConfig.ui32Compare0 = 0xFFFFFFFF;
+    } else if ((cfg->enableInterrupt)) {
         TimerConfig.eFunction = AM_HAL_TIMER_FN_UPCOUNT;
         TimerConfig.ui32Compare1 = cfg->periodInMicroseconds / 6; // 6 ticks per uS
     }
@@ -95,7 +99,12 @@ uint32_t ns_timer_platform_init(ns_timer_config_t *cfg) {
     //
     am_hal_timer_clear(cfg->timer);
 
-    if ((cfg->enableInterrupt)) {
+    if (cfg->timer == NS_TIMER_WHEEL) {
+        am_hal_timer_interrupt_clear(AM_HAL_TIMER_MASK(cfg->timer, AM_HAL_TIMER_COMPARE0));
+        am_hal_timer_interrupt_enable(AM_HAL_TIMER_MASK(cfg->timer, AM_HAL_TIMER_COMPARE0));
+        NVIC_SetPriority(TIMER2_IRQn, AM_IRQ_PRIORITY_DEFAULT);
+        NVIC_EnableIRQ(TIMER2_IRQn);
+    } else if ((cfg->enableInterrupt)) {
         am_hal_timer_interrupt_clear(AM_HAL_TIMER_MASK(cfg->timer, AM_HAL_TIMER_COMPARE1));
         am_hal_timer_interrupt_enable(AM_HAL_TIMER_MASK(cfg->timer, AM_HAL_TIMER_COMPARE1));
         //
@@ -121,6 +130,33 @@ uint32_t ns_us_ticker_read(ns_timer_config_t *cfg) {
     return am_hal_timer_read(cfg->timer) / 6; // 6 ticks per uS
 }
 
+uint32_t ns_timer_ticks_read(ns_timer_config_t *cfg) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return 0xDEADBEEF;
+    }
+#endif
+    return am_hal_timer_read(cfg->timer);
+}
+
+uint32_t ns_timer_compare_set(ns_timer_config_t *cfg, uint32_t tick) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (cfg == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (cfg->timer != NS_TIMER_WHEEL) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+    am_hal_timer_compare0_set(cfg->timer, tick);
+
+    // A compare behind the counter would only match after it wraps
+    if ((int32_t)(am_hal_timer_read(cfg->timer) - tick) >= 0) {
+        NVIC_SetPendingIRQ(TIMER2_IRQn);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
 uint32_t ns_timer_clear(ns_timer_config_t *cfg) {
 #ifndef NS_DISABLE_API_VALIDATION
     if (cfg == NULL) {
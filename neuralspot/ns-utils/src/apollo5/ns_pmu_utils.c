@@ -12,6 +12,7 @@
 #include "ns_core.h"
 #include "ns_pmu_map.h"
 #include "ns_pmu_utils.h"
+#include "ns_pmu_mux.h"
 #include <string.h>
 
 const ns_core_api_t ns_pmu_V0_0_1 = {.apiId = NS_PMU_API_ID, .version = NS_PMU_V0_0_1};
@@ -440,3 +441,37 @@ void ns_pmu_characterize_function(invoke_fp func, ns_pmu_config_t *cfg) {
     }
 }
 
+// *** ns_pmu_mux port - each group is programmed as up to 4 chained 32b counters
+
+static ns_pmu_config_t ns_pmu_mux_hw_cfg = {.api = &ns_pmu_V1_0_0};
+static uint32_t ns_pmu_mux_hw_count;
+
+static void ns_pmu_mux_hw_program(void *ctx, const uint32_t *eventIds, uint32_t count) {
+    ns_pmu_reset_config(&ns_pmu_mux_hw_cfg);
+    for (uint32_t i = 0; i < count; i++) {
+        ns_pmu_event_create(&(ns_pmu_mux_hw_cfg.events[i]), eventIds[i], NS_PMU_EVENT_COUNTER_SIZE_32);
+    }
+    ns_pmu_mux_hw_count = count;
+    ns_pmu_init(&ns_pmu_mux_hw_cfg);
+    ns_pmu_reset_counters();
+}
+
+static void ns_pmu_mux_hw_read(void *ctx, uint32_t *counts, uint32_t *cycles) {
+    *cycles = ARM_PMU_Get_CCNTR();
+    ns_pmu_get_counters(&ns_pmu_mux_hw_cfg); // also restarts the counters from zero
+    for (uint32_t i = 0; i < ns_pmu_mux_hw_count; i++) {
+        counts[i] = ns_pmu_mux_hw_cfg.counter[i].counterValue;
+    }
+}
+
+static uint32_t ns_pmu_mux_hw_lock(void *ctx) { return am_hal_interrupt_master_disable(); }
+
+static void ns_pmu_mux_hw_unlock(void *ctx, uint32_t state) { am_hal_interrupt_master_set(state); }
+
+const ns_pmu_mux_port_t ns_pmu_mux_hw_port = {
+    .program = ns_pmu_mux_hw_program,
+    .read = ns_pmu_mux_hw_read,
+    .lock = ns_pmu_mux_hw_lock,
+    .unlock = ns_pmu_mux_hw_unlock,
+    .ctx = NULL,
+};
@@ -0,0 +1,261 @@
+/**
+ * @file ns_fast_log.c
+ * @author Ambiq
+ * @brief Table-driven vector logarithm kernels
+ * @version 0.1
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_fast_log.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+    #define NS_FAST_LOG_MVEI
+    #if (__ARM_FEATURE_MVE & 2)
+        #define NS_FAST_LOG_MVEF
+    #endif
+#endif
+
+// ln(2) split so that e * NS_LN2_HI_F32 is exact for any float exponent
+#define NS_LN2_HI_F32 (0.693145752f)
+#define NS_LN2_LO_F32 (1.42860677e-06f)
+#define NS_INV_LN10_F32 (0.434294482f)
+
+// ln(1+u), u in [0,1) in 128 segments: value, slope (both Q15)
+const int16_t ns_log_mantissa_q15[256] = {
+    0x0000, 0x7fff, 0x00ff, 0x7f01, 0x01fc, 0x7e07, 0x02f7, 0x7d11, 0x03f0, 0x7c1f, 0x04e7, 0x7b30,
+    0x05dd, 0x7a44, 0x06d0, 0x795c, 0x07c2, 0x7878, 0x08b2, 0x7797, 0x09a0, 0x76b9, 0x0a8d, 0x75de,
+    0x0b78, 0x7507, 0x0c61, 0x7432, 0x0d49, 0x7361, 0x0e2f, 0x7292, 0x0f13, 0x71c7, 0x0ff6, 0x70fe,
+    0x10d7, 0x7038, 0x11b7, 0x6f74, 0x1295, 0x6eb3, 0x1371, 0x6df5, 0x144d, 0x6d3a, 0x1526, 0x6c80,
+    0x15ff, 0x6bca, 0x16d6, 0x6b15, 0x17ab, 0x6a63, 0x187f, 0x69b4, 0x1952, 0x6906, 0x1a23, 0x685b,
+    0x1af3, 0x67b2, 0x1bc2, 0x670b, 0x1c8f, 0x6666, 0x1d5c, 0x65c3, 0x1e27, 0x6522, 0x1ef0, 0x6483,
+    0x1fb9, 0x63e7, 0x2080, 0x634c, 0x2146, 0x62b2, 0x220b, 0x621b, 0x22ce, 0x6186, 0x2391, 0x60f2,
+    0x2452, 0x6060, 0x2512, 0x5fd0, 0x25d1, 0x5f41, 0x268f, 0x5eb4, 0x274c, 0x5e29, 0x2808, 0x5d9f,
+    0x28c3, 0x5d17, 0x297c, 0x5c90, 0x2a35, 0x5c0b, 0x2aec, 0x5b87, 0x2ba3, 0x5b05, 0x2c59, 0x5a84,
+    0x2d0d, 0x5a05, 0x2dc1, 0x5987, 0x2e73, 0x590b, 0x2f25, 0x588f, 0x2fd5, 0x5816, 0x3085, 0x579d,
+    0x3134, 0x5726, 0x31e2, 0x56b0, 0x328f, 0x563b, 0x333b, 0x55c7, 0x33e6, 0x5555, 0x3490, 0x54e4,
+    0x3539, 0x5474, 0x35e2, 0x5405, 0x3689, 0x5397, 0x3730, 0x532a, 0x37d6, 0x52bf, 0x387b, 0x5254,
+    0x391f, 0x51eb, 0x39c3, 0x5183, 0x3a65, 0x511b, 0x3b07, 0x50b5, 0x3ba8, 0x5050, 0x3c49, 0x4fec,
+    0x3ce8, 0x4f88, 0x3d87, 0x4f26, 0x3e25, 0x4ec4, 0x3ec2, 0x4e64, 0x3f5e, 0x4e04, 0x3ffa, 0x4da6,
+    0x4095, 0x4d48, 0x412f, 0x4ceb, 0x41c8, 0x4c8f, 0x4261, 0x4c34, 0x42f9, 0x4bda, 0x4391, 0x4b80,
+    0x4427, 0x4b27, 0x44bd, 0x4ad0, 0x4553, 0x4a79, 0x45e7, 0x4a22, 0x467b, 0x49cd, 0x470e, 0x4978,
+    0x47a1, 0x4924, 0x4833, 0x48d1, 0x48c4, 0x487e, 0x4955, 0x482d, 0x49e5, 0x47dc, 0x4a74, 0x478b,
+    0x4b03, 0x473c, 0x4b91, 0x46ed, 0x4c1f, 0x469e, 0x4cac, 0x4651, 0x4d38, 0x4604, 0x4dc4, 0x45b8,
+    0x4e4f, 0x456c, 0x4eda, 0x4521, 0x4f64, 0x44d7, 0x4fed, 0x448d, 0x5076, 0x4444, 0x50fe, 0x43fb,
+    0x5186, 0x43b3, 0x520d, 0x436c, 0x5293, 0x4325, 0x5319, 0x42df, 0x539f, 0x429a, 0x5424, 0x4254,
+    0x54a8, 0x4210, 0x552c, 0x41cc, 0x55af, 0x4189, 0x5632, 0x4146, 0x56b5, 0x4104, 0x5736, 0x40c2,
+    0x57b8, 0x4081, 0x5838, 0x4040,
+};
+
+// ln(1+k/256), k = 0..256
+static const float ns_log_mantissa_f32[257] = {
+    0.000000000e+00f, 3.898640416e-03f, 7.782140442e-03f, 1.165061722e-02f,
+    1.550418654e-02f, 1.934296284e-02f, 2.316705928e-02f, 2.697658770e-02f,
+    3.077165867e-02f, 3.455238151e-02f, 3.831886430e-02f, 4.207121392e-02f,
+    4.580953603e-02f, 4.953393512e-02f, 5.324451452e-02f, 5.694137640e-02f,
+    6.062462182e-02f, 6.429435071e-02f, 6.795066191e-02f, 7.159365319e-02f,
+    7.522342124e-02f, 7.884006171e-02f, 8.244366921e-02f, 8.603433734e-02f,
+    8.961215869e-02f, 9.317722485e-02f, 9.672962646e-02f, 1.002694532e-01f,
+    1.037967937e-01f, 1.073117358e-01f, 1.108143663e-01f, 1.143047713e-01f,
+    1.177830357e-01f, 1.212492436e-01f, 1.247034785e-01f, 1.281458227e-01f,
+    1.315763578e-01f, 1.349951645e-01f, 1.384023229e-01f, 1.417979119e-01f,
+    1.451820098e-01f, 1.485546943e-01f, 1.519160420e-01f, 1.552661289e-01f,
+    1.586050302e-01f, 1.619328203e-01f, 1.652495729e-01f, 1.685553610e-01f,
+    1.718502569e-01f, 1.751343321e-01f, 1.784076575e-01f, 1.816703031e-01f,
+    1.849223385e-01f, 1.881638324e-01f, 1.913948530e-01f, 1.946154677e-01f,
+    1.978257433e-01f, 2.010257461e-01f, 2.042155414e-01f, 2.073951943e-01f,
+    2.105647691e-01f, 2.137243294e-01f, 2.168739383e-01f, 2.200136583e-01f,
+    2.231435513e-01f, 2.262636787e-01f, 2.293741011e-01f, 2.324748787e-01f,
+    2.355660713e-01f, 2.386477379e-01f, 2.417199369e-01f, 2.447827264e-01f,
+    2.478361639e-01f, 2.508803063e-01f, 2.539152100e-01f, 2.569409309e-01f,
+    2.599575244e-01f, 2.629650455e-01f, 2.659635485e-01f, 2.689530873e-01f,
+    2.719337155e-01f, 2.749054859e-01f, 2.778684510e-01f, 2.808226629e-01f,
+    2.837681731e-01f, 2.867050328e-01f, 2.896332926e-01f, 2.925530027e-01f,
+    2.954642129e-01f, 2.983669726e-01f, 3.012613306e-01f, 3.041473355e-01f,
+    3.070250353e-01f, 3.098944777e-01f, 3.127557100e-01f, 3.156087790e-01f,
+    3.184537311e-01f, 3.212906125e-01f, 3.241194687e-01f, 3.269403450e-01f,
+    3.297532864e-01f, 3.325583373e-01f, 3.353555419e-01f, 3.381449440e-01f,
+    3.409265870e-01f, 3.437005139e-01f, 3.464667673e-01f, 3.492253898e-01f,
+    3.519764232e-01f, 3.547199091e-01f, 3.574558889e-01f, 3.601844036e-01f,
+    3.629054937e-01f, 3.656191996e-01f, 3.683255612e-01f, 3.710246181e-01f,
+    3.737164098e-01f, 3.764009752e-01f, 3.790783529e-01f, 3.817485815e-01f,
+    3.844116989e-01f, 3.870677430e-01f, 3.897167511e-01f, 3.923587606e-01f,
+    3.949938082e-01f, 3.976219306e-01f, 4.002431641e-01f, 4.028575447e-01f,
+    4.054651081e-01f, 4.080658898e-01f, 4.106599250e-01f, 4.132472486e-01f,
+    4.158278951e-01f, 4.184018991e-01f, 4.209692946e-01f, 4.235301155e-01f,
+    4.260843953e-01f, 4.286321674e-01f, 4.311734648e-01f, 4.337083204e-01f,
+    4.362367668e-01f, 4.387588362e-01f, 4.412745608e-01f, 4.437839724e-01f,
+    4.462871026e-01f, 4.487839828e-01f, 4.512746441e-01f, 4.537591175e-01f,
+    4.562374335e-01f, 4.587096226e-01f, 4.611757151e-01f, 4.636357410e-01f,
+    4.660897299e-01f, 4.685377116e-01f, 4.709797152e-01f, 4.734157700e-01f,
+    4.758459049e-01f, 4.782701485e-01f, 4.806885293e-01f, 4.831010758e-01f,
+    4.855078158e-01f, 4.879087773e-01f, 4.903039880e-01f, 4.926934754e-01f,
+    4.950772668e-01f, 4.974553892e-01f, 4.998278696e-01f, 5.021947346e-01f,
+    5.045560108e-01f, 5.069117244e-01f, 5.092619018e-01f, 5.116065687e-01f,
+    5.139457511e-01f, 5.162794744e-01f, 5.186077642e-01f, 5.209306456e-01f,
+    5.232481438e-01f, 5.255602835e-01f, 5.278670896e-01f, 5.301685866e-01f,
+    5.324647989e-01f, 5.347557506e-01f, 5.370414659e-01f, 5.393219686e-01f,
+    5.415972824e-01f, 5.438674310e-01f, 5.461324376e-01f, 5.483923256e-01f,
+    5.506471180e-01f, 5.528968377e-01f, 5.551415075e-01f, 5.573811501e-01f,
+    5.596157879e-01f, 5.618454433e-01f, 5.640701383e-01f, 5.662898950e-01f,
+    5.685047354e-01f, 5.707146810e-01f, 5.729197536e-01f, 5.751199745e-01f,
+    5.773153650e-01f, 5.795059464e-01f, 5.816917396e-01f, 5.838727656e-01f,
+    5.860490450e-01f, 5.882205985e-01f, 5.903874466e-01f, 5.925496096e-01f,
+    5.947071077e-01f, 5.968599611e-01f, 5.990081896e-01f, 6.011518132e-01f,
+    6.032908514e-01f, 6.054253240e-01f, 6.075552502e-01f, 6.096806495e-01f,
+    6.118015411e-01f, 6.139179440e-01f, 6.160298772e-01f, 6.181373596e-01f,
+    6.202404098e-01f, 6.223390464e-01f, 6.244332880e-01f, 6.265231529e-01f,
+    6.286086594e-01f, 6.306898256e-01f, 6.327666696e-01f, 6.348392092e-01f,
+    6.369074622e-01f, 6.389714465e-01f, 6.410311794e-01f, 6.430866786e-01f,
+    6.451379614e-01f, 6.471850450e-01f, 6.492279466e-01f, 6.512666833e-01f,
+    6.533012720e-01f, 6.553317296e-01f, 6.573580727e-01f, 6.593803181e-01f,
+    6.613984822e-01f, 6.634125816e-01f, 6.654226325e-01f, 6.674286513e-01f,
+    6.694306539e-01f, 6.714286566e-01f, 6.734226752e-01f, 6.754127256e-01f,
+    6.773988236e-01f, 6.793809848e-01f, 6.813592248e-01f, 6.833335591e-01f,
+    6.853040031e-01f, 6.872705721e-01f, 6.892332812e-01f, 6.911921457e-01f,
+    6.931471806e-01f,
+};
+
+// ln(x * 2^-(31 - clz(x))) in Q15, and the position of the leading one
+static inline int32_t ns_ln_mantissa_q15(int32_t x, int32_t *pt_msb) {
+    int32_t msb, y, u, kx;
+
+    if (x <= 0)
+        x = 1;
+
+    msb = 31 - __builtin_clz((uint32_t)x);
+    y = (msb <= 15) ? (x << (15 - msb)) : (x >> (msb - 15)); // [1,2) in Q15
+    u = y - (1 << 15);
+    kx = u >> 8;
+    *pt_msb = msb;
+    return (int32_t)ns_log_mantissa_q15[kx << 1] +
+           (((int32_t)ns_log_mantissa_q15[(kx << 1) + 1] * (u & 0xff)) >> 15);
+}
+
+static inline float ns_logf_scalar(float x) {
+    union {
+        float f;
+        int32_t i;
+    } v = {.f = x};
+    int32_t k;
+    float e, t0, frac;
+
+    // zero, negative and denormal inputs clamp to FLT_MIN
+    if (v.i < 0x00800000)
+        v.i = 0x00800000;
+
+    k = (v.i >> 15) & 0xff;
+    frac = (float)(v.i & 0x7fff) * (1.0f / 32768.0f);
+    e = (float)((v.i >> 23) - 127);
+    t0 = ns_log_mantissa_f32[k];
+    return e * NS_LN2_HI_F32 + (e * NS_LN2_LO_F32 + (t0 + (ns_log_mantissa_f32[k + 1] - t0) * frac));
+}
+
+#ifdef NS_FAST_LOG_MVEI
+static inline int32x4_t ns_ln_mantissa_q15_mve(int32x4_t vx, int32x4_t *pt_msb) {
+    int32x4_t msb, y, u, kx2, c0, c1;
+
+    vx = vmaxq_s32(vx, vdupq_n_s32(1));
+    msb = vsubq_s32(vdupq_n_s32(31), vclzq_s32(vx));
+    y = vshlq_s32(vx, vsubq_s32(vdupq_n_s32(15), msb)); // negative shift is a right shift
+    u = vsubq_n_s32(y, 1 << 15);
+    kx2 = vshlq_n_s32(vshrq_n_s32(u, 8), 1);
+    c0 = vldrhq_gather_shifted_offset_s32(ns_log_mantissa_q15, vreinterpretq_u32_s32(kx2));
+    c1 = vldrhq_gather_shifted_offset_s32(
+        ns_log_mantissa_q15, vreinterpretq_u32_s32(vaddq_n_s32(kx2, 1)));
+    *pt_msb = msb;
+    return vaddq_s32(c0, vshrq_n_s32(vmulq_s32(c1, vandq_s32(u, vdupq_n_s32(0xff))), 15));
+}
+#endif
+
+void ns_log10_q31_vec(int32_t *out, const int32_t *x, uint32_t len, int16_t bit_frac_in) {
+    uint32_t i = 0;
+    int32_t msb, ln;
+#ifdef NS_FAST_LOG_MVEI
+    int32x4_t vmsb, vln;
+    for (; i + 4 <= len; i += 4) {
+        vln = ns_ln_mantissa_q15_mve(vld1q_s32(x + i), &vmsb);
+        vln = vshrq_n_s32(vmulq_n_s32(vln, NS_INV_LN10_Q15), 15);
+        vst1q_s32(
+            out + i,
+            vmlaq_n_s32(vln, vsubq_n_s32(vmsb, bit_frac_in), NS_LOG2_DIV_LOG10_Q15));
+    }
+#endif
+    for (; i < len; i++) {
+        ln = ns_ln_mantissa_q15(x[i], &msb);
+        out[i] = ((ln * NS_INV_LN10_Q15) >> 15) + NS_LOG2_DIV_LOG10_Q15 * (msb - bit_frac_in);
+    }
+}
+
+void ns_log2_q31_vec(int32_t *out, const int32_t *x, uint32_t len, int16_t bit_frac_in) {
+    uint32_t i = 0;
+    int32_t msb, ln;
+#ifdef NS_FAST_LOG_MVEI
+    int32x4_t vmsb, vln;
+    for (; i + 4 <= len; i += 4) {
+        vln = ns_ln_mantissa_q15_mve(vld1q_s32(x + i), &vmsb);
+        vln = vshrq_n_s32(vmulq_n_s32(vln, NS_INV_LN2_Q15), 15);
+        vst1q_s32(out + i, vaddq_s32(vln, vshlq_n_s32(vsubq_n_s32(vmsb, bit_frac_in), 15)));
+    }
+#endif
+    for (; i < len; i++) {
+        ln = ns_ln_mantissa_q15(x[i], &msb);
+        out[i] = ((ln * NS_INV_LN2_Q15) >> 15) + (msb - bit_frac_in) * (1 << 15);
+    }
+}
+
+void ns_log10_q15_vec(int32_t *out, const int16_t *x, uint32_t len, int16_t bit_frac_in) {
+    uint32_t i = 0;
+    int32_t msb, ln;
+#ifdef NS_FAST_LOG_MVEI
+    int32x4_t vmsb, vln;
+    for (; i + 4 <= len; i += 4) {
+        vln = ns_ln_mantissa_q15_mve(vldrhq_s32(x + i), &vmsb);
+        vln = vshrq_n_s32(vmulq_n_s32(vln, NS_INV_LN10_Q15), 15);
+        vst1q_s32(
+            out + i,
+            vmlaq_n_s32(vln, vsubq_n_s32(vmsb, bit_frac_in), NS_LOG2_DIV_LOG10_Q15));
+    }
+#endif
+    for (; i < len; i++) {
+        ln = ns_ln_mantissa_q15((int32_t)x[i], &msb);
+        out[i] = ((ln * NS_INV_LN10_Q15) >> 15) + NS_LOG2_DIV_LOG10_Q15 * (msb - bit_frac_in);
+    }
+}
+
+void ns_logf_vec(float *out, const float *x, uint32_t len) {
+    uint32_t i = 0;
+#ifdef NS_FAST_LOG_MVEF
+    int32x4_t ib;
+    uint32x4_t k;
+    float32x4_t e, frac, t0, t1, r;
+    for (; i + 4 <= len; i += 4) {
+        ib = vreinterpretq_s32_f32(vld1q_f32(x + i));
+        ib = vmaxq_s32(ib, vdupq_n_s32(0x00800000));
+        k = vreinterpretq_u32_s32(vandq_s32(vshrq_n_s32(ib, 15), vdupq_n_s32(0xff)));
+        frac = vmulq_n_f32(
+            vcvtq_f32_s32(vandq_s32(ib, vdupq_n_s32(0x7fff))), 1.0f / 32768.0f);
+        t0 = vldrwq_gather_shifted_offset_f32(ns_log_mantissa_f32, k);
+        t1 = vldrwq_gather_shifted_offset_f32(ns_log_mantissa_f32, vaddq_n_u32(k, 1));
+        e = vcvtq_f32_s32(vsubq_n_s32(vshrq_n_s32(ib, 23), 127));
+        r = vfmaq_f32(t0, vsubq_f32(t1, t0), frac);
+        r = vfmaq_n_f32(r, e, NS_LN2_LO_F32);
+        r = vfmaq_n_f32(r, e, NS_LN2_HI_F32);
+        vst1q_f32(out + i, r);
+    }
+#endif
+    for (; i < len; i++) {
+        out[i] = ns_logf_scalar(x[i]);
+    }
+}
+
+void ns_log10f_vec(float *out, const float *x, uint32_t len) {
+    uint32_t i;
+    ns_logf_vec(out, x, len);
+    for (i = 0; i < len; i++) {
+        out[i] *= NS_INV_LN10_F32;
+    }
+}
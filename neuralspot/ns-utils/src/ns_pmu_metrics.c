@@ -0,0 +1,134 @@
+/**
+ * @file ns_pmu_metrics.c
+ * @author Ambiq
+ * @brief Derived performance metrics from raw PMU event counts
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_pmu_metrics.h"
+#include <math.h>
+#include <stddef.h>
+
+// Event IDs (Armv8.1-M PMU architecture), spelled out so this file doesn't depend on CMSIS
+#define NS_PMU_EVT_L1D_CACHE_REFILL 0x0003
+#define NS_PMU_EVT_L1D_CACHE 0x0004
+#define NS_PMU_EVT_INST_RETIRED 0x0008
+#define NS_PMU_EVT_CPU_CYCLES 0x0011
+#define NS_PMU_EVT_STALL 0x003C
+#define NS_PMU_EVT_MVE_INST_RETIRED 0x0200
+#define NS_PMU_EVT_MVE_INT_MAC_RETIRED 0x0228
+#define NS_PMU_EVT_MVE_STALL_RESOURCE_MEM 0x02CE
+
+#define NS_PMU_MVE_BEATS_PER_INST 4
+
+const ns_pmu_machine_t ns_pmu_machine_apollo5 = {
+    .peakIpc = 1.0f,
+    .memBytesPerCycle = 8.0f,
+    .lineBytes = 32,
+    .beatsPerCycle = 2,
+};
+
+// The ratios' inputs share the first group, so they are counted over the same interval
+const uint32_t ns_pmu_metrics_events[NS_PMU_METRICS_NUM_EVENTS] = {
+    // Group 0
+    NS_PMU_EVT_CPU_CYCLES,
+    NS_PMU_EVT_INST_RETIRED,
+    NS_PMU_EVT_MVE_INST_RETIRED,
+    NS_PMU_EVT_L1D_CACHE_REFILL,
+    // Group 1
+    NS_PMU_EVT_MVE_STALL_RESOURCE_MEM,
+    NS_PMU_EVT_L1D_CACHE,
+    NS_PMU_EVT_STALL,
+    NS_PMU_EVT_MVE_INT_MAC_RETIRED,
+};
+const uint32_t ns_pmu_metrics_num_events = NS_PMU_METRICS_NUM_EVENTS;
+
+static bool ns_pmu_metrics_find(
+    const ns_pmu_sample_t *samples, uint32_t numSamples, uint32_t eventId, float *value) {
+    for (uint32_t i = 0; i < numSamples; i++) {
+        if (samples[i].eventId == eventId) {
+            *value = (float)samples[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ns_pmu_metrics_compute(
+    const ns_pmu_sample_t *samples, uint32_t numSamples, const ns_pmu_machine_t *machine,
+    ns_pmu_metrics_t *metrics) {
+    float cycles, inst, mveInst, memStall, refills;
+    bool haveCycles, haveInst;
+
+    if (machine == NULL) {
+        machine = &ns_pmu_machine_apollo5;
+    }
+    metrics->valid = 0;
+    metrics->ipc = 0.0f;
+    metrics->mveBeatUtil = 0.0f;
+    metrics->ldstStallRatio = 0.0f;
+    metrics->mpki = 0.0f;
+    metrics->intensity = 0.0f;
+    metrics->attainableIpc = 0.0f;
+    metrics->bound = NS_PMU_BOUND_UNKNOWN;
+
+    haveCycles = ns_pmu_metrics_find(samples, numSamples, NS_PMU_EVT_CPU_CYCLES, &cycles) &&
+                 (cycles > 0.0f);
+    haveInst = ns_pmu_metrics_find(samples, numSamples, NS_PMU_EVT_INST_RETIRED, &inst) &&
+               (inst > 0.0f);
+
+    if (haveCycles && haveInst) {
+        metrics->ipc = inst / cycles;
+        metrics->valid |= NS_PMU_METRIC_IPC;
+    }
+
+    if (haveCycles &&
+        ns_pmu_metrics_find(samples, numSamples, NS_PMU_EVT_MVE_INST_RETIRED, &mveInst)) {
+        metrics->mveBeatUtil =
+            MIN(1.0f, mveInst * NS_PMU_MVE_BEATS_PER_INST / (cycles * machine->beatsPerCycle));
+        metrics->valid |= NS_PMU_METRIC_MVE_BEATS;
+    }
+
+    if (haveCycles &&
+        ns_pmu_metrics_find(samples, numSamples, NS_PMU_EVT_MVE_STALL_RESOURCE_MEM, &memStall)) {
+        metrics->ldstStallRatio = MIN(1.0f, memStall / cycles);
+        metrics->valid |= NS_PMU_METRIC_LDST_STALL;
+    }
+
+    if (haveInst &&
+        ns_pmu_metrics_find(samples, numSamples, NS_PMU_EVT_L1D_CACHE_REFILL, &refills)) {
+        metrics->mpki = refills * 1000.0f / inst;
+        metrics->valid |= NS_PMU_METRIC_MPKI;
+
+        // Cache-miss roofline: instructions per byte brought in from memory vs. the ridge
+        // point where memory bandwidth and peak IPC meet
+        float ridge = machine->peakIpc / machine->memBytesPerCycle;
+        if (refills > 0.0f) {
+            metrics->intensity = inst / (refills * machine->lineBytes);
+            metrics->attainableIpc =
+                MIN(machine->peakIpc, metrics->intensity * machine->memBytesPerCycle);
+            metrics->bound =
+                (metrics->intensity < ridge) ? NS_PMU_BOUND_MEMORY : NS_PMU_BOUND_COMPUTE;
+        } else {
+            metrics->intensity = INFINITY;
+            metrics->attainableIpc = machine->peakIpc;
+            metrics->bound = NS_PMU_BOUND_COMPUTE;
+        }
+        metrics->valid |= NS_PMU_METRIC_BOUND;
+    }
+}
+
+const char *ns_pmu_bound_name(ns_pmu_bound_e bound) {
+    switch (bound) {
+    case NS_PMU_BOUND_COMPUTE:
+        return "compute";
+    case NS_PMU_BOUND_MEMORY:
+        return "memory";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,232 @@
+/**
+ * @file ns_pmu_mux.c
+ * @author Ambiq
+ * @brief Time-multiplexed PMU sampling - capture more events than there are counters in one run
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_pmu_mux.h"
+#include <string.h>
+
+const ns_core_api_t ns_pmu_mux_V0_0_1 = {.apiId = NS_PMU_MUX_API_ID, .version = NS_PMU_MUX_V0_0_1};
+const ns_core_api_t ns_pmu_mux_oldest_supported_version = {
+    .apiId = NS_PMU_MUX_API_ID, .version = NS_PMU_MUX_V0_0_1};
+const ns_core_api_t ns_pmu_mux_current_version = {
+    .apiId = NS_PMU_MUX_API_ID, .version = NS_PMU_MUX_V0_0_1};
+
+static uint32_t ns_pmu_mux_lock(ns_pmu_mux_t *m) {
+    return m->port->lock ? m->port->lock(m->port->ctx) : 0;
+}
+
+static void ns_pmu_mux_unlock(ns_pmu_mux_t *m, uint32_t state) {
+    if (m->port->unlock) {
+        m->port->unlock(m->port->ctx, state);
+    }
+}
+
+static uint32_t ns_pmu_mux_group_events(const ns_pmu_mux_t *m, uint32_t group) {
+    return MIN(NS_PMU_MUX_GROUP_SIZE, m->numEvents - group * NS_PMU_MUX_GROUP_SIZE);
+}
+
+static void ns_pmu_mux_program(ns_pmu_mux_t *m) {
+    m->port->program(
+        m->port->ctx, &m->eventIds[m->group * NS_PMU_MUX_GROUP_SIZE],
+        ns_pmu_mux_group_events(m, m->group));
+}
+
+// Read the active group and charge its counts to the current layer, if any
+static void ns_pmu_mux_flush(ns_pmu_mux_t *m) {
+    uint32_t counts[NS_PMU_MUX_GROUP_SIZE];
+    uint32_t cycles;
+
+    m->port->read(m->port->ctx, counts, &cycles);
+    if (!m->inLayer) {
+        return;
+    }
+
+    uint32_t *c = &m->counts[m->layer * m->numEvents + m->group * NS_PMU_MUX_GROUP_SIZE];
+    for (uint32_t i = 0; i < ns_pmu_mux_group_events(m, m->group); i++) {
+        c[i] += counts[i];
+    }
+    m->groupCycles[m->layer * m->numGroups + m->group] += cycles;
+}
+
+static void ns_pmu_mux_next_group(ns_pmu_mux_t *m) {
+    m->group = (m->group + 1) % m->numGroups;
+    ns_pmu_mux_program(m);
+    m->rotations++;
+}
+
+uint32_t ns_pmu_mux_init(ns_pmu_mux_t *m) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (m == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(m->api, &ns_pmu_mux_oldest_supported_version,
+                          &ns_pmu_mux_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((m->port == NULL) || (m->port->program == NULL) || (m->port->read == NULL) ||
+        (m->eventIds == NULL) || (m->numEvents == 0) || (m->maxLayers == 0) ||
+        (m->counts == NULL) || (m->groupCycles == NULL)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    m->numGroups = NS_PMU_MUX_GROUPS(m->numEvents);
+    m->running = false;
+    ns_pmu_mux_reset(m);
+    return NS_STATUS_SUCCESS;
+}
+
+void ns_pmu_mux_reset(ns_pmu_mux_t *m) {
+    uint32_t state = ns_pmu_mux_lock(m);
+    memset(m->counts, 0, sizeof(uint32_t) * m->maxLayers * m->numEvents);
+    memset(m->groupCycles, 0, sizeof(uint32_t) * m->maxLayers * m->numGroups);
+    m->group = 0;
+    m->startGroup = 0;
+    m->layer = 0;
+    m->numLayers = 0;
+    m->runs = 0;
+    m->rotations = 0;
+    m->inLayer = false;
+    ns_pmu_mux_unlock(m, state);
+}
+
+void ns_pmu_mux_start(ns_pmu_mux_t *m) {
+    uint32_t state = ns_pmu_mux_lock(m);
+    m->group = m->startGroup;
+    m->numLayers = 0;
+    m->inLayer = false;
+    m->runs++;
+    m->running = true;
+    ns_pmu_mux_program(m);
+    ns_pmu_mux_unlock(m, state);
+}
+
+void ns_pmu_mux_restart(ns_pmu_mux_t *m) {
+    // Start each run on a different group, so layers that are shorter than a time slice
+    // still see every group after numGroups runs
+    m->startGroup = (m->startGroup + 1) % m->numGroups;
+    ns_pmu_mux_start(m);
+}
+
+void ns_pmu_mux_stop(ns_pmu_mux_t *m) {
+    uint32_t state = ns_pmu_mux_lock(m);
+    if (m->running) {
+        ns_pmu_mux_flush(m);
+    }
+    m->inLayer = false;
+    m->running = false;
+    ns_pmu_mux_unlock(m, state);
+}
+
+uint32_t ns_pmu_mux_layer_begin(ns_pmu_mux_t *m) {
+    uint32_t layer = m->maxLayers;
+    uint32_t state = ns_pmu_mux_lock(m);
+    if (m->running) {
+        m->inLayer = false;
+        ns_pmu_mux_flush(m); // discard counts between layers
+        if (m->numLayers < m->maxLayers) {
+            layer = m->numLayers;
+            m->layer = layer;
+            m->inLayer = true;
+        }
+        m->numLayers++;
+    }
+    ns_pmu_mux_unlock(m, state);
+    return layer;
+}
+
+void ns_pmu_mux_layer_end(ns_pmu_mux_t *m) {
+    uint32_t state = ns_pmu_mux_lock(m);
+    if (m->running) {
+        ns_pmu_mux_flush(m);
+        m->inLayer = false;
+        if (m->numGroups > 1) {
+            ns_pmu_mux_next_group(m);
+        }
+    }
+    ns_pmu_mux_unlock(m, state);
+}
+
+void ns_pmu_mux_rotate(ns_pmu_mux_t *m) {
+    uint32_t state = ns_pmu_mux_lock(m);
+    if (m->running && m->numGroups > 1) {
+        ns_pmu_mux_flush(m);
+        ns_pmu_mux_next_group(m);
+    }
+    ns_pmu_mux_unlock(m, state);
+}
+
+uint32_t ns_pmu_mux_layer_cycles(const ns_pmu_mux_t *m, uint32_t layer) {
+    uint64_t cycles = 0;
+    if (layer >= m->maxLayers || m->runs == 0) {
+        return 0;
+    }
+    for (uint32_t g = 0; g < m->numGroups; g++) {
+        cycles += m->groupCycles[layer * m->numGroups + g];
+    }
+    return (uint32_t)(cycles / m->runs);
+}
+
+uint32_t
+ns_pmu_mux_estimate(const ns_pmu_mux_t *m, uint32_t layer, uint32_t eventIndex, uint32_t *value) {
+    if (layer >= m->maxLayers || eventIndex >= m->numEvents) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+    uint32_t active = m->groupCycles[layer * m->numGroups + eventIndex / NS_PMU_MUX_GROUP_SIZE];
+    if (active == 0) {
+        *value = 0;
+        return NS_STATUS_FAILURE;
+    }
+
+    // Scale to the whole layer, then to a single run
+    uint64_t total = 0;
+    for (uint32_t g = 0; g < m->numGroups; g++) {
+        total += m->groupCycles[layer * m->numGroups + g];
+    }
+    uint64_t scaled = (uint64_t)m->counts[layer * m->numEvents + eventIndex] * total / active;
+    scaled /= m->runs;
+    *value = (uint32_t)MIN(scaled, UINT32_MAX);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_pmu_mux_layer_samples(const ns_pmu_mux_t *m, uint32_t layer, ns_pmu_sample_t *out) {
+    uint32_t n = 0;
+    for (uint32_t e = 0; e < m->numEvents; e++) {
+        if (ns_pmu_mux_estimate(m, layer, e, &out[n].value) == NS_STATUS_SUCCESS) {
+            out[n++].eventId = m->eventIds[e];
+        }
+    }
+    return n;
+}
+
+bool ns_pmu_rerun_source_layer(uint32_t layer, uint32_t rv, int32_t callOnceLayer,
+                               uint32_t *source) {
+    *source = layer;
+    if (callOnceLayer < 0) {
+        return true;
+    }
+    uint32_t skipEnd = (uint32_t)callOnceLayer + rv * 2;
+    if (layer > (uint32_t)callOnceLayer && layer <= skipEnd) {
+        return false;
+    }
+    if (layer > skipEnd) {
+        *source = layer - rv * 2;
+    }
+    return true;
+}
+
+uint32_t ns_pmu_rerun_snapshot_index(
+    uint32_t source, uint32_t numLayers, uint32_t rv, uint32_t mapIndex, uint32_t *slot) {
+    uint32_t runLength = numLayers - rv * 2;
+    *slot = mapIndex % NS_PMU_MUX_GROUP_SIZE;
+    return numLayers + source + runLength * (mapIndex / NS_PMU_MUX_GROUP_SIZE);
+}
@@ -19,11 +19,13 @@ const ns_core_api_t ns_timer_V0_0_1 = {.apiId = NS_TIMER_API_ID, .version = NS_T
 
 const ns_core_api_t ns_timer_V1_0_0 = {.apiId = NS_TIMER_API_ID, .version = NS_TIMER_V1_0_0};
 
+const ns_core_api_t ns_timer_V1_1_0 = {.apiId = NS_TIMER_API_ID, .version = NS_TIMER_V1_1_0};
+
 const ns_core_api_t ns_timer_oldest_supported_version = {
     .apiId = NS_TIMER_API_ID, .version = NS_TIMER_V0_0_1};
 
 const ns_core_api_t ns_timer_current_version = {
-    .apiId = NS_TIMER_API_ID, .version = NS_TIMER_V1_0_0};
+    .apiId = NS_TIMER_API_ID, .version = NS_TIMER_V1_1_0};
 
 ns_timer_config_t *ns_timer_config[NS_TIMER_TEMPCO + 1];
 
@@ -46,6 +48,11 @@ uint32_t ns_timer_init(ns_timer_config_t *cfg) {
     if (cfg->timer > NS_TIMER_TEMPCO) {
         return NS_STATUS_INVALID_CONFIG;
     }
+    // NS_TIMER_WHEEL arrived in v1.1.0
+    if ((cfg->timer == NS_TIMER_WHEEL) &&
+        ns_core_check_api(cfg->api, &ns_timer_V1_1_0, &ns_timer_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
     if ((cfg->enableInterrupt) && (cfg->callback == NULL)) {
         return NS_STATUS_INVALID_CONFIG;
     }
@@ -57,3 +64,10 @@ uint32_t ns_timer_init(ns_timer_config_t *cfg) {
 
     return ui32Status;
 }
+
+ns_timer_config_t *ns_timer_get_config(ns_timers_e timer) {
+    if (timer > NS_TIMER_TEMPCO) {
+        return NULL;
+    }
+    return ns_timer_config[timer];
+}
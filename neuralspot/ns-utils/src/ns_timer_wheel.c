@@ -0,0 +1,433 @@
+/**
+ * @file ns_timer_wheel.c
+ * @author Ambiq
+ * @brief Hierarchical timer wheel multiplexing software timers on one hardware timer
+ * @version 0.1
+ * @date 2025-07-18
+ *
+ * A timer whose expiry is d jiffies after the current jiffy goes to level l where
+ * 64^l <= d < 64^(l+1), in the slot picked by bits [6l, 6l+6) of its expiry.
+ * When the current jiffy crosses a multiple of 64^l, the level l slot it lands
+ * on is emptied and its timers are re-inserted, landing on finer levels. Timers
+ * only ever fire from level 0, on exactly their expiry jiffy.
+ *
+ * This file has no hardware dependencies; see ns_timer_wheel_hw.c for the port.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "ns_timer_wheel.h"
+#include <stddef.h>
+#include <string.h>
+
+const ns_core_api_t ns_timer_wheel_V0_0_1 = {
+    .apiId = NS_TIMER_WHEEL_API_ID, .version = NS_TIMER_WHEEL_V0_0_1};
+
+const ns_core_api_t ns_timer_wheel_oldest_supported_version = {
+    .apiId = NS_TIMER_WHEEL_API_ID, .version = NS_TIMER_WHEEL_V0_0_1};
+
+const ns_core_api_t ns_timer_wheel_current_version = {
+    .apiId = NS_TIMER_WHEEL_API_ID, .version = NS_TIMER_WHEEL_V0_0_1};
+
+#define NS_TW_MASK (NS_TIMER_WHEEL_SLOTS - 1)
+#define NS_TW_SHIFT(level) ((level) * NS_TIMER_WHEEL_SLOT_BITS)
+#define NS_TW_BEFORE(a, b) ((int32_t)((a) - (b)) < 0) // wrap-safe a < b
+#define NS_TW_MAX_ALARM_TICKS 0x7FFFFFFFUL
+
+static inline uint32_t ns_tw_lock(ns_timer_wheel_t *w) {
+    return w->port->lock ? w->port->lock(w->port->ctx) : 0;
+}
+
+static inline void ns_tw_unlock(ns_timer_wheel_t *w, uint32_t state) {
+    if (w->port->unlock) {
+        w->port->unlock(w->port->ctx, state);
+    }
+}
+
+// Advance baseJiffy/baseTick to the jiffy containing the current counter value
+static uint32_t ns_tw_sync(ns_timer_wheel_t *w) {
+    uint32_t now = w->port->now(w->port->ctx);
+
+    if (!w->synced) {
+        // Idle wheels don't program alarms, so the counter may have wrapped any
+        // number of times. Restart the jiffy clock at the first unprocessed jiffy.
+        w->baseJiffy = w->cur;
+        w->baseTick = now;
+        w->synced = true;
+        return now;
+    }
+
+    uint32_t n = (now - w->baseTick) / w->ticksPerJiffy;
+    w->baseJiffy += n;
+    w->baseTick += n * w->ticksPerJiffy;
+    return now;
+}
+
+// Counter value at which a jiffy starts
+static inline uint32_t ns_tw_jiffy_tick(ns_timer_wheel_t *w, uint32_t jiffy) {
+    return w->baseTick + (jiffy - w->baseJiffy) * w->ticksPerJiffy;
+}
+
+static void ns_tw_insert(ns_timer_wheel_t *w, ns_timer_wheel_timer_t *t) {
+    uint32_t delta = t->expires - w->cur;
+    uint32_t level = 0;
+
+    while ((level < NS_TIMER_WHEEL_LEVELS - 1) && (delta >> NS_TW_SHIFT(level + 1))) {
+        level++;
+    }
+
+    uint32_t slot = (t->expires >> NS_TW_SHIFT(level)) & NS_TW_MASK;
+    ns_timer_wheel_timer_t **head = &w->slots[level][slot];
+
+    t->next = *head;
+    if (t->next) {
+        t->next->pprev = &t->next;
+    }
+    t->pprev = head;
+    *head = t;
+    t->level = (uint8_t)level;
+    t->slot = (uint8_t)slot;
+    w->occupied[level] |= (1ULL << slot);
+    w->count++;
+}
+
+static void ns_tw_unlink(ns_timer_wheel_t *w, ns_timer_wheel_timer_t *t) {
+    *t->pprev = t->next;
+    if (t->next) {
+        t->next->pprev = t->pprev;
+    }
+    if (w->slots[t->level][t->slot] == NULL) {
+        w->occupied[t->level] &= ~(1ULL << t->slot);
+    }
+    t->pprev = NULL;
+    t->next = NULL;
+
+    // Nothing will wake the wheel to follow the counter, resync on the next start.
+    // While servicing, the service call takes care of this when it finishes.
+    if ((--w->count == 0) && !w->servicing) {
+        w->synced = false;
+    }
+}
+
+/**
+ * @brief Find the next jiffy >= cur that needs attention
+ *
+ * With exact == false this is the next slot to process: a level 0 expiry or
+ * the cascade of an occupied upper level slot. With exact == true it is the
+ * earliest expiry of any running timer. Upper level slots cover disjoint, ordered
+ * ranges of expiry, so only the first occupied slot of each level is searched.
+ */
+static bool ns_tw_next_event(ns_timer_wheel_t *w, bool exact, uint32_t *when) {
+    bool found = false;
+    uint32_t best = 0;
+
+    for (uint32_t level = 0; level < NS_TIMER_WHEEL_LEVELS; level++) {
+        uint64_t occ = w->occupied[level];
+        if (occ == 0) {
+            continue;
+        }
+
+        uint32_t shift = NS_TW_SHIFT(level);
+        uint32_t first = w->cur >> shift;
+        if ((level > 0) && (w->cur & ((1UL << shift) - 1))) {
+            // The current slot was already cascaded; what's in it now is a full turn away
+            first++;
+        }
+
+        // Bit d of rot is slot first + d
+        uint32_t idx = first & NS_TW_MASK;
+        uint64_t rot = idx ? ((occ >> idx) | (occ << (NS_TIMER_WHEEL_SLOTS - idx))) : occ;
+        uint32_t d = (uint32_t)__builtin_ctzll(rot);
+        uint32_t t;
+
+        if (level == 0) {
+            t = w->cur + d;
+        } else if (exact) {
+            ns_timer_wheel_timer_t *p = w->slots[level][(idx + d) & NS_TW_MASK];
+            t = p->expires;
+            for (p = p->next; p != NULL; p = p->next) {
+                if (NS_TW_BEFORE(p->expires, t)) {
+                    t = p->expires;
+                }
+            }
+        } else {
+            t = (first + d) << shift;
+        }
+
+        if (!found || NS_TW_BEFORE(t, best)) {
+            best = t;
+            found = true;
+        }
+    }
+
+    *when = best;
+    return found;
+}
+
+// Re-insert the timers of every upper level slot that starts at cur
+static void ns_tw_cascade(ns_timer_wheel_t *w) {
+    for (uint32_t level = NS_TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        uint32_t shift = NS_TW_SHIFT(level);
+        if (w->cur & ((1UL << shift) - 1)) {
+            continue;
+        }
+
+        uint32_t slot = (w->cur >> shift) & NS_TW_MASK;
+        ns_timer_wheel_timer_t *t = w->slots[level][slot];
+        w->slots[level][slot] = NULL;
+        w->occupied[level] &= ~(1ULL << slot);
+
+        while (t != NULL) {
+            ns_timer_wheel_timer_t *next = t->next;
+            w->count--;
+            ns_tw_insert(w, t);
+            w->stats.cascades++;
+            t = next;
+        }
+    }
+}
+
+static void ns_tw_record(ns_timer_wheel_t *w, ns_timer_wheel_timer_t *t, uint32_t deadline) {
+    uint32_t latency = w->port->now(w->port->ctx) - deadline;
+    if ((int32_t)latency < 0) {
+        latency = 0;
+    }
+    uint32_t latencyUs = latency / w->port->ticksPerUs;
+
+    // Deadlines of consecutive callbacks are an exact number of periods apart,
+    // so the change in latency is the deviation of the interval from nominal.
+    if (t->period && (t->stats.fired > 0)) {
+        uint32_t jitter = (latency > t->lastLatency) ? latency - t->lastLatency
+                                                     : t->lastLatency - latency;
+        t->stats.jitterMaxUs = MAX(t->stats.jitterMaxUs, jitter / w->port->ticksPerUs);
+    }
+    t->lastLatency = latency;
+    t->stats.fired++;
+    t->stats.latencySumUs += latencyUs;
+    t->stats.latencyMaxUs = MAX(t->stats.latencyMaxUs, latencyUs);
+    w->stats.fired++;
+    w->stats.latencyMaxUs = MAX(w->stats.latencyMaxUs, latencyUs);
+}
+
+// Fire the level 0 slot for cur. Callbacks run unlocked and may start or stop
+// timers, so the slot head is re-read after each one.
+static void ns_tw_expire(ns_timer_wheel_t *w, uint32_t *state) {
+    uint32_t slot = w->cur & NS_TW_MASK;
+    ns_timer_wheel_timer_t *t;
+
+    while ((t = w->slots[0][slot]) != NULL) {
+        uint32_t deadline = ns_tw_jiffy_tick(w, t->expires);
+
+        ns_tw_unlink(w, t);
+        if (t->period) {
+            t->expires += t->period;
+            if (!NS_TW_BEFORE(w->baseJiffy, t->expires)) {
+                // Dispatch fell at least a full period behind, drop the missed periods
+                uint32_t n = (w->baseJiffy - t->expires) / t->period + 1;
+                t->expires += n * t->period;
+                t->stats.missed += n;
+            }
+            ns_tw_insert(w, t);
+        }
+
+        ns_tw_unlock(w, *state);
+        ns_tw_record(w, t, deadline);
+        t->callback(t, t->arg);
+        *state = ns_tw_lock(w);
+    }
+}
+
+// Process every jiffy up to and including target, skipping idle stretches
+static void ns_tw_run(ns_timer_wheel_t *w, uint32_t target, uint32_t *state) {
+    uint32_t next;
+
+    while (!NS_TW_BEFORE(target, w->cur)) {
+        if (!ns_tw_next_event(w, false, &next) || NS_TW_BEFORE(target, next)) {
+            w->cur = target + 1;
+            return;
+        }
+        w->cur = next;
+        ns_tw_cascade(w);
+        ns_tw_expire(w, state);
+        w->cur++;
+    }
+}
+
+// Program the hardware alarm for the nearest deadline
+static void ns_tw_arm(ns_timer_wheel_t *w, uint32_t jiffy) {
+    uint32_t maxJiffies = NS_TW_MAX_ALARM_TICKS / w->ticksPerJiffy;
+
+    // The counter has to be observed at least once per wrap for sync to work
+    if ((int32_t)(jiffy - w->baseJiffy) > (int32_t)maxJiffies) {
+        jiffy = w->baseJiffy + maxJiffies;
+    }
+    w->alarmJiffy = jiffy;
+    w->armed = true;
+    w->stats.alarms++;
+    w->port->set_alarm(w->port->ctx, ns_tw_jiffy_tick(w, jiffy));
+}
+
+uint32_t ns_timer_wheel_init(ns_timer_wheel_t *wheel) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if (wheel == NULL) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+
+    if (ns_core_check_api(
+            wheel->api, &ns_timer_wheel_oldest_supported_version,
+            &ns_timer_wheel_current_version)) {
+        return NS_STATUS_INVALID_VERSION;
+    }
+
+    if ((wheel->port == NULL) || (wheel->port->now == NULL) ||
+        (wheel->port->set_alarm == NULL) || (wheel->port->ticksPerUs == 0) ||
+        (wheel->resolutionUs == 0) ||
+        ((uint64_t)wheel->resolutionUs * wheel->port->ticksPerUs > NS_TW_MAX_ALARM_TICKS)) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    memset(wheel->slots, 0, sizeof(wheel->slots));
+    memset(wheel->occupied, 0, sizeof(wheel->occupied));
+    memset(&wheel->stats, 0, sizeof(wheel->stats));
+    wheel->cur = 0;
+    wheel->baseJiffy = 0;
+    wheel->baseTick = 0;
+    wheel->ticksPerJiffy = wheel->resolutionUs * wheel->port->ticksPerUs;
+    wheel->alarmJiffy = 0;
+    wheel->count = 0;
+    wheel->armed = false;
+    wheel->synced = false;
+    wheel->servicing = false;
+
+    if (wheel->port->init) {
+        return wheel->port->init(wheel->port->ctx, wheel);
+    }
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_timer_wheel_start(
+    ns_timer_wheel_t *wheel, ns_timer_wheel_timer_t *timer, uint32_t delayUs, uint32_t periodUs) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((wheel == NULL) || (timer == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+    if (timer->callback == NULL) {
+        return NS_STATUS_INVALID_CONFIG;
+    }
+#endif
+
+    uint32_t state = ns_tw_lock(wheel);
+
+    if (timer->pprev) {
+        ns_tw_unlink(wheel, timer);
+    }
+
+    uint32_t now = ns_tw_sync(wheel);
+
+    // Round up so the first callback is never early
+    uint64_t ticks =
+        (uint64_t)(now - wheel->baseTick) + (uint64_t)delayUs * wheel->port->ticksPerUs;
+    uint64_t delay = (ticks + wheel->ticksPerJiffy - 1) / wheel->ticksPerJiffy;
+    timer->expires = wheel->baseJiffy + (uint32_t)MIN(delay, NS_TIMER_WHEEL_MAX_JIFFIES);
+
+    if (NS_TW_BEFORE(timer->expires, wheel->cur)) {
+        timer->expires = wheel->cur;
+    }
+    if (wheel->servicing && (timer->expires == wheel->cur)) {
+        // The current jiffy may be firing right now; a timer restarting itself
+        // with no delay would never let it finish
+        timer->expires++;
+    }
+
+    timer->period = 0;
+    if (periodUs) {
+        uint32_t period = (periodUs + wheel->resolutionUs / 2) / wheel->resolutionUs;
+        timer->period = MAX(MIN(period, NS_TIMER_WHEEL_MAX_JIFFIES), 1);
+    }
+
+    ns_tw_insert(wheel, timer);
+
+    // Only a new nearest deadline needs the alarm moved. Inside service, the
+    // alarm is programmed once all callbacks are done.
+    if (!wheel->servicing &&
+        (!wheel->armed || NS_TW_BEFORE(timer->expires, wheel->alarmJiffy))) {
+        ns_tw_arm(wheel, timer->expires);
+    }
+
+    ns_tw_unlock(wheel, state);
+    return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_timer_wheel_stop(ns_timer_wheel_t *wheel, ns_timer_wheel_timer_t *timer) {
+#ifndef NS_DISABLE_API_VALIDATION
+    if ((wheel == NULL) || (timer == NULL)) {
+        return NS_STATUS_INVALID_HANDLE;
+    }
+#endif
+
+    // The alarm is left alone: if it was for this timer, the wakeup finds
+    // nothing to do and moves the alarm to the next deadline.
+    uint32_t state = ns_tw_lock(wheel);
+    if (timer->pprev) {
+        ns_tw_unlink(wheel, timer);
+    }
+    ns_tw_unlock(wheel, state);
+    return NS_STATUS_SUCCESS;
+}
+
+bool ns_timer_wheel_active(const ns_timer_wheel_timer_t *timer) { return timer->pprev != NULL; }
+
+void ns_timer_wheel_service(ns_timer_wheel_t *wheel) {
+    uint32_t state = ns_tw_lock(wheel);
+    uint32_t next;
+
+    if (wheel->servicing) {
+        // Called from a callback, or an interrupt preempted a service call
+        // from thread mode; the outer call picks up whatever is due.
+        ns_tw_unlock(wheel, state);
+        return;
+    }
+    wheel->servicing = true;
+    wheel->armed = false;
+    wheel->stats.services++;
+
+    if (wheel->count) {
+        ns_tw_sync(wheel);
+        ns_tw_run(wheel, wheel->baseJiffy, &state);
+    }
+
+    // Callbacks take time; anything that became due meanwhile is caught by the
+    // port, which services again right away for an alarm in the past.
+    if (wheel->count && ns_tw_next_event(wheel, true, &next)) {
+        ns_tw_arm(wheel, next);
+    } else {
+        wheel->synced = false;
+    }
+
+    wheel->servicing = false;
+    ns_tw_unlock(wheel, state);
+}
+
+uint32_t ns_timer_wheel_next_deadline_us(ns_timer_wheel_t *wheel) {
+    uint32_t state = ns_tw_lock(wheel);
+    uint32_t next, us = UINT32_MAX;
+
+    if (wheel->count && ns_tw_next_event(wheel, true, &next)) {
+        uint32_t now = ns_tw_sync(wheel);
+        uint32_t ticks = ns_tw_jiffy_tick(wheel, next) - now;
+        us = ((int32_t)ticks > 0) ? ticks / wheel->port->ticksPerUs : 0;
+    }
+
+    ns_tw_unlock(wheel, state);
+    return us;
+}
+
+void ns_timer_wheel_stats_reset(ns_timer_wheel_t *wheel, ns_timer_wheel_timer_t *timer) {
+    memset(&wheel->stats, 0, sizeof(wheel->stats));
+    if (timer != NULL) {
+        memset(&timer->stats, 0, sizeof(timer->stats));
+        timer->lastLatency = 0;
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file ns_timer_wheel_hw.c
+ * @author Ambiq
+ * @brief Timer wheel port for the NS_TIMER_WHEEL hardware timer
+ * @version 0.1
+ * @date 2025-07-18
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "am_mcu_apollo.h"
+#include "ns_timer.h"
+#include "ns_timer_wheel.h"
+
+static ns_timer_wheel_t *ns_timer_wheel_hw_wheel = NULL;
+
+static void ns_timer_wheel_hw_isr(ns_timer_config_t *cfg) {
+    if (ns_timer_wheel_hw_wheel != NULL) {
+        ns_timer_wheel_service(ns_timer_wheel_hw_wheel);
+    }
+}
+
+static ns_timer_config_t ns_timer_wheel_hw_timer = {
+    .api = &ns_timer_V1_1_0,
+    .timer = NS_TIMER_WHEEL,
+    .enableInterrupt = true,
+    .periodInMicroseconds = 0,
+    .callback = ns_timer_wheel_hw_isr,
+};
+
+static uint32_t ns_timer_wheel_hw_init(void *ctx, ns_timer_wheel_t *wheel) {
+    ns_timer_wheel_hw_wheel = wheel;
+    return ns_timer_init(&ns_timer_wheel_hw_timer);
+}
+
+static uint32_t ns_timer_wheel_hw_now(void *ctx) {
+    return ns_timer_ticks_read(&ns_timer_wheel_hw_timer);
+}
+
+static void ns_timer_wheel_hw_set_alarm(void *ctx, uint32_t tick) {
+    ns_timer_compare_set(&ns_timer_wheel_hw_timer, tick);
+}
+
+static uint32_t ns_timer_wheel_hw_lock(void *ctx) { return am_hal_interrupt_master_disable(); }
+
+static void ns_timer_wheel_hw_unlock(void *ctx, uint32_t state) {
+    am_hal_interrupt_master_set(state);
+}
+
+const ns_timer_wheel_port_t ns_timer_wheel_hw_port = {
+    .ticksPerUs = NS_TIMER_TICKS_PER_US,
+    .init = ns_timer_wheel_hw_init,
+    .now = ns_timer_wheel_hw_now,
+    .set_alarm = ns_timer_wheel_hw_set_alarm,
+    .lock = ns_timer_wheel_hw_lock,
+    .unlock = ns_timer_wheel_hw_unlock,
+    .ctx = NULL,
+};
@@ -0,0 +1,224 @@
+#include "ns_fast_log_tests.h"
+#include "ns_core.h"
+#include "ns_timer.h"
+#include "unity/unity.h"
+#include <float.h>
+#include <math.h>
+
+#define NS_FAST_LOG_TEST_LEN 257 // not a multiple of the vector width
+#define NS_FAST_LOG_BENCH_LEN 256
+#define NS_FAST_LOG_BENCH_REPS 100
+
+static int32_t x_q[NS_FAST_LOG_TEST_LEN];
+static int32_t out_q[NS_FAST_LOG_TEST_LEN];
+static int32_t ref_q[NS_FAST_LOG_TEST_LEN];
+static float x_f[NS_FAST_LOG_TEST_LEN];
+static float out_f[NS_FAST_LOG_TEST_LEN];
+static uint32_t lfsr;
+
+static ns_timer_config_t bench_timer = {
+    .api = &ns_timer_V1_0_0,
+    .timer = NS_TIMER_COUNTER,
+    .enableInterrupt = false,
+};
+
+static uint32_t next_rand() {
+    lfsr ^= lfsr << 13;
+    lfsr ^= lfsr >> 17;
+    lfsr ^= lfsr << 5;
+    return lfsr;
+}
+
+// Reference: the bit-search implementation from ns-nnsp fixlog10.c
+static void ref_log10(int32_t *out, int32_t x, int16_t bit_frac_in) {
+    int32_t i, y, kx, dx, tmp;
+    int8_t shift = 0;
+
+    if (x == 0)
+        x = 1;
+    for (i = 0; i < 31; i++) {
+        if ((((int32_t)1) << (30 - i)) & x) {
+            shift = -(30 - i - 15);
+            break;
+        }
+    }
+    y = (shift >= 0) ? x << shift : x >> -shift;
+    shift = -shift;
+    kx = (y - (1 << 15)) >> 8;
+    dx = (y - (1 << 15)) - (kx << 8);
+    tmp = ((int32_t)ns_log_mantissa_q15[kx << 1]) +
+          (((int32_t)ns_log_mantissa_q15[1 + (kx << 1)] * dx) >> 15);
+    tmp = (int32_t)(((int64_t)tmp * NS_INV_LN10_Q15) >> 15);
+    *out = tmp + NS_LOG2_DIV_LOG10_Q15 * (int32_t)shift + (15 - bit_frac_in) * NS_LOG2_DIV_LOG10_Q15;
+}
+
+// Spread inputs over every magnitude, plus small values
+static void fill_q31() {
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        x_q[i] = (int32_t)(next_rand() >> (1 + (i % 31)));
+    }
+    x_q[0] = 0;
+    x_q[1] = 1;
+    x_q[2] = 0x7fffffff;
+    x_q[3] = 1 << 15;
+}
+
+static void fill_f32() {
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        float m = 1.0f + (float)(next_rand() & 0xffffff) / 16777216.0f;
+        x_f[i] = ldexpf(m, (int)(next_rand() % 120) - 60);
+    }
+}
+
+void ns_fast_log_tests_pre_test_hook() {
+    lfsr = 0x12345678;
+}
+
+void ns_fast_log_tests_post_test_hook() {
+    // post hook if needed
+}
+
+void ns_fast_log_test_log10_bit_exact() {
+    fill_q31();
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        ref_log10(&ref_q[i], x_q[i], 15);
+    }
+    ns_log10_q31_vec(out_q, x_q, NS_FAST_LOG_TEST_LEN, 15);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref_q, out_q, NS_FAST_LOG_TEST_LEN);
+}
+
+void ns_fast_log_test_log10_frac_bits() {
+    fill_q31();
+    for (int16_t frac = 0; frac <= 30; frac += 5) {
+        for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+            ref_log10(&ref_q[i], x_q[i], frac);
+        }
+        ns_log10_q31_vec(out_q, x_q, NS_FAST_LOG_TEST_LEN, frac);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(ref_q, out_q, NS_FAST_LOG_TEST_LEN);
+    }
+}
+
+void ns_fast_log_test_log10_q15_input() {
+    int16_t x16[NS_FAST_LOG_TEST_LEN];
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        x16[i] = (int16_t)(next_rand() >> (17 + (i % 15)));
+        ref_log10(&ref_q[i], x16[i], 15);
+    }
+    ns_log10_q15_vec(out_q, x16, NS_FAST_LOG_TEST_LEN, 15);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref_q, out_q, NS_FAST_LOG_TEST_LEN);
+}
+
+void ns_fast_log_test_log2() {
+    fill_q31();
+    ns_log2_q31_vec(out_q, x_q, NS_FAST_LOG_TEST_LEN, 15);
+    for (int i = 1; i < NS_FAST_LOG_TEST_LEN; i++) {
+        if (x_q[i] <= 0) {
+            continue;
+        }
+        float expected = log2f((float)x_q[i] / 32768.0f);
+        TEST_ASSERT_FLOAT_WITHIN(2e-3f, expected, (float)out_q[i] / 32768.0f);
+    }
+
+    // Exact powers of two land on integers
+    x_q[0] = 1 << 20;
+    ns_log2_q31_vec(out_q, x_q, 1, 15);
+    TEST_ASSERT_EQUAL_INT32(5 << 15, out_q[0]);
+}
+
+void ns_fast_log_test_nonpositive_input() {
+    int32_t x[5] = {0, -1, -32768, (int32_t)0x80000000, 1};
+    int32_t out[5];
+    ns_log10_q31_vec(out, x, 5, 15);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT32(out[4], out[i]);
+    }
+}
+
+void ns_fast_log_test_logf_accuracy() {
+    fill_f32();
+    ns_logf_vec(out_f, x_f, NS_FAST_LOG_TEST_LEN);
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(8e-6f, logf(x_f[i]), out_f[i]);
+    }
+}
+
+void ns_fast_log_test_log10f_accuracy() {
+    fill_f32();
+    ns_log10f_vec(out_f, x_f, NS_FAST_LOG_TEST_LEN);
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(8e-6f, log10f(x_f[i]), out_f[i]);
+    }
+}
+
+void ns_fast_log_test_logf_edge_cases() {
+    float x[6] = {1.0f, 2.0f, FLT_MIN, 0.0f, -1.0f, FLT_MIN / 4.0f};
+    float out[6];
+    ns_logf_vec(out, x, 6);
+    TEST_ASSERT_FLOAT_WITHIN(1e-7f, 0.0f, out[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, logf(2.0f), out[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, logf(FLT_MIN), out[2]);
+
+    // zero, negative and denormal inputs clamp to FLT_MIN
+    TEST_ASSERT_EQUAL_FLOAT(out[2], out[3]);
+    TEST_ASSERT_EQUAL_FLOAT(out[2], out[4]);
+    TEST_ASSERT_EQUAL_FLOAT(out[2], out[5]);
+}
+
+void ns_fast_log_test_in_place() {
+    fill_q31();
+    for (int i = 0; i < NS_FAST_LOG_TEST_LEN; i++) {
+        ref_log10(&ref_q[i], x_q[i], 15);
+    }
+    ns_log10_q31_vec(x_q, x_q, NS_FAST_LOG_TEST_LEN, 15);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref_q, x_q, NS_FAST_LOG_TEST_LEN);
+
+    fill_f32();
+    ns_logf_vec(out_f, x_f, NS_FAST_LOG_TEST_LEN);
+    ns_logf_vec(x_f, x_f, NS_FAST_LOG_TEST_LEN);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(out_f, x_f, NS_FAST_LOG_TEST_LEN);
+}
+
+// Not a pass/fail check: reports per-element cost against the bit-search and libm baselines
+void ns_fast_log_test_benchmark() {
+    uint32_t t0, t_ref, t_q, t_libm, t_f;
+
+    fill_q31();
+    fill_f32();
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_init(&bench_timer));
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_FAST_LOG_BENCH_REPS; r++) {
+        for (int i = 0; i < NS_FAST_LOG_BENCH_LEN; i++) {
+            ref_log10(&ref_q[i], x_q[i], 15);
+        }
+    }
+    t_ref = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_FAST_LOG_BENCH_REPS; r++) {
+        ns_log10_q31_vec(out_q, x_q, NS_FAST_LOG_BENCH_LEN, 15);
+    }
+    t_q = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_FAST_LOG_BENCH_REPS; r++) {
+        for (int i = 0; i < NS_FAST_LOG_BENCH_LEN; i++) {
+            out_f[i] = logf(x_f[i]);
+        }
+    }
+    t_libm = ns_us_ticker_read(&bench_timer) - t0;
+
+    t0 = ns_us_ticker_read(&bench_timer);
+    for (int r = 0; r < NS_FAST_LOG_BENCH_REPS; r++) {
+        ns_logf_vec(out_f, x_f, NS_FAST_LOG_BENCH_LEN);
+    }
+    t_f = ns_us_ticker_read(&bench_timer) - t0;
+
+    ns_lp_printf(
+        "log10 q31: bit-search %d us, ns_log10_q31_vec %d us (%d x %d elements)\n", t_ref, t_q,
+        NS_FAST_LOG_BENCH_REPS, NS_FAST_LOG_BENCH_LEN);
+    ns_lp_printf(
+        "log f32: logf %d us, ns_logf_vec %d us (%d x %d elements)\n", t_libm, t_f,
+        NS_FAST_LOG_BENCH_REPS, NS_FAST_LOG_BENCH_LEN);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref_q, out_q, NS_FAST_LOG_BENCH_LEN);
+}
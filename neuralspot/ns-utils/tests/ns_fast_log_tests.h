@@ -0,0 +1,13 @@
+#include "ns_fast_log.h"
+void ns_fast_log_tests_pre_test_hook();
+void ns_fast_log_tests_post_test_hook();
+void ns_fast_log_test_log10_bit_exact();
+void ns_fast_log_test_log10_frac_bits();
+void ns_fast_log_test_log10_q15_input();
+void ns_fast_log_test_log2();
+void ns_fast_log_test_nonpositive_input();
+void ns_fast_log_test_logf_accuracy();
+void ns_fast_log_test_log10f_accuracy();
+void ns_fast_log_test_logf_edge_cases();
+void ns_fast_log_test_in_place();
+void ns_fast_log_test_benchmark();
@@ -0,0 +1,200 @@
+#include "ns_pmu_metrics_tests.h"
+#include "ns_core.h"
+#include "unity/unity.h"
+#include <math.h>
+#include <string.h>
+
+// Event IDs, as used by ns_pmu_metrics_events
+#define EVT_L1D_CACHE_REFILL 0x0003
+#define EVT_INST_RETIRED 0x0008
+#define EVT_CPU_CYCLES 0x0011
+#define EVT_MVE_INST_RETIRED 0x0200
+#define EVT_MVE_STALL_RESOURCE_MEM 0x02CE
+
+static ns_pmu_metrics_t metrics;
+
+void ns_pmu_metrics_tests_pre_test_hook() {}
+
+void ns_pmu_metrics_tests_post_test_hook() {}
+
+void ns_pmu_metrics_test_ipc() {
+    const ns_pmu_sample_t s[] = {
+        {EVT_INST_RETIRED, 7500},
+        {EVT_CPU_CYCLES, 10000},
+    };
+    ns_pmu_metrics_compute(s, 2, NULL, &metrics);
+    TEST_ASSERT_EQUAL(NS_PMU_METRIC_IPC, metrics.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.75f, metrics.ipc);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_UNKNOWN, metrics.bound);
+}
+
+void ns_pmu_metrics_test_mve_beat_utilization() {
+    // 2 beats per cycle: 10000 cycles can execute 5000 4-beat MVE instructions
+    ns_pmu_sample_t s[] = {
+        {EVT_CPU_CYCLES, 10000},
+        {EVT_MVE_INST_RETIRED, 1250},
+    };
+    ns_pmu_metrics_compute(s, 2, NULL, &metrics);
+    TEST_ASSERT_TRUE(metrics.valid & NS_PMU_METRIC_MVE_BEATS);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25f, metrics.mveBeatUtil);
+
+    // Sampling noise can overshoot, utilization is clamped
+    s[1].value = 6000;
+    ns_pmu_metrics_compute(s, 2, NULL, &metrics);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, metrics.mveBeatUtil);
+}
+
+void ns_pmu_metrics_test_ldst_stall_ratio() {
+    const ns_pmu_sample_t s[] = {
+        {EVT_MVE_STALL_RESOURCE_MEM, 300},
+        {EVT_CPU_CYCLES, 1200},
+    };
+    ns_pmu_metrics_compute(s, 2, NULL, &metrics);
+    TEST_ASSERT_EQUAL(NS_PMU_METRIC_LDST_STALL, metrics.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25f, metrics.ldstStallRatio);
+}
+
+void ns_pmu_metrics_test_mpki_memory_bound() {
+    // 4000 refills of 32 bytes for 10000 instructions is 0.078 inst/byte, under the
+    // 1/8 inst/byte ridge of a 64-bit bus
+    const ns_pmu_sample_t s[] = {
+        {EVT_CPU_CYCLES, 40000},
+        {EVT_INST_RETIRED, 10000},
+        {EVT_L1D_CACHE_REFILL, 4000},
+    };
+    ns_pmu_metrics_compute(s, 3, NULL, &metrics);
+    TEST_ASSERT_EQUAL(NS_PMU_METRIC_IPC | NS_PMU_METRIC_MPKI | NS_PMU_METRIC_BOUND,
+                      metrics.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 400.0f, metrics.mpki);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 10000.0f / (4000 * 32), metrics.intensity);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.625f, metrics.attainableIpc);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_MEMORY, metrics.bound);
+    TEST_ASSERT_EQUAL_STRING("memory", ns_pmu_bound_name(metrics.bound));
+}
+
+void ns_pmu_metrics_test_compute_bound() {
+    ns_pmu_sample_t s[] = {
+        {EVT_INST_RETIRED, 10000},
+        {EVT_L1D_CACHE_REFILL, 100},
+    };
+    ns_pmu_metrics_compute(s, 2, NULL, &metrics);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10.0f, metrics.mpki);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, metrics.attainableIpc);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_COMPUTE, metrics.bound);
+    TEST_ASSERT_EQUAL_STRING("compute", ns_pmu_bound_name(metrics.bound));
+
+    // No misses at all
+    s[1].value = 0;
+    ns_pmu_metrics_compute(s, 2, NULL, &metrics);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, metrics.mpki);
+    TEST_ASSERT_TRUE(isinf(metrics.intensity));
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_COMPUTE, metrics.bound);
+}
+
+void ns_pmu_metrics_test_missing_events() {
+    const ns_pmu_sample_t s[] = {
+        {EVT_MVE_INST_RETIRED, 100},
+        {EVT_L1D_CACHE_REFILL, 100},
+        {EVT_CPU_CYCLES, 0}, // a layer with no samples
+    };
+    ns_pmu_metrics_compute(s, 3, NULL, &metrics);
+    TEST_ASSERT_EQUAL(0, metrics.valid);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_UNKNOWN, metrics.bound);
+    TEST_ASSERT_EQUAL_STRING("unknown", ns_pmu_bound_name(metrics.bound));
+
+    ns_pmu_metrics_compute(NULL, 0, NULL, &metrics);
+    TEST_ASSERT_EQUAL(0, metrics.valid);
+}
+
+void ns_pmu_metrics_test_custom_machine() {
+    // Same layer, faster memory moves the ridge and the layer becomes compute bound
+    const ns_pmu_machine_t fast = {
+        .peakIpc = 1.0f, .memBytesPerCycle = 32.0f, .lineBytes = 32, .beatsPerCycle = 1};
+    const ns_pmu_sample_t s[] = {
+        {EVT_CPU_CYCLES, 40000},
+        {EVT_INST_RETIRED, 10000},
+        {EVT_L1D_CACHE_REFILL, 4000},
+        {EVT_MVE_INST_RETIRED, 5000},
+    };
+    ns_pmu_metrics_compute(s, 4, &fast, &metrics);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_COMPUTE, metrics.bound);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, metrics.mveBeatUtil);
+
+    ns_pmu_metrics_compute(s, 4, &ns_pmu_machine_apollo5, &metrics);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_MEMORY, metrics.bound);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25f, metrics.mveBeatUtil);
+}
+
+// A synthetic counter trace through the mux and into the metrics
+static uint32_t fx_vclock, fx_last;
+static uint32_t fx_active[NS_PMU_MUX_GROUP_SIZE], fx_count;
+
+static uint32_t fx_rate(uint32_t eventId) {
+    // counts per 100 cycles
+    switch (eventId) {
+    case EVT_CPU_CYCLES:
+        return 100;
+    case EVT_INST_RETIRED:
+        return 60;
+    case EVT_MVE_INST_RETIRED:
+        return 20;
+    case EVT_L1D_CACHE_REFILL:
+        return 1;
+    case EVT_MVE_STALL_RESOURCE_MEM:
+        return 10;
+    default:
+        return 5;
+    }
+}
+
+static void fx_program(void *ctx, const uint32_t *ids, uint32_t count) {
+    memcpy(fx_active, ids, count * sizeof(uint32_t));
+    fx_count = count;
+    fx_last = fx_vclock;
+}
+
+static void fx_read(void *ctx, uint32_t *c, uint32_t *cycles) {
+    for (uint32_t i = 0; i < fx_count; i++) {
+        c[i] = fx_rate(fx_active[i]) * (fx_vclock - fx_last) / 100;
+    }
+    *cycles = fx_vclock - fx_last;
+    fx_last = fx_vclock;
+}
+
+void ns_pmu_metrics_test_from_mux() {
+    static const ns_pmu_mux_port_t port = {.program = fx_program, .read = fx_read};
+    static uint32_t counts[NS_PMU_METRICS_NUM_EVENTS];
+    static uint32_t groupCycles[NS_PMU_MUX_GROUPS(NS_PMU_METRICS_NUM_EVENTS)];
+    ns_pmu_sample_t samples[NS_PMU_METRICS_NUM_EVENTS];
+    ns_pmu_mux_t mux = {
+        .api = &ns_pmu_mux_current_version,
+        .port = &port,
+        .eventIds = ns_pmu_metrics_events,
+        .numEvents = ns_pmu_metrics_num_events,
+        .maxLayers = 1,
+        .counts = counts,
+        .groupCycles = groupCycles,
+    };
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_pmu_mux_init(&mux));
+
+    fx_vclock = 0;
+    ns_pmu_mux_start(&mux);
+    ns_pmu_mux_layer_begin(&mux);
+    for (int slice = 0; slice < 20; slice++) {
+        fx_vclock += 1000;
+        ns_pmu_mux_rotate(&mux);
+    }
+    ns_pmu_mux_layer_end(&mux);
+    ns_pmu_mux_stop(&mux);
+
+    TEST_ASSERT_EQUAL(NS_PMU_METRICS_NUM_EVENTS, ns_pmu_mux_layer_samples(&mux, 0, samples));
+    ns_pmu_metrics_compute(samples, NS_PMU_METRICS_NUM_EVENTS, NULL, &metrics);
+    TEST_ASSERT_EQUAL(NS_PMU_METRIC_IPC | NS_PMU_METRIC_MVE_BEATS | NS_PMU_METRIC_LDST_STALL |
+                          NS_PMU_METRIC_MPKI | NS_PMU_METRIC_BOUND,
+                      metrics.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.6f, metrics.ipc);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.4f, metrics.mveBeatUtil);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.1f, metrics.ldstStallRatio);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 1000.0f / 60, metrics.mpki);
+    TEST_ASSERT_EQUAL(NS_PMU_BOUND_COMPUTE, metrics.bound);
+}
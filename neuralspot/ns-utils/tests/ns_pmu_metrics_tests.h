@@ -0,0 +1,11 @@
+#include "ns_pmu_metrics.h"
+void ns_pmu_metrics_tests_pre_test_hook();
+void ns_pmu_metrics_tests_post_test_hook();
+void ns_pmu_metrics_test_ipc();
+void ns_pmu_metrics_test_mve_beat_utilization();
+void ns_pmu_metrics_test_ldst_stall_ratio();
+void ns_pmu_metrics_test_mpki_memory_bound();
+void ns_pmu_metrics_test_compute_bound();
+void ns_pmu_metrics_test_missing_events();
+void ns_pmu_metrics_test_custom_machine();
+void ns_pmu_metrics_test_from_mux();
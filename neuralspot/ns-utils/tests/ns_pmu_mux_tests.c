@@ -0,0 +1,394 @@
+#include "ns_pmu_mux_tests.h"
+#include "ns_core.h"
+#include "unity/unity.h"
+#include <string.h>
+
+// The multiplexer runs against a simulated PMU: every event counts at a fixed rate per cycle,
+// with one set of rates inside layers and another (noise) between them. Virtual time only
+// advances between mux calls, so each read() interval is entirely in one phase.
+
+#define PM_MAX_EVENTS 12
+#define PM_MAX_LAYERS 16
+#define PM_GAP_RATE 1000
+
+static uint32_t eventIds[PM_MAX_EVENTS];
+static uint32_t counts[PM_MAX_LAYERS * PM_MAX_EVENTS];
+static uint32_t groupCycles[PM_MAX_LAYERS * NS_PMU_MUX_GROUPS(PM_MAX_EVENTS)];
+
+static uint32_t vclock;
+static uint32_t lastRead;
+static uint32_t nextSlice;
+static uint32_t sliceCycles;
+static uint32_t layerRate[PM_MAX_EVENTS]; // count per cycle, indexed by eventId
+static const uint32_t *rates;
+static uint32_t gapRate[PM_MAX_EVENTS];
+static uint32_t active[NS_PMU_MUX_GROUP_SIZE];
+static uint32_t activeCount;
+static uint32_t programs;
+
+static void pm_program(void *ctx, const uint32_t *ids, uint32_t count) {
+    TEST_ASSERT_TRUE(count <= NS_PMU_MUX_GROUP_SIZE);
+    memcpy(active, ids, count * sizeof(uint32_t));
+    activeCount = count;
+    lastRead = vclock;
+    programs++;
+}
+
+static void pm_read(void *ctx, uint32_t *c, uint32_t *cycles) {
+    uint32_t elapsed = vclock - lastRead;
+    for (uint32_t i = 0; i < activeCount; i++) {
+        c[i] = rates[active[i]] * elapsed;
+    }
+    *cycles = elapsed;
+    lastRead = vclock;
+}
+
+static const ns_pmu_mux_port_t pm_port = {
+    .program = pm_program,
+    .read = pm_read,
+};
+
+static ns_pmu_mux_t mux;
+
+// Advance virtual time, rotating on every slice boundary
+static void pm_advance(uint32_t cycles) {
+    uint32_t end = vclock + cycles;
+    while (sliceCycles != 0 && nextSlice <= end) {
+        vclock = nextSlice;
+        ns_pmu_mux_rotate(&mux);
+        nextSlice += sliceCycles;
+    }
+    vclock = end;
+}
+
+static void pm_layer(uint32_t cycles) {
+    ns_pmu_mux_layer_begin(&mux);
+    rates = layerRate;
+    pm_advance(cycles);
+    ns_pmu_mux_layer_end(&mux);
+    rates = gapRate;
+}
+
+// Run a model of numLayers layers with gapCycles of other work between them
+static void pm_run(const uint32_t *layerCycles, uint32_t numLayers, uint32_t gapCycles) {
+    for (uint32_t l = 0; l < numLayers; l++) {
+        pm_layer(layerCycles[l]);
+        pm_advance(gapCycles);
+    }
+}
+
+static void pm_setup(uint32_t numEvents, uint32_t maxLayers, uint32_t slice) {
+    for (uint32_t i = 0; i < PM_MAX_EVENTS; i++) {
+        eventIds[i] = i;
+        layerRate[i] = i + 1;
+        gapRate[i] = PM_GAP_RATE;
+    }
+    rates = gapRate;
+    vclock = 0;
+    lastRead = 0;
+    sliceCycles = slice;
+    nextSlice = slice;
+    programs = 0;
+
+    memset(&mux, 0, sizeof(mux));
+    mux.api = &ns_pmu_mux_current_version;
+    mux.port = &pm_port;
+    mux.eventIds = eventIds;
+    mux.numEvents = numEvents;
+    mux.maxLayers = maxLayers;
+    mux.counts = counts;
+    mux.groupCycles = groupCycles;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_pmu_mux_init(&mux));
+}
+
+static void pm_assert_estimate(uint32_t layer, uint32_t event, uint32_t expected, uint32_t tol) {
+    uint32_t value;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_pmu_mux_estimate(&mux, layer, event, &value));
+    TEST_ASSERT_UINT32_WITHIN(tol, expected, value);
+}
+
+void ns_pmu_mux_tests_pre_test_hook() {}
+
+void ns_pmu_mux_tests_post_test_hook() {}
+
+void ns_pmu_mux_test_init_validation() {
+    ns_pmu_mux_t bad;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_pmu_mux_init(NULL));
+
+    pm_setup(8, 4, 0);
+    bad = mux;
+    bad.api = &ns_pmu_mux_V0_0_1;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_pmu_mux_init(&bad));
+
+    ns_core_api_t future = {.apiId = NS_PMU_MUX_API_ID, .version = {.major = 9}};
+    bad = mux;
+    bad.api = &future;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_pmu_mux_init(&bad));
+
+    bad = mux;
+    bad.port = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_pmu_mux_init(&bad));
+
+    bad = mux;
+    bad.numEvents = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_pmu_mux_init(&bad));
+
+    bad = mux;
+    bad.counts = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_pmu_mux_init(&bad));
+
+    TEST_ASSERT_EQUAL(2, mux.numGroups);
+}
+
+void ns_pmu_mux_test_single_group() {
+    // 3 events fit in the counters, nothing to rotate - exact counts
+    const uint32_t layers[] = {1000, 2500, 10};
+    pm_setup(3, 4, 100);
+    ns_pmu_mux_start(&mux);
+    pm_run(layers, 3, 50);
+    ns_pmu_mux_stop(&mux);
+
+    TEST_ASSERT_EQUAL(1, programs);
+    for (uint32_t l = 0; l < 3; l++) {
+        TEST_ASSERT_EQUAL(layers[l], ns_pmu_mux_layer_cycles(&mux, l));
+        for (uint32_t e = 0; e < 3; e++) {
+            pm_assert_estimate(l, e, layers[l] * (e + 1), 0);
+        }
+    }
+}
+
+void ns_pmu_mux_test_extrapolation() {
+    // 10 events in 3 groups, layers span many slices: each group counts about a third of
+    // the time and is scaled back up
+    const uint32_t layers[] = {30000, 45000, 61000};
+    pm_setup(10, 4, 1000);
+    ns_pmu_mux_start(&mux);
+    pm_run(layers, 3, 777);
+    ns_pmu_mux_stop(&mux);
+
+    TEST_ASSERT_EQUAL(3, mux.numGroups);
+    TEST_ASSERT_TRUE(mux.rotations > 100);
+    for (uint32_t l = 0; l < 3; l++) {
+        TEST_ASSERT_EQUAL(layers[l], ns_pmu_mux_layer_cycles(&mux, l));
+        for (uint32_t e = 0; e < 10; e++) {
+            // Constant rates extrapolate exactly, up to integer division
+            pm_assert_estimate(l, e, layers[l] * (e + 1), e + 1);
+        }
+    }
+}
+
+void ns_pmu_mux_test_discard_between_layers() {
+    // The gap between layers counts at a much higher rate; none of it may leak in
+    const uint32_t layers[] = {5000, 5000};
+    pm_setup(8, 4, 300);
+    pm_advance(12345);
+    ns_pmu_mux_start(&mux);
+    pm_advance(4000);
+    pm_run(layers, 2, 9000);
+    ns_pmu_mux_stop(&mux);
+
+    for (uint32_t l = 0; l < 2; l++) {
+        TEST_ASSERT_EQUAL(5000, ns_pmu_mux_layer_cycles(&mux, l));
+        for (uint32_t e = 0; e < 8; e++) {
+            pm_assert_estimate(l, e, 5000 * (e + 1), e + 1);
+        }
+    }
+    // Nothing was charged to layers that never ran
+    TEST_ASSERT_EQUAL(0, ns_pmu_mux_layer_cycles(&mux, 2));
+}
+
+void ns_pmu_mux_test_short_layers_coverage() {
+    // Layers shorter than a slice only see the group that was active when they started
+    const uint32_t layers[] = {100, 100, 100, 100};
+    uint32_t value;
+    pm_setup(8, 4, 100000);
+    ns_pmu_mux_start(&mux);
+    pm_run(layers, 4, 10);
+    ns_pmu_mux_stop(&mux);
+
+    // Rotating at layer boundaries spreads the groups over consecutive layers
+    for (uint32_t l = 0; l < 4; l++) {
+        uint32_t seen = l % 2;
+        uint32_t missed = 1 - seen;
+        pm_assert_estimate(l, seen * 4, 100 * (seen * 4 + 1), 0);
+        TEST_ASSERT_EQUAL((uint32_t)NS_STATUS_FAILURE,
+                          ns_pmu_mux_estimate(&mux, l, missed * 4, &value));
+        TEST_ASSERT_EQUAL(0, value);
+    }
+
+    // A second run starts on the other group and fills in the gaps
+    ns_pmu_mux_restart(&mux);
+    pm_run(layers, 4, 10);
+    ns_pmu_mux_stop(&mux);
+    for (uint32_t l = 0; l < 4; l++) {
+        for (uint32_t e = 0; e < 8; e++) {
+            pm_assert_estimate(l, e, 100 * (e + 1), e + 1);
+        }
+    }
+}
+
+void ns_pmu_mux_test_restart_averages_runs() {
+    // Estimates are per run, however many runs were accumulated
+    const uint32_t layers[] = {20000, 8000};
+    pm_setup(12, 4, 500);
+    for (uint32_t run = 0; run < 5; run++) {
+        if (run == 0) {
+            ns_pmu_mux_start(&mux);
+        } else {
+            ns_pmu_mux_restart(&mux);
+        }
+        pm_run(layers, 2, 333);
+        ns_pmu_mux_stop(&mux);
+    }
+
+    TEST_ASSERT_EQUAL(5, mux.runs);
+    for (uint32_t l = 0; l < 2; l++) {
+        TEST_ASSERT_EQUAL(layers[l], ns_pmu_mux_layer_cycles(&mux, l));
+        for (uint32_t e = 0; e < 12; e++) {
+            pm_assert_estimate(l, e, layers[l] * (e + 1), e + 1);
+        }
+    }
+
+    // Reset forgets everything
+    ns_pmu_mux_reset(&mux);
+    TEST_ASSERT_EQUAL(0, ns_pmu_mux_layer_cycles(&mux, 0));
+}
+
+void ns_pmu_mux_test_layer_overflow() {
+    const uint32_t layers[] = {1000, 1000, 1000, 1000};
+    pm_setup(4, 2, 0);
+    ns_pmu_mux_start(&mux);
+    TEST_ASSERT_EQUAL(0, ns_pmu_mux_layer_begin(&mux));
+    ns_pmu_mux_layer_end(&mux);
+    TEST_ASSERT_EQUAL(1, ns_pmu_mux_layer_begin(&mux));
+    ns_pmu_mux_layer_end(&mux);
+    TEST_ASSERT_EQUAL(2, ns_pmu_mux_layer_begin(&mux)); // out of storage
+    ns_pmu_mux_layer_end(&mux);
+    ns_pmu_mux_stop(&mux);
+
+    // Extra layers are dropped, not written past the buffers
+    ns_pmu_mux_restart(&mux);
+    pm_run(layers, 4, 0);
+    ns_pmu_mux_stop(&mux);
+    TEST_ASSERT_EQUAL(4, mux.numLayers);
+    pm_assert_estimate(1, 3, 1000 * 4 / 2, 0); // averaged with the empty first run
+
+    // Not running: layers are ignored
+    TEST_ASSERT_EQUAL(2, ns_pmu_mux_layer_begin(&mux));
+}
+
+void ns_pmu_mux_test_layer_samples() {
+    const uint32_t layers[] = {50};
+    ns_pmu_sample_t samples[PM_MAX_EVENTS];
+    pm_setup(6, 4, 100000);
+    for (uint32_t i = 0; i < 6; i++) {
+        eventIds[i] = 0x200 + i;
+    }
+    ns_pmu_mux_start(&mux);
+    pm_layer(layers[0]);
+    ns_pmu_mux_stop(&mux);
+
+    // Only the first group counted - the rest have no estimate
+    TEST_ASSERT_EQUAL(4, ns_pmu_mux_layer_samples(&mux, 0, samples));
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_HEX32(0x200 + i, samples[i].eventId);
+    }
+    TEST_ASSERT_EQUAL(0, ns_pmu_mux_layer_samples(&mux, 1, samples));
+}
+
+// Layer mapping as originally written in ns_get_layer_counters
+static bool reference_source_layer(uint32_t layer, uint32_t rv, int32_t call_once_layer,
+                                   uint32_t *source_layer) {
+    if (call_once_layer != -1 && (layer > (uint32_t)call_once_layer) &&
+        (layer <= (uint32_t)(call_once_layer + rv * 2))) {
+        return false;
+    }
+    *source_layer = layer;
+    if (call_once_layer != -1 && layer > (uint32_t)(call_once_layer + rv * 2)) {
+        *source_layer = layer - rv * 2;
+    }
+    return true;
+}
+
+void ns_pmu_mux_test_rerun_source_layer() {
+    uint32_t source, expected, slot;
+
+    for (uint32_t numLayers = 1; numLayers < 40; numLayers++) {
+        for (uint32_t rv = 0; rv * 2 < numLayers; rv++) {
+            for (int32_t callOnce = -1; callOnce < (int32_t)(numLayers - rv * 2); callOnce++) {
+                for (uint32_t layer = 0; layer < numLayers; layer++) {
+                    bool ref = reference_source_layer(layer, rv, callOnce, &expected);
+                    TEST_ASSERT_EQUAL(ref, ns_pmu_rerun_source_layer(layer, rv, callOnce, &source));
+                    if (ref) {
+                        TEST_ASSERT_EQUAL(expected, source);
+                        for (uint32_t mapIndex = 0; mapIndex < 9; mapIndex++) {
+                            uint32_t index =
+                                (numLayers + source) + (numLayers - rv * 2) * (mapIndex / 4);
+                            TEST_ASSERT_EQUAL(index, ns_pmu_rerun_snapshot_index(
+                                                         source, numLayers, rv, mapIndex, &slot));
+                            TEST_ASSERT_EQUAL(mapIndex % 4, slot);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#define PM_TRACE_MAX 512
+#define PM_TRACE_ENCODE(layer, mapIndex) (0x10000 + (layer) * 256 + (mapIndex))
+
+void ns_pmu_mux_test_rerun_snapshot_trace() {
+    // Build the snapshot array the way ns_characterize_model's rerun mode fills it - one full
+    // first run, then one run per group of 4 events in which the rv*2 layers after CALL_ONCE
+    // don't execute - and check every lookup lands on the right layer and event.
+    static uint32_t snapshot[PM_TRACE_MAX][4];
+    uint32_t source, slot;
+
+    for (uint32_t numLayers = 2; numLayers < 24; numLayers++) {
+        for (uint32_t rv = 0; rv * 2 < numLayers; rv++) {
+            for (int32_t callOnce = -1; callOnce < (int32_t)(numLayers - rv * 2); callOnce++) {
+                if (callOnce == -1 && rv != 0) {
+                    continue; // no CALL_ONCE, nothing is skipped
+                }
+                for (uint32_t mapSize = 1; mapSize <= 13; mapSize += 4) {
+                    uint32_t n = 0;
+                    memset(snapshot, 0xEE, sizeof(snapshot));
+                    n += numLayers; // first run
+
+                    for (uint32_t g = 0; g * 4 < mapSize; g++) {
+                        for (uint32_t layer = 0; layer < numLayers; layer++) {
+                            if (callOnce != -1 && layer > (uint32_t)callOnce &&
+                                layer <= (uint32_t)callOnce + rv * 2) {
+                                continue;
+                            }
+                            for (uint32_t s = 0; s < 4; s++) {
+                                snapshot[n][s] = PM_TRACE_ENCODE(layer, g * 4 + s);
+                            }
+                            n++;
+                        }
+                    }
+                    TEST_ASSERT_TRUE(n <= PM_TRACE_MAX);
+
+                    for (uint32_t layer = 0; layer < numLayers; layer++) {
+                        bool ran = ns_pmu_rerun_source_layer(layer, rv, callOnce, &source);
+                        bool skipped = callOnce != -1 && layer > (uint32_t)callOnce &&
+                                       layer <= (uint32_t)callOnce + rv * 2;
+                        TEST_ASSERT_EQUAL(!skipped, ran);
+                        if (!ran) {
+                            continue;
+                        }
+                        for (uint32_t m = 0; m < mapSize; m++) {
+                            uint32_t index =
+                                ns_pmu_rerun_snapshot_index(source, numLayers, rv, m, &slot);
+                            TEST_ASSERT_TRUE(index < n);
+                            TEST_ASSERT_EQUAL_HEX32(PM_TRACE_ENCODE(layer, m),
+                                                    snapshot[index][slot]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
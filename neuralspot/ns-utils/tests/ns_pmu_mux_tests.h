@@ -0,0 +1,13 @@
+#include "ns_pmu_mux.h"
+void ns_pmu_mux_tests_pre_test_hook();
+void ns_pmu_mux_tests_post_test_hook();
+void ns_pmu_mux_test_init_validation();
+void ns_pmu_mux_test_single_group();
+void ns_pmu_mux_test_extrapolation();
+void ns_pmu_mux_test_discard_between_layers();
+void ns_pmu_mux_test_short_layers_coverage();
+void ns_pmu_mux_test_restart_averages_runs();
+void ns_pmu_mux_test_layer_overflow();
+void ns_pmu_mux_test_layer_samples();
+void ns_pmu_mux_test_rerun_source_layer();
+void ns_pmu_mux_test_rerun_snapshot_trace();
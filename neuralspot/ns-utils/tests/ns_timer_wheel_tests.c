@@ -0,0 +1,363 @@
+#include "ns_timer_wheel_tests.h"
+#include "ns_core.h"
+#include "unity/unity.h"
+#include <string.h>
+
+// The wheel runs against a simulated counter: advancing virtual time delivers
+// the programmed alarm the way the timer interrupt would, optionally late.
+
+#define TW_TICKS_PER_US 6
+#define TW_RES_US 100
+#define TW_TICKS_PER_JIFFY (TW_RES_US * TW_TICKS_PER_US)
+#define TW_MANY 256
+#define TW_BEFORE(a, b) ((int32_t)((a) - (b)) < 0)
+
+typedef struct {
+    uint32_t fired;
+    uint32_t lastTick;
+    uint32_t firstTick;
+} tw_record_t;
+
+static uint32_t vclock;
+static uint32_t valarm;
+static bool valarmSet;
+static uint32_t vlatency; // ticks between the alarm and the service call
+
+static uint32_t tw_now(void *ctx) { return vclock; }
+
+static void tw_set_alarm(void *ctx, uint32_t tick) {
+    valarm = tick;
+    valarmSet = true;
+}
+
+static const ns_timer_wheel_port_t tw_port = {
+    .ticksPerUs = TW_TICKS_PER_US,
+    .now = tw_now,
+    .set_alarm = tw_set_alarm,
+};
+
+static ns_timer_wheel_t wheel;
+static ns_timer_wheel_timer_t timers[TW_MANY];
+static tw_record_t records[TW_MANY];
+static uint32_t lfsr;
+
+static uint32_t next_rand() {
+    lfsr ^= lfsr << 13;
+    lfsr ^= lfsr >> 17;
+    lfsr ^= lfsr << 5;
+    return lfsr;
+}
+
+static void tw_record_cb(ns_timer_wheel_timer_t *t, void *arg) {
+    tw_record_t *r = (tw_record_t *)arg;
+    if (r->fired == 0) {
+        r->firstTick = vclock;
+    }
+    r->fired++;
+    r->lastTick = vclock;
+}
+
+// Advance virtual time, servicing the wheel whenever the alarm comes due
+static void tw_advance_ticks(uint32_t ticks) {
+    uint32_t end = vclock + ticks;
+
+    while (valarmSet && !TW_BEFORE(end, valarm)) {
+        if (TW_BEFORE(vclock, valarm)) {
+            vclock = valarm;
+        }
+        vclock += vlatency;
+        valarmSet = false;
+        ns_timer_wheel_service(&wheel);
+    }
+    if (TW_BEFORE(vclock, end)) {
+        vclock = end;
+    }
+}
+
+static void tw_advance_us(uint32_t us) { tw_advance_ticks(us * TW_TICKS_PER_US); }
+
+static void tw_reset(uint32_t startTick) {
+    vclock = startTick;
+    valarmSet = false;
+    vlatency = 0;
+    memset(timers, 0, sizeof(timers));
+    memset(records, 0, sizeof(records));
+    for (int i = 0; i < TW_MANY; i++) {
+        timers[i].callback = tw_record_cb;
+        timers[i].arg = &records[i];
+    }
+    wheel.api = &ns_timer_wheel_V0_0_1;
+    wheel.resolutionUs = TW_RES_US;
+    wheel.port = &tw_port;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_wheel_init(&wheel));
+}
+
+void ns_timer_wheel_tests_pre_test_hook() { lfsr = 0x2545F491; }
+
+void ns_timer_wheel_tests_post_test_hook() {}
+
+void ns_timer_wheel_test_init_validation() {
+    ns_timer_wheel_port_t badPort = tw_port;
+    ns_core_api_t badApi = {.apiId = NS_TIMER_WHEEL_API_ID, .version = {9, 9, 9}};
+    ns_timer_wheel_t w = {.api = &ns_timer_wheel_V0_0_1, .resolutionUs = TW_RES_US};
+
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_timer_wheel_init(NULL));
+
+    w.port = &tw_port;
+    w.api = &badApi;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_VERSION, ns_timer_wheel_init(&w));
+
+    w.api = &ns_timer_wheel_V0_0_1;
+    w.port = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_timer_wheel_init(&w));
+
+    w.port = &badPort;
+    badPort.set_alarm = NULL;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_timer_wheel_init(&w));
+
+    badPort = tw_port;
+    w.resolutionUs = 0;
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_timer_wheel_init(&w));
+
+    w.resolutionUs = TW_RES_US;
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_wheel_init(&w));
+
+    // A timer needs a callback
+    ns_timer_wheel_timer_t t = {0};
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_CONFIG, ns_timer_wheel_start(&w, &t, 1000, 0));
+    TEST_ASSERT_EQUAL(NS_STATUS_INVALID_HANDLE, ns_timer_wheel_start(&w, NULL, 1000, 0));
+}
+
+void ns_timer_wheel_test_one_shot() {
+    tw_reset(1000);
+    uint32_t start = vclock;
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_wheel_start(&wheel, &timers[0], 2550, 0));
+    TEST_ASSERT_TRUE(ns_timer_wheel_active(&timers[0]));
+
+    tw_advance_us(2500);
+    TEST_ASSERT_EQUAL(0, records[0].fired);
+
+    tw_advance_us(10000);
+    TEST_ASSERT_EQUAL(1, records[0].fired);
+    TEST_ASSERT_FALSE(ns_timer_wheel_active(&timers[0]));
+
+    // Never early, and late by less than a jiffy
+    uint32_t late = records[0].firstTick - (start + 2550 * TW_TICKS_PER_US);
+    TEST_ASSERT_TRUE((int32_t)late >= 0);
+    TEST_ASSERT_TRUE(late < TW_TICKS_PER_JIFFY);
+}
+
+void ns_timer_wheel_test_periodic_no_drift() {
+    tw_reset(0);
+
+    // 1 ms period, first callback after 500 us
+    ns_timer_wheel_start(&wheel, &timers[0], 500, 1000);
+    tw_advance_us(500);
+    TEST_ASSERT_EQUAL(1, records[0].fired);
+    uint32_t first = records[0].firstTick;
+
+    // Service late by varying amounts; deadlines must stay on the 1 ms grid
+    for (int i = 1; i <= 1000; i++) {
+        vlatency = next_rand() % (300 * TW_TICKS_PER_US);
+        tw_advance_ticks(first + i * 1000 * TW_TICKS_PER_US - vclock);
+    }
+    TEST_ASSERT_EQUAL(1001, records[0].fired);
+
+    vlatency = 0;
+    uint32_t before = records[0].fired;
+    tw_advance_us(1000);
+    TEST_ASSERT_EQUAL(before + 1, records[0].fired);
+    TEST_ASSERT_EQUAL(0, (records[0].lastTick - first) % (1000 * TW_TICKS_PER_US));
+    TEST_ASSERT_EQUAL(0, timers[0].stats.missed);
+}
+
+void ns_timer_wheel_test_stop() {
+    tw_reset(0);
+
+    ns_timer_wheel_start(&wheel, &timers[0], 1000, 0);
+    ns_timer_wheel_start(&wheel, &timers[1], 1000, 0);
+    ns_timer_wheel_start(&wheel, &timers[2], 500000, 1000); // upper level slot
+    TEST_ASSERT_EQUAL(3, wheel.count);
+
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_wheel_stop(&wheel, &timers[0]));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_wheel_stop(&wheel, &timers[2]));
+    TEST_ASSERT_EQUAL(NS_STATUS_SUCCESS, ns_timer_wheel_stop(&wheel, &timers[2])); // harmless
+    TEST_ASSERT_FALSE(ns_timer_wheel_active(&timers[0]));
+    TEST_ASSERT_EQUAL(1, wheel.count);
+
+    tw_advance_us(1000000);
+    TEST_ASSERT_EQUAL(0, records[0].fired);
+    TEST_ASSERT_EQUAL(1, records[1].fired);
+    TEST_ASSERT_EQUAL(0, records[2].fired);
+    TEST_ASSERT_EQUAL(0, wheel.count);
+
+    // Restarting a running timer moves it
+    ns_timer_wheel_start(&wheel, &timers[3], 1000, 0);
+    ns_timer_wheel_start(&wheel, &timers[3], 5000, 0);
+    tw_advance_us(4000);
+    TEST_ASSERT_EQUAL(0, records[3].fired);
+    tw_advance_us(1000);
+    TEST_ASSERT_EQUAL(1, records[3].fired);
+}
+
+static int restart_count;
+
+static void tw_restart_cb(ns_timer_wheel_timer_t *t, void *arg) {
+    tw_record_cb(t, arg);
+    if (++restart_count < 5) {
+        ns_timer_wheel_start(&wheel, t, 0, 0); // next jiffy
+    }
+    // Stopping a timer due in the same jiffy keeps it from firing
+    ns_timer_wheel_stop(&wheel, &timers[1]);
+}
+
+void ns_timer_wheel_test_restart_from_callback() {
+    tw_reset(0);
+    restart_count = 0;
+    timers[0].callback = tw_restart_cb;
+
+    // Timers in a slot run newest first, so timers[0] runs before timers[1]
+    ns_timer_wheel_start(&wheel, &timers[1], 1000, 0);
+    ns_timer_wheel_start(&wheel, &timers[0], 1000, 0);
+    tw_advance_us(10000);
+
+    TEST_ASSERT_EQUAL(5, records[0].fired);
+    TEST_ASSERT_EQUAL(4 * TW_TICKS_PER_JIFFY, records[0].lastTick - records[0].firstTick);
+    TEST_ASSERT_EQUAL(0, records[1].fired);
+}
+
+static void tw_check_many(const uint32_t *startTick, const uint32_t *delayUs, int n) {
+    for (int i = 0; i < n; i++) {
+        uint32_t late = records[i].firstTick - (startTick[i] + delayUs[i] * TW_TICKS_PER_US);
+        TEST_ASSERT_EQUAL(1, records[i].fired);
+        TEST_ASSERT_TRUE((int32_t)late >= 0);
+        TEST_ASSERT_TRUE(late < TW_TICKS_PER_JIFFY);
+    }
+}
+
+void ns_timer_wheel_test_many_timers() {
+    static uint32_t startTick[TW_MANY];
+    static uint32_t delayUs[TW_MANY];
+
+    tw_reset(12345);
+
+    // Delays spread over all four levels, started at different times
+    for (int i = 0; i < TW_MANY; i++) {
+        uint32_t levelBits = 6 * ((i % 4) + 1);
+        uint32_t jiffies = next_rand() & ((1UL << levelBits) - 1);
+        delayUs[i] = jiffies * TW_RES_US + next_rand() % TW_RES_US;
+        startTick[i] = vclock;
+        ns_timer_wheel_start(&wheel, &timers[i], delayUs[i], 0);
+        tw_advance_ticks(next_rand() % 5000);
+    }
+    TEST_ASSERT_TRUE(wheel.count > 0);
+
+    // Longest delay is ~28 minutes, several counter wraps at 6 MHz
+    for (int i = 0; i < 10; i++) {
+        tw_advance_ticks(1000000000);
+    }
+    TEST_ASSERT_EQUAL(0, wheel.count);
+    TEST_ASSERT_TRUE(wheel.stats.cascades > 0);
+    tw_check_many(startTick, delayUs, TW_MANY);
+}
+
+void ns_timer_wheel_test_counter_wrap() {
+    tw_reset(0xFFFFFFFF - 3000 * TW_TICKS_PER_US);
+    uint32_t start = vclock;
+
+    ns_timer_wheel_start(&wheel, &timers[0], 1000, 1000);
+    tw_advance_us(10000);
+    TEST_ASSERT_EQUAL(10, records[0].fired);
+    TEST_ASSERT_EQUAL(start + 10000 * TW_TICKS_PER_US, records[0].lastTick);
+
+    // An idle wheel doesn't follow the counter; starting again resyncs
+    ns_timer_wheel_stop(&wheel, &timers[0]);
+    tw_advance_ticks(0xF0000000);
+    tw_advance_ticks(0xF0000000);
+    start = vclock;
+    ns_timer_wheel_start(&wheel, &timers[1], 700, 0);
+    tw_advance_us(1000);
+    TEST_ASSERT_EQUAL(1, records[1].fired);
+    TEST_ASSERT_EQUAL(start + 700 * TW_TICKS_PER_US, records[1].firstTick);
+}
+
+void ns_timer_wheel_test_tickless() {
+    tw_reset(0);
+
+    // Idle wheel: nothing programmed
+    ns_timer_wheel_service(&wheel);
+    TEST_ASSERT_FALSE(valarmSet);
+
+    // 10 ms sensor poll, 1 s watchdog and a one-shot far off in an upper level
+    ns_timer_wheel_start(&wheel, &timers[0], 10000, 10000);
+    ns_timer_wheel_start(&wheel, &timers[1], 1000000, 1000000);
+    ns_timer_wheel_start(&wheel, &timers[2], 3333300, 0);
+    ns_timer_wheel_stats_reset(&wheel, NULL);
+
+    tw_advance_us(5000000);
+    TEST_ASSERT_EQUAL(500, records[0].fired);
+    TEST_ASSERT_EQUAL(5, records[1].fired);
+    TEST_ASSERT_EQUAL(1, records[2].fired);
+
+    // The watchdog always coincides with a poll, the one-shot doesn't, and
+    // cascading never needs a wakeup of its own
+    TEST_ASSERT_EQUAL(501, wheel.stats.services);
+    TEST_ASSERT_EQUAL(506, wheel.stats.fired);
+}
+
+void ns_timer_wheel_test_next_deadline() {
+    tw_reset(0);
+    TEST_ASSERT_EQUAL(UINT32_MAX, ns_timer_wheel_next_deadline_us(&wheel));
+
+    ns_timer_wheel_start(&wheel, &timers[0], 750000, 0);
+    ns_timer_wheel_start(&wheel, &timers[1], 90000, 0);
+    TEST_ASSERT_EQUAL(90000, ns_timer_wheel_next_deadline_us(&wheel));
+    TEST_ASSERT_EQUAL(90000 * TW_TICKS_PER_US, valarm);
+
+    tw_advance_us(100000);
+    TEST_ASSERT_EQUAL(650000, ns_timer_wheel_next_deadline_us(&wheel));
+    TEST_ASSERT_EQUAL(750000 * TW_TICKS_PER_US, valarm);
+
+    ns_timer_wheel_stop(&wheel, &timers[0]);
+    TEST_ASSERT_EQUAL(UINT32_MAX, ns_timer_wheel_next_deadline_us(&wheel));
+}
+
+void ns_timer_wheel_test_latency_jitter_stats() {
+    tw_reset(0);
+    ns_timer_wheel_start(&wheel, &timers[0], 1000, 1000);
+
+    vlatency = 20 * TW_TICKS_PER_US;
+    tw_advance_us(1000);
+    vlatency = 50 * TW_TICKS_PER_US;
+    tw_advance_us(1000);
+    vlatency = 10 * TW_TICKS_PER_US;
+    tw_advance_us(1000);
+
+    TEST_ASSERT_EQUAL(3, timers[0].stats.fired);
+    TEST_ASSERT_EQUAL(50, timers[0].stats.latencyMaxUs);
+    TEST_ASSERT_EQUAL(80, timers[0].stats.latencySumUs);
+    TEST_ASSERT_EQUAL(40, timers[0].stats.jitterMaxUs); // 50 us late, then 10 us late
+    TEST_ASSERT_EQUAL(50, wheel.stats.latencyMaxUs);
+
+    ns_timer_wheel_stats_reset(&wheel, &timers[0]);
+    TEST_ASSERT_EQUAL(0, timers[0].stats.fired);
+    TEST_ASSERT_EQUAL(0, wheel.stats.latencyMaxUs);
+}
+
+void ns_timer_wheel_test_missed_periods() {
+    tw_reset(0);
+    ns_timer_wheel_start(&wheel, &timers[0], 1000, 1000);
+
+    // The interrupt is held off for 3.5 periods
+    vlatency = 3500 * TW_TICKS_PER_US;
+    tw_advance_us(1000);
+    TEST_ASSERT_EQUAL(1, records[0].fired);
+    TEST_ASSERT_EQUAL(3, timers[0].stats.missed);
+
+    // Back on the original grid
+    vlatency = 0;
+    tw_advance_us(1000);
+    TEST_ASSERT_EQUAL(2, records[0].fired);
+    TEST_ASSERT_EQUAL(5000 * TW_TICKS_PER_US, records[0].lastTick);
+}
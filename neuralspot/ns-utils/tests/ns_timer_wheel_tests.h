@@ -0,0 +1,14 @@
+#include "ns_timer_wheel.h"
+void ns_timer_wheel_tests_pre_test_hook();
+void ns_timer_wheel_tests_post_test_hook();
+void ns_timer_wheel_test_init_validation();
+void ns_timer_wheel_test_one_shot();
+void ns_timer_wheel_test_periodic_no_drift();
+void ns_timer_wheel_test_stop();
+void ns_timer_wheel_test_restart_from_callback();
+void ns_timer_wheel_test_many_timers();
+void ns_timer_wheel_test_counter_wrap();
+void ns_timer_wheel_test_tickless();
+void ns_timer_wheel_test_next_deadline();
+void ns_timer_wheel_test_latency_jitter_stats();
+void ns_timer_wheel_test_missed_periods();
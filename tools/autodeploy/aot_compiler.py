@@ -0,0 +1,817 @@
+"""
+Ahead-of-time model compiler
+
+Turns an int8 .tflite model into C code that calls CMSIS-NN kernels directly,
+as an alternative to running it through the TFLM MicroInterpreter. Everything
+the interpreter works out at init time is done here instead:
+
+- tensor placement: activations are planned into one arena, greedily by size,
+  reusing memory between tensors whose lifetimes don't overlap
+- per-op constants: requantization multipliers/shifts, padding, activation
+  ranges and kernel dimensions are emitted as const structs
+- dispatch: invoke is a straight sequence of kernel calls, no op resolver
+
+The generated code implements ns_aot_model_t (see ns-model/includes-api/ns_aot_model.h).
+Quantization parameters are derived exactly as TFLM's CMSIS-NN kernels derive
+them, so outputs are bit-exact with TFLM.
+
+Usage:
+    python -m neuralspot.tools.autodeploy.aot_compiler --tflite-filename kws.tflite --model-name kws
+
+To check bit-exactness on the host against the TFLite reference kernels, point
+--verify-cmsis-nn at a CMSIS-NN source tree (the directory containing Include/ and Source/).
+"""
+
+import argparse
+import array
+import glob
+import logging as log
+import math
+import os
+import struct
+import subprocess
+import tempfile
+
+from neuralspot.tools.utils.tflite_helpers import BuiltinCodeToName, CreateDictFromFlatbuffer
+
+TENSOR_TYPE_INT32 = 2
+TENSOR_TYPE_INT8 = 9
+
+PADDING_SAME = 0
+
+ACT_NONE = 0
+ACT_RELU = 1
+ACT_RELU_N1_TO_1 = 2
+ACT_RELU6 = 3
+
+ARENA_ALIGNMENT = 16
+
+# CMSIS-NN depthwise kernels process channels in blocks of this size on Helium
+CH_IN_BLOCK_MVE = 124
+
+
+class AotCompileError(Exception):
+    pass
+
+
+# ----------------------------------------------------------------------------
+#   Quantization helpers - these mirror tensorflow/lite/kernels/internal/quantization_util.cc
+#   and the TFLM kernel Prepare() functions, including their float/double precision
+# ----------------------------------------------------------------------------
+def _f32(x):
+    """Round a python float to float32, as C++ does for float expressions"""
+    return struct.unpack("<f", struct.pack("<f", x))[0]
+
+
+def _round(x):
+    """std::round - halfway cases away from zero"""
+    return int(math.copysign(math.floor(abs(x) + 0.5), x))
+
+
+def quantize_multiplier(real_multiplier):
+    """Split a real multiplier into a Q31 multiplier and a power-of-two shift"""
+    if real_multiplier == 0.0:
+        return 0, 0
+    q, shift = math.frexp(real_multiplier)
+    q_fixed = _round(q * (1 << 31))
+    if q_fixed == (1 << 31):
+        q_fixed //= 2
+        shift += 1
+    if shift < -31:
+        shift = 0
+        q_fixed = 0
+    if shift > 30:
+        shift = 30
+        q_fixed = (1 << 31) - 1
+    return q_fixed, shift
+
+
+def activation_range(activation, scale, zero_point):
+    """CalculateActivationRangeQuantized for int8 outputs"""
+
+    def quantize(f):
+        return zero_point + _round(_f32(f / scale))
+
+    qmin, qmax = -128, 127
+    if activation == ACT_NONE:
+        return qmin, qmax
+    if activation == ACT_RELU:
+        return max(qmin, quantize(0.0)), qmax
+    if activation == ACT_RELU6:
+        return max(qmin, quantize(0.0)), min(qmax, quantize(6.0))
+    if activation == ACT_RELU_N1_TO_1:
+        return max(qmin, quantize(-1.0)), min(qmax, quantize(1.0))
+    raise AotCompileError(f"Unsupported fused activation {activation}")
+
+
+def compute_padding(stride, dilation, in_size, filter_size, out_size):
+    effective_filter = (filter_size - 1) * dilation + 1
+    total = max((out_size - 1) * stride + effective_filter - in_size, 0)
+    return total // 2
+
+
+# ----------------------------------------------------------------------------
+#   Model parsing
+# ----------------------------------------------------------------------------
+class Tensor:
+    def __init__(self, index, t, buffers):
+        self.index = index
+        self.name = t.get("name") or f"t{index}"
+        if isinstance(self.name, (bytes, list)):
+            self.name = bytes(self.name).decode()  # CreateDictFromFlatbuffer gives a list of bytes
+        self.shape = list(t.get("shape") or [])
+        self.type = t["type"]
+        q = t.get("quantization") or {}
+        self.scales = list(q.get("scale") or [])
+        self.zero_points = list(q.get("zero_point") or [])
+        self.scale = self.scales[0] if self.scales else 0.0
+        self.zero_point = self.zero_points[0] if self.zero_points else 0
+        data = buffers[t["buffer"]].get("data") if t.get("buffer") else None
+        self.data = bytes(bytearray(data)) if data is not None and len(data) else None
+        self.elements = 1
+        for d in self.shape:
+            self.elements *= d
+        self.bytes = self.elements * (4 if self.type == TENSOR_TYPE_INT32 else 1)
+
+    @property
+    def is_constant(self):
+        return self.data is not None
+
+
+def _nhwc(shape):
+    """Pad a shape out to NHWC the way TFLM's kernels view it"""
+    if len(shape) == 4:
+        return shape
+    if len(shape) == 3:
+        return [1] + shape
+    if len(shape) == 2:
+        return [shape[0], 1, 1, shape[1]]
+    raise AotCompileError(f"Can't view shape {shape} as NHWC")
+
+
+class Op:
+    def __init__(self, index, kind, inputs, outputs, options):
+        self.index = index
+        self.kind = kind
+        self.inputs = inputs
+        self.outputs = outputs
+        self.options = options or {}
+        self.scratch = 0  # upper bound of CMSIS-NN scratch bytes
+        self.persistent = 0  # bytes kept across invokes (FC kernel sums)
+        self.persistent_offset = 0
+
+
+class AotModel:
+    SUPPORTED = (
+        "CONV_2D",
+        "DEPTHWISE_CONV_2D",
+        "FULLY_CONNECTED",
+        "AVERAGE_POOL_2D",
+        "MAX_POOL_2D",
+        "SOFTMAX",
+        "ADD",
+        "RESHAPE",
+    )
+
+    def __init__(self, model_dict):
+        if len(model_dict["subgraphs"]) != 1:
+            raise AotCompileError("Only single-subgraph models are supported")
+        sg = model_dict["subgraphs"][0]
+        buffers = model_dict["buffers"]
+        self.tensors = [Tensor(i, t, buffers) for i, t in enumerate(sg["tensors"])]
+        self.inputs = list(sg["inputs"])
+        self.outputs = list(sg["outputs"])
+
+        self.ops = []
+        for i, o in enumerate(sg["operators"]):
+            code = model_dict["operator_codes"][o.get("opcode_index", 0)]
+            builtin = max(code.get("builtin_code", 0), code.get("deprecated_builtin_code", 0))
+            kind = BuiltinCodeToName(builtin)
+            if kind not in self.SUPPORTED:
+                raise AotCompileError(f"Op {i} ({kind}) is not supported by the AOT compiler")
+            self.ops.append(Op(i, kind, list(o["inputs"]), list(o["outputs"]), o.get("builtin_options")))
+
+        for t in self.inputs + self.outputs:
+            if self.tensors[t].type != TENSOR_TYPE_INT8:
+                raise AotCompileError(f"Tensor {self.tensors[t].name} is not int8")
+
+        # RESHAPE doesn't move data, so its output shares its input's memory
+        self.alias = {}
+        for op in self.ops:
+            if op.kind == "RESHAPE":
+                if self.t(op.inputs[0]).is_constant:
+                    raise AotCompileError(f"Op {op.index}: RESHAPE of a constant is not supported")
+                self.alias[op.outputs[0]] = self._root(op.inputs[0])
+
+    def _root(self, t):
+        while t in self.alias:
+            t = self.alias[t]
+        return t
+
+    def t(self, index):
+        return self.tensors[index]
+
+    # ------------------------------------------------------------------
+    #   Memory planning
+    # ------------------------------------------------------------------
+    def plan_activations(self):
+        """Assign arena offsets to activations"""
+        first, last = {}, {}
+
+        def touch(t, i):
+            r = self._root(t)
+            first[r] = min(first.get(r, i), i)
+            last[r] = max(last.get(r, i), i)
+
+        for t in self.inputs:
+            touch(t, -1)
+        for t in self.outputs:
+            touch(t, len(self.ops))
+        for op in self.ops:
+            for t in op.inputs:
+                if t >= 0 and not self.t(t).is_constant:
+                    touch(t, op.index)
+            for t in op.outputs:
+                touch(t, op.index)
+
+        # Greedy by size: biggest tensors first, each at the lowest offset that
+        # doesn't collide with an already-placed tensor that is live at the same time
+        self.offsets = {}
+        placed = []
+        for r in sorted(first, key=lambda r: (-self.t(r).bytes, first[r])):
+            size = _align(self.t(r).bytes)
+            offset = 0
+            for o, s, f, l in sorted(placed):
+                if l < first[r] or f > last[r]:
+                    continue
+                if offset + size <= o:
+                    break
+                offset = max(offset, o + s)
+            placed.append((offset, size, first[r], last[r]))
+            self.offsets[r] = offset
+
+        self.activation_size = max([o + s for o, s, _, _ in placed] + [0])
+
+    def plan_buffers(self):
+        """Place the shared kernel scratch and per-op persistent buffers after the activations"""
+        self.scratch_offset = _align(self.activation_size)
+        self.scratch_size = _align(max([op.scratch for op in self.ops] + [0]))
+        p = self.scratch_offset + self.scratch_size
+        for op in self.ops:
+            if op.persistent:
+                op.persistent_offset = p
+                p += _align(op.persistent)
+        self.arena_size = p
+
+    def offset(self, t):
+        return self.offsets[self._root(t)]
+
+
+def _align(n):
+    return (n + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1)
+
+
+# ----------------------------------------------------------------------------
+#   C emission
+# ----------------------------------------------------------------------------
+class Emitter:
+    def __init__(self, model, name):
+        self.m = model
+        self.name = name
+        self.consts = []  # weight/bias/quant arrays
+        self.params = []  # per-op const structs
+        self.init_checks = []  # (buffer size expression, bytes reserved)
+        self.init_sums = []
+        self.calls = []
+        self.weights = {}  # tensor index -> C symbol
+
+    # -- helpers -------------------------------------------------------
+    def sym(self, s):
+        return f"{self.name}_{s}"
+
+    def dims(self, label, n, h, w, c):
+        s = self.sym(label)
+        self.params.append(
+            f"static const cmsis_nn_dims {s} = {{.n = {n}, .h = {h}, .w = {w}, .c = {c}}};"
+        )
+        return s
+
+    def array(self, label, ctype, values):
+        s = self.sym(label)
+        body = _wrap(", ".join(str(v) for v in values))
+        self.consts.append(
+            f"static const {ctype} {s}[{len(values)}] __attribute__((aligned(16))) = {{\n{body}}};"
+        )
+        return s
+
+    def weight(self, t, ctype):
+        if t < 0:
+            return "NULL"
+        if t not in self.weights:
+            fmt = "b" if ctype == "int8_t" else "i"
+            values = array.array(fmt)
+            values.frombytes(self.m.t(t).data)
+            self.weights[t] = self.array(f"const{len(self.weights)}", ctype, values.tolist())
+        return self.weights[t]
+
+    def act(self, t):
+        return f"&arena[{self.m.offset(t)}]"
+
+    def scratch(self):
+        return f"{self.name}_AOT_SCRATCH_SIZE"
+
+    # -- ops -----------------------------------------------------------
+    def emit(self):
+        for op in self.m.ops:
+            if op.kind == "RESHAPE":
+                continue
+            getattr(self, "op_" + op.kind.lower())(op)
+
+    def _conv_common(self, op, depthwise):
+        i, f, o = self.m.t(op.inputs[0]), self.m.t(op.inputs[1]), self.m.t(op.outputs[0])
+        bias = op.inputs[2] if len(op.inputs) > 2 else -1
+        opt = op.options
+        n, ih, iw, ic = _nhwc(i.shape)
+        _, oh, ow, oc = _nhwc(o.shape)
+        fh, fw = f.shape[1], f.shape[2]
+        sh, sw = opt.get("stride_h", 1), opt.get("stride_w", 1)
+        dh, dw = opt.get("dilation_h_factor", 1), opt.get("dilation_w_factor", 1)
+        if opt.get("padding", PADDING_SAME) == PADDING_SAME:
+            ph = compute_padding(sh, dh, ih, fh, oh)
+            pw = compute_padding(sw, dw, iw, fw, ow)
+        else:
+            ph = pw = 0
+        if f.type != TENSOR_TYPE_INT8 or any(z != 0 for z in f.zero_points):
+            raise AotCompileError(f"Op {op.index}: only symmetric int8 filters are supported")
+        if bias >= 0 and self.m.t(bias).type != TENSOR_TYPE_INT32:
+            raise AotCompileError(f"Op {op.index}: only int32 bias is supported")
+
+        act_min, act_max = activation_range(
+            opt.get("fused_activation_function", ACT_NONE), o.scale, o.zero_point
+        )
+        mults, shifts = [], []
+        for c in range(oc):
+            fs = f.scales[c] if len(f.scales) > 1 else f.scales[0]
+            m, s = quantize_multiplier(i.scale * fs / o.scale)
+            mults.append(m)
+            shifts.append(s)
+
+        k = op.index
+        mult = self.array(f"mult{k}", "int32_t", mults)
+        shift = self.array(f"shift{k}", "int32_t", shifts)
+        q = self.sym(f"quant{k}")
+        self.params.append(
+            f"static const cmsis_nn_per_channel_quant_params {q} = {{.multiplier = (int32_t *){mult}, "
+            f".shift = (int32_t *){shift}}};"
+        )
+        p = self.sym(f"params{k}")
+        fields = (
+            f".input_offset = {-i.zero_point}, .output_offset = {o.zero_point}, "
+            + (f".ch_mult = {oc // ic}, " if depthwise else "")
+            + f".stride = {{.w = {sw}, .h = {sh}}}, .padding = {{.w = {pw}, .h = {ph}}}, "
+            f".dilation = {{.w = {dw}, .h = {dh}}}, .activation = {{.min = {act_min}, .max = {act_max}}}"
+        )
+        ptype = "cmsis_nn_dw_conv_params" if depthwise else "cmsis_nn_conv_params"
+        self.params.append(f"static const {ptype} {p} = {{{fields}}};")
+
+        in_d = self.dims(f"in{k}", n, ih, iw, ic)
+        if depthwise:
+            f_d = self.dims(f"filter{k}", 1, fh, fw, oc)
+            # Helium processes channel blocks of im2col rows; DSP builds need one int16 im2col row
+            op.scratch = max(4 * CH_IN_BLOCK_MVE * fh * fw, 2 * ic * fh * fw)
+        else:
+            f_d = self.dims(f"filter{k}", oc, fh, fw, ic)
+            # Worst case over the conv kernels the wrapper can pick (4 im2col rows on Helium,
+            # 2 int16 rows on DSP)
+            op.scratch = 4 * 2 * fh * fw * ic
+        b_d = self.dims(f"bias_dims{k}", 1, 1, 1, oc)
+        o_d = self.dims(f"out{k}", n, oh, ow, oc)
+        w = self.weight(op.inputs[1], "int8_t")
+        b = self.weight(bias, "int32_t")
+
+        kernel = "arm_depthwise_conv_wrapper_s8" if depthwise else "arm_convolve_wrapper_s8"
+        self.init_checks.append(
+            (f"{kernel}_get_buffer_size(&{p}, &{in_d}, &{f_d}, &{o_d})", self.scratch())
+        )
+        self.calls.append(
+            (
+                op,
+                f"{kernel}(&ctx, NS_AOT_WEIGHT_SUM_ARG(&weight_sum) &{p}, &{q}, &{in_d}, "
+                f"(const int8_t *){self.act(op.inputs[0])}, &{f_d}, {w}, &{b_d}, {b}, &{o_d}, "
+                f"(int8_t *){self.act(op.outputs[0])})",
+                True,
+            )
+        )
+
+    def op_conv_2d(self, op):
+        self._conv_common(op, depthwise=False)
+
+    def op_depthwise_conv_2d(self, op):
+        self._conv_common(op, depthwise=True)
+
+    def op_fully_connected(self, op):
+        i, f, o = self.m.t(op.inputs[0]), self.m.t(op.inputs[1]), self.m.t(op.outputs[0])
+        bias = op.inputs[2] if len(op.inputs) > 2 else -1
+        if len(f.scales) > 1:
+            raise AotCompileError(f"Op {op.index}: per-channel fully connected is not supported")
+        if f.type != TENSOR_TYPE_INT8 or f.zero_point != 0:
+            raise AotCompileError(f"Op {op.index}: only symmetric int8 filters are supported")
+        out_depth, accum_depth = f.shape[0], f.shape[-1]
+        batches = o.elements // out_depth
+
+        # TFLM multiplies the two float scales before widening to double
+        m, s = quantize_multiplier(_f32(i.scale * f.scale) / o.scale)
+        act_min, act_max = activation_range(
+            op.options.get("fused_activation_function", ACT_NONE), o.scale, o.zero_point
+        )
+        k = op.index
+        p = self.sym(f"params{k}")
+        self.params.append(
+            f"static const cmsis_nn_fc_params {p} = {{.input_offset = {-i.zero_point}, "
+            f".filter_offset = {-f.zero_point}, .output_offset = {o.zero_point}, "
+            f".activation = {{.min = {act_min}, .max = {act_max}}}}};"
+        )
+        q = self.sym(f"quant{k}")
+        self.params.append(
+            f"static const cmsis_nn_per_tensor_quant_params {q} = {{.multiplier = {m}, .shift = {s}}};"
+        )
+        in_d = self.dims(f"in{k}", batches, 1, 1, accum_depth)
+        f_d = self.dims(f"filter{k}", accum_depth, 1, 1, out_depth)
+        b_d = self.dims(f"bias_dims{k}", 1, 1, 1, out_depth)
+        o_d = self.dims(f"out{k}", batches, 1, 1, out_depth)
+        w = self.weight(op.inputs[1], "int8_t")
+        b = self.weight(bias, "int32_t")
+
+        # Helium kernels fold the input offset and bias into per-row kernel sums,
+        # computed once at init like TFLM does in Prepare()
+        op.persistent = 4 * out_depth
+        sums = f"&arena[{op.persistent_offset}]"
+        self.init_checks.append((f"arm_fully_connected_s8_get_buffer_size(&{f_d})", op.persistent))
+        self.init_sums.append(
+            f"    if (arm_fully_connected_s8_get_buffer_size(&{f_d}) > 0) {{\n"
+            f"        arm_vector_sum_s8((int32_t *){sums}, {accum_depth}, {out_depth}, {w}, "
+            f"{-i.zero_point}, {-f.zero_point}, {b});\n"
+            f"    }}"
+        )
+        self.calls.append(
+            (
+                op,
+                f"arm_fully_connected_s8(&(cmsis_nn_context){{.buf = {sums}, .size = {op.persistent}}}, "
+                f"&{p}, &{q}, &{in_d}, (const int8_t *){self.act(op.inputs[0])}, &{f_d}, {w}, "
+                f"&{b_d}, {b}, &{o_d}, (int8_t *){self.act(op.outputs[0])})",
+                True,
+            )
+        )
+
+    def _pool(self, op, kernel):
+        i, o = self.m.t(op.inputs[0]), self.m.t(op.outputs[0])
+        opt = op.options
+        n, ih, iw, c = _nhwc(i.shape)
+        _, oh, ow, _ = _nhwc(o.shape)
+        fh, fw = opt["filter_height"], opt["filter_width"]
+        sh, sw = opt.get("stride_h", 1), opt.get("stride_w", 1)
+        if opt.get("padding", PADDING_SAME) == PADDING_SAME:
+            ph = compute_padding(sh, 1, ih, fh, oh)
+            pw = compute_padding(sw, 1, iw, fw, ow)
+        else:
+            ph = pw = 0
+        act_min, act_max = activation_range(
+            opt.get("fused_activation_function", ACT_NONE), o.scale, o.zero_point
+        )
+        k = op.index
+        p = self.sym(f"params{k}")
+        self.params.append(
+            f"static const cmsis_nn_pool_params {p} = {{.stride = {{.w = {sw}, .h = {sh}}}, "
+            f".padding = {{.w = {pw}, .h = {ph}}}, .activation = {{.min = {act_min}, .max = {act_max}}}}};"
+        )
+        in_d = self.dims(f"in{k}", n, ih, iw, c)
+        f_d = self.dims(f"filter{k}", 1, fh, fw, 1)
+        o_d = self.dims(f"out{k}", n, oh, ow, c)
+        if kernel == "arm_avgpool_s8":
+            op.scratch = 4 * c
+            self.init_checks.append((f"arm_avgpool_s8_get_buffer_size({ow}, {c})", self.scratch()))
+        self.calls.append(
+            (
+                op,
+                f"{kernel}(&ctx, &{p}, &{in_d}, (const int8_t *){self.act(op.inputs[0])}, &{f_d}, "
+                f"&{o_d}, (int8_t *){self.act(op.outputs[0])})",
+                True,
+            )
+        )
+
+    def op_average_pool_2d(self, op):
+        self._pool(op, "arm_avgpool_s8")
+
+    def op_max_pool_2d(self, op):
+        self._pool(op, "arm_max_pool_s8")
+
+    def op_softmax(self, op):
+        i, o = self.m.t(op.inputs[0]), self.m.t(op.outputs[0])
+        if o.zero_point != -128 or o.scale != _f32(1.0 / 256):
+            raise AotCompileError(f"Op {op.index}: softmax output must be scale 1/256, zero point -128")
+        integer_bits = 5
+        beta = op.options.get("beta", 1.0)
+        real = min(beta * i.scale * (1 << (31 - integer_bits)), (1 << 31) - 1.0)
+        mult, shift = quantize_multiplier(real)
+        radius = math.floor(
+            1.0 * ((1 << integer_bits) - 1) * (1 << (31 - integer_bits)) / (1 << shift)
+        )
+        row_size = i.shape[-1]
+        rows = i.elements // row_size
+        self.calls.append(
+            (
+                op,
+                f"arm_softmax_s8((const int8_t *){self.act(op.inputs[0])}, {rows}, {row_size}, "
+                f"{mult}, {shift}, {-radius}, (int8_t *){self.act(op.outputs[0])})",
+                False,
+            )
+        )
+
+    def op_add(self, op):
+        a, b, o = self.m.t(op.inputs[0]), self.m.t(op.inputs[1]), self.m.t(op.outputs[0])
+        if a.shape != b.shape or a.is_constant or b.is_constant:
+            raise AotCompileError(f"Op {op.index}: broadcast/constant ADD is not supported")
+        left_shift = 20
+        twice_max = 2 * max(a.scale, b.scale)
+        m1, s1 = quantize_multiplier(a.scale / twice_max)
+        m2, s2 = quantize_multiplier(b.scale / twice_max)
+        mo, so = quantize_multiplier(twice_max / _f32((1 << left_shift) * o.scale))
+        act_min, act_max = activation_range(
+            op.options.get("fused_activation_function", ACT_NONE), o.scale, o.zero_point
+        )
+        self.calls.append(
+            (
+                op,
+                f"arm_elementwise_add_s8((const int8_t *){self.act(op.inputs[0])}, "
+                f"(const int8_t *){self.act(op.inputs[1])}, {-a.zero_point}, {m1}, {s1}, "
+                f"{-b.zero_point}, {m2}, {s2}, {left_shift}, (int8_t *){self.act(op.outputs[0])}, "
+                f"{o.zero_point}, {mo}, {so}, {act_min}, {act_max}, {o.elements})",
+                True,
+            )
+        )
+
+    # -- output --------------------------------------------------------
+    def render(self):
+        n = self.name
+        N = n.upper()
+        m = self.m
+
+        def tensor_list(indices):
+            return ",\n".join(
+                f"    {{.offset = {m.offset(t)}, .bytes = {m.t(t).bytes}, "
+                f".scale = {m.t(t).scale!r}f, .zero_point = {m.t(t).zero_point}}}"
+                for t in indices
+            )
+
+        checks = "\n".join(
+            f"    if ({expr} > {limit}) {{\n        return -1;\n    }}" for expr, limit in self.init_checks
+        )
+
+        body = []
+        for op, call, returns_status in self.calls:
+            body.append(f"    // {op.index}: {op.kind} -> {m.t(op.outputs[0]).name}")
+            if not returns_status:
+                body.append(f"    {call};")
+            else:
+                body.append(f"    if ({call} != ARM_CMSIS_NN_SUCCESS) {{")
+                body.append(f"        return {op.index + 1};")
+                body.append("    }")
+        body = "\n".join(body)
+
+        c = f"""/**
+ * @file {n}_aot.c
+ * @brief Generated by aot_compiler.py - {len(m.ops)} ops compiled to direct CMSIS-NN calls
+ *
+ * Arena layout ({m.arena_size} bytes):
+ *   [0, {m.activation_size}) activations
+ *   [{m.scratch_offset}, {m.scratch_offset + m.scratch_size}) kernel scratch
+ *   [{m.scratch_offset + m.scratch_size}, {m.arena_size}) persistent kernel sums
+ */
+
+#include "{n}_aot.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(NS_TF_VERSION_Oct_08_2024_e86d97b6)
+    #include "cmsis_nn/Include/arm_nnfunctions.h"
+#else
+    #include "ns_cmsis_nn/Include/arm_nnfunctions.h"
+#endif
+
+#define {n}_AOT_SCRATCH_OFFSET {m.scratch_offset}
+#define {n}_AOT_SCRATCH_SIZE {m.scratch_size}
+
+// Weights, biases and requantization constants
+{chr(10).join(self.consts)}
+
+// Per-op parameters
+{chr(10).join(self.params)}
+
+static const ns_aot_tensor_t {n}_aot_inputs[{len(m.inputs)}] = {{
+{tensor_list(m.inputs)}}};
+
+static const ns_aot_tensor_t {n}_aot_outputs[{len(m.outputs)}] = {{
+{tensor_list(m.outputs)}}};
+
+static int {n}_aot_init(uint8_t *arena, uint32_t arena_size) {{
+    if (arena_size < {n}_AOT_ARENA_SIZE) {{
+        return -1;
+    }}
+
+    // The plan reserves a worst-case scratch size; check the kernels picked for this core fit
+{checks}
+
+{chr(10).join(self.init_sums)}
+    return 0;
+}}
+
+static int {n}_aot_invoke(uint8_t *arena) {{
+    cmsis_nn_context ctx = {{.buf = &arena[{n}_AOT_SCRATCH_OFFSET], .size = {n}_AOT_SCRATCH_SIZE}};
+#if defined(NS_TF_VERSION_helios_rt_v1_2_0)
+    cmsis_nn_context weight_sum = {{.buf = NULL, .size = 0}};
+#endif
+
+{body}
+    return 0;
+}}
+
+const ns_aot_model_t {n}_aot_model = {{
+    .name = "{n}",
+    .arena_size = {n}_AOT_ARENA_SIZE,
+    .num_inputs = {len(m.inputs)},
+    .num_outputs = {len(m.outputs)},
+    .inputs = {n}_aot_inputs,
+    .outputs = {n}_aot_outputs,
+    .init = {n}_aot_init,
+    .invoke = {n}_aot_invoke,
+}};
+"""
+        h = f"""/**
+ * @file {n}_aot.h
+ * @brief Generated by aot_compiler.py
+ */
+
+#ifndef {N}_AOT_H
+#define {N}_AOT_H
+#ifdef __cplusplus
+extern "C" {{
+#endif
+
+#include "ns_aot_model.h"
+
+#define {n}_AOT_ARENA_SIZE {m.arena_size}
+
+extern const ns_aot_model_t {n}_aot_model;
+
+#ifdef __cplusplus
+}}
+#endif
+#endif // {N}_AOT_H
+"""
+        return c, h
+
+
+def _wrap(text, width=96):
+    lines, line = [], "    "
+    for item in text.split(", "):
+        if len(line) + len(item) + 2 > width and line.strip():
+            lines.append(line.rstrip())
+            line = "    "
+        line += item + ", "
+    lines.append(line.rstrip())
+    return "\n".join(lines) + "\n"
+
+
+# ----------------------------------------------------------------------------
+#   Entry points
+# ----------------------------------------------------------------------------
+def compile_model(model_dict, name):
+    """Compile a parsed model (see CreateDictFromFlatbuffer) into (c_source, header, arena_size)"""
+    model = AotModel(model_dict)
+    model.plan_activations()
+
+    # Kernel scratch and persistent buffer sizes fall out of emitting the ops,
+    # so emit once to size them and again once they are placed
+    Emitter(model, name).emit()
+    model.plan_buffers()
+    emitter = Emitter(model, name)
+    emitter.emit()
+    c, h = emitter.render()
+    return c, h, model.arena_size
+
+
+def compile_tflite(tflite_filename, name, destination):
+    with open(tflite_filename, "rb") as f:
+        model_dict = CreateDictFromFlatbuffer(bytearray(f.read()))
+    c, h, arena_size = compile_model(model_dict, name)
+    os.makedirs(destination, exist_ok=True)
+    with open(f"{destination}/{name}_aot.c", "w") as f:
+        f.write(c)
+    with open(f"{destination}/{name}_aot.h", "w") as f:
+        f.write(h)
+    log.info(f"AOT compiled {tflite_filename} to {destination}/{name}_aot.c, arena {arena_size} bytes")
+    return arena_size
+
+
+_HOST_DRIVER = """
+#include <stdio.h>
+#include "NAME_aot.h"
+
+static uint8_t arena[NAME_ARENA] __attribute__((aligned(16)));
+
+int main(int argc, char **argv) {
+    const ns_aot_model_t *m = &NAME_aot_model;
+    FILE *f = fopen(argv[1], "rb");
+    for (uint32_t i = 0; i < m->num_inputs; i++) {
+        if (fread(&arena[m->inputs[i].offset], 1, m->inputs[i].bytes, f) != m->inputs[i].bytes) {
+            return 2;
+        }
+    }
+    fclose(f);
+    if (m->init(arena, sizeof(arena)) || m->invoke(arena)) {
+        return 1;
+    }
+    f = fopen(argv[2], "wb");
+    for (uint32_t i = 0; i < m->num_outputs; i++) {
+        fwrite(&arena[m->outputs[i].offset], 1, m->outputs[i].bytes, f);
+    }
+    fclose(f);
+    return 0;
+}
+"""
+
+
+def verify_on_host(tflite_filename, name, cmsis_nn_path, runs=10, seed=42):
+    """Build the generated code for the host against CMSIS-NN's portable C kernels and compare
+    every output byte against the TFLite reference kernels (which TFLM's are derived from)"""
+    import numpy as np
+
+    # Any of the TFLite Python packages will do, only the reference kernels are used
+    try:
+        from tensorflow.lite.python.interpreter import Interpreter, OpResolverType
+    except ImportError:
+        try:
+            from ai_edge_litert.interpreter import Interpreter, OpResolverType
+        except ImportError:
+            from tflite_runtime.interpreter import Interpreter, OpResolverType
+
+    here = os.path.dirname(os.path.abspath(__file__))
+    ns_model_api = os.path.join(here, "..", "..", "neuralspot", "ns-model", "includes-api")
+    with tempfile.TemporaryDirectory() as tmp:
+        arena_size = compile_tflite(tflite_filename, name, tmp)
+        with open(f"{tmp}/main.c", "w") as f:
+            f.write(_HOST_DRIVER.replace("NAME_ARENA", str(arena_size)).replace("NAME", name))
+        # The generated code picks the CMSIS-NN include by TF version; give it both spellings
+        os.makedirs(f"{tmp}/inc", exist_ok=True)
+        for alias in ("cmsis_nn", "ns_cmsis_nn"):
+            os.symlink(os.path.abspath(cmsis_nn_path), f"{tmp}/inc/{alias}")
+        sources = glob.glob(f"{cmsis_nn_path}/Source/*/*.c")
+        cmd = [
+            "cc", "-O2", "-o", f"{tmp}/aot", f"{tmp}/main.c", f"{tmp}/{name}_aot.c",
+            "-I", tmp, "-I", f"{tmp}/inc", "-I", ns_model_api, "-I", f"{cmsis_nn_path}/Include",
+        ] + sources + ["-lm"]
+        subprocess.run(cmd, check=True)
+
+        interpreter = Interpreter(
+            model_path=tflite_filename, experimental_op_resolver_type=OpResolverType.BUILTIN_REF
+        )
+        interpreter.allocate_tensors()
+        rng = np.random.default_rng(seed)
+        for run in range(runs):
+            inputs = []
+            for d in interpreter.get_input_details():
+                x = rng.integers(-128, 128, size=d["shape"], dtype=np.int8)
+                interpreter.set_tensor(d["index"], x)
+                inputs.append(x.tobytes())
+            interpreter.invoke()
+            expected = b"".join(
+                interpreter.get_tensor(d["index"]).tobytes() for d in interpreter.get_output_details()
+            )
+            with open(f"{tmp}/in.bin", "wb") as f:
+                f.write(b"".join(inputs))
+            subprocess.run([f"{tmp}/aot", f"{tmp}/in.bin", f"{tmp}/out.bin"], check=True)
+            with open(f"{tmp}/out.bin", "rb") as f:
+                actual = f.read()
+            if actual != expected:
+                mismatches = sum(1 for a, e in zip(actual, expected) if a != e)
+                raise AotCompileError(f"Run {run}: {mismatches} of {len(expected)} output bytes differ")
+    print(f"[NS] AOT model {name} is bit-exact with the TFLite reference over {runs} runs")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a .tflite model to direct CMSIS-NN calls")
+    parser.add_argument("--tflite-filename", required=True, help="int8 .tflite model")
+    parser.add_argument("--model-name", default="model", help="Prefix for generated symbols and files")
+    parser.add_argument("--destination", default=".", help="Directory for <name>_aot.c/.h")
+    parser.add_argument(
+        "--verify-cmsis-nn", default="", help="CMSIS-NN source tree; if set, check bit-exactness on the host"
+    )
+    args = parser.parse_args()
+    log.basicConfig(level=log.INFO, format="%(levelname)s: %(message)s")
+    compile_tflite(args.tflite_filename, args.model_name, args.destination)
+    if args.verify_cmsis_nn:
+        verify_on_host(args.tflite_filename, args.model_name, args.verify_cmsis_nn)
+
+
+if __name__ == "__main__":
+    main()
@@ -5,6 +5,7 @@ import glob
 import pkg_resources
 
 import numpy as np
+from neuralspot.tools.autodeploy.aot_compiler import compile_tflite
 from neuralspot.tools.ns_utils import createFromTemplate, xxd_c_dump
 
 
@@ -54,8 +55,17 @@ def generateModelLib(params, mc, md, ambiqsuite=False):
         "NS_AD_NUM_INPUT_VECTORS": md.numInputs,
         "NS_AD_NUM_OUTPUT_VECTORS": md.numOutputs,
         "NS_AD_TOOLCHAIN": "arm-none-eabi",
+        "NS_AD_RUNTIME_AOT": 0,
+        "NS_AD_AOT_OBJECTS": "",
     }
 
+    # The AOT runtime is built alongside TFLM, so the example can check the two
+    # against each other
+    aot = params.runtime == "aot"
+    if aot:
+        rm["NS_AD_RUNTIME_AOT"] = 1
+        rm["NS_AD_AOT_OBJECTS"] = f"$(build)/{n}_aot.o"
+
     if ambiqsuite:
         print(f"[NS] Generating AmbiqSuite example at {d}/{n}")
         # Make destination directory
@@ -142,6 +152,12 @@ def generateModelLib(params, mc, md, ambiqsuite=False):
             dirs_exist_ok=True,
         )
 
+        if aot:
+            compile_tflite(params.tflite_filename, n, f"{d}/{n}/src")
+            shutil.copy(
+                params.neuralspot_rootdir + "/neuralspot/ns-model/includes-api/ns_aot_model.h", f"{d}/{n}/src/"
+            )
+
     else:
         createFromTemplate(
             template_directory + "/minimal_example/template_minimal_model.cc", f"{d}/{n}/src/{n}_model.cc", rm
@@ -190,6 +206,12 @@ def generateModelLib(params, mc, md, ambiqsuite=False):
             template_directory + "/common/template_ns_model.h", f"{d}/{n}/lib/ns_model.h", rm
         )
 
+        if aot:
+            compile_tflite(params.tflite_filename, n, f"{d}/{n}/src")
+            shutil.copy(
+                params.neuralspot_rootdir + "/neuralspot/ns-model/includes-api/ns_aot_model.h", f"{d}/{n}/lib/"
+            )
+
     # Generate model weight file
     xxd_c_dump(
         src_path=params.tflite_filename,
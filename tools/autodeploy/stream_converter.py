@@ -0,0 +1,817 @@
+"""
+Streaming model converter
+
+Rewrites a windowed temporal model into a streaming one. The windowed model sees a whole
+window of frames each invoke (time along dimension 1 of its only input, e.g. [1, 49, 10, 1]
+MFCC frames or [1, 200, 6] IMU samples), so with overlapping windows most of every invoke
+recomputes frames it has already seen. The streaming model takes only the new frames:
+
+- every temporal CONV_2D, DEPTHWISE_CONV_2D, AVERAGE_POOL_2D or MAX_POOL_2D (kernel longer
+  than one frame along time, which may be either H or W) gets a state tensor holding the
+  frames of history it needs. The op's input becomes CONCATENATION(state, new frames) and a
+  STRIDED_SLICE of that concatenation is the next step's state
+- per-frame ops (activations, elementwise math, FULLY_CONNECTED with keep_num_dims, reshapes,
+  EXPAND_DIMS and SQUEEZE that keep the time axis, possibly moving it, ...) just run on fewer
+  frames
+- a pool over the whole remaining time axis becomes a stride-1 pool, so there is one output
+  per step instead of one per window
+- any other op that reads the time axis (e.g. a RESHAPE flattening it into a classifier head)
+  gets a state holding the rest of the window, and runs unchanged on the whole window
+- UNIDIRECTIONAL_SEQUENCE_LSTM keeps its state in TFLM variable tensors between invokes;
+  "last time step" slices after it are moved to the last new frame. These models only
+  approximate the windowed model, since the recurrent state is not limited to one window
+
+Once a full window of frames has been streamed in, every output of a model without recurrent
+layers or SAME padding in time is bit-identical to the windowed model's for the window
+ending at the newest frame. Before that, the state holds the zero point, i.e. the windowed
+model on a window padded with zeros.
+
+SAME padding in time looks ahead: the windowed model's last frames are computed from padding
+after the window. The streaming model waits for the real frames instead, so its outputs lag
+the newest frame by a fixed delay (the sum of the padding after the window of every SAME
+layer, in input frames; the header's windowFrames includes it) and match the windowed model
+for the window ending that many frames earlier. They are not bit-identical, since frames
+within the padding of either window edge see real neighbours instead of zeros; the error
+is reported by --verify. Not supported: ops that combine tensors with different delays
+(e.g. a residual add around a SAME layer), time along any axis but H or W of a temporal op,
+and LSTMs with time anywhere but dimension 1.
+
+The state lives either in extra model inputs/outputs (--state external, the default) that
+ns_model_stream copies across invokes, or in TFLM resource variables (--state
+resource-variables: VAR_HANDLE/READ_VARIABLE/ASSIGN_VARIABLE ops, sized by rv_count and
+rv_arena in ns_model_state_t). The converter writes <name>_stream.tflite and
+<name>_stream.h, whose ns_model_stream_desc_t is passed to ns_model_stream_init_tflm().
+
+Usage:
+    python -m neuralspot.tools.autodeploy.stream_converter --tflite-filename kws.tflite \
+        --model-name kws --frames-per-step 2 --verify
+
+--verify runs both models through the TFLite interpreter (TensorFlow required) on a random
+frame sequence, and reports the output agreement and the per-step latency and MACs of each.
+tools/autodeploy/tests/test_stream_converter.py converts the checked-in HAR and KWS models
+and checks them the same way without TensorFlow.
+"""
+
+import argparse
+import collections
+import copy
+import logging as log
+import os
+import time
+
+import flatbuffers
+import numpy as np
+
+import neuralspot.tools.utils.schema_py_generated as schema_fb
+from neuralspot.tools.utils.tflite_helpers import BuiltinCodeToName
+
+TENSOR_TYPE_FLOAT32 = schema_fb.TensorType.FLOAT32
+TENSOR_TYPE_INT32 = schema_fb.TensorType.INT32
+TENSOR_TYPE_INT16 = schema_fb.TensorType.INT16
+TENSOR_TYPE_INT8 = schema_fb.TensorType.INT8
+TENSOR_TYPE_RESOURCE = schema_fb.TensorType.RESOURCE
+
+ELEMENT_BYTES = {TENSOR_TYPE_FLOAT32: 4, TENSOR_TYPE_INT32: 4, TENSOR_TYPE_INT16: 2, TENSOR_TYPE_INT8: 1}
+NUMPY_TYPE = {TENSOR_TYPE_FLOAT32: np.float32, TENSOR_TYPE_INT16: np.int16, TENSOR_TYPE_INT8: np.int8}
+
+PADDING_VALID = schema_fb.Padding.VALID
+
+TEMPORAL = ("CONV_2D", "DEPTHWISE_CONV_2D", "AVERAGE_POOL_2D", "MAX_POOL_2D")
+
+# Ops that treat every frame independently
+PER_FRAME = (
+    "ADD",
+    "SUB",
+    "MUL",
+    "MAXIMUM",
+    "MINIMUM",
+    "RELU",
+    "RELU6",
+    "RELU_N1_TO_1",
+    "LEAKY_RELU",
+    "PRELU",
+    "HARD_SWISH",
+    "LOGISTIC",
+    "TANH",
+    "QUANTIZE",
+    "DEQUANTIZE",
+    "SOFTMAX",
+)
+
+
+# A time tensor: frames in the windowed model, input frames per frame, and the time axis
+Timing = collections.namedtuple("Timing", "frames rate axis")
+
+
+class StreamConvertError(Exception):
+    pass
+
+
+def _same_padding(size, kernel, stride, dilation):
+    """Output size and total padding of a SAME op along one axis"""
+    out = (size + stride - 1) // stride
+    return out, max((out - 1) * stride + (kernel - 1) * dilation + 1 - size, 0)
+
+
+class StreamModel:
+    """A windowed model being rewritten in place into its streaming form"""
+
+    def __init__(self, model, frames_per_step, state):
+        if len(model.subgraphs) != 1:
+            raise StreamConvertError("Only single-subgraph models are supported")
+        self.model = model
+        self.sg = model.subgraphs[0]
+        self.step = frames_per_step
+        self.state = state
+        self.states = []  # (state input tensor, state output tensor)
+        self.recurrent = []  # names of ops whose state isn't bounded by the window
+        self.padded = []  # names of ops with SAME padding in time
+        self.time = {}  # tensor -> Timing
+        self.lag = {}  # tensor -> input frames its newest frame lags the newest input frame by
+        self.ops = []
+
+        # The object API unpacks index vectors as numpy arrays
+        self.sg.inputs = [int(i) for i in self.sg.inputs]
+        self.sg.outputs = [int(i) for i in self.sg.outputs]
+        if len(self.sg.inputs) != 1:
+            raise StreamConvertError("The windowed model must have exactly one input")
+        x = self.sg.inputs[0]
+        shape = list(self.t(x).shape)
+        if len(shape) < 3 or shape[0] != 1:
+            raise StreamConvertError(f"Input shape {shape} is not [1, time, ...]")
+        self.window = shape[1]
+        if not 1 <= frames_per_step <= self.window:
+            raise StreamConvertError(f"Frames per step must be between 1 and the window ({self.window})")
+        self.num_outputs = len(self.sg.outputs)
+        self.frame_bytes = int(np.prod(shape[2:])) * ELEMENT_BYTES[self.t(x).type]
+        self.time[x] = Timing(self.window, 1, 1)
+        self.lag[x] = 0
+        self._set_frames(x, frames_per_step)
+
+    # ------------------------------------------------------------------
+    #   Graph helpers
+    # ------------------------------------------------------------------
+    def t(self, index):
+        return self.sg.tensors[index]
+
+    def name(self, index):
+        n = self.t(index).name
+        return n.decode() if isinstance(n, bytes) else str(n)
+
+    def kind(self, op):
+        code = self.model.operatorCodes[op.opcodeIndex]
+        return BuiltinCodeToName(max(code.builtinCode, code.deprecatedBuiltinCode))
+
+    def is_constant(self, index):
+        b = self.t(index).buffer
+        return b > 0 and self.model.buffers[b].data is not None and len(self.model.buffers[b].data) > 0
+
+    def constant(self, index):
+        t = self.t(index)
+        data = np.asarray(self.model.buffers[t.buffer].data, dtype=np.uint8).tobytes()
+        return np.frombuffer(data, dtype=np.int32 if t.type == TENSOR_TYPE_INT32 else np.int8)
+
+    def frames(self, index):
+        """Frames of a time tensor per step in the streaming model"""
+        return self.step // self.time[index].rate
+
+    def delay(self):
+        """Input frames the outputs lag the newest input frame by"""
+        return max([self.lag.get(o, 0) for o in self.sg.outputs[: self.num_outputs]] + [0])
+
+    def _set_frames(self, index, n):
+        t = self.t(index)
+        axis = self.time[index].axis
+        t.shape = [int(d) for d in t.shape]
+        t.shape[axis] = n
+        if t.shapeSignature is not None and len(t.shapeSignature) > axis:
+            t.shapeSignature = [int(d) for d in t.shapeSignature]
+            t.shapeSignature[axis] = n
+
+    def _add_tensor(self, name, shape, like=None, tensor_type=None):
+        t = schema_fb.TensorT()
+        t.name = name.encode()
+        t.shape = [int(d) for d in shape]
+        t.type = like.type if like is not None else tensor_type
+        if like is not None and like.quantization is not None:
+            t.quantization = copy.deepcopy(like.quantization)
+        t.buffer = 0
+        self.sg.tensors.append(t)
+        return len(self.sg.tensors) - 1
+
+    def _add_int32(self, name, values):
+        b = schema_fb.BufferT()
+        b.data = np.frombuffer(np.asarray(values, dtype="<i4").tobytes(), dtype=np.uint8)
+        self.model.buffers.append(b)
+        index = self._add_tensor(name, [len(values)], tensor_type=TENSOR_TYPE_INT32)
+        self.t(index).buffer = len(self.model.buffers) - 1
+        return index
+
+    def _opcode(self, builtin):
+        for i, code in enumerate(self.model.operatorCodes):
+            if max(code.builtinCode, code.deprecatedBuiltinCode) == builtin:
+                return i
+        code = schema_fb.OperatorCodeT()
+        code.builtinCode = builtin
+        code.deprecatedBuiltinCode = min(builtin, schema_fb.BuiltinOperator.PLACEHOLDER_FOR_GREATER_OP_CODES)
+        code.version = 1
+        self.model.operatorCodes.append(code)
+        return len(self.model.operatorCodes) - 1
+
+    def _emit(self, builtin, inputs, outputs, options_type=0, options=None):
+        op = schema_fb.OperatorT()
+        op.opcodeIndex = self._opcode(builtin)
+        op.inputs = list(inputs)
+        op.outputs = list(outputs)
+        op.builtinOptionsType = options_type
+        op.builtinOptions = options
+        self.ops.append(op)
+
+    def _slice(self, src, dst, begin, end):
+        """dst = src[begin:end], full range on other dims"""
+        shape = self.t(src).shape
+        prefix = self.name(dst)
+        b = self._add_int32(prefix + "_begin", begin)
+        e = self._add_int32(prefix + "_end", end)
+        s = self._add_int32(prefix + "_strides", [1] * len(shape))
+        self._emit(
+            schema_fb.BuiltinOperator.STRIDED_SLICE,
+            [src, b, e, s],
+            [dst],
+            schema_fb.BuiltinOptions.StridedSliceOptions,
+            schema_fb.StridedSliceOptionsT(),
+        )
+
+    def _time_slice(self, src, first, count, name, axis=1, dst=None):
+        """A tensor (new unless dst is given) holding count frames of src starting at first"""
+        shape = list(self.t(src).shape)
+        begin = [0] * len(shape)
+        end = list(shape)
+        begin[axis], end[axis] = first, first + count
+        if dst is None:
+            out_shape = list(shape)
+            out_shape[axis] = count
+            dst = self._add_tensor(name, out_shape, like=self.t(src))
+        self._slice(src, dst, begin, end)
+        return dst
+
+    # ------------------------------------------------------------------
+    #   State
+    # ------------------------------------------------------------------
+    def _with_history(self, x, history):
+        """CONCATENATION(history frames from the last step, x), and the next step's history"""
+        xt = self.t(x)
+        axis = self.time[x].axis
+        shape = list(xt.shape)
+        shape[axis] = history
+        base = f"{self.name(x)}_stream{len(self.states)}"
+
+        if self.state == "external":
+            state_in = self._add_tensor(base + "_state_in", shape, like=xt)
+            self.sg.inputs.append(state_in)
+        else:
+            handle = self._add_tensor(base + "_handle", [], tensor_type=TENSOR_TYPE_RESOURCE)
+            state_in = self._add_tensor(base + "_state", shape, like=xt)
+            options = schema_fb.VarHandleOptionsT()
+            options.container = b""
+            options.sharedName = base.encode()
+            self._emit(
+                schema_fb.BuiltinOperator.VAR_HANDLE,
+                [],
+                [handle],
+                schema_fb.BuiltinOptions.VarHandleOptions,
+                options,
+            )
+            self._emit(
+                schema_fb.BuiltinOperator.READ_VARIABLE,
+                [handle],
+                [state_in],
+                schema_fb.BuiltinOptions.ReadVariableOptions,
+                schema_fb.ReadVariableOptionsT(),
+            )
+
+        cat_shape = list(xt.shape)
+        cat_shape[axis] = history + cat_shape[axis]
+        cat = self._add_tensor(base + "_window", cat_shape, like=xt)
+        options = schema_fb.ConcatenationOptionsT()
+        options.axis = axis
+        self._emit(
+            schema_fb.BuiltinOperator.CONCATENATION,
+            [state_in, x],
+            [cat],
+            schema_fb.BuiltinOptions.ConcatenationOptions,
+            options,
+        )
+
+        state_out = self._time_slice(cat, cat_shape[axis] - history, history, base + "_state_out", axis)
+        if self.state == "external":
+            self.sg.outputs.append(state_out)
+        else:
+            self._emit(
+                schema_fb.BuiltinOperator.ASSIGN_VARIABLE,
+                [handle, state_out],
+                [],
+                schema_fb.BuiltinOptions.AssignVariableOptions,
+                schema_fb.AssignVariableOptionsT(),
+            )
+        self.states.append((state_in, state_out))
+        return cat
+
+    # ------------------------------------------------------------------
+    #   Ops
+    # ------------------------------------------------------------------
+    def _temporal(self, op, kind):
+        x = op.inputs[0]
+        tw, rate, axis = self.time[x]
+        n = self.frames(x)
+        o = op.builtinOptions
+        out = op.outputs[0]
+        shape = list(self.t(x).shape)
+        if len(shape) != 4 or axis not in (1, 2):
+            raise StreamConvertError(f"{kind} {self.name(out)}: input is not NHWC with time along H or W")
+        # Kernel, stride and dilation along time ([0]) and along the other spatial axis ([1])
+        hw = ("H", "W") if axis == 1 else ("W", "H")
+        if kind in ("CONV_2D", "DEPTHWISE_CONV_2D"):
+            kernel = [self.t(op.inputs[1]).shape[d] for d in (axis, 3 - axis)]
+            dilation = [getattr(o, f"dilation{d}Factor") for d in hw]
+        else:
+            kernel = [getattr(o, "filterHeight" if d == "H" else "filterWidth") for d in hw]
+            dilation = [1, 1]
+        stride = [getattr(o, f"stride{d}") for d in hw]
+        k, s, reach = kernel[0], stride[0], (kernel[0] - 1) * dilation[0]
+
+        lag = 0
+        same = o.padding != PADDING_VALID
+        if same:
+            # The windowed model's last output reaches past the window by the padding after it;
+            # the streaming model waits for those frames, so it lags by as many
+            tw_out, pad = _same_padding(tw, k, s, dilation[0])
+            lag = (pad - pad // 2) * rate
+            if pad:
+                self.padded.append(self.name(out))
+        elif (tw - reach - 1) % s:
+            raise StreamConvertError(f"{kind} {self.name(out)}: the window does not end on a stride boundary")
+        else:
+            tw_out = (tw - reach - 1) // s + 1
+        if kind.endswith("POOL_2D") and k == tw and k > 1 and tw_out == 1:
+            # Pooling over everything left of the window: one result per frame instead
+            setattr(o, f"stride{hw[0]}", 1)
+            s, tw_out = 1, 1
+        if n % s:
+            raise StreamConvertError(f"{kind} {self.name(out)}: frames per step must be a multiple of {rate * s}")
+        if same and not _same_padding(shape[3 - axis], kernel[1], stride[1], dilation[1])[1]:
+            # Nothing is padded off the time axis, so VALID gives the same outputs there
+            o.padding = PADDING_VALID
+            same = False
+
+        if not same:
+            # The last output of each step must end on the step's last frame, so a strided op
+            # needs (s - 1) frames less history than its reach, or drops frames if it reaches
+            # less than that
+            history = reach - (s - 1)
+            if history > 0:
+                op.inputs[0] = self._with_history(x, history)
+            elif history < 0:
+                op.inputs[0] = self._time_slice(x, -history, n + history, self.name(x) + "_stream_aligned", axis)
+        else:
+            # The other axis is padded, so the op keeps SAME and pads time as well. Give it enough
+            # history that n // s of its outputs see only real frames, the last of them ending on
+            # the newest one, and slice those out
+            for history in range(reach + 2 * s):
+                m = history + n
+                count, pad = _same_padding(m, k, s, dilation[0])
+                last, misaligned = divmod(m - 1 + pad // 2 - reach, s)
+                first = last - n // s + 1
+                if not misaligned and first * s >= pad // 2 and last < count:
+                    break
+            else:
+                raise StreamConvertError(f"{kind} {self.name(out)}: no history aligns the padded outputs")
+            if history:
+                op.inputs[0] = self._with_history(x, history)
+            full_shape = list(self.t(out).shape)
+            full_shape[axis] = count
+            full = self._add_tensor(self.name(out) + "_stream_padded", full_shape, like=self.t(out))
+            op.outputs[0] = full
+            self.ops.append(op)
+            self._time_slice(full, first, n // s, None, axis, dst=out)
+
+        self.time[out] = Timing(tw_out, rate * s, axis)
+        self.lag[out] = self.lag[x] + lag
+        self._set_frames(out, n // s)
+        if not same:
+            self.ops.append(op)
+
+    def _per_frame(self, op, x, axis=None):
+        tx = self.time[x]
+        for i in op.inputs:
+            if i >= 0 and self.is_constant(i):
+                shape = list(self.t(i).shape)
+                if len(shape) == len(self.t(x).shape) and shape[tx.axis] == tx.frames > 1:
+                    raise StreamConvertError(f"Op {self.name(op.outputs[0])} has a constant that varies in time")
+        for out in op.outputs:
+            self.time[out] = tx if axis is None else tx._replace(axis=axis)
+            self.lag[out] = self.lag[x]
+            self._set_frames(out, self.frames(x))
+        self.ops.append(op)
+
+    def _reshape(self, op, x):
+        """Reshapes that keep every frame together, wherever the time axis ends up"""
+        out = op.outputs[0]
+        tw, _, axis = self.time[x]
+        in_shape, out_shape = list(self.t(x).shape), list(self.t(out).shape)
+        if np.prod(in_shape[:axis]) != 1:
+            return False
+        inner = np.prod(in_shape[axis + 1 :])
+        for j, d in enumerate(out_shape):
+            if d == tw and np.prod(out_shape[:j]) == 1 and np.prod(out_shape[j + 1 :]) == inner:
+                break
+        else:
+            return False
+        out_shape[j] = self.frames(x)
+        if len(op.inputs) > 1 and op.inputs[1] >= 0:
+            op.inputs[1] = self._add_int32(self.name(out) + "_stream_shape", out_shape)
+        if op.builtinOptions is not None and op.builtinOptions.newShape is not None:
+            op.builtinOptions.newShape = out_shape
+        self._per_frame(op, x, j)
+        return True
+
+    def _expand_dims(self, op, x):
+        if not self.is_constant(op.inputs[1]):
+            return False
+        rank = len(self.t(x).shape)
+        axis = int(self.constant(op.inputs[1])[0])
+        if axis < 0:
+            axis += rank + 1
+        t = self.time[x].axis
+        self._per_frame(op, x, t + 1 if axis <= t else t)
+        return True
+
+    def _squeeze(self, op, x):
+        tw, _, t = self.time[x]
+        shape = list(self.t(x).shape)
+        shape[t] = tw
+        o = op.builtinOptions
+        dims = [d + len(shape) if d < 0 else d for d in (o.squeezeDims if o is not None else None) or []]
+        if not dims:
+            dims = [d for d, size in enumerate(shape) if size == 1]
+        if t in dims:
+            return False
+        # Spell out the squeezed dims, or a step of one frame would lose its time axis too
+        if o is None:
+            op.builtinOptionsType = schema_fb.BuiltinOptions.SqueezeOptions
+            op.builtinOptions = o = schema_fb.SqueezeOptionsT()
+        o.squeezeDims = dims
+        self._per_frame(op, x, t - sum(d < t for d in dims))
+        return True
+
+    def _strided_slice(self, op, x):
+        """Slices that keep the whole time axis, or take its last frame"""
+        tw, rate, a = self.time[x]
+        n = self.frames(x)
+        if not all(self.is_constant(i) for i in op.inputs[1:4]):
+            return False
+        begin, end, strides = (list(self.constant(i)) for i in op.inputs[1:4])
+        o = op.builtinOptions
+        begin_all = begin[a] == 0 or (o.beginMask >> a) & 1
+        end_all = (o.endMask >> a) & 1 or end[a] >= tw
+        shrink = (o.shrinkAxisMask >> a) & 1
+        out = op.outputs[0]
+        prefix = self.name(out) + "_stream"
+
+        if strides[a] == 1 and begin_all and end_all and not shrink:
+            end[a] = n if not (o.endMask >> a) & 1 else end[a]
+            op.inputs[2] = self._add_int32(prefix + "_end", end)
+            self._per_frame(op, x, a - sum((o.shrinkAxisMask >> d) & 1 for d in range(a)))
+            return True
+
+        last = begin[a] in (tw - 1, -1) and (end_all or end[a] == 0 or shrink)
+        if strides[a] == 1 and last:
+            begin[a], end[a] = n - 1, n
+            op.inputs[1] = self._add_int32(prefix + "_begin", begin)
+            op.inputs[2] = self._add_int32(prefix + "_end", end)
+            if not shrink:
+                self.time[out] = Timing(1, self.step, a)  # one frame per step
+            self.lag[out] = self.lag[x]
+            self.ops.append(op)
+            return True
+        return False
+
+    def _whole_window(self, op, timed):
+        """Run an op unchanged on the whole window, the frames before this step from a state"""
+        for k, i in enumerate(op.inputs):
+            if i not in timed:
+                continue
+            tw, n = self.time[i].frames, self.frames(i)
+            if n < tw:
+                op.inputs[k] = self._with_history(i, tw - n)
+            elif n > tw:
+                op.inputs[k] = self._time_slice(i, n - tw, tw, self.name(i) + "_stream_window", self.time[i].axis)
+        for out in op.outputs:
+            self.lag[out] = self.lag[timed[0]]
+        self.ops.append(op)
+
+    def convert(self):
+        for op in self.sg.operators:
+            kind = self.kind(op)
+            op.inputs = [int(i) for i in op.inputs]
+            timed = [i for i in op.inputs if i >= 0 and i in self.time]
+            if not timed:
+                lags = [self.lag[i] for i in op.inputs if i in self.lag]
+                for out in op.outputs:
+                    if lags:
+                        self.lag[out] = max(lags)
+                self.ops.append(op)
+                continue
+            x = timed[0]
+            if any(self.time[i] != self.time[x] or self.lag[i] != self.lag[x] for i in timed):
+                raise StreamConvertError(
+                    f"{kind} {self.name(op.outputs[0])}: inputs run at different rates or delays"
+                )
+            tw, rate, axis = self.time[x]
+            rank = len(self.t(x).shape)
+            if self.step % rate:
+                raise StreamConvertError(f"Frames per step must be a multiple of {rate}")
+
+            if kind in TEMPORAL and x == op.inputs[0]:
+                self._temporal(op, kind)
+            elif kind in PER_FRAME and not (kind == "SOFTMAX" and axis == rank - 1):
+                self._per_frame(op, x)
+            elif kind == "FULLY_CONNECTED" and op.builtinOptions.keepNumDims and axis < rank - 1:
+                self._per_frame(op, x)
+            elif kind == "CONCATENATION" and op.builtinOptions.axis not in (axis, axis - rank):
+                self._per_frame(op, x)
+            elif (
+                kind == "PAD"
+                and self.is_constant(op.inputs[1])
+                and not any(self.constant(op.inputs[1]).reshape(-1, 2)[axis])
+            ):
+                self._per_frame(op, x)
+            elif kind == "UNIDIRECTIONAL_SEQUENCE_LSTM" and not op.builtinOptions.timeMajor and axis == 1:
+                self.recurrent.append(self.name(op.outputs[0]))
+                self._per_frame(op, x)
+            elif kind == "RESHAPE" and self._reshape(op, x):
+                pass
+            elif kind == "EXPAND_DIMS" and self._expand_dims(op, x):
+                pass
+            elif kind == "SQUEEZE" and self._squeeze(op, x):
+                pass
+            elif kind == "STRIDED_SLICE" and self._strided_slice(op, x):
+                pass
+            else:
+                # The op mixes frames some other way (e.g. flattening the time axis into a
+                # classifier head), or takes them all once the time axis is reduced to one frame
+                # per step. Either way it runs unchanged on the whole window
+                self._whole_window(op, timed)
+        self.sg.operators = self.ops
+        # The signatures describe the windowed model's inputs and outputs
+        self.model.signatureDefs = None
+        return self
+
+    # ------------------------------------------------------------------
+    #   Outputs
+    # ------------------------------------------------------------------
+    def state_bytes(self):
+        return [int(np.prod(self.t(s).shape)) * ELEMENT_BYTES[self.t(s).type] for s, _ in self.states]
+
+    def serialize(self):
+        builder = flatbuffers.Builder(1024)
+        builder.Finish(self.model.Pack(builder), file_identifier=b"TFL3")
+        return bytes(builder.Output())
+
+    def header(self, name, source):
+        external = self.state == "external"
+        n = len(self.states) if external else 0
+        state_in = ", ".join(str(1 + i) for i in range(n)) or "0"
+        state_out = ", ".join(str(self.num_outputs + i) for i in range(n)) or "0"
+        state_bytes = self.state_bytes()
+        # Each resource variable buffer is allocated separately, 16-byte aligned
+        rv_arena = sum((b + 15) // 16 * 16 for b in state_bytes) if not external else 0
+        guard = f"{name.upper()}_STREAM_H"
+        lines = [
+            "/**",
+            f" * @file {name}_stream.h",
+            f" * @brief Streaming form of {os.path.basename(source)} (generated by stream_converter.py)",
+            " *",
+            f" * {self.step} new frame(s) of {self.frame_bytes} bytes per invoke, {self.window}-frame window,",
+            f" * {len(self.states)} state tensor(s) of {sum(state_bytes)} bytes in total.",
+        ]
+        if self.recurrent:
+            lines.append(f" * Recurrent layers ({', '.join(self.recurrent)}) carry state beyond the window.")
+        if self.delay():
+            lines.append(f" * SAME padding in time: outputs lag the newest frame by {self.delay()} frame(s).")
+        lines += [
+            " */",
+            "",
+            f"#ifndef {guard}",
+            f"#define {guard}",
+            '#include "ns_model_stream.h"',
+            "",
+            f"#define {name.upper()}_STREAM_RV_COUNT {0 if external else len(self.states)}",
+            f"#define {name.upper()}_STREAM_RV_ARENA_SIZE {rv_arena}",
+            f"#define {name.upper()}_STREAM_DELAY_FRAMES {self.delay()}",
+            "",
+            f"static const ns_model_stream_desc_t {name}_stream_desc = {{",
+            f"    {'NS_MODEL_STREAM_EXTERNAL_STATE' if external else 'NS_MODEL_STREAM_RESOURCE_VARIABLES'},",
+            f"    0,    // frameInput",
+            f"    {self.step},    // framesPerStep",
+            f"    {self.frame_bytes},   // frameBytes",
+            f"    {self.window + self.delay()},   // windowFrames (including the delay)",
+            f"    {n},    // numStates",
+            f"    {{{state_in}}}, // stateInput",
+            f"    {{{state_out}}}, // stateOutput",
+            "};",
+            "",
+            f"#endif // {guard}",
+            "",
+        ]
+        return "\n".join(lines)
+
+
+def load_model(tflite_bytes):
+    return schema_fb.ModelT.InitFromObj(schema_fb.Model.GetRootAs(bytearray(tflite_bytes), 0))
+
+
+def convert_model(tflite_bytes, frames_per_step=1, state="external"):
+    """Returns the StreamModel, already converted; serialize() gives the new flatbuffer"""
+    return StreamModel(load_model(tflite_bytes), frames_per_step, state).convert()
+
+
+def count_macs(tflite_bytes):
+    """Multiply-accumulates per invoke of the conv, depthwise and fully connected ops"""
+    model = load_model(tflite_bytes)
+    sg = model.subgraphs[0]
+    macs = 0
+    for op in sg.operators:
+        code = model.operatorCodes[op.opcodeIndex]
+        kind = BuiltinCodeToName(max(code.builtinCode, code.deprecatedBuiltinCode))
+        if kind not in ("CONV_2D", "DEPTHWISE_CONV_2D", "FULLY_CONNECTED"):
+            continue
+        out = int(np.prod(sg.tensors[op.outputs[0]].shape))
+        if kind == "CONV_2D":
+            macs += out * int(np.prod(sg.tensors[op.inputs[1]].shape[1:]))
+        elif kind == "DEPTHWISE_CONV_2D":
+            macs += out * int(np.prod(sg.tensors[op.inputs[1]].shape[1:3]))
+        elif kind == "FULLY_CONNECTED":
+            macs += out * int(sg.tensors[op.inputs[1]].shape[-1])
+    return macs
+
+
+class TfliteRunner:
+    """Runs a model with the TFLite reference kernels"""
+
+    def __init__(self, tflite_bytes):
+        import tensorflow as tf
+
+        self.interpreter = tf.lite.Interpreter(
+            model_content=tflite_bytes,
+            experimental_op_resolver_type=tf.lite.experimental.OpResolverType.BUILTIN_REF,
+        )
+        self.interpreter.allocate_tensors()
+        self.inputs = self.interpreter.get_input_details()
+        self.outputs = self.interpreter.get_output_details()
+
+    def input_quantization(self, i):
+        return self.inputs[i]["quantization"]
+
+    def output_quantization(self, i):
+        return self.outputs[i]["quantization"]
+
+    def __call__(self, inputs):
+        for d, x in zip(self.inputs, inputs):
+            self.interpreter.set_tensor(d["index"], x)
+        self.interpreter.invoke()
+        return [self.interpreter.get_tensor(d["index"]) for d in self.outputs]
+
+
+def _dequantize(x, quantization):
+    scale, zero_point = quantization
+    if scale == 0:
+        return x.astype(np.float64)
+    return (x.astype(np.float64) - zero_point) * scale
+
+
+def verify(windowed_bytes, stream, num_frames=400, seed=42, runner=TfliteRunner, reps=3):
+    """Stream a random frame sequence through both models and compare every step the windowed
+    model can also be evaluated on, delayed as the streaming outputs are. Returns True if all
+    outputs were identical, or for models that only approximate the windowed one (recurrent
+    layers, SAME padding in time), if they all had the same top-1."""
+    stream_bytes = stream.serialize()
+    win, st = runner(windowed_bytes), runner(stream_bytes)
+    x0 = stream.t(stream.sg.inputs[0])
+    dtype = NUMPY_TYPE[x0.type]
+    frame_shape = [int(d) for d in x0.shape[2:]]
+    rng = np.random.default_rng(seed)
+    if dtype == np.float32:
+        frames = rng.standard_normal([num_frames] + frame_shape).astype(np.float32)
+    else:
+        info = np.iinfo(dtype)
+        frames = rng.integers(info.min, info.max + 1, size=[num_frames] + frame_shape, dtype=dtype)
+
+    num_states = len(stream.states) if stream.state == "external" else 0
+    states = []
+    for i in range(num_states):
+        t = stream.t(stream.states[i][0])
+        zero_point = st.input_quantization(1 + i)[1]
+        states.append(np.full([int(d) for d in t.shape], zero_point, dtype=NUMPY_TYPE[t.type]))
+
+    step = stream.step
+    lags = [stream.lag.get(o, 0) for o in stream.sg.outputs[: stream.num_outputs]]
+    compared = exact = agree = 0
+    max_error = 0.0
+    win_time = st_time = 0.0
+    win_runs = st_runs = 0
+    for n in range(num_frames // step):
+        new = frames[n * step : (n + 1) * step][np.newaxis]
+        t0 = time.perf_counter()
+        for _ in range(reps):
+            outputs = st([new] + [s.copy() for s in states])
+        st_time += time.perf_counter() - t0
+        st_runs += reps
+        states = outputs[stream.num_outputs :]
+
+        last = (n + 1) * step
+        if last - max(lags) < stream.window:
+            continue
+        expected = {}
+        for end in sorted(set(last - lag for lag in lags)):
+            t0 = time.perf_counter()
+            for _ in range(reps):
+                expected[end] = win([frames[end - stream.window : end][np.newaxis]])
+            win_time += time.perf_counter() - t0
+            win_runs += reps
+
+        for i in range(stream.num_outputs):
+            e, a = expected[last - lags[i]][i], outputs[i]
+            if e.ndim >= 2 and a.ndim == e.ndim and e.shape != a.shape:
+                # Time outputs: compare the frames both forms produce, ending at the newest frame
+                k = min(e.shape[1], a.shape[1])
+                e, a = e[:, e.shape[1] - k :], a[:, a.shape[1] - k :]
+            q = st.output_quantization(i)
+            error = np.abs(_dequantize(e, q) - _dequantize(a, q))
+            max_error = max(max_error, float(error.max()))
+            exact += int(np.array_equal(e, a))
+            top1 = [np.argmax(y.reshape(-1, y.shape[-1]), -1).tolist() for y in (e, a)]
+            agree += int(top1[0] == top1[1])
+            compared += 1
+
+    win_macs, st_macs = count_macs(windowed_bytes), count_macs(stream_bytes)
+    print(f"[NS] Streaming vs windowed over {compared} outputs ({num_frames} frames, {step} per step):")
+    print(f"[NS]   identical: {exact}/{compared}, same top-1: {agree}/{compared}, max error {max_error:.6g}")
+    print(f"[NS]   MACs per step: {win_macs} windowed (hop {step}), {st_macs} streaming")
+    print(
+        f"[NS]   host latency per step: {1e6 * win_time / max(win_runs, 1):.1f} us windowed, "
+        f"{1e6 * st_time / max(st_runs, 1):.1f} us streaming"
+    )
+    if stream.recurrent:
+        print(f"[NS]   {', '.join(stream.recurrent)} carry state beyond the window; differences are expected")
+    if stream.padded:
+        print(
+            f"[NS]   {', '.join(stream.padded)} pad in time; outputs lag by {stream.delay()} frame(s) and "
+            f"differ where the windowed model padded the window edges"
+        )
+    if stream.recurrent or stream.padded:
+        return agree == compared
+    return exact == compared
+
+
+def convert_tflite(tflite_filename, name, destination, frames_per_step=1, state="external"):
+    with open(tflite_filename, "rb") as f:
+        windowed = f.read()
+    stream = convert_model(windowed, frames_per_step, state)
+    os.makedirs(destination, exist_ok=True)
+    with open(f"{destination}/{name}_stream.tflite", "wb") as f:
+        f.write(stream.serialize())
+    with open(f"{destination}/{name}_stream.h", "w") as f:
+        f.write(stream.header(name, tflite_filename))
+    log.info(
+        f"Converted {tflite_filename} to {destination}/{name}_stream.tflite: {len(stream.states)} states, "
+        f"{sum(stream.state_bytes())} bytes"
+    )
+    return windowed, stream
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a windowed temporal .tflite model to streaming form")
+    parser.add_argument("--tflite-filename", required=True, help="Windowed model, time along input dimension 1")
+    parser.add_argument("--model-name", default="model", help="Prefix for generated symbols and files")
+    parser.add_argument("--destination", default=".", help="Directory for <name>_stream.tflite/.h")
+    parser.add_argument("--frames-per-step", type=int, default=1, help="New frames consumed per invoke")
+    parser.add_argument(
+        "--state",
+        choices=("external", "resource-variables"),
+        default="external",
+        help="Keep state in extra model inputs/outputs, or in TFLM resource variables",
+    )
+    parser.add_argument("--verify", action="store_true", help="Compare against the windowed model (needs TensorFlow)")
+    parser.add_argument("--verify-frames", type=int, default=400, help="Length of the --verify frame sequence")
+    args = parser.parse_args()
+    log.basicConfig(level=log.INFO, format="%(levelname)s: %(message)s")
+    windowed, stream = convert_tflite(
+        args.tflite_filename, args.model_name, args.destination, args.frames_per_step, args.state
+    )
+    if args.verify and not verify(windowed, stream, args.verify_frames):
+        raise SystemExit(1)
+
+
+if __name__ == "__main__":
+    main()
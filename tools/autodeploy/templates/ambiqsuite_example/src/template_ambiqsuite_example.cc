@@ -27,10 +27,16 @@ Notes:
 - It includes sample input and output tensors - the examples operate on these without
   regard to datatype (it treats everything as int8 arrays). The tensors are TF tensor
   types, with all dtype, dimensions, etc, preserved as usual.
+
+- If the example was generated with the AOT runtime, it also runs the ahead-of-time
+  compiled model on the same inputs and checks its outputs are bit-exact with TFLM's.
 */
 
 // TFLM Config
 static ns_model_state_t model;
+#if NS_AD_RUNTIME_AOT
+static ns_model_state_t aot_model;
+#endif
 volatile int example_status = 0; // Prevent the compiler from optimizing out while loops
 
 int main(void) {
@@ -111,6 +117,39 @@ int main(void) {
     }
     am_util_stdio_printf("All output tensors matched expected results.\n");
 
+#if NS_AD_RUNTIME_AOT
+    // Same inputs through the compiled model; outputs must match TFLM's bit for bit
+    am_util_stdio_printf("Initializing AOT model...");
+    if (NS_AD_NAME_aot_minimal_init(&aot_model) != NS_AD_NAME_STATUS_SUCCESS) {
+        am_util_stdio_printf(" failed.\n");
+        while (1)
+            example_status = NS_AD_NAME_STATUS_INIT_FAILED; // hang
+    }
+    am_util_stdio_printf(" success!\n");
+    offset = 0;
+    for (int i = 0; i < numInputs; i++) {
+        memcpy(
+            aot_model.model_input[i]->data.int8,
+            ((char *)NS_AD_NAME_example_input_tensors) + offset, aot_model.model_input[i]->bytes);
+        offset += aot_model.model_input[i]->bytes;
+    }
+    if (NS_AD_NAME_invoke(&aot_model) != NS_AD_NAME_STATUS_SUCCESS) {
+        while (1)
+            example_status = NS_AD_NAME_STATUS_FAILURE; // invoke failed, so hang
+    }
+    for (int i = 0; i < numOutputs; i++) {
+        if ((aot_model.model_output[i]->bytes != model.model_output[i]->bytes) ||
+            (0 != memcmp(
+                      aot_model.model_output[i]->data.int8, model.model_output[i]->data.int8,
+                      model.model_output[i]->bytes))) {
+            am_util_stdio_printf("AOT miscompare in output tensor %d\n", i);
+            while (1)
+                example_status = NS_AD_NAME_STATUS_INVALID_CONFIG; // miscompare, so hang
+        }
+    }
+    am_util_stdio_printf("AOT output tensors are bit-exact with TFLM.\n");
+#endif
+
     while (1) {
         // Success!
         example_status = NS_AD_NAME_STATUS_SUCCESS;
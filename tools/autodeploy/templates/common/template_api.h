@@ -16,4 +16,11 @@ NS_AD_NAME_init(ns_model_state_t *ms);
 extern int
 NS_AD_NAME_minimal_init(ns_model_state_t *ms);
 
+extern int
+NS_AD_NAME_invoke(ns_model_state_t *ms);
+
+// Only available when the library was generated with --runtime aot
+extern int
+NS_AD_NAME_aot_minimal_init(ns_model_state_t *ms);
+
 #endif
@@ -172,6 +172,11 @@ int NS_AD_NAME_minimal_init(ns_model_state_t *ms) {
     return status;
 }
 
+int NS_AD_NAME_invoke(ns_model_state_t *ms) {
+    return (ms->interpreter->Invoke() == kTfLiteOk) ? NS_AD_NAME_STATUS_SUCCESS
+                                                    : NS_AD_NAME_STATUS_FAILURE;
+}
+
 int NS_AD_NAME_init(ns_model_state_t *ms) {
     ms->state = NOT_READY;
 
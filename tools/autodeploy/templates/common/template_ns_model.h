@@ -41,7 +41,7 @@ extern "C" {
 #endif
 
 typedef enum { READY, NOT_READY, ERROR } ns_model_states_e;
-typedef enum { TFLM } ns_model_runtime_e;
+typedef enum { TFLM, AOT } ns_model_runtime_e;
 
 #define NS_MAX_INPUT_TENSORS 10
 #define NS_MAX_OUTPUT_TENSORS 10
@@ -50,8 +50,9 @@ typedef struct {
     ns_model_states_e state;
 
     // Configuration (init by application)
-    ns_model_runtime_e runtime; ///< Future use
-    const unsigned char *model_array;
+    ns_model_runtime_e runtime;           ///< TFLM interpreter or ahead-of-time compiled model
+    const unsigned char *model_array;     ///< Flatbuffer (TFLM only)
+    const struct ns_aot_model *aot_model; ///< Compiled model (AOT only, see ns_aot_model.h)
     uint8_t *arena; ///< Tensor Arena
     uint32_t arena_size;
     uint8_t *rv_arena;      ///< ResourceVariable Arena
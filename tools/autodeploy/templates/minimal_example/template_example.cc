@@ -31,17 +31,75 @@ Notes:
 - It includes sample input and output tensors - the examples operate on these without
   regard to datatype (it treats everything as int8 arrays). The tensors are TF tensor
   types, with all dtype, dimensions, etc, preserved as usual.
+
+- If the library was generated with the AOT runtime, the example also runs the
+  ahead-of-time compiled model, checks its outputs are bit-exact with TFLM's, and
+  records init cycles, invoke cycles and arena bytes of both in tflm_stats/aot_stats.
 */
 
 // TFLM Config
 static ns_model_state_t model;
 volatile int example_status = 0; // Prevent the compiler from optimizing out while loops
 
+#if NS_AD_RUNTIME_AOT
+static ns_model_state_t aot_model;
+
+    // DWT cycle counter, addressed directly so the example stays free of device headers
+    #define EXAMPLE_DEMCR (*(volatile uint32_t *)0xE000EDFC)
+    #define EXAMPLE_DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+    #define EXAMPLE_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+    #define EXAMPLE_INVOKE_RUNS 10
+
+typedef struct {
+    uint32_t init_cycles;   ///< Cycles spent in model init
+    uint32_t invoke_cycles; ///< Average cycles per invoke
+    uint32_t arena_bytes;   ///< Arena used by the model
+} example_runtime_stats_t;
+
+volatile example_runtime_stats_t tflm_stats;
+volatile example_runtime_stats_t aot_stats;
+
+static int
+example_timed_init(ns_model_state_t *m, int (*init)(ns_model_state_t *),
+                   volatile example_runtime_stats_t *stats);
+static void
+example_timed_invoke(ns_model_state_t *m, volatile example_runtime_stats_t *stats);
+#endif
+
+static void
+example_load_inputs(ns_model_state_t *m) {
+    int offset = 0;
+    for (uint32_t i = 0; i < m->numInputTensors; i++) {
+        memcpy(m->model_input[i]->data.int8, ((char *)NS_AD_NAME_example_input_tensors) + offset,
+               m->model_input[i]->bytes);
+        offset += m->model_input[i]->bytes;
+    }
+}
+
+// Compare the bytes of the output tensors against expected values
+static bool
+example_check_outputs(ns_model_state_t *m) {
+    int offset = 0;
+    for (uint32_t i = 0; i < m->numOutputTensors; i++) {
+        if (0 != memcmp(m->model_output[i]->data.int8,
+                        ((char *)NS_AD_NAME_example_output_tensors) + offset,
+                        m->model_output[i]->bytes)) {
+            return false;
+        }
+        offset += m->model_output[i]->bytes;
+    }
+    return true;
+}
+
 int
 main(void) {
 
     // Initialize the model, get handle if successful
+#if NS_AD_RUNTIME_AOT
+    int status = example_timed_init(&model, NS_AD_NAME_minimal_init, &tflm_stats);
+#else
     int status = NS_AD_NAME_minimal_init(&model); // model init with minimal defaults
+#endif
 
     if (status == NS_AD_NAME_STATUS_FAILURE) {
         while (1)
@@ -52,40 +110,71 @@ main(void) {
     // Note that the model handle is not meant to be opaque, the structure is defined
     // in ns_model.h, and contains state, config details, and model structure information
 
-    // Get data about input and output tensors
-    int numInputs = model.numInputTensors;
-    int numOutputs = model.numOutputTensors;
-
     // Initialize input tensors
-    int offset = 0;
-    for (int i = 0; i < numInputs; i++) {
-        memcpy(model.model_input[i]->data.int8, ((char *)NS_AD_NAME_example_input_tensors) + offset,
-               model.model_input[i]->bytes);
-        offset += model.model_input[i]->bytes;
-    }
+    example_load_inputs(&model);
 
     // Execute the model
-    TfLiteStatus invoke_status = model.interpreter->Invoke();
-
-    if (invoke_status != kTfLiteOk) {
+    if (NS_AD_NAME_invoke(&model) != NS_AD_NAME_STATUS_SUCCESS) {
         while (1)
             example_status = NS_AD_NAME_STATUS_FAILURE; // invoke failed, so hang
     }
 
-    // Compare the bytes of the output tensors against expected values
-    offset = 0;
-    for (int i = 0; i < numOutputs; i++) {
-        if (0 != memcmp(model.model_output[i]->data.int8,
-                        ((char *)NS_AD_NAME_example_output_tensors) + offset,
-                        model.model_output[i]->bytes)) {
+    if (!example_check_outputs(&model)) {
+        while (1)
+            example_status = NS_AD_NAME_STATUS_INVALID_CONFIG; // miscompare, so hang
+    }
+
+#if NS_AD_RUNTIME_AOT
+    // Same inputs through the compiled model; outputs must match TFLM's bit for bit
+    if (example_timed_init(&aot_model, NS_AD_NAME_aot_minimal_init, &aot_stats) !=
+        NS_AD_NAME_STATUS_SUCCESS) {
+        while (1)
+            example_status = NS_AD_NAME_STATUS_INIT_FAILED; // hang
+    }
+    example_timed_invoke(&model, &tflm_stats);
+    example_timed_invoke(&aot_model, &aot_stats);
+    for (uint32_t i = 0; i < model.numOutputTensors; i++) {
+        if ((aot_model.model_output[i]->bytes != model.model_output[i]->bytes) ||
+            (0 != memcmp(aot_model.model_output[i]->data.int8, model.model_output[i]->data.int8,
+                         model.model_output[i]->bytes))) {
             while (1)
                 example_status = NS_AD_NAME_STATUS_INVALID_CONFIG; // miscompare, so hang
         }
-        offset += model.model_output[i]->bytes;
     }
+#endif
 
     while (1) {
         // Success!
         example_status = NS_AD_NAME_STATUS_SUCCESS;
     }
 }
+
+#if NS_AD_RUNTIME_AOT
+static int
+example_timed_init(ns_model_state_t *m, int (*init)(ns_model_state_t *),
+                   volatile example_runtime_stats_t *stats) {
+    EXAMPLE_DEMCR |= (1 << 24); // TRCENA
+    EXAMPLE_DWT_CTRL |= 1;      // CYCCNTENA
+
+    uint32_t start = EXAMPLE_DWT_CYCCNT;
+    int status = init(m);
+    stats->init_cycles = EXAMPLE_DWT_CYCCNT - start;
+    stats->arena_bytes = m->computed_arena_size;
+    return status;
+}
+
+static void
+example_timed_invoke(ns_model_state_t *m, volatile example_runtime_stats_t *stats) {
+    example_load_inputs(m);
+    uint32_t start = EXAMPLE_DWT_CYCCNT;
+    for (int i = 0; i < EXAMPLE_INVOKE_RUNS; i++) {
+        NS_AD_NAME_invoke(m);
+    }
+    stats->invoke_cycles = (EXAMPLE_DWT_CYCCNT - start) / EXAMPLE_INVOKE_RUNS;
+
+    if (!example_check_outputs(m)) {
+        while (1)
+            example_status = NS_AD_NAME_STATUS_INVALID_CONFIG; // miscompare, so hang
+    }
+}
+#endif
@@ -13,6 +13,9 @@
 #include "NS_AD_NAME_model.h"
 #include "NS_AD_NAME_model_data.h"
 #include "ns_model.h"
+#if NS_AD_RUNTIME_AOT
+    #include "NS_AD_NAME_aot.h"
+#endif
 
 // Tensorflow Lite for Microcontroller includes (somewhat boilerplate)
 // #include "tensorflow/lite/micro/all_ops_resolver.h"
@@ -46,6 +49,12 @@ static constexpr int NS_AD_NAME_tensor_arena_size = 1024 * NS_AD_NAME_COMPUTED_A
     #endif
 #endif
 
+#if NS_AD_RUNTIME_AOT
+// The AOT model gets its own arena so both runtimes can be compared side by side
+alignas(16) static uint8_t NS_AD_NAME_aot_arena[NS_AD_NAME_AOT_ARENA_SIZE];
+static TfLiteTensor NS_AD_NAME_aot_tensors[NS_AD_NUM_INPUT_VECTORS + NS_AD_NUM_OUTPUT_VECTORS];
+#endif
+
 // Resource Variable Arena
 static constexpr int NS_AD_NAME_resource_var_arena_size =
     4 * (NS_AD_RV_COUNT + 1) * sizeof(tflite::MicroResourceVariables);
@@ -89,9 +98,67 @@ int NS_AD_NAME_minimal_init(ns_model_state_t *ms) {
     return status;
 }
 
+#if NS_AD_RUNTIME_AOT
+int NS_AD_NAME_aot_minimal_init(ns_model_state_t *ms) {
+    ms->runtime = AOT;
+    ms->aot_model = &NS_AD_NAME_aot_model;
+    ms->model_array = NULL;
+    ms->arena = NS_AD_NAME_aot_arena;
+    ms->arena_size = NS_AD_NAME_AOT_ARENA_SIZE;
+    ms->rv_count = 0;
+    ms->numInputTensors = NS_AD_NUM_INPUT_VECTORS;
+    ms->numOutputTensors = NS_AD_NUM_OUTPUT_VECTORS;
+    ms->tickTimer = NULL;
+    ms->mac_estimates = NULL;
+    return NS_AD_NAME_init(ms);
+}
+
+// Nothing to parse or allocate - the arena was planned by the compiler. Expose
+// the model's inputs and outputs as tensor views into the arena.
+static int NS_AD_NAME_aot_init(ns_model_state_t *ms) {
+    const ns_aot_model_t *m = ms->aot_model;
+
+    if ((ms->arena_size < m->arena_size) || (m->init(ms->arena, ms->arena_size) != 0)) {
+        return NS_AD_NAME_STATUS_FAILURE;
+    }
+
+    TfLiteTensor *v = NS_AD_NAME_aot_tensors;
+    for (uint32_t t = 0; t < m->num_inputs; t++, v++) {
+        ns_aot_tensor_view(v, &m->inputs[t], ms->arena);
+        ms->model_input[t] = v;
+    }
+    for (uint32_t t = 0; t < m->num_outputs; t++, v++) {
+        ns_aot_tensor_view(v, &m->outputs[t], ms->arena);
+        ms->model_output[t] = v;
+    }
+
+    ms->interpreter = NULL;
+    ms->computed_arena_size = m->arena_size;
+    ms->state = READY;
+    return NS_AD_NAME_STATUS_SUCCESS;
+}
+#endif
+
+int NS_AD_NAME_invoke(ns_model_state_t *ms) {
+#if NS_AD_RUNTIME_AOT
+    if (ms->runtime == AOT) {
+        return (ms->aot_model->invoke(ms->arena) == 0) ? NS_AD_NAME_STATUS_SUCCESS
+                                                        : NS_AD_NAME_STATUS_FAILURE;
+    }
+#endif
+    return (ms->interpreter->Invoke() == kTfLiteOk) ? NS_AD_NAME_STATUS_SUCCESS
+                                                    : NS_AD_NAME_STATUS_FAILURE;
+}
+
 int NS_AD_NAME_init(ns_model_state_t *ms) {
     ms->state = NOT_READY;
 
+#if NS_AD_RUNTIME_AOT
+    if (ms->runtime == AOT) {
+        return NS_AD_NAME_aot_init(ms);
+    }
+#endif
+
     tflite::MicroErrorReporter micro_error_reporter;
     ms->error_reporter = &micro_error_reporter;
 
@@ -165,6 +232,7 @@ int NS_AD_NAME_init(ns_model_state_t *ms) {
         TF_LITE_REPORT_ERROR(ms->error_reporter, "AllocateTensors() failed");
         return NS_AD_NAME_STATUS_FAILURE;
     }
+    ms->computed_arena_size = ms->interpreter->arena_used_bytes();
 
     // Obtain pointers to the model's input and output tensors.
     for (uint32_t t = 0; t <= ms->numInputTensors; t++) {
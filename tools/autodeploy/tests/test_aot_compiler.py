@@ -0,0 +1,122 @@
+"""
+AOT compiler tests
+
+The regression model is neuralspot/ns-model/tests/ns_model_aot_tests_tiny.tflite, a small int8
+network using every op the compiler supports (CONV_2D, DEPTHWISE_CONV_2D, ADD, MAX_POOL_2D,
+AVERAGE_POOL_2D, RESHAPE, FULLY_CONNECTED, SOFTMAX). Its compiled form is checked in next to
+it, and ns_model_aot_tests (ns_model_full_regression.ini) runs that on the EVB against TFLM:
+byte-for-byte outputs, init time, invoke overhead and arena size.
+
+These tests keep the checked-in sources in step with the compiler and compile them against the
+CMSIS-NN headers of each TF version in extern/tensorflow. test_bit_exact_on_host builds the
+generated code with CMSIS-NN's portable C kernels and compares it with the TFLite reference
+kernels; it needs a CMSIS-NN source tree in CMSIS_NN_PATH and a TFLite Python package.
+
+    python -m pytest tools/autodeploy/tests
+    python tools/autodeploy/tests/test_aot_compiler.py --regenerate   # after a compiler change
+"""
+
+import glob
+import os
+import shutil
+import subprocess
+import sys
+
+import pytest
+
+import neuralspot.tools.autodeploy.aot_compiler as aot
+from neuralspot.tools.utils.tflite_helpers import CreateDictFromFlatbuffer
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "..")
+TESTS = os.path.join(ROOT, "neuralspot", "ns-model", "tests")
+NAME = "ns_model_aot_tests_tiny"
+TFLITE = os.path.join(TESTS, f"{NAME}.tflite")
+MODEL_HEADER = os.path.join(TESTS, f"{NAME}_model.h")
+
+_HEADER = """\
+// {name}.tflite as a C array, for the TFLM side of ns_model_aot_tests.
+// Regenerate both with tools/autodeploy/tests/test_aot_compiler.py --regenerate.
+#ifndef {guard}
+#define {guard}
+
+alignas(16) const unsigned char {name}_model[] = {{
+{body}
+}};
+const unsigned int {name}_model_len = {size};
+
+#endif // {guard}
+"""
+
+
+def model_header(data):
+    """The C array header of the regression model"""
+    body = "\n".join(
+        "    " + ", ".join(f"0x{b:02x}" for b in data[i : i + 16]) + "," for i in range(0, len(data), 16)
+    )
+    guard = f"{NAME.upper()}_MODEL_H"
+    return _HEADER.format(name=NAME, guard=guard, body=body, size=len(data))
+
+
+def read(path, mode="r"):
+    with open(path, mode) as f:
+        return f.read()
+
+
+def compiled():
+    model = CreateDictFromFlatbuffer(bytearray(read(TFLITE, "rb")))
+    return aot.compile_model(model, NAME)
+
+
+def test_checked_in_sources_are_current():
+    c, h, arena_size = compiled()
+    assert read(os.path.join(TESTS, f"{NAME}_aot.c")) == c
+    assert read(os.path.join(TESTS, f"{NAME}_aot.h")) == h
+    assert read(MODEL_HEADER) == model_header(read(TFLITE, "rb"))
+    assert f"#define {NAME}_AOT_ARENA_SIZE {arena_size}" in h
+
+
+def test_every_supported_op_is_covered():
+    ops = {op.split("op_", 1)[1].upper() for op in dir(aot.Emitter) if op.startswith("op_")}
+    c = read(os.path.join(TESTS, f"{NAME}_aot.c"))
+    for op in ops:
+        assert f": {op} -> " in c, f"{op} missing from the regression model"
+
+
+@pytest.mark.skipif(shutil.which("cc") is None, reason="no host C compiler")
+@pytest.mark.parametrize(
+    "version", sorted(os.path.basename(v) for v in glob.glob(os.path.join(ROOT, "extern", "tensorflow", "*_*")))
+)
+def test_generated_code_compiles(version):
+    cmd = [
+        "cc", "-fsyntax-only", "-Wall", "-Werror", f"-DNS_TF_VERSION_{version}",
+        "-I", os.path.join(ROOT, "neuralspot", "ns-model", "includes-api"),
+        "-I", os.path.join(ROOT, "extern", "tensorflow", version, "third_party"),
+        os.path.join(TESTS, f"{NAME}_aot.c"),
+    ]  # fmt: skip
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    assert result.returncode == 0, result.stderr
+
+
+def test_bit_exact_on_host():
+    cmsis_nn = os.environ.get("CMSIS_NN_PATH", "")
+    if not glob.glob(os.path.join(cmsis_nn, "Source", "*", "*.c")):
+        pytest.skip("set CMSIS_NN_PATH to a CMSIS-NN source tree")
+    if not any(_importable(m) for m in ("tensorflow", "ai_edge_litert", "tflite_runtime")):
+        pytest.skip("needs tensorflow, ai_edge_litert or tflite_runtime")
+    aot.verify_on_host(TFLITE, NAME, cmsis_nn, runs=20)
+
+
+def _importable(module):
+    try:
+        __import__(module)
+        return True
+    except ImportError:
+        return False
+
+
+if __name__ == "__main__":
+    if sys.argv[1:] != ["--regenerate"]:
+        sys.exit(f"usage: {sys.argv[0]} --regenerate")
+    aot.compile_tflite(TFLITE, NAME, TESTS)
+    with open(MODEL_HEADER, "w") as f:
+        f.write(model_header(read(TFLITE, "rb")))
@@ -0,0 +1,339 @@
+"""
+Stream converter tests
+
+Converts the HAR and KWS models checked in under apps/ai and streams a random frame sequence
+through both forms with stream_converter.verify(). TensorFlow isn't needed: the models run on
+RefRunner, a numpy interpreter for the int8 ops these models use. Its requantization follows
+the TFLite reference kernels; SOFTMAX is computed in floating point, so outputs may differ
+from TFLite by one LSB there, but both forms of a model always run on the same kernels.
+
+    python -m pytest tools/autodeploy/tests
+"""
+
+import copy
+import os
+import re
+
+import numpy as np
+import pytest
+
+import neuralspot.tools.autodeploy.stream_converter as sc
+
+ROOT = os.path.join(os.path.dirname(__file__), "..", "..", "..")
+
+INT32_MIN = -(2**31)
+INT32_MAX = 2**31 - 1
+
+
+def model_from_header(path):
+    """The bytes of the C array a model header holds"""
+    with open(os.path.join(ROOT, path)) as f:
+        source = f.read()
+    body = source[source.index("{", source.index("[]")) + 1 :]
+    body = body[: body.index("}")]
+    return bytes(int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", body))
+
+
+# ----------------------------------------------------------------------
+#   Fixed-point helpers (tensorflow/lite/kernels/internal/common.h)
+# ----------------------------------------------------------------------
+def quantize_multiplier(m):
+    if m == 0:
+        return 0, 0
+    frac, shift = np.frexp(m)
+    q = int(round(frac * (1 << 31)))
+    if q == 1 << 31:
+        q //= 2
+        shift += 1
+    return q, int(shift)
+
+
+def multiply_by_quantized_multiplier(x, multiplier, shift):
+    x = np.asarray(x, dtype=np.int64) * (1 << np.maximum(shift, 0))
+    # SaturatingRoundingDoublingHighMul
+    ab = x * multiplier
+    nudge = np.where(ab >= 0, 1 << 30, 1 - (1 << 30))
+    high = np.sign(ab + nudge) * (np.abs(ab + nudge) >> 31)
+    high = np.where((x == INT32_MIN) & (multiplier == INT32_MIN), INT32_MAX, high)
+    # RoundingDivideByPOT
+    exponent = np.maximum(-shift, 0)
+    mask = (1 << exponent) - 1
+    remainder = high & mask
+    threshold = (mask >> 1) + (high < 0)
+    return (high >> exponent) + (remainder > threshold)
+
+
+def same_padding(size, kernel, stride, dilation):
+    out, pad = sc._same_padding(size, kernel, stride, dilation)
+    return out, pad // 2
+
+
+# ----------------------------------------------------------------------
+#   Reference interpreter
+# ----------------------------------------------------------------------
+class RefRunner:
+    """Runs an int8 model on numpy, with the interface stream_converter.verify() expects"""
+
+    def __init__(self, tflite_bytes):
+        self.model = sc.load_model(tflite_bytes)
+        self.sg = self.model.subgraphs[0]
+        self.kinds = [
+            sc.BuiltinCodeToName(max(c.builtinCode, c.deprecatedBuiltinCode)) for c in self.model.operatorCodes
+        ]
+
+    def _quantization(self, index):
+        q = self.sg.tensors[index].quantization
+        if q is None or q.scale is None or len(q.scale) == 0:
+            return 0.0, 0
+        return float(q.scale[0]), int(q.zeroPoint[0])
+
+    def input_quantization(self, i):
+        return self._quantization(int(self.sg.inputs[i]))
+
+    def output_quantization(self, i):
+        return self._quantization(int(self.sg.outputs[i]))
+
+    def _shape(self, index):
+        return [int(d) for d in self.sg.tensors[index].shape]
+
+    def _constant(self, index):
+        t = self.sg.tensors[index]
+        data = np.asarray(self.model.buffers[t.buffer].data, dtype=np.uint8).tobytes()
+        dtype = {sc.TENSOR_TYPE_INT32: np.int32, sc.TENSOR_TYPE_INT8: np.int8}[t.type]
+        return np.frombuffer(data, dtype=dtype).reshape(self._shape(index))
+
+    def _activation_range(self, index, activation):
+        scale, zero_point = self._quantization(index)
+        lo, hi = -128, 127
+        if activation in (1, 2, 3):  # RELU, RELU_N1_TO_1, RELU6
+            floor, ceiling = {1: (0.0, None), 2: (-1.0, 1.0), 3: (0.0, 6.0)}[activation]
+            lo = max(lo, zero_point + int(round(floor / scale)))
+            if ceiling is not None:
+                hi = min(hi, zero_point + int(round(ceiling / scale)))
+        return lo, hi
+
+    def _requantize(self, acc, input_index, filter_index, output_index, activation):
+        in_scale, _ = self._quantization(input_index)
+        out_scale, out_zp = self._quantization(output_index)
+        filter_scales = np.asarray(self.sg.tensors[filter_index].quantization.scale, dtype=np.float64)
+        if len(filter_scales) == 1:
+            filter_scales = np.repeat(filter_scales, acc.shape[-1])
+        multipliers = [quantize_multiplier(in_scale * f / out_scale) for f in filter_scales]
+        q = np.array([m for m, _ in multipliers], dtype=np.int64)
+        shift = np.array([s for _, s in multipliers], dtype=np.int64)
+        lo, hi = self._activation_range(output_index, activation)
+        return np.clip(multiply_by_quantized_multiplier(acc, q, shift) + out_zp, lo, hi).astype(np.int8)
+
+    def _windows(self, x, kernel, stride, dilation, padding, pad_value):
+        """[1, H', W', kh, kw, C] views of the receptive fields, and which taps are real"""
+        _, h, w, _ = x.shape
+        if padding == sc.PADDING_VALID:
+            oh = (h - (kernel[0] - 1) * dilation[0] - 1) // stride[0] + 1
+            ow = (w - (kernel[1] - 1) * dilation[1] - 1) // stride[1] + 1
+            top = left = 0
+        else:
+            oh, top = same_padding(h, kernel[0], stride[0], dilation[0])
+            ow, left = same_padding(w, kernel[1], stride[1], dilation[1])
+        reach_h = (oh - 1) * stride[0] + (kernel[0] - 1) * dilation[0] + 1
+        reach_w = (ow - 1) * stride[1] + (kernel[1] - 1) * dilation[1] + 1
+        padded = np.full((1, max(reach_h, top + h), max(reach_w, left + w), x.shape[3]), pad_value, np.int64)
+        padded[:, top : top + h, left : left + w] = x
+        real = np.zeros(padded.shape[1:3], dtype=bool)
+        real[top : top + h, left : left + w] = True
+        taps, valid = [], []
+        for i in range(kernel[0]):
+            for j in range(kernel[1]):
+                rows = slice(i * dilation[0], i * dilation[0] + (oh - 1) * stride[0] + 1, stride[0])
+                cols = slice(j * dilation[1], j * dilation[1] + (ow - 1) * stride[1] + 1, stride[1])
+                taps.append(padded[:, rows, cols])
+                valid.append(real[rows, cols])
+        shape = (1, oh, ow, kernel[0], kernel[1], x.shape[3])
+        taps = np.stack(taps, axis=3).reshape(shape)
+        valid = np.stack(valid, axis=2).reshape(oh, ow, kernel[0], kernel[1])
+        return taps, valid
+
+    def _conv(self, op, kind, x):
+        o = op.builtinOptions
+        w = self._constant(op.inputs[1]).astype(np.int64)
+        bias = self._constant(op.inputs[2]).astype(np.int64) if len(op.inputs) > 2 and op.inputs[2] >= 0 else 0
+        _, in_zp = self._quantization(op.inputs[0])
+        kernel = w.shape[1:3]
+        taps, _ = self._windows(
+            x, kernel, (o.strideH, o.strideW), (o.dilationHFactor, o.dilationWFactor), o.padding, in_zp
+        )
+        taps = taps - in_zp
+        if kind == "CONV_2D":
+            acc = np.einsum("nhwijc,oijc->nhwo", taps, w)
+        else:
+            multiplier = w.shape[3] // x.shape[3]
+            acc = np.repeat(taps, multiplier, axis=5) * w[0]
+            acc = acc.sum(axis=(3, 4))
+        return self._requantize(acc + bias, op.inputs[0], op.inputs[1], op.outputs[0], o.fusedActivationFunction)
+
+    def _pool(self, op, kind, x):
+        o = op.builtinOptions
+        taps, valid = self._windows(
+            x, (o.filterHeight, o.filterWidth), (o.strideH, o.strideW), (1, 1), o.padding, 0
+        )
+        valid = valid[np.newaxis, ..., np.newaxis]
+        if kind == "MAX_POOL_2D":
+            y = np.where(valid, taps, -128).max(axis=(3, 4))
+        else:
+            total = np.where(valid, taps, 0).sum(axis=(3, 4))
+            count = valid.sum(axis=(3, 4))
+            y = np.where(total > 0, (total + count // 2) // count, -((-total + count // 2) // count))
+        lo, hi = self._activation_range(op.outputs[0], o.fusedActivationFunction)
+        return np.clip(y, lo, hi).astype(np.int8)
+
+    def _fully_connected(self, op, x):
+        o = op.builtinOptions
+        w = self._constant(op.inputs[1]).astype(np.int64)
+        bias = self._constant(op.inputs[2]).astype(np.int64) if len(op.inputs) > 2 and op.inputs[2] >= 0 else 0
+        _, in_zp = self._quantization(op.inputs[0])
+        acc = (x.reshape(-1, w.shape[1]).astype(np.int64) - in_zp) @ w.T + bias
+        y = self._requantize(acc, op.inputs[0], op.inputs[1], op.outputs[0], o.fusedActivationFunction)
+        return y.reshape(self._shape(op.outputs[0]))
+
+    def _softmax(self, op, x):
+        in_scale, in_zp = self._quantization(op.inputs[0])
+        out_scale, out_zp = self._quantization(op.outputs[0])
+        logits = (x.astype(np.float64) - in_zp) * in_scale * op.builtinOptions.beta
+        e = np.exp(logits - logits.max(axis=-1, keepdims=True))
+        y = np.round(e / e.sum(axis=-1, keepdims=True) / out_scale) + out_zp
+        return np.clip(y, -128, 127).astype(np.int8)
+
+    def _strided_slice(self, op, x):
+        o = op.builtinOptions
+        begin, end, strides = (self._constant(i).tolist() for i in op.inputs[1:4])
+        index = []
+        for d, size in enumerate(x.shape):
+            b = 0 if (o.beginMask >> d) & 1 else begin[d] + (size if begin[d] < 0 else 0)
+            e = size if (o.endMask >> d) & 1 else end[d] + (size if end[d] < 0 else 0)
+            if (o.shrinkAxisMask >> d) & 1:
+                index.append(b)
+            else:
+                index.append(slice(b, min(e, size), strides[d]))
+        return x[tuple(index)]
+
+    def __call__(self, inputs):
+        values = {}
+        for i, x in zip(self.sg.inputs, inputs):
+            assert list(x.shape) == self._shape(i), (x.shape, self._shape(i))
+            values[int(i)] = x
+        for op in self.sg.operators:
+            kind = self.kinds[op.opcodeIndex]
+            x = values.get(int(op.inputs[0])) if len(op.inputs) else None
+            if kind in ("CONV_2D", "DEPTHWISE_CONV_2D"):
+                y = self._conv(op, kind, x)
+            elif kind in ("AVERAGE_POOL_2D", "MAX_POOL_2D"):
+                y = self._pool(op, kind, x)
+            elif kind == "FULLY_CONNECTED":
+                y = self._fully_connected(op, x)
+            elif kind == "SOFTMAX":
+                y = self._softmax(op, x)
+            elif kind in ("RESHAPE", "EXPAND_DIMS", "SQUEEZE"):
+                y = x.reshape(self._shape(op.outputs[0]))
+            elif kind == "CONCATENATION":
+                y = np.concatenate([values[int(i)] for i in op.inputs], axis=op.builtinOptions.axis)
+            elif kind == "STRIDED_SLICE":
+                y = self._strided_slice(op, x)
+            else:
+                raise NotImplementedError(kind)
+            assert list(y.shape) == self._shape(op.outputs[0]), (kind, y.shape, self._shape(op.outputs[0]))
+            values[int(op.outputs[0])] = y
+        return [values[int(i)] for i in self.sg.outputs]
+
+
+# ----------------------------------------------------------------------
+#   Tests
+# ----------------------------------------------------------------------
+HAR = "apps/ai/har/src/har_model_data.h"
+KWS = "apps/ai/kws/src/kws_model_data.h"
+
+
+def layer_names(windowed, kinds):
+    model = sc.StreamModel(sc.load_model(windowed), 1, "external")
+    return [model.name(op.outputs[0]) for op in model.sg.operators if model.kind(op) in kinds]
+
+
+def check_interior_frames(windowed, frames_per_step, name, num_frames=240, seed=7):
+    """Stream frames through a converted model and check that every frame of the time tensor
+    called name matches the windowed model's, except those SAME padding reaches from the
+    window edges. Returns how many frames were checked."""
+    stream = sc.convert_model(windowed, frames_per_step)
+    index = next(i for i in range(len(stream.sg.tensors)) if stream.name(i) == name)
+    tw, rate, axis = stream.time[index]
+    lag = stream.lag[index]
+
+    win = RefRunner(windowed)
+    win.sg.outputs = [next(i for i, t in enumerate(win.sg.tensors) if t.name.decode() == name)]
+    st = RefRunner(stream.serialize())
+    st.sg.outputs = [index] + [s for _, s in stream.states]
+
+    x = stream.t(stream.sg.inputs[0])
+    rng = np.random.default_rng(seed)
+    frames = rng.integers(-128, 128, size=[num_frames] + [int(d) for d in x.shape[2:]], dtype=np.int8)
+    states = [np.full(st._shape(s), st._quantization(s)[1], np.int8) for s, _ in stream.states]
+    streamed = []
+    for n in range(0, num_frames, frames_per_step):
+        outputs = st([frames[n : n + frames_per_step][np.newaxis]] + states)
+        streamed.append(np.moveaxis(outputs[0], axis, 0))
+        states = outputs[1:]
+    streamed = np.concatenate(streamed)
+
+    # Streamed frame k covers input frames up to (k + 1) * rate; the window ending lag frames
+    # before the last step ends with frame tw - 1
+    end = num_frames - lag
+    expected = np.moveaxis(win([frames[end - stream.window : end][np.newaxis]])[0], axis, 0)
+    edge = -(-lag // rate)
+    for j in range(edge, tw - edge):
+        assert np.array_equal(expected[j], streamed[(end + lag) // rate - tw + j]), f"{name} frame {j}"
+    return tw - 2 * edge
+
+
+def test_har_streams():
+    windowed = model_from_header(HAR)
+    stream = sc.convert_model(windowed, frames_per_step=2)
+    # Conv1D layers keep time along W between EXPAND_DIMS and RESHAPE; three of them pad in time
+    assert len(stream.padded) == 3
+    assert stream.delay() == 3
+    # Four conv histories of two frames, and the other 98 pooled frames for the classifier
+    assert stream.state_bytes() == [2 * 6, 2 * 16, 2 * 32, 2 * 32, 98 * 128]
+    assert sc.verify(windowed, stream, num_frames=320, runner=RefRunner, reps=1)
+
+
+def test_har_interior_frames_exact():
+    windowed = model_from_header(HAR)
+    for name in layer_names(windowed, ("CONV_2D", "MAX_POOL_2D")):
+        assert check_interior_frames(windowed, 2, name) >= 99 - 2 * 2
+
+
+def test_kws_interior_frames_exact():
+    """SAME padding reaches 6 of KWS's 25 frames from each window edge by the last layer,
+    enough to move the average pool and the top-1 of random inputs, so only the frames the
+    padding doesn't reach are compared"""
+    windowed = model_from_header(KWS)
+    stream = sc.convert_model(windowed, frames_per_step=2)
+    # 5 frames after the first conv's window, 1 (at two frames each) after each depthwise conv
+    assert stream.delay() == 5 + 4 * 2
+    for name in layer_names(windowed, ("CONV_2D", "DEPTHWISE_CONV_2D")):
+        assert check_interior_frames(windowed, 2, name, num_frames=160) >= 25 - 2 * 7
+
+
+def test_rejects_mixed_delays():
+    """A residual add around a SAME layer would combine frames from different times"""
+    model = sc.load_model(model_from_header(HAR))
+    sg = model.subgraphs[0]
+    convs = [op for op in sg.operators if model.operatorCodes[op.opcodeIndex].builtinCode == 3]  # CONV_2D
+    conv = convs[2]
+    code = sc.schema_fb.OperatorCodeT()
+    code.builtinCode = code.deprecatedBuiltinCode = sc.schema_fb.BuiltinOperator.ADD
+    model.operatorCodes.append(code)
+    add = sc.schema_fb.OperatorT()
+    add.opcodeIndex = len(model.operatorCodes) - 1
+    add.inputs = [int(conv.inputs[0]), int(conv.outputs[0])]
+    add.outputs = [len(sg.tensors)]
+    sg.tensors.append(copy.deepcopy(sg.tensors[conv.outputs[0]]))
+    sg.operators.insert(sg.operators.index(conv) + 1, add)
+    with pytest.raises(sc.StreamConvertError, match="different rates or delays"):
+        sc.StreamModel(model, 2, "external").convert()
@@ -1,4 +1,5 @@
 import configparser
+import glob
 import logging as log
 import os
 import queue
@@ -72,6 +73,10 @@ def generateTestRunner(params, test_suite_name, tc):
 
     shutil.copy2(f"{test_directory}/{test_file_name}.c", f"{d}/")
     shutil.copy2(f"{test_directory}/{test_file_name}.h", f"{d}/")
+    # Helpers of a C test (e.g. C++ template code, generated models), named <test_file>_*
+    for ext in ("cc", "c", "h"):
+        for f in glob.glob(f"{test_directory}/{test_file_name}_*.{ext}"):
+            shutil.copy2(f, f"{d}/")
 
     # Compile test enclosures
 
@@ -19,6 +19,7 @@ import yaml
 from pydantic import BaseModel, Field
 
 # External modules – behaviour must stay identical; keep import locations
+from neuralspot.tools.autodeploy.aot_compiler import verify_on_host
 from neuralspot.tools.autodeploy.gen_library import generateModelLib
 from neuralspot.tools.autodeploy.measure_power import (
     generatePowerBinary,
@@ -109,6 +110,15 @@ class Params(BaseModel):
         description="(TFLM Workaround) Padding to be added to arena size to account for scratch buffer (in KB)",
     )
 
+    runtime: str = Field(
+        "tflm",
+        description="Runtime for the generated library: tflm, or aot to also compile the model to direct CMSIS-NN calls",
+    )
+    verify_cmsis_nn: str = Field(
+        "",
+        description="CMSIS-NN source tree; with --runtime aot, check the compiled model is bit-exact with the TFLite reference kernels on the host",
+    )
+
     resource_variable_count: int = Field(
         0,
         description="Maximum ResourceVariables needed by model (typically used by RNNs)",
@@ -403,6 +413,9 @@ class AutoDeployRunner:
         if self.p.create_ambiqsuite_example:
             self._generate_ambiqsuite_example()
 
+        if self.p.runtime == "aot" and self.p.verify_cmsis_nn:
+            verify_on_host(self.p.tflite_filename, self.p.model_name, self.p.verify_cmsis_nn)
+
         # Final report is produced by adResults – identical behaviour
         # Get the arena size from the platform config
         self.results.setArenaSize(self.mc.arena_size_k)
@@ -0,0 +1,205 @@
+#!/usr/bin/env python
+"""
+Replay recorded sensor logs through the ns-model inference gate.
+
+Runs the novelty metrics and hysteresis policy of neuralspot/ns-model (ns_model_gate.h) over
+a recording and reports how many model invokes the gate would skip. Given the model's
+per-stride outputs for the same recording (for example logged from the ungated pipeline on
+the EVB, or computed offline with the training pipeline), it also reports how often the
+gated decision, which reuses the last invoked output on skipped strides, differs from the
+ungated one.
+
+    python ns_gate_replay.py --wav kws_session.wav --hop 320 --on 9 12 15 --hold 25 50 \\
+        --floor-alpha 0.05 --outputs kws_session_outputs.npy
+    python ns_gate_replay.py --imu har_session.csv --stride 25 --metric variance --on 0.005 \\
+        --off 0.002 --hold 4 --refresh 20
+
+Audio must be 16-bit PCM .wav (the first channel is used). IMU logs are CSV with one sample
+per row; non-numeric rows (headers) are skipped and --columns picks the axes. Outputs are a
+.npy or .csv with one row of scores per stride; the decision is their argmax.
+"""
+import argparse
+import csv
+import itertools
+import sys
+import wave
+from pathlib import Path
+
+import numpy as np
+
+
+class Gate:
+    """Mirror of ns_model_gate_decide()."""
+
+    def __init__(self, on, off, hold=0, refresh=0, floor_alpha=0.0):
+        if off > on or not 0.0 <= floor_alpha <= 1.0:
+            raise ValueError("need off <= on and 0 <= floor_alpha <= 1")
+        self.on, self.off, self.hold, self.refresh, self.alpha = on, off, hold, refresh, floor_alpha
+        self.open = self.primed = False
+        self.below = self.since = 0
+        self.floor = None
+        self.invokes = self.refreshes = self.opens = 0
+
+    def decide(self, novelty):
+        level = novelty
+        if self.alpha > 0:
+            if self.floor is None:
+                self.floor = novelty
+            level = novelty - self.floor
+
+        if not self.open:
+            if level >= self.on:
+                self.open, self.below = True, 0
+                self.opens += 1
+        elif level < self.off:
+            self.below += 1
+            if self.below > self.hold:
+                self.open = False
+        else:
+            self.below = 0
+
+        if self.alpha > 0:
+            if novelty < self.floor:
+                self.floor = novelty
+            elif not self.open:
+                self.floor += self.alpha * (novelty - self.floor)
+
+        invoke = self.open or not self.primed or (self.refresh and self.since + 1 >= self.refresh)
+        if invoke:
+            self.refreshes += int(not self.open and self.primed)
+            self.invokes += 1
+            self.primed, self.since = True, 0
+        else:
+            self.since += 1
+        return invoke
+
+
+def energy_db(frames):
+    """ns_gate_energy_db() per row of int16 frames."""
+    power = np.mean(frames.astype(np.float64) ** 2, axis=1) / 32768.0**2
+    with np.errstate(divide="ignore"):
+        return np.maximum(10 * np.log10(power), -100.0)
+
+
+def spectral_flux(spectra):
+    """ns_gate_spectral_flux() over consecutive rows, starting from silence."""
+    prev = np.vstack([np.zeros_like(spectra[:1]), spectra[:-1]])
+    rise = np.maximum(spectra - prev, 0).sum(axis=1)
+    total = spectra.sum(axis=1)
+    return np.divide(rise, total, out=np.zeros_like(total), where=total > 0)
+
+
+def imu_variance(blocks):
+    """ns_gate_imu_variance() per block of (samples, axes)."""
+    return blocks.var(axis=1).sum(axis=1)
+
+
+def load_wav(path):
+    with wave.open(str(path)) as w:
+        if w.getsampwidth() != 2:
+            raise ValueError(f"{path}: expected 16-bit PCM")
+        pcm = np.frombuffer(w.readframes(w.getnframes()), dtype="<i2")
+        return pcm.reshape(-1, w.getnchannels())[:, 0], w.getframerate()
+
+
+def load_csv(path, columns=None):
+    rows = []
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            try:
+                values = [float(v) for v in row]
+            except ValueError:
+                continue
+            rows.append(values if columns is None else [values[c] for c in columns])
+    return np.array(rows, dtype=np.float64)
+
+
+def novelty_from_audio(pcm, hop, metric):
+    frames = pcm[: len(pcm) // hop * hop].reshape(-1, hop)
+    if metric == "energy":
+        return energy_db(frames)
+    if metric == "flux":
+        window = np.hanning(hop)
+        return spectral_flux(np.abs(np.fft.rfft(frames * window, axis=1)))
+    raise ValueError(f"{metric} is not an audio metric (energy, flux)")
+
+
+def novelty_from_imu(samples, stride, metric):
+    if metric != "variance":
+        raise ValueError(f"{metric} is not an IMU metric (variance)")
+    blocks = samples[: len(samples) // stride * stride].reshape(-1, stride, samples.shape[1])
+    return imu_variance(blocks)
+
+
+def replay(novelty, outputs, on, off, hold, refresh, floor_alpha):
+    """Run one gate configuration, returning (invokes, refreshes, opens, differing steps)."""
+    gate = Gate(on, off, hold, refresh, floor_alpha)
+    last = None
+    differ = 0
+    for step, value in enumerate(novelty):
+        if gate.decide(float(value)):
+            last = step
+        if outputs is not None:
+            differ += int(np.argmax(outputs[last]) != np.argmax(outputs[step]))
+    return gate.invokes, gate.refreshes, gate.opens, differ
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Replay logs through the ns-model inference gate")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--wav", help="16-bit PCM recording")
+    source.add_argument("--imu", help="CSV of IMU samples, one per row")
+    parser.add_argument("--hop", type=int, default=320, help="audio samples per stride")
+    parser.add_argument("--stride", type=int, default=25, help="IMU samples per stride")
+    parser.add_argument("--columns", type=int, nargs="*", help="IMU CSV columns to use")
+    parser.add_argument("--metric", choices=["energy", "flux", "variance"],
+                        help="novelty metric (default energy for audio, variance for IMU)")
+    parser.add_argument("--outputs", help="ungated model outputs per stride (.npy or .csv)")
+    parser.add_argument("--on", type=float, nargs="+", required=True, help="onThreshold values")
+    parser.add_argument("--off", type=float, nargs="*",
+                        help="offThreshold values (default half of each --on)")
+    parser.add_argument("--hold", type=int, nargs="+", default=[0], help="holdSteps values")
+    parser.add_argument("--refresh", type=int, nargs="+", default=[0], help="refreshSteps values")
+    parser.add_argument("--floor-alpha", type=float, default=0.0)
+    args = parser.parse_args(argv)
+
+    if args.wav:
+        pcm, rate = load_wav(args.wav)
+        novelty = novelty_from_audio(pcm, args.hop, args.metric or "energy")
+        print(f"{args.wav}: {len(pcm) / rate:.1f} s, {len(novelty)} strides of {args.hop} samples")
+    else:
+        samples = load_csv(args.imu, args.columns)
+        novelty = novelty_from_imu(samples, args.stride, args.metric or "variance")
+        print(f"{args.imu}: {len(samples)} samples x {samples.shape[1]} axes, "
+              f"{len(novelty)} strides of {args.stride}")
+
+    outputs = None
+    if args.outputs:
+        path = Path(args.outputs)
+        outputs = np.load(path) if path.suffix == ".npy" else load_csv(path)
+        outputs = outputs.reshape(len(outputs), -1)
+        if len(outputs) < len(novelty):
+            parser.error(f"{args.outputs} has {len(outputs)} rows for {len(novelty)} strides")
+    print(f"novelty: min {novelty.min():.4g}, median {np.median(novelty):.4g}, "
+          f"max {novelty.max():.4g}")
+
+    print(f"{'on':>8} {'off':>8} {'hold':>5} {'refresh':>7} {'invokes':>8} {'saved':>6} "
+          f"{'opens':>6} {'refr':>5}" + (f" {'differ':>7}" if outputs is not None else ""))
+    offs = args.off or [None]
+    for on, off, hold, refresh in itertools.product(args.on, offs, args.hold, args.refresh):
+        off = on / 2 if off is None else off
+        if off > on:
+            continue
+        invokes, refreshes, opens, differ = replay(novelty, outputs, on, off, hold, refresh,
+                                                   args.floor_alpha)
+        steps = len(novelty)
+        line = (f"{on:>8.4g} {off:>8.4g} {hold:>5} {refresh:>7} {invokes:>8} "
+                f"{100 * (steps - invokes) / steps:>5.1f}% {opens:>6} {refreshes:>5}")
+        if outputs is not None:
+            line += f" {100 * differ / steps:>6.2f}%"
+        print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
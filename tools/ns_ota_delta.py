@@ -0,0 +1,324 @@
+#!/usr/bin/env python
+"""
+Delta patches for ns-ota model updates.
+
+Builds a patch that rebuilds a new model image from the one already deployed, in the format
+applied on the device by neuralspot/ns-ota (ns_ota_delta.h), checks patches by applying them
+on the host, and benchmarks patch size against full image size.
+
+    python ns_ota_delta.py diff old.tflite new.tflite -o update.nsdp
+    python ns_ota_delta.py apply old.tflite update.nsdp -o rebuilt.tflite
+    python ns_ota_delta.py bench --pairs old.tflite:new.tflite ...
+    python ns_ota_delta.py bench --synthetic apps/ai/kws/src/kws_model_data.h
+
+Images can be .tflite files or C headers holding the model as a byte array.
+
+The patch is a header (magic, sizes and SHA-256 of both images) followed by COPY and INSERT
+ops. COPY offsets are relative to where the previous COPY ended (plus the bytes inserted
+since), so the common case of a few changed weights costs two or three bytes per change.
+"""
+import argparse
+import hashlib
+import re
+import struct
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+
+MAGIC = 0x5044534E  # 'NSDP'
+VERSION = 1
+HEADER = struct.Struct("<IHHII32s32s")
+OP_INSERT = 0x00
+OP_COPY = 0x40
+OP_MASK = 0xC0
+LEN_MASK = 0x3F
+
+KEY = 8  # Bytes per index key
+MAX_CANDIDATES = 4  # Source positions kept per key
+MIN_COPY_EXPECTED = 4  # Shortest COPY worth emitting at the expected position
+MIN_COPY = 12  # Shortest COPY elsewhere (the offset costs bytes)
+
+
+def load_image(path):
+    """Read a .tflite file, or the largest byte array in a C header."""
+    path = Path(path)
+    if path.suffix in (".h", ".c", ".cc", ".cpp"):
+        text = path.read_text()
+        arrays = re.findall(r"\[\s*\w*\s*\]\s*=\s*\{([^}]*)\}", text)
+        if not arrays:
+            raise ValueError(f"{path}: no byte array found")
+        body = max(arrays, key=len)
+        return bytes(int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\b\d+\b", body))
+    return path.read_bytes()
+
+
+def _leb128(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return out
+
+
+def _zigzag(value):
+    return (value << 1) ^ (value >> 31) if value < 0 else value << 1
+
+
+def _op(kind, length):
+    if length <= LEN_MASK:
+        return bytearray([kind | length])
+    return bytearray([kind]) + _leb128(length)
+
+
+def _match_len(a, ai, b, bi):
+    """Length of the common run of a[ai:] and b[bi:], compared in growing slices."""
+    limit = min(len(a) - ai, len(b) - bi)
+    n, step = 0, 16
+    while n < limit:
+        step = min(step, limit - n)
+        if a[ai + n : ai + n + step] == b[bi + n : bi + n + step]:
+            n += step
+            step *= 2
+        elif step == 1:
+            break
+        else:
+            step //= 2
+    return n
+
+
+class Patch:
+    def __init__(self):
+        self.ops = bytearray()
+        self.copies = 0
+        self.inserts = 0
+        self.copied = 0
+        self.inserted = 0
+
+
+def diff(source, target):
+    """Patch (bytes) rebuilding target from source, and its op statistics."""
+    index = {}
+    for i in range(len(source) - KEY + 1):
+        hits = index.setdefault(source[i : i + KEY], [])
+        if len(hits) < MAX_CANDIDATES:
+            hits.append(i)
+
+    p = Patch()
+    pending = bytearray()
+    expected = 0
+    t = 0
+
+    def flush():
+        if pending:
+            p.ops += _op(OP_INSERT, len(pending)) + pending
+            p.inserts += 1
+            p.inserted += len(pending)
+            pending.clear()
+
+    while t < len(target):
+        best_pos, best_len = -1, 0
+        if expected < len(source):
+            n = _match_len(source, expected, target, t)
+            if n >= MIN_COPY_EXPECTED:
+                best_pos, best_len = expected, n
+        for c in index.get(target[t : t + KEY], ()):
+            if c == best_pos:
+                continue
+            n = _match_len(source, c, target, t)
+            if n >= MIN_COPY and n > best_len:
+                best_pos, best_len = c, n
+
+        if best_len:
+            flush()
+            p.ops += _op(OP_COPY, best_len) + _leb128(_zigzag(best_pos - expected))
+            p.copies += 1
+            p.copied += best_len
+            expected = best_pos + best_len
+            t += best_len
+        else:
+            pending.append(target[t])
+            expected += 1
+            t += 1
+    flush()
+
+    header = HEADER.pack(
+        MAGIC,
+        VERSION,
+        HEADER.size,
+        len(source),
+        len(target),
+        hashlib.sha256(source).digest(),
+        hashlib.sha256(target).digest(),
+    )
+    return header + bytes(p.ops), p
+
+
+def _read_leb128(patch, pos):
+    value, shift = 0, 0
+    while True:
+        b = patch[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def apply(source, patch):
+    """Rebuild the target image, checking both hashes like the device does."""
+    magic, version, header_size, source_size, target_size, source_hash, target_hash = (
+        HEADER.unpack_from(patch)
+    )
+    if magic != MAGIC or version != VERSION or header_size != HEADER.size:
+        raise ValueError("not an ns-ota delta patch")
+    if source_size != len(source) or source_hash != hashlib.sha256(source).digest():
+        raise ValueError("patch was made for another source image")
+
+    out = bytearray()
+    pos, expected = header_size, 0
+    while len(out) < target_size:
+        op = patch[pos]
+        pos += 1
+        length = op & LEN_MASK
+        if length == 0:
+            length, pos = _read_leb128(patch, pos)
+        if op & OP_MASK == OP_COPY:
+            rel, pos = _read_leb128(patch, pos)
+            src = expected + ((rel >> 1) ^ -(rel & 1))
+            if src < 0 or src + length > len(source):
+                raise ValueError(f"COPY out of range at patch offset {pos}")
+            out += source[src : src + length]
+            expected = src + length
+        elif op & OP_MASK == OP_INSERT:
+            out += patch[pos : pos + length]
+            pos += length
+            expected += length
+        else:
+            raise ValueError(f"bad op 0x{op:02x} at patch offset {pos - 1}")
+    if pos != len(patch) or len(out) != target_size:
+        raise ValueError("patch length does not match its target size")
+    if hashlib.sha256(out).digest() != target_hash:
+        raise ValueError("rebuilt image does not match the target hash")
+    return bytes(out)
+
+
+def weight_buffers(image):
+    """(offset, length) of every constant buffer in a .tflite flatbuffer, in file order."""
+    import neuralspot.tools.utils.schema_py_generated as schema_fb
+
+    model = schema_fb.Model.GetRootAs(image, 0)
+    spans = []
+    for i in range(model.BuffersLength()):
+        buf = model.Buffers(i)
+        if buf.DataIsNone() or buf.DataLength() == 0:
+            continue
+        spans.append((buf._tab.Vector(buf._tab.Offset(4)), buf.DataLength()))
+    return sorted(spans)
+
+
+def synthetic_variants(image, seed=0):
+    """Stand-ins for retrained models: the same graph with some or all weights changed."""
+    rng = np.random.default_rng(seed)
+    spans = weight_buffers(image)
+    base = np.frombuffer(image, dtype=np.uint8)
+    weights = np.concatenate([np.arange(o, o + n) for o, n in spans])
+
+    def nudge(fraction):
+        out = base.copy()
+        picked = rng.choice(weights, size=max(1, int(len(weights) * fraction)), replace=False)
+        out[picked] += rng.choice(np.array([1, 255], dtype=np.uint8), size=len(picked))
+        return out.tobytes()
+
+    def redraw(chosen):
+        out = base.copy()
+        for o, n in chosen:
+            out[o : o + n] = rng.integers(0, 256, size=n, dtype=np.uint8)
+        return out.tobytes()
+
+    largest = sorted(spans, key=lambda s: s[1])[-2:]
+    return [
+        ("1% of weights +-1", nudge(0.01)),
+        ("10% of weights +-1", nudge(0.10)),
+        ("2 largest layers retrained", redraw(largest)),
+        ("full retrain", redraw(spans)),
+    ]
+
+
+def bench(pairs):
+    rows = []
+    for name, source, target in pairs:
+        start = time.perf_counter()
+        patch, stats = diff(source, target)
+        elapsed = time.perf_counter() - start
+        if apply(source, patch) != target:
+            raise RuntimeError(f"{name}: patch does not rebuild the target")
+        rows.append((name, len(target), len(patch), stats, elapsed))
+
+    width = max(len(r[0]) for r in rows)
+    print(
+        f"{'pair':<{width}}  {'full':>9}  {'patch':>9}  {'ratio':>6}  "
+        f"{'copies':>6}  {'inserts':>7}  {'diff s':>6}"
+    )
+    for name, full, size, stats, elapsed in rows:
+        print(
+            f"{name:<{width}}  {full:>9}  {size:>9}  {100 * size / full:>5.1f}%  "
+            f"{stats.copies:>6}  {stats.inserts:>7}  {elapsed:>6.2f}"
+        )
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="ns-ota delta patches for model updates")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("diff", help="build a patch from SOURCE (deployed) to TARGET")
+    p.add_argument("source")
+    p.add_argument("target")
+    p.add_argument("-o", "--output", required=True)
+
+    p = sub.add_parser("apply", help="apply a patch on the host and verify it")
+    p.add_argument("source")
+    p.add_argument("patch")
+    p.add_argument("-o", "--output", required=True)
+
+    p = sub.add_parser("bench", help="patch size versus full image size")
+    p.add_argument("--pairs", nargs="*", default=[], metavar="OLD:NEW",
+                   help="retrained model pairs (.tflite or C headers)")
+    p.add_argument("--synthetic", nargs="*", default=[], metavar="MODEL",
+                   help="models to derive retrained variants from")
+    p.add_argument("--seed", type=int, default=0)
+
+    args = parser.parse_args(argv)
+
+    if args.command == "diff":
+        source, target = load_image(args.source), load_image(args.target)
+        patch, stats = diff(source, target)
+        Path(args.output).write_bytes(patch)
+        print(
+            f"{args.output}: {len(patch)} bytes for a {len(target)} byte image "
+            f"({100 * len(patch) / len(target):.1f}%), {stats.copies} copies, "
+            f"{stats.inserts} inserts ({stats.inserted} bytes)"
+        )
+    elif args.command == "apply":
+        out = apply(load_image(args.source), Path(args.patch).read_bytes())
+        Path(args.output).write_bytes(out)
+        print(f"{args.output}: {len(out)} bytes, target hash verified")
+    else:
+        pairs = []
+        for pair in args.pairs:
+            old, new = pair.split(":")
+            pairs.append((f"{Path(old).name} -> {Path(new).name}", load_image(old),
+                          load_image(new)))
+        for model in args.synthetic:
+            image = load_image(model)
+            for variant, target in synthetic_variants(image, args.seed):
+                pairs.append((f"{Path(model).stem}: {variant}", image, target))
+        if not pairs:
+            parser.error("bench needs --pairs or --synthetic")
+        bench(pairs)
+
+
+if __name__ == "__main__":
+    sys.exit(main())